@@ -0,0 +1,137 @@
+#include <cxxopts.hpp>
+#include <iostream>
+#include <libcharta/PDFSplitter.h>
+#include <sstream>
+
+// "1-3,5,7-9" as one based inclusive ranges, each a part
+static bool ParseRanges(const std::string &inRanges, PDFSplitPartVector &outParts)
+{
+    std::stringstream rangesStream(inRanges);
+    std::string range;
+    while (std::getline(rangesStream, range, ','))
+    {
+        unsigned long first = 0;
+        unsigned long last = 0;
+        char separator = 0;
+        std::stringstream rangeStream(range);
+        rangeStream >> first;
+        if (rangeStream.fail() || first == 0)
+            return false;
+        last = first;
+        if (rangeStream >> separator)
+        {
+            if (separator != '-' || !(rangeStream >> last) || last < first)
+                return false;
+        }
+
+        PDFSplitPart part;
+        part.PageRange.mType = PDFPageRange::eRangeTypeSpecific;
+        part.PageRange.mSpecificRanges.emplace_back(first - 1, last - 1);
+        outParts.push_back(part);
+    }
+    return !outParts.empty();
+}
+
+int main(int argc, char **argv)
+{
+    cxxopts::Options options("pdfsplit", "Split a PDF file into multiple ones");
+
+    // clang-format off
+    options.add_options()
+    ("o,output", "Output pattern for the generated PDFs, %d is replaced by the part number", cxxopts::value<std::string>())
+    ("r,ranges", "Page ranges, a part each, e.g. 1-3,4,5-10", cxxopts::value<std::string>())
+    ("n,every", "Split every N pages", cxxopts::value<unsigned long>())
+    ("b,bookmarks", "Split by the top level bookmarks")
+    ("j,threads", "Number of threads writing parts, default is the number of cores", cxxopts::value<unsigned int>())
+    ("p,password", "Password of the input file", cxxopts::value<std::string>())
+    ("version", "Version output")
+    ("h,help", "Print usage");
+    // clang-format on
+
+    auto result = options.parse(argc, argv);
+    if (result.unmatched().size() != 1 || result.count("help") > 0u)
+    {
+        std::cout << options.help() << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    if (result.count("version") > 0u)
+    {
+        std::cout << "pdfsplit " << LIBCHARTA_VERSION << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    if (result.count("output") == 0)
+    {
+        std::cout << "Must specify an output pattern!" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    auto output = result["output"].as<std::string>();
+    auto numberPosition = output.find("%d");
+    if (numberPosition == std::string::npos)
+    {
+        std::cout << "Output pattern must contain %d" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (result.count("ranges") + result.count("every") + result.count("bookmarks") != 1)
+    {
+        std::cout << "Must specify exactly one of --ranges, --every or --bookmarks" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    auto input = result.unmatched().front();
+    PDFSplitter splitter;
+    auto status = splitter.Open(input, PDFParsingOptions(result.count("password") > 0u
+                                                             ? result["password"].as<std::string>()
+                                                             : std::string()));
+    if (status != charta::eSuccess)
+    {
+        std::cerr << "Failed to open PDF: " << input << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    PDFSplitPartVector parts;
+    if (result.count("ranges") > 0u)
+    {
+        if (!ParseRanges(result["ranges"].as<std::string>(), parts))
+        {
+            std::cerr << "Bad page ranges: " << result["ranges"].as<std::string>() << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    else if (result.count("every") > 0u)
+    {
+        parts = splitter.CreatePartsForEveryNPages(result["every"].as<unsigned long>());
+    }
+    else if (splitter.CreatePartsForBookmarks(parts) != charta::eSuccess)
+    {
+        std::cerr << "Failed to read bookmarks of: " << input << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (parts.empty())
+    {
+        std::cerr << "Nothing to split" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    for (size_t i = 0; i < parts.size(); ++i)
+    {
+        parts[i].OutputPath = output;
+        parts[i].OutputPath.replace(numberPosition, 2, std::to_string(i + 1));
+        std::cout << "Part " << i + 1 << ": " << parts[i].OutputPath;
+        if (!parts[i].Title.empty())
+            std::cout << " (" << parts[i].Title << ")";
+        std::cout << std::endl;
+    }
+
+    status = splitter.Split(parts, result.count("threads") > 0u ? result["threads"].as<unsigned int>() : 0);
+    if (status != charta::eSuccess)
+    {
+        std::cerr << "Failed to split PDF: " << input << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -165,6 +165,15 @@ class AbstractContentContext
     void DrawCircle(double inCenterX, double inCenterY, double inRadius,
                     const GraphicOptions &inOptions = GraphicOptions());
     void DrawPath(const DoubleAndDoublePairList &inPathPoints, const GraphicOptions &inOptions = GraphicOptions());
+    // same, for points given as contiguous x,y pairs. see Polyline and Polygons below
+    void DrawPolyline(const double *inCoordinates, size_t inPointsCount,
+                      const GraphicOptions &inOptions = GraphicOptions(), const double *inMatrix = nullptr);
+    void DrawPolyline(const float *inCoordinates, size_t inPointsCount,
+                      const GraphicOptions &inOptions = GraphicOptions(), const double *inMatrix = nullptr);
+    void DrawPolygons(const double *inCoordinates, const size_t *inPointsCounts, size_t inPolygonsCount,
+                      const GraphicOptions &inOptions = GraphicOptions(), const double *inMatrix = nullptr);
+    void DrawPolygons(const float *inCoordinates, const size_t *inPointsCounts, size_t inPolygonsCount,
+                      const GraphicOptions &inOptions = GraphicOptions(), const double *inMatrix = nullptr);
     void WriteText(double inX, double inY, const std::string &inText, const TextOptions &inOptions);
     static unsigned long ColorValueForName(const std::string &inColorName);
     void DrawImage(double inX, double inY, const std::string &inImagePath,
@@ -194,6 +203,22 @@ class AbstractContentContext
     void h();
     void re(double inLeft, double inBottom, double inWidth, double inHeight);
 
+    // bulk path construction, for paths with many points. coordinates are x,y pairs laid out contiguously, and are
+    // formatted into the stream in one go rather than operator by operator. inMatrix, when provided, is a 6 values
+    // matrix (same order as cm) applied to each point before it is written.
+    // Polyline - m for the first point, l for the rest
+    void Polyline(const double *inCoordinates, size_t inPointsCount, const double *inMatrix = nullptr);
+    void Polyline(const float *inCoordinates, size_t inPointsCount, const double *inMatrix = nullptr);
+    // Polygons - consecutive polylines, inPointsCounts[i] points each, each closed with h
+    void Polygons(const double *inCoordinates, const size_t *inPointsCounts, size_t inPolygonsCount,
+                  const double *inMatrix = nullptr);
+    void Polygons(const float *inCoordinates, const size_t *inPointsCounts, size_t inPolygonsCount,
+                  const double *inMatrix = nullptr);
+    // Curves - m for the first point, then c for each following triplet of control, control and end points.
+    // trailing points that do not complete a triplet are ignored
+    void Curves(const double *inCoordinates, size_t inPointsCount, const double *inMatrix = nullptr);
+    void Curves(const float *inCoordinates, size_t inPointsCount, const double *inMatrix = nullptr);
+
     // graphic state
     void q();
     charta::EStatusCode Q(); // Status code returned, in case there's inbalance in "q-Q"s
@@ -314,6 +339,13 @@ class AbstractContentContext
     void WriteFreeCode(const std::string &inFreeCode);
     void WriteFreeCode(charta::IByteReader *inFreeCodeSource);
 
+    // Skip operators that would not change the state - colors, line style, text state and identity cm - as far as
+    // the context can follow it (see GraphicState). Set from PDFCreationSettings::ElideRedundantOperators, may be
+    // changed per context
+    void SetElideRedundantOperators(bool inElideRedundantOperators);
+    bool GetElideRedundantOperators() const;
+    const GraphicState &GetCurrentGraphicState();
+
     // Extensibility
     void AddContentContextListener(IContentContextListener *inExtender);
     void RemoveContentContextListener(IContentContextListener *inExtender);
@@ -340,8 +372,9 @@ class AbstractContentContext
                                     const PDFParsingOptions &inParsingOptions) = 0;
     PrimitiveObjectsWriter mPrimitiveWriter;
 
-    // graphic stack to monitor high-level graphic usage (now - fonts)
+    // graphic stack to monitor graphic usage - fonts, colors, line style, text state and CTM
     GraphicStateStack mGraphicStack;
+    bool mElideRedundantOperators;
 
     // listeners
     std::set<IContentContextListener *> mListeners;
@@ -356,4 +389,10 @@ class AbstractContentContext
     void SetupColor(const TextOptions &inOptions);
     void SetupColor(EDrawingType inDrawingType, unsigned long inColorValue, EColorSpace inColorSpace);
     void FinishPath(const GraphicOptions &inOptions);
+    template <class T>
+    void WritePolyline(const T *inCoordinates, size_t inPointsCount, const double *inMatrix);
+    template <class T>
+    void WritePolygons(const T *inCoordinates, const size_t *inPointsCounts, size_t inPolygonsCount,
+                       const double *inMatrix);
+    template <class T> void WriteCurves(const T *inCoordinates, size_t inPointsCount, const double *inMatrix);
 };
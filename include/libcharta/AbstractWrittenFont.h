@@ -26,7 +26,7 @@
 
 class ObjectsContext;
 class DictionaryContext;
-class PDFParser;
+class StateReader;
 
 namespace charta
 {
@@ -52,7 +52,7 @@ class AbstractWrittenFont : public IWrittenFont
     charta::EStatusCode WriteStateInDictionary(ObjectsContext *inStateWriter,
                                                DictionaryContext *inDerivedObjectDictionary);
     charta::EStatusCode WriteStateAfterDictionary(ObjectsContext *inStateWriter);
-    charta::EStatusCode ReadStateFromObject(PDFParser *inStateReader,
+    charta::EStatusCode ReadStateFromObject(StateReader *inStateReader,
                                             const std::shared_ptr<charta::PDFDictionary> &inState);
 
   private:
@@ -86,8 +86,8 @@ class AbstractWrittenFont : public IWrittenFont
                                               ObjectsContext *inStateWriter, ObjectIDType inObjectID);
     void WriteGlyphEncodingInfoState(ObjectsContext *inStateWriter, ObjectIDType inObjectId,
                                      const GlyphEncodingInfo &inGlyphEncodingInfo);
-    void ReadWrittenFontState(PDFParser *inStateReader, const std::shared_ptr<charta::PDFDictionary> &inState,
+    void ReadWrittenFontState(StateReader *inStateReader, const std::shared_ptr<charta::PDFDictionary> &inState,
                               WrittenFontRepresentation *inRepresentation);
-    void ReadGlyphEncodingInfoState(PDFParser *inStateReader, ObjectIDType inObjectID,
+    void ReadGlyphEncodingInfoState(StateReader *inStateReader, ObjectIDType inObjectID,
                                     GlyphEncodingInfo &inGlyphEncodingInfo);
 };
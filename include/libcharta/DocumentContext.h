@@ -29,7 +29,9 @@
 #include "UsedFontsRepository.h"
 #include "encryption/EncryptionHelper.h"
 #include "encryption/EncryptionOptions.h"
+#include "images/ImagePreparationPool.h"
 #include "images/jpeg/JPEGImageHandler.h"
+#include "images/pixels/PixelsImageHandler.h"
 #include "images/png/PNGImageHandler.h"
 #include "images/tiff/TIFFImageHandler.h"
 #include "images/tiff/TIFFUsageParameters.h"
@@ -51,14 +53,18 @@ class PDFPage;
 class PageTree;
 class IDocumentContextExtender;
 class PageContentContext;
+class PageContentBuffer;
 class ResourcesDictionary;
 class PDFFormXObject;
 class PDFTiledPattern;
+class WriterStatistics;
 class PDFRectangle;
 class PDFImageXObject;
 class PDFUsedFont;
 class PageContentContext;
 class PDFParser;
+class StateReader;
+class PDFParserReader;
 class IResourceWritingTask;
 class IFormEndWritingTask;
 class IPageEndWritingTask;
@@ -82,12 +88,18 @@ typedef std::list<ITiledPatternEndWritingTask *> ITiledPatternEndWritingTaskList
 typedef std::map<PDFTiledPattern *, ITiledPatternEndWritingTaskList>
     PDFTiledPatternToITiledPatternEndWritingTaskListMap;
 typedef std::pair<std::string, unsigned long> StringAndULongPair;
+typedef std::pair<uint32_t, uint32_t> UIntAndUIntPair;
+// image file and index, with the pixels size it is downsampled to
+typedef std::pair<StringAndULongPair, UIntAndUIntPair> StringAndULongPairAndPixelsSize;
+typedef std::map<StringAndULongPairAndPixelsSize, ObjectIDType> StringAndULongPairAndPixelsSizeToObjectIDTypeMap;
+typedef std::map<ObjectIDType, UIntAndUIntPair> ObjectIDTypeToUIntAndUIntPairMap;
 
 namespace charta
 {
 class OutputFile;
 class PDFDictionary;
 class PDFDocumentCopyingContext;
+class PreparedImage;
 
 struct HummusImageInformation
 {
@@ -97,15 +109,20 @@ struct HummusImageInformation
         imageType = eUndefined;
         imageWidth = -1;
         imageHeight = -1;
+        pixelsWidth = -1;
+        pixelsHeight = -1;
     }
 
     ObjectIDType writtenObjectID;
     EHummusImageType imageType;
     double imageWidth;
     double imageHeight;
+    long long pixelsWidth;
+    long long pixelsHeight;
 };
 
 typedef std::map<StringAndULongPair, HummusImageInformation> StringAndULongPairToHummusImageInformationMap;
+typedef std::map<ObjectIDType, PreparedImage *> ObjectIDTypeToPreparedImageMap;
 
 class DocumentContext
 {
@@ -116,6 +133,15 @@ class DocumentContext
     void SetObjectsContext(ObjectsContext *inObjectsContext);
     void SetOutputFileInformation(OutputFile *inOutputFile);
     void SetEmbedFonts(bool inEmbedFonts);
+    // default for content contexts created from now on, see AbstractContentContext::SetElideRedundantOperators
+    void SetElideRedundantOperators(bool inElideRedundantOperators);
+    bool GetElideRedundantOperators() const;
+    // downsample JPEG and PNG images drawn with DrawImage to inTargetResolution pixels per inch at the size they are
+    // drawn, when larger. JPEG images are recompressed at inJPEGQuality. 0 resolution to embed images as they are
+    void SetImageOptimization(double inTargetResolution, int inJPEGQuality);
+    // worker threads that decode and compress JPEG and PNG images drawn with DrawImage ahead of writing them, see
+    // ImagePreparationPool. 0 to do it on the writing thread, when the image is written
+    void SetImagePreparationThreads(unsigned int inThreadsCount);
     EStatusCode WriteHeader(EPDFVersion inPDFVersion);
     EStatusCode FinalizeNewPDF();
     EStatusCode FinalizeModifiedPDF(PDFParser *inModifiedFileParser, EPDFVersion inModifiedPDFVersion);
@@ -123,6 +149,9 @@ class DocumentContext
     TrailerInformation &GetTrailerInformation();
     CatalogInformation &GetCatalogInformation();
 
+    // statistics of the current production, NULL when not collecting. see WriterStatistics.h
+    WriterStatistics *GetStatistics();
+
     // Encryption related (will default to no encryption of not called)
     void SetupEncryption(const EncryptionOptions &inEncryptionOptions, EPDFVersion inPDFVersion);
     void SetupEncryption(PDFParser *inModifiedFileParser);
@@ -151,6 +180,14 @@ class DocumentContext
     EStatusCodeAndObjectIDType WritePage(PDFPage &inPage);
     EStatusCodeAndObjectIDType WritePageAndRelease(PDFPage *inPage);
 
+    // Page parallel content generation (see PageContentBuffer).
+    // StartPageContentBuffer reserves inObjectsCount object IDs for the page objects [each content stream takes 2],
+    // and returns a buffer that can be written on another thread. returns NULL for encrypted documents.
+    PageContentBuffer *StartPageContentBuffer(PDFPage &inPage, ObjectIDType inObjectsCount = 16);
+    // Append the buffer content to the output and write its page. Commit buffers in page order, from the writing
+    // thread. the buffer is released, the page is not
+    EStatusCodeAndObjectIDType CommitPageContentBuffer(PageContentBuffer *inPageContentBuffer);
+
     // Use this to add annotation references to a page. the references will be written on the next page write (see
     // WritePage and WritePageAndRelease)
     void RegisterAnnotationReferenceForNextPageWrite(ObjectIDType inAnnotationReference);
@@ -194,6 +231,11 @@ class DocumentContext
     PDFFormXObject *CreateFormXObjectFromJPGFile(const std::string &inJPGFilePath, ObjectIDType inFormXObjectID);
     PDFFormXObject *CreateFormXObjectFromJPGStream(IByteReaderWithPosition *inJPGStream, ObjectIDType inFormXObjectID);
 
+    // Pixels already decoded to memory. will return image xobject sized at 1X1
+    PDFImageXObject *CreateImageXObjectFromPixels(const PixelsImageDescription &inPixels);
+    PDFImageXObject *CreateImageXObjectFromPixels(const PixelsImageDescription &inPixels,
+                                                  ObjectIDType inImageXObjectID);
+
     // TIFF
 #ifndef LIBCHARTA_NO_TIFF
     PDFFormXObject *CreateFormXObjectFromTIFFFile(
@@ -208,6 +250,12 @@ class DocumentContext
     PDFFormXObject *CreateFormXObjectFromTIFFStream(
         IByteReaderWithPosition *inTIFFStream, ObjectIDType inFormXObjectID,
         const TIFFUsageParameters &inTIFFUsageParameters = TIFFUsageParameters::DefaultTIFFUsageParameters());
+    PDFFormXObjectVector CreateFormXObjectsFromTIFFFile(
+        const std::string &inTIFFFilePath, const std::vector<unsigned long> &inPageIndexes = {},
+        const TIFFUsageParameters &inTIFFUsageParameters = TIFFUsageParameters::DefaultTIFFUsageParameters());
+    PDFFormXObjectVector CreateFormXObjectsFromTIFFStream(
+        IByteReaderWithPosition *inTIFFStream, const std::vector<unsigned long> &inPageIndexes = {},
+        const TIFFUsageParameters &inTIFFUsageParameters = TIFFUsageParameters::DefaultTIFFUsageParameters());
 #endif
 #ifndef LIBCHARTA_NO_PNG
     // PNG
@@ -268,6 +316,7 @@ class DocumentContext
     std::shared_ptr<PDFDocumentCopyingContext> CreatePDFCopyingContext(IByteReaderWithPosition *inPDFStream,
                                                                        const PDFParsingOptions &inOptions);
     std::shared_ptr<PDFDocumentCopyingContext> CreatePDFCopyingContext(PDFParser *inPDFParser);
+    std::shared_ptr<PDFDocumentCopyingContext> CreatePDFCopyingContext(PDFParserReader *inParserReader);
 
     // some public image info services, for users of hummus
     std::pair<double, double> GetImageDimensions(
@@ -320,7 +369,7 @@ class DocumentContext
                                             ITiledPatternEndWritingTask *inWritingTask);
 
     EStatusCode WriteState(ObjectsContext *inStateWriter, ObjectIDType inObjectID);
-    EStatusCode ReadState(PDFParser *inStateReader, ObjectIDType inObjectID);
+    EStatusCode ReadState(StateReader *inStateReader, ObjectIDType inObjectID);
 
     void Cleanup();
 
@@ -336,6 +385,10 @@ class DocumentContext
         const std::string &inImagePath, unsigned long inImageIndex, ObjectIDType inObjectID,
         const PDFParsingOptions &inParsingOptions = PDFParsingOptions::DefaultPDFParsingOptions());
     ObjectIDTypeAndBool RegisterImageForDrawing(const std::string &inImageFile, unsigned long inImageIndex);
+    // same, for an image drawn at the given scale from its natural size. with image optimization set, may register a
+    // downsampled image, that WriteFormForImage then writes
+    ObjectIDTypeAndBool RegisterImageForDrawing(const std::string &inImageFile, unsigned long inImageIndex,
+                                                double inScaleX, double inScaleY);
 
     // JPG images handler for retrieving JPG images information
     JPEGImageHandler &GetJPEGImageHandler();
@@ -354,6 +407,7 @@ class DocumentContext
     std::string mOutputFilePath;
     IDocumentContextExtenderSet mExtenders;
     JPEGImageHandler mJPEGImageHandler;
+    PixelsImageHandler mPixelsImageHandler;
 #ifndef LIBCHARTA_NO_TIFF
     TIFFImageHandler mTIFFImageHandler;
 #endif
@@ -366,6 +420,9 @@ class DocumentContext
     IPDFParserExtender *mParserExtender;
     std::set<PDFDocumentCopyingContext *> mCopyingContexts;
     bool mModifiedDocumentIDExists;
+    bool mElideRedundantOperators;
+    double mImageTargetResolution;
+    int mImageJPEGQuality;
     std::string mModifiedDocumentID;
     std::string mNewPDFID;
     ObjectIDType mCurrentPageTreeIDInState;
@@ -374,6 +431,10 @@ class DocumentContext
     PDFPageToIPageEndWritingTaskListMap mPageEndTasks;
     PDFTiledPatternToITiledPatternEndWritingTaskListMap mTiledPatternEndTasks;
     StringAndULongPairToHummusImageInformationMap mImagesInformation;
+    StringAndULongPairAndPixelsSizeToObjectIDTypeMap mDownsampledImages;
+    ObjectIDTypeToUIntAndUIntPairMap mDownsampledImagesToWrite;
+    ImagePreparationPool mImagePreparationPool;
+    ObjectIDTypeToPreparedImageMap mPreparedImages;
     EncryptionHelper mEncryptionHelper;
 
     void WriteHeaderComment(EPDFVersion inPDFVersion);
@@ -385,6 +446,7 @@ class DocumentContext
     EStatusCode WriteTrailerDictionaryValues(DictionaryContext *inDictionaryContext);
     void WriteXrefReference(long long inXrefTablePosition);
     void WriteFinalEOF();
+    void UpdateXrefStatistics(long long inXrefSectionStart);
     void WriteInfoDictionary();
     void WriteEncryptionDictionary();
     void WritePagesTree();
@@ -405,15 +467,15 @@ class DocumentContext
     void WriteTrailerInfoState(ObjectsContext *inStateWriter, ObjectIDType inObjectID);
     void WriteDateState(ObjectsContext *inStateWriter, const PDFDate &inDate);
     void WriteCatalogInformationState(ObjectsContext *inStateWriter, ObjectIDType inObjectID);
-    void ReadTrailerState(PDFParser *inStateReader, const std::shared_ptr<PDFDictionary> &inTrailerState);
+    void ReadTrailerState(StateReader *inStateReader, const std::shared_ptr<PDFDictionary> &inTrailerState);
     ObjectReference GetReferenceFromState(const std::shared_ptr<PDFDictionary> &inDictionary);
-    void ReadTrailerInfoState(PDFParser *inStateReader, const std::shared_ptr<PDFDictionary> &inTrailerInfoState);
+    void ReadTrailerInfoState(StateReader *inStateReader, const std::shared_ptr<PDFDictionary> &inTrailerInfoState);
     void ReadDateState(const std::shared_ptr<PDFDictionary> &inDateState, PDFDate &inDate);
-    void ReadCatalogInformationState(PDFParser *inStateReader,
+    void ReadCatalogInformationState(StateReader *inStateReader,
                                      const std::shared_ptr<PDFDictionary> &inCatalogInformationState);
 
     void WritePageTreeState(ObjectsContext *inStateWriter, ObjectIDType inObjectID, PageTree *inPageTree);
-    void ReadPageTreeState(PDFParser *inStateReader, const std::shared_ptr<PDFDictionary> &inPageTreeState,
+    void ReadPageTreeState(StateReader *inStateReader, const std::shared_ptr<PDFDictionary> &inPageTreeState,
                            PageTree *inPageTree);
 
     ObjectReference GetOriginalDocumentPageTreeRoot(PDFParser *inModifiedFileParser);
@@ -425,5 +487,16 @@ class DocumentContext
     bool RequiresXrefStream(PDFParser *inModifiedFileParser);
     EStatusCode WriteXrefStream(long long &outXrefPosition);
     HummusImageInformation &GetImageInformationStructFor(const std::string &inImageFile, unsigned long inImageIndex);
+    UIntAndUIntPair GetImagePixelsSize(const std::string &inImageFile, unsigned long inImageIndex);
+    UIntAndUIntPair GetDownsampledImageSize(const std::string &inImageFile, unsigned long inImageIndex,
+                                            double inScaleX, double inScaleY);
+    void StartImagePreparation(const std::string &inImageFile, unsigned long inImageIndex,
+                               ObjectIDType inFormObjectID, const UIntAndUIntPair &inPixelsSize);
+    EStatusCode WriteFormForDownsampledImage(const std::string &inImagePath, unsigned long inImageIndex,
+                                             ObjectIDType inObjectID, const UIntAndUIntPair &inPixelsSize);
+    EStatusCode WriteFormForPreparedImage(const std::string &inImagePath, unsigned long inImageIndex,
+                                          ObjectIDType inObjectID, PreparedImage *inPreparedImage);
+    EStatusCode WriteFormForImageXObject(const std::string &inImagePath, unsigned long inImageIndex,
+                                         ObjectIDType inObjectID, PDFImageXObject *inImageXObject);
 };
 } // namespace charta
\ No newline at end of file
@@ -0,0 +1,30 @@
+/*
+   Source File : EStateFileFormat.h
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#pragma once
+
+// format of the state file written by PDFWriter::Shutdown. ContinuePDF recognizes either one
+enum EStateFileFormat
+{
+    // PDF syntax objects, human readable, parsed back with PDFParser
+    eStateFileFormatPDF,
+    // compact binary snapshot, see StateSnapshot. mapped to memory and decoded on demand when continuing
+    eStateFileFormatBinary
+};
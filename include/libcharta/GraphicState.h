@@ -20,10 +20,35 @@
 */
 #pragma once
 
+#include <optional>
 #include <string>
+#include <utility>
+#include <vector>
 
 class PDFUsedFont;
 
+/*
+    Fill or stroke color. mColorSpace is the color space name (DeviceGray, DeviceRGB and DeviceCMYK for the device
+    color operators), empty when unknown. mComponentsCount is 0 when the components are unknown - following a color
+    space change, a pattern color, or components that this does not hold.
+*/
+struct GraphicStateColor
+{
+    std::string mColorSpace;
+    double mComponents[4];
+    int mComponentsCount;
+
+    GraphicStateColor();
+
+    bool Matches(const std::string &inColorSpace, const double *inComponents, int inComponentsCount) const;
+    void Set(const std::string &inColorSpace, const double *inComponents, int inComponentsCount);
+};
+
+/*
+    State that the content context follows while writing. Parameters are known only once the content sets them -
+    a content stream may run with an inherited state (forms, patterns, appended page content), so the PDF defaults
+    are not assumed. The CTM is relative to the start of the content.
+*/
 class GraphicState
 {
   public:
@@ -33,9 +58,35 @@ class GraphicState
 
     GraphicState &operator=(const GraphicState &inGraphicState);
 
+    // forget everything that can not be followed anymore, e.g. after free code was written
+    void Invalidate();
+
     // current font properties
     PDFUsedFont *mFont;
     double mFontSize;
     std::string mPlacedFontName;
     double mPlacedFontSize;
+
+    // colors
+    GraphicStateColor mFillColor;
+    GraphicStateColor mStrokeColor;
+
+    // line style
+    std::optional<double> mLineWidth;
+    std::optional<int> mLineCap;
+    std::optional<int> mLineJoin;
+    std::optional<double> mMiterLimit;
+    std::optional<std::pair<std::vector<double>, double>> mDashPattern;
+
+    // text state
+    std::optional<double> mCharacterSpacing;
+    std::optional<double> mWordSpacing;
+    std::optional<int> mHorizontalScaling;
+    std::optional<double> mLeading;
+    std::optional<int> mRenderingMode;
+    std::optional<double> mRise;
+
+    // transformation matrix, relative to the start of the content
+    bool mCTMKnown;
+    double mCTM[6];
 };
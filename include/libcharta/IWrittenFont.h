@@ -34,7 +34,7 @@ typedef std::list<GlyphUnicodeMappingList> GlyphUnicodeMappingListList;
 
 class FreeTypeFaceWrapper;
 class ObjectsContext;
-class PDFParser;
+class StateReader;
 
 class IWrittenFont
 {
@@ -62,5 +62,5 @@ class IWrittenFont
 
     // state read and write
     virtual charta::EStatusCode WriteState(ObjectsContext *inStateWriter, ObjectIDType inObjectID) = 0;
-    virtual charta::EStatusCode ReadState(PDFParser *inStateReader, ObjectIDType inObjectID) = 0;
+    virtual charta::EStatusCode ReadState(StateReader *inStateReader, ObjectIDType inObjectID) = 0;
 };
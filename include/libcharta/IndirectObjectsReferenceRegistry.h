@@ -24,17 +24,22 @@
     1. It maintains the reference list for all indirect objects (initially just their total count), and allowing to get
    a new object number
     2. It maintains file writing information, such as whether the object was written and if so at what position
+
+    Allocation and write marking are synchronized, so objects may be allocated from worker threads (say, by fonts
+    used in a PageContentBuffer) while the main thread writes.
 */
 
 #include "EStatusCode.h"
 #include "ObjectsBasicTypes.h"
 #include <stdint.h>
 #include <stdio.h>
+#include <mutex>
 #include <utility>
 #include <vector>
 
 class ObjectsContext;
 class PDFParser;
+class StateReader;
 
 struct ObjectWriteInformation
 {
@@ -69,20 +74,30 @@ class IndirectObjectsReferenceRegistry
     ~IndirectObjectsReferenceRegistry(void);
 
     ObjectIDType AllocateNewObjectID();
+    // allocate inCount consecutive object IDs, returning the first. the objects may be written by another objects
+    // context, which is setup with SetupReservedRange
+    ObjectIDType AllocateObjectIDRange(ObjectIDType inCount);
+
+    // restrict the registry to the inCount objects starting with inFirstObjectID, as allocated by
+    // AllocateObjectIDRange in the document registry. AllocateNewObjectID hands out IDs from that range.
+    // used by objects contexts that write into a private buffer
+    void SetupReservedRange(ObjectIDType inFirstObjectID, ObjectIDType inCount);
+    // first ID in the registry. 0, unless setup with a reserved range
+    ObjectIDType GetFirstObjectID() const;
 
     charta::EStatusCode MarkObjectAsWritten(ObjectIDType inObjectID, long long inWritePosition);
     GetObjectWriteInformationResult GetObjectWriteInformation(ObjectIDType inObjectID) const;
 
     ObjectIDType GetObjectsCount() const;
     // should be used with safe object IDs. use GetObjectsCount to verify the maximum ID
-    const ObjectWriteInformation &GetNthObjectReference(ObjectIDType inObjectID) const;
+    ObjectWriteInformation GetNthObjectReference(ObjectIDType inObjectID) const;
 
     // modified PDF methods
     charta::EStatusCode DeleteObject(ObjectIDType inObjectID);
     charta::EStatusCode MarkObjectAsUpdated(ObjectIDType inObjectID, long long inNewWritePosition);
 
     charta::EStatusCode WriteState(ObjectsContext *inStateWriter, ObjectIDType inObjectID);
-    charta::EStatusCode ReadState(PDFParser *inStateReader, ObjectIDType inObjectID);
+    charta::EStatusCode ReadState(StateReader *inStateReader, ObjectIDType inObjectID);
 
     void Reset();
 
@@ -90,6 +105,13 @@ class IndirectObjectsReferenceRegistry
 
   private:
     ObjectWriteInformationVector mObjectsWritesRegistry;
+    ObjectIDType mFirstObjectID;
+    ObjectIDType mNextReservedObjectID;
+    ObjectIDType mReservedRangeEnd;
+    mutable std::mutex mLock;
+
+    ObjectIDType AppendNewObjects(ObjectIDType inCount);
+    bool IsInRegistry(ObjectIDType inObjectID) const;
 
     void SetupInitialFreeObject();
     void AppendExistingItem(ObjectWriteInformation::EObjectReferenceType inObjectReferenceType,
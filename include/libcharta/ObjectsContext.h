@@ -25,6 +25,7 @@
 #include "IndirectObjectsReferenceRegistry.h"
 #include "PrimitiveObjectsWriter.h"
 #include "UppercaseSequence.h"
+#include "WriterStatistics.h"
 #include <list>
 #include <memory>
 #include <string>
@@ -34,10 +35,12 @@ namespace charta
 class IByteWriterWithPosition;
 }
 class DictionaryContext;
+class MyStringBuf;
 class PDFStream;
 class IObjectsContextExtender;
 class ObjectsContext;
 class PDFParser;
+class StateReader;
 class EncryptionHelper;
 
 typedef std::list<DictionaryContext *> DictionaryContextList;
@@ -63,8 +66,17 @@ class ObjectsContext
     charta::IByteWriterWithPosition *StartFreeContext();
     void EndFreeContext();
 
+    // Copy over objects that another objects context wrote to a buffer, using the IDs reserved for it here
+    // (inFirstObjectID and on, inObjectsCount of them). their positions are registered here, and reserved IDs that were
+    // not written are freed. fails if the other context allocated objects past the reserved ones
+    charta::EStatusCode CopyBufferedObjects(ObjectsContext &inBufferObjectsContext, MyStringBuf &inBuffer,
+                                            ObjectIDType inFirstObjectID, ObjectIDType inObjectsCount);
+
     // Get current output stream position
     long long GetCurrentPosition();
+    // Get the position up to which the output holds only complete objects - the start of the indirect object being
+    // written, or the current position if there is none. output before it is never touched again
+    long long GetCompletedPosition();
 
     // Get objects management object
     IndirectObjectsReferenceRegistry &GetInDirectObjectsRegistry();
@@ -120,17 +132,31 @@ class ObjectsContext
     void SetCompressStreams(bool inCompressStreams);
     bool IsCompressingStreams() const;
 
+    // Sets whether streams are written with a direct Length, instead of an indirect object that follows them. the
+    // stream content is then held in memory till the stream ends, and the output only ever gets complete objects
+    void SetDirectStreamLengths(bool inDirectStreamLengths);
+    bool IsWritingDirectStreamLengths() const;
+
     // Create PDF stream and write it's header. note that stream are written with indirect object for Length, to allow
-    // one pass writing. inStreamDictionary can be passed in order to include stream generic information in an already
-    // written stream dictionary that is type specific. [the method will take care of closing the dictionary.
+    // one pass writing (unless SetDirectStreamLengths is on). inStreamDictionary can be passed in order to include
+    // stream generic information in an already written stream dictionary that is type specific. [the method will take
+    // care of closing the dictionary.
     std::shared_ptr<PDFStream> StartPDFStream(DictionaryContext *inStreamDictionary = NULL,
                                               bool inForceDirectExtentObject = false);
     // same as StartPDFStream but forces the stream to create an unfiltered stream
     std::shared_ptr<PDFStream> StartUnfilteredPDFStream(DictionaryContext *inStreamDictionary = NULL);
     void EndPDFStream(std::shared_ptr<PDFStream> inStream);
 
+    // Statistics (optional, may be NULL). objects are accounted to the current category as they end, and streams
+    // report their raw and encoded sizes
+    void SetStatistics(WriterStatistics *inStatistics);
+    WriterStatistics *GetStatistics();
+    // returns the previous category, for restoring. see WriterStatisticsScope
+    EWriterStatisticsCategory SetStatisticsCategory(EWriterStatisticsCategory inCategory);
+
     // Extensibility
     void SetObjectsContextExtender(IObjectsContextExtender *inExtender);
+    IObjectsContextExtender *GetObjectsContextExtender();
 
     // as the obly common context around...i'm using the objects context to create
     // subset fonts prefixes. might want to consider a more relevant object...
@@ -140,7 +166,7 @@ class ObjectsContext
     void SetupModifiedFile(PDFParser *inModifiedFileParser);
 
     charta::EStatusCode WriteState(ObjectsContext *inStateWriter, ObjectIDType inObjectID);
-    charta::EStatusCode ReadState(PDFParser *inStateReader, ObjectIDType inObjectID);
+    charta::EStatusCode ReadState(StateReader *inStateReader, ObjectIDType inObjectID);
 
   private:
     IObjectsContextExtender *mExtender;
@@ -148,8 +174,13 @@ class ObjectsContext
     IndirectObjectsReferenceRegistry mReferencesRegistry;
     PrimitiveObjectsWriter mPrimitiveWriter;
     bool mCompressStreams;
+    bool mDirectStreamLengths;
     UppercaseSequence mSubsetFontsNamesSequance;
     EncryptionHelper *mEncryptionHelper;
+    WriterStatistics *mStatistics;
+    EWriterStatisticsCategory mStatisticsCategory;
+    long long mObjectStartPosition;
+    bool mIndirectObjectOpen;
 
     DictionaryContextList mDictionaryStack;
 
@@ -0,0 +1,86 @@
+/*
+   Source File : PDFSplitter.h
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#pragma once
+
+#include "EStatusCode.h"
+#include "PDFWriter.h"
+#include "io/InputFile.h"
+#include "parsing/PDFEmbedParameterTypes.h"
+#include "parsing/PDFParser.h"
+#include "parsing/PDFParsingOptions.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+/*
+    One output document of a split - the pages to copy into it, and where to write it.
+    Title is set for parts made from bookmarks.
+*/
+struct PDFSplitPart
+{
+    std::string OutputPath;
+    PDFPageRange PageRange;
+    std::string Title;
+};
+
+typedef std::vector<PDFSplitPart> PDFSplitPartVector;
+
+/*
+    Splits one source document into many. The source is opened and its xref parsed once, then the parts are written
+    concurrently, each by its own PDFWriter copying through its own PDFParserReader of the shared parser.
+    Resources shared between pages of a part are copied once per part.
+*/
+class PDFSplitter
+{
+  public:
+    PDFSplitter();
+    ~PDFSplitter();
+
+    charta::EStatusCode Open(const std::string &inSourcePath,
+                             const PDFParsingOptions &inOptions = PDFParsingOptions::DefaultPDFParsingOptions());
+
+    PDFParser &GetSourceParser();
+    unsigned long GetPagesCount() const;
+
+    // parts of inPagesPerPart pages each, the last one possibly shorter. output paths are left for the caller to fill
+    PDFSplitPartVector CreatePartsForEveryNPages(unsigned long inPagesPerPart);
+
+    // a part per top level bookmark, running from the bookmark page to the page before the next one. bookmarks that
+    // don't point at a page in the document are skipped, as are the pages before the first bookmark
+    charta::EStatusCode CreatePartsForBookmarks(PDFSplitPartVector &outParts);
+
+    // write the parts, using up to inThreadsCount threads (0 for the hardware concurrency). a part with an "All" page
+    // range gets the whole document. a failing part does not stop the others, but fails the split
+    charta::EStatusCode Split(const PDFSplitPartVector &inParts, unsigned int inThreadsCount = 0,
+                              const LogConfiguration &inLogConfiguration = LogConfiguration::DefaultLogConfiguration(),
+                              const PDFCreationSettings &inPDFCreationSettings = PDFCreationSettings(true, true));
+
+  private:
+    charta::InputFile mSourceFile;
+    PDFParser mParser;
+
+    long FindPageIndex(const std::shared_ptr<charta::PDFObject> &inDestination,
+                       const std::map<ObjectIDType, unsigned long> &inPageIndexes);
+    std::shared_ptr<charta::PDFObject> FindNamedDestination(const std::shared_ptr<charta::PDFObject> &inName);
+    std::shared_ptr<charta::PDFObject> FindInNameTree(const std::shared_ptr<charta::PDFDictionary> &inNode,
+                                                      const std::string &inName, int inDepth);
+};
@@ -26,10 +26,9 @@
 */
 
 #include "EStatusCode.h"
-#include "MyStringBuf.h"
 #include "ObjectsBasicTypes.h"
+#include "io/OutputChunkedBufferStream.h"
 #include "io/OutputFlateEncodeStream.h"
-#include "io/OutputStringBufferStream.h"
 #include <sstream>
 #include <stdint.h>
 #include <stdio.h>
@@ -41,6 +40,7 @@ class IByteWriterWithPosition;
 class IObjectsContextExtender;
 class DictionaryContext;
 class EncryptionHelper;
+class WriterStatistics;
 
 class PDFStream
 {
@@ -73,6 +73,9 @@ class PDFStream
     DictionaryContext *GetStreamDictionaryForDirectExtentStream();
     void FlushStreamContentForDirectExtentStream();
 
+    // report sizes, compression time and buffered memory to inStatistics (may be NULL). set before writing
+    void SetStatistics(WriterStatistics *inStatistics);
+
   private:
     bool mCompressStream;
     charta::OutputFlateEncodeStream mFlateEncodingStream;
@@ -83,7 +86,8 @@ class PDFStream
     long long mStreamStartPosition;
     charta::IByteWriter *mWriteStream;
     IObjectsContextExtender *mExtender;
-    MyStringBuf mTemporaryStream;
-    charta::OutputStringBufferStream mTemporaryOutputStream;
+    charta::OutputChunkedBufferStream mTemporaryStream;
     DictionaryContext *mStreamDictionaryContextForDirectExtentStream;
+    WriterStatistics *mStatistics;
+    size_t mReportedBufferedMemory;
 };
@@ -26,6 +26,7 @@
 #include "text/freetype/FreeTypeFaceWrapper.h"
 #include <list>
 #include <map>
+#include <mutex>
 #include <string>
 
 #include <ft2build.h>
@@ -38,7 +39,7 @@ typedef std::list<uint32_t> UIntList;
 
 class IWrittenFont;
 class ObjectsContext;
-class PDFParser;
+class StateReader;
 
 class PDFUsedFont
 {
@@ -110,7 +111,7 @@ class PDFUsedFont
                                                 GlyphUnicodeMappingList &outGlyphsUnicodeMapping);
 
     charta::EStatusCode WriteState(ObjectsContext *inStateWriter, ObjectIDType inObjectID);
-    charta::EStatusCode ReadState(PDFParser *inStateReader, ObjectIDType inObjectID);
+    charta::EStatusCode ReadState(StateReader *inStateReader, ObjectIDType inObjectID);
 
     FreeTypeFaceWrapper *GetFreeTypeFont();
 
@@ -134,4 +135,6 @@ class PDFUsedFont
     ObjectsContext *mObjectsContext;
     std::map<uint32_t, FT_Pos> mAdvanceCache;
     bool mEmbedFont;
+    // guards glyph translation and encoding, so content contexts on different threads may share the font
+    std::mutex mLock;
 };
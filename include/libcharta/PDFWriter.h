@@ -27,8 +27,10 @@
 
 #include "DocumentContext.h"
 #include "EPDFVersion.h"
+#include "EStateFileFormat.h"
 #include "ObjectsContext.h"
 #include "PDFRectangle.h"
+#include "WriterStatistics.h"
 #include "encryption/EncryptionOptions.h"
 #include "images/tiff/TIFFUsageParameters.h"
 #include "io/OutputFile.h"
@@ -67,6 +69,26 @@ struct PDFCreationSettings
     bool CompressStreams;
     bool EmbedFonts;
     EncryptionOptions DocumentEncryptionOptions;
+    // collect object, byte and timing statistics, see PDFWriter::GetStatistics
+    bool CollectStatistics;
+    // content contexts skip operators that do not change the graphic state, see AbstractContentContext
+    bool ElideRedundantOperators;
+    // write the output file from a background thread, while the next content is generated. file output only
+    bool AsynchronousFileOutput;
+    // with asynchronous file output, flush the file to the device (fsync) at EndPDF
+    bool SyncFileOnClose;
+    // write streams with direct lengths, so the output only ever holds complete objects, and what was written so far
+    // may be sent while the document is still being created. see PDFWriter::GetSafeToSendPosition
+    bool ProgressiveOutput;
+    // pixels per inch that JPEG and PNG images drawn with DrawImage are downsampled to, at the size they are drawn.
+    // only images larger than that are resampled. 0 embeds images as they are
+    double ImageTargetResolution;
+    // quality (1 to 100) for JPEG images recompressed after downsampling
+    int ImageJPEGQuality;
+    // worker threads decoding and compressing JPEG and PNG images drawn with DrawImage ahead of writing them, so the
+    // writing thread only copies the finished bytes. 0 to decode images on the writing thread. not for encrypted
+    // documents
+    unsigned int ImagePreparationThreads;
 
     PDFCreationSettings(bool inCompressStreams, bool inEmbedFonts,
                         EncryptionOptions inDocumentEncryptionOptions = EncryptionOptions::DefaultEncryptionOptions())
@@ -74,10 +96,19 @@ struct PDFCreationSettings
     {
         CompressStreams = inCompressStreams;
         EmbedFonts = inEmbedFonts;
+        CollectStatistics = false;
+        ElideRedundantOperators = false;
+        AsynchronousFileOutput = false;
+        SyncFileOnClose = false;
+        ProgressiveOutput = false;
+        ImageTargetResolution = 0;
+        ImageJPEGQuality = 85;
+        ImagePreparationThreads = 0;
     }
 };
 
 class PageContentContext;
+class PageContentBuffer;
 class PDFFormXObject;
 class PDFImageXObject;
 class PDFUsedFont;
@@ -106,6 +137,13 @@ class PDFWriter
         const PDFCreationSettings &inPDFCreationSettings = PDFCreationSettings(true, true));
     charta::EStatusCode EndPDFForStream();
 
+    // output position up to which the output stream holds complete objects, that will not change anymore. when
+    // streaming a document as it is created, bytes up to it may be sent. Objects are complete when their Write/End
+    // method returns (WritePage, EndPageContentContext, EndFormXObject etc.), and with
+    // PDFCreationSettings::ProgressiveOutput no object stays open across such calls. The catalog, page tree and xref
+    // are written by EndPDFForStream, after which all of the output is final
+    long long GetSafeToSendPosition();
+
     // in case of internal or external error, call this function to cleanup, in order to allow reuse of the PDFWriter
     // class
     void Reset();
@@ -121,8 +159,10 @@ class PDFWriter
         const LogConfiguration &inLogConfiguration = LogConfiguration::DefaultLogConfiguration(),
         const PDFCreationSettings &inPDFCreationSettings = PDFCreationSettings(true, true));
 
-    // Ending and Restarting writing session (optional input file is for modification scenarios)
-    charta::EStatusCode Shutdown(const std::string &inStateFilePath);
+    // Ending and Restarting writing session (optional input file is for modification scenarios).
+    // binary state files are faster to continue from, ContinuePDF recognizes either format
+    charta::EStatusCode Shutdown(const std::string &inStateFilePath,
+                                 EStateFileFormat inStateFileFormat = eStateFileFormatPDF);
     charta::EStatusCode ContinuePDF(
         const std::string &inOutputFilePath, const std::string &inStateFilePath,
         const std::string &inOptionalModifiedFile = "",
@@ -147,6 +187,12 @@ class PDFWriter
     EStatusCodeAndObjectIDType WritePageAndReturnPageID(PDFPage &inPage);
     EStatusCodeAndObjectIDType WritePageReleaseAndReturnPageID(PDFPage *inPage);
 
+    // Page parallel content generation. start a buffer per page on the writing thread, fill it on any thread
+    // and commit in page order on the writing thread. see PageContentBuffer.h
+    PageContentBuffer *StartPageContentBuffer(PDFPage &inPage, ObjectIDType inObjectsCount = 16);
+    charta::EStatusCode CommitPageContentBuffer(PageContentBuffer *inPageContentBuffer);
+    EStatusCodeAndObjectIDType CommitPageContentBufferAndReturnPageID(PageContentBuffer *inPageContentBuffer);
+
     // Form XObject creating and writing
     PDFFormXObject *StartFormXObject(const PDFRectangle &inBoundingBox, const double *inMatrix = NULL);
     PDFFormXObject *StartFormXObject(const PDFRectangle &inBoundingBox, ObjectIDType inFormXObjectID,
@@ -178,6 +224,12 @@ class PDFWriter
     PDFFormXObject *CreateFormXObjectFromJPGStream(charta::IByteReaderWithPosition *inJPGStream,
                                                    ObjectIDType inFormXObjectID);
 
+    // pixels already decoded to memory, say by a renderer. compressed straight from the described buffer, alpha
+    // becoming a soft mask. will return image xobject sized at 1X1
+    PDFImageXObject *CreateImageXObjectFromPixels(const charta::PixelsImageDescription &inPixels);
+    PDFImageXObject *CreateImageXObjectFromPixels(const charta::PixelsImageDescription &inPixels,
+                                                  ObjectIDType inImageXObjectID);
+
     // tiff
 #ifndef LIBCHARTA_NO_TIFF
     PDFFormXObject *CreateFormXObjectFromTIFFFile(const std::string &inTIFFFilePath,
@@ -193,6 +245,15 @@ class PDFWriter
                                                     ObjectIDType inFormXObjectID,
                                                     const charta::TIFFUsageParameters &inTIFFUsageParameters =
                                                         charta::TIFFUsageParameters::DefaultTIFFUsageParameters());
+    // multiple pages of a multipage tiff, opening it once. empty page indexes for all pages. see TIFFImageHandler
+    charta::PDFFormXObjectVector CreateFormXObjectsFromTIFFFile(
+        const std::string &inTIFFFilePath, const std::vector<unsigned long> &inPageIndexes = {},
+        const charta::TIFFUsageParameters &inTIFFUsageParameters =
+            charta::TIFFUsageParameters::DefaultTIFFUsageParameters());
+    charta::PDFFormXObjectVector CreateFormXObjectsFromTIFFStream(
+        charta::IByteReaderWithPosition *inTIFFStream, const std::vector<unsigned long> &inPageIndexes = {},
+        const charta::TIFFUsageParameters &inTIFFUsageParameters =
+            charta::TIFFUsageParameters::DefaultTIFFUsageParameters());
 #endif
 
     // png
@@ -265,6 +326,10 @@ class PDFWriter
         charta::IByteReaderWithPosition *inPDFStream,
         const PDFParsingOptions &inOptions = PDFParsingOptions::DefaultPDFParsingOptions());
 
+    // copying context over a source that is already parsed, and shared with other writers. each writer, possibly on
+    // its own thread, copies through its own PDFParserReader of the common parser
+    std::shared_ptr<charta::PDFDocumentCopyingContext> CreatePDFCopyingContext(PDFParserReader *inParserReader);
+
     // for modified file path, create a copying context for the modified file
     std::shared_ptr<charta::PDFDocumentCopyingContext> CreatePDFCopyingContextForModifiedFile();
 
@@ -290,6 +355,13 @@ class PDFWriter
     // URL should be encoded to be a valid URL, ain't gonna be checking that!
     charta::EStatusCode AttachURLLinktoCurrentPage(const std::string &inURL, const PDFRectangle &inLinkClickArea);
 
+    // statistics of the last production, when started with PDFCreationSettings::CollectStatistics. remains
+    // available after EndPDF, till the next production starts. see WriterStatistics.h
+    inline const WriterStatistics &GetStatistics() const
+    {
+        return mStatistics;
+    }
+
     // Extensibility, reaching to lower levels
     inline charta::DocumentContext &GetDocumentContext()
     {
@@ -331,9 +403,34 @@ class PDFWriter
                                           const PDFCreationSettings &inPDFCreationSettings,
                                           EPDFVersion inOveridePDFVersion = ePDFVersionUndefined);
 
+    // Optimization static methods. rewrite a document, typically one that went through many incremental updates, as a
+    // single revision. only objects reachable from the trailer Root and Info are kept, and they are renumbered
+    // densely. streams are copied as is, without decoding. the original encryption is dropped, pass encryption
+    // options in inPDFCreationSettings to encrypt the result
+    static charta::EStatusCode OptimizePDF(const std::string &inOriginalPDFPath, const std::string &inNewPDFPath,
+                                           const LogConfiguration &inLogConfiguration,
+                                           const PDFCreationSettings &inPDFCreationSettings,
+                                           const std::string &inOriginalPDFPassword = "");
+
+    static charta::EStatusCode OptimizePDF(charta::IByteReaderWithPosition *inOriginalPDFStream,
+                                           charta::IByteWriterWithPosition *inNewPDFStream,
+                                           const LogConfiguration &inLogConfiguration,
+                                           const PDFCreationSettings &inPDFCreationSettings,
+                                           const std::string &inOriginalPDFPassword = "");
+
   private:
+    // copy the whole source document, through its trailer Root (and Info, with inCopyInfo), into a new document
+    // started on inPDFWriter. ending the new document is left to the caller
+    static charta::EStatusCode DeepCopyPDF(PDFWriter &inPDFWriter, charta::IByteReaderWithPosition *inOriginalPDFStream,
+                                           const std::string &inOriginalPDFPassword,
+                                           charta::IByteWriterWithPosition *inNewPDFStream,
+                                           const LogConfiguration &inLogConfiguration,
+                                           const PDFCreationSettings &inPDFCreationSettings,
+                                           EPDFVersion inOveridePDFVersion, bool inCopyInfo);
+
     ObjectsContext mObjectsContext;
     charta::DocumentContext mDocumentContext;
+    WriterStatistics mStatistics;
 
     // for output file workflow, this will be the valid output [stream workflow does not have a file]
     charta::OutputFile mOutputFile;
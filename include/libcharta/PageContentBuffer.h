@@ -0,0 +1,92 @@
+/*
+   Source File : PageContentBuffer.h
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#pragma once
+/*
+    PageContentBuffer is used for generating page content on a worker thread, so pages can be produced in parallel.
+    The page content (and any other object the page needs, such as ExtGStates) is written by a private objects
+    context into an in-memory buffer, using a range of object IDs reserved in the document up front. When done, the
+    buffer is committed to the document, which appends it to the output and writes the page.
+
+    Typical usage:
+    1. On the main thread, for each page: PDFWriter::StartPageContentBuffer(page) (reserves the IDs)
+    2. On worker threads: draw with GetContentContext(), optionally Finalize()
+    3. On the main thread, in page order: PDFWriter::CommitPageContentBuffer(buffer) (writes the page, releases the
+       buffer)
+
+    Buffers are independent of each other and of the document output, so different buffers may be used on different
+    threads at the same time, while the main thread commits earlier pages. Fonts (PDFUsedFont) may be shared between
+    buffers. DrawImage, and other calls that register document level resources, are not synchronized - create
+    images and forms on the main thread before handing the pages out, and place them with Do.
+    Buffers cannot be used when the document is encrypted.
+*/
+
+#include "EStatusCode.h"
+#include "MyStringBuf.h"
+#include "ObjectsBasicTypes.h"
+#include "ObjectsContext.h"
+#include "io/OutputStringBufferStream.h"
+
+namespace charta
+{
+class DocumentContext;
+}
+class PageContentContext;
+class PDFPage;
+
+class PageContentBuffer
+{
+  public:
+    PageContentBuffer(charta::DocumentContext *inDocumentContext, PDFPage &inPage, ObjectIDType inFirstObjectID,
+                      ObjectIDType inObjectsCount, bool inCompressStreams);
+    ~PageContentBuffer();
+
+    // content context for the page. writes into the buffer
+    PageContentContext *GetContentContext();
+
+    // objects context writing into the buffer, for page specific objects. new objects get IDs from the reserved range
+    ObjectsContext &GetObjectsContext();
+
+    PDFPage &GetPage();
+
+    ObjectIDType GetFirstObjectID() const;
+    ObjectIDType GetObjectsCount() const;
+
+    // end the content context, flushing the current content stream. Commit does this as well, but calling it on the
+    // worker keeps stream compression off the committing thread
+    charta::EStatusCode Finalize();
+
+    // append the buffer to inTargetObjectsContext output, and register the reserved objects with it.
+    // reserved IDs that were not used are marked as free. called by the document when committing
+    charta::EStatusCode WriteTo(ObjectsContext *inTargetObjectsContext);
+
+  private:
+    charta::DocumentContext *mDocumentContext;
+    PDFPage &mPage;
+    ObjectIDType mFirstObjectID;
+    ObjectIDType mObjectsCount;
+    MyStringBuf mBuffer;
+    charta::OutputStringBufferStream mOutputStream;
+    ObjectsContext mObjectsContext;
+    PageContentContext *mContentContext;
+    size_t mReportedBufferedMemory;
+
+    void UpdateBufferedMemory();
+};
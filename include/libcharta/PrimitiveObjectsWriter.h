@@ -57,8 +57,13 @@ class PrimitiveObjectsWriter
 
     charta::IByteWriter *GetWritingStream();
 
+    // the text of WriteDouble - fixed notation, 6 decimals, trailing zeros trimmed - into outBuffer, which should
+    // hold scMaxDoubleLength chars. returns the length. for formatting many numbers into one buffer before writing it
+    static constexpr size_t scMaxDoubleLength = 330;
+    static size_t FormatDouble(double inDoubleToken, char *outBuffer);
+
   private:
     charta::IByteWriter *mStreamForWriting;
 
-    size_t DetermineDoubleTrimmedLength(const std::string &inString);
+    static size_t DetermineDoubleTrimmedLength(const char *inString, size_t inLength);
 };
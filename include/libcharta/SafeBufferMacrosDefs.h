@@ -65,12 +65,14 @@ std::wstring UTF8ToUTF16Wide(const std::string &inUTF8String)
     swprintf_s(BUFFER, BUFFER_SIZE, FORMAT, ARG1, ARG2, ARG3, ARG4, ARG5, ARG6)
 #ifdef __MINGW32__
 #define SAFE_LOCAL_TIME(structuredLocalTime, currentTime) structuredLocalTime = *localtime(&currentTime)
+#define SAFE_GM_TIME(structuredGMTime, currentTime) structuredGMTime = *gmtime(&currentTime)
 #define SAFE_FSEEK64(FILESTREAM_P, SEEK, SEEK_DIRECTION) fseeko64(FILESTREAM_P, SEEK, SEEK_DIRECTION)
 #define SAFE_FTELL64(FILESTREAM_P) ftello64(FILESTREAM_P)
 #define SAFE_VSPRINTF(BUFFER, BUFFER_SIZE, FORMAT, ARGLIST) vsnprintf(BUFFER, BUFFER_SIZE, FORMAT, ARGLIST)
 #define sprintf_s snprintf
 #else
 #define SAFE_LOCAL_TIME(structuredLocalTime, currentTime) localtime_s(&structuredLocalTime, &currentTime)
+#define SAFE_GM_TIME(structuredGMTime, currentTime) gmtime_s(&structuredGMTime, &currentTime)
 #define SAFE_FSEEK64(FILESTREAM_P, SEEK, SEEK_DIRECTION) _fseeki64(FILESTREAM_P, SEEK, SEEK_DIRECTION)
 #define SAFE_FTELL64(FILESTREAM_P) _ftelli64(FILESTREAM_P)
 #define SAFE_VSPRINTF(BUFFER, BUFFER_SIZE, FORMAT, ARGLIST) vsprintf_s(BUFFER, BUFFER_SIZE, FORMAT, ARGLIST)
@@ -104,7 +106,8 @@ std::wstring UTF8ToUTF16Wide(const std::string &inUTF8String)
     swprintf(BUFFER, FORMAT, ARG1, ARG2, ARG3, ARG4, ARG5)
 #define SAFE_SWPRINTF_6(BUFFER, BUFFER_SIZE, FORMAT, ARG1, ARG2, ARG3, ARG4, ARG5, ARG6)                               \
     swprintf(BUFFER, FORMAT, ARG1, ARG2, ARG3, ARG4, ARG5, ARG6)
-#define SAFE_LOCAL_TIME(structuredLocalTime, currentTime) structuredLocalTime = *localtime(&currentTime)
+#define SAFE_LOCAL_TIME(structuredLocalTime, currentTime) localtime_r(&currentTime, &structuredLocalTime)
+#define SAFE_GM_TIME(structuredGMTime, currentTime) gmtime_r(&currentTime, &structuredGMTime)
 #define SAFE_VSWPRINTF(BUFFER, BUFFER_SIZE, FORMAT, ARGLIST) vswprintf(BUFFER, FORMAT, ARGLIST)
 #define SAFE_VSPRINTF(BUFFER, BUFFER_SIZE, FORMAT, ARGLIST) vsprintf(BUFFER, FORMAT, ARGLIST)
 #define SAFE_FOPEN(FILESTREAM_P, FILE_PATH, MODE)                                                                      \
@@ -22,6 +22,7 @@
 
 #include "EStatusCode.h"
 #include "ObjectsBasicTypes.h"
+#include "StateSnapshot.h"
 #include "io/InputFile.h"
 #include "parsing/PDFParser.h"
 
@@ -33,13 +34,20 @@ class StateReader
     StateReader(void);
     ~StateReader(void);
 
+    // reads either state file format, recognizing binary snapshots by their magic
     charta::EStatusCode Start(const std::string &inStateFilePath);
-    PDFParser *GetObjectsReader();
     ObjectIDType GetRootObjectID() const;
     void Finish();
 
+    // objects access, for the ReadState implementations
+    std::shared_ptr<charta::PDFObject> ParseNewObject(ObjectIDType inObjectID);
+    std::shared_ptr<charta::PDFObject> QueryDictionaryObject(const std::shared_ptr<charta::PDFDictionary> &inDictionary,
+                                                             const std::string &inName);
+
   private:
     PDFParser mParser;
     charta::InputFile mInputFile;
+    StateSnapshot mSnapshot;
+    bool mIsSnapshot;
     ObjectIDType mRootObject;
 };
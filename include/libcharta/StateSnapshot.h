@@ -0,0 +1,87 @@
+/*
+   Source File : StateSnapshot.h
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#pragma once
+
+#include "EStatusCode.h"
+#include "ObjectsBasicTypes.h"
+
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class PDFParser;
+
+namespace charta
+{
+class PDFObject;
+}
+
+/*
+    StateSnapshot - binary form of a state file, for writers that are shut down and continued often.
+
+    Layout, numbers are little endian:
+        header:  8 bytes magic, uint32 format version, uint32 CRC32 of all that follows the header,
+                 uint64 objects count, uint64 root object ID, uint64 position of the objects table
+        objects: a type tag followed by the value. integers, IDs and lengths are varints (integers zigzagged),
+                 reals are 8 byte IEEE doubles, strings and names are length prefixed bytes
+        table:   a uint64 position per object ID, 0 for free objects
+
+    Open maps the file to memory (reads it whole where mapping is not available) and verifies version and checksum.
+    Objects are decoded on demand, straight from the mapped bytes.
+*/
+class StateSnapshot
+{
+  public:
+    StateSnapshot();
+    ~StateSnapshot();
+
+    // write the objects of a PDF syntax state, as parsed by inStateParser, to a snapshot file
+    static charta::EStatusCode Write(PDFParser &inStateParser, ObjectIDType inRootObjectID,
+                                     const std::string &inSnapshotFilePath);
+
+    // true if the file starts with the snapshot magic
+    static bool IsSnapshotFile(const std::string &inFilePath);
+
+    charta::EStatusCode Open(const std::string &inSnapshotFilePath);
+    void Close();
+
+    ObjectIDType GetRootObjectID() const;
+    ObjectIDType GetObjectsCount() const;
+
+    // decode an object. nullptr for free or malformed objects
+    std::shared_ptr<charta::PDFObject> ParseNewObject(ObjectIDType inObjectID);
+
+  private:
+    const uint8_t *mData;
+    size_t mSize;
+    void *mMapping;
+    std::vector<uint8_t> mBuffer;
+
+    ObjectIDType mObjectsCount;
+    ObjectIDType mRootObjectID;
+    uint64_t mTablePosition;
+
+    charta::EStatusCode LoadFile(const std::string &inSnapshotFilePath);
+    std::shared_ptr<charta::PDFObject> DecodeObject(size_t &ioPosition, int inDepth);
+    bool DecodeVarInt(size_t &ioPosition, uint64_t &outValue);
+    bool DecodeBytes(size_t &ioPosition, std::string &outValue);
+};
@@ -20,9 +20,11 @@
 */
 #pragma once
 
+#include "EStateFileFormat.h"
 #include "EStatusCode.h"
 #include "ObjectsBasicTypes.h"
 #include "io/OutputFile.h"
+#include "io/OutputStringBufferStream.h"
 #include <stdint.h>
 #include <stdio.h>
 
@@ -36,7 +38,8 @@ class StateWriter
     StateWriter(void);
     virtual ~StateWriter(void);
 
-    charta::EStatusCode Start(const std::string &inStateFilePath);
+    // binary format states are composed in memory and converted to a StateSnapshot on Finish
+    charta::EStatusCode Start(const std::string &inStateFilePath, EStateFileFormat inFormat = eStateFileFormatPDF);
     ObjectsContext *GetObjectsWriter();
     void SetRootObject(ObjectIDType inRootObjectID);
     charta::EStatusCode Finish();
@@ -44,9 +47,13 @@ class StateWriter
   private:
     ObjectsContext *mObjectsContext;
     charta::OutputFile mOutputFile;
+    charta::OutputStringBufferStream mOutputBuffer;
+    std::string mStateFilePath;
+    EStateFileFormat mFormat;
     ObjectIDType mRootObject;
 
     void WriteTrailerDictionary();
     void WriteXrefReference(long long inXrefTablePosition);
     void WriteFinalEOF();
+    charta::EStatusCode WriteSnapshot();
 };
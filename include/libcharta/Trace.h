@@ -24,6 +24,8 @@
 
 #include <string.h>
 
+#include <atomic>
+#include <mutex>
 #include <string>
 
 // good for tracing upto 5K wide chars messages
@@ -35,6 +37,9 @@ class IByteWriter;
 }
 #define MAX_TRACE_SIZE 50001
 
+/*
+    Process wide trace log. Tracing and changing the settings may happen from any thread, and are serialized
+*/
 class Trace
 {
   public:
@@ -50,16 +55,15 @@ class Trace
     static Trace &DefaultTrace();
 
   private:
+    // guards all members. mShouldLog is also read without it, so tracing costs nothing while logging is off
+    std::mutex mLock;
     char mBuffer[MAX_TRACE_SIZE];
     Log *mLog;
 
     std::string mLogFilePath;
     charta::IByteWriter *mLogStream;
-    bool mShouldLog;
+    std::atomic<bool> mShouldLog;
     bool mPlaceUTF8Bom;
-
-    // use the log
-    // make it lock safe
 };
 
 // short cuts for logging formats strings
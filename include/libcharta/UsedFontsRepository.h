@@ -30,7 +30,7 @@
 class FreeTypeWrapper;
 class PDFUsedFont;
 class ObjectsContext;
-class PDFParser;
+class StateReader;
 
 typedef std::pair<std::string, long> StringAndLong;
 typedef std::map<StringAndLong, PDFUsedFont *> StringAndLongToPDFUsedFontMap;
@@ -53,7 +53,7 @@ class UsedFontsRepository
     charta::EStatusCode WriteUsedFontsDefinitions();
 
     charta::EStatusCode WriteState(ObjectsContext *inStateWriter, ObjectIDType inObjectID);
-    charta::EStatusCode ReadState(PDFParser *inStateReader, ObjectIDType inObjectID);
+    charta::EStatusCode ReadState(StateReader *inStateReader, ObjectIDType inObjectID);
 
     void Reset();
 
@@ -0,0 +1,137 @@
+/*
+   Source File : WriterStatistics.h
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#pragma once
+/*
+    WriterStatistics collects where the bytes and the time of a PDF production go. Turn it on with
+    PDFCreationSettings::CollectStatistics and query it with PDFWriter::GetStatistics, after EndPDF.
+
+    - objects and bytes are accounted per category. the category is decided by what the writer is doing when an
+      indirect object ends (see WriterStatisticsScope), anything outside of a known activity goes to "other"
+    - stream bytes are the bytes handed to streams before compression vs. the bytes they occupy in the file
+    - phase times are wall clock and inclusive. so image decoding time includes the compression of the image
+      stream, which is also counted under compression
+    - buffered memory is the content held in memory waiting to be written - direct extent streams, page content
+      buffers and prepared images
+
+    Counters are atomic, so streams, page content buffers and prepared images on worker threads may report too.
+*/
+
+#include <atomic>
+#include <chrono>
+#include <stddef.h>
+#include <string>
+
+class ObjectsContext;
+
+enum EWriterStatisticsCategory
+{
+    eWriterStatisticsCategoryContent, // page, form and pattern content
+    eWriterStatisticsCategoryImages,
+    eWriterStatisticsCategoryFonts,
+    eWriterStatisticsCategoryXref, // xref table or stream, and the trailer
+    eWriterStatisticsCategoryMetadata,
+    eWriterStatisticsCategoryCopied, // objects copied from other PDFs
+    eWriterStatisticsCategoryOther,  // page tree, catalog, annotations and whatever else
+
+    eWriterStatisticsCategoryCount
+};
+
+enum EWriterStatisticsPhase
+{
+    eWriterStatisticsPhaseCompression,
+    eWriterStatisticsPhaseFontSubsetting,
+    eWriterStatisticsPhaseImageDecoding,
+    eWriterStatisticsPhasePDFCopying,
+
+    eWriterStatisticsPhaseCount
+};
+
+class WriterStatistics
+{
+  public:
+    WriterStatistics();
+
+    void Reset();
+
+    // recording
+    void AddObject(EWriterStatisticsCategory inCategory, unsigned long long inBytes);
+    // bytes that are not part of an indirect object, like the xref table
+    void AddBytes(EWriterStatisticsCategory inCategory, unsigned long long inBytes);
+    void AddStream(unsigned long long inRawBytes, unsigned long long inEncodedBytes);
+    void AddPhaseTime(EWriterStatisticsPhase inPhase, unsigned long long inNanoseconds);
+    void AddBufferedMemory(size_t inBytes);
+    void ReleaseBufferedMemory(size_t inBytes);
+    void SetOutputBytes(unsigned long long inBytes);
+
+    // queries
+    unsigned long long GetObjectsCount(EWriterStatisticsCategory inCategory) const;
+    unsigned long long GetObjectsCount() const; // all categories
+    unsigned long long GetBytes(EWriterStatisticsCategory inCategory) const;
+    unsigned long long GetStreamsCount() const;
+    unsigned long long GetRawStreamBytes() const;
+    unsigned long long GetEncodedStreamBytes() const;
+    unsigned long long GetPhaseNanoseconds(EWriterStatisticsPhase inPhase) const;
+    double GetPhaseSeconds(EWriterStatisticsPhase inPhase) const;
+    size_t GetBufferedMemory() const;
+    size_t GetPeakBufferedMemory() const;
+    unsigned long long GetOutputBytes() const;
+
+    // all of the above as a JSON object
+    std::string ToJSON() const;
+
+    static const char *GetCategoryName(EWriterStatisticsCategory inCategory);
+    static const char *GetPhaseName(EWriterStatisticsPhase inPhase);
+
+  private:
+    std::atomic<unsigned long long> mObjectsCount[eWriterStatisticsCategoryCount];
+    std::atomic<unsigned long long> mBytes[eWriterStatisticsCategoryCount];
+    std::atomic<unsigned long long> mStreamsCount;
+    std::atomic<unsigned long long> mRawStreamBytes;
+    std::atomic<unsigned long long> mEncodedStreamBytes;
+    std::atomic<unsigned long long> mPhaseNanoseconds[eWriterStatisticsPhaseCount];
+    std::atomic<size_t> mBufferedMemory;
+    std::atomic<size_t> mPeakBufferedMemory;
+    std::atomic<unsigned long long> mOutputBytes;
+};
+
+/*
+    Scope of a writer activity. Sets the category that objects ended within it are accounted to (restoring the
+    previous one on exit) and, optionally, times a phase. Nested scopes of the same phase on one thread are timed
+    once, by the outermost. Does nothing when the objects context does not collect statistics.
+*/
+class WriterStatisticsScope
+{
+  public:
+    WriterStatisticsScope(ObjectsContext *inObjectsContext, EWriterStatisticsCategory inCategory,
+                          EWriterStatisticsPhase inPhase = eWriterStatisticsPhaseCount);
+    ~WriterStatisticsScope();
+
+    WriterStatisticsScope(const WriterStatisticsScope &) = delete;
+    WriterStatisticsScope &operator=(const WriterStatisticsScope &) = delete;
+
+  private:
+    ObjectsContext *mObjectsContext;
+    WriterStatistics *mStatistics;
+    EWriterStatisticsCategory mPreviousCategory;
+    EWriterStatisticsPhase mPhase;
+    bool mTimed;
+    std::chrono::steady_clock::time_point mStart;
+};
@@ -35,7 +35,7 @@ class WrittenFontCFF : public AbstractWrittenFont
     virtual charta::EStatusCode WriteFontDefinition(FreeTypeFaceWrapper &inFontInfo, bool inEmbedFont);
 
     virtual charta::EStatusCode WriteState(ObjectsContext *inStateWriter, ObjectIDType inObjectId);
-    virtual charta::EStatusCode ReadState(PDFParser *inStateReader, ObjectIDType inObjectID);
+    virtual charta::EStatusCode ReadState(StateReader *inStateReader, ObjectIDType inObjectID);
 
   private:
     virtual bool AddToANSIRepresentation(const GlyphUnicodeMappingList &inGlyphsList, UShortList &outEncodedCharacters);
@@ -31,7 +31,7 @@ class IByteWriterWithPosition;
 }
 class ObjectsContext;
 class DecryptionHelper;
-class PDFParser;
+class StateReader;
 
 class EncryptionHelper
 {
@@ -97,7 +97,7 @@ class EncryptionHelper
 
     // state read/write support
     charta::EStatusCode WriteState(ObjectsContext *inStateWriter, ObjectIDType inObjectID);
-    charta::EStatusCode ReadState(PDFParser *inStateReader, ObjectIDType inObjectID);
+    charta::EStatusCode ReadState(StateReader *inStateReader, ObjectIDType inObjectID);
 
   private:
     // named xcrypts, for V4
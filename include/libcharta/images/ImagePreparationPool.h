@@ -0,0 +1,71 @@
+/*
+   Source File : ImagePreparationPool.h
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#pragma once
+
+#include "EStatusCode.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace charta
+{
+class PreparedImage;
+
+/*
+    Worker threads that prepare images (see PreparedImage) ahead of their writing, so decoding and compression of
+    the images on a page run in parallel while the content is still being generated. Images are prepared in the
+    order they are submitted. Waiting for an image that no worker took yet prepares it on the waiting thread.
+*/
+class ImagePreparationPool
+{
+  public:
+    ImagePreparationPool();
+    ~ImagePreparationPool();
+
+    // 0 (the default) to not use the pool. threads start with the first submitted image
+    void SetThreadsCount(unsigned int inThreadsCount);
+    unsigned int GetThreadsCount() const;
+
+    // queue an image for preparation. the image must stay alive till waited for
+    void Submit(PreparedImage *inImage);
+    // wait for the image to be prepared, and return the preparation status
+    EStatusCode Wait(PreparedImage *inImage);
+
+    // finish the images being prepared, drop the queued ones and stop the threads
+    void Stop();
+
+  private:
+    unsigned int mThreadsCount;
+    std::vector<std::thread> mThreads;
+    std::mutex mLock;
+    std::condition_variable mImageQueued;
+    std::condition_variable mImageDone;
+    std::deque<PreparedImage *> mQueue;
+    std::set<PreparedImage *> mPreparing;
+    bool mStopping;
+
+    void WorkerLoop();
+};
+} // namespace charta
@@ -0,0 +1,93 @@
+/*
+   Source File : PreparedImage.h
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#pragma once
+/*
+    PreparedImage is a JPEG or PNG image xobject (and its soft mask, if it has one) written ahead of time into an
+    in-memory buffer. Prepare does all of the work - reading the file, decoding, downsampling and compressing - with
+    private image handlers and a private objects context that uses object IDs reserved in the document, so it may
+    run on any thread (see ImagePreparationPool). WriteTo, on the writing thread, then only appends the finished
+    bytes to the output and registers the objects, the way PageContentBuffer does for pages.
+    Prepared images cannot be used when the document is encrypted.
+*/
+
+#include "EHummusImageType.h"
+#include "EStatusCode.h"
+#include "MyStringBuf.h"
+#include "ObjectsBasicTypes.h"
+#include "ObjectsContext.h"
+#include "io/OutputStringBufferStream.h"
+
+#include <stdint.h>
+#include <string>
+
+class PDFImageXObject;
+class WriterStatistics;
+
+namespace charta
+{
+class PreparedImage
+{
+  public:
+    // object IDs to reserve for an image - the image and its soft mask
+    static const ObjectIDType ObjectsCount = 2;
+
+    // inWidth and inHeight are the pixels size to downsample to, 0 to keep the image as is. inFirstObjectID starts a
+    // range of ObjectsCount IDs, reserved with IndirectObjectsReferenceRegistry::AllocateObjectIDRange
+    PreparedImage(const std::string &inImagePath, EHummusImageType inImageType, uint32_t inWidth, uint32_t inHeight,
+                  int inJPEGQuality, ObjectIDType inFirstObjectID, bool inCompressStreams,
+                  WriterStatistics *inStatistics);
+    ~PreparedImage();
+
+    // whether images of the type can be written by PrepareImageXObject, as is or downsampled
+    static bool CanPrepare(EHummusImageType inImageType, bool inDownsample);
+
+    // decode the image, and write it (downsampled if so asked) as an image xobject with inObjectsContext, which may
+    // be the document objects context or a private one. returns nullptr, with no object written, if the image
+    // cannot be decoded
+    static PDFImageXObject *PrepareImageXObject(ObjectsContext *inObjectsContext, const std::string &inImagePath,
+                                                EHummusImageType inImageType, uint32_t inWidth, uint32_t inHeight,
+                                                int inJPEGQuality);
+
+    // write the image into the buffer. may run on any thread
+    EStatusCode Prepare();
+    bool IsPrepared() const;
+
+    // append the buffer to inTargetObjectsContext output, and register the reserved objects with it. reserved IDs
+    // that were not used, or all of them if the image failed to prepare, are marked as free
+    EStatusCode WriteTo(ObjectsContext *inTargetObjectsContext);
+
+    // the image, for placing it. available once prepared
+    PDFImageXObject *GetImageXObject();
+
+  private:
+    std::string mImagePath;
+    EHummusImageType mImageType;
+    uint32_t mWidth;
+    uint32_t mHeight;
+    int mJPEGQuality;
+    ObjectIDType mFirstObjectID;
+    MyStringBuf mBuffer;
+    OutputStringBufferStream mOutputStream;
+    ObjectsContext mObjectsContext;
+    PDFImageXObject *mImageXObject;
+    size_t mReportedBufferedMemory;
+};
+} // namespace charta
@@ -0,0 +1,46 @@
+/*
+   Source File : JPEGImageEncoder.h
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#pragma once
+
+#ifndef LIBCHARTA_NO_DCT
+
+#include "EStatusCode.h"
+#include "images/pixels/PixelsImageDescription.h"
+
+namespace charta
+{
+class IByteWriter;
+
+// encodes pixels to a JPEG stream, with libjpeg. 8 bits gray, RGB or CMYK pixels only
+class JPEGImageEncoder
+{
+  public:
+    // quality 1 to 100, as with libjpeg's quality scaling
+    JPEGImageEncoder(int inQuality = 85);
+
+    EStatusCode Encode(const PixelsImageDescription &inPixels, IByteWriter *inOutputStream);
+
+  private:
+    int mQuality;
+};
+} // namespace charta
+
+#endif
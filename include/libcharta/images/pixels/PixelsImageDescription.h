@@ -0,0 +1,59 @@
+/*
+   Source File : PixelsImageDescription.h
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace charta
+{
+// order of the components of a pixel. alpha, when there, comes last
+enum EPixelsLayout
+{
+    ePixelsLayoutGray,
+    ePixelsLayoutGrayAlpha,
+    ePixelsLayoutRGB,
+    ePixelsLayoutRGBA,
+    ePixelsLayoutCMYK
+};
+
+// describes pixels already decoded to memory, for PixelsImageHandler. the memory is read as is, and is not retained
+struct PixelsImageDescription
+{
+    // first row of samples. rows go top to bottom
+    const uint8_t *Pixels = nullptr;
+    uint32_t Width = 0;
+    uint32_t Height = 0;
+
+    // bytes from the start of one row to the start of the next. 0 for rows that are packed tight
+    size_t Stride = 0;
+
+    EPixelsLayout Layout = ePixelsLayoutRGB;
+
+    // 1, 2, 4, 8 or 16. layouts with alpha take 8 or 16 only. 16 bits samples are big endian, as PDF has them, and
+    // sub byte samples are packed with each row starting on a byte boundary
+    int BitsPerComponent = 8;
+
+    // filter rows with PNG predictors ahead of compression. costs a few passes over each row, but makes for much
+    // smaller streams with rendered images (flat colors and gradients). ignored if streams are not compressed
+    bool UsePredictors = false;
+};
+} // namespace charta
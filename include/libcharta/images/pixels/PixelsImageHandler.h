@@ -0,0 +1,51 @@
+/*
+   Source File : PixelsImageHandler.h
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#pragma once
+
+#include "ObjectsBasicTypes.h"
+#include "images/pixels/PixelsImageDescription.h"
+
+class ObjectsContext;
+class PDFImageXObject;
+
+namespace charta
+{
+/*
+    Writes image XObjects from pixels that are already decoded in memory, such as the output of a renderer, with no
+    round trip through an image file format. Samples are compressed straight from the caller's memory, and an alpha
+    channel turns into an /SMask image.
+*/
+class PixelsImageHandler
+{
+  public:
+    PixelsImageHandler();
+
+    // DocumentContext::CreateImageXObjectFromPixels are equivalent. will return image xobject sized at 1X1
+    PDFImageXObject *CreateImageXObjectFromPixels(const PixelsImageDescription &inPixels);
+    PDFImageXObject *CreateImageXObjectFromPixels(const PixelsImageDescription &inPixels,
+                                                  ObjectIDType inImageXObjectID);
+
+    void SetObjectsContext(ObjectsContext *inObjectsContext);
+
+  private:
+    ObjectsContext *mObjectsContext;
+};
+} // namespace charta
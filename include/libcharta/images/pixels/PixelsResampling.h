@@ -0,0 +1,47 @@
+/*
+   Source File : PixelsResampling.h
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#pragma once
+
+#include "images/pixels/PixelsImageDescription.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace charta
+{
+// decoded image held in memory. 8 bits per component, rows packed tight
+struct PixelsBuffer
+{
+    std::vector<uint8_t> Pixels;
+    uint32_t Width = 0;
+    uint32_t Height = 0;
+    EPixelsLayout Layout = ePixelsLayoutRGB;
+
+    size_t GetComponentsCount() const;
+    // description for PixelsImageHandler
+    PixelsImageDescription Describe() const;
+};
+
+// area average (box filter) downsampling, each target pixel being the average of the source area it covers. the
+// target may not be larger than the source in either direction. computed in fixed point over a couple of rows at a
+// time, with loops that compilers vectorize
+PixelsBuffer DownsamplePixels(const PixelsBuffer &inSource, uint32_t inWidth, uint32_t inHeight);
+} // namespace charta
@@ -21,6 +21,7 @@
 #pragma once
 
 #ifndef LIBCHARTA_NO_PNG
+#include "EStatusCode.h"
 #include "ObjectsBasicTypes.h"
 
 #include <utility>
@@ -31,6 +32,7 @@ namespace charta
 {
 class IByteReaderWithPosition;
 class DocumentContext;
+struct PixelsBuffer;
 
 class PNGImageHandler
 {
@@ -51,6 +53,8 @@ class PNGImageHandler
 
     std::pair<double, double> ReadImageDimensions(IByteReaderWithPosition *inPNGStream);
     PNGImageInfo ReadImageInfo(IByteReaderWithPosition *inPNGStream);
+    // decode the image to memory, at 8 bits per component, as gray, gray and alpha, RGB or RGBA
+    EStatusCode ReadImagePixels(IByteReaderWithPosition *inPNGStream, PixelsBuffer &outPixels);
 
   private:
     ObjectsContext *mObjectsContext;
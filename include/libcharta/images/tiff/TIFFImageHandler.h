@@ -83,6 +83,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 // tiff lib includes
 #include <tiffconf.h>
@@ -104,6 +105,7 @@ class IByteReaderWithPosition;
 
 using ObjectIDTypeList = std::list<ObjectIDType>;
 using PDFImageXObjectList = std::list<PDFImageXObject *>;
+using PDFFormXObjectVector = std::vector<PDFFormXObject *>;
 
 using ImageSizeProc = std::function<tsize_t(T2P *inT2p)>;
 
@@ -134,6 +136,16 @@ class TIFFImageHandler
         IByteReaderWithPosition *inTIFFStream, ObjectIDType inFormXObjectID,
         const TIFFUsageParameters &inTIFFUsageParameters = TIFFUsageParameters::DefaultTIFFUsageParameters());
 
+    // create form XObjects from multiple pages of a tiff, opening and indexing it once. pass the 0 based indexes of
+    // the pages to convert, or an empty list for all of them. the result has an entry per requested page, in order,
+    // which is nullptr where a page failed to convert. PageIndex of the usage parameters is ignored
+    PDFFormXObjectVector CreateFormXObjectsFromTIFFFile(
+        const std::string &inTIFFFilePath, const std::vector<unsigned long> &inPageIndexes = {},
+        const TIFFUsageParameters &inTIFFUsageParameters = TIFFUsageParameters::DefaultTIFFUsageParameters());
+    PDFFormXObjectVector CreateFormXObjectsFromTIFFStream(
+        IByteReaderWithPosition *inTIFFStream, const std::vector<unsigned long> &inPageIndexes = {},
+        const TIFFUsageParameters &inTIFFUsageParameters = TIFFUsageParameters::DefaultTIFFUsageParameters());
+
     void SetOperationsContexts(DocumentContext *inContainerDocumentContext, ObjectsContext *inObjectsContext);
     void SetDocumentContextExtender(IDocumentContextExtender *inExtender);
 
@@ -155,6 +167,7 @@ class TIFFImageHandler
 
     void InitializeConversionState();
     void DestroyConversionState();
+    void ResetPageConversionState();
     PDFFormXObject *ConvertTiff2PDF(ObjectIDType inFormXObjectID);
     EStatusCode ReadTopLevelTiffInformation();
     EStatusCode ReadTIFFPageInformation();
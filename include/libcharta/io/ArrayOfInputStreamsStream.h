@@ -29,11 +29,14 @@ namespace charta
 class PDFArray;
 }
 class PDFParser;
+class PDFParserReader;
 
 class ArrayOfInputStreamsStream : public charta::IByteReader
 {
   public:
     ArrayOfInputStreamsStream(std::shared_ptr<charta::PDFArray> inArrayOfStreams, PDFParser *inParser);
+    // reads the streams with a parser reader, rather than the parser itself
+    ArrayOfInputStreamsStream(std::shared_ptr<charta::PDFArray> inArrayOfStreams, PDFParserReader *inReader);
     virtual ~ArrayOfInputStreamsStream(void);
 
     // IByteReader implementation
@@ -45,6 +48,7 @@ class ArrayOfInputStreamsStream : public charta::IByteReader
 
     charta::IByteReader *mCurrentStream;
     PDFParser *mParser;
+    PDFParserReader *mReader;
     std::shared_ptr<charta::PDFArray> mArray;
     unsigned long mCurrentIndex;
 };
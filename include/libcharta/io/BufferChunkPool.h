@@ -0,0 +1,67 @@
+/*
+   Source File : BufferChunkPool.h
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#pragma once
+
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace charta
+{
+
+constexpr size_t DEFAULT_BUFFER_CHUNK_SIZE = 64 * 1024;
+constexpr size_t DEFAULT_BUFFER_CHUNK_POOL_LIMIT = 64;
+
+/*
+    Pool of fixed size memory chunks, for in-memory streams that are written once and then flushed
+    (see OutputChunkedBufferStream). Chunks released to the pool are kept for the next stream, up to a limit,
+    so writing many temporary streams does not keep allocating and freeing memory.
+    Thread safe.
+*/
+class BufferChunkPool
+{
+  public:
+    BufferChunkPool(size_t inChunkSize = DEFAULT_BUFFER_CHUNK_SIZE,
+                    size_t inMaxPooledChunks = DEFAULT_BUFFER_CHUNK_POOL_LIMIT);
+    ~BufferChunkPool();
+
+    // process wide pool, shared by streams of all documents
+    static BufferChunkPool &Default();
+
+    // get a chunk of GetChunkSize() bytes, pooled or new
+    uint8_t *Acquire();
+    // return a chunk acquired from this pool. freed if the pool is full
+    void Release(uint8_t *inChunk);
+
+    size_t GetChunkSize() const;
+    size_t GetPooledChunksCount();
+
+    // free all pooled chunks
+    void Trim();
+
+  private:
+    size_t mChunkSize;
+    size_t mMaxPooledChunks;
+    std::mutex mLock;
+    std::vector<uint8_t *> mPooledChunks;
+};
+} // namespace charta
@@ -0,0 +1,43 @@
+/*
+   Source File : IPositionalByteReader.h
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#pragma once
+/*
+    IPositionalByteReader. interface for reading bytes at explicit positions, without a shared read position.
+    implementations must allow calls from several threads at the same time.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+
+namespace charta
+{
+class IPositionalByteReader
+{
+  public:
+    virtual ~IPositionalByteReader() = default;
+
+    /*
+        Read up to inBufferSize bytes starting at inPosition, returning the number of bytes actually read.
+        less than asked means that the end was reached
+    */
+    virtual size_t ReadAt(long long inPosition, uint8_t *inBuffer, size_t inBufferSize) = 0;
+};
+} // namespace charta
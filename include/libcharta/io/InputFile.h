@@ -22,6 +22,7 @@
 
 #include "EStatusCode.h"
 #include "IByteReaderWithPosition.h"
+#include "IPositionalByteReader.h"
 #include <memory>
 #include <string>
 
@@ -40,6 +41,8 @@ class InputFile
     EStatusCode CloseFile();
 
     IByteReaderWithPosition *GetInputStream(); // returns buffered input stream
+    // reads at explicit positions, from any thread. for PDFParserReader
+    IPositionalByteReader *GetPositionalReader();
     const std::string &GetFilePath();
 
     long long GetFileSize();
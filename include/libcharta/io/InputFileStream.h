@@ -22,7 +22,9 @@
 
 #include "EStatusCode.h"
 #include "IByteReaderWithPosition.h"
+#include "IPositionalByteReader.h"
 
+#include <mutex>
 #include <stdio.h>
 #include <string>
 #ifdef __MINGW32__
@@ -31,7 +33,7 @@
 
 namespace charta
 {
-class InputFileStream final : public IByteReaderWithPosition
+class InputFileStream final : public IByteReaderWithPosition, public IPositionalByteReader
 {
   public:
     InputFileStream() = default;
@@ -54,7 +56,14 @@ class InputFileStream final : public IByteReaderWithPosition
 
     long long GetFileSize();
 
+    // IPositionalByteReader implementation. does not move the read position
+    virtual size_t ReadAt(long long inPosition, uint8_t *inBuffer, size_t inBufferSize);
+
   private:
     FILE *mStream = nullptr;
+#if defined(_WIN32) || defined(__WIN32__) || defined(WIN32)
+    // no pread here, so positional reads seek and restore under a lock
+    std::mutex mPositionalReadLock;
+#endif
 };
 } // namespace charta
\ No newline at end of file
@@ -25,13 +25,18 @@
 
 namespace charta
 {
+/*
+    LZWDecode filter. Read fills the whole of the caller's buffer - sequences are expanded straight into it, and codes
+    are pulled from a bulk buffer of the source stream, so there is no need to read it byte by byte.
+    "early" is the EarlyChange decode parameter. 1 (the default) means the code length grows one code early.
+*/
 class InputLZWDecodeStream final : public IByteReader
 {
   public:
-    InputLZWDecodeStream(int early);
+    InputLZWDecodeStream(int early = 1);
 
     // Note that assigning passes ownership on the stream, use Assign(NULL) to remove ownership
-    InputLZWDecodeStream(IByteReader *inSourceReader);
+    InputLZWDecodeStream(IByteReader *inSourceReader, int early = 1);
     virtual ~InputLZWDecodeStream(void);
 
     // Assigning passes ownership of the input stream to the decoder stream.
@@ -46,34 +51,46 @@ class InputLZWDecodeStream final : public IByteReader
     virtual bool NotEnded();
 
   private:
+    static const int scTableSize = 4097;
+    static const size_t scInputBufferSize = 16 * 1024;
+
     IByteReader *mSourceStream;
 
     bool mCurrentlyEncoding;
 
-    int mEarly;    // early parameter
-    int inputBuf;  // input buffer
-    int inputBits; // number of bits in input buffer
+    int mEarly; // early parameter
+
+    // encoded input, read from the source stream in bulk
+    uint8_t mInputBuffer[scInputBufferSize];
+    size_t mInputPosition;
+    size_t mInputEnd;
+    uint32_t mBitBuffer; // bits read from the input and not yet consumed
+    int mBitCount;       // number of valid bits in mBitBuffer
 
     struct
-    { // decoding table
-        int length;
-        int head;
+    { // decoding table. codes under 256 are the single byte sequences
+        uint16_t length;
+        uint16_t head;
         uint8_t tail;
-    } table[4097];
-    int nextCode;         // next code to be used
-    int nextBits;         // number of bits in next code word
-    int prevCode;         // previous code used in stream
-    int newChar;          // next char to be added to table
-    uint8_t seqBuf[4097]; // buffer for current sequence
-    int seqLength;        // length of current sequence
-    int seqIndex;         // index into current sequence
-    bool first;           // first code after a table clear
-
-    bool ProcessNextCode();
+        uint8_t first;
+    } mTable[scTableSize];
+    int mNextCode;   // next code to be used
+    int mCodeLength; // number of bits in next code word
+    int mPrevCode;   // previous code used in stream
+    bool mFirst;     // first code after a table clear
+
+    // sequence that did not fit the caller buffer, and is waiting for the next Read
+    uint8_t mSequence[scTableSize];
+    size_t mSequenceLength;
+    size_t mSequenceIndex;
+
+    int ProcessNextCode();
+    void ExpandSequence(int inCode, uint8_t *outBuffer) const;
     void ClearTable();
     int GetCode();
+    bool FillInputBuffer();
 
     void FinalizeEncoding();
     void StartEncoding();
 };
-} // namespace charta
\ No newline at end of file
+} // namespace charta
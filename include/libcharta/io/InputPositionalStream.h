@@ -0,0 +1,60 @@
+/*
+   Source File : InputPositionalStream.h
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#pragma once
+
+#include "IByteReaderWithPosition.h"
+#include "IPositionalByteReader.h"
+
+#include <vector>
+
+namespace charta
+{
+/*
+    A read position of its own over a positional source, with a small read-ahead buffer.
+    Several of these can read the same source from different threads, one per thread.
+    Does not own the source.
+*/
+class InputPositionalStream final : public IByteReaderWithPosition
+{
+  public:
+    InputPositionalStream(IPositionalByteReader *inSource, size_t inBufferSize = 16 * 1024);
+
+    // IByteReaderWithPosition implementation
+    virtual size_t Read(uint8_t *inBuffer, size_t inBufferSize);
+    virtual bool NotEnded();
+    virtual void Skip(size_t inSkipSize);
+    virtual void SetPosition(long long inOffsetFromStart);
+    // the source has no notion of size, so this one is not supported, and leaves the position as is
+    virtual void SetPositionFromEnd(long long inOffsetFromEnd);
+    virtual long long GetCurrentPosition();
+
+  private:
+    IPositionalByteReader *mSource;
+    std::vector<uint8_t> mBuffer;
+    // file position of mBuffer[0], and the amount of valid bytes in it
+    long long mBufferStart;
+    size_t mBufferFill;
+    long long mPosition;
+    bool mEnded;
+
+    bool FillBuffer();
+};
+} // namespace charta
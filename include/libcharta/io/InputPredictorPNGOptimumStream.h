@@ -42,15 +42,15 @@ class InputPredictorPNGOptimumStream final : public IByteReader
 
   private:
     IByteReader *mSourceStream;
-    uint8_t *mBuffer;
     size_t mBytesPerPixel;
-    size_t mBufferSize;
-    uint8_t *mIndex;
-    uint8_t mFunctionType;
+    size_t mRowSize; // without the filter tag byte
 
+    // source rows are read with their tag byte in front, then decoded in place. the prior row is kept for the
+    // up values, the two swap places each row
+    uint8_t *mBuffer;
     uint8_t *mUpValues;
+    uint8_t *mIndex; // next decoded byte to hand out, mBuffer + 1 + mRowSize when the row is done
 
-    void DecodeNextByte(uint8_t &outDecodedByte);
-    char PaethPredictor(char inLeft, char inUp, char inUpLeft);
+    bool ReadNextRow();
 };
 } // namespace charta
\ No newline at end of file
@@ -47,14 +47,11 @@ class InputPredictorTIFFSubStream final : public IByteReader
     uint8_t mBitsPerComponent;
     size_t mColumns;
 
+    // rows are decoded in place and handed out from here
     uint8_t *mRowBuffer;
-    size_t mReadColorsCount;
-    uint16_t *mReadColors;
-    uint16_t *mReadColorsIndex;
-    uint8_t mIndexInColor;
-    uint16_t mBitMask;
-
-    void ReadByteFromColorsArray(uint8_t &outBuffer);
-    void DecodeBufferToColors();
+    size_t mRowSize;
+    size_t mRowIndex;
+
+    bool ReadNextRow();
 };
 } // namespace charta
\ No newline at end of file
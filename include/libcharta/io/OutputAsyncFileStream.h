@@ -0,0 +1,96 @@
+/*
+   Source File : OutputAsyncFileStream.h
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#pragma once
+
+#include "EStatusCode.h"
+#include "IByteWriterWithPosition.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdio.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace charta
+{
+
+constexpr size_t DEFAULT_ASYNC_OUTPUT_BUFFER_SIZE = 256 * 1024;
+constexpr size_t DEFAULT_ASYNC_OUTPUT_BUFFERS_COUNT = 2;
+
+/*
+    File output stream that writes from a background thread. Writes fill a buffer, and full buffers are handed to
+    the writing thread while the caller goes on filling the next one. At most inBuffersCount buffers exist at any
+    time; when all are taken, Write waits for the writing thread to free one.
+    Write failures happen on the writing thread. From then on Write returns 0, and Close reports the failure -
+    check its status (PDFWriter::EndPDF does).
+*/
+class OutputAsyncFileStream final : public IByteWriterWithPosition
+{
+  public:
+    OutputAsyncFileStream(size_t inBufferSize = DEFAULT_ASYNC_OUTPUT_BUFFER_SIZE,
+                          size_t inBuffersCount = DEFAULT_ASYNC_OUTPUT_BUFFERS_COUNT);
+    virtual ~OutputAsyncFileStream();
+
+    // input file path is in UTF8. inSyncOnClose - flush the file to the device (fsync) when closing
+    charta::EStatusCode Open(const std::string &inFilePath, bool inAppend = false, bool inSyncOnClose = false);
+    // waits for all writes to complete. failure if any of them, or the sync, failed
+    charta::EStatusCode Close();
+
+    // charta::IByteWriter implementation
+    virtual size_t Write(const uint8_t *inBuffer, size_t inSize);
+
+    // IByteWriterWithPosition implementation
+    virtual long long GetCurrentPosition();
+
+    // hand the current buffer to the writing thread, without waiting for it to be written
+    void Flush();
+
+    // errno of the first failure, 0 if none
+    int GetError();
+
+  private:
+    size_t mBufferSize;
+    size_t mBuffersCount;
+    FILE *mFile;
+    bool mSyncOnClose;
+    long long mPosition;
+
+    // the buffer being filled by Write
+    std::vector<uint8_t> mCurrentBuffer;
+
+    // shared with the writing thread
+    std::thread mWritingThread;
+    std::mutex mLock;
+    std::condition_variable mStateChanged;
+    std::deque<std::vector<uint8_t>> mPendingBuffers;
+    std::vector<std::vector<uint8_t>> mFreeBuffers;
+    size_t mBuffersInFlight;
+    bool mStopping;
+    std::atomic<int> mError;
+    long long mErrorPosition;
+
+    void WritePendingBuffers(long long inStartPosition);
+    int WriteToFile(const std::vector<uint8_t> &inBuffer, long long inPosition);
+};
+} // namespace charta
@@ -0,0 +1,76 @@
+/*
+   Source File : OutputChunkedBufferStream.h
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#pragma once
+
+#include "BufferChunkPool.h"
+#include "IByteWriterWithPosition.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace charta
+{
+
+typedef std::pair<const uint8_t *, size_t> ConstBytesSegment;
+typedef std::vector<ConstBytesSegment> ConstBytesSegmentVector;
+
+/*
+    In-memory output stream made of fixed size chunks taken from a BufferChunkPool. Growing never reallocates or
+    moves written data, and the chunks go back to the pool on Reset or destruction.
+    Append only - for content that is written once and then copied elsewhere, like the content of direct extent
+    PDF streams, or a whole PDF (StartPDFForStream) that is then sent with writev/sendmsg straight from the chunks
+    (see GetSegments).
+*/
+class OutputChunkedBufferStream final : public IByteWriterWithPosition
+{
+  public:
+    // inPool - pool to take chunks from, NULL for BufferChunkPool::Default(). NOT taking ownership
+    OutputChunkedBufferStream(BufferChunkPool *inPool = nullptr);
+    ~OutputChunkedBufferStream();
+
+    OutputChunkedBufferStream(const OutputChunkedBufferStream &) = delete;
+    OutputChunkedBufferStream &operator=(const OutputChunkedBufferStream &) = delete;
+
+    // charta::IByteWriter implementation
+    virtual size_t Write(const uint8_t *inBuffer, size_t inSize);
+
+    // IByteWriterWithPosition implementation
+    virtual long long GetCurrentPosition();
+
+    // write the content to inTargetStream, a chunk per write, straight from the chunks
+    size_t CopyToOutputStream(IByteWriter *inTargetStream) const;
+
+    std::string ToString() const;
+
+    // the content, in order, as (pointer, size) segments pointing into the chunks. for building an iovec array for
+    // writev/sendmsg without copying. valid until the next Write or Reset
+    ConstBytesSegmentVector GetSegments() const;
+    size_t GetSegmentsCount() const;
+
+    // release the chunks to the pool and start over
+    void Reset();
+
+  private:
+    BufferChunkPool *mPool;
+    std::vector<uint8_t *> mChunks;
+    size_t mSize;
+};
+} // namespace charta
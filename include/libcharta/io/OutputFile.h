@@ -26,6 +26,7 @@
 namespace charta
 {
 class IByteWriterWithPosition;
+class OutputAsyncFileStream;
 class OutputBufferedStream;
 class OutputFileStream;
 
@@ -35,14 +36,18 @@ class OutputFile
     OutputFile(void);
     ~OutputFile(void);
 
-    EStatusCode OpenFile(const std::string &inFilePath, bool inAppend = false);
+    // inAsynchronous - write from a background thread (see OutputAsyncFileStream), inSyncOnClose - with asynchronous
+    // writing, flush the file to the device when closing
+    EStatusCode OpenFile(const std::string &inFilePath, bool inAppend = false, bool inAsynchronous = false,
+                         bool inSyncOnClose = false);
     EStatusCode CloseFile();
 
-    charta::IByteWriterWithPosition *GetOutputStream(); // returns buffered output stream
+    charta::IByteWriterWithPosition *GetOutputStream(); // returns buffered (or asynchronous) output stream
     const std::string &GetFilePath();
 
   private:
     std::string mFilePath;
     OutputBufferedStream *mOutputStream;
+    OutputAsyncFileStream *mAsyncOutputStream;
 };
 } // namespace charta
\ No newline at end of file
@@ -47,14 +47,23 @@ class OutputFlateEncodeStream final : public IByteWriterWithPosition
     void TurnOnEncoding();
     void TurnOffEncoding();
 
+    // counters for the current target, reset on Assign. time is measured only when asked for
+    void MeasureEncodingTime(bool inMeasure);
+    unsigned long long GetInputBytes() const;
+    unsigned long long GetEncodingNanoseconds() const;
+
   private:
     uint8_t *mBuffer;
     IByteWriterWithPosition *mTargetStream;
     bool mCurrentlyEncoding;
     z_stream *mZLibState;
+    bool mMeasureEncodingTime;
+    unsigned long long mInputBytes;
+    unsigned long long mEncodingNanoseconds;
 
     void FinalizeEncoding();
     void StartEncoding();
     size_t EncodeBufferAndWrite(const uint8_t *inBuffer, size_t inSize);
+    int Deflate(int inFlush);
 };
 } // namespace charta
\ No newline at end of file
@@ -0,0 +1,52 @@
+/*
+   Source File : PredictorKernels.h
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace charta
+{
+/*
+    Row kernels for the PNG and TIFF predictors, used by InputPredictorPNGOptimumStream and
+    InputPredictorTIFFSubStream. Both work in place on one row at a time.
+*/
+
+// PNG filter types, as they appear in the tag byte at the start of each row
+enum EPNGFilterType
+{
+    ePNGFilterNone = 0,
+    ePNGFilterSub = 1,
+    ePNGFilterUp = 2,
+    ePNGFilterAverage = 3,
+    ePNGFilterPaeth = 4
+};
+
+// undo the filter of a row (without its tag byte). inPriorRow is the previous row, already decoded - all zeros for
+// the first row. inBytesPerPixel is the distance to the "left" byte, 1 for pixels smaller than a byte.
+// returns false for an unknown filter type, leaving the row as is.
+bool PNGUnfilterRow(uint8_t inFilterType, uint8_t *ioRow, const uint8_t *inPriorRow, size_t inRowSize,
+                    size_t inBytesPerPixel);
+
+// undo TIFF horizontal differencing (predictor 2) on a row of inColumns * inColors components, packed at
+// inBitsPerComponent (1, 2, 4, 8 or 16, big endian) bits
+void TIFFUndifferenceRow(uint8_t *ioRow, size_t inColumns, size_t inColors, uint8_t inBitsPerComponent);
+} // namespace charta
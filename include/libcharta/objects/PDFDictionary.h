@@ -21,19 +21,31 @@
 #pragma once
 #include "MapIterator.h"
 #include "PDFName.h"
+#include "PDFNameTable.h"
 #include "PDFObject.h"
 
-#include <map>
 #include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace charta
 {
-struct PDFNameLess
+/*
+    Dictionary entries, kept flat in insertion order. exposes key_type and mapped_type so that
+    it can be walked with MapIterator
+*/
+class PDFDictionaryEntries
+    : public std::pmr::vector<std::pair<std::shared_ptr<PDFName>, std::shared_ptr<PDFObject>>>
 {
-    bool operator()(const std::shared_ptr<PDFName> left, const std::shared_ptr<charta::PDFName> right) const
-    {
-        return left->GetValue() < right->GetValue();
-    }
+  public:
+    using std::pmr::vector<std::pair<std::shared_ptr<PDFName>, std::shared_ptr<PDFObject>>>::vector;
+
+    typedef std::shared_ptr<PDFName> key_type;
+    typedef std::shared_ptr<PDFObject> mapped_type;
 };
 
 class PDFDictionary : public PDFObject
@@ -45,16 +57,29 @@ class PDFDictionary : public PDFObject
     };
 
     PDFDictionary();
+    // storage for the entries comes from inResource (e.g. a PDFObjectArena)
+    explicit PDFDictionary(std::pmr::memory_resource *inResource);
 
-    // AddRefs on both
+    // AddRefs on both. if the key already exists, the dictionary is left as is
     void Insert(const std::shared_ptr<PDFName> &inKeyObject, const std::shared_ptr<charta::PDFObject> &inValueObject);
 
     bool Exists(const std::string &inName);
+    bool Exists(EPDFWellKnownName inName);
     std::shared_ptr<charta::PDFObject> QueryDirectObject(const std::string &inName);
+    // lookups with name objects compare pointers first, which is what interned (parsed) keys are good for
+    std::shared_ptr<charta::PDFObject> QueryDirectObject(const std::shared_ptr<PDFName> &inName);
+    std::shared_ptr<charta::PDFObject> QueryDirectObject(EPDFWellKnownName inName);
+
+    size_t GetLength() const;
 
-    MapIterator<std::map<std::shared_ptr<PDFName>, std::shared_ptr<charta::PDFObject>, PDFNameLess>> GetIterator();
+    MapIterator<PDFDictionaryEntries> GetIterator();
 
   private:
-    std::map<std::shared_ptr<PDFName>, std::shared_ptr<charta::PDFObject>, PDFNameLess> mValues;
+    PDFDictionaryEntries mValues;
+    // built by Insert once the dictionary grows large. keys view the values of the key name objects
+    std::unique_ptr<std::unordered_map<std::string_view, size_t>> mIndex;
+
+    long FindEntry(std::string_view inName);
+    long FindEntry(const std::shared_ptr<PDFName> &inName);
 };
-} // namespace charta
\ No newline at end of file
+} // namespace charta
@@ -41,7 +41,14 @@ class PDFName : public PDFObject
     const std::string &GetValue() const;
     operator std::string() const;
 
+    // true for the process wide atoms of PDFNameTable, which are the only name objects with their values
+    bool IsWellKnown() const;
+
   private:
+    friend class PDFNameTable;
+    PDFName(const std::string &inValue, bool inIsWellKnown);
+
     const std::string mValue;
+    bool mIsWellKnown;
 };
 } // namespace charta
@@ -0,0 +1,112 @@
+/*
+   Source File : PDFNameTable.h
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#pragma once
+
+#include "PDFName.h"
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace charta
+{
+// keys that parsing and copying look up all the time. each has a single, process wide, name object
+enum EPDFWellKnownName
+{
+    ePDFNameType,
+    ePDFNameSubtype,
+    ePDFNameLength,
+    ePDFNameFilter,
+    ePDFNameDecodeParms,
+    ePDFNameDL,
+    ePDFNameResources,
+    ePDFNameContents,
+    ePDFNameKids,
+    ePDFNameCount,
+    ePDFNameParent,
+    ePDFNamePage,
+    ePDFNamePages,
+    ePDFNameRoot,
+    ePDFNameInfo,
+    ePDFNameEncrypt,
+    ePDFNameID,
+    ePDFNameSize,
+    ePDFNamePrev,
+    ePDFNameXRefStm,
+    ePDFNameW,
+    ePDFNameIndex,
+    ePDFNameN,
+    ePDFNameFirst,
+    ePDFNameMediaBox,
+    ePDFNameCropBox,
+    ePDFNameRotate,
+    ePDFNameAnnots,
+    ePDFNameFont,
+    ePDFNameXObject,
+    ePDFNameExtGState,
+    ePDFNameColorSpace,
+    ePDFNamePattern,
+    ePDFNameShading,
+    ePDFNameProcSet,
+    ePDFNameProperties,
+    ePDFNameBaseFont,
+    ePDFNameEncoding,
+    ePDFNameToUnicode,
+    ePDFNameWidth,
+    ePDFNameHeight,
+    ePDFNameBitsPerComponent,
+    ePDFNamePredictor,
+    ePDFNameColumns,
+    ePDFNameColors,
+    ePDFNameEarlyChange,
+    ePDFNameName,
+    ePDFWellKnownNamesCount
+};
+
+/*
+    Name interning table. Parsed names with the same value share one PDFName object, and well known names
+    resolve to the process wide atoms, so dictionary lookups with atoms compare pointers rather than strings.
+    A table is not thread safe, use one per parser. The well known atoms may be shared freely.
+*/
+class PDFNameTable
+{
+  public:
+    PDFNameTable();
+
+    // return the single name object for inValue. inValue is the interpreted name, as in PDFName
+    std::shared_ptr<PDFName> Intern(std::string_view inValue);
+
+    size_t GetSize() const;
+    void Clear();
+
+    static const std::shared_ptr<PDFName> &WellKnown(EPDFWellKnownName inName);
+    // nullptr if inValue is not a well known name
+    static const std::shared_ptr<PDFName> *FindWellKnown(std::string_view inValue);
+
+  private:
+    struct WellKnownNames;
+    static const WellKnownNames &GetWellKnownNames();
+
+    // keys view the value of the name object they map to
+    std::unordered_map<std::string_view, std::shared_ptr<PDFName>> mNames;
+};
+} // namespace charta
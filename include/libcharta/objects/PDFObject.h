@@ -21,6 +21,7 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <string>
 
 namespace charta
@@ -67,6 +68,7 @@ class PDFObject
 
   private:
     EPDFObjectType mType;
-    StringToIDeletable mMetadata;
+    // created on first SetMetadata, most objects never carry any
+    std::unique_ptr<StringToIDeletable> mMetadata;
 };
 } // namespace charta
\ No newline at end of file
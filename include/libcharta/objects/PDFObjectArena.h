@@ -0,0 +1,106 @@
+/*
+   Source File : PDFObjectArena.h
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#pragma once
+
+#include <memory>
+#include <memory_resource>
+#include <stddef.h>
+#include <utility>
+
+namespace charta
+{
+template <class T> class PDFObjectArenaAllocator;
+
+/*
+    Bump allocator for parsed objects. Set one on a parser (PDFObjectParser::SetArena, PDFParser::SetObjectArena)
+    and the objects it parses, along with the storage of dictionaries, are carved out of a few large blocks instead
+    of being allocated one by one. Freeing an object is a no-op, the blocks are released together when the arena
+    goes away.
+    Objects don't keep their arena alive, so that they cost no more reference counting than heap objects. The
+    parser keeps every arena it was given until it is reset or destroyed - hold on to the arena to use its objects
+    past that. Allocation is not thread safe - use an arena with one parser at a time.
+*/
+class PDFObjectArena : public std::pmr::memory_resource
+{
+  public:
+    explicit PDFObjectArena(size_t inInitialBlockSize = 64 * 1024);
+    ~PDFObjectArena() override;
+
+    // create an object in the arena. it must not outlive the arena
+    template <class T, class... Args> std::shared_ptr<T> Make(Args &&...inArgs);
+
+    // bytes handed out so far, for diagnostics
+    size_t GetAllocatedSize() const;
+
+  private:
+    std::pmr::monotonic_buffer_resource mBuffer;
+    size_t mAllocatedSize;
+
+    void *do_allocate(size_t inBytes, size_t inAlignment) override;
+    void do_deallocate(void *inPointer, size_t inBytes, size_t inAlignment) override;
+    bool do_is_equal(const std::pmr::memory_resource &inOther) const noexcept override;
+};
+
+// allocator for std::allocate_shared. does not own the arena
+template <class T> class PDFObjectArenaAllocator
+{
+  public:
+    typedef T value_type;
+
+    explicit PDFObjectArenaAllocator(PDFObjectArena *inArena) : mArena(inArena)
+    {
+    }
+
+    template <class U> PDFObjectArenaAllocator(const PDFObjectArenaAllocator<U> &inOther) : mArena(inOther.mArena)
+    {
+    }
+
+    T *allocate(size_t inCount)
+    {
+        return static_cast<T *>(mArena->allocate(inCount * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *inPointer, size_t inCount)
+    {
+        mArena->deallocate(inPointer, inCount * sizeof(T), alignof(T));
+    }
+
+    template <class U> bool operator==(const PDFObjectArenaAllocator<U> &inOther) const
+    {
+        return mArena == inOther.mArena;
+    }
+
+    template <class U> bool operator!=(const PDFObjectArenaAllocator<U> &inOther) const
+    {
+        return mArena != inOther.mArena;
+    }
+
+  private:
+    template <class U> friend class PDFObjectArenaAllocator;
+
+    PDFObjectArena *mArena;
+};
+
+template <class T, class... Args> std::shared_ptr<T> PDFObjectArena::Make(Args &&...inArgs)
+{
+    return std::allocate_shared<T>(PDFObjectArenaAllocator<T>(this), std::forward<Args>(inArgs)...);
+}
+} // namespace charta
@@ -35,6 +35,7 @@
 #include <string>
 
 class PDFParser;
+class PDFParserReader;
 namespace charta
 {
 class PDFArray;
@@ -47,6 +48,8 @@ class PDFPageInput
     PDFPageInput(PDFParser *inParser, std::shared_ptr<PDFObject> inPageObject);
     // constructors from a smart pointer or another page object, will call addref
     PDFPageInput(PDFParser *inParser, const PDFObjectCastPtr<PDFDictionary> &inPageObject);
+    // reading inherited values through a parser reader, for use alongside other threads
+    PDFPageInput(PDFParserReader *inParserReader, std::shared_ptr<PDFObject> inPageObject);
     PDFPageInput(const PDFPageInput &inOtherPage);
 
     // will call release on the input page object
@@ -63,6 +66,7 @@ class PDFPageInput
 
   private:
     PDFParser *mParser;
+    PDFParserReader *mParserReader;
     PDFObjectCastPtr<PDFDictionary> mPageObject;
 
     std::shared_ptr<PDFObject> QueryInheritedValue(const std::shared_ptr<PDFDictionary> &inDictionary,
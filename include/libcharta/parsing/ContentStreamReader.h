@@ -0,0 +1,141 @@
+/*
+   Source File : ContentStreamReader.h
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#pragma once
+
+#include "EStatusCode.h"
+
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace charta
+{
+class PDFStreamInput;
+}
+class PDFParser;
+
+enum EContentStreamOperandType
+{
+    eContentStreamOperandNumber,
+    eContentStreamOperandName,
+    eContentStreamOperandLiteralString,
+    eContentStreamOperandHexString,
+    eContentStreamOperandBoolean,
+    eContentStreamOperandNull,
+    eContentStreamOperandArray,
+    eContentStreamOperandDictionary
+};
+
+struct ContentStreamOperand
+{
+    EContentStreamOperandType mType;
+    // the token as it is in the content, pointing into it: the name without the slash (# escapes kept), the literal
+    // string without the parentheses (escapes kept), the hex digits, or the number/keyword text
+    std::string_view mToken;
+    // numbers
+    double mNumber;
+    bool mIsInteger;
+    // booleans
+    bool mBoolean;
+    // arrays and dictionaries: how many of the operands that follow belong to it, nested ones included.
+    // dictionaries list keys and values in turn
+    size_t mElementsCount;
+    // offset of the token in the content, including its opening delimiter
+    size_t mPosition;
+};
+
+struct ContentStreamOperator
+{
+    // the operator keyword, e.g. "Tj". inline images are reported as a single "BI" operator, whose operands are the
+    // image dictionary entries, and whose data is the bytes between ID and EI
+    std::string_view mOperator;
+    const ContentStreamOperand *mOperands;
+    size_t mOperandsCount;
+    const uint8_t *mInlineImageData;
+    size_t mInlineImageSize;
+    // offset of the operator keyword in the content
+    size_t mPosition;
+};
+
+class IContentStreamVisitor
+{
+  public:
+    virtual ~IContentStreamVisitor() = default;
+
+    // return false to stop reading
+    virtual bool OnOperator(const ContentStreamOperator &inOperator) = 0;
+};
+
+/*
+    Reads content streams operator by operator. Operands are typed and point into the content, and the operands
+    list is reused between operators, so reading allocates nothing once the reader warmed up - keep one reader
+    around for many streams. Everything reported is valid only till the next operator is read.
+
+    The reader is lenient: stray delimiters are skipped, unterminated arrays and dictionaries are closed at the next
+    operator, and operands left at the end of the content are dropped.
+
+    Either pull operators with Start and Next, or have them pushed to a visitor with Read. ReadStream and
+    ReadPageContents decode with a parser first (page contents that are arrays of streams are read as one).
+*/
+class ContentStreamReader
+{
+  public:
+    ContentStreamReader();
+
+    // pull interface
+    void Start(const uint8_t *inContent, size_t inSize);
+    // false when the content ended
+    bool Next(ContentStreamOperator &outOperator);
+
+    // push interface. stops early (still successfully) when the visitor asks to
+    charta::EStatusCode Read(const uint8_t *inContent, size_t inSize, IContentStreamVisitor *inVisitor);
+    charta::EStatusCode ReadStream(PDFParser *inParser, const std::shared_ptr<charta::PDFStreamInput> &inStream,
+                                   IContentStreamVisitor *inVisitor);
+    charta::EStatusCode ReadPageContents(PDFParser *inParser, unsigned long inPageIndex,
+                                         IContentStreamVisitor *inVisitor);
+
+    // decoding of operand text, for when it is needed. these allocate
+    static std::string DecodeName(const ContentStreamOperand &inOperand);
+    static std::string DecodeString(const ContentStreamOperand &inOperand); // literal or hex
+    // same, into a buffer that can be reused between strings
+    static void DecodeString(const ContentStreamOperand &inOperand, std::string &outString);
+
+  private:
+    const uint8_t *mContent;
+    size_t mSize;
+    size_t mPosition;
+    std::vector<ContentStreamOperand> mOperands;
+    std::vector<size_t> mOpenContainers; // indexes into mOperands of arrays and dictionaries being read
+    std::vector<uint8_t> mContentBuffer;
+    std::vector<uint8_t> mStreamBuffer;
+
+    // reads the next token. operands are added to mOperands, keywords are returned in outKeyword (empty otherwise).
+    // false when the content ended
+    bool ReadToken(std::string_view &outKeyword, size_t &outKeywordPosition);
+    void CloseContainer(EContentStreamOperandType inType);
+    void CloseOpenContainers();
+    bool ReadInlineImage(ContentStreamOperator &outOperator);
+    size_t SkipWhiteSpacesAndComments(size_t inPosition) const;
+    size_t FindTokenEnd(size_t inPosition) const;
+};
@@ -30,6 +30,7 @@
 
 class ObjectsContext;
 class PDFParser;
+class PDFParserReader;
 class IPDFParserExtender;
 
 namespace charta
@@ -53,6 +54,10 @@ class PDFDocumentCopyingContext
     charta::EStatusCode Start(PDFParser *inPDFParser, charta::DocumentContext *inDocumentContext,
                               ObjectsContext *inObjectsContext);
 
+    // copy from a parser that is shared between copying contexts, possibly on other threads. see PDFParserReader
+    charta::EStatusCode Start(PDFParserReader *inParserReader, charta::DocumentContext *inDocumentContext,
+                              ObjectsContext *inObjectsContext);
+
     EStatusCodeAndObjectIDType CreateFormXObjectFromPDFPage(unsigned long inPageIndex,
                                                             EPDFPageBox inPageBoxToUseAsFormBox,
                                                             const double *inTransformationMatrix = NULL,
@@ -33,6 +33,7 @@
 #include <list>
 #include <map>
 #include <set>
+#include <vector>
 
 class ObjectsContext;
 namespace charta
@@ -43,6 +44,7 @@ class PDFArray;
 class PDFDictionary;
 class PDFIndirectObjectReference;
 class PDFObject;
+class PDFPageInput;
 class PDFStreamInput;
 } // namespace charta
 class DictionaryContext;
@@ -52,6 +54,7 @@ class IDocumentContextExtender;
 class IPageEmbedInFormCommand;
 class IPDFParserExtender;
 class ICategoryServicesCommand;
+class PDFParserReader;
 
 typedef std::map<ObjectIDType, ObjectIDType> ObjectIDTypeToObjectIDTypeMap;
 typedef std::map<std::string, std::string> StringToStringMap;
@@ -181,6 +184,9 @@ class PDFDocumentHandler : public DocumentContextExtenderAdapter
     charta::EStatusCode StartStreamCopyingContext(charta::IByteReaderWithPosition *inPDFStream,
                                                   const PDFParsingOptions &inOptions);
     charta::EStatusCode StartParserCopyingContext(PDFParser *inPDFParser);
+    // copy from a parser shared with other copying contexts, reading through inParserReader. use one reader per
+    // thread, and keep it alive as long as the copying context
+    charta::EStatusCode StartParserReaderCopyingContext(PDFParserReader *inParserReader);
     EStatusCodeAndObjectIDType CreateFormXObjectFromPDFPage(unsigned long inPageIndex,
                                                             EPDFPageBox inPageBoxToUseAsFormBox,
                                                             const double *inTransformationMatrix,
@@ -223,6 +229,7 @@ class PDFDocumentHandler : public DocumentContextExtenderAdapter
     charta::IByteReaderWithPosition *mPDFStream;
     PDFParser *mParser;
     bool mParserOwned;
+    PDFParserReader *mParserReader;
     ObjectIDTypeToObjectIDTypeMap mSourceToTarget;
     std::shared_ptr<charta::PDFDictionary> mWrittenPage;
 
@@ -282,11 +289,11 @@ class PDFDocumentHandler : public DocumentContextExtenderAdapter
     charta::EStatusCode WritePDFStreamInputToStream(charta::IByteWriter *inTargetStream,
                                                     const std::shared_ptr<charta::PDFStreamInput> &inSourceStream,
                                                     const StringToStringMap &inMappedResourcesNames);
-    charta::EStatusCode ScanStreamForResourcesTokens(const std::shared_ptr<charta::PDFStreamInput> &inSourceStream,
+    charta::EStatusCode ScanStreamForResourcesTokens(std::vector<uint8_t> &inContent,
                                                      const StringToStringMap &inMappedResourcesNames,
                                                      ResourceTokenMarkerList &outResourceMarkers);
     charta::EStatusCode MergeAndReplaceResourcesTokens(charta::IByteWriter *inTargetStream,
-                                                       const std::shared_ptr<charta::PDFStreamInput> &inSourceStream,
+                                                       const std::vector<uint8_t> &inContent,
                                                        const StringToStringMap &inMappedResourcesNames,
                                                        const ResourceTokenMarkerList &inResourceMarkers);
 
@@ -322,6 +329,19 @@ class PDFDocumentHandler : public DocumentContextExtenderAdapter
     charta::EStatusCode MergePageContentToTargetXObject(PDFFormXObject *inTargetFormXObject,
                                                         std::shared_ptr<charta::PDFDictionary> inSourcePage,
                                                         const StringToStringMap &inMappedResourcesNames);
-    std::shared_ptr<charta::PDFObject> FindPageResources(PDFParser *inParser,
-                                                         const std::shared_ptr<charta::PDFDictionary> &inDictionary);
+    std::shared_ptr<charta::PDFObject> FindPageResources(const std::shared_ptr<charta::PDFDictionary> &inDictionary);
+
+    // source reading, through the parser reader when there is one
+    std::shared_ptr<charta::PDFObject> ParseSourceObject(ObjectIDType inObjectID);
+    std::shared_ptr<charta::PDFDictionary> ParseSourcePage(unsigned long inPageIndex);
+    std::shared_ptr<charta::PDFObject> QuerySourceDictionaryObject(
+        const std::shared_ptr<charta::PDFDictionary> &inDictionary, const std::string &inName);
+    std::shared_ptr<charta::PDFObject> QuerySourceDictionaryObject(
+        const std::shared_ptr<charta::PDFDictionary> &inDictionary, charta::EPDFWellKnownName inName);
+    charta::IByteReader *StartReadingFromSourceStream(const std::shared_ptr<charta::PDFStreamInput> &inStream);
+    charta::IByteReader *StartReadingFromSourceStreamForPlainCopying(
+        const std::shared_ptr<charta::PDFStreamInput> &inStream);
+    charta::EStatusCode DecodeSourceStreamToBuffer(const std::shared_ptr<charta::PDFStreamInput> &inStream,
+                                                   std::vector<uint8_t> &ioBuffer);
+    charta::PDFPageInput CreateSourcePageInput(const std::shared_ptr<charta::PDFDictionary> &inPageObject);
 };
@@ -23,13 +23,17 @@
 #include "EStatusCode.h"
 #include "PDFParserTokenizer.h"
 #include "io/IReadPositionProvider.h"
+#include "objects/PDFNameTable.h"
+#include "objects/PDFObjectArena.h"
 #include <stdint.h>
 #include <stdio.h>
 
 #include <list>
 #include <memory>
+#include <memory_resource>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace charta
 {
@@ -72,6 +76,16 @@ class PDFObjectParser
     charta::IByteReader *StartExternalRead();
     void EndExternalRead();
 
+    // parsed names are interned here, so equal names share a single object
+    charta::PDFNameTable &GetNameTable();
+
+    // allocate parsed objects from inArena, nullptr (the default) for the regular heap.
+    // names are interned, and stay on the heap either way. arenas replaced by later calls are kept until
+    // ReleaseRetainedArenas, or until the parser is destroyed
+    void SetArena(std::shared_ptr<charta::PDFObjectArena> inArena);
+    std::shared_ptr<charta::PDFObjectArena> GetArena() const;
+    void ReleaseRetainedArenas();
+
   private:
     PDFParserTokenizer mTokenizer;
     std::list<std::string> mTokenBuffer;
@@ -80,6 +94,12 @@ class PDFObjectParser
     charta::IPDFParserExtender *mParserExtender;
     DecryptionHelper *mDecryptionHelper;
     bool mOwnsStream;
+    charta::PDFNameTable mNameTable;
+    std::shared_ptr<charta::PDFObjectArena> mArena;
+    std::vector<std::shared_ptr<charta::PDFObjectArena>> mRetainedArenas;
+
+    template <class T, class... Args> std::shared_ptr<T> MakeObject(Args &&...inArgs);
+    std::pmr::memory_resource *GetContainersResource();
 
     bool GetNextToken(std::string &outToken);
     void SaveTokenToBuffer(std::string &inToken);
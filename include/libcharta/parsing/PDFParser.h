@@ -24,6 +24,8 @@
 #include "ObjectsBasicTypes.h"
 #include "PDFObjectParser.h"
 #include "PDFParsingOptions.h"
+#include "XrefScanner.h"
+#include "XrefTable.h"
 #include "encryption/DecryptionHelper.h"
 #include "io/AdapterIByteReaderWithPositionToIReadPositionProvider.h"
 #include "io/IByteReaderWithPosition.h"
@@ -33,7 +35,9 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <utility>
+#include <vector>
 
 namespace charta
 {
@@ -48,30 +52,6 @@ typedef std::pair<charta::EStatusCode, charta::IByteReader *> EStatusCodeAndIByt
 
 #define LINE_BUFFER_SIZE 1024
 
-enum EXrefEntryType
-{
-    eXrefEntryExisting,
-    eXrefEntryDelete,
-    eXrefEntryStreamObject,
-    eXrefEntryUndefined
-};
-
-struct XrefEntryInput
-{
-    XrefEntryInput()
-    {
-        mObjectPosition = 0;
-        mRivision = 0;
-        mType = eXrefEntryUndefined;
-    }
-
-    // well...it's more like...the first number in a pair on an xref, and the second one. the names
-    // are true only for "n" type of entries
-    long long mObjectPosition;
-    unsigned long mRivision;
-    EXrefEntryType mType;
-};
-
 struct ObjectStreamHeaderEntry
 {
     ObjectIDType mObjectNumber;
@@ -80,6 +60,19 @@ struct ObjectStreamHeaderEntry
 
 typedef std::map<ObjectIDType, ObjectStreamHeaderEntry *> ObjectIDTypeToObjectStreamHeaderEntryMap;
 
+/*
+    The stream and object parser that reading objects goes through. The parser has one for the stream it was
+    started with, and each PDFParserReader has its own, so that readers don't step on each other's position.
+*/
+struct PDFParserReadContext
+{
+    charta::IByteReaderWithPosition *mStream = nullptr;
+    IReadPositionProvider *mPositionProvider = nullptr;
+    PDFObjectParser *mObjectParser = nullptr;
+};
+
+class PDFParserReader;
+
 class PDFParser
 {
   public:
@@ -87,7 +80,8 @@ class PDFParser
     virtual ~PDFParser(void);
 
     // sets the stream to parse, then parses for enough information to be able
-    // to parse objects later
+    // to parse objects later. with inOptions.RecoverBrokenXref, a broken cross reference is rebuilt by scanning
+    // the file
     charta::EStatusCode StartPDFParsing(
         charta::IByteReaderWithPosition *inSourceStream,
         const PDFParsingOptions &inOptions = PDFParsingOptions::DefaultPDFParsingOptions());
@@ -95,6 +89,13 @@ class PDFParser
     // get a parser that can parse objects
     PDFObjectParser &GetObjectParser();
 
+    // allocate parsed objects from inArena, including objects read with parsers from StartReadingObjectsFromStream(s).
+    // nullptr (the default) goes back to the regular heap. objects don't keep their arena alive, so the parser keeps
+    // every arena it was given (the trailer, say, may come from any of them) until ResetParser. hold on to an arena
+    // to use its objects past that
+    void SetObjectArena(std::shared_ptr<charta::PDFObjectArena> inArena);
+    std::shared_ptr<charta::PDFObjectArena> GetObjectArena() const;
+
     // get decryption helper - useful to decrypt streams if not using standard operation
     DecryptionHelper &GetDecryptionHelper();
 
@@ -116,6 +117,8 @@ class PDFParser
     // [if you want the direct dictionary value, use PDFDictionary::QueryDirectObject [will AddRef automatically]
     std::shared_ptr<charta::PDFObject> QueryDictionaryObject(const std::shared_ptr<charta::PDFDictionary> &inDictionary,
                                                              const std::string &inName);
+    std::shared_ptr<charta::PDFObject> QueryDictionaryObject(const std::shared_ptr<charta::PDFDictionary> &inDictionary,
+                                                             charta::EPDFWellKnownName inName);
 
     // Query an array object, if indirect, go and fetch the indirect object and return it instead
     // [if you want the direct array value, use the PDFArray direct access to the vector [and use AddRef, cause it
@@ -160,6 +163,18 @@ class PDFParser
     */
     charta::IByteReader *StartReadingFromStreamForPlainCopying(const std::shared_ptr<charta::PDFStreamInput> &inStream);
 
+    // read the whole of a stream, decoded, into ioBuffer - replacing its content but reusing its memory. the buffer is
+    // sized up front from /DL when the stream has it, or from an estimate by /Length. unencrypted flate streams, with
+    // or without a predictor, are inflated straight from the file into the buffer. other streams are read through
+    // the filters of CreateInputStreamReader, in large blocks
+    charta::EStatusCode DecodeStreamToBuffer(const std::shared_ptr<charta::PDFStreamInput> &inStream,
+                                             std::vector<uint8_t> &ioBuffer);
+
+    // a pool of buffers for DecodeStreamToBuffer, so that repeated decodes don't allocate. AcquireStreamBuffer returns
+    // a previously released buffer when there is one (empty, with its capacity). can be used from PDFParserReaders
+    std::vector<uint8_t> AcquireStreamBuffer();
+    void ReleaseStreamBuffer(std::vector<uint8_t> inBuffer);
+
     // use this to explictly free used objects. quite obviously this means that you'll have to parse the file again
     void ResetParser();
 
@@ -176,14 +191,19 @@ class PDFParser
     // set extender for parser, to enhance parsing capabilities
     void SetParserExtender(charta::IPDFParserExtender *inParserExtender);
 
+    // true if the xref was rebuilt by scanning the file (see PDFParsingOptions::RecoverBrokenXref)
+    bool IsXrefRebuilt() const;
+
     // advanced, direct xref access
     ObjectIDType GetXrefSize() const;
-    XrefEntryInput *GetXrefEntry(ObjectIDType inObjectID);
+    XrefEntryInput GetXrefEntry(ObjectIDType inObjectID) const;
     long long GetXrefPosition() const;
 
     charta::IByteReaderWithPosition *GetParserStream();
 
   private:
+    friend class PDFParserReader;
+
     PDFObjectParser mObjectParser;
     DecryptionHelper mDecryptionHelper;
     charta::IByteReaderWithPosition *mStream;
@@ -200,60 +220,100 @@ class PDFParser
     double mPDFLevel;
     long long mLastXrefPosition;
     std::shared_ptr<charta::PDFDictionary> mTrailer;
-    ObjectIDType mXrefSize;
-    XrefEntryInput *mXrefTable;
+    XrefTable mXrefTable;
     unsigned long mPagesCount;
     ObjectIDType *mPagesObjectIDs;
     charta::IPDFParserExtender *mParserExtender;
     bool mAllowExtendingSegments;
+    bool mXrefRebuilt;
+    // object streams found while rebuilding the xref, indexed once decryption is setup
+    std::vector<ObjectIDType> mRecoveredObjectStreams;
+    PDFParserReadContext mReadContext;
+    // object stream headers are shared between readers
+    std::mutex mObjectStreamsCacheLock;
+    // readers take this when the file can't be read concurrently (encrypted, or with an extender)
+    std::recursive_mutex mSerializedReadLock;
+    // readers take this to read from the parser stream, when they don't have a positional source
+    std::mutex mStreamReadLock;
+    std::vector<std::vector<uint8_t>> mStreamBufferPool;
+    std::mutex mStreamBufferPoolLock;
 
     charta::EStatusCode ParseHeaderLine();
+    charta::EStatusCode ParseDocumentDirectory();
+    charta::EStatusCode SetupDocument(const std::string &inPassword);
+    charta::EStatusCode RebuildXref();
+    std::shared_ptr<charta::PDFDictionary> RecoverTrailer(const XrefScanner &inScanner);
+    charta::EStatusCode IndexRecoveredObjectStreams();
     charta::EStatusCode ParseEOFLine();
     charta::EStatusCode ParseLastXrefPosition();
     charta::EStatusCode ParseTrailerDictionary(std::shared_ptr<charta::PDFDictionary> *outTrailer);
     charta::EStatusCode BuildXrefTableFromTable();
-    charta::EStatusCode DetermineXrefSize();
     charta::EStatusCode InitializeXref();
-    charta::EStatusCode ParseXrefFromXrefTable(XrefEntryInput *inXrefTable, ObjectIDType inXrefSize,
-                                               long long inXrefPosition, bool inIsFirstXref,
-                                               XrefEntryInput **outExtendedTable, ObjectIDType *outExtendedTableSize);
-    XrefEntryInput *ExtendXrefTableToSize(XrefEntryInput *inXrefTable, ObjectIDType inOldSize, ObjectIDType inNewSize);
+    charta::EStatusCode ParseXrefFromXrefTable(long long inXrefPosition, bool inIsFirstXref);
     charta::EStatusCode ReadNextXrefEntry(uint8_t inBuffer[20]);
-    std::shared_ptr<charta::PDFObject> ParseExistingInDirectObject(ObjectIDType inObjectID);
+    std::shared_ptr<charta::PDFObject> ParseExistingInDirectObject(ObjectIDType inObjectID,
+                                                                   PDFParserReadContext &ioContext);
     charta::EStatusCode SetupDecryptionHelper(const std::string &inPassword);
     charta::EStatusCode ParsePagesObjectIDs();
     charta::EStatusCode ParsePagesIDs(std::shared_ptr<charta::PDFDictionary> inPageNode, ObjectIDType inNodeObjectID);
     charta::EStatusCode ParsePagesIDs(const std::shared_ptr<charta::PDFDictionary> &inPageNode,
                                       ObjectIDType inNodeObjectID, unsigned long &ioCurrentPageIndex);
     charta::EStatusCode ParsePreviousXrefs(const std::shared_ptr<charta::PDFDictionary> &inTrailer);
-    void MergeXrefWithMainXref(XrefEntryInput *inTableToMerge, ObjectIDType inMergedTableSize);
     charta::EStatusCode ParseFileDirectory();
     charta::EStatusCode BuildXrefTableAndTrailerFromXrefStream(long long inXrefStreamObjectID);
     // an overload for cases where the xref stream object is already parsed
-    charta::EStatusCode ParseXrefFromXrefStream(XrefEntryInput *inXrefTable, ObjectIDType inXrefSize,
-                                                const std::shared_ptr<charta::PDFStreamInput> &inXrefStream,
-                                                XrefEntryInput **outExtendedTable, ObjectIDType *outExtendedTableSize);
+    charta::EStatusCode ParseXrefFromXrefStream(const std::shared_ptr<charta::PDFStreamInput> &inXrefStream);
     // an overload for cases where the position should hold a stream object, and it should be parsed
-    charta::EStatusCode ParseXrefFromXrefStream(XrefEntryInput *inXrefTable, ObjectIDType inXrefSize,
-                                                long long inXrefPosition, XrefEntryInput **outExtendedTable,
-                                                ObjectIDType *outExtendedTableSize);
-    charta::EStatusCode ReadXrefStreamSegment(XrefEntryInput *inXrefTable, ObjectIDType inSegmentStartObject,
-                                              ObjectIDType inSegmentCount, charta::IByteReader *inReadFrom,
-                                              int *inEntryWidths, unsigned long inEntryWidthsSize);
+    charta::EStatusCode ParseXrefFromXrefStream(long long inXrefPosition);
+    charta::EStatusCode ReadXrefStreamSegment(ObjectIDType inSegmentStartObject, ObjectIDType inSegmentCount,
+                                              charta::IByteReader *inReadFrom, int *inEntryWidths,
+                                              unsigned long inEntryWidthsSize);
     charta::EStatusCode ReadXrefSegmentValue(charta::IByteReader *inSource, int inEntrySize, long long &outValue);
     charta::EStatusCode ReadXrefSegmentValue(charta::IByteReader *inSource, int inEntrySize, ObjectIDType &outValue);
-    charta::EStatusCode ParsePreviousFileDirectory(long long inXrefPosition, XrefEntryInput *inXrefTable,
-                                                   ObjectIDType inXrefSize,
+    // reads the trailer of a previous directory, and if it's an xref stream - the stream object. entries are not read.
+    charta::EStatusCode ParsePreviousFileDirectory(long long inXrefPosition,
                                                    std::shared_ptr<charta::PDFDictionary> *outTrailer,
-                                                   XrefEntryInput **outExtendedTable,
-                                                   ObjectIDType *outExtendedTableSize);
-    std::shared_ptr<charta::PDFObject> ParseExistingInDirectStreamObject(ObjectIDType inObjectId);
-    charta::EStatusCode ParseObjectStreamHeader(ObjectStreamHeaderEntry *inHeaderInfo, ObjectIDType inObjectsCount);
+                                                   std::shared_ptr<charta::PDFStreamInput> *outXrefStream);
+    std::shared_ptr<charta::PDFObject> ParseExistingInDirectStreamObject(ObjectIDType inObjectId,
+                                                                         PDFParserReadContext &ioContext);
+    charta::EStatusCode ParseObjectStreamHeader(ObjectStreamHeaderEntry *inHeaderInfo, ObjectIDType inObjectsCount,
+                                                PDFParserReadContext &ioContext);
     void MovePositionInStream(long long inPosition);
+    void MovePositionInStream(long long inPosition, PDFParserReadContext &ioContext);
     EStatusCodeAndIByteReader CreateFilterForStream(charta::IByteReader *inStream,
                                                     const std::shared_ptr<charta::PDFName> &inFilterName,
                                                     const std::shared_ptr<charta::PDFDictionary> &inDecodeParams,
-                                                    const std::shared_ptr<charta::PDFStreamInput> &inPDFStream);
+                                                    const std::shared_ptr<charta::PDFStreamInput> &inPDFStream,
+                                                    PDFParserReadContext &ioContext);
+
+    // object reading over a given read context. the public versions use the parser's own
+    std::shared_ptr<charta::PDFObject> ParseNewObject(ObjectIDType inObjectId, PDFParserReadContext &ioContext);
+    std::shared_ptr<charta::PDFObject> QueryDictionaryObject(const std::shared_ptr<charta::PDFDictionary> &inDictionary,
+                                                             const std::string &inName,
+                                                             PDFParserReadContext &ioContext);
+    std::shared_ptr<charta::PDFObject> QueryDictionaryObject(const std::shared_ptr<charta::PDFDictionary> &inDictionary,
+                                                             charta::EPDFWellKnownName inName,
+                                                             PDFParserReadContext &ioContext);
+    std::shared_ptr<charta::PDFObject> QueryArrayObject(const std::shared_ptr<charta::PDFArray> &inArray,
+                                                        unsigned long inIndex, PDFParserReadContext &ioContext);
+    std::shared_ptr<charta::PDFDictionary> ParsePage(unsigned long inPageIndex, PDFParserReadContext &ioContext);
+    charta::IByteReader *CreateInputStreamReader(const std::shared_ptr<charta::PDFStreamInput> &inStream,
+                                                 PDFParserReadContext &ioContext);
+    charta::IByteReader *CreateInputStreamReaderForPlainCopying(const std::shared_ptr<charta::PDFStreamInput> &inStream,
+                                                                PDFParserReadContext &ioContext);
+    charta::IByteReader *StartReadingFromStream(const std::shared_ptr<charta::PDFStreamInput> &inStream,
+                                                PDFParserReadContext &ioContext);
+    charta::IByteReader *StartReadingFromStreamForPlainCopying(const std::shared_ptr<charta::PDFStreamInput> &inStream,
+                                                               PDFParserReadContext &ioContext);
+    PDFObjectParser *StartReadingObjectsFromStream(std::shared_ptr<charta::PDFStreamInput> inStream,
+                                                   PDFParserReadContext &ioContext);
+    charta::EStatusCode DecodeStreamToBuffer(const std::shared_ptr<charta::PDFStreamInput> &inStream,
+                                             std::vector<uint8_t> &ioBuffer, PDFParserReadContext &ioContext);
+    charta::EStatusCode InflateStreamToBuffer(const std::shared_ptr<charta::PDFStreamInput> &inStream,
+                                              long long inLength, std::vector<uint8_t> &ioBuffer,
+                                              PDFParserReadContext &ioContext);
+    charta::EStatusCode ApplyPredictorToBuffer(const std::shared_ptr<charta::PDFDictionary> &inDecodeParams,
+                                               std::vector<uint8_t> &ioBuffer, PDFParserReadContext &ioContext);
 
     void NotifyIndirectObjectStart(long long inObjectID, long long inGenerationNumber);
     void NotifyIndirectObjectEnd(const std::shared_ptr<charta::PDFObject> &inObject);
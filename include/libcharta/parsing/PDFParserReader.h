@@ -0,0 +1,85 @@
+/*
+   Source File : PDFParserReader.h
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#pragma once
+
+#include "PDFParser.h"
+#include "io/AdapterIByteReaderWithPositionToIReadPositionProvider.h"
+#include "io/IPositionalByteReader.h"
+#include "io/InputPositionalStream.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/*
+    Read only access to a parsed PDFParser, that can be used concurrently. Create one reader per thread, all over
+    the same parser. A reader has its own tokenizer and read position, and reads the file at explicit positions,
+    while the xref, trailer, page list and object stream headers are shared with the parser.
+
+    Positional reads come from inSource - InputFile::GetPositionalReader provides one for files. Without a source,
+    reads go through the parser stream under a lock, which is correct, just slower.
+    Encrypted files, and parsers with an extender, are read one reader at a time.
+    Don't use the parser own reading methods, or restart it, while readers are in use.
+*/
+class PDFParserReader
+{
+  public:
+    PDFParserReader(PDFParser *inParser, charta::IPositionalByteReader *inSource = nullptr);
+    ~PDFParserReader();
+
+    // the PDFParser methods of the same names, reading with this reader
+    std::shared_ptr<charta::PDFObject> ParseNewObject(ObjectIDType inObjectId);
+    std::shared_ptr<charta::PDFObject> QueryDictionaryObject(const std::shared_ptr<charta::PDFDictionary> &inDictionary,
+                                                             const std::string &inName);
+    std::shared_ptr<charta::PDFObject> QueryDictionaryObject(const std::shared_ptr<charta::PDFDictionary> &inDictionary,
+                                                             charta::EPDFWellKnownName inName);
+    std::shared_ptr<charta::PDFObject> QueryArrayObject(const std::shared_ptr<charta::PDFArray> &inArray,
+                                                        unsigned long inIndex);
+    std::shared_ptr<charta::PDFDictionary> ParsePage(unsigned long inPageIndex);
+
+    // streams read through the reader position, so finish with a stream before parsing more objects with the reader.
+    // delete the result when done
+    charta::IByteReader *StartReadingFromStream(const std::shared_ptr<charta::PDFStreamInput> &inStream);
+    charta::IByteReader *StartReadingFromStreamForPlainCopying(const std::shared_ptr<charta::PDFStreamInput> &inStream);
+    PDFObjectParser *StartReadingObjectsFromStream(std::shared_ptr<charta::PDFStreamInput> inStream);
+    PDFObjectParser *StartReadingObjectsFromStreams(std::shared_ptr<charta::PDFArray> inArrayOfStreams);
+    // buffers may come from the parser pool, PDFParser::AcquireStreamBuffer
+    charta::EStatusCode DecodeStreamToBuffer(const std::shared_ptr<charta::PDFStreamInput> &inStream,
+                                             std::vector<uint8_t> &ioBuffer);
+
+    // arenas are not thread safe, so a reader does not use the parser arena. set one per reader if you like
+    void SetObjectArena(std::shared_ptr<charta::PDFObjectArena> inArena);
+
+    PDFParser *GetParser();
+
+  private:
+    class ParserStreamSource;
+
+    PDFParser *mParser;
+    std::unique_ptr<charta::IPositionalByteReader> mParserStreamSource;
+    charta::InputPositionalStream mStream;
+    AdapterIByteReaderWithPositionToIReadPositionProvider mPositionProvider;
+    PDFObjectParser mObjectParser;
+    PDFParserReadContext mReadContext;
+
+    std::unique_lock<std::recursive_mutex> LockIfSerialized();
+};
@@ -26,12 +26,18 @@ struct PDFParsingOptions
 {
     std::string Password;
 
+    // when the cross reference table (or stream) can't be read, or points to the wrong places, rebuild it by
+    // scanning the file for objects and trailers. objects in object streams are indexed as well
+    bool RecoverBrokenXref;
+
     PDFParsingOptions()
     {
+        RecoverBrokenXref = false;
     }
-    PDFParsingOptions(std::string inPassword)
+    PDFParsingOptions(std::string inPassword, bool inRecoverBrokenXref = false)
     {
         Password = inPassword;
+        RecoverBrokenXref = inRecoverBrokenXref;
     }
 
     static const PDFParsingOptions &DefaultPDFParsingOptions();
@@ -0,0 +1,95 @@
+/*
+   Source File : ParsedCMap.h
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#pragma once
+
+#include "EStatusCode.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/*
+    A parsed CMap program - a font ToUnicode map, or an embedded Type0 encoding. Keeps what text extraction needs:
+    the codespace ranges, for splitting strings to character codes, the bfchar/bfrange mappings of codes to unicode,
+    and the cidchar/cidrange mappings of codes to CIDs. usecmap is ignored.
+    Parsing is lenient, entries that can't be read are skipped. Once parsed, a map is read only and may be shared
+    between threads.
+*/
+class ParsedCMap
+{
+  public:
+    ParsedCMap();
+
+    charta::EStatusCode Parse(const uint8_t *inData, size_t inSize);
+
+    // reads one character code from the start of inData (inSize > 0), by the codespace ranges. without ranges, codes
+    // are inDefaultLength bytes long. returns the length of the code
+    size_t ReadCode(const uint8_t *inData, size_t inSize, size_t inDefaultLength, uint32_t &outCode) const;
+
+    // appends the unicode value of the code to ioText, in UTF-8. false if the code is not mapped
+    bool AppendUnicode(uint32_t inCode, std::string &ioText) const;
+    bool MapToCID(uint32_t inCode, uint32_t &outCID) const;
+
+    bool HasCodespaceRanges() const;
+    bool HasUnicodeMappings() const;
+
+    static void AppendUTF8(uint32_t inCodePoint, std::string &ioText);
+
+  private:
+    struct CodespaceRange
+    {
+        uint32_t mLow;
+        uint32_t mHigh;
+        size_t mLength;
+    };
+
+    // ranges may be cut by later definitions, so the values are given for mBaseCode, the first code as defined
+
+    struct UnicodeRange
+    {
+        uint32_t mFirstCode;
+        uint32_t mLastCode;
+        uint32_t mBaseCode;
+        // the unicode value of the base code, in mUnicodes. the last code point is incremented for the codes that
+        // follow
+        uint32_t mOffset;
+        uint32_t mLength;
+    };
+
+    struct CIDRange
+    {
+        uint32_t mFirstCode;
+        uint32_t mLastCode;
+        uint32_t mBaseCode;
+        uint32_t mBaseCID;
+    };
+
+    std::vector<CodespaceRange> mCodespaceRanges;
+    // lengths that codes may have, as bits. when there's just one, codes are read without checking ranges
+    unsigned int mCodeLengths;
+    // sorted by first code, with no overlaps
+    std::vector<UnicodeRange> mUnicodeRanges;
+    std::vector<uint32_t> mUnicodes;
+    std::vector<CIDRange> mCIDRanges;
+
+    void AddUnicodeRange(uint32_t inFirstCode, uint32_t inLastCode, const std::string &inUTF16BE);
+};
@@ -0,0 +1,149 @@
+/*
+   Source File : TextExtractionFont.h
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#pragma once
+
+#include "EStatusCode.h"
+#include "ObjectsBasicTypes.h"
+#include "parsing/ParsedCMap.h"
+
+#include <memory>
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace charta
+{
+class PDFDictionary;
+class PDFObject;
+class PDFStreamInput;
+} // namespace charta
+class PDFParserReader;
+class TextExtractionCache;
+
+/*
+    What text extraction needs to know about a font: how to split shown strings to character codes, the unicode
+    value of each code and the advance width of its glyph.
+
+    Unicode values come from the font ToUnicode map when it has one. Otherwise, simple fonts go through their
+    encoding - WinAnsiEncoding, MacRomanEncoding, StandardEncoding or PDFDocEncoding, with Differences - and the
+    glyph names it gives, and composite fonts with a UCS2/UTF16 CMap use the codes themselves.
+    Widths come from Widths/FirstChar (simple fonts) and W/DW (composite fonts). fonts without widths, like
+    non-embedded standard 14 fonts, get a rough half an em per glyph.
+
+    Fonts are read only once created, and may be shared between threads.
+*/
+class TextExtractionFont
+{
+  public:
+    TextExtractionFont();
+
+    // reads the font dictionary. CMaps go through the cache, when there is one
+    charta::EStatusCode Read(PDFParserReader *inReader, const std::shared_ptr<charta::PDFDictionary> &inFont,
+                             TextExtractionCache *inCache);
+
+    // reads one character code from a shown string (inSize > 0). returns the length of the code
+    size_t ReadCode(const uint8_t *inData, size_t inSize, uint32_t &outCode) const
+    {
+        if (!mIsComposite)
+        {
+            outCode = inData[0];
+            return 1;
+        }
+        return ReadCompositeCode(inData, inSize, outCode);
+    }
+
+    // appends the unicode value of the code, in UTF-8. codes that map to nothing append nothing for simple fonts, and
+    // the replacement character for composite fonts
+    void AppendUnicode(uint32_t inCode, std::string &ioText) const;
+
+    // horizontal displacement of the glyph, in text space units (that is, for a font size of 1)
+    double GetWidth(uint32_t inCode) const;
+
+    bool IsComposite() const;
+    // vertical writing. glyphs then advance downwards by 1 em
+    bool IsVertical() const;
+
+    const std::string &GetBaseFont() const;
+
+    // unicode of glyph names, from the library encodings glyph lists, and uniXXXX/uXXXX names. 0 when unknown
+    static uint32_t GlyphNameToUnicode(const std::string &inGlyphName);
+
+  private:
+    struct WidthRange
+    {
+        uint32_t mFirstCID;
+        uint32_t mLastCID;
+        double mWidth;
+    };
+
+    std::string mBaseFont;
+    bool mIsComposite;
+    bool mIsVertical;
+    std::shared_ptr<const ParsedCMap> mToUnicode;
+    // composite fonts: the encoding CMap when embedded. predefined CMaps are all 2 bytes, identity or unicode ones
+    std::shared_ptr<const ParsedCMap> mEncodingCMap;
+    bool mCodesAreUnicode;
+
+    // simple fonts, by code
+    uint32_t mUnicodes[256];
+    double mWidths[256];
+
+    // composite fonts, by CID
+    double mDefaultWidth;
+    std::vector<WidthRange> mWidthRanges; // sorted
+
+    size_t ReadCompositeCode(const uint8_t *inData, size_t inSize, uint32_t &outCode) const;
+    void ReadSimpleEncoding(PDFParserReader *inReader, const std::shared_ptr<charta::PDFDictionary> &inFont,
+                            const std::string &inSubtype);
+    void ReadSimpleWidths(PDFParserReader *inReader, const std::shared_ptr<charta::PDFDictionary> &inFont,
+                          double inScale);
+    charta::EStatusCode ReadCompositeFont(PDFParserReader *inReader,
+                                          const std::shared_ptr<charta::PDFDictionary> &inFont,
+                                          TextExtractionCache *inCache);
+};
+
+/*
+    Fonts and CMaps by object ID, to read each once per document however many pages use them. The cache is thread
+    safe, share one between the extractors of a document (and don't share it between documents).
+*/
+class TextExtractionCache
+{
+  public:
+    // the font of a font resource entry (a reference, or a direct dictionary, that is not cached). null when the
+    // font can't be read
+    std::shared_ptr<const TextExtractionFont> GetFont(PDFParserReader *inReader,
+                                                      const std::shared_ptr<charta::PDFObject> &inFontEntry);
+    // a CMap stream entry (a reference, or a direct stream, that is not cached). null when it can't be read
+    std::shared_ptr<const ParsedCMap> GetCMap(PDFParserReader *inReader,
+                                              const std::shared_ptr<charta::PDFObject> &inCMapEntry);
+
+    size_t GetFontsCount();
+    size_t GetCMapsCount();
+    void Reset();
+
+  private:
+    std::mutex mMutex;
+    std::unordered_map<ObjectIDType, std::shared_ptr<const TextExtractionFont>> mFonts;
+    std::unordered_map<ObjectIDType, std::shared_ptr<const ParsedCMap>> mCMaps;
+};
@@ -0,0 +1,156 @@
+/*
+   Source File : TextExtractor.h
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#pragma once
+
+#include "EStatusCode.h"
+#include "parsing/ContentStreamReader.h"
+#include "parsing/TextExtractionFont.h"
+
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace charta
+{
+class IPositionalByteReader;
+class PDFDictionary;
+} // namespace charta
+class PDFParser;
+class PDFParserReader;
+
+// text shown in one go, positioned in the page default user space
+struct TextRun
+{
+    std::string mText; // UTF-8
+    // baseline origin of the first glyph, and the point after the advance of the last one
+    double mX;
+    double mY;
+    double mEndX;
+    double mEndY;
+    // the font size, scaled by the text and graphics matrices
+    double mFontSize;
+    std::string mFontName; // BaseFont
+};
+
+class ITextExtractionVisitor
+{
+  public:
+    virtual ~ITextExtractionVisitor() = default;
+
+    // the run is valid only during the call. return false to stop extracting
+    virtual bool OnTextRun(const TextRun &inRun) = 0;
+};
+
+/*
+    Extracts positioned text from pages. Content is read with ContentStreamReader, tracking the graphics and text
+    states (q/Q, cm, BT/ET, Tc, Tw, Tz, TL, Tf, Ts, Td, TD, Tm, T*) and going into form XObjects, and text is
+    decoded with TextExtractionFont.
+
+    A run is the text of one showing operator (Tj, ', ", TJ). TJ runs are split where the spacing moves the text
+    forward by more than a fraction of an em, which is what word gaps usually look like. Runs are reported in content
+    order, RunsToText puts them together to plain text.
+
+    An extractor reads through a PDFParserReader, so create one per thread. They may all share one cache, so fonts
+    and CMaps are read once per document. Run text and content buffers are reused between runs and pages, so keep
+    one extractor for many pages. ExtractPages does all of this for a range of pages, in parallel.
+*/
+class TextExtractor
+{
+  public:
+    // uses a cache of its own, when none is given
+    TextExtractor(PDFParserReader *inReader, TextExtractionCache *inCache = nullptr);
+    ~TextExtractor();
+
+    charta::EStatusCode ExtractPage(unsigned long inPageIndex, ITextExtractionVisitor *inVisitor);
+    // appends the page runs
+    charta::EStatusCode ExtractPage(unsigned long inPageIndex, std::vector<TextRun> &outRuns);
+
+    // TJ spacing, in ems, from which a run is split. default is 0.2
+    void SetWordGapThreshold(double inEms);
+
+    // extracts inPagesCount pages from inFirstPage, using inThreadsCount threads (0 for the hardware concurrency).
+    // outPages gets the runs of each page, in page order. each thread reads with its own PDFParserReader over
+    // inSource, see PDFParserReader for what no source means. pages that fail are left empty, and fail the call
+    static charta::EStatusCode ExtractPages(PDFParser *inParser, charta::IPositionalByteReader *inSource,
+                                            unsigned long inFirstPage, unsigned long inPagesCount,
+                                            unsigned int inThreadsCount, std::vector<std::vector<TextRun>> &outPages,
+                                            TextExtractionCache *inCache = nullptr);
+
+    // plain text of runs in reading order, for a single column at least: runs on another line start a new line,
+    // runs apart on the same line are separated by a space
+    static std::string RunsToText(const std::vector<TextRun> &inRuns);
+
+  private:
+    struct GraphicState
+    {
+        double mCTM[6];
+        double mCharacterSpacing;
+        double mWordSpacing;
+        double mHorizontalScaling;
+        double mLeading;
+        double mRise;
+        double mFontSize;
+        const TextExtractionFont *mFont;
+    };
+
+    PDFParserReader *mReader;
+    TextExtractionCache *mCache;
+    std::unique_ptr<TextExtractionCache> mOwnCache;
+    double mWordGapThreshold;
+
+    // per level of form nesting
+    std::vector<std::unique_ptr<ContentStreamReader>> mContentReaders;
+    std::vector<std::vector<uint8_t>> mContentBuffers;
+    std::vector<uint8_t> mStreamBuffer;
+
+    // page state
+    ITextExtractionVisitor *mVisitor;
+    bool mStopped;
+    std::vector<GraphicState> mStates;
+    double mTextMatrix[6];
+    double mTextLineMatrix[6];
+    // fonts used in the page, which keeps them alive when the cache is reset meanwhile
+    std::vector<std::shared_ptr<const TextExtractionFont>> mPageFonts;
+    std::vector<ObjectIDType> mFormsStack;
+    // fonts of the last resources used, by name as it is in the content
+    std::shared_ptr<charta::PDFDictionary> mFontsResources;
+    std::shared_ptr<charta::PDFDictionary> mFontsDictionary;
+    std::vector<std::pair<std::string, const TextExtractionFont *>> mResourceFonts;
+
+    TextRun mRun;
+    bool mRunOpen;
+    std::string mString;
+
+    charta::EStatusCode ReadContent(const uint8_t *inContent, size_t inSize,
+                                    const std::shared_ptr<charta::PDFDictionary> &inResources, size_t inDepth);
+    charta::EStatusCode DecodePageContents(const std::shared_ptr<charta::PDFDictionary> &inPage,
+                                           std::vector<uint8_t> &outContent);
+    void SetFont(const std::shared_ptr<charta::PDFDictionary> &inResources, const ContentStreamOperand &inName);
+    void ShowText(const ContentStreamOperand &inString);
+    void AdjustText(double inAdjustment);
+    void MoveTextLine(double inX, double inY);
+    void DrawForm(const std::shared_ptr<charta::PDFDictionary> &inResources, const ContentStreamOperand &inName,
+                  size_t inDepth);
+    void FlushRun();
+};
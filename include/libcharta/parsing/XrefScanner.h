@@ -0,0 +1,85 @@
+/*
+   Source File : XrefScanner.h
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#pragma once
+
+#include "EStatusCode.h"
+#include "ObjectsBasicTypes.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace charta
+{
+class IByteReaderWithPosition;
+}
+
+struct XrefScannedObject
+{
+    ObjectIDType mObjectID;
+    unsigned long mGenerationNumber;
+    // position of the object header ("N G obj")
+    long long mPosition;
+};
+
+/*
+    Scans a whole PDF for the markers needed to rebuild a broken cross reference table: indirect object headers
+    ("N G obj"), trailer keywords and a few names that identify special objects (object streams, xref streams and
+    the catalog). Used by PDFParser in recovery mode (see PDFParsingOptions::RecoverBrokenXref).
+
+    The input is read sequentially in large blocks, and candidates are located with memchr, so the scan runs
+    at close to memory speed. Results are in file order.
+*/
+class XrefScanner
+{
+  public:
+    enum EKeyword
+    {
+        eKeywordTrailer,
+        eKeywordObjStm,
+        eKeywordXRef,
+        eKeywordCatalog,
+        eKeywordsCount
+    };
+
+    explicit XrefScanner(size_t inBlockSize = 4 * 1024 * 1024);
+
+    charta::EStatusCode Scan(charta::IByteReaderWithPosition *inStream);
+
+    const std::vector<XrefScannedObject> &GetObjects() const;
+
+    // keyword positions. for trailer this is the position right after the keyword, where the trailer dictionary
+    // starts. for names it is the position of the name
+    const std::vector<long long> &GetKeywordPositions(EKeyword inKeyword) const;
+
+    // index (into GetObjects) of the last object header before inPosition, or -1 if there's none
+    long long FindObjectBefore(long long inPosition) const;
+
+  private:
+    size_t mBlockSize;
+    std::vector<XrefScannedObject> mObjects;
+    std::vector<long long> mKeywordPositions[eKeywordsCount];
+
+    void ScanObjectHeaders(const uint8_t *inBuffer, size_t inLength, size_t inFrom, long long inBufferPosition,
+                           bool inIsLastBlock);
+    void ScanKeyword(EKeyword inKeyword, const uint8_t *inBuffer, size_t inLength, size_t inFrom,
+                     long long inBufferPosition, bool inIsLastBlock);
+};
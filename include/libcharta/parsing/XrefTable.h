@@ -0,0 +1,105 @@
+/*
+   Source File : XrefTable.h
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#pragma once
+
+#include "ObjectsBasicTypes.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+enum EXrefEntryType
+{
+    eXrefEntryExisting,
+    eXrefEntryDelete,
+    eXrefEntryStreamObject,
+    eXrefEntryUndefined
+};
+
+struct XrefEntryInput
+{
+    XrefEntryInput()
+    {
+        mObjectPosition = 0;
+        mRivision = 0;
+        mType = eXrefEntryUndefined;
+    }
+
+    XrefEntryInput(long long inObjectPosition, unsigned long inRivision, EXrefEntryType inType)
+    {
+        mObjectPosition = inObjectPosition;
+        mRivision = inRivision;
+        mType = inType;
+    }
+
+    // well...it's more like...the first number in a pair on an xref, and the second one. the names
+    // are true only for "n" type of entries
+    long long mObjectPosition;
+    unsigned long mRivision;
+    EXrefEntryType mType;
+};
+
+/*
+    Packed cross reference table. Each entry takes 8 bytes:
+    bits 0-39 hold the object position (or the containing object stream ID for compressed objects),
+    bits 40-41 the entry type, bit 42 marks an entry whose values did not fit and are kept in a side table,
+    and bits 43-63 the second xref number (generation, or index inside the object stream).
+    Entries with a position past 1TB or a second number past 2^21 - 1 go to the side table, which in
+    practice stays empty.
+
+    The table grows in place (amortized), so incremental sections can be merged straight into it.
+*/
+class XrefTable
+{
+  public:
+    XrefTable();
+
+    // drop all entries and set up the table with inSize undefined entries
+    void Reset(ObjectIDType inSize);
+
+    // release all memory
+    void Clear();
+
+    ObjectIDType GetSize() const;
+
+    // grow the table so that it holds at least inNewSize entries. new entries are undefined.
+    // never shrinks.
+    void ExtendToSize(ObjectIDType inNewSize);
+
+    EXrefEntryType GetType(ObjectIDType inObjectID) const;
+    long long GetObjectPosition(ObjectIDType inObjectID) const;
+    unsigned long GetRivision(ObjectIDType inObjectID) const;
+    // unpacked copy of an entry. out of range IDs return an undefined entry
+    XrefEntryInput GetEntry(ObjectIDType inObjectID) const;
+
+    // inObjectID must be smaller than the table size
+    void SetEntry(ObjectIDType inObjectID, long long inObjectPosition, unsigned long inRivision,
+                  EXrefEntryType inType);
+
+    // bytes used by the table, for diagnostics
+    size_t GetMemoryFootprint() const;
+
+  private:
+    std::vector<uint64_t> mEntries;
+    std::unordered_map<ObjectIDType, std::pair<long long, unsigned long>> mWideEntries;
+};
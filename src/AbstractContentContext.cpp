@@ -32,6 +32,8 @@
 #include "io/OutputStringBufferStream.h"
 #include <algorithm>
 #include <ctype.h>
+#include <math.h>
+#include <vector>
 
 using namespace charta;
 
@@ -206,6 +208,7 @@ unsigned long AbstractContentContext::ColorValueForName(const std::string &inCol
 AbstractContentContext::AbstractContentContext(charta::DocumentContext *inDocumentContext)
 {
     mDocumentContext = inDocumentContext;
+    mElideRedundantOperators = inDocumentContext != nullptr && inDocumentContext->GetElideRedundantOperators();
 }
 
 AbstractContentContext::~AbstractContentContext() = default;
@@ -220,6 +223,25 @@ void AbstractContentContext::AssertProcsetAvailable(const std::string &inProcset
     GetResourcesDictionary()->AddProcsetResource(inProcsetName);
 }
 
+void AbstractContentContext::SetElideRedundantOperators(bool inElideRedundantOperators)
+{
+    mElideRedundantOperators = inElideRedundantOperators;
+}
+
+bool AbstractContentContext::GetElideRedundantOperators() const
+{
+    return mElideRedundantOperators;
+}
+
+const GraphicState &AbstractContentContext::GetCurrentGraphicState()
+{
+    return mGraphicStack.GetCurrentState();
+}
+
+static const std::string scDeviceGray = "DeviceGray";
+static const std::string scDeviceRGB = "DeviceRGB";
+static const std::string scDeviceCMYK = "DeviceCMYK";
+
 static const std::string scAddRectangleToPath = "re";
 void AbstractContentContext::re(double inLeft, double inBottom, double inWidth, double inHeight)
 {
@@ -233,6 +255,169 @@ void AbstractContentContext::re(double inLeft, double inBottom, double inWidth,
     mPrimitiveWriter.WriteKeyword(scAddRectangleToPath);
 }
 
+// formats path construction operators into a local buffer, writing it to the content stream whenever it fills up
+class PathOperatorsBatch
+{
+  public:
+    PathOperatorsBatch(PrimitiveObjectsWriter &inPrimitiveWriter, const double *inMatrix)
+        : mPrimitiveWriter(inPrimitiveWriter), mMatrix(inMatrix), mLength(0)
+    {
+    }
+
+    ~PathOperatorsBatch()
+    {
+        Flush();
+    }
+
+    template <class T> void WritePoint(const T *inCoordinates)
+    {
+        double x = inCoordinates[0];
+        double y = inCoordinates[1];
+        if (mMatrix != nullptr)
+        {
+            WriteNumber(mMatrix[0] * x + mMatrix[2] * y + mMatrix[4]);
+            WriteNumber(mMatrix[1] * x + mMatrix[3] * y + mMatrix[5]);
+        }
+        else
+        {
+            WriteNumber(x);
+            WriteNumber(y);
+        }
+    }
+
+    void WriteOperator(char inOperator)
+    {
+        if (mLength + 3 > sizeof(mBuffer))
+            Flush();
+        mBuffer[mLength++] = inOperator;
+        mBuffer[mLength++] = '\r';
+        mBuffer[mLength++] = '\n';
+    }
+
+  private:
+    PrimitiveObjectsWriter &mPrimitiveWriter;
+    const double *mMatrix;
+    char mBuffer[8 * 1024];
+    size_t mLength;
+
+    void WriteNumber(double inValue)
+    {
+        if (mLength + PrimitiveObjectsWriter::scMaxDoubleLength + 1 > sizeof(mBuffer))
+            Flush();
+        mLength += PrimitiveObjectsWriter::FormatDouble(inValue, mBuffer + mLength);
+        mBuffer[mLength++] = ' ';
+    }
+
+    void Flush()
+    {
+        if (mLength == 0)
+            return;
+        mPrimitiveWriter.GetWritingStream()->Write((const uint8_t *)mBuffer, mLength);
+        mLength = 0;
+    }
+};
+
+template <class T>
+void AbstractContentContext::WritePolyline(const T *inCoordinates, size_t inPointsCount, const double *inMatrix)
+{
+    if (inPointsCount == 0)
+        return;
+
+    RenewStreamConnection();
+    AssertProcsetAvailable(KProcsetPDF);
+
+    PathOperatorsBatch batch(mPrimitiveWriter, inMatrix);
+    batch.WritePoint(inCoordinates);
+    batch.WriteOperator('m');
+    for (size_t i = 1; i < inPointsCount; ++i)
+    {
+        batch.WritePoint(inCoordinates + 2 * i);
+        batch.WriteOperator('l');
+    }
+}
+
+template <class T>
+void AbstractContentContext::WritePolygons(const T *inCoordinates, const size_t *inPointsCounts,
+                                           size_t inPolygonsCount, const double *inMatrix)
+{
+    if (inPolygonsCount == 0)
+        return;
+
+    RenewStreamConnection();
+    AssertProcsetAvailable(KProcsetPDF);
+
+    PathOperatorsBatch batch(mPrimitiveWriter, inMatrix);
+    const T *polygon = inCoordinates;
+    for (size_t i = 0; i < inPolygonsCount; ++i)
+    {
+        if (inPointsCounts[i] == 0)
+            continue;
+
+        batch.WritePoint(polygon);
+        batch.WriteOperator('m');
+        for (size_t j = 1; j < inPointsCounts[i]; ++j)
+        {
+            batch.WritePoint(polygon + 2 * j);
+            batch.WriteOperator('l');
+        }
+        batch.WriteOperator('h');
+        polygon += 2 * inPointsCounts[i];
+    }
+}
+
+template <class T>
+void AbstractContentContext::WriteCurves(const T *inCoordinates, size_t inPointsCount, const double *inMatrix)
+{
+    if (inPointsCount == 0)
+        return;
+
+    RenewStreamConnection();
+    AssertProcsetAvailable(KProcsetPDF);
+
+    PathOperatorsBatch batch(mPrimitiveWriter, inMatrix);
+    batch.WritePoint(inCoordinates);
+    batch.WriteOperator('m');
+    for (size_t i = 1; i + 2 < inPointsCount; i += 3)
+    {
+        batch.WritePoint(inCoordinates + 2 * i);
+        batch.WritePoint(inCoordinates + 2 * (i + 1));
+        batch.WritePoint(inCoordinates + 2 * (i + 2));
+        batch.WriteOperator('c');
+    }
+}
+
+void AbstractContentContext::Polyline(const double *inCoordinates, size_t inPointsCount, const double *inMatrix)
+{
+    WritePolyline(inCoordinates, inPointsCount, inMatrix);
+}
+
+void AbstractContentContext::Polyline(const float *inCoordinates, size_t inPointsCount, const double *inMatrix)
+{
+    WritePolyline(inCoordinates, inPointsCount, inMatrix);
+}
+
+void AbstractContentContext::Polygons(const double *inCoordinates, const size_t *inPointsCounts,
+                                      size_t inPolygonsCount, const double *inMatrix)
+{
+    WritePolygons(inCoordinates, inPointsCounts, inPolygonsCount, inMatrix);
+}
+
+void AbstractContentContext::Polygons(const float *inCoordinates, const size_t *inPointsCounts,
+                                      size_t inPolygonsCount, const double *inMatrix)
+{
+    WritePolygons(inCoordinates, inPointsCounts, inPolygonsCount, inMatrix);
+}
+
+void AbstractContentContext::Curves(const double *inCoordinates, size_t inPointsCount, const double *inMatrix)
+{
+    WriteCurves(inCoordinates, inPointsCount, inMatrix);
+}
+
+void AbstractContentContext::Curves(const float *inCoordinates, size_t inPointsCount, const double *inMatrix)
+{
+    WriteCurves(inCoordinates, inPointsCount, inMatrix);
+}
+
 static const std::string scFill = "f";
 void AbstractContentContext::f()
 {
@@ -408,6 +593,10 @@ EStatusCode AbstractContentContext::Q()
 
 void AbstractContentContext::cm(double inA, double inB, double inC, double inD, double inE, double inF)
 {
+    // identity changes nothing, whatever the state
+    if (mElideRedundantOperators && inA == 1 && inB == 0 && inC == 0 && inD == 1 && inE == 0 && inF == 0)
+        return;
+
     RenewStreamConnection();
     AssertProcsetAvailable(KProcsetPDF);
 
@@ -418,46 +607,82 @@ void AbstractContentContext::cm(double inA, double inB, double inC, double inD,
     mPrimitiveWriter.WriteDouble(inE);
     mPrimitiveWriter.WriteDouble(inF);
     mPrimitiveWriter.WriteKeyword("cm");
+
+    // CTM' = [a b c d e f] x CTM
+    GraphicState &state = mGraphicStack.GetCurrentState();
+    if (state.mCTMKnown)
+    {
+        double *ctm = state.mCTM;
+        double result[6] = {inA * ctm[0] + inB * ctm[2],
+                            inA * ctm[1] + inB * ctm[3],
+                            inC * ctm[0] + inD * ctm[2],
+                            inC * ctm[1] + inD * ctm[3],
+                            inE * ctm[0] + inF * ctm[2] + ctm[4],
+                            inE * ctm[1] + inF * ctm[3] + ctm[5]};
+        for (int i = 0; i < 6; ++i)
+            ctm[i] = result[i];
+    }
 }
 
 void AbstractContentContext::w(double inLineWidth)
 {
+    if (mElideRedundantOperators && mGraphicStack.GetCurrentState().mLineWidth == inLineWidth)
+        return;
+
     RenewStreamConnection();
     AssertProcsetAvailable(KProcsetPDF);
 
     mPrimitiveWriter.WriteDouble(inLineWidth);
     mPrimitiveWriter.WriteKeyword("w");
+    mGraphicStack.GetCurrentState().mLineWidth = inLineWidth;
 }
 
 void AbstractContentContext::J(int inLineCapStyle)
 {
+    if (mElideRedundantOperators && mGraphicStack.GetCurrentState().mLineCap == inLineCapStyle)
+        return;
+
     RenewStreamConnection();
     AssertProcsetAvailable(KProcsetPDF);
 
     mPrimitiveWriter.WriteInteger(inLineCapStyle);
     mPrimitiveWriter.WriteKeyword("J");
+    mGraphicStack.GetCurrentState().mLineCap = inLineCapStyle;
 }
 
 void AbstractContentContext::j(int inLineJoinStyle)
 {
+    if (mElideRedundantOperators && mGraphicStack.GetCurrentState().mLineJoin == inLineJoinStyle)
+        return;
+
     RenewStreamConnection();
     AssertProcsetAvailable(KProcsetPDF);
 
     mPrimitiveWriter.WriteInteger(inLineJoinStyle);
     mPrimitiveWriter.WriteKeyword("j");
+    mGraphicStack.GetCurrentState().mLineJoin = inLineJoinStyle;
 }
 
 void AbstractContentContext::M(double inMiterLimit)
 {
+    if (mElideRedundantOperators && mGraphicStack.GetCurrentState().mMiterLimit == inMiterLimit)
+        return;
+
     RenewStreamConnection();
     AssertProcsetAvailable(KProcsetPDF);
 
     mPrimitiveWriter.WriteDouble(inMiterLimit);
     mPrimitiveWriter.WriteKeyword("M");
+    mGraphicStack.GetCurrentState().mMiterLimit = inMiterLimit;
 }
 
 void AbstractContentContext::d(double *inDashArray, int inDashArrayLength, double inDashPhase)
 {
+    std::pair<std::vector<double>, double> dashPattern(
+        std::vector<double>(inDashArray, inDashArray + std::max(inDashArrayLength, 0)), inDashPhase);
+    if (mElideRedundantOperators && mGraphicStack.GetCurrentState().mDashPattern == dashPattern)
+        return;
+
     RenewStreamConnection();
     AssertProcsetAvailable(KProcsetPDF);
 
@@ -467,6 +692,7 @@ void AbstractContentContext::d(double *inDashArray, int inDashArrayLength, doubl
     mPrimitiveWriter.EndArray(eTokenSeparatorSpace);
     mPrimitiveWriter.WriteDouble(inDashPhase);
     mPrimitiveWriter.WriteKeyword("d");
+    mGraphicStack.GetCurrentState().mDashPattern = std::move(dashPattern);
 }
 
 void AbstractContentContext::ri(const std::string &inRenderingIntentName)
@@ -494,6 +720,15 @@ void AbstractContentContext::gs(const std::string &inGraphicStateName)
 
     mPrimitiveWriter.WriteName(inGraphicStateName);
     mPrimitiveWriter.WriteKeyword("gs");
+
+    // an extended graphic state may set the line style and the font
+    GraphicState &state = mGraphicStack.GetCurrentState();
+    state.mLineWidth.reset();
+    state.mLineCap.reset();
+    state.mLineJoin.reset();
+    state.mMiterLimit.reset();
+    state.mDashPattern.reset();
+    state.mPlacedFontName.clear();
 }
 
 void AbstractContentContext::CS(const std::string &inColorSpaceName)
@@ -503,6 +738,7 @@ void AbstractContentContext::CS(const std::string &inColorSpaceName)
 
     mPrimitiveWriter.WriteName(inColorSpaceName);
     mPrimitiveWriter.WriteKeyword("CS");
+    mGraphicStack.GetCurrentState().mStrokeColor.Set(inColorSpaceName, nullptr, 0);
 }
 
 void AbstractContentContext::cs(const std::string &inColorSpaceName)
@@ -512,26 +748,37 @@ void AbstractContentContext::cs(const std::string &inColorSpaceName)
 
     mPrimitiveWriter.WriteName(inColorSpaceName);
     mPrimitiveWriter.WriteKeyword("cs");
+    mGraphicStack.GetCurrentState().mFillColor.Set(inColorSpaceName, nullptr, 0);
 }
 
 void AbstractContentContext::SC(double *inColorComponents, int inColorComponentsLength)
 {
+    GraphicStateColor &color = mGraphicStack.GetCurrentState().mStrokeColor;
+    if (mElideRedundantOperators && color.Matches(color.mColorSpace, inColorComponents, inColorComponentsLength))
+        return;
+
     RenewStreamConnection();
     AssertProcsetAvailable(KProcsetPDF);
 
     for (int i = 0; i < inColorComponentsLength; ++i)
         mPrimitiveWriter.WriteDouble(inColorComponents[i]);
     mPrimitiveWriter.WriteKeyword("SC");
+    color.Set(color.mColorSpace, inColorComponents, inColorComponentsLength);
 }
 
 void AbstractContentContext::SCN(double *inColorComponents, int inColorComponentsLength)
 {
+    GraphicStateColor &color = mGraphicStack.GetCurrentState().mStrokeColor;
+    if (mElideRedundantOperators && color.Matches(color.mColorSpace, inColorComponents, inColorComponentsLength))
+        return;
+
     RenewStreamConnection();
     AssertProcsetAvailable(KProcsetPDF);
 
     for (int i = 0; i < inColorComponentsLength; ++i)
         mPrimitiveWriter.WriteDouble(inColorComponents[i]);
     mPrimitiveWriter.WriteKeyword("SCN");
+    color.Set(color.mColorSpace, inColorComponents, inColorComponentsLength);
 }
 
 void AbstractContentContext::SCN(double *inColorComponents, int inColorComponentsLength,
@@ -544,26 +791,40 @@ void AbstractContentContext::SCN(double *inColorComponents, int inColorComponent
         mPrimitiveWriter.WriteDouble(inColorComponents[i]);
     mPrimitiveWriter.WriteName(inPatternName);
     mPrimitiveWriter.WriteKeyword("SCN");
+
+    // pattern colors are not followed
+    GraphicStateColor &color = mGraphicStack.GetCurrentState().mStrokeColor;
+    color.Set(color.mColorSpace, nullptr, 0);
 }
 
 void AbstractContentContext::sc(double *inColorComponents, int inColorComponentsLength)
 {
+    GraphicStateColor &color = mGraphicStack.GetCurrentState().mFillColor;
+    if (mElideRedundantOperators && color.Matches(color.mColorSpace, inColorComponents, inColorComponentsLength))
+        return;
+
     RenewStreamConnection();
     AssertProcsetAvailable(KProcsetPDF);
 
     for (int i = 0; i < inColorComponentsLength; ++i)
         mPrimitiveWriter.WriteDouble(inColorComponents[i]);
     mPrimitiveWriter.WriteKeyword("sc");
+    color.Set(color.mColorSpace, inColorComponents, inColorComponentsLength);
 }
 
 void AbstractContentContext::scn(double *inColorComponents, int inColorComponentsLength)
 {
+    GraphicStateColor &color = mGraphicStack.GetCurrentState().mFillColor;
+    if (mElideRedundantOperators && color.Matches(color.mColorSpace, inColorComponents, inColorComponentsLength))
+        return;
+
     RenewStreamConnection();
     AssertProcsetAvailable(KProcsetPDF);
 
     for (int i = 0; i < inColorComponentsLength; ++i)
         mPrimitiveWriter.WriteDouble(inColorComponents[i]);
     mPrimitiveWriter.WriteKeyword("scn");
+    color.Set(color.mColorSpace, inColorComponents, inColorComponentsLength);
 }
 
 void AbstractContentContext::scn(double *inColorComponents, int inColorComponentsLength,
@@ -576,28 +837,49 @@ void AbstractContentContext::scn(double *inColorComponents, int inColorComponent
         mPrimitiveWriter.WriteDouble(inColorComponents[i]);
     mPrimitiveWriter.WriteName(inPatternName);
     mPrimitiveWriter.WriteKeyword("scn");
+
+    // pattern colors are not followed
+    GraphicStateColor &color = mGraphicStack.GetCurrentState().mFillColor;
+    color.Set(color.mColorSpace, nullptr, 0);
 }
 
 void AbstractContentContext::G(double inGray)
 {
+    double components[1] = {inGray};
+    GraphicStateColor &color = mGraphicStack.GetCurrentState().mStrokeColor;
+    if (mElideRedundantOperators && color.Matches(scDeviceGray, components, 1))
+        return;
+
     RenewStreamConnection();
     AssertProcsetAvailable(KProcsetPDF);
 
     mPrimitiveWriter.WriteDouble(inGray);
     mPrimitiveWriter.WriteKeyword("G");
+    color.Set(scDeviceGray, components, 1);
 }
 
 void AbstractContentContext::g(double inGray)
 {
+    double components[1] = {inGray};
+    GraphicStateColor &color = mGraphicStack.GetCurrentState().mFillColor;
+    if (mElideRedundantOperators && color.Matches(scDeviceGray, components, 1))
+        return;
+
     RenewStreamConnection();
     AssertProcsetAvailable(KProcsetPDF);
 
     mPrimitiveWriter.WriteDouble(inGray);
     mPrimitiveWriter.WriteKeyword("g");
+    color.Set(scDeviceGray, components, 1);
 }
 
 void AbstractContentContext::RG(double inR, double inG, double inB)
 {
+    double components[3] = {inR, inG, inB};
+    GraphicStateColor &color = mGraphicStack.GetCurrentState().mStrokeColor;
+    if (mElideRedundantOperators && color.Matches(scDeviceRGB, components, 3))
+        return;
+
     RenewStreamConnection();
     AssertProcsetAvailable(KProcsetPDF);
 
@@ -605,10 +887,16 @@ void AbstractContentContext::RG(double inR, double inG, double inB)
     mPrimitiveWriter.WriteDouble(inG);
     mPrimitiveWriter.WriteDouble(inB);
     mPrimitiveWriter.WriteKeyword("RG");
+    color.Set(scDeviceRGB, components, 3);
 }
 
 void AbstractContentContext::rg(double inR, double inG, double inB)
 {
+    double components[3] = {inR, inG, inB};
+    GraphicStateColor &color = mGraphicStack.GetCurrentState().mFillColor;
+    if (mElideRedundantOperators && color.Matches(scDeviceRGB, components, 3))
+        return;
+
     RenewStreamConnection();
     AssertProcsetAvailable(KProcsetPDF);
 
@@ -616,10 +904,16 @@ void AbstractContentContext::rg(double inR, double inG, double inB)
     mPrimitiveWriter.WriteDouble(inG);
     mPrimitiveWriter.WriteDouble(inB);
     mPrimitiveWriter.WriteKeyword("rg");
+    color.Set(scDeviceRGB, components, 3);
 }
 
 void AbstractContentContext::K(double inC, double inM, double inY, double inK)
 {
+    double components[4] = {inC, inM, inY, inK};
+    GraphicStateColor &color = mGraphicStack.GetCurrentState().mStrokeColor;
+    if (mElideRedundantOperators && color.Matches(scDeviceCMYK, components, 4))
+        return;
+
     RenewStreamConnection();
     AssertProcsetAvailable(KProcsetPDF);
 
@@ -628,10 +922,16 @@ void AbstractContentContext::K(double inC, double inM, double inY, double inK)
     mPrimitiveWriter.WriteDouble(inY);
     mPrimitiveWriter.WriteDouble(inK);
     mPrimitiveWriter.WriteKeyword("K");
+    color.Set(scDeviceCMYK, components, 4);
 }
 
 void AbstractContentContext::k(double inC, double inM, double inY, double inK)
 {
+    double components[4] = {inC, inM, inY, inK};
+    GraphicStateColor &color = mGraphicStack.GetCurrentState().mFillColor;
+    if (mElideRedundantOperators && color.Matches(scDeviceCMYK, components, 4))
+        return;
+
     RenewStreamConnection();
     AssertProcsetAvailable(KProcsetPDF);
 
@@ -640,6 +940,7 @@ void AbstractContentContext::k(double inC, double inM, double inY, double inK)
     mPrimitiveWriter.WriteDouble(inY);
     mPrimitiveWriter.WriteDouble(inK);
     mPrimitiveWriter.WriteKeyword("k");
+    color.Set(scDeviceCMYK, components, 4);
 }
 
 void AbstractContentContext::W()
@@ -669,42 +970,58 @@ void AbstractContentContext::Do(const std::string &inXObjectName)
 
 void AbstractContentContext::Tc(double inCharacterSpace)
 {
+    if (mElideRedundantOperators && mGraphicStack.GetCurrentState().mCharacterSpacing == inCharacterSpace)
+        return;
+
     RenewStreamConnection();
     AssertProcsetAvailable(KProcsetPDF);
     AssertProcsetAvailable(KProcsetText);
 
     mPrimitiveWriter.WriteDouble(inCharacterSpace);
     mPrimitiveWriter.WriteKeyword("Tc");
+    mGraphicStack.GetCurrentState().mCharacterSpacing = inCharacterSpace;
 }
 
 void AbstractContentContext::Tw(double inWordSpace)
 {
+    if (mElideRedundantOperators && mGraphicStack.GetCurrentState().mWordSpacing == inWordSpace)
+        return;
+
     RenewStreamConnection();
     AssertProcsetAvailable(KProcsetPDF);
     AssertProcsetAvailable(KProcsetText);
 
     mPrimitiveWriter.WriteDouble(inWordSpace);
     mPrimitiveWriter.WriteKeyword("Tw");
+    mGraphicStack.GetCurrentState().mWordSpacing = inWordSpace;
 }
 
 void AbstractContentContext::Tz(int inHorizontalScaling)
 {
+    if (mElideRedundantOperators && mGraphicStack.GetCurrentState().mHorizontalScaling == inHorizontalScaling)
+        return;
+
     RenewStreamConnection();
     AssertProcsetAvailable(KProcsetPDF);
     AssertProcsetAvailable(KProcsetText);
 
     mPrimitiveWriter.WriteInteger(inHorizontalScaling);
     mPrimitiveWriter.WriteKeyword("Tz");
+    mGraphicStack.GetCurrentState().mHorizontalScaling = inHorizontalScaling;
 }
 
 void AbstractContentContext::TL(double inTextLeading)
 {
+    if (mElideRedundantOperators && mGraphicStack.GetCurrentState().mLeading == inTextLeading)
+        return;
+
     RenewStreamConnection();
     AssertProcsetAvailable(KProcsetPDF);
     AssertProcsetAvailable(KProcsetText);
 
     mPrimitiveWriter.WriteDouble(inTextLeading);
     mPrimitiveWriter.WriteKeyword("TL");
+    mGraphicStack.GetCurrentState().mLeading = inTextLeading;
 }
 
 void AbstractContentContext::TfLow(const std::string &inFontName, double inFontSize)
@@ -723,22 +1040,30 @@ void AbstractContentContext::TfLow(const std::string &inFontName, double inFontS
 
 void AbstractContentContext::Tr(int inRenderingMode)
 {
+    if (mElideRedundantOperators && mGraphicStack.GetCurrentState().mRenderingMode == inRenderingMode)
+        return;
+
     RenewStreamConnection();
     AssertProcsetAvailable(KProcsetPDF);
     AssertProcsetAvailable(KProcsetText);
 
     mPrimitiveWriter.WriteInteger(inRenderingMode);
     mPrimitiveWriter.WriteKeyword("Tr");
+    mGraphicStack.GetCurrentState().mRenderingMode = inRenderingMode;
 }
 
 void AbstractContentContext::Ts(double inFontRise)
 {
+    if (mElideRedundantOperators && mGraphicStack.GetCurrentState().mRise == inFontRise)
+        return;
+
     RenewStreamConnection();
     AssertProcsetAvailable(KProcsetPDF);
     AssertProcsetAvailable(KProcsetText);
 
     mPrimitiveWriter.WriteDouble(inFontRise);
     mPrimitiveWriter.WriteKeyword("Ts");
+    mGraphicStack.GetCurrentState().mRise = inFontRise;
 }
 
 void AbstractContentContext::BT()
@@ -855,6 +1180,8 @@ void AbstractContentContext::DoubleQuoteLow(double inWordSpacing, double inChara
     mPrimitiveWriter.WriteDouble(inCharacterSpacing);
     mPrimitiveWriter.WriteLiteralString(inText);
     mPrimitiveWriter.WriteKeyword("\"");
+    mGraphicStack.GetCurrentState().mWordSpacing = inWordSpacing;
+    mGraphicStack.GetCurrentState().mCharacterSpacing = inCharacterSpacing;
 }
 
 void AbstractContentContext::DoubleQuoteHexLow(double inWordSpacing, double inCharacterSpacing,
@@ -868,6 +1195,8 @@ void AbstractContentContext::DoubleQuoteHexLow(double inWordSpacing, double inCh
     mPrimitiveWriter.WriteDouble(inCharacterSpacing);
     mPrimitiveWriter.WriteHexString(inText);
     mPrimitiveWriter.WriteKeyword("\"");
+    mGraphicStack.GetCurrentState().mWordSpacing = inWordSpacing;
+    mGraphicStack.GetCurrentState().mCharacterSpacing = inCharacterSpacing;
 }
 
 void AbstractContentContext::TJLow(const std::list<StringOrDouble> &inStringsAndSpacing)
@@ -1254,6 +1583,7 @@ void AbstractContentContext::WriteFreeCode(const std::string &inFreeCode)
 {
     RenewStreamConnection();
     mPrimitiveWriter.GetWritingStream()->Write((const uint8_t *)(inFreeCode.c_str()), inFreeCode.length());
+    mGraphicStack.GetCurrentState().Invalidate();
 }
 void AbstractContentContext::WriteFreeCode(charta::IByteReader *inFreeCodeSource)
 {
@@ -1261,6 +1591,7 @@ void AbstractContentContext::WriteFreeCode(charta::IByteReader *inFreeCodeSource
 
     OutputStreamTraits traits(mPrimitiveWriter.GetWritingStream());
     traits.CopyToOutputStream(inFreeCodeSource);
+    mGraphicStack.GetCurrentState().Invalidate();
 }
 
 void AbstractContentContext::AddContentContextListener(IContentContextListener *inExtender)
@@ -1313,15 +1644,67 @@ void AbstractContentContext::DrawPath(const DoubleAndDoublePairList &inPathPoint
     if (inPathPoints.empty())
         return;
 
+    std::vector<double> coordinates;
+    coordinates.reserve(inPathPoints.size() * 2);
+    for (const auto &point : inPathPoints)
+    {
+        coordinates.push_back(point.first);
+        coordinates.push_back(point.second);
+    }
+    DrawPolyline(coordinates.data(), inPathPoints.size(), inOptions);
+}
+
+void AbstractContentContext::DrawPolyline(const double *inCoordinates, size_t inPointsCount,
+                                          const GraphicOptions &inOptions, const double *inMatrix)
+{
+    if (inPointsCount == 0)
+        return;
+
     SetupColor(inOptions);
     if (inOptions.drawingType == eStroke)
         w(inOptions.strokeWidth);
+    Polyline(inCoordinates, inPointsCount, inMatrix);
+    FinishPath(inOptions);
+}
+
+void AbstractContentContext::DrawPolyline(const float *inCoordinates, size_t inPointsCount,
+                                          const GraphicOptions &inOptions, const double *inMatrix)
+{
+    if (inPointsCount == 0)
+        return;
 
-    auto it = inPathPoints.begin();
-    m(it->first, it->second);
-    ++it;
-    for (; it != inPathPoints.end(); ++it)
-        l(it->first, it->second);
+    SetupColor(inOptions);
+    if (inOptions.drawingType == eStroke)
+        w(inOptions.strokeWidth);
+    Polyline(inCoordinates, inPointsCount, inMatrix);
+    FinishPath(inOptions);
+}
+
+void AbstractContentContext::DrawPolygons(const double *inCoordinates, const size_t *inPointsCounts,
+                                          size_t inPolygonsCount, const GraphicOptions &inOptions,
+                                          const double *inMatrix)
+{
+    if (inPolygonsCount == 0)
+        return;
+
+    SetupColor(inOptions);
+    if (inOptions.drawingType == eStroke)
+        w(inOptions.strokeWidth);
+    Polygons(inCoordinates, inPointsCounts, inPolygonsCount, inMatrix);
+    FinishPath(inOptions);
+}
+
+void AbstractContentContext::DrawPolygons(const float *inCoordinates, const size_t *inPointsCounts,
+                                          size_t inPolygonsCount, const GraphicOptions &inOptions,
+                                          const double *inMatrix)
+{
+    if (inPolygonsCount == 0)
+        return;
+
+    SetupColor(inOptions);
+    if (inOptions.drawingType == eStroke)
+        w(inOptions.strokeWidth);
+    Polygons(inCoordinates, inPointsCounts, inPolygonsCount, inMatrix);
     FinishPath(inOptions);
 }
 
@@ -1464,8 +1847,12 @@ void AbstractContentContext::DrawImage(double inX, double inY, const std::string
     transformation[4] += inX;
     transformation[5] += inY;
 
-    // registering the images at pdfwriter to allow optimization on image writes
-    ObjectIDTypeAndBool result = mDocumentContext->RegisterImageForDrawing(inImagePath, inOptions.imageIndex);
+    // registering the images at pdfwriter to allow optimization on image writes. the scale of the placement lets
+    // it downsample images drawn smaller than their natural size
+    double scaleX = sqrt(transformation[0] * transformation[0] + transformation[1] * transformation[1]);
+    double scaleY = sqrt(transformation[2] * transformation[2] + transformation[3] * transformation[3]);
+    ObjectIDTypeAndBool result =
+        mDocumentContext->RegisterImageForDrawing(inImagePath, inOptions.imageIndex, scaleX, scaleY);
     if (result.second)
     {
         // if first usage, write the image
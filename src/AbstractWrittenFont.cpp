@@ -22,13 +22,13 @@
 #include "DictionaryContext.h"
 #include "IndirectObjectsReferenceRegistry.h"
 #include "ObjectsContext.h"
+#include "StateReader.h"
 #include "Trace.h"
 #include "objects/PDFArray.h"
 #include "objects/PDFDictionary.h"
 #include "objects/PDFIndirectObjectReference.h"
 #include "objects/PDFInteger.h"
 #include "objects/PDFObjectCast.h"
-#include "parsing/PDFParser.h"
 
 #include <list>
 
@@ -408,7 +408,7 @@ void AbstractWrittenFont::WriteGlyphEncodingInfoState(ObjectsContext *inStateWri
     inStateWriter->EndIndirectObject();
 }
 
-EStatusCode AbstractWrittenFont::ReadStateFromObject(PDFParser *inStateReader,
+EStatusCode AbstractWrittenFont::ReadStateFromObject(StateReader *inStateReader,
                                                      const std::shared_ptr<charta::PDFDictionary> &inState)
 {
     PDFObjectCastPtr<charta::PDFDictionary> cidRepresentationState(
@@ -437,7 +437,7 @@ EStatusCode AbstractWrittenFont::ReadStateFromObject(PDFParser *inStateReader,
     return charta::eSuccess;
 }
 
-void AbstractWrittenFont::ReadWrittenFontState(PDFParser *inStateReader,
+void AbstractWrittenFont::ReadWrittenFontState(StateReader *inStateReader,
                                                const std::shared_ptr<charta::PDFDictionary> &inState,
                                                WrittenFontRepresentation *inRepresentation)
 {
@@ -466,7 +466,7 @@ void AbstractWrittenFont::ReadWrittenFontState(PDFParser *inStateReader,
     inRepresentation->mWrittenObjectID = (ObjectIDType)writtenObjectIDState->GetValue();
 }
 
-void AbstractWrittenFont::ReadGlyphEncodingInfoState(PDFParser *inStateReader, ObjectIDType inObjectID,
+void AbstractWrittenFont::ReadGlyphEncodingInfoState(StateReader *inStateReader, ObjectIDType inObjectID,
                                                      GlyphEncodingInfo &inGlyphEncodingInfo)
 {
     PDFObjectCastPtr<charta::PDFDictionary> glyphEncodingInfoState(inStateReader->ParseNewObject(inObjectID));
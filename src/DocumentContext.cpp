@@ -29,14 +29,20 @@
 #include "InfoDictionary.h"
 #include "ObjectsContext.h"
 #include "PDFFormXObject.h"
+#include "PDFImageXObject.h"
 #include "PDFPage.h"
 #include "PDFTiledPattern.h"
+#include "PageContentBuffer.h"
 #include "PageContentContext.h"
 #include "PageTree.h"
+#include "StateReader.h"
 #include "Trace.h"
+#include "XObjectContentContext.h"
 #include "encoding/Ascii7Encoding.h"
 #include "encryption/MD5Generator.h"
+#include "images/PreparedImage.h"
 #include "io/IByteWriterWithPosition.h"
+#include "io/InputFile.h"
 #include "io/OutputFile.h"
 #include "objects/PDFArray.h"
 #include "objects/PDFBoolean.h"
@@ -48,14 +54,20 @@
 #include "objects/PDFName.h"
 #include "objects/PDFObjectCast.h"
 #include "objects/PDFPageInput.h"
+#include "objects/helpers/ParsedPrimitiveHelper.h"
 #include "parsing/PDFDocumentCopyingContext.h"
 #include "parsing/PDFParser.h"
 
+#include <math.h>
+
 charta::DocumentContext::DocumentContext()
 {
     mObjectsContext = nullptr;
     mParserExtender = nullptr;
     mModifiedDocumentIDExists = false;
+    mElideRedundantOperators = false;
+    mImageTargetResolution = 0;
+    mImageJPEGQuality = 85;
 }
 
 charta::DocumentContext::~DocumentContext()
@@ -67,6 +79,7 @@ void charta::DocumentContext::SetObjectsContext(ObjectsContext *inObjectsContext
 {
     mObjectsContext = inObjectsContext;
     mJPEGImageHandler.SetOperationsContexts(this, mObjectsContext);
+    mPixelsImageHandler.SetObjectsContext(mObjectsContext);
     mPDFDocumentHandler.SetOperationsContexts(this, mObjectsContext);
     mUsedFontsRepository.SetObjectsContext(mObjectsContext);
 #ifndef LIBCHARTA_NO_TIFF
@@ -82,6 +95,27 @@ void charta::DocumentContext::SetEmbedFonts(bool inEmbedFonts)
     mUsedFontsRepository.SetEmbedFonts(inEmbedFonts);
 }
 
+void charta::DocumentContext::SetElideRedundantOperators(bool inElideRedundantOperators)
+{
+    mElideRedundantOperators = inElideRedundantOperators;
+}
+
+bool charta::DocumentContext::GetElideRedundantOperators() const
+{
+    return mElideRedundantOperators;
+}
+
+void charta::DocumentContext::SetImageOptimization(double inTargetResolution, int inJPEGQuality)
+{
+    mImageTargetResolution = inTargetResolution;
+    mImageJPEGQuality = inJPEGQuality;
+}
+
+void charta::DocumentContext::SetImagePreparationThreads(unsigned int inThreadsCount)
+{
+    mImagePreparationPool.SetThreadsCount(inThreadsCount);
+}
+
 void charta::DocumentContext::SetOutputFileInformation(OutputFile *inOutputFile)
 {
     // just save the output file path for the ID generation in the end
@@ -223,6 +257,7 @@ charta::EStatusCode charta::DocumentContext::FinalizeNewPDF()
 
         WriteXrefReference(xrefTablePosition);
         WriteFinalEOF();
+        UpdateXrefStatistics(xrefTablePosition);
 
     } while (false);
 
@@ -245,6 +280,18 @@ void charta::DocumentContext::WriteFinalEOF()
     mObjectsContext->EndFreeContext();
 }
 
+void charta::DocumentContext::UpdateXrefStatistics(long long inXrefSectionStart)
+{
+    WriterStatistics *statistics = mObjectsContext->GetStatistics();
+    if (statistics == nullptr)
+        return;
+
+    // xref table, trailer and the file end. not objects, so only bytes are added
+    long long endPosition = mObjectsContext->GetCurrentPosition();
+    statistics->AddBytes(eWriterStatisticsCategoryXref, endPosition - inXrefSectionStart);
+    statistics->SetOutputBytes(endPosition);
+}
+
 static const std::string scTrailer = "trailer";
 static const std::string scSize = "Size";
 static const std::string scPrev = "Prev";
@@ -355,6 +402,7 @@ static const std::string scFalse = "False";
 
 void charta::DocumentContext::WriteInfoDictionary()
 {
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryMetadata);
     InfoDictionary &infoDictionary = mTrailerInformation.GetInfo();
     if (infoDictionary.IsEmpty())
         return;
@@ -635,6 +683,7 @@ static const std::string scContents = "Contents";
 
 EStatusCodeAndObjectIDType charta::DocumentContext::WritePage(PDFPage &inPage)
 {
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryContent);
     EStatusCodeAndObjectIDType result;
 
     result.first = charta::eSuccess;
@@ -789,6 +838,34 @@ EStatusCodeAndObjectIDType charta::DocumentContext::WritePageAndRelease(PDFPage
     return status;
 }
 
+PageContentBuffer *charta::DocumentContext::StartPageContentBuffer(PDFPage &inPage, ObjectIDType inObjectsCount)
+{
+    if (mEncryptionHelper.IsEncrypting())
+    {
+        TRACE_LOG("charta::DocumentContext::StartPageContentBuffer, page content buffers are not supported for "
+                  "encrypted documents");
+        return nullptr;
+    }
+
+    ObjectIDType firstObjectID = mObjectsContext->GetInDirectObjectsRegistry().AllocateObjectIDRange(inObjectsCount);
+    return new PageContentBuffer(this, inPage, firstObjectID, inObjectsCount, mObjectsContext->IsCompressingStreams());
+}
+
+EStatusCodeAndObjectIDType charta::DocumentContext::CommitPageContentBuffer(PageContentBuffer *inPageContentBuffer)
+{
+    EStatusCodeAndObjectIDType result;
+
+    result.first = inPageContentBuffer->WriteTo(mObjectsContext);
+    result.second = 0;
+    if (result.first != eSuccess)
+        TRACE_LOG("charta::DocumentContext::CommitPageContentBuffer, failed to write page content buffer");
+    else
+        result = WritePage(inPageContentBuffer->GetPage());
+
+    delete inPageContentBuffer;
+    return result;
+}
+
 static const std::string scUnknown = "Unknown";
 std::string charta::DocumentContext::GenerateMD5IDForFile()
 {
@@ -1027,6 +1104,7 @@ PDFFormXObject *charta::DocumentContext::StartFormXObject(const PDFRectangle &in
 
 charta::EStatusCode charta::DocumentContext::EndFormXObjectNoRelease(PDFFormXObject *inFormXObject)
 {
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryContent);
     mObjectsContext->EndPDFStream(inFormXObject->GetContentStream());
 
     // now write the resources dictionary, full of all the goodness that got accumulated over the stream write
@@ -1056,6 +1134,7 @@ charta::EStatusCode charta::DocumentContext::EndFormXObjectNoRelease(PDFFormXObj
 
 charta::EStatusCode charta::DocumentContext::EndTiledPattern(PDFTiledPattern *inTiledPattern)
 {
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryContent);
     mObjectsContext->EndPDFStream(inTiledPattern->GetContentStream());
 
     // now write the resources dictionary, full of all the goodness that got accumulated over the stream write
@@ -1267,18 +1346,39 @@ bool charta::DocumentContext::IsIdentityMatrix(const double *inMatrix)
 
 PDFImageXObject *charta::DocumentContext::CreateImageXObjectFromJPGFile(const std::string &inJPGFilePath)
 {
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryImages,
+                                          eWriterStatisticsPhaseImageDecoding);
     return mJPEGImageHandler.CreateImageXObjectFromJPGFile(inJPGFilePath);
 }
 
 PDFFormXObject *charta::DocumentContext::CreateFormXObjectFromJPGFile(const std::string &inJPGFilePath)
 {
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryImages,
+                                          eWriterStatisticsPhaseImageDecoding);
     return mJPEGImageHandler.CreateFormXObjectFromJPGFile(inJPGFilePath);
 }
 
+PDFImageXObject *charta::DocumentContext::CreateImageXObjectFromPixels(const PixelsImageDescription &inPixels)
+{
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryImages,
+                                          eWriterStatisticsPhaseCompression);
+    return mPixelsImageHandler.CreateImageXObjectFromPixels(inPixels);
+}
+
+PDFImageXObject *charta::DocumentContext::CreateImageXObjectFromPixels(const PixelsImageDescription &inPixels,
+                                                                       ObjectIDType inImageXObjectID)
+{
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryImages,
+                                          eWriterStatisticsPhaseCompression);
+    return mPixelsImageHandler.CreateImageXObjectFromPixels(inPixels, inImageXObjectID);
+}
+
 #ifndef LIBCHARTA_NO_PNG
 PDFFormXObject *charta::DocumentContext::CreateFormXObjectFromPNGStream(charta::IByteReaderWithPosition *inPNGStream,
                                                                         ObjectIDType inFormXObjectId)
 {
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryImages,
+                                          eWriterStatisticsPhaseImageDecoding);
     return mPNGImageHandler.CreateFormXObjectFromPNGStream(inPNGStream, inFormXObjectId);
 }
 #endif
@@ -1297,7 +1397,8 @@ charta::TIFFImageHandler &charta::DocumentContext::GetTIFFImageHandler()
 PDFFormXObject *charta::DocumentContext::CreateFormXObjectFromTIFFFile(const std::string &inTIFFFilePath,
                                                                        const TIFFUsageParameters &inTIFFUsageParameters)
 {
-
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryImages,
+                                          eWriterStatisticsPhaseImageDecoding);
     return mTIFFImageHandler.CreateFormXObjectFromTIFFFile(inTIFFFilePath, inTIFFUsageParameters);
 }
 
@@ -1305,12 +1406,16 @@ PDFFormXObject *charta::DocumentContext::CreateFormXObjectFromTIFFFile(const std
                                                                        ObjectIDType inFormXObjectID,
                                                                        const TIFFUsageParameters &inTIFFUsageParameters)
 {
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryImages,
+                                          eWriterStatisticsPhaseImageDecoding);
     return mTIFFImageHandler.CreateFormXObjectFromTIFFFile(inTIFFFilePath, inFormXObjectID, inTIFFUsageParameters);
 }
 
 PDFFormXObject *charta::DocumentContext::CreateFormXObjectFromTIFFStream(
     charta::IByteReaderWithPosition *inTIFFStream, const TIFFUsageParameters &inTIFFUsageParameters)
 {
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryImages,
+                                          eWriterStatisticsPhaseImageDecoding);
     return mTIFFImageHandler.CreateFormXObjectFromTIFFStream(inTIFFStream, inTIFFUsageParameters);
 }
 
@@ -1318,23 +1423,52 @@ PDFFormXObject *charta::DocumentContext::CreateFormXObjectFromTIFFStream(
     charta::IByteReaderWithPosition *inTIFFStream, ObjectIDType inFormXObjectID,
     const TIFFUsageParameters &inTIFFUsageParameters)
 {
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryImages,
+                                          eWriterStatisticsPhaseImageDecoding);
     return mTIFFImageHandler.CreateFormXObjectFromTIFFStream(inTIFFStream, inFormXObjectID, inTIFFUsageParameters);
 }
 
+charta::PDFFormXObjectVector charta::DocumentContext::CreateFormXObjectsFromTIFFFile(
+    const std::string &inTIFFFilePath, const std::vector<unsigned long> &inPageIndexes,
+    const TIFFUsageParameters &inTIFFUsageParameters)
+{
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryImages,
+                                          eWriterStatisticsPhaseImageDecoding);
+    return mTIFFImageHandler.CreateFormXObjectsFromTIFFFile(inTIFFFilePath, inPageIndexes, inTIFFUsageParameters);
+}
+
+charta::PDFFormXObjectVector charta::DocumentContext::CreateFormXObjectsFromTIFFStream(
+    charta::IByteReaderWithPosition *inTIFFStream, const std::vector<unsigned long> &inPageIndexes,
+    const TIFFUsageParameters &inTIFFUsageParameters)
+{
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryImages,
+                                          eWriterStatisticsPhaseImageDecoding);
+    return mTIFFImageHandler.CreateFormXObjectsFromTIFFStream(inTIFFStream, inPageIndexes, inTIFFUsageParameters);
+}
+
 #endif
 
 PDFImageXObject *charta::DocumentContext::CreateImageXObjectFromJPGFile(const std::string &inJPGFilePath,
                                                                         ObjectIDType inImageXObjectID)
 {
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryImages,
+                                          eWriterStatisticsPhaseImageDecoding);
     return mJPEGImageHandler.CreateImageXObjectFromJPGFile(inJPGFilePath, inImageXObjectID);
 }
 
 PDFFormXObject *charta::DocumentContext::CreateFormXObjectFromJPGFile(const std::string &inJPGFilePath,
                                                                       ObjectIDType inFormXObjectID)
 {
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryImages,
+                                          eWriterStatisticsPhaseImageDecoding);
     return mJPEGImageHandler.CreateFormXObjectFromJPGFile(inJPGFilePath, inFormXObjectID);
 }
 
+WriterStatistics *charta::DocumentContext::GetStatistics()
+{
+    return mObjectsContext->GetStatistics();
+}
+
 PDFUsedFont *charta::DocumentContext::GetFontForFile(const std::string &inFontFilePath, long inFontIndex)
 {
     return mUsedFontsRepository.GetFontForFile(inFontFilePath, inFontIndex);
@@ -1342,6 +1476,8 @@ PDFUsedFont *charta::DocumentContext::GetFontForFile(const std::string &inFontFi
 
 charta::EStatusCode charta::DocumentContext::WriteUsedFontsDefinitions()
 {
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryFonts,
+                                          eWriterStatisticsPhaseFontSubsetting);
     return mUsedFontsRepository.WriteUsedFontsDefinitions();
 }
 
@@ -1411,6 +1547,15 @@ charta::EStatusCode charta::DocumentContext::WriteState(ObjectsContext *inStateW
         documentDictionary->WriteKey("mModifiedDocumentIDExists");
         documentDictionary->WriteBooleanValue(mModifiedDocumentIDExists);
 
+        documentDictionary->WriteKey("mElideRedundantOperators");
+        documentDictionary->WriteBooleanValue(mElideRedundantOperators);
+
+        documentDictionary->WriteKey("mImageTargetResolution");
+        documentDictionary->WriteDoubleValue(mImageTargetResolution);
+
+        documentDictionary->WriteKey("mImageJPEGQuality");
+        documentDictionary->WriteIntegerValue(mImageJPEGQuality);
+
         if (mModifiedDocumentIDExists)
         {
             documentDictionary->WriteKey("mModifiedDocumentID");
@@ -1656,7 +1801,7 @@ void charta::DocumentContext::WritePageTreeState(ObjectsContext *inStateWriter,
     }
 }
 
-charta::EStatusCode charta::DocumentContext::ReadState(PDFParser *inStateReader, ObjectIDType inObjectID)
+charta::EStatusCode charta::DocumentContext::ReadState(StateReader *inStateReader, ObjectIDType inObjectID)
 {
     PDFObjectCastPtr<charta::PDFDictionary> documentState(inStateReader->ParseNewObject(inObjectID));
 
@@ -1670,6 +1815,16 @@ charta::EStatusCode charta::DocumentContext::ReadState(PDFParser *inStateReader,
         mModifiedDocumentID = modifiedDocumentExists->GetValue();
     }
 
+    PDFObjectCastPtr<charta::PDFBoolean> elideRedundantOperators(
+        documentState->QueryDirectObject("mElideRedundantOperators"));
+    mElideRedundantOperators = !!elideRedundantOperators && elideRedundantOperators->GetValue();
+
+    std::shared_ptr<PDFObject> imageTargetResolution(documentState->QueryDirectObject("mImageTargetResolution"));
+    mImageTargetResolution = !!imageTargetResolution ? ParsedPrimitiveHelper(imageTargetResolution).GetAsDouble() : 0;
+
+    PDFObjectCastPtr<PDFInteger> imageJPEGQuality(documentState->QueryDirectObject("mImageJPEGQuality"));
+    mImageJPEGQuality = !!imageJPEGQuality ? (int)imageJPEGQuality->GetValue() : 85;
+
     PDFObjectCastPtr<PDFHexString> newPDFID(documentState->QueryDirectObject("mNewPDFID"));
 
     if (!!newPDFID)
@@ -1694,7 +1849,7 @@ charta::EStatusCode charta::DocumentContext::ReadState(PDFParser *inStateReader,
     return mEncryptionHelper.ReadState(inStateReader, encrytpionStateID->mObjectID);
 }
 
-void charta::DocumentContext::ReadTrailerState(PDFParser *inStateReader,
+void charta::DocumentContext::ReadTrailerState(StateReader *inStateReader,
                                                const std::shared_ptr<charta::PDFDictionary> &inTrailerState)
 {
     PDFObjectCastPtr<PDFInteger> prevState(inTrailerState->QueryDirectObject("mPrev"));
@@ -1725,7 +1880,7 @@ ObjectReference charta::DocumentContext::GetReferenceFromState(
     return ObjectReference((ObjectIDType)(objectID->GetValue()), (unsigned long)generationNumber->GetValue());
 }
 
-void charta::DocumentContext::ReadTrailerInfoState(PDFParser * /*inStateReader*/,
+void charta::DocumentContext::ReadTrailerInfoState(StateReader * /*inStateReader*/,
                                                    const std::shared_ptr<charta::PDFDictionary> &inTrailerInfoState)
 {
     PDFObjectCastPtr<charta::PDFLiteralString> titleState(inTrailerInfoState->QueryDirectObject("Title"));
@@ -1804,7 +1959,7 @@ void charta::DocumentContext::ReadDateState(const std::shared_ptr<charta::PDFDic
 }
 
 void charta::DocumentContext::ReadCatalogInformationState(
-    PDFParser *inStateReader, const std::shared_ptr<charta::PDFDictionary> &inCatalogInformationState)
+    StateReader *inStateReader, const std::shared_ptr<charta::PDFDictionary> &inCatalogInformationState)
 {
     PDFObjectCastPtr<charta::PDFIndirectObjectReference> pageTreeRootState(
         inCatalogInformationState->QueryDirectObject("PageTreeRoot"));
@@ -1833,7 +1988,7 @@ void charta::DocumentContext::ReadCatalogInformationState(
     ReadPageTreeState(inStateReader, pageTreeState, rootNode);
 }
 
-void charta::DocumentContext::ReadPageTreeState(PDFParser *inStateReader,
+void charta::DocumentContext::ReadPageTreeState(StateReader *inStateReader,
                                                 const std::shared_ptr<charta::PDFDictionary> &inPageTreeState,
                                                 PageTree *inPageTree)
 {
@@ -2002,23 +2157,31 @@ charta::EStatusCode charta::DocumentContext::MergePDFPagesToPage(PDFPage &inPage
 
 PDFImageXObject *charta::DocumentContext::CreateImageXObjectFromJPGStream(charta::IByteReaderWithPosition *inJPGStream)
 {
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryImages,
+                                          eWriterStatisticsPhaseImageDecoding);
     return mJPEGImageHandler.CreateImageXObjectFromJPGStream(inJPGStream);
 }
 
 PDFImageXObject *charta::DocumentContext::CreateImageXObjectFromJPGStream(charta::IByteReaderWithPosition *inJPGStream,
                                                                           ObjectIDType inImageXObjectID)
 {
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryImages,
+                                          eWriterStatisticsPhaseImageDecoding);
     return mJPEGImageHandler.CreateImageXObjectFromJPGStream(inJPGStream, inImageXObjectID);
 }
 
 PDFFormXObject *charta::DocumentContext::CreateFormXObjectFromJPGStream(charta::IByteReaderWithPosition *inJPGStream)
 {
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryImages,
+                                          eWriterStatisticsPhaseImageDecoding);
     return mJPEGImageHandler.CreateFormXObjectFromJPGStream(inJPGStream);
 }
 
 PDFFormXObject *charta::DocumentContext::CreateFormXObjectFromJPGStream(charta::IByteReaderWithPosition *inJPGStream,
                                                                         ObjectIDType inFormXObjectID)
 {
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryImages,
+                                          eWriterStatisticsPhaseImageDecoding);
     return mJPEGImageHandler.CreateFormXObjectFromJPGStream(inJPGStream, inFormXObjectID);
 }
 
@@ -2086,6 +2249,13 @@ void charta::DocumentContext::Cleanup()
     mOutputFilePath.clear();
     mExtenders.clear();
     mAnnotations.clear();
+    mDownsampledImages.clear();
+    mDownsampledImagesToWrite.clear();
+    // workers may still be on images of a document that did not finish
+    mImagePreparationPool.Stop();
+    for (auto &preparedImage : mPreparedImages)
+        delete preparedImage.second;
+    mPreparedImages.clear();
     for (auto &copyingContext : mCopyingContexts)
         copyingContext->ReleaseDocumentContextReference();
     mCopyingContexts.clear();
@@ -2307,9 +2477,13 @@ charta::EStatusCode charta::DocumentContext::FinalizeModifiedPDF(PDFParser *inMo
         // write encryption dictionary, if encrypting
         CopyEncryptionDictionary(inModifiedFileParser);
 
+        long long xrefSectionStart;
         if (RequiresXrefStream(inModifiedFileParser))
         {
+            // the xref stream is an object, and is accounted as such
+            WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryXref);
             status = WriteXrefStream(xrefTablePosition);
+            xrefSectionStart = mObjectsContext->GetCurrentPosition();
         }
         else
         {
@@ -2320,10 +2494,12 @@ charta::EStatusCode charta::DocumentContext::FinalizeModifiedPDF(PDFParser *inMo
             status = WriteTrailerDictionary();
             if (status != eSuccess)
                 break;
+            xrefSectionStart = xrefTablePosition;
         }
 
         WriteXrefReference(xrefTablePosition);
         WriteFinalEOF();
+        UpdateXrefStatistics(xrefSectionStart);
     } while (false);
 
     return status;
@@ -2601,6 +2777,18 @@ std::shared_ptr<charta::PDFDocumentCopyingContext> charta::DocumentContext::Crea
     return context;
 }
 
+std::shared_ptr<charta::PDFDocumentCopyingContext> charta::DocumentContext::CreatePDFCopyingContext(
+    PDFParserReader *inParserReader)
+{
+    auto context = std::make_shared<PDFDocumentCopyingContext>();
+
+    if (context->Start(inParserReader, this, mObjectsContext) != charta::eSuccess)
+    {
+        return nullptr;
+    }
+    return context;
+}
+
 std::string charta::DocumentContext::AddExtendedResourceMapping(PDFPage &inPage,
                                                                 const std::string &inResourceCategoryName,
                                                                 IResourceWritingTask *inWritingTask)
@@ -3032,6 +3220,27 @@ charta::EStatusCode charta::DocumentContext::WriteFormForImage(const std::string
                                                                unsigned long inImageIndex, ObjectIDType inObjectID,
                                                                const PDFParsingOptions &inParsingOptions)
 {
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryImages,
+                                          eWriterStatisticsPhaseImageDecoding);
+
+    auto itPrepared = mPreparedImages.find(inObjectID);
+    if (itPrepared != mPreparedImages.end())
+    {
+        PreparedImage *preparedImage = itPrepared->second;
+        mPreparedImages.erase(itPrepared);
+        EStatusCode status = WriteFormForPreparedImage(inImagePath, inImageIndex, inObjectID, preparedImage);
+        delete preparedImage;
+        return status;
+    }
+
+    auto itDownsampled = mDownsampledImagesToWrite.find(inObjectID);
+    if (itDownsampled != mDownsampledImagesToWrite.end())
+    {
+        UIntAndUIntPair pixelsSize = itDownsampled->second;
+        mDownsampledImagesToWrite.erase(itDownsampled);
+        return WriteFormForDownsampledImage(inImagePath, inImageIndex, inObjectID, pixelsSize);
+    }
+
     charta::EStatusCode status = eFailure;
     EHummusImageType imageType = GetImageType(inImagePath, inImageIndex);
 
@@ -3115,3 +3324,203 @@ ObjectIDTypeAndBool charta::DocumentContext::RegisterImageForDrawing(const std::
 
     return ObjectIDTypeAndBool(imageInformation.writtenObjectID, firstTime);
 }
+
+static uint32_t GetTargetPixelsCount(double inPoints, double inResolution, uint32_t inSourcePixels)
+{
+    double pixels = ceil(inPoints / 72.0 * inResolution);
+    if (pixels >= inSourcePixels)
+        return inSourcePixels;
+    return pixels < 1 ? 1 : (uint32_t)pixels;
+}
+
+ObjectIDTypeAndBool charta::DocumentContext::RegisterImageForDrawing(const std::string &inImageFile,
+                                                                     unsigned long inImageIndex, double inScaleX,
+                                                                     double inScaleY)
+{
+    UIntAndUIntPair targetSize = GetDownsampledImageSize(inImageFile, inImageIndex, inScaleX, inScaleY);
+    ObjectIDTypeAndBool result;
+
+    if (targetSize.first == 0)
+        result = RegisterImageForDrawing(inImageFile, inImageIndex);
+    else
+    {
+        // one image per target size, shared by placements of the same size
+        StringAndULongPairAndPixelsSize key(StringAndULongPair(inImageFile, inImageIndex), targetSize);
+        auto it = mDownsampledImages.find(key);
+        if (it != mDownsampledImages.end())
+            return ObjectIDTypeAndBool(it->second, false);
+
+        result.first = mObjectsContext->GetInDirectObjectsRegistry().AllocateNewObjectID();
+        result.second = true;
+        mDownsampledImages.insert(StringAndULongPairAndPixelsSizeToObjectIDTypeMap::value_type(key, result.first));
+        mDownsampledImagesToWrite.insert(ObjectIDTypeToUIntAndUIntPairMap::value_type(result.first, targetSize));
+    }
+
+    // first usage. get the image going while the content is still being written
+    if (result.second)
+        StartImagePreparation(inImageFile, inImageIndex, result.first, targetSize);
+    return result;
+}
+
+UIntAndUIntPair charta::DocumentContext::GetDownsampledImageSize(const std::string &inImageFile,
+                                                                 unsigned long inImageIndex, double inScaleX,
+                                                                 double inScaleY)
+{
+    UIntAndUIntPair noDownsampling(0, 0);
+
+    if (mImageTargetResolution <= 0)
+        return noDownsampling;
+
+    // only images that can be decoded to pixels here are downsampled
+    if (!PreparedImage::CanPrepare(GetImageType(inImageFile, inImageIndex), true))
+        return noDownsampling;
+
+    UIntAndUIntPair sourceSize = GetImagePixelsSize(inImageFile, inImageIndex);
+    if (sourceSize.first == 0 || sourceSize.second == 0)
+        return noDownsampling;
+
+    // pixels required for the target resolution at the size the image is drawn
+    std::pair<double, double> dimensions = GetImageDimensions(inImageFile, inImageIndex);
+    UIntAndUIntPair targetSize(
+        GetTargetPixelsCount(dimensions.first * fabs(inScaleX), mImageTargetResolution, sourceSize.first),
+        GetTargetPixelsCount(dimensions.second * fabs(inScaleY), mImageTargetResolution, sourceSize.second));
+    return targetSize == sourceSize ? noDownsampling : targetSize;
+}
+
+void charta::DocumentContext::StartImagePreparation(const std::string &inImageFile, unsigned long inImageIndex,
+                                                    ObjectIDType inFormObjectID, const UIntAndUIntPair &inPixelsSize)
+{
+    // prepared images are written by a private objects context, with no encryption, extenders or objects context
+    // extender to take part
+    if (mImagePreparationPool.GetThreadsCount() == 0 || mEncryptionHelper.IsEncrypting() || !mExtenders.empty() ||
+        mObjectsContext->GetObjectsContextExtender() != nullptr)
+        return;
+
+    EHummusImageType imageType = GetImageType(inImageFile, inImageIndex);
+    if (!PreparedImage::CanPrepare(imageType, inPixelsSize.first != 0))
+        return;
+
+    ObjectIDType firstObjectID =
+        mObjectsContext->GetInDirectObjectsRegistry().AllocateObjectIDRange(PreparedImage::ObjectsCount);
+    auto *preparedImage =
+        new PreparedImage(inImageFile, imageType, inPixelsSize.first, inPixelsSize.second, mImageJPEGQuality,
+                          firstObjectID, mObjectsContext->IsCompressingStreams(), mObjectsContext->GetStatistics());
+    mPreparedImages.insert(ObjectIDTypeToPreparedImageMap::value_type(inFormObjectID, preparedImage));
+    mImagePreparationPool.Submit(preparedImage);
+}
+
+UIntAndUIntPair charta::DocumentContext::GetImagePixelsSize(const std::string &inImageFile, unsigned long inImageIndex)
+{
+    charta::HummusImageInformation &imageInformation = GetImageInformationStructFor(inImageFile, inImageIndex);
+
+    if (imageInformation.pixelsWidth == -1 || imageInformation.pixelsHeight == -1)
+    {
+        imageInformation.pixelsWidth = 0;
+        imageInformation.pixelsHeight = 0;
+
+        switch (GetImageType(inImageFile, inImageIndex))
+        {
+        case eJPG: {
+            BoolAndJPEGImageInformation jpgImageInformation =
+                GetJPEGImageHandler().RetrieveImageInformation(inImageFile);
+            if (!jpgImageInformation.first)
+                break;
+
+            imageInformation.pixelsWidth = jpgImageInformation.second.SamplesWidth;
+            imageInformation.pixelsHeight = jpgImageInformation.second.SamplesHeight;
+            break;
+        }
+#ifndef LIBCHARTA_NO_PNG
+        case ePNG: {
+            PNGImageHandler hummusPngHandler;
+
+            InputFile file;
+            if (file.OpenFile(inImageFile) != eSuccess)
+                break;
+
+            std::pair<double, double> dimensions = hummusPngHandler.ReadImageDimensions(file.GetInputStream());
+
+            imageInformation.pixelsWidth = (long long)dimensions.first;
+            imageInformation.pixelsHeight = (long long)dimensions.second;
+            break;
+        }
+#endif
+        default: {
+            // only jpg and png are downsampled, other types keep 0
+        }
+        }
+    }
+
+    return UIntAndUIntPair((uint32_t)imageInformation.pixelsWidth, (uint32_t)imageInformation.pixelsHeight);
+}
+
+charta::EStatusCode charta::DocumentContext::WriteFormForDownsampledImage(const std::string &inImagePath,
+                                                                          unsigned long inImageIndex,
+                                                                          ObjectIDType inObjectID,
+                                                                          const UIntAndUIntPair &inPixelsSize)
+{
+    PDFImageXObject *imageXObject =
+        PreparedImage::PrepareImageXObject(mObjectsContext, inImagePath, GetImageType(inImagePath, inImageIndex),
+                                           inPixelsSize.first, inPixelsSize.second, mImageJPEGQuality);
+
+    // can't downsample, embed as is
+    if (imageXObject == nullptr)
+        return WriteFormForImage(inImagePath, inImageIndex, inObjectID);
+
+    EStatusCode status = WriteFormForImageXObject(inImagePath, inImageIndex, inObjectID, imageXObject);
+    delete imageXObject;
+    return status;
+}
+
+charta::EStatusCode charta::DocumentContext::WriteFormForPreparedImage(const std::string &inImagePath,
+                                                                       unsigned long inImageIndex,
+                                                                       ObjectIDType inObjectID,
+                                                                       PreparedImage *inPreparedImage)
+{
+    if (mImagePreparationPool.Wait(inPreparedImage) != eSuccess)
+    {
+        // with nothing prepared, this only frees the reserved objects. the form is then written here on the writer
+        // thread, the way it is when not prepared - downsampled if it can be, or embedding the image as is
+        inPreparedImage->WriteTo(mObjectsContext);
+        TRACE_LOG1("charta::DocumentContext::WriteFormForPreparedImage, unable to prepare %s, writing it without "
+                   "preparation",
+                   inImagePath.c_str());
+        return WriteFormForImage(inImagePath, inImageIndex, inObjectID);
+    }
+
+    // copies the finished bytes
+    EStatusCode status = inPreparedImage->WriteTo(mObjectsContext);
+    mDownsampledImagesToWrite.erase(inObjectID);
+    if (status != eSuccess)
+    {
+        TRACE_LOG1("charta::DocumentContext::WriteFormForPreparedImage, unable to write image for %s",
+                   inImagePath.c_str());
+        return status;
+    }
+    return WriteFormForImageXObject(inImagePath, inImageIndex, inObjectID, inPreparedImage->GetImageXObject());
+}
+
+charta::EStatusCode charta::DocumentContext::WriteFormForImageXObject(const std::string &inImagePath,
+                                                                      unsigned long inImageIndex,
+                                                                      ObjectIDType inObjectID,
+                                                                      PDFImageXObject *inImageXObject)
+{
+    // the form keeps the size of the original image, so it is drawn the same way
+    std::pair<double, double> dimensions = GetImageDimensions(inImagePath, inImageIndex);
+    PDFFormXObject *formXObject =
+        StartFormXObject(PDFRectangle(0, 0, dimensions.first, dimensions.second), inObjectID);
+    XObjectContentContext *xobjectContentContext = formXObject->GetContentContext();
+
+    xobjectContentContext->q();
+    xobjectContentContext->cm(dimensions.first, 0, 0, dimensions.second, 0, 0);
+    xobjectContentContext->Do(formXObject->GetResourcesDictionary().AddImageXObjectMapping(inImageXObject));
+    xobjectContentContext->Q();
+
+    EStatusCode status = EndFormXObjectNoRelease(formXObject);
+    if (status != eSuccess)
+        TRACE_LOG1("charta::DocumentContext::WriteFormForImageXObject, unable to write form for %s",
+                   inImagePath.c_str());
+
+    delete formXObject;
+    return status;
+}
@@ -24,11 +24,45 @@
 #define NULL 0
 #endif
 
+GraphicStateColor::GraphicStateColor()
+{
+    mComponentsCount = 0;
+    for (double &component : mComponents)
+        component = 0;
+}
+
+bool GraphicStateColor::Matches(const std::string &inColorSpace, const double *inComponents,
+                                int inComponentsCount) const
+{
+    if (mComponentsCount == 0 || mComponentsCount != inComponentsCount || mColorSpace != inColorSpace)
+        return false;
+    for (int i = 0; i < inComponentsCount; ++i)
+        if (mComponents[i] != inComponents[i])
+            return false;
+    return true;
+}
+
+void GraphicStateColor::Set(const std::string &inColorSpace, const double *inComponents, int inComponentsCount)
+{
+    mColorSpace = inColorSpace;
+    if (inComponents == nullptr || inComponentsCount > 4)
+    {
+        mComponentsCount = 0;
+        return;
+    }
+    mComponentsCount = inComponentsCount;
+    for (int i = 0; i < inComponentsCount; ++i)
+        mComponents[i] = inComponents[i];
+}
+
 GraphicState::GraphicState()
 {
     mFont = nullptr;
     mFontSize = 0;
     mPlacedFontSize = 0;
+    mCTMKnown = true;
+    mCTM[0] = mCTM[3] = 1;
+    mCTM[1] = mCTM[2] = mCTM[4] = mCTM[5] = 0;
 }
 
 GraphicState::GraphicState(const GraphicState &inGraphicState)
@@ -38,4 +72,25 @@ GraphicState::GraphicState(const GraphicState &inGraphicState)
 
 GraphicState::~GraphicState() = default;
 
-GraphicState &GraphicState::operator=(const GraphicState &inGraphicState) = default;
\ No newline at end of file
+GraphicState &GraphicState::operator=(const GraphicState &inGraphicState) = default;
+
+void GraphicState::Invalidate()
+{
+    // the font to use is the library's choice, only what was placed is in doubt
+    mPlacedFontName.clear();
+    mPlacedFontSize = 0;
+    mFillColor = GraphicStateColor();
+    mStrokeColor = GraphicStateColor();
+    mLineWidth.reset();
+    mLineCap.reset();
+    mLineJoin.reset();
+    mMiterLimit.reset();
+    mDashPattern.reset();
+    mCharacterSpacing.reset();
+    mWordSpacing.reset();
+    mHorizontalScaling.reset();
+    mLeading.reset();
+    mRenderingMode.reset();
+    mRise.reset();
+    mCTMKnown = false;
+}
\ No newline at end of file
@@ -21,6 +21,7 @@
 #include "IndirectObjectsReferenceRegistry.h"
 #include "DictionaryContext.h"
 #include "ObjectsContext.h"
+#include "StateReader.h"
 #include "Trace.h"
 #include "objects/PDFArray.h"
 #include "objects/PDFBoolean.h"
@@ -36,6 +37,9 @@ using namespace charta;
 
 IndirectObjectsReferenceRegistry::IndirectObjectsReferenceRegistry()
 {
+    mFirstObjectID = 0;
+    mNextReservedObjectID = 0;
+    mReservedRangeEnd = 0;
     SetupInitialFreeObject();
 }
 
@@ -54,22 +58,63 @@ void IndirectObjectsReferenceRegistry::SetupInitialFreeObject()
 IndirectObjectsReferenceRegistry::~IndirectObjectsReferenceRegistry() = default;
 
 ObjectIDType IndirectObjectsReferenceRegistry::AllocateNewObjectID()
+{
+    std::lock_guard<std::mutex> lock(mLock);
+
+    if (mNextReservedObjectID < mReservedRangeEnd)
+        return mNextReservedObjectID++;
+
+    if (mReservedRangeEnd != 0)
+        TRACE_LOG1("IndirectObjectsReferenceRegistry::AllocateNewObjectID, reserved range exhausted. Allocating ID = "
+                   "%ld outside of the range",
+                   mFirstObjectID + static_cast<ObjectIDType>(mObjectsWritesRegistry.size()));
+
+    return AppendNewObjects(1);
+}
+
+ObjectIDType IndirectObjectsReferenceRegistry::AllocateObjectIDRange(ObjectIDType inCount)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+
+    return AppendNewObjects(inCount);
+}
+
+ObjectIDType IndirectObjectsReferenceRegistry::AppendNewObjects(ObjectIDType inCount)
 {
     ObjectWriteInformation newObjectInformation;
-    ObjectIDType newObjectID = GetObjectsCount();
+    ObjectIDType newObjectID = mFirstObjectID + static_cast<ObjectIDType>(mObjectsWritesRegistry.size());
 
     newObjectInformation.mObjectWritten = false;
     newObjectInformation.mObjectReferenceType = ObjectWriteInformation::Used;
     newObjectInformation.mGenerationNumber = 0;
     newObjectInformation.mIsDirty = true;
+    newObjectInformation.mWritePosition = 0;
 
-    mObjectsWritesRegistry.push_back(newObjectInformation);
+    mObjectsWritesRegistry.insert(mObjectsWritesRegistry.end(), inCount, newObjectInformation);
     return newObjectID;
 }
 
+void IndirectObjectsReferenceRegistry::SetupReservedRange(ObjectIDType inFirstObjectID, ObjectIDType inCount)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+
+    mObjectsWritesRegistry.clear();
+    mFirstObjectID = inFirstObjectID;
+    AppendNewObjects(inCount);
+    mNextReservedObjectID = inFirstObjectID;
+    mReservedRangeEnd = inFirstObjectID + inCount;
+}
+
+ObjectIDType IndirectObjectsReferenceRegistry::GetFirstObjectID() const
+{
+    return mFirstObjectID;
+}
+
 EStatusCode IndirectObjectsReferenceRegistry::MarkObjectAsWritten(ObjectIDType inObjectID, long long inWritePosition)
 {
-    if (mObjectsWritesRegistry.size() <= inObjectID)
+    std::lock_guard<std::mutex> lock(mLock);
+
+    if (!IsInRegistry(inObjectID))
     {
         TRACE_LOG1("IndirectObjectsReferenceRegistry::MarkObjectAsWritten, Out of range failure. An Object ID is "
                    "marked as written, which was not allocated before. ID = %ld",
@@ -77,11 +122,13 @@ EStatusCode IndirectObjectsReferenceRegistry::MarkObjectAsWritten(ObjectIDType i
         return charta::eFailure;
     }
 
-    if (mObjectsWritesRegistry[inObjectID].mObjectWritten)
+    ObjectWriteInformation &objectInformation = mObjectsWritesRegistry[inObjectID - mFirstObjectID];
+
+    if (objectInformation.mObjectWritten)
     {
         TRACE_LOG3("IndirectObjectsReferenceRegistry::MarkObjectAsWritten, Object rewrite failure. The object %ld was "
                    "already marked as written at %lld. New position is %lld",
-                   inObjectID, mObjectsWritesRegistry[inObjectID].mWritePosition, inWritePosition);
+                   inObjectID, objectInformation.mWritePosition, inWritePosition);
         return charta::eFailure; // trying to mark as written an object that was already marked as such in the past.
                                  // probably a mistake [till we have revisions]
     }
@@ -96,42 +143,55 @@ EStatusCode IndirectObjectsReferenceRegistry::MarkObjectAsWritten(ObjectIDType i
         return charta::eFailure;
     }
 
-    mObjectsWritesRegistry[inObjectID].mIsDirty = true;
-    mObjectsWritesRegistry[inObjectID].mWritePosition = inWritePosition;
-    mObjectsWritesRegistry[inObjectID].mObjectWritten = true;
+    objectInformation.mIsDirty = true;
+    objectInformation.mWritePosition = inWritePosition;
+    objectInformation.mObjectWritten = true;
     return charta::eSuccess;
 }
 
 GetObjectWriteInformationResult IndirectObjectsReferenceRegistry::GetObjectWriteInformation(
     ObjectIDType inObjectID) const
 {
+    std::lock_guard<std::mutex> lock(mLock);
+
     GetObjectWriteInformationResult result;
 
-    if (mObjectsWritesRegistry.size() <= inObjectID)
+    if (!IsInRegistry(inObjectID))
     {
         result.first = false;
     }
     else
     {
         result.first = true;
-        result.second = mObjectsWritesRegistry[inObjectID];
+        result.second = mObjectsWritesRegistry[inObjectID - mFirstObjectID];
     }
     return result;
 }
 
-const ObjectWriteInformation &IndirectObjectsReferenceRegistry::GetNthObjectReference(ObjectIDType inObjectID) const
+ObjectWriteInformation IndirectObjectsReferenceRegistry::GetNthObjectReference(ObjectIDType inObjectID) const
 {
-    return mObjectsWritesRegistry[inObjectID];
+    std::lock_guard<std::mutex> lock(mLock);
+
+    return mObjectsWritesRegistry[inObjectID - mFirstObjectID];
 }
 
 ObjectIDType IndirectObjectsReferenceRegistry::GetObjectsCount() const
 {
-    return static_cast<ObjectIDType>(mObjectsWritesRegistry.size());
+    std::lock_guard<std::mutex> lock(mLock);
+
+    return mFirstObjectID + static_cast<ObjectIDType>(mObjectsWritesRegistry.size());
+}
+
+bool IndirectObjectsReferenceRegistry::IsInRegistry(ObjectIDType inObjectID) const
+{
+    return inObjectID >= mFirstObjectID && inObjectID - mFirstObjectID < mObjectsWritesRegistry.size();
 }
 
 charta::EStatusCode IndirectObjectsReferenceRegistry::DeleteObject(ObjectIDType inObjectID)
 {
-    if (mObjectsWritesRegistry.size() <= inObjectID)
+    std::lock_guard<std::mutex> lock(mLock);
+
+    if (!IsInRegistry(inObjectID))
     {
         TRACE_LOG1("IndirectObjectsReferenceRegistry::DeleteObject, Out of range failure. An Object ID is marked for "
                    "delete,but there's no such object. ID = %ld",
@@ -139,7 +199,9 @@ charta::EStatusCode IndirectObjectsReferenceRegistry::DeleteObject(ObjectIDType
         return charta::eFailure;
     }
 
-    if (mObjectsWritesRegistry[inObjectID].mGenerationNumber == 65535)
+    ObjectWriteInformation &objectInformation = mObjectsWritesRegistry[inObjectID - mFirstObjectID];
+
+    if (objectInformation.mGenerationNumber == 65535)
     {
         TRACE_LOG1("IndirectObjectsReferenceRegistry::DeleteObject, object ID generation number reached maximum value "
                    "and cannot be increased. ID = %ld",
@@ -147,10 +209,10 @@ charta::EStatusCode IndirectObjectsReferenceRegistry::DeleteObject(ObjectIDType
         return charta::eFailure;
     }
 
-    mObjectsWritesRegistry[inObjectID].mIsDirty = true;
-    ++(mObjectsWritesRegistry[inObjectID].mGenerationNumber);
-    mObjectsWritesRegistry[inObjectID].mWritePosition = 0;
-    mObjectsWritesRegistry[inObjectID].mObjectReferenceType = ObjectWriteInformation::Free;
+    objectInformation.mIsDirty = true;
+    ++(objectInformation.mGenerationNumber);
+    objectInformation.mWritePosition = 0;
+    objectInformation.mObjectReferenceType = ObjectWriteInformation::Free;
 
     return charta::eSuccess;
 }
@@ -158,7 +220,9 @@ charta::EStatusCode IndirectObjectsReferenceRegistry::DeleteObject(ObjectIDType
 charta::EStatusCode IndirectObjectsReferenceRegistry::MarkObjectAsUpdated(ObjectIDType inObjectID,
                                                                           long long inNewWritePosition)
 {
-    if (mObjectsWritesRegistry.size() <= inObjectID)
+    std::lock_guard<std::mutex> lock(mLock);
+
+    if (!IsInRegistry(inObjectID))
     {
         TRACE_LOG1("IndirectObjectsReferenceRegistry::MarkObjectAsUpdated, Out of range failure. An Object ID is "
                    "marked for update,but there's no such object. ID = %ld",
@@ -166,6 +230,8 @@ charta::EStatusCode IndirectObjectsReferenceRegistry::MarkObjectAsUpdated(Object
         return charta::eFailure;
     }
 
+    ObjectWriteInformation &objectInformation = mObjectsWritesRegistry[inObjectID - mFirstObjectID];
+
     if (inNewWritePosition >
         9999999999LL) // if write position is larger than what can be represented by 10 digits, xref write will fail
     {
@@ -176,9 +242,9 @@ charta::EStatusCode IndirectObjectsReferenceRegistry::MarkObjectAsUpdated(Object
         return charta::eFailure;
     }
 
-    mObjectsWritesRegistry[inObjectID].mIsDirty = true;
-    mObjectsWritesRegistry[inObjectID].mWritePosition = inNewWritePosition;
-    mObjectsWritesRegistry[inObjectID].mObjectReferenceType = ObjectWriteInformation::Used;
+    objectInformation.mIsDirty = true;
+    objectInformation.mWritePosition = inNewWritePosition;
+    objectInformation.mObjectReferenceType = ObjectWriteInformation::Used;
 
     return charta::eSuccess;
 }
@@ -250,7 +316,7 @@ EStatusCode IndirectObjectsReferenceRegistry::WriteState(ObjectsContext *inState
     return charta::eSuccess;
 }
 
-EStatusCode IndirectObjectsReferenceRegistry::ReadState(PDFParser *inStateReader, ObjectIDType inObjectID)
+EStatusCode IndirectObjectsReferenceRegistry::ReadState(StateReader *inStateReader, ObjectIDType inObjectID)
 {
     PDFObjectCastPtr<charta::PDFDictionary> indirectObjectsDictionary(inStateReader->ParseNewObject(inObjectID));
 
@@ -300,6 +366,9 @@ EStatusCode IndirectObjectsReferenceRegistry::ReadState(PDFParser *inStateReader
 void IndirectObjectsReferenceRegistry::Reset()
 {
     mObjectsWritesRegistry.clear();
+    mFirstObjectID = 0;
+    mNextReservedObjectID = 0;
+    mReservedRangeEnd = 0;
 
     SetupInitialFreeObject();
 }
@@ -327,9 +396,9 @@ void IndirectObjectsReferenceRegistry::SetupXrefFromModifiedFile(PDFParser *inMo
     // element]
     for (ObjectIDType i = 1; i < inModifiedFileParser->GetXrefSize(); ++i)
     {
-        XrefEntryInput *anEntry = inModifiedFileParser->GetXrefEntry(i);
-        AppendExistingItem(anEntry->mType != eXrefEntryDelete ? ObjectWriteInformation::Used
-                                                              : ObjectWriteInformation::Free,
-                           anEntry->mType != eXrefEntryStreamObject ? anEntry->mRivision : 0, anEntry->mObjectPosition);
+        XrefEntryInput anEntry = inModifiedFileParser->GetXrefEntry(i);
+        AppendExistingItem(anEntry.mType != eXrefEntryDelete ? ObjectWriteInformation::Used
+                                                             : ObjectWriteInformation::Free,
+                           anEntry.mType != eXrefEntryStreamObject ? anEntry.mRivision : 0, anEntry.mObjectPosition);
     }
 }
@@ -20,11 +20,14 @@
 */
 #include "ObjectsContext.h"
 #include "DictionaryContext.h"
+#include "MyStringBuf.h"
 #include "PDFStream.h"
 #include "SafeBufferMacrosDefs.h"
+#include "StateReader.h"
 #include "Trace.h"
 #include "encryption/EncryptionHelper.h"
 #include "io/IByteWriterWithPosition.h"
+#include "io/InputStringBufferStream.h"
 #include "io/OutputStreamTraits.h"
 #include "objects/PDFBoolean.h"
 #include "objects/PDFDictionary.h"
@@ -42,8 +45,13 @@ ObjectsContext::ObjectsContext()
 {
     mOutputStream = nullptr;
     mCompressStreams = true;
+    mDirectStreamLengths = false;
     mExtender = nullptr;
     mEncryptionHelper = nullptr;
+    mStatistics = nullptr;
+    mStatisticsCategory = eWriterStatisticsCategoryOther;
+    mObjectStartPosition = 0;
+    mIndirectObjectOpen = false;
 }
 
 ObjectsContext::~ObjectsContext() = default;
@@ -143,6 +151,40 @@ void ObjectsContext::EndFreeContext()
     // currently just a marker, do nothing. allegedly used to return to a "controlled" context
 }
 
+EStatusCode ObjectsContext::CopyBufferedObjects(ObjectsContext &inBufferObjectsContext, MyStringBuf &inBuffer,
+                                                ObjectIDType inFirstObjectID, ObjectIDType inObjectsCount)
+{
+    // objects past the reserved range would go out with IDs that belong to others here
+    IndirectObjectsReferenceRegistry &bufferRegistry = inBufferObjectsContext.GetInDirectObjectsRegistry();
+    if (bufferRegistry.GetObjectsCount() > inFirstObjectID + inObjectsCount)
+    {
+        TRACE_LOG2("ObjectsContext::CopyBufferedObjects, %ld objects were written, but only %ld were reserved",
+                   bufferRegistry.GetObjectsCount() - inFirstObjectID, inObjectsCount);
+        return eFailure;
+    }
+
+    long long basePosition = GetCurrentPosition();
+
+    inBuffer.pubseekoff(0, std::ios_base::beg);
+    InputStringBufferStream bufferInput(&inBuffer);
+    OutputStreamTraits streamCopier(StartFreeContext());
+    EStatusCode status = streamCopier.CopyToOutputStream(&bufferInput);
+    EndFreeContext();
+    if (status != eSuccess)
+        return status;
+
+    // object positions in the buffer are relative to its start
+    for (ObjectIDType i = inFirstObjectID; i < inFirstObjectID + inObjectsCount && eSuccess == status; ++i)
+    {
+        GetObjectWriteInformationResult objectInformation = bufferRegistry.GetObjectWriteInformation(i);
+        if (objectInformation.first && objectInformation.second.mObjectWritten)
+            status = mReferencesRegistry.MarkObjectAsWritten(i, basePosition + objectInformation.second.mWritePosition);
+        else
+            status = mReferencesRegistry.DeleteObject(i);
+    }
+    return status;
+}
+
 long long ObjectsContext::GetCurrentPosition()
 {
     if (mOutputStream == nullptr) // in case somebody gets smart and ask before the stream is set
@@ -151,6 +193,13 @@ long long ObjectsContext::GetCurrentPosition()
     return mOutputStream->GetCurrentPosition();
 }
 
+long long ObjectsContext::GetCompletedPosition()
+{
+    if (mIndirectObjectOpen)
+        return mObjectStartPosition;
+    return GetCurrentPosition();
+}
+
 static const uint8_t scXref[] = {'x', 'r', 'e', 'f'};
 
 EStatusCode ObjectsContext::WriteXrefTable(long long &outWritePosition)
@@ -185,7 +234,7 @@ EStatusCode ObjectsContext::WriteXrefTable(long long &outWritePosition)
 
         for (ObjectIDType i = startID; i < firstIDNotInRange && (charta::eSuccess == status); ++i)
         {
-            const ObjectWriteInformation &objectReference = mReferencesRegistry.GetNthObjectReference(i);
+            ObjectWriteInformation objectReference = mReferencesRegistry.GetNthObjectReference(i);
             if (objectReference.mObjectReferenceType == ObjectWriteInformation::Used)
             {
                 // used object
@@ -314,7 +363,9 @@ static const std::string scObj = "obj";
 ObjectIDType ObjectsContext::StartNewIndirectObject()
 {
     ObjectIDType newObjectID = mReferencesRegistry.AllocateNewObjectID();
-    mReferencesRegistry.MarkObjectAsWritten(newObjectID, mOutputStream->GetCurrentPosition());
+    mObjectStartPosition = mOutputStream->GetCurrentPosition();
+    mIndirectObjectOpen = true;
+    mReferencesRegistry.MarkObjectAsWritten(newObjectID, mObjectStartPosition);
     mPrimitiveWriter.WriteInteger(newObjectID);
     mPrimitiveWriter.WriteInteger(0);
     mPrimitiveWriter.WriteKeyword(scObj);
@@ -329,7 +380,9 @@ ObjectIDType ObjectsContext::StartNewIndirectObject()
 
 void ObjectsContext::StartNewIndirectObject(ObjectIDType inObjectID)
 {
-    mReferencesRegistry.MarkObjectAsWritten(inObjectID, mOutputStream->GetCurrentPosition());
+    mObjectStartPosition = mOutputStream->GetCurrentPosition();
+    mIndirectObjectOpen = true;
+    mReferencesRegistry.MarkObjectAsWritten(inObjectID, mObjectStartPosition);
     mPrimitiveWriter.WriteInteger(inObjectID);
     mPrimitiveWriter.WriteInteger(0);
     mPrimitiveWriter.WriteKeyword(scObj);
@@ -342,7 +395,9 @@ void ObjectsContext::StartNewIndirectObject(ObjectIDType inObjectID)
 
 void ObjectsContext::StartModifiedIndirectObject(ObjectIDType inObjectID)
 {
-    mReferencesRegistry.MarkObjectAsUpdated(inObjectID, mOutputStream->GetCurrentPosition());
+    mObjectStartPosition = mOutputStream->GetCurrentPosition();
+    mIndirectObjectOpen = true;
+    mReferencesRegistry.MarkObjectAsUpdated(inObjectID, mObjectStartPosition);
     mPrimitiveWriter.WriteInteger(inObjectID);
     mPrimitiveWriter.WriteInteger(0);
     mPrimitiveWriter.WriteKeyword(scObj);
@@ -357,11 +412,15 @@ static const std::string scEndObj = "endobj";
 void ObjectsContext::EndIndirectObject()
 {
     mPrimitiveWriter.WriteKeyword(scEndObj);
+    mIndirectObjectOpen = false;
 
     if (IsEncrypting())
     {
         mEncryptionHelper->OnObjectEnd();
     }
+
+    if (mStatistics != nullptr)
+        mStatistics->AddObject(mStatisticsCategory, mOutputStream->GetCurrentPosition() - mObjectStartPosition);
 }
 
 void ObjectsContext::StartArray()
@@ -374,6 +433,16 @@ void ObjectsContext::EndArray(ETokenSeparator inSeparate)
     mPrimitiveWriter.EndArray(inSeparate);
 }
 
+void ObjectsContext::SetDirectStreamLengths(bool inDirectStreamLengths)
+{
+    mDirectStreamLengths = inDirectStreamLengths;
+}
+
+bool ObjectsContext::IsWritingDirectStreamLengths() const
+{
+    return mDirectStreamLengths;
+}
+
 void ObjectsContext::SetCompressStreams(bool inCompressStreams)
 {
     mCompressStreams = inCompressStreams;
@@ -409,7 +478,7 @@ std::shared_ptr<PDFStream> ObjectsContext::StartPDFStream(DictionaryContext *inS
     }
 
     std::shared_ptr<PDFStream> result = nullptr;
-    if (!inForceDirectExtentObject)
+    if (!inForceDirectExtentObject && !mDirectStreamLengths)
     {
 
         // Length (write as an indirect object)
@@ -428,6 +497,7 @@ std::shared_ptr<PDFStream> ObjectsContext::StartPDFStream(DictionaryContext *inS
     else
         result = std::make_shared<PDFStream>(mCompressStreams, mOutputStream, mEncryptionHelper,
                                              streamDictionaryContext, mExtender);
+    result->SetStatistics(mStatistics);
 
     // break encryption, if any, when writing a stream, cause if encryption is desired, only top level elements should
     // be encrypted. hence - the stream itself is, but its contents do not re-encrypt
@@ -447,18 +517,25 @@ std::shared_ptr<PDFStream> ObjectsContext::StartUnfilteredPDFStream(DictionaryCo
     DictionaryContext *streamDictionaryContext =
         (nullptr == inStreamDictionary ? StartDictionary() : inStreamDictionary);
 
-    // Length (write as an indirect object)
-    streamDictionaryContext->WriteKey(scLength);
-    ObjectIDType lengthObjectID = mReferencesRegistry.AllocateNewObjectID();
-    streamDictionaryContext->WriteNewObjectReferenceValue(lengthObjectID);
+    std::shared_ptr<PDFStream> result = nullptr;
+    if (!mDirectStreamLengths)
+    {
+        // Length (write as an indirect object)
+        streamDictionaryContext->WriteKey(scLength);
+        ObjectIDType lengthObjectID = mReferencesRegistry.AllocateNewObjectID();
+        streamDictionaryContext->WriteNewObjectReferenceValue(lengthObjectID);
 
-    EndDictionary(streamDictionaryContext);
+        EndDictionary(streamDictionaryContext);
 
-    // Write Stream Content
-    WriteKeyword(scStream);
+        // Write Stream Content
+        WriteKeyword(scStream);
 
-    // now begin the stream itself
-    auto result = std::make_shared<PDFStream>(false, mOutputStream, mEncryptionHelper, lengthObjectID, nullptr);
+        // now begin the stream itself
+        result = std::make_shared<PDFStream>(false, mOutputStream, mEncryptionHelper, lengthObjectID, nullptr);
+    }
+    else
+        result = std::make_shared<PDFStream>(false, mOutputStream, mEncryptionHelper, streamDictionaryContext, nullptr);
+    result->SetStatistics(mStatistics);
 
     // break encryption, if any, when writing a stream, cause if encryption is desired, only top level elements should
     // be encrypted. hence - the stream itself is, but its contents do not re-encrypt
@@ -522,6 +599,28 @@ void ObjectsContext::SetObjectsContextExtender(IObjectsContextExtender *inExtend
     mExtender = inExtender;
 }
 
+IObjectsContextExtender *ObjectsContext::GetObjectsContextExtender()
+{
+    return mExtender;
+}
+
+void ObjectsContext::SetStatistics(WriterStatistics *inStatistics)
+{
+    mStatistics = inStatistics;
+}
+
+WriterStatistics *ObjectsContext::GetStatistics()
+{
+    return mStatistics;
+}
+
+EWriterStatisticsCategory ObjectsContext::SetStatisticsCategory(EWriterStatisticsCategory inCategory)
+{
+    EWriterStatisticsCategory previous = mStatisticsCategory;
+    mStatisticsCategory = inCategory;
+    return previous;
+}
+
 std::string ObjectsContext::GenerateSubsetFontPrefix()
 {
     return mSubsetFontsNamesSequance.GetNextValue();
@@ -549,6 +648,9 @@ EStatusCode ObjectsContext::WriteState(ObjectsContext *inStateWriter, ObjectIDTy
         objectsContextDict->WriteKey("mCompressStreams");
         objectsContextDict->WriteBooleanValue(mCompressStreams);
 
+        objectsContextDict->WriteKey("mDirectStreamLengths");
+        objectsContextDict->WriteBooleanValue(mDirectStreamLengths);
+
         objectsContextDict->WriteKey("mSubsetFontsNamesSequance");
         objectsContextDict->WriteNewObjectReferenceValue(subsetFontsNameSequanceID);
 
@@ -579,13 +681,17 @@ EStatusCode ObjectsContext::WriteState(ObjectsContext *inStateWriter, ObjectIDTy
     return status;
 }
 
-EStatusCode ObjectsContext::ReadState(PDFParser *inStateReader, ObjectIDType inObjectID)
+EStatusCode ObjectsContext::ReadState(StateReader *inStateReader, ObjectIDType inObjectID)
 {
     PDFObjectCastPtr<charta::PDFDictionary> objectsContext(inStateReader->ParseNewObject(inObjectID));
 
     PDFObjectCastPtr<charta::PDFBoolean> compressStreams(objectsContext->QueryDirectObject("mCompressStreams"));
     mCompressStreams = compressStreams->GetValue();
 
+    // optional, states from older versions don't have it
+    PDFObjectCastPtr<charta::PDFBoolean> directStreamLengths(objectsContext->QueryDirectObject("mDirectStreamLengths"));
+    mDirectStreamLengths = !!directStreamLengths && directStreamLengths->GetValue();
+
     PDFObjectCastPtr<charta::PDFDictionary> subsetFontsNamesSequance(
         inStateReader->QueryDictionaryObject(objectsContext, "mSubsetFontsNamesSequance"));
     PDFObjectCastPtr<charta::PDFLiteralString> sequanceString(
@@ -602,8 +708,12 @@ void ObjectsContext::Cleanup()
 {
     mOutputStream = nullptr;
     mCompressStreams = true;
+    mDirectStreamLengths = false;
     mExtender = nullptr;
     mEncryptionHelper = nullptr;
+    mStatistics = nullptr;
+    mStatisticsCategory = eWriterStatisticsCategoryOther;
+    mIndirectObjectOpen = false;
 
     mSubsetFontsNamesSequance.Reset();
     mReferencesRegistry.Reset();
@@ -679,7 +789,7 @@ EStatusCode ObjectsContext::WriteXrefStream(DictionaryContext *inDictionaryConte
             if (!mReferencesRegistry.GetNthObjectReference(i).mIsDirty)
                 continue;
 
-            const ObjectWriteInformation &objectReference = mReferencesRegistry.GetNthObjectReference(i);
+            ObjectWriteInformation objectReference = mReferencesRegistry.GetNthObjectReference(i);
 
             if (objectReference.mObjectReferenceType == ObjectWriteInformation::Used)
             {
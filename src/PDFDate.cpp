@@ -187,7 +187,7 @@ void PDFDate::SetToCurrentTime()
 #if defined(__MWERKS__) || defined(__GNUC__) || defined(_AIX32) || defined(WIN32)
     int status;
 #if !defined(__MWERKS__) // (using c methods)
-    struct tm *gmTime;
+    struct tm gmTime;
 
     time_t localEpoch, gmEpoch;
 
@@ -195,10 +195,10 @@ void PDFDate::SetToCurrentTime()
     localEpoch = time(nullptr);
 
     /* Using local time epoch get the GM Time */
-    gmTime = gmtime(&localEpoch);
-    gmTime->tm_isdst = -1;
+    SAFE_GM_TIME(gmTime, localEpoch);
+    gmTime.tm_isdst = -1;
     /* Convert gm time in to epoch format */
-    gmEpoch = mktime(gmTime);
+    gmEpoch = mktime(&gmTime);
 
     timeZoneSecondsDifference = difftime(gmEpoch, localEpoch);
     status = 0;
@@ -145,6 +145,7 @@ std::shared_ptr<charta::PDFObject> PDFModifiedPage::findInheritedResources(
 
 charta::EStatusCode PDFModifiedPage::WritePage()
 {
+    WriterStatisticsScope statisticsScope(&mWriter->GetObjectsContext(), eWriterStatisticsCategoryContent);
     charta::EStatusCode status = EndContentContext(); // just in case someone forgot to close the latest content context
 
     do
@@ -0,0 +1,334 @@
+/*
+   Source File : PDFSplitter.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "PDFSplitter.h"
+#include "PDFTextString.h"
+#include "Trace.h"
+#include "objects/PDFArray.h"
+#include "objects/PDFDictionary.h"
+#include "objects/PDFIndirectObjectReference.h"
+#include "objects/PDFInteger.h"
+#include "objects/PDFObjectCast.h"
+#include "objects/helpers/ParsedPrimitiveHelper.h"
+#include "parsing/PDFDocumentCopyingContext.h"
+#include "parsing/PDFParserReader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <thread>
+
+using namespace charta;
+
+PDFSplitter::PDFSplitter() = default;
+
+PDFSplitter::~PDFSplitter() = default;
+
+EStatusCode PDFSplitter::Open(const std::string &inSourcePath, const PDFParsingOptions &inOptions)
+{
+    mParser.ResetParser();
+
+    if (mSourceFile.OpenFile(inSourcePath) != eSuccess)
+    {
+        TRACE_LOG1("PDFSplitter::Open, unable to open %s", inSourcePath.c_str());
+        return eFailure;
+    }
+
+    if (mParser.StartPDFParsing(mSourceFile.GetInputStream(), inOptions) != eSuccess)
+    {
+        TRACE_LOG1("PDFSplitter::Open, failed to parse %s", inSourcePath.c_str());
+        return eFailure;
+    }
+
+    if (mParser.IsEncrypted() && !mParser.IsEncryptionSupported())
+    {
+        TRACE_LOG("PDFSplitter::Open, cant decrypt document. make sure to provide the right password");
+        return eFailure;
+    }
+
+    return eSuccess;
+}
+
+PDFParser &PDFSplitter::GetSourceParser()
+{
+    return mParser;
+}
+
+unsigned long PDFSplitter::GetPagesCount() const
+{
+    return mParser.GetPagesCount();
+}
+
+PDFSplitPartVector PDFSplitter::CreatePartsForEveryNPages(unsigned long inPagesPerPart)
+{
+    PDFSplitPartVector parts;
+    if (inPagesPerPart == 0)
+        return parts;
+
+    unsigned long pagesCount = mParser.GetPagesCount();
+    for (unsigned long first = 0; first < pagesCount; first += inPagesPerPart)
+    {
+        PDFSplitPart part;
+        part.PageRange.mType = PDFPageRange::eRangeTypeSpecific;
+        part.PageRange.mSpecificRanges.emplace_back(first, std::min(first + inPagesPerPart, pagesCount) - 1);
+        parts.push_back(part);
+    }
+    return parts;
+}
+
+EStatusCode PDFSplitter::CreatePartsForBookmarks(PDFSplitPartVector &outParts)
+{
+    outParts.clear();
+
+    PDFObjectCastPtr<PDFDictionary> catalog(mParser.QueryDictionaryObject(mParser.GetTrailer(), "Root"));
+    if (!catalog)
+    {
+        TRACE_LOG("PDFSplitter::CreatePartsForBookmarks, document has no catalog");
+        return eFailure;
+    }
+
+    // no outline, no parts
+    PDFObjectCastPtr<PDFDictionary> outlines(mParser.QueryDictionaryObject(catalog, "Outlines"));
+    if (!outlines)
+        return eSuccess;
+
+    std::map<ObjectIDType, unsigned long> pageIndexes;
+    for (unsigned long i = 0; i < mParser.GetPagesCount(); ++i)
+        pageIndexes.emplace(mParser.GetPageObjectID(i), i);
+
+    // top level items, as page index and title. the count limit guards against looping sibling chains
+    std::vector<std::pair<unsigned long, std::string>> bookmarks;
+    PDFObjectCastPtr<PDFDictionary> item(mParser.QueryDictionaryObject(outlines, "First"));
+    for (ObjectIDType i = 0; !!item && i < mParser.GetXrefSize(); ++i)
+    {
+        std::shared_ptr<PDFObject> destination = mParser.QueryDictionaryObject(item, "Dest");
+        if (!destination)
+        {
+            PDFObjectCastPtr<PDFDictionary> action(mParser.QueryDictionaryObject(item, "A"));
+            if (!!action && action->Exists("S") &&
+                ParsedPrimitiveHelper(action->QueryDirectObject("S")).ToString() == "GoTo")
+                destination = mParser.QueryDictionaryObject(action, "D");
+        }
+
+        long pageIndex = destination != nullptr ? FindPageIndex(destination, pageIndexes) : -1;
+        if (pageIndex >= 0)
+        {
+            std::shared_ptr<PDFObject> title = mParser.QueryDictionaryObject(item, "Title");
+            std::string titleText;
+            if (title != nullptr)
+                titleText = PDFTextString(ParsedPrimitiveHelper(title).ToString()).ToUTF8String();
+            bookmarks.emplace_back((unsigned long)pageIndex, titleText);
+        }
+
+        item = mParser.QueryDictionaryObject(item, "Next");
+    }
+
+    std::stable_sort(bookmarks.begin(), bookmarks.end(),
+                     [](const std::pair<unsigned long, std::string> &inLeft,
+                        const std::pair<unsigned long, std::string> &inRight) { return inLeft.first < inRight.first; });
+
+    for (size_t i = 0; i < bookmarks.size(); ++i)
+    {
+        unsigned long end = i + 1 < bookmarks.size() ? bookmarks[i + 1].first : mParser.GetPagesCount();
+        // bookmarks to the same page as the next one have no pages of their own
+        if (end == bookmarks[i].first)
+            continue;
+
+        PDFSplitPart part;
+        part.PageRange.mType = PDFPageRange::eRangeTypeSpecific;
+        part.PageRange.mSpecificRanges.emplace_back(bookmarks[i].first, end - 1);
+        part.Title = bookmarks[i].second;
+        outParts.push_back(part);
+    }
+
+    return eSuccess;
+}
+
+long PDFSplitter::FindPageIndex(const std::shared_ptr<PDFObject> &inDestination,
+                                const std::map<ObjectIDType, unsigned long> &inPageIndexes)
+{
+    std::shared_ptr<PDFObject> destination = inDestination;
+
+    // named destinations lead to either the destination array or a dictionary holding it in D
+    if (destination->GetType() == PDFObject::ePDFObjectName ||
+        destination->GetType() == PDFObject::ePDFObjectLiteralString ||
+        destination->GetType() == PDFObject::ePDFObjectHexString)
+        destination = FindNamedDestination(destination);
+    if (destination != nullptr && destination->GetType() == PDFObject::ePDFObjectDictionary)
+        destination = mParser.QueryDictionaryObject(std::static_pointer_cast<PDFDictionary>(destination), "D");
+
+    PDFObjectCastPtr<PDFArray> destinationArray(destination);
+    if (!destinationArray || destinationArray->GetLength() == 0)
+        return -1;
+
+    std::shared_ptr<PDFObject> page = destinationArray->QueryObject(0);
+    if (page->GetType() == PDFObject::ePDFObjectIndirectObjectReference)
+    {
+        auto it = inPageIndexes.find(std::static_pointer_cast<PDFIndirectObjectReference>(page)->mObjectID);
+        return it != inPageIndexes.end() ? (long)it->second : -1;
+    }
+
+    // page numbers are allowed too, if unusual, for local destinations
+    if (page->GetType() == PDFObject::ePDFObjectInteger)
+    {
+        long long pageIndex = std::static_pointer_cast<PDFInteger>(page)->GetValue();
+        return pageIndex >= 0 && pageIndex < (long long)mParser.GetPagesCount() ? (long)pageIndex : -1;
+    }
+
+    return -1;
+}
+
+std::shared_ptr<PDFObject> PDFSplitter::FindNamedDestination(const std::shared_ptr<PDFObject> &inName)
+{
+    std::string name = ParsedPrimitiveHelper(inName).ToString();
+    PDFObjectCastPtr<PDFDictionary> catalog(mParser.QueryDictionaryObject(mParser.GetTrailer(), "Root"));
+    if (!catalog)
+        return nullptr;
+
+    // PDF 1.1 style, a dictionary in the catalog
+    PDFObjectCastPtr<PDFDictionary> dests(mParser.QueryDictionaryObject(catalog, "Dests"));
+    if (!!dests && dests->Exists(name))
+        return mParser.QueryDictionaryObject(dests, name);
+
+    // and the later name tree
+    PDFObjectCastPtr<PDFDictionary> names(mParser.QueryDictionaryObject(catalog, "Names"));
+    if (!names)
+        return nullptr;
+    PDFObjectCastPtr<PDFDictionary> destsTree(mParser.QueryDictionaryObject(names, "Dests"));
+    if (!destsTree)
+        return nullptr;
+    return FindInNameTree(destsTree, name, 0);
+}
+
+std::shared_ptr<PDFObject> PDFSplitter::FindInNameTree(const std::shared_ptr<PDFDictionary> &inNode,
+                                                       const std::string &inName, int inDepth)
+{
+    static const int scMaxNameTreeDepth = 32;
+    if (inDepth > scMaxNameTreeDepth)
+        return nullptr;
+
+    PDFObjectCastPtr<PDFArray> names(mParser.QueryDictionaryObject(inNode, "Names"));
+    if (!!names)
+    {
+        for (unsigned long i = 0; i + 1 < names->GetLength(); i += 2)
+            if (ParsedPrimitiveHelper(names->QueryObject(i)).ToString() == inName)
+                return mParser.QueryArrayObject(names, i + 1);
+        return nullptr;
+    }
+
+    PDFObjectCastPtr<PDFArray> kids(mParser.QueryDictionaryObject(inNode, "Kids"));
+    if (!kids)
+        return nullptr;
+    for (unsigned long i = 0; i < kids->GetLength(); ++i)
+    {
+        PDFObjectCastPtr<PDFDictionary> kid(mParser.QueryArrayObject(kids, i));
+        if (!kid)
+            continue;
+
+        PDFObjectCastPtr<PDFArray> limits(kid->QueryDirectObject("Limits"));
+        if (!!limits && limits->GetLength() == 2 &&
+            (inName < ParsedPrimitiveHelper(limits->QueryObject(0)).ToString() ||
+             ParsedPrimitiveHelper(limits->QueryObject(1)).ToString() < inName))
+            continue;
+
+        std::shared_ptr<PDFObject> result = FindInNameTree(kid, inName, inDepth + 1);
+        if (result != nullptr)
+            return result;
+    }
+    return nullptr;
+}
+
+EStatusCode PDFSplitter::Split(const PDFSplitPartVector &inParts, unsigned int inThreadsCount,
+                               const LogConfiguration &inLogConfiguration,
+                               const PDFCreationSettings &inPDFCreationSettings)
+{
+    if (inParts.empty())
+        return eSuccess;
+
+    if (inThreadsCount == 0)
+        inThreadsCount = std::max(1u, std::thread::hardware_concurrency());
+    if (inThreadsCount > inParts.size())
+        inThreadsCount = (unsigned int)inParts.size();
+
+    EPDFVersion version = EPDFVersion((int)(mParser.GetPDFLevel() * 10));
+
+    // each writer applies the log configuration as it starts. the trace serializes that against other threads
+    // tracing, so writers can start in parallel
+    std::atomic<size_t> nextPart(0);
+    std::atomic<bool> failed(false);
+    auto work = [&]() {
+        PDFParserReader reader(&mParser, mSourceFile.GetPositionalReader());
+        for (size_t i = nextPart++; i < inParts.size(); i = nextPart++)
+        {
+            const PDFSplitPart &part = inParts[i];
+            PDFWriter pdfWriter;
+            EStatusCode status =
+                pdfWriter.StartPDF(part.OutputPath, version, inLogConfiguration, inPDFCreationSettings);
+            if (status != eSuccess)
+            {
+                TRACE_LOG1("PDFSplitter::Split, unable to start %s", part.OutputPath.c_str());
+                failed = true;
+                continue;
+            }
+
+            std::shared_ptr<PDFDocumentCopyingContext> copyingContext = pdfWriter.CreatePDFCopyingContext(&reader);
+            if (copyingContext == nullptr)
+            {
+                // still end the document, so the output is closed and the writer cleaned up
+                TRACE_LOG1("PDFSplitter::Split, unable to copy pages into %s", part.OutputPath.c_str());
+                status = eFailure;
+            }
+            else if (part.PageRange.mType == PDFPageRange::eRangeTypeAll)
+            {
+                for (unsigned long page = 0; page < mParser.GetPagesCount() && status == eSuccess; ++page)
+                    status = copyingContext->AppendPDFPageFromPDF(page).first;
+            }
+            else
+            {
+                for (auto it = part.PageRange.mSpecificRanges.begin();
+                     it != part.PageRange.mSpecificRanges.end() && status == eSuccess; ++it)
+                {
+                    if (it->second >= mParser.GetPagesCount() || it->first > it->second)
+                    {
+                        TRACE_LOG3("PDFSplitter::Split, range %ld-%ld is out of range for %s", it->first, it->second,
+                                   part.OutputPath.c_str());
+                        status = eFailure;
+                        break;
+                    }
+                    for (unsigned long page = it->first; page <= it->second && status == eSuccess; ++page)
+                        status = copyingContext->AppendPDFPageFromPDF(page).first;
+                }
+            }
+            copyingContext = nullptr;
+
+            if (pdfWriter.EndPDF() != eSuccess || status != eSuccess)
+                failed = true;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned int t = 1; t < inThreadsCount; ++t)
+        threads.emplace_back(work);
+    work();
+    for (auto &thread : threads)
+        thread.join();
+
+    return failed ? eFailure : eSuccess;
+}
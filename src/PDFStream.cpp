@@ -20,9 +20,8 @@
 */
 #include "PDFStream.h"
 #include "IObjectsContextExtender.h"
+#include "WriterStatistics.h"
 #include "encryption/EncryptionHelper.h"
-#include "io/InputStringBufferStream.h"
-#include "io/OutputStreamTraits.h"
 
 PDFStream::PDFStream(bool inCompressStream, charta::IByteWriterWithPosition *inOutputStream,
                      EncryptionHelper *inEncryptionHelper, ObjectIDType inExtentObjectID,
@@ -44,6 +43,8 @@ PDFStream::PDFStream(bool inCompressStream, charta::IByteWriterWithPosition *inO
 
     mStreamLength = 0;
     mStreamDictionaryContextForDirectExtentStream = nullptr;
+    mStatistics = nullptr;
+    mReportedBufferedMemory = 0;
 
     if (mCompressStream)
     {
@@ -74,11 +75,12 @@ PDFStream::PDFStream(bool inCompressStream, charta::IByteWriterWithPosition *inO
     mOutputStream = inOutputStream;
     mStreamLength = 0;
     mStreamDictionaryContextForDirectExtentStream = inStreamDictionaryContextForDirectExtentStream;
+    mStatistics = nullptr;
+    mReportedBufferedMemory = 0;
 
-    mTemporaryOutputStream.Assign(&mTemporaryStream);
     if ((inEncryptionHelper != nullptr) && inEncryptionHelper->IsEncrypting())
     {
-        mEncryptionStream = inEncryptionHelper->CreateEncryptionStream(&mTemporaryOutputStream);
+        mEncryptionStream = inEncryptionHelper->CreateEncryptionStream(&mTemporaryStream);
     }
     else
     {
@@ -90,19 +92,29 @@ PDFStream::PDFStream(bool inCompressStream, charta::IByteWriterWithPosition *inO
         if ((mExtender != nullptr) && mExtender->OverridesStreamCompression())
         {
             mWriteStream = mExtender->GetCompressionWriteStream(mEncryptionStream != nullptr ? mEncryptionStream
-                                                                                             : &mTemporaryOutputStream);
+                                                                                             : &mTemporaryStream);
         }
         else
         {
-            mFlateEncodingStream.Assign(mEncryptionStream != nullptr ? mEncryptionStream : &mTemporaryOutputStream);
+            mFlateEncodingStream.Assign(mEncryptionStream != nullptr ? mEncryptionStream : &mTemporaryStream);
             mWriteStream = &mFlateEncodingStream;
         }
     }
     else
-        mWriteStream = mEncryptionStream != nullptr ? mEncryptionStream : &mTemporaryOutputStream;
+        mWriteStream = mEncryptionStream != nullptr ? mEncryptionStream : &mTemporaryStream;
 }
 
-PDFStream::~PDFStream() = default;
+PDFStream::~PDFStream()
+{
+    if (mStatistics != nullptr)
+        mStatistics->ReleaseBufferedMemory(mReportedBufferedMemory);
+}
+
+void PDFStream::SetStatistics(WriterStatistics *inStatistics)
+{
+    mStatistics = inStatistics;
+    mFlateEncodingStream.MeasureEncodingTime(mStatistics != nullptr);
+}
 
 charta::IByteWriter *PDFStream::GetWriteStream()
 {
@@ -129,13 +141,34 @@ void PDFStream::FinalizeStreamWrite()
     // different endings, depending if direct stream writing or not
     if (mExtendObjectID == 0)
     {
-        mStreamLength = mTemporaryStream.GetCurrentWritePosition();
+        mStreamLength = mTemporaryStream.GetCurrentPosition();
     }
     else
     {
         mStreamLength = mOutputStream->GetCurrentPosition() - mStreamStartPosition;
         mOutputStream = nullptr;
     }
+
+    if (mStatistics != nullptr)
+    {
+        bool flateEncoded = mCompressStream && ((mExtender == nullptr) || !mExtender->OverridesStreamCompression());
+        if (flateEncoded)
+        {
+            mStatistics->AddStream(mFlateEncodingStream.GetInputBytes(), mStreamLength);
+            mStatistics->AddPhaseTime(eWriterStatisticsPhaseCompression,
+                                      mFlateEncodingStream.GetEncodingNanoseconds());
+        }
+        else
+        {
+            mStatistics->AddStream(mStreamLength, mStreamLength);
+        }
+
+        if (mExtendObjectID == 0)
+        {
+            mReportedBufferedMemory = (size_t)mStreamLength;
+            mStatistics->AddBufferedMemory(mReportedBufferedMemory);
+        }
+    }
 }
 
 long long PDFStream::GetLength() const
@@ -160,13 +193,14 @@ DictionaryContext *PDFStream::GetStreamDictionaryForDirectExtentStream()
 
 void PDFStream::FlushStreamContentForDirectExtentStream()
 {
-    mTemporaryStream.pubseekoff(0, std::ios_base::beg);
-
-    // copy internal temporary stream to output
-    charta::InputStringBufferStream inputStreamForWrite(&mTemporaryStream);
-    charta::OutputStreamTraits streamCopier(mOutputStream);
-    streamCopier.CopyToOutputStream(&inputStreamForWrite);
-
-    mTemporaryStream.str();
+    // copy internal temporary stream to output, and let go of its memory
+    mTemporaryStream.CopyToOutputStream(mOutputStream);
+    mTemporaryStream.Reset();
     mOutputStream = nullptr;
+
+    if (mStatistics != nullptr)
+    {
+        mStatistics->ReleaseBufferedMemory(mReportedBufferedMemory);
+        mReportedBufferedMemory = 0;
+    }
 }
@@ -22,11 +22,11 @@
 #include "DictionaryContext.h"
 #include "IWrittenFont.h"
 #include "ObjectsContext.h"
+#include "StateReader.h"
 #include "encoding/UnicodeString.h"
 #include "objects/PDFDictionary.h"
 #include "objects/PDFIndirectObjectReference.h"
 #include "objects/PDFObjectCast.h"
-#include "parsing/PDFParser.h"
 
 #include FT_GLYPH_H
 
@@ -55,6 +55,8 @@ bool PDFUsedFont::IsValid()
 EStatusCode PDFUsedFont::EncodeStringForShowing(const GlyphUnicodeMappingList &inText, ObjectIDType &outFontObjectToUse,
                                                 UShortList &outCharactersToUse, bool &outTreatCharactersAsCID)
 {
+    std::lock_guard<std::mutex> lock(mLock);
+
     if (inText.empty())
     {
         outFontObjectToUse = 0;
@@ -73,6 +75,8 @@ EStatusCode PDFUsedFont::EncodeStringForShowing(const GlyphUnicodeMappingList &i
 EStatusCode PDFUsedFont::TranslateStringToGlyphs(const std::string &inText,
                                                  GlyphUnicodeMappingList &outGlyphsUnicodeMapping)
 {
+    std::lock_guard<std::mutex> lock(mLock);
+
     UIntList glyphs;
     UnicodeString unicode;
 
@@ -95,6 +99,8 @@ EStatusCode PDFUsedFont::EncodeStringsForShowing(const GlyphUnicodeMappingListLi
                                                  ObjectIDType &outFontObjectToUse, UShortListList &outCharactersToUse,
                                                  bool &outTreatCharactersAsCID)
 {
+    std::lock_guard<std::mutex> lock(mLock);
+
     if (inText.empty())
     {
         outFontObjectToUse = 0;
@@ -146,7 +152,7 @@ EStatusCode PDFUsedFont::WriteState(ObjectsContext *inStateWriter, ObjectIDType
     return charta::eSuccess;
 }
 
-EStatusCode PDFUsedFont::ReadState(PDFParser *inStateReader, ObjectIDType inObjectID)
+EStatusCode PDFUsedFont::ReadState(StateReader *inStateReader, ObjectIDType inObjectID)
 {
     PDFObjectCastPtr<charta::PDFDictionary> pdfUsedFontState(inStateReader->ParseNewObject(inObjectID));
 
@@ -173,6 +179,8 @@ FreeTypeFaceWrapper *PDFUsedFont::GetFreeTypeFont()
 
 void PDFUsedFont::GetUnicodeGlyphs(const std::string &inText, UIntList &glyphs)
 {
+    std::lock_guard<std::mutex> lock(mLock);
+
     UnicodeString unicode;
 
     unicode.FromUTF8(inText);
@@ -182,15 +190,14 @@ void PDFUsedFont::GetUnicodeGlyphs(const std::string &inText, UIntList &glyphs)
 PDFUsedFont::TextMeasures PDFUsedFont::CalculateTextDimensions(const std::string &inText, long inFontSize)
 {
     UIntList glyphs;
-    UnicodeString unicode;
-
-    unicode.FromUTF8(inText);
-    mFaceWrapper.GetGlyphsForUnicodeText(unicode.GetUnicodeList(), glyphs);
+    GetUnicodeGlyphs(inText, glyphs);
     return CalculateTextDimensions(glyphs, inFontSize);
 }
 
 PDFUsedFont::TextMeasures PDFUsedFont::CalculateTextDimensions(const UIntList &inGlyphsList, long inFontSize)
 {
+    std::lock_guard<std::mutex> lock(mLock);
+
     // now calculate the placement bounding box. using the algorithm described in the FreeType turtorial part 2, minus
     // the kerning part, and with no scale
 
@@ -280,6 +287,8 @@ double PDFUsedFont::CalculateTextAdvance(const std::string &inText, double inFon
 
 double PDFUsedFont::CalculateTextAdvance(const UIntList &inGlyphsList, double inFontSize)
 {
+    std::lock_guard<std::mutex> lock(mLock);
+
     FT_Pos pen = 0;
     auto it = inGlyphsList.begin();
     for (; it != inGlyphsList.end(); ++it)
@@ -308,6 +317,8 @@ bool PDFUsedFont::EnumeratePaths(IOutlineEnumerator &target, const std::string &
 
 bool PDFUsedFont::EnumeratePaths(IOutlineEnumerator &target, const UIntList &inGlyphsList, double inFontSize)
 {
+    std::lock_guard<std::mutex> lock(mLock);
+
     bool status = true;
     target.BeginEnum(inFontSize);
     for (uint32_t it : inGlyphsList)
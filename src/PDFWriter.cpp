@@ -65,7 +65,8 @@ EStatusCode PDFWriter::StartPDF(const std::string &inOutputFilePath, EPDFVersion
     SetupLog(inLogConfiguration);
     SetupCreationSettings(inPDFCreationSettings);
 
-    EStatusCode status = mOutputFile.OpenFile(inOutputFilePath);
+    EStatusCode status = mOutputFile.OpenFile(inOutputFilePath, false, inPDFCreationSettings.AsynchronousFileOutput,
+                                              inPDFCreationSettings.SyncFileOnClose);
     if (status != eSuccess)
         return status;
 
@@ -123,6 +124,11 @@ EStatusCode PDFWriter::EndPDF()
     return status;
 }
 
+long long PDFWriter::GetSafeToSendPosition()
+{
+    return mObjectsContext.GetCompletedPosition();
+}
+
 void PDFWriter::Cleanup()
 {
     mObjectsContext.Cleanup();
@@ -170,7 +176,14 @@ void PDFWriter::SetupLog(const LogConfiguration &inLogConfiguration)
 void PDFWriter::SetupCreationSettings(const PDFCreationSettings &inPDFCreationSettings)
 {
     mObjectsContext.SetCompressStreams(inPDFCreationSettings.CompressStreams);
+    mObjectsContext.SetDirectStreamLengths(inPDFCreationSettings.ProgressiveOutput);
     mDocumentContext.SetEmbedFonts(inPDFCreationSettings.EmbedFonts);
+    mDocumentContext.SetElideRedundantOperators(inPDFCreationSettings.ElideRedundantOperators);
+    mDocumentContext.SetImageOptimization(inPDFCreationSettings.ImageTargetResolution,
+                                          inPDFCreationSettings.ImageJPEGQuality);
+    mDocumentContext.SetImagePreparationThreads(inPDFCreationSettings.ImagePreparationThreads);
+    mStatistics.Reset();
+    mObjectsContext.SetStatistics(inPDFCreationSettings.CollectStatistics ? &mStatistics : nullptr);
 }
 
 void PDFWriter::ReleaseLog()
@@ -178,6 +191,21 @@ void PDFWriter::ReleaseLog()
     // Singleton<Trace>::Reset();
 }
 
+PageContentBuffer *PDFWriter::StartPageContentBuffer(PDFPage &inPage, ObjectIDType inObjectsCount)
+{
+    return mDocumentContext.StartPageContentBuffer(inPage, inObjectsCount);
+}
+
+EStatusCode PDFWriter::CommitPageContentBuffer(PageContentBuffer *inPageContentBuffer)
+{
+    return mDocumentContext.CommitPageContentBuffer(inPageContentBuffer).first;
+}
+
+EStatusCodeAndObjectIDType PDFWriter::CommitPageContentBufferAndReturnPageID(PageContentBuffer *inPageContentBuffer)
+{
+    return mDocumentContext.CommitPageContentBuffer(inPageContentBuffer);
+}
+
 PageContentContext *PDFWriter::StartPageContentContext(PDFPage &inPage)
 {
     return mDocumentContext.StartPageContentContext(inPage);
@@ -251,6 +279,20 @@ PDFFormXObject *PDFWriter::CreateFormXObjectFromTIFFStream(charta::IByteReaderWi
     return mDocumentContext.CreateFormXObjectFromTIFFStream(inTIFFStream, inFormXObjectID, inTIFFUsageParameters);
 }
 
+charta::PDFFormXObjectVector PDFWriter::CreateFormXObjectsFromTIFFFile(const std::string &inTIFFFilePath,
+                                                                       const std::vector<unsigned long> &inPageIndexes,
+                                                                       const TIFFUsageParameters &inTIFFUsageParameters)
+{
+    return mDocumentContext.CreateFormXObjectsFromTIFFFile(inTIFFFilePath, inPageIndexes, inTIFFUsageParameters);
+}
+
+charta::PDFFormXObjectVector PDFWriter::CreateFormXObjectsFromTIFFStream(
+    charta::IByteReaderWithPosition *inTIFFStream, const std::vector<unsigned long> &inPageIndexes,
+    const TIFFUsageParameters &inTIFFUsageParameters)
+{
+    return mDocumentContext.CreateFormXObjectsFromTIFFStream(inTIFFStream, inPageIndexes, inTIFFUsageParameters);
+}
+
 #endif
 
 #ifndef LIBCHARTA_NO_PNG
@@ -339,7 +381,7 @@ EStatusCodeAndObjectIDTypeList PDFWriter::AppendPDFPagesFromPDF(const std::strin
                                                   inCopyAdditionalObjects);
 }
 
-EStatusCode PDFWriter::Shutdown(const std::string &inStateFilePath)
+EStatusCode PDFWriter::Shutdown(const std::string &inStateFilePath, EStateFileFormat inStateFileFormat)
 {
     EStatusCode status;
 
@@ -347,7 +389,7 @@ EStatusCode PDFWriter::Shutdown(const std::string &inStateFilePath)
     {
         StateWriter writer;
 
-        status = writer.Start(inStateFilePath);
+        status = writer.Start(inStateFilePath, inStateFileFormat);
         if (status != eSuccess)
         {
             TRACE_LOG("PDFWriter::Shutdown, cant start state writing");
@@ -453,8 +495,7 @@ EStatusCode PDFWriter::SetupState(const std::string &inStateFilePath)
             break;
         }
 
-        PDFObjectCastPtr<charta::PDFDictionary> pdfWriterDictionary(
-            reader.GetObjectsReader()->ParseNewObject(reader.GetRootObjectID()));
+        PDFObjectCastPtr<charta::PDFDictionary> pdfWriterDictionary(reader.ParseNewObject(reader.GetRootObjectID()));
 
         PDFObjectCastPtr<charta::PDFBoolean> isModifiedObject(pdfWriterDictionary->QueryDirectObject("mIsModified"));
         mIsModified = isModifiedObject->GetValue();
@@ -468,13 +509,13 @@ EStatusCode PDFWriter::SetupState(const std::string &inStateFilePath)
 
         PDFObjectCastPtr<charta::PDFIndirectObjectReference> objectsContextObject(
             pdfWriterDictionary->QueryDirectObject("mObjectsContext"));
-        status = mObjectsContext.ReadState(reader.GetObjectsReader(), objectsContextObject->mObjectID);
+        status = mObjectsContext.ReadState(&reader, objectsContextObject->mObjectID);
         if (status != eSuccess)
             break;
 
         PDFObjectCastPtr<charta::PDFIndirectObjectReference> documentContextObject(
             pdfWriterDictionary->QueryDirectObject("mDocumentContext"));
-        status = mDocumentContext.ReadState(reader.GetObjectsReader(), documentContextObject->mObjectID);
+        status = mDocumentContext.ReadState(&reader, documentContextObject->mObjectID);
         if (status != eSuccess)
             break;
 
@@ -575,6 +616,17 @@ PDFFormXObject *PDFWriter::CreateFormXObjectFromJPGStream(charta::IByteReaderWit
     return mDocumentContext.CreateFormXObjectFromJPGStream(inJPGStream, inFormXObjectID);
 }
 
+PDFImageXObject *PDFWriter::CreateImageXObjectFromPixels(const PixelsImageDescription &inPixels)
+{
+    return mDocumentContext.CreateImageXObjectFromPixels(inPixels);
+}
+
+PDFImageXObject *PDFWriter::CreateImageXObjectFromPixels(const PixelsImageDescription &inPixels,
+                                                         ObjectIDType inImageXObjectID)
+{
+    return mDocumentContext.CreateImageXObjectFromPixels(inPixels, inImageXObjectID);
+}
+
 EStatusCodeAndObjectIDTypeList PDFWriter::CreateFormXObjectsFromPDF(charta::IByteReaderWithPosition *inPDFStream,
                                                                     const PDFPageRange &inPageRange,
                                                                     EPDFPageBox inPageBoxToUseAsFormBox,
@@ -621,6 +673,11 @@ std::shared_ptr<PDFDocumentCopyingContext> PDFWriter::CreatePDFCopyingContext(
     return mDocumentContext.CreatePDFCopyingContext(inPDFStream, inOptions);
 }
 
+std::shared_ptr<PDFDocumentCopyingContext> PDFWriter::CreatePDFCopyingContext(PDFParserReader *inParserReader)
+{
+    return mDocumentContext.CreatePDFCopyingContext(inParserReader);
+}
+
 EStatusCode PDFWriter::ModifyPDF(const std::string &inModifiedFile, EPDFVersion inPDFVersion,
                                  const std::string &inOptionalAlternativeOutputFile,
                                  const LogConfiguration &inLogConfiguration,
@@ -636,14 +693,17 @@ EStatusCode PDFWriter::ModifyPDF(const std::string &inModifiedFile, EPDFVersion
         // either append to original file, or create a new copy and "modify" it. depending on users choice
         if (inOptionalAlternativeOutputFile.empty() || (inOptionalAlternativeOutputFile == inModifiedFile))
         {
-            status = mOutputFile.OpenFile(inModifiedFile, true);
+            status = mOutputFile.OpenFile(inModifiedFile, true, inPDFCreationSettings.AsynchronousFileOutput,
+                                          inPDFCreationSettings.SyncFileOnClose);
             if (status != eSuccess)
                 break;
             mObjectsContext.SetOutputStream(mOutputFile.GetOutputStream());
         }
         else
         {
-            status = mOutputFile.OpenFile(inOptionalAlternativeOutputFile);
+            status = mOutputFile.OpenFile(inOptionalAlternativeOutputFile, false,
+                                          inPDFCreationSettings.AsynchronousFileOutput,
+                                          inPDFCreationSettings.SyncFileOnClose);
             if (status != eSuccess)
                 break;
 
@@ -818,63 +878,119 @@ charta::EStatusCode PDFWriter::RecryptPDF(charta::IByteReaderWithPosition *inOri
                                           EPDFVersion inOveridePDFVersion)
 {
     PDFWriter pdfWriter;
-    EStatusCode status;
-    std::shared_ptr<PDFDocumentCopyingContext> copyingContext = nullptr;
 
     /*
     How to recrypt an encrypted or plain PDF. In other words. create a new version that's decrypted, or encrypted with
     new passwords.
     */
+    EStatusCode status = DeepCopyPDF(pdfWriter, inOriginalPDFStream, inOriginalPDFPassword, inNewPDFStream,
+                                     inLogConfiguration, inPDFCreationSettings, inOveridePDFVersion, false);
 
-    do
-    {
-        // open PDF copying context for the source document (before starting a new one, so i can get the origina level
-        // and set the same)
-        copyingContext =
-            pdfWriter.CreatePDFCopyingContext(inOriginalPDFStream, PDFParsingOptions(inOriginalPDFPassword));
-        if (copyingContext == nullptr)
-        {
-            status = charta::eFailure;
-            break;
-        }
+    // now just end the PDF
+    if (status == charta::eSuccess)
+        pdfWriter.EndPDF();
 
-        // open new PDF for writing
-        status = pdfWriter.StartPDFForStream(
-            inNewPDFStream,
-            (ePDFVersionUndefined == inOveridePDFVersion)
-                ? EPDFVersion((int)(copyingContext->GetSourceDocumentParser()->GetPDFLevel() * 10))
-                : inOveridePDFVersion,
-            inLogConfiguration, inPDFCreationSettings);
-        if (status != charta::eSuccess)
-        {
-            break;
-        }
+    return status;
+}
 
-        // get its root object ID
-        PDFObjectCastPtr<charta::PDFIndirectObjectReference> catalogRef(
-            copyingContext->GetSourceDocumentParser()->GetTrailer()->QueryDirectObject("Root"));
-        if (!catalogRef)
-        {
-            status = charta::eFailure;
-            break;
-        }
+charta::EStatusCode PDFWriter::OptimizePDF(const std::string &inOriginalPDFPath, const std::string &inNewPDFPath,
+                                           const LogConfiguration &inLogConfiguration,
+                                           const PDFCreationSettings &inPDFCreationSettings,
+                                           const std::string &inOriginalPDFPassword)
+{
+    InputFile originalPDF;
+    OutputFile newPDF;
 
-        // deep-copy the whole pdf through its root - return root object ID copy at new PDF
-        EStatusCodeAndObjectIDType copyCatalogResult = copyingContext->CopyObject(catalogRef->mObjectID);
-        if (copyCatalogResult.first != eSuccess)
-        {
-            status = charta::eFailure;
-            break;
-        }
+    EStatusCode status = originalPDF.OpenFile(inOriginalPDFPath);
+    if (status != eSuccess)
+        return status;
 
-        copyingContext = nullptr;
+    status = newPDF.OpenFile(inNewPDFPath);
+    if (status != eSuccess)
+        return status;
 
-        // set new root object ID as this document root
-        pdfWriter.GetDocumentContext().GetTrailerInformation().SetRoot(copyCatalogResult.second);
+    return PDFWriter::OptimizePDF(originalPDF.GetInputStream(), newPDF.GetOutputStream(), inLogConfiguration,
+                                  inPDFCreationSettings, inOriginalPDFPassword);
+}
 
-        // now just end the PDF
-        pdfWriter.EndPDF();
-    } while (false);
+charta::EStatusCode PDFWriter::OptimizePDF(charta::IByteReaderWithPosition *inOriginalPDFStream,
+                                           charta::IByteWriterWithPosition *inNewPDFStream,
+                                           const LogConfiguration &inLogConfiguration,
+                                           const PDFCreationSettings &inPDFCreationSettings,
+                                           const std::string &inOriginalPDFPassword)
+{
+    PDFWriter pdfWriter;
 
-    return status;
-}
\ No newline at end of file
+    /*
+    The parser already resolves every object to its latest revision, so copying the document graph from the trailer
+    into a new file collapses all revisions into one. Objects that nothing reaches any more, like replaced page
+    contents or dropped pages, are never visited and so are left behind. The copying context allocates new IDs in
+    visiting order, which keeps the new numbering dense, and copies streams without decoding them when compressing.
+    Info is the other trailer entry holding on to content, so copy it as well.
+    */
+    EStatusCode status = DeepCopyPDF(pdfWriter, inOriginalPDFStream, inOriginalPDFPassword, inNewPDFStream,
+                                     inLogConfiguration, inPDFCreationSettings, ePDFVersionUndefined, true);
+    if (status != charta::eSuccess)
+        return status;
+
+    return pdfWriter.EndPDF();
+}
+
+charta::EStatusCode PDFWriter::DeepCopyPDF(PDFWriter &inPDFWriter, charta::IByteReaderWithPosition *inOriginalPDFStream,
+                                           const std::string &inOriginalPDFPassword,
+                                           charta::IByteWriterWithPosition *inNewPDFStream,
+                                           const LogConfiguration &inLogConfiguration,
+                                           const PDFCreationSettings &inPDFCreationSettings,
+                                           EPDFVersion inOveridePDFVersion, bool inCopyInfo)
+{
+    // open PDF copying context for the source document (before starting a new one, so i can get the original level
+    // and set the same)
+    std::shared_ptr<PDFDocumentCopyingContext> copyingContext =
+        inPDFWriter.CreatePDFCopyingContext(inOriginalPDFStream, PDFParsingOptions(inOriginalPDFPassword));
+    if (copyingContext == nullptr)
+        return charta::eFailure;
+
+    PDFParser *sourceParser = copyingContext->GetSourceDocumentParser();
+
+    // open new PDF for writing
+    EStatusCode status = inPDFWriter.StartPDFForStream(
+        inNewPDFStream,
+        (ePDFVersionUndefined == inOveridePDFVersion) ? EPDFVersion((int)(sourceParser->GetPDFLevel() * 10))
+                                                      : inOveridePDFVersion,
+        inLogConfiguration, inPDFCreationSettings);
+    if (status != charta::eSuccess)
+        return status;
+
+    // get its root object ID
+    PDFObjectCastPtr<charta::PDFIndirectObjectReference> catalogRef(
+        sourceParser->GetTrailer()->QueryDirectObject("Root"));
+    if (!catalogRef)
+    {
+        TRACE_LOG("PDFWriter::DeepCopyPDF, source document trailer has no Root");
+        return charta::eFailure;
+    }
+
+    // deep-copy the whole pdf through its root - return root object ID copy at new PDF
+    EStatusCodeAndObjectIDType copyCatalogResult = copyingContext->CopyObject(catalogRef->mObjectID);
+    if (copyCatalogResult.first != eSuccess)
+        return charta::eFailure;
+
+    // set new root object ID as this document root
+    inPDFWriter.GetDocumentContext().GetTrailerInformation().SetRoot(copyCatalogResult.second);
+
+    if (inCopyInfo)
+    {
+        PDFObjectCastPtr<charta::PDFIndirectObjectReference> infoRef(
+            sourceParser->GetTrailer()->QueryDirectObject("Info"));
+        if (!!infoRef)
+        {
+            EStatusCodeAndObjectIDType copyInfoResult = copyingContext->CopyObject(infoRef->mObjectID);
+            if (copyInfoResult.first != eSuccess)
+                return charta::eFailure;
+            inPDFWriter.GetDocumentContext().GetTrailerInformation().SetInfoDictionaryReference(
+                copyInfoResult.second);
+        }
+    }
+
+    return charta::eSuccess;
+}
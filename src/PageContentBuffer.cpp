@@ -0,0 +1,113 @@
+/*
+   Source File : PageContentBuffer.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "PageContentBuffer.h"
+#include "DocumentContext.h"
+#include "PageContentContext.h"
+
+using namespace charta;
+
+PageContentBuffer::PageContentBuffer(charta::DocumentContext *inDocumentContext, PDFPage &inPage,
+                                     ObjectIDType inFirstObjectID, ObjectIDType inObjectsCount,
+                                     bool inCompressStreams)
+    : mPage(inPage), mOutputStream(&mBuffer)
+{
+    mDocumentContext = inDocumentContext;
+    mFirstObjectID = inFirstObjectID;
+    mObjectsCount = inObjectsCount;
+    mContentContext = nullptr;
+    mReportedBufferedMemory = 0;
+
+    mObjectsContext.SetOutputStream(&mOutputStream);
+    mObjectsContext.SetCompressStreams(inCompressStreams);
+    mObjectsContext.SetStatistics(inDocumentContext->GetStatistics());
+    mObjectsContext.SetStatisticsCategory(eWriterStatisticsCategoryContent);
+    mObjectsContext.GetInDirectObjectsRegistry().SetupReservedRange(inFirstObjectID, inObjectsCount);
+}
+
+PageContentBuffer::~PageContentBuffer()
+{
+    delete mContentContext;
+    if (mObjectsContext.GetStatistics() != nullptr)
+        mObjectsContext.GetStatistics()->ReleaseBufferedMemory(mReportedBufferedMemory);
+}
+
+void PageContentBuffer::UpdateBufferedMemory()
+{
+    WriterStatistics *statistics = mObjectsContext.GetStatistics();
+    if (statistics == nullptr)
+        return;
+
+    size_t bufferSize = (size_t)mBuffer.GetCurrentWritePosition();
+    if (bufferSize > mReportedBufferedMemory)
+        statistics->AddBufferedMemory(bufferSize - mReportedBufferedMemory);
+    else
+        statistics->ReleaseBufferedMemory(mReportedBufferedMemory - bufferSize);
+    mReportedBufferedMemory = bufferSize;
+}
+
+PageContentContext *PageContentBuffer::GetContentContext()
+{
+    if (mContentContext == nullptr)
+        mContentContext = new PageContentContext(mDocumentContext, mPage, &mObjectsContext);
+    return mContentContext;
+}
+
+ObjectsContext &PageContentBuffer::GetObjectsContext()
+{
+    return mObjectsContext;
+}
+
+PDFPage &PageContentBuffer::GetPage()
+{
+    return mPage;
+}
+
+ObjectIDType PageContentBuffer::GetFirstObjectID() const
+{
+    return mFirstObjectID;
+}
+
+ObjectIDType PageContentBuffer::GetObjectsCount() const
+{
+    return mObjectsCount;
+}
+
+EStatusCode PageContentBuffer::Finalize()
+{
+    if (mContentContext == nullptr)
+        return eSuccess;
+
+    EStatusCode status = mContentContext->FinalizeCurrentStream();
+    delete mContentContext;
+    mContentContext = nullptr;
+    UpdateBufferedMemory();
+    return status;
+}
+
+EStatusCode PageContentBuffer::WriteTo(ObjectsContext *inTargetObjectsContext)
+{
+    EStatusCode status = Finalize();
+    if (status != eSuccess)
+        return status;
+
+    UpdateBufferedMemory();
+    return inTargetObjectsContext->CopyBufferedObjects(mObjectsContext, mBuffer, mFirstObjectID, mObjectsCount);
+}
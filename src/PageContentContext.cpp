@@ -73,6 +73,7 @@ PDFPage &PageContentContext::GetAssociatedPage()
 
 EStatusCode PageContentContext::FinalizeStreamWriteAndRelease()
 {
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryContent);
     mObjectsContext->EndPDFStream(mCurrentStream);
     mCurrentStream = nullptr;
     return charta::eSuccess;
@@ -21,6 +21,8 @@
 #include "PrimitiveObjectsWriter.h"
 #include "SafeBufferMacrosDefs.h"
 #include "io/IByteWriter.h"
+#include <algorithm>
+#include <cmath>
 #include <iomanip>
 #include <locale>
 #include <sstream>
@@ -136,6 +138,57 @@ void PrimitiveObjectsWriter::WriteLiteralString(const std::string &inString, ETo
 
 void PrimitiveObjectsWriter::WriteDouble(double inDoubleToken, ETokenSeparator inSeparate)
 {
+    char buffer[scMaxDoubleLength];
+    size_t sizeToWrite = FormatDouble(inDoubleToken, buffer);
+
+    mStreamForWriting->Write((const uint8_t *)buffer, sizeToWrite);
+    WriteTokenSeparator(inSeparate);
+}
+
+size_t PrimitiveObjectsWriter::FormatDouble(double inDoubleToken, char *outBuffer)
+{
+    /*
+        digits are computed from the value scaled to millionths. the scaling may be off by a fraction, so values
+        that are close to a rounding tie, as well as large and non finite ones, go through the stream formatting,
+        which rounds by the exact binary value.
+    */
+    double scaled = inDoubleToken * 1000000.0;
+    if (std::isfinite(scaled) && std::fabs(scaled) < 1e13)
+    {
+        double rounded = std::floor(std::fabs(scaled) + 0.5);
+        if (std::fabs(std::fabs(scaled) - rounded) < 0.49)
+        {
+            auto units = (unsigned long long)rounded;
+            unsigned long long integerPart = units / 1000000;
+            auto fraction = (unsigned long)(units % 1000000);
+
+            size_t length = 0;
+            if (std::signbit(inDoubleToken))
+                outBuffer[length++] = '-';
+
+            char digits[20];
+            size_t digitsCount = 0;
+            do
+            {
+                digits[digitsCount++] = (char)('0' + integerPart % 10);
+                integerPart /= 10;
+            } while (integerPart > 0);
+            while (digitsCount > 0)
+                outBuffer[length++] = digits[--digitsCount];
+
+            if (fraction != 0)
+            {
+                outBuffer[length++] = '.';
+                for (unsigned long divisor = 100000; fraction != 0; divisor /= 10)
+                {
+                    outBuffer[length++] = (char)('0' + fraction / divisor);
+                    fraction %= divisor;
+                }
+            }
+            return length;
+        }
+    }
+
     // make sure we get proper decimal point writing
     std::stringstream s;
     // use classic locale for no worries writing
@@ -143,33 +196,27 @@ void PrimitiveObjectsWriter::WriteDouble(double inDoubleToken, ETokenSeparator i
     s << std::fixed << inDoubleToken;
     std::string result = s.str();
 
-    size_t sizeToWrite = DetermineDoubleTrimmedLength(result);
-
-    mStreamForWriting->Write((const uint8_t *)(result.c_str()), sizeToWrite);
-    WriteTokenSeparator(inSeparate);
+    size_t length = std::min(DetermineDoubleTrimmedLength(result.c_str(), result.length()), scMaxDoubleLength);
+    memcpy(outBuffer, result.c_str(), length);
+    return length;
 }
 
-size_t PrimitiveObjectsWriter::DetermineDoubleTrimmedLength(const std::string &inString)
+size_t PrimitiveObjectsWriter::DetermineDoubleTrimmedLength(const char *inString, size_t inLength)
 {
-    size_t result = inString.length();
+    size_t result = inLength;
 
     // check that we got decimal dot. if not...use original length.
-    std::size_t found = inString.find('.');
-    if (found == std::string::npos)
+    if (memchr(inString, '.', inLength) == nullptr)
         return result;
 
     // otherwise - trim trailing 0s and decimal dot
 
     // remove all ending 0's
-    std::string::const_reverse_iterator fromEnd = inString.rbegin();
-    while (result > 0 && *fromEnd == '0')
-    {
-        ++fromEnd;
+    while (result > 0 && inString[result - 1] == '0')
         --result;
-    }
 
     // if it's actually an integer, remove also decimal point
-    if (result > 0 && *fromEnd == '.')
+    if (result > 0 && inString[result - 1] == '.')
         --result;
     return result;
 }
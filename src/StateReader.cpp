@@ -25,12 +25,26 @@
 
 using namespace charta;
 
-StateReader::StateReader() = default;
+StateReader::StateReader() : mIsSnapshot(false), mRootObject(0)
+{
+}
 
 StateReader::~StateReader() = default;
 
 EStatusCode StateReader::Start(const std::string &inStateFilePath)
 {
+    mIsSnapshot = StateSnapshot::IsSnapshotFile(inStateFilePath);
+    if (mIsSnapshot)
+    {
+        if (mSnapshot.Open(inStateFilePath) != charta::eSuccess)
+        {
+            TRACE_LOG1("StateReader::Start, unable to open state snapshot %s", inStateFilePath.c_str());
+            return charta::eFailure;
+        }
+        mRootObject = mSnapshot.GetRootObjectID();
+        return charta::eSuccess;
+    }
+
     // open the new file...
     if (mInputFile.OpenFile(inStateFilePath) != charta::eSuccess)
     {
@@ -51,9 +65,22 @@ EStatusCode StateReader::Start(const std::string &inStateFilePath)
     return charta::eSuccess;
 }
 
-PDFParser *StateReader::GetObjectsReader()
+std::shared_ptr<charta::PDFObject> StateReader::ParseNewObject(ObjectIDType inObjectID)
+{
+    return mIsSnapshot ? mSnapshot.ParseNewObject(inObjectID) : mParser.ParseNewObject(inObjectID);
+}
+
+std::shared_ptr<charta::PDFObject> StateReader::QueryDictionaryObject(
+    const std::shared_ptr<charta::PDFDictionary> &inDictionary, const std::string &inName)
 {
-    return &mParser;
+    if (!mIsSnapshot)
+        return mParser.QueryDictionaryObject(inDictionary, inName);
+
+    std::shared_ptr<charta::PDFObject> anObject = inDictionary->QueryDirectObject(inName);
+    if (anObject != nullptr && anObject->GetType() == charta::PDFObject::ePDFObjectIndirectObjectReference)
+        return mSnapshot.ParseNewObject(
+            std::static_pointer_cast<charta::PDFIndirectObjectReference>(anObject)->mObjectID);
+    return anObject;
 }
 
 ObjectIDType StateReader::GetRootObjectID() const
@@ -63,5 +90,8 @@ ObjectIDType StateReader::GetRootObjectID() const
 
 void StateReader::Finish()
 {
-    mParser.ResetParser();
+    if (mIsSnapshot)
+        mSnapshot.Close();
+    else
+        mParser.ResetParser();
 }
@@ -0,0 +1,504 @@
+/*
+   Source File : StateSnapshot.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "StateSnapshot.h"
+#include "Trace.h"
+#include "io/IByteWriterWithPosition.h"
+#include "io/InputFile.h"
+#include "io/OutputFile.h"
+#include "objects/PDFArray.h"
+#include "objects/PDFBoolean.h"
+#include "objects/PDFDictionary.h"
+#include "objects/PDFHexString.h"
+#include "objects/PDFIndirectObjectReference.h"
+#include "objects/PDFInteger.h"
+#include "objects/PDFLiteralString.h"
+#include "objects/PDFName.h"
+#include "objects/PDFNull.h"
+#include "objects/PDFReal.h"
+#include "objects/PDFSymbol.h"
+#include "parsing/PDFParser.h"
+
+#include <string.h>
+#include <zlib.h>
+
+#if !defined(_WIN32) && !defined(__WIN32__) && !defined(WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define STATE_SNAPSHOT_MMAP
+#endif
+
+using namespace charta;
+
+static const uint8_t scMagic[] = {0x89, 'C', 'H', 'S', 'T', 'A', 'T', 'E'};
+static const uint32_t scFormatVersion = 1;
+static const size_t scHeaderSize = 40;
+static const int scMaxDepth = 256;
+
+enum EStateSnapshotTag
+{
+    eStateSnapshotTagNull,
+    eStateSnapshotTagFalse,
+    eStateSnapshotTagTrue,
+    eStateSnapshotTagInteger,
+    eStateSnapshotTagReal,
+    eStateSnapshotTagLiteralString,
+    eStateSnapshotTagHexString,
+    eStateSnapshotTagName,
+    eStateSnapshotTagSymbol,
+    eStateSnapshotTagArray,
+    eStateSnapshotTagDictionary,
+    eStateSnapshotTagReference
+};
+
+static void EncodeFixed(std::string &ioBuffer, uint64_t inValue, size_t inSize)
+{
+    for (size_t i = 0; i < inSize; ++i)
+        ioBuffer.push_back((char)((inValue >> (8 * i)) & 0xff));
+}
+
+static uint64_t DecodeFixed(const uint8_t *inData, size_t inSize)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < inSize; ++i)
+        value |= (uint64_t)inData[i] << (8 * i);
+    return value;
+}
+
+static void EncodeVarInt(std::string &ioBuffer, uint64_t inValue)
+{
+    while (inValue >= 0x80)
+    {
+        ioBuffer.push_back((char)((inValue & 0x7f) | 0x80));
+        inValue >>= 7;
+    }
+    ioBuffer.push_back((char)inValue);
+}
+
+static void EncodeBytes(std::string &ioBuffer, const std::string &inValue)
+{
+    EncodeVarInt(ioBuffer, inValue.size());
+    ioBuffer.append(inValue);
+}
+
+static uint32_t ComputeCRC(const uint8_t *inData, size_t inSize)
+{
+    uLong crc = crc32(0L, Z_NULL, 0);
+    while (inSize > 0)
+    {
+        uInt chunk = inSize > (1u << 30) ? (1u << 30) : (uInt)inSize;
+        crc = crc32(crc, inData, chunk);
+        inData += chunk;
+        inSize -= chunk;
+    }
+    return (uint32_t)crc;
+}
+
+static EStatusCode EncodeObject(std::string &ioBuffer, const std::shared_ptr<PDFObject> &inObject)
+{
+    switch (inObject->GetType())
+    {
+    case PDFObject::ePDFObjectNull:
+        ioBuffer.push_back(eStateSnapshotTagNull);
+        break;
+    case PDFObject::ePDFObjectBoolean:
+        ioBuffer.push_back(std::static_pointer_cast<PDFBoolean>(inObject)->GetValue() ? eStateSnapshotTagTrue
+                                                                                        : eStateSnapshotTagFalse);
+        break;
+    case PDFObject::ePDFObjectInteger: {
+        long long value = std::static_pointer_cast<PDFInteger>(inObject)->GetValue();
+        ioBuffer.push_back(eStateSnapshotTagInteger);
+        EncodeVarInt(ioBuffer, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+        break;
+    }
+    case PDFObject::ePDFObjectReal: {
+        double value = std::static_pointer_cast<PDFReal>(inObject)->GetValue();
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        ioBuffer.push_back(eStateSnapshotTagReal);
+        EncodeFixed(ioBuffer, bits, 8);
+        break;
+    }
+    case PDFObject::ePDFObjectLiteralString:
+        ioBuffer.push_back(eStateSnapshotTagLiteralString);
+        EncodeBytes(ioBuffer, std::static_pointer_cast<PDFLiteralString>(inObject)->GetValue());
+        break;
+    case PDFObject::ePDFObjectHexString:
+        ioBuffer.push_back(eStateSnapshotTagHexString);
+        EncodeBytes(ioBuffer, std::static_pointer_cast<PDFHexString>(inObject)->GetValue());
+        break;
+    case PDFObject::ePDFObjectName:
+        ioBuffer.push_back(eStateSnapshotTagName);
+        EncodeBytes(ioBuffer, std::static_pointer_cast<charta::PDFName>(inObject)->GetValue());
+        break;
+    case PDFObject::ePDFObjectSymbol:
+        ioBuffer.push_back(eStateSnapshotTagSymbol);
+        EncodeBytes(ioBuffer, std::static_pointer_cast<PDFSymbol>(inObject)->GetValue());
+        break;
+    case PDFObject::ePDFObjectArray: {
+        auto anArray = std::static_pointer_cast<PDFArray>(inObject);
+        ioBuffer.push_back(eStateSnapshotTagArray);
+        EncodeVarInt(ioBuffer, anArray->GetLength());
+        auto it = anArray->GetIterator();
+        while (it.MoveNext())
+            if (EncodeObject(ioBuffer, it.GetItem()) != eSuccess)
+                return eFailure;
+        break;
+    }
+    case PDFObject::ePDFObjectDictionary: {
+        auto aDictionary = std::static_pointer_cast<PDFDictionary>(inObject);
+        ioBuffer.push_back(eStateSnapshotTagDictionary);
+        EncodeVarInt(ioBuffer, aDictionary->GetLength());
+        auto it = aDictionary->GetIterator();
+        while (it.MoveNext())
+        {
+            EncodeBytes(ioBuffer, it.GetKey()->GetValue());
+            if (EncodeObject(ioBuffer, it.GetValue()) != eSuccess)
+                return eFailure;
+        }
+        break;
+    }
+    case PDFObject::ePDFObjectIndirectObjectReference: {
+        auto reference = std::static_pointer_cast<PDFIndirectObjectReference>(inObject);
+        ioBuffer.push_back(eStateSnapshotTagReference);
+        EncodeVarInt(ioBuffer, reference->mObjectID);
+        EncodeVarInt(ioBuffer, reference->mVersion);
+        break;
+    }
+    default:
+        // streams, which state writing does not produce
+        TRACE_LOG1("StateSnapshot::Write, unsupported object type %d", inObject->GetType());
+        return eFailure;
+    }
+    return eSuccess;
+}
+
+StateSnapshot::StateSnapshot()
+    : mData(nullptr), mSize(0), mMapping(nullptr), mObjectsCount(0), mRootObjectID(0), mTablePosition(0)
+{
+}
+
+StateSnapshot::~StateSnapshot()
+{
+    Close();
+}
+
+EStatusCode StateSnapshot::Write(PDFParser &inStateParser, ObjectIDType inRootObjectID,
+                                 const std::string &inSnapshotFilePath)
+{
+    ObjectIDType objectsCount = inStateParser.GetXrefSize();
+    std::vector<uint64_t> positions(objectsCount, 0);
+    std::string body;
+
+    for (ObjectIDType i = 1; i < objectsCount; ++i)
+    {
+        std::shared_ptr<PDFObject> anObject = inStateParser.ParseNewObject(i);
+        if (anObject == nullptr)
+            continue;
+        positions[i] = scHeaderSize + body.size();
+        if (EncodeObject(body, anObject) != eSuccess)
+        {
+            TRACE_LOG1("StateSnapshot::Write, failed to encode object %ld", i);
+            return eFailure;
+        }
+    }
+
+    uint64_t tablePosition = scHeaderSize + body.size();
+    body.reserve(body.size() + objectsCount * 8);
+    for (uint64_t position : positions)
+        EncodeFixed(body, position, 8);
+
+    std::string header((const char *)scMagic, sizeof(scMagic));
+    EncodeFixed(header, scFormatVersion, 4);
+    EncodeFixed(header, ComputeCRC((const uint8_t *)body.data(), body.size()), 4);
+    EncodeFixed(header, objectsCount, 8);
+    EncodeFixed(header, inRootObjectID, 8);
+    EncodeFixed(header, tablePosition, 8);
+
+    OutputFile snapshotFile;
+    if (snapshotFile.OpenFile(inSnapshotFilePath) != eSuccess)
+    {
+        TRACE_LOG1("StateSnapshot::Write, can't open file for state writing in %s", inSnapshotFilePath.c_str());
+        return eFailure;
+    }
+    IByteWriterWithPosition *stream = snapshotFile.GetOutputStream();
+    if (stream->Write((const uint8_t *)header.data(), header.size()) != header.size() ||
+        stream->Write((const uint8_t *)body.data(), body.size()) != body.size())
+    {
+        TRACE_LOG1("StateSnapshot::Write, failed writing to %s", inSnapshotFilePath.c_str());
+        snapshotFile.CloseFile();
+        return eFailure;
+    }
+    return snapshotFile.CloseFile();
+}
+
+bool StateSnapshot::IsSnapshotFile(const std::string &inFilePath)
+{
+    InputFile aFile;
+    if (aFile.OpenFile(inFilePath) != eSuccess)
+        return false;
+
+    uint8_t buffer[sizeof(scMagic)];
+    bool isSnapshot = aFile.GetInputStream()->Read(buffer, sizeof(buffer)) == sizeof(buffer) &&
+                      memcmp(buffer, scMagic, sizeof(scMagic)) == 0;
+    aFile.CloseFile();
+    return isSnapshot;
+}
+
+EStatusCode StateSnapshot::Open(const std::string &inSnapshotFilePath)
+{
+    Close();
+
+    if (LoadFile(inSnapshotFilePath) != eSuccess)
+        return eFailure;
+
+    EStatusCode status = eFailure;
+    do
+    {
+        if (mSize < scHeaderSize || memcmp(mData, scMagic, sizeof(scMagic)) != 0)
+        {
+            TRACE_LOG1("StateSnapshot::Open, %s is not a state snapshot", inSnapshotFilePath.c_str());
+            break;
+        }
+
+        uint32_t version = (uint32_t)DecodeFixed(mData + 8, 4);
+        if (version != scFormatVersion)
+        {
+            TRACE_LOG2("StateSnapshot::Open, unsupported snapshot version %d in %s", version,
+                       inSnapshotFilePath.c_str());
+            break;
+        }
+
+        if ((uint32_t)DecodeFixed(mData + 12, 4) != ComputeCRC(mData + scHeaderSize, mSize - scHeaderSize))
+        {
+            TRACE_LOG1("StateSnapshot::Open, checksum mismatch in %s", inSnapshotFilePath.c_str());
+            break;
+        }
+
+        mObjectsCount = (ObjectIDType)DecodeFixed(mData + 16, 8);
+        mRootObjectID = (ObjectIDType)DecodeFixed(mData + 24, 8);
+        mTablePosition = DecodeFixed(mData + 32, 8);
+        if (mTablePosition < scHeaderSize || mTablePosition > mSize ||
+            (mSize - mTablePosition) / 8 < (uint64_t)mObjectsCount)
+        {
+            TRACE_LOG1("StateSnapshot::Open, corrupt objects table in %s", inSnapshotFilePath.c_str());
+            break;
+        }
+
+        status = eSuccess;
+    } while (false);
+
+    if (status != eSuccess)
+        Close();
+    return status;
+}
+
+EStatusCode StateSnapshot::LoadFile(const std::string &inSnapshotFilePath)
+{
+#ifdef STATE_SNAPSHOT_MMAP
+    int descriptor = open(inSnapshotFilePath.c_str(), O_RDONLY);
+    if (descriptor != -1)
+    {
+        struct stat fileStatus;
+        if (fstat(descriptor, &fileStatus) == 0 && fileStatus.st_size > 0)
+        {
+            void *mapping = mmap(nullptr, (size_t)fileStatus.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+            if (mapping != MAP_FAILED)
+            {
+                mMapping = mapping;
+                mData = (const uint8_t *)mapping;
+                mSize = (size_t)fileStatus.st_size;
+            }
+        }
+        close(descriptor);
+        if (mMapping != nullptr)
+            return eSuccess;
+    }
+#endif
+
+    // no mapping, read it all
+    InputFile aFile;
+    if (aFile.OpenFile(inSnapshotFilePath) != eSuccess)
+    {
+        TRACE_LOG1("StateSnapshot::Open, can't open file for state reading in %s", inSnapshotFilePath.c_str());
+        return eFailure;
+    }
+    mBuffer.resize((size_t)aFile.GetFileSize());
+    size_t readBytes = mBuffer.empty() ? 0 : aFile.GetInputStream()->Read(mBuffer.data(), mBuffer.size());
+    aFile.CloseFile();
+    if (readBytes != mBuffer.size())
+    {
+        TRACE_LOG1("StateSnapshot::Open, failed reading %s", inSnapshotFilePath.c_str());
+        mBuffer.clear();
+        return eFailure;
+    }
+    mData = mBuffer.data();
+    mSize = mBuffer.size();
+    return eSuccess;
+}
+
+void StateSnapshot::Close()
+{
+#ifdef STATE_SNAPSHOT_MMAP
+    if (mMapping != nullptr)
+        munmap(mMapping, mSize);
+#endif
+    mMapping = nullptr;
+    mBuffer.clear();
+    mBuffer.shrink_to_fit();
+    mData = nullptr;
+    mSize = 0;
+    mObjectsCount = 0;
+    mRootObjectID = 0;
+    mTablePosition = 0;
+}
+
+ObjectIDType StateSnapshot::GetRootObjectID() const
+{
+    return mRootObjectID;
+}
+
+ObjectIDType StateSnapshot::GetObjectsCount() const
+{
+    return mObjectsCount;
+}
+
+std::shared_ptr<PDFObject> StateSnapshot::ParseNewObject(ObjectIDType inObjectID)
+{
+    if (mData == nullptr || inObjectID >= mObjectsCount)
+        return nullptr;
+
+    size_t position = (size_t)DecodeFixed(mData + mTablePosition + 8 * (uint64_t)inObjectID, 8);
+    if (position < scHeaderSize || position >= mTablePosition)
+        return nullptr;
+    return DecodeObject(position, 0);
+}
+
+bool StateSnapshot::DecodeVarInt(size_t &ioPosition, uint64_t &outValue)
+{
+    outValue = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        if (ioPosition >= mTablePosition)
+            return false;
+        uint8_t aByte = mData[ioPosition++];
+        outValue |= (uint64_t)(aByte & 0x7f) << shift;
+        if ((aByte & 0x80) == 0)
+            return true;
+    }
+    return false;
+}
+
+bool StateSnapshot::DecodeBytes(size_t &ioPosition, std::string &outValue)
+{
+    uint64_t length;
+    if (!DecodeVarInt(ioPosition, length) || length > mTablePosition - ioPosition)
+        return false;
+    outValue.assign((const char *)mData + ioPosition, (size_t)length);
+    ioPosition += (size_t)length;
+    return true;
+}
+
+std::shared_ptr<PDFObject> StateSnapshot::DecodeObject(size_t &ioPosition, int inDepth)
+{
+    if (ioPosition >= mTablePosition || inDepth > scMaxDepth)
+        return nullptr;
+
+    uint8_t tag = mData[ioPosition++];
+    uint64_t value;
+    std::string bytes;
+
+    switch (tag)
+    {
+    case eStateSnapshotTagNull:
+        return std::make_shared<PDFNull>();
+    case eStateSnapshotTagFalse:
+        return std::make_shared<PDFBoolean>(false);
+    case eStateSnapshotTagTrue:
+        return std::make_shared<PDFBoolean>(true);
+    case eStateSnapshotTagInteger:
+        if (!DecodeVarInt(ioPosition, value))
+            return nullptr;
+        return std::make_shared<PDFInteger>((long long)(value >> 1) ^ -(long long)(value & 1));
+    case eStateSnapshotTagReal: {
+        if (mTablePosition - ioPosition < 8)
+            return nullptr;
+        uint64_t bits = DecodeFixed(mData + ioPosition, 8);
+        ioPosition += 8;
+        double aDouble;
+        memcpy(&aDouble, &bits, sizeof(aDouble));
+        return std::make_shared<PDFReal>(aDouble);
+    }
+    case eStateSnapshotTagLiteralString:
+        if (!DecodeBytes(ioPosition, bytes))
+            return nullptr;
+        return std::make_shared<PDFLiteralString>(bytes);
+    case eStateSnapshotTagHexString:
+        if (!DecodeBytes(ioPosition, bytes))
+            return nullptr;
+        return std::make_shared<PDFHexString>(bytes);
+    case eStateSnapshotTagName:
+        if (!DecodeBytes(ioPosition, bytes))
+            return nullptr;
+        return std::make_shared<charta::PDFName>(bytes);
+    case eStateSnapshotTagSymbol:
+        if (!DecodeBytes(ioPosition, bytes))
+            return nullptr;
+        return std::make_shared<PDFSymbol>(bytes);
+    case eStateSnapshotTagArray: {
+        if (!DecodeVarInt(ioPosition, value))
+            return nullptr;
+        auto anArray = std::make_shared<PDFArray>();
+        for (uint64_t i = 0; i < value; ++i)
+        {
+            std::shared_ptr<PDFObject> item = DecodeObject(ioPosition, inDepth + 1);
+            if (item == nullptr)
+                return nullptr;
+            anArray->AppendObject(item);
+        }
+        return anArray;
+    }
+    case eStateSnapshotTagDictionary: {
+        if (!DecodeVarInt(ioPosition, value))
+            return nullptr;
+        auto aDictionary = std::make_shared<PDFDictionary>();
+        for (uint64_t i = 0; i < value; ++i)
+        {
+            if (!DecodeBytes(ioPosition, bytes))
+                return nullptr;
+            std::shared_ptr<PDFObject> item = DecodeObject(ioPosition, inDepth + 1);
+            if (item == nullptr)
+                return nullptr;
+            aDictionary->Insert(std::make_shared<charta::PDFName>(bytes), item);
+        }
+        return aDictionary;
+    }
+    case eStateSnapshotTagReference: {
+        uint64_t version;
+        if (!DecodeVarInt(ioPosition, value) || !DecodeVarInt(ioPosition, version))
+            return nullptr;
+        return std::make_shared<PDFIndirectObjectReference>((ObjectIDType)value, (unsigned long)version);
+    }
+    default:
+        return nullptr;
+    }
+}
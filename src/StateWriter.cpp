@@ -21,14 +21,19 @@
 #include "StateWriter.h"
 #include "DictionaryContext.h"
 #include "ObjectsContext.h"
+#include "StateSnapshot.h"
 #include "Trace.h"
 #include "io/IByteWriterWithPosition.h"
+#include "io/InputStringStream.h"
+#include "parsing/PDFParser.h"
 
 using namespace charta;
 
 StateWriter::StateWriter()
 {
     mObjectsContext = nullptr;
+    mFormat = eStateFileFormatPDF;
+    mRootObject = 0;
 }
 
 StateWriter::~StateWriter()
@@ -36,20 +41,30 @@ StateWriter::~StateWriter()
     delete mObjectsContext;
 }
 
-EStatusCode StateWriter::Start(const std::string &inStateFilePath)
+EStatusCode StateWriter::Start(const std::string &inStateFilePath, EStateFileFormat inFormat)
 {
-
-    // open the new file...
-    if (mOutputFile.OpenFile(inStateFilePath) != charta::eSuccess)
-    {
-        TRACE_LOG1("StateWriter::Start, can't open file for state writing in %s", inStateFilePath.c_str());
-        return charta::eFailure;
-    }
+    mStateFilePath = inStateFilePath;
+    mFormat = inFormat;
 
     // Get me a new copy of objects context, for this session
     delete mObjectsContext;
     mObjectsContext = new ObjectsContext();
-    mObjectsContext->SetOutputStream(mOutputFile.GetOutputStream());
+
+    if (eStateFileFormatBinary == mFormat)
+    {
+        mOutputBuffer.Reset();
+        mObjectsContext->SetOutputStream(&mOutputBuffer);
+    }
+    else
+    {
+        // open the new file...
+        if (mOutputFile.OpenFile(inStateFilePath) != charta::eSuccess)
+        {
+            TRACE_LOG1("StateWriter::Start, can't open file for state writing in %s", inStateFilePath.c_str());
+            return charta::eFailure;
+        }
+        mObjectsContext->SetOutputStream(mOutputFile.GetOutputStream());
+    }
 
     // Put up a nice 'lil header comment. nice one, eh?
     mObjectsContext->WriteComment("PDFHummus-1.0");
@@ -82,6 +97,9 @@ EStatusCode StateWriter::Finish()
 
     } while (false);
 
+    if (eStateFileFormatBinary == mFormat)
+        return charta::eSuccess == status ? WriteSnapshot() : status;
+
     if (charta::eSuccess == status)
         status = mOutputFile.CloseFile();
     else
@@ -89,6 +107,22 @@ EStatusCode StateWriter::Finish()
     return status;
 }
 
+EStatusCode StateWriter::WriteSnapshot()
+{
+    // parse the composed state once here, so that continuing does not have to
+    std::string state = mOutputBuffer.ToString();
+    InputStringStream stateStream(state);
+    PDFParser parser;
+
+    if (parser.StartStateFileParsing(&stateStream) != charta::eSuccess)
+    {
+        TRACE_LOG("StateWriter::WriteSnapshot, unable to parse the composed state");
+        return charta::eFailure;
+    }
+
+    return StateSnapshot::Write(parser, mRootObject, mStateFilePath);
+}
+
 static const std::string scTrailer = "trailer";
 static const std::string scSize = "Size";
 static const std::string scRoot = "Root";
@@ -35,7 +35,9 @@ Trace::Trace()
 {
     mLog = nullptr;
     mLogFilePath = "Log.txt";
+    mLogStream = nullptr;
     mShouldLog = false;
+    mPlaceUTF8Bom = false;
 }
 
 Trace::~Trace()
@@ -45,6 +47,8 @@ Trace::~Trace()
 
 void Trace::SetLogSettings(const std::string &inLogFilePath, bool inShouldLog, bool inPlaceUTF8Bom)
 {
+    std::lock_guard<std::mutex> lock(mLock);
+
     mShouldLog = inShouldLog;
     mPlaceUTF8Bom = inPlaceUTF8Bom;
     mLogFilePath = inLogFilePath;
@@ -60,6 +64,8 @@ void Trace::SetLogSettings(const std::string &inLogFilePath, bool inShouldLog, b
 
 void Trace::SetLogSettings(charta::IByteWriter *inLogStream, bool inShouldLog)
 {
+    std::lock_guard<std::mutex> lock(mLock);
+
     mShouldLog = inShouldLog;
     mLogStream = inLogStream;
     mPlaceUTF8Bom = false;
@@ -76,38 +82,33 @@ void Trace::TraceToLog(const char *inFormat, ...)
 {
     if (mShouldLog)
     {
-        if (nullptr == mLog)
-        {
-            if (mLogStream != nullptr)
-                mLog = new Log(mLogStream);
-            else
-                mLog = new Log(mLogFilePath, mPlaceUTF8Bom);
-        }
-
         va_list argptr;
         va_start(argptr, inFormat);
-
-        SAFE_VSPRINTF(mBuffer, MAX_TRACE_SIZE, inFormat, argptr);
+        TraceToLog(inFormat, argptr);
         va_end(argptr);
-
-        mLog->LogEntry(std::string(mBuffer));
     }
 }
 
 void Trace::TraceToLog(const char *inFormat, va_list inList)
 {
-    if (mShouldLog)
-    {
-        if (nullptr == mLog)
-        {
-            if (mLogStream != nullptr)
-                mLog = new Log(mLogStream);
-            else
-                mLog = new Log(mLogFilePath, mPlaceUTF8Bom);
-        }
+    if (!mShouldLog)
+        return;
 
-        SAFE_VSPRINTF(mBuffer, MAX_TRACE_SIZE, inFormat, inList);
+    std::lock_guard<std::mutex> lock(mLock);
 
-        mLog->LogEntry(std::string(mBuffer));
+    // settings may have changed while waiting for the lock
+    if (!mShouldLog)
+        return;
+
+    if (nullptr == mLog)
+    {
+        if (mLogStream != nullptr)
+            mLog = new Log(mLogStream);
+        else
+            mLog = new Log(mLogFilePath, mPlaceUTF8Bom);
     }
+
+    SAFE_VSPRINTF(mBuffer, MAX_TRACE_SIZE, inFormat, inList);
+
+    mLog->LogEntry(std::string(mBuffer));
 }
@@ -23,6 +23,7 @@
 #include "ObjectsContext.h"
 #include "PDFTextString.h"
 #include "PDFUsedFont.h"
+#include "StateReader.h"
 #include "Trace.h"
 #include "objects/PDFArray.h"
 #include "objects/PDFBoolean.h"
@@ -31,7 +32,6 @@
 #include "objects/PDFInteger.h"
 #include "objects/PDFLiteralString.h"
 #include "objects/PDFObjectCast.h"
-#include "parsing/PDFParser.h"
 #include "text/freetype/FreeTypeWrapper.h"
 
 #include <list>
@@ -196,7 +196,7 @@ EStatusCode UsedFontsRepository::WriteState(ObjectsContext *inStateWriter, Objec
     return status;
 }
 
-EStatusCode UsedFontsRepository::ReadState(PDFParser *inStateReader, ObjectIDType inObjectID)
+EStatusCode UsedFontsRepository::ReadState(StateReader *inStateReader, ObjectIDType inObjectID)
 {
     EStatusCode status = charta::eSuccess;
 
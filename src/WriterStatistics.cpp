@@ -0,0 +1,222 @@
+/*
+   Source File : WriterStatistics.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "WriterStatistics.h"
+#include "ObjectsContext.h"
+
+#include <iomanip>
+#include <locale>
+#include <sstream>
+
+WriterStatistics::WriterStatistics()
+{
+    Reset();
+}
+
+void WriterStatistics::Reset()
+{
+    for (int i = 0; i < eWriterStatisticsCategoryCount; ++i)
+    {
+        mObjectsCount[i] = 0;
+        mBytes[i] = 0;
+    }
+    mStreamsCount = 0;
+    mRawStreamBytes = 0;
+    mEncodedStreamBytes = 0;
+    for (auto &phaseTime : mPhaseNanoseconds)
+        phaseTime = 0;
+    mBufferedMemory = 0;
+    mPeakBufferedMemory = 0;
+    mOutputBytes = 0;
+}
+
+void WriterStatistics::AddObject(EWriterStatisticsCategory inCategory, unsigned long long inBytes)
+{
+    mObjectsCount[inCategory].fetch_add(1, std::memory_order_relaxed);
+    mBytes[inCategory].fetch_add(inBytes, std::memory_order_relaxed);
+}
+
+void WriterStatistics::AddBytes(EWriterStatisticsCategory inCategory, unsigned long long inBytes)
+{
+    mBytes[inCategory].fetch_add(inBytes, std::memory_order_relaxed);
+}
+
+void WriterStatistics::AddStream(unsigned long long inRawBytes, unsigned long long inEncodedBytes)
+{
+    mStreamsCount.fetch_add(1, std::memory_order_relaxed);
+    mRawStreamBytes.fetch_add(inRawBytes, std::memory_order_relaxed);
+    mEncodedStreamBytes.fetch_add(inEncodedBytes, std::memory_order_relaxed);
+}
+
+void WriterStatistics::AddPhaseTime(EWriterStatisticsPhase inPhase, unsigned long long inNanoseconds)
+{
+    mPhaseNanoseconds[inPhase].fetch_add(inNanoseconds, std::memory_order_relaxed);
+}
+
+void WriterStatistics::AddBufferedMemory(size_t inBytes)
+{
+    size_t current = mBufferedMemory.fetch_add(inBytes, std::memory_order_relaxed) + inBytes;
+    size_t peak = mPeakBufferedMemory.load(std::memory_order_relaxed);
+    while (current > peak && !mPeakBufferedMemory.compare_exchange_weak(peak, current, std::memory_order_relaxed))
+        ;
+}
+
+void WriterStatistics::ReleaseBufferedMemory(size_t inBytes)
+{
+    mBufferedMemory.fetch_sub(inBytes, std::memory_order_relaxed);
+}
+
+void WriterStatistics::SetOutputBytes(unsigned long long inBytes)
+{
+    mOutputBytes = inBytes;
+}
+
+unsigned long long WriterStatistics::GetObjectsCount(EWriterStatisticsCategory inCategory) const
+{
+    return mObjectsCount[inCategory];
+}
+
+unsigned long long WriterStatistics::GetObjectsCount() const
+{
+    unsigned long long result = 0;
+    for (const auto &count : mObjectsCount)
+        result += count;
+    return result;
+}
+
+unsigned long long WriterStatistics::GetBytes(EWriterStatisticsCategory inCategory) const
+{
+    return mBytes[inCategory];
+}
+
+unsigned long long WriterStatistics::GetStreamsCount() const
+{
+    return mStreamsCount;
+}
+
+unsigned long long WriterStatistics::GetRawStreamBytes() const
+{
+    return mRawStreamBytes;
+}
+
+unsigned long long WriterStatistics::GetEncodedStreamBytes() const
+{
+    return mEncodedStreamBytes;
+}
+
+unsigned long long WriterStatistics::GetPhaseNanoseconds(EWriterStatisticsPhase inPhase) const
+{
+    return mPhaseNanoseconds[inPhase];
+}
+
+double WriterStatistics::GetPhaseSeconds(EWriterStatisticsPhase inPhase) const
+{
+    return (double)mPhaseNanoseconds[inPhase] / 1e9;
+}
+
+size_t WriterStatistics::GetBufferedMemory() const
+{
+    return mBufferedMemory;
+}
+
+size_t WriterStatistics::GetPeakBufferedMemory() const
+{
+    return mPeakBufferedMemory;
+}
+
+unsigned long long WriterStatistics::GetOutputBytes() const
+{
+    return mOutputBytes;
+}
+
+static const char *scCategoryNames[eWriterStatisticsCategoryCount] = {"content", "images", "fonts",  "xref",
+                                                                      "metadata", "copied", "other"};
+static const char *scPhaseNames[eWriterStatisticsPhaseCount] = {"compression", "fontSubsetting", "imageDecoding",
+                                                                "pdfCopying"};
+
+const char *WriterStatistics::GetCategoryName(EWriterStatisticsCategory inCategory)
+{
+    return scCategoryNames[inCategory];
+}
+
+const char *WriterStatistics::GetPhaseName(EWriterStatisticsPhase inPhase)
+{
+    return scPhaseNames[inPhase];
+}
+
+std::string WriterStatistics::ToJSON() const
+{
+    std::ostringstream json;
+    json.imbue(std::locale::classic());
+
+    json << "{\"outputBytes\":" << GetOutputBytes() << ",\"categories\":{";
+    for (int i = 0; i < eWriterStatisticsCategoryCount; ++i)
+    {
+        auto category = (EWriterStatisticsCategory)i;
+        json << (i == 0 ? "" : ",") << "\"" << GetCategoryName(category) << "\":{\"objects\":"
+             << GetObjectsCount(category) << ",\"bytes\":" << GetBytes(category) << "}";
+    }
+    json << "},\"streams\":{\"count\":" << GetStreamsCount() << ",\"rawBytes\":" << GetRawStreamBytes()
+         << ",\"encodedBytes\":" << GetEncodedStreamBytes() << "},\"phaseSeconds\":{";
+    json << std::fixed << std::setprecision(6);
+    for (int i = 0; i < eWriterStatisticsPhaseCount; ++i)
+    {
+        auto phase = (EWriterStatisticsPhase)i;
+        json << (i == 0 ? "" : ",") << "\"" << GetPhaseName(phase) << "\":" << GetPhaseSeconds(phase);
+    }
+    json << "},\"peakBufferedMemory\":" << GetPeakBufferedMemory() << "}";
+    return json.str();
+}
+
+// per thread nesting of timed phases, so that only the outermost scope adds its time
+static thread_local int sPhaseDepth[eWriterStatisticsPhaseCount] = {0};
+
+WriterStatisticsScope::WriterStatisticsScope(ObjectsContext *inObjectsContext, EWriterStatisticsCategory inCategory,
+                                             EWriterStatisticsPhase inPhase)
+{
+    mObjectsContext = inObjectsContext;
+    mStatistics = inObjectsContext != nullptr ? inObjectsContext->GetStatistics() : nullptr;
+    mPreviousCategory = eWriterStatisticsCategoryOther;
+    mPhase = inPhase;
+    mTimed = false;
+    if (mStatistics == nullptr)
+        return;
+
+    mPreviousCategory = mObjectsContext->SetStatisticsCategory(inCategory);
+    if (mPhase != eWriterStatisticsPhaseCount && sPhaseDepth[mPhase]++ == 0)
+    {
+        mTimed = true;
+        mStart = std::chrono::steady_clock::now();
+    }
+}
+
+WriterStatisticsScope::~WriterStatisticsScope()
+{
+    if (mStatistics == nullptr)
+        return;
+
+    mObjectsContext->SetStatisticsCategory(mPreviousCategory);
+    if (mPhase != eWriterStatisticsPhaseCount)
+        --sPhaseDepth[mPhase];
+    if (mTimed)
+        mStatistics->AddPhaseTime(mPhase, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                              std::chrono::steady_clock::now() - mStart)
+                                              .count());
+}
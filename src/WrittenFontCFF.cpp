@@ -22,13 +22,13 @@
 #include "CIDFontWriter.h"
 #include "DictionaryContext.h"
 #include "ObjectsContext.h"
+#include "StateReader.h"
 #include "Trace.h"
 #include "objects/PDFArray.h"
 #include "objects/PDFBoolean.h"
 #include "objects/PDFDictionary.h"
 #include "objects/PDFInteger.h"
 #include "objects/PDFObjectCast.h"
-#include "parsing/PDFParser.h"
 #include "text/cff/CFFANSIFontWriter.h"
 #include "text/cff/CFFDescendentFontWriter.h"
 
@@ -288,7 +288,7 @@ EStatusCode WrittenFontCFF::WriteState(ObjectsContext *inStateWriter, ObjectIDTy
     return status;
 }
 
-EStatusCode WrittenFontCFF::ReadState(PDFParser *inStateReader, ObjectIDType inObjectID)
+EStatusCode WrittenFontCFF::ReadState(StateReader *inStateReader, ObjectIDType inObjectID)
 {
     PDFObjectCastPtr<charta::PDFDictionary> writtenFontState(inStateReader->ParseNewObject(inObjectID));
 
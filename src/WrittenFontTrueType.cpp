@@ -22,11 +22,11 @@
 #include "CIDFontWriter.h"
 #include "DictionaryContext.h"
 #include "ObjectsContext.h"
+#include "StateReader.h"
 #include "Trace.h"
 #include "encoding/WinAnsiEncoding.h"
 #include "objects/PDFDictionary.h"
 #include "objects/PDFObjectCast.h"
-#include "parsing/PDFParser.h"
 #include "text/truetype/TrueTypeANSIFontWriter.h"
 #include "text/truetype/TrueTypeDescendentFontWriter.h"
 
@@ -241,7 +241,7 @@ EStatusCode WrittenFontTrueType::WriteState(ObjectsContext *inStateWriter, Objec
     return status;
 }
 
-EStatusCode WrittenFontTrueType::ReadState(PDFParser *inStateReader, ObjectIDType inObjectID)
+EStatusCode WrittenFontTrueType::ReadState(StateReader *inStateReader, ObjectIDType inObjectID)
 {
     PDFObjectCastPtr<charta::PDFDictionary> writtenFontState(inStateReader->ParseNewObject(inObjectID));
 
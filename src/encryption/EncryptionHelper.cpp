@@ -33,7 +33,7 @@ limitations under the License.
 #include "objects/PDFInteger.h"
 #include "objects/PDFLiteralString.h"
 #include "objects/PDFObjectCast.h"
-#include "parsing/PDFParser.h"
+#include "StateReader.h"
 
 #include <stdint.h>
 
@@ -425,7 +425,7 @@ charta::EStatusCode EncryptionHelper::WriteState(ObjectsContext *inStateWriter,
     return eSuccess;
 }
 
-charta::EStatusCode EncryptionHelper::ReadState(PDFParser *inStateReader, ObjectIDType inObjectID)
+charta::EStatusCode EncryptionHelper::ReadState(StateReader *inStateReader, ObjectIDType inObjectID)
 {
     PDFObjectCastPtr<charta::PDFDictionary> encryptionObjectState(inStateReader->ParseNewObject(inObjectID));
 
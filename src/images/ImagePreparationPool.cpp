@@ -0,0 +1,115 @@
+/*
+   Source File : ImagePreparationPool.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "images/ImagePreparationPool.h"
+#include "images/PreparedImage.h"
+
+#include <algorithm>
+
+using namespace charta;
+
+ImagePreparationPool::ImagePreparationPool()
+{
+    mThreadsCount = 0;
+    mStopping = false;
+}
+
+ImagePreparationPool::~ImagePreparationPool()
+{
+    Stop();
+}
+
+void ImagePreparationPool::SetThreadsCount(unsigned int inThreadsCount)
+{
+    Stop();
+    mThreadsCount = inThreadsCount;
+}
+
+unsigned int ImagePreparationPool::GetThreadsCount() const
+{
+    return mThreadsCount;
+}
+
+void ImagePreparationPool::Submit(PreparedImage *inImage)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+
+    mQueue.push_back(inImage);
+    // one more thread per queued image, up to the count
+    if (mThreads.size() < mThreadsCount && mThreads.size() < mQueue.size() + mPreparing.size())
+        mThreads.emplace_back(&ImagePreparationPool::WorkerLoop, this);
+    mImageQueued.notify_one();
+}
+
+EStatusCode ImagePreparationPool::Wait(PreparedImage *inImage)
+{
+    std::unique_lock<std::mutex> lock(mLock);
+
+    auto it = std::find(mQueue.begin(), mQueue.end(), inImage);
+    if (it != mQueue.end())
+    {
+        // not started, no point in waiting for a worker
+        mQueue.erase(it);
+        lock.unlock();
+        inImage->Prepare();
+    }
+    else
+        mImageDone.wait(lock, [this, inImage] { return mPreparing.count(inImage) == 0; });
+
+    return inImage->IsPrepared() ? eSuccess : eFailure;
+}
+
+void ImagePreparationPool::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mStopping = true;
+        mQueue.clear();
+        mImageQueued.notify_all();
+    }
+
+    for (auto &thread : mThreads)
+        thread.join();
+    mThreads.clear();
+    mStopping = false;
+}
+
+void ImagePreparationPool::WorkerLoop()
+{
+    std::unique_lock<std::mutex> lock(mLock);
+
+    while (true)
+    {
+        mImageQueued.wait(lock, [this] { return mStopping || !mQueue.empty(); });
+        if (mStopping)
+            break;
+
+        PreparedImage *image = mQueue.front();
+        mQueue.pop_front();
+        mPreparing.insert(image);
+
+        lock.unlock();
+        image->Prepare();
+        lock.lock();
+
+        mPreparing.erase(image);
+        mImageDone.notify_all();
+    }
+}
@@ -0,0 +1,242 @@
+/*
+   Source File : PreparedImage.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "images/PreparedImage.h"
+#include "PDFImageXObject.h"
+#include "Trace.h"
+#include "WriterStatistics.h"
+#include "images/jpeg/JPEGImageEncoder.h"
+#include "images/jpeg/JPEGImageHandler.h"
+#include "images/pixels/PixelsImageHandler.h"
+#include "images/pixels/PixelsResampling.h"
+#include "images/png/PNGImageHandler.h"
+#include "io/InputDCTDecodeStream.h"
+#include "io/InputFile.h"
+#include "io/InputStringStream.h"
+
+#include <vector>
+
+using namespace charta;
+
+PreparedImage::PreparedImage(const std::string &inImagePath, EHummusImageType inImageType, uint32_t inWidth,
+                             uint32_t inHeight, int inJPEGQuality, ObjectIDType inFirstObjectID,
+                             bool inCompressStreams, WriterStatistics *inStatistics)
+    : mImagePath(inImagePath), mOutputStream(&mBuffer)
+{
+    mImageType = inImageType;
+    mWidth = inWidth;
+    mHeight = inHeight;
+    mJPEGQuality = inJPEGQuality;
+    mFirstObjectID = inFirstObjectID;
+    mImageXObject = nullptr;
+    mReportedBufferedMemory = 0;
+
+    mObjectsContext.SetOutputStream(&mOutputStream);
+    mObjectsContext.SetCompressStreams(inCompressStreams);
+    // the streams are in memory anyway. direct lengths save reserving IDs for length objects
+    mObjectsContext.SetDirectStreamLengths(true);
+    mObjectsContext.SetStatistics(inStatistics);
+    mObjectsContext.SetStatisticsCategory(eWriterStatisticsCategoryImages);
+    mObjectsContext.GetInDirectObjectsRegistry().SetupReservedRange(inFirstObjectID, ObjectsCount);
+}
+
+PreparedImage::~PreparedImage()
+{
+    delete mImageXObject;
+    if (mObjectsContext.GetStatistics() != nullptr)
+        mObjectsContext.GetStatistics()->ReleaseBufferedMemory(mReportedBufferedMemory);
+}
+
+bool PreparedImage::CanPrepare(EHummusImageType inImageType, [[maybe_unused]] bool inDownsample)
+{
+    switch (inImageType)
+    {
+    case eJPG:
+#ifndef LIBCHARTA_NO_DCT
+        return true;
+#else
+        // jpgs are only copied over, no decoding
+        return !inDownsample;
+#endif
+#ifndef LIBCHARTA_NO_PNG
+    case ePNG:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+// decode to 8 bits per component pixels
+static EStatusCode ReadImagePixels(const std::string &inImagePath, EHummusImageType inImageType,
+                                   PixelsBuffer &outPixels)
+{
+    EStatusCode status = eFailure;
+
+    switch (inImageType)
+    {
+#ifndef LIBCHARTA_NO_DCT
+    case eJPG: {
+        JPEGImageHandler jpgHandler;
+        BoolAndJPEGImageInformation jpgImageInformation = jpgHandler.RetrieveImageInformation(inImagePath);
+        // CMYK jpgs are commonly stored inverted, leave them be
+        if (!jpgImageInformation.first || (jpgImageInformation.second.ColorComponentsCount != 1 &&
+                                           jpgImageInformation.second.ColorComponentsCount != 3))
+            break;
+
+        InputFile file;
+        if (file.OpenFile(inImagePath) != eSuccess)
+            break;
+
+        outPixels.Width = (uint32_t)jpgImageInformation.second.SamplesWidth;
+        outPixels.Height = (uint32_t)jpgImageInformation.second.SamplesHeight;
+        outPixels.Layout = jpgImageInformation.second.ColorComponentsCount == 1 ? ePixelsLayoutGray : ePixelsLayoutRGB;
+        outPixels.Pixels.resize((size_t)outPixels.Width * outPixels.Height * outPixels.GetComponentsCount());
+
+        InputDCTDecodeStream decoder(file.GetInputStream());
+        size_t totalRead = 0;
+        while (totalRead < outPixels.Pixels.size() && decoder.NotEnded())
+        {
+            size_t readAmount = decoder.Read(outPixels.Pixels.data() + totalRead, outPixels.Pixels.size() - totalRead);
+            if (readAmount == 0)
+                break;
+            totalRead += readAmount;
+        }
+        // the file owns its stream
+        decoder.Assign(nullptr);
+
+        status = totalRead == outPixels.Pixels.size() ? eSuccess : eFailure;
+        break;
+    }
+#endif
+#ifndef LIBCHARTA_NO_PNG
+    case ePNG: {
+        InputFile file;
+        if (file.OpenFile(inImagePath) != eSuccess)
+            break;
+
+        PNGImageHandler pngHandler;
+        status = pngHandler.ReadImagePixels(file.GetInputStream(), outPixels);
+        break;
+    }
+#endif
+    default: {
+        // no decoding to pixels for other types
+    }
+    }
+
+    return status;
+}
+
+PDFImageXObject *PreparedImage::PrepareImageXObject(ObjectsContext *inObjectsContext, const std::string &inImagePath,
+                                                    EHummusImageType inImageType, uint32_t inWidth,
+                                                    uint32_t inHeight, int inJPEGQuality)
+{
+    // private handlers, the document ones are not to be used from other threads
+    JPEGImageHandler jpgHandler;
+    jpgHandler.SetOperationsContexts(nullptr, inObjectsContext);
+
+    // jpgs kept as they are need no decoding, their data is copied over
+    if (inImageType == eJPG && inWidth == 0)
+    {
+        if (!jpgHandler.RetrieveImageInformation(inImagePath).first)
+        {
+            TRACE_LOG1("charta::PreparedImage::PrepareImageXObject, unable to parse %s", inImagePath.c_str());
+            return nullptr;
+        }
+        return jpgHandler.CreateImageXObjectFromJPGFile(inImagePath);
+    }
+
+    PixelsBuffer pixels;
+    if (ReadImagePixels(inImagePath, inImageType, pixels) != eSuccess)
+    {
+        TRACE_LOG1("charta::PreparedImage::PrepareImageXObject, unable to decode %s", inImagePath.c_str());
+        return nullptr;
+    }
+    if (inWidth != 0)
+        pixels = DownsamplePixels(pixels, inWidth, inHeight);
+
+    if (inImageType == eJPG)
+    {
+#ifndef LIBCHARTA_NO_DCT
+        MyStringBuf jpgData;
+        OutputStringBufferStream jpgWriteStream(&jpgData);
+        if (JPEGImageEncoder(inJPEGQuality).Encode(pixels.Describe(), &jpgWriteStream) != eSuccess)
+            return nullptr;
+
+        // make sure the stream parses before an image object is allocated for it
+        std::string jpgBytes = jpgData.str();
+        InputStringStream jpgReadStream(jpgBytes);
+        if (!jpgHandler.RetrieveImageInformation(&jpgReadStream).first)
+            return nullptr;
+        jpgReadStream.SetPosition(0);
+        return jpgHandler.CreateImageXObjectFromJPGStream(&jpgReadStream);
+#else
+        return nullptr;
+#endif
+    }
+
+    // png stays lossless. flate with predictors, alpha going to the soft mask
+    PixelsImageHandler pixelsHandler;
+    pixelsHandler.SetObjectsContext(inObjectsContext);
+    PixelsImageDescription description = pixels.Describe();
+    description.UsePredictors = true;
+    return pixelsHandler.CreateImageXObjectFromPixels(description);
+}
+
+EStatusCode PreparedImage::Prepare()
+{
+    WriterStatisticsScope statisticsScope(&mObjectsContext, eWriterStatisticsCategoryImages,
+                                          eWriterStatisticsPhaseImageDecoding);
+
+    mImageXObject = PrepareImageXObject(&mObjectsContext, mImagePath, mImageType, mWidth, mHeight, mJPEGQuality);
+
+    WriterStatistics *statistics = mObjectsContext.GetStatistics();
+    if (statistics != nullptr)
+    {
+        mReportedBufferedMemory = (size_t)mBuffer.GetCurrentWritePosition();
+        statistics->AddBufferedMemory(mReportedBufferedMemory);
+    }
+    return mImageXObject != nullptr ? eSuccess : eFailure;
+}
+
+bool PreparedImage::IsPrepared() const
+{
+    return mImageXObject != nullptr;
+}
+
+PDFImageXObject *PreparedImage::GetImageXObject()
+{
+    return mImageXObject;
+}
+
+EStatusCode PreparedImage::WriteTo(ObjectsContext *inTargetObjectsContext)
+{
+    IndirectObjectsReferenceRegistry &targetRegistry = inTargetObjectsContext->GetInDirectObjectsRegistry();
+
+    if (mImageXObject == nullptr)
+    {
+        for (ObjectIDType i = mFirstObjectID; i < mFirstObjectID + ObjectsCount; ++i)
+            targetRegistry.DeleteObject(i);
+        return eFailure;
+    }
+
+    return inTargetObjectsContext->CopyBufferedObjects(mObjectsContext, mBuffer, mFirstObjectID, ObjectsCount);
+}
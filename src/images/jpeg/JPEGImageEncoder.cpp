@@ -0,0 +1,168 @@
+/*
+   Source File : JPEGImageEncoder.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "images/jpeg/JPEGImageEncoder.h"
+#include "Trace.h"
+#include "io/IByteWriter.h"
+
+#ifndef LIBCHARTA_NO_DCT
+
+#include <stdio.h>
+
+#include <jpeglib.h>
+
+class HummusJPGEncodeException
+{
+};
+
+METHODDEF(void) HummusJPGEncodeErrorExit(j_common_ptr cinfo)
+{
+    (*cinfo->err->output_message)(cinfo);
+    throw HummusJPGEncodeException();
+}
+
+METHODDEF(void) HummusJPGEncodeOutputMessage(j_common_ptr cinfo)
+{
+    char buffer[JMSG_LENGTH_MAX];
+
+    (*cinfo->err->format_message)(cinfo, buffer);
+    TRACE_LOG1("HummusJPGEncodeOutputMessage, error from jpg library: %s", buffer);
+}
+
+#define OUTPUT_BUF_SIZE 4096
+
+struct HummusDestinationManager
+{
+    struct jpeg_destination_mgr pub; /* public fields */
+
+    charta::IByteWriter *mWriter; /* target stream */
+    JOCTET buffer[OUTPUT_BUF_SIZE];
+};
+
+METHODDEF(void) HummusInitDestination(j_compress_ptr cinfo)
+{
+    auto *dest = (HummusDestinationManager *)cinfo->dest;
+
+    dest->pub.next_output_byte = dest->buffer;
+    dest->pub.free_in_buffer = OUTPUT_BUF_SIZE;
+}
+
+METHODDEF(boolean) HummusEmptyOutputBuffer(j_compress_ptr cinfo)
+{
+    auto *dest = (HummusDestinationManager *)cinfo->dest;
+
+    // libjpeg expects the whole buffer to go, regardless of free_in_buffer
+    if (dest->mWriter->Write((const uint8_t *)dest->buffer, OUTPUT_BUF_SIZE) != OUTPUT_BUF_SIZE)
+        throw HummusJPGEncodeException();
+
+    dest->pub.next_output_byte = dest->buffer;
+    dest->pub.free_in_buffer = OUTPUT_BUF_SIZE;
+    return TRUE;
+}
+
+METHODDEF(void) HummusTermDestination(j_compress_ptr cinfo)
+{
+    auto *dest = (HummusDestinationManager *)cinfo->dest;
+    size_t remaining = OUTPUT_BUF_SIZE - dest->pub.free_in_buffer;
+
+    if (remaining > 0 && dest->mWriter->Write((const uint8_t *)dest->buffer, remaining) != remaining)
+        throw HummusJPGEncodeException();
+}
+
+charta::JPEGImageEncoder::JPEGImageEncoder(int inQuality)
+{
+    mQuality = inQuality;
+}
+
+charta::EStatusCode charta::JPEGImageEncoder::Encode(const PixelsImageDescription &inPixels,
+                                                     IByteWriter *inOutputStream)
+{
+    int components = 0;
+    J_COLOR_SPACE colorSpace = JCS_UNKNOWN;
+
+    switch (inPixels.Layout)
+    {
+    case ePixelsLayoutGray:
+        components = 1;
+        colorSpace = JCS_GRAYSCALE;
+        break;
+    case ePixelsLayoutRGB:
+        components = 3;
+        colorSpace = JCS_RGB;
+        break;
+    case ePixelsLayoutCMYK:
+        components = 4;
+        colorSpace = JCS_CMYK;
+        break;
+    default:
+        break;
+    }
+    if (components == 0 || inPixels.BitsPerComponent != 8 || inPixels.Pixels == nullptr)
+    {
+        TRACE_LOG("charta::JPEGImageEncoder::Encode, only 8 bits gray, RGB or CMYK pixels can be encoded");
+        return eFailure;
+    }
+
+    size_t stride = inPixels.Stride != 0 ? inPixels.Stride : (size_t)inPixels.Width * components;
+    jpeg_compress_struct jpgState;
+    jpeg_error_mgr jpgError;
+    HummusDestinationManager destination;
+    EStatusCode status = eSuccess;
+
+    jpgState.err = jpeg_std_error(&jpgError);
+    jpgError.error_exit = HummusJPGEncodeErrorExit;
+    jpgError.output_message = HummusJPGEncodeOutputMessage;
+
+    try
+    {
+        jpeg_create_compress(&jpgState);
+
+        destination.pub.init_destination = HummusInitDestination;
+        destination.pub.empty_output_buffer = HummusEmptyOutputBuffer;
+        destination.pub.term_destination = HummusTermDestination;
+        destination.mWriter = inOutputStream;
+        jpgState.dest = &destination.pub;
+
+        jpgState.image_width = inPixels.Width;
+        jpgState.image_height = inPixels.Height;
+        jpgState.input_components = components;
+        jpgState.in_color_space = colorSpace;
+        jpeg_set_defaults(&jpgState);
+        jpeg_set_quality(&jpgState, mQuality, TRUE);
+
+        jpeg_start_compress(&jpgState, TRUE);
+        while (jpgState.next_scanline < jpgState.image_height)
+        {
+            auto row = (JSAMPROW)(inPixels.Pixels + jpgState.next_scanline * stride);
+            jpeg_write_scanlines(&jpgState, &row, 1);
+        }
+        jpeg_finish_compress(&jpgState);
+    }
+    catch (HummusJPGEncodeException)
+    {
+        TRACE_LOG("charta::JPEGImageEncoder::Encode, caught exception in jpg encoding");
+        status = eFailure;
+    }
+
+    jpeg_destroy_compress(&jpgState);
+    return status;
+}
+
+#endif
@@ -0,0 +1,404 @@
+/*
+   Source File : PixelsImageHandler.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "images/pixels/PixelsImageHandler.h"
+#include "DictionaryContext.h"
+#include "EStatusCode.h"
+#include "ObjectsContext.h"
+#include "PDFImageXObject.h"
+#include "PDFStream.h"
+#include "ProcsetResourcesConstants.h"
+#include "Trace.h"
+#include "io/IByteWriter.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+charta::PixelsImageHandler::PixelsImageHandler()
+{
+    mObjectsContext = nullptr;
+}
+
+void charta::PixelsImageHandler::SetObjectsContext(ObjectsContext *inObjectsContext)
+{
+    mObjectsContext = inObjectsContext;
+}
+
+static const std::string scType = "Type";
+static const std::string scXObject = "XObject";
+static const std::string scSubType = "Subtype";
+static const std::string scImage = "Image";
+static const std::string scWidth = "Width";
+static const std::string scHeight = "Height";
+static const std::string scColorSpace = "ColorSpace";
+static const std::string scDeviceGray = "DeviceGray";
+static const std::string scDeviceRGB = "DeviceRGB";
+static const std::string scDeviceCMYK = "DeviceCMYK";
+static const std::string scBitsPerComponent = "BitsPerComponent";
+static const std::string scSMask = "SMask";
+static const std::string scDecodeParms = "DecodeParms";
+static const std::string scPredictor = "Predictor";
+static const std::string scColors = "Colors";
+static const std::string scColumns = "Columns";
+
+// PNG predictor in DecodeParms, for rows that each carry their own filter type
+static const int scPNGOptimumPredictor = 15;
+
+static int PaethPredictor(int inLeft, int inAbove, int inAboveLeft)
+{
+    int estimate = inLeft + inAbove - inAboveLeft;
+    int distanceLeft = abs(estimate - inLeft);
+    int distanceAbove = abs(estimate - inAbove);
+    int distanceAboveLeft = abs(estimate - inAboveLeft);
+
+    if (distanceLeft <= distanceAbove && distanceLeft <= distanceAboveLeft)
+        return inLeft;
+    if (distanceAbove <= distanceAboveLeft)
+        return inAbove;
+    return inAboveLeft;
+}
+
+/*
+    Writes rows of samples to an image stream. With predictors each row is filtered with the PNG filter that scores
+    best for it (the smallest sum of absolute differences, the same heuristic libpng uses), and prefixed with the
+    filter type. Rows are written from wherever they are, so the previous row must stay put till the next one is
+    written.
+*/
+class PixelsRowsWriter
+{
+  public:
+    PixelsRowsWriter(charta::IByteWriter *inStream, size_t inRowBytes, size_t inBytesPerPixel, bool inUsePredictors)
+        : mStream(inStream), mRowBytes(inRowBytes), mBytesPerPixel(inBytesPerPixel), mUsePredictors(inUsePredictors),
+          mPreviousRow(nullptr)
+    {
+        if (mUsePredictors)
+        {
+            mZeroRow.resize(mRowBytes, 0);
+            for (auto &filtered : mFilteredRows)
+                filtered.resize(mRowBytes + 1);
+        }
+    }
+
+    charta::EStatusCode WriteRow(const uint8_t *inRow)
+    {
+        if (!mUsePredictors)
+            return mStream->Write(inRow, mRowBytes) == mRowBytes ? charta::eSuccess : charta::eFailure;
+
+        const uint8_t *above = mPreviousRow != nullptr ? mPreviousRow : mZeroRow.data();
+        size_t bestFilter = 0;
+        unsigned long long bestScore = 0;
+
+        for (size_t filter = 0; filter < 5; ++filter)
+        {
+            uint8_t *filtered = mFilteredRows[filter].data();
+            unsigned long long score = 0;
+
+            filtered[0] = (uint8_t)filter;
+            for (size_t i = 0; i < mRowBytes; ++i)
+            {
+                int left = i >= mBytesPerPixel ? inRow[i - mBytesPerPixel] : 0;
+                int aboveLeft = i >= mBytesPerPixel ? above[i - mBytesPerPixel] : 0;
+                int prediction = 0;
+
+                switch (filter)
+                {
+                case 1:
+                    prediction = left;
+                    break;
+                case 2:
+                    prediction = above[i];
+                    break;
+                case 3:
+                    prediction = (left + above[i]) / 2;
+                    break;
+                case 4:
+                    prediction = PaethPredictor(left, above[i], aboveLeft);
+                    break;
+                default:
+                    break;
+                }
+                filtered[i + 1] = (uint8_t)(inRow[i] - prediction);
+                score += abs((int8_t)filtered[i + 1]);
+            }
+
+            if (filter == 0 || score < bestScore)
+            {
+                bestFilter = filter;
+                bestScore = score;
+            }
+        }
+
+        mPreviousRow = inRow;
+        return mStream->Write(mFilteredRows[bestFilter].data(), mRowBytes + 1) == mRowBytes + 1 ? charta::eSuccess
+                                                                                                : charta::eFailure;
+    }
+
+  private:
+    charta::IByteWriter *mStream;
+    size_t mRowBytes;
+    size_t mBytesPerPixel;
+    bool mUsePredictors;
+    const uint8_t *mPreviousRow;
+    std::vector<uint8_t> mZeroRow;
+    std::vector<uint8_t> mFilteredRows[5];
+};
+
+// copy a run of components out of each pixel of a row. used to split color from alpha
+static void ExtractComponents(const uint8_t *inRow, uint8_t *outRow, uint32_t inWidth, size_t inPixelBytes,
+                              size_t inOffset, size_t inLength)
+{
+    for (uint32_t i = 0; i < inWidth; ++i)
+    {
+        memcpy(outRow, inRow + inOffset, inLength);
+        inRow += inPixelBytes;
+        outRow += inLength;
+    }
+}
+
+/*
+    Writes one image xobject out of the pixels - either the color components, or (with inAlpha) the alpha channel
+    as a gray soft mask. Rows that can be taken as is are written straight from the caller's memory, otherwise the
+    wanted components are gathered a row at a time.
+*/
+static charta::EStatusCode WritePixelsImage(ObjectsContext *inObjectsContext, ObjectIDType inImageXObjectID,
+                                            const charta::PixelsImageDescription &inPixels, size_t inComponents,
+                                            size_t inColorComponents, bool inAlpha, ObjectIDType inSMaskObjectID)
+{
+    size_t outputComponents = inAlpha ? 1 : inColorComponents;
+    size_t sampleBytes = inPixels.BitsPerComponent == 16 ? 2 : 1;
+    size_t sourceRowBytes = ((size_t)inPixels.Width * inComponents * inPixels.BitsPerComponent + 7) / 8;
+    size_t rowBytes = ((size_t)inPixels.Width * outputComponents * inPixels.BitsPerComponent + 7) / 8;
+    size_t stride = inPixels.Stride != 0 ? inPixels.Stride : sourceRowBytes;
+    size_t bytesPerPixel = (outputComponents * inPixels.BitsPerComponent + 7) / 8;
+    bool usePredictors = inPixels.UsePredictors && inObjectsContext->IsCompressingStreams();
+
+    inObjectsContext->StartNewIndirectObject(inImageXObjectID);
+    DictionaryContext *imageContext = inObjectsContext->StartDictionary();
+
+    // type
+    imageContext->WriteKey(scType);
+    imageContext->WriteNameValue(scXObject);
+
+    // subtype
+    imageContext->WriteKey(scSubType);
+    imageContext->WriteNameValue(scImage);
+
+    // Width
+    imageContext->WriteKey(scWidth);
+    imageContext->WriteIntegerValue(inPixels.Width);
+
+    // Height
+    imageContext->WriteKey(scHeight);
+    imageContext->WriteIntegerValue(inPixels.Height);
+
+    // Bits Per Component
+    imageContext->WriteKey(scBitsPerComponent);
+    imageContext->WriteIntegerValue(inPixels.BitsPerComponent);
+
+    // Color Space
+    imageContext->WriteKey(scColorSpace);
+    imageContext->WriteNameValue(outputComponents == 1   ? scDeviceGray
+                                 : outputComponents == 3 ? scDeviceRGB
+                                                         : scDeviceCMYK);
+
+    // Mask in case of Alpha
+    if (inSMaskObjectID != 0)
+    {
+        imageContext->WriteKey(scSMask);
+        imageContext->WriteNewObjectReferenceValue(inSMaskObjectID);
+    }
+
+    // DecodeParms, for the rows filters
+    if (usePredictors)
+    {
+        imageContext->WriteKey(scDecodeParms);
+        DictionaryContext *decodeParmsDictionary = inObjectsContext->StartDictionary();
+
+        decodeParmsDictionary->WriteKey(scPredictor);
+        decodeParmsDictionary->WriteIntegerValue(scPNGOptimumPredictor);
+
+        decodeParmsDictionary->WriteKey(scColumns);
+        decodeParmsDictionary->WriteIntegerValue(inPixels.Width);
+
+        decodeParmsDictionary->WriteKey(scColors);
+        decodeParmsDictionary->WriteIntegerValue(outputComponents);
+
+        decodeParmsDictionary->WriteKey(scBitsPerComponent);
+        decodeParmsDictionary->WriteIntegerValue(inPixels.BitsPerComponent);
+
+        inObjectsContext->EndDictionary(decodeParmsDictionary);
+    }
+
+    std::shared_ptr<PDFStream> imageStream = inObjectsContext->StartPDFStream(imageContext);
+    charta::EStatusCode status = charta::eSuccess;
+
+    if (inComponents == outputComponents && !usePredictors && stride == rowBytes)
+    {
+        // packed tight, write all in one go
+        size_t imageBytes = rowBytes * inPixels.Height;
+        if (imageStream->GetWriteStream()->Write(inPixels.Pixels, imageBytes) != imageBytes)
+            status = charta::eFailure;
+    }
+    else
+    {
+        PixelsRowsWriter rowsWriter(imageStream->GetWriteStream(), rowBytes, bytesPerPixel, usePredictors);
+        size_t pixelBytes = inComponents * sampleBytes;
+        size_t offset = inAlpha ? inColorComponents * sampleBytes : 0;
+        std::vector<uint8_t> gatheredRows[2];
+
+        if (inComponents != outputComponents)
+        {
+            gatheredRows[0].resize(rowBytes);
+            gatheredRows[1].resize(rowBytes);
+        }
+
+        const uint8_t *sourceRow = inPixels.Pixels;
+        for (uint32_t y = 0; y < inPixels.Height && status == charta::eSuccess; ++y)
+        {
+            const uint8_t *row = sourceRow;
+            if (inComponents != outputComponents)
+            {
+                // alternate buffers, so the previous row is still there for the predictors
+                uint8_t *gathered = gatheredRows[y % 2].data();
+                ExtractComponents(sourceRow, gathered, inPixels.Width, pixelBytes, offset,
+                                  outputComponents * sampleBytes);
+                row = gathered;
+            }
+            status = rowsWriter.WriteRow(row);
+            sourceRow += stride;
+        }
+    }
+
+    inObjectsContext->EndPDFStream(imageStream);
+    return status;
+}
+
+// check the description, and tell its components count, color and all
+static bool ReadPixelsComponents(const charta::PixelsImageDescription &inPixels, size_t &outComponents,
+                                 size_t &outColorComponents)
+{
+    outComponents = outColorComponents = 0;
+    switch (inPixels.Layout)
+    {
+    case charta::ePixelsLayoutGray:
+        outComponents = outColorComponents = 1;
+        break;
+    case charta::ePixelsLayoutGrayAlpha:
+        outComponents = 2;
+        outColorComponents = 1;
+        break;
+    case charta::ePixelsLayoutRGB:
+        outComponents = outColorComponents = 3;
+        break;
+    case charta::ePixelsLayoutRGBA:
+        outComponents = 4;
+        outColorComponents = 3;
+        break;
+    case charta::ePixelsLayoutCMYK:
+        outComponents = outColorComponents = 4;
+        break;
+    }
+
+    if (outComponents == 0 || inPixels.Pixels == nullptr || inPixels.Width == 0 || inPixels.Height == 0)
+    {
+        TRACE_LOG("charta::PixelsImageHandler::CreateImageXObjectFromPixels, no pixels to write");
+        return false;
+    }
+
+    int bits = inPixels.BitsPerComponent;
+    if ((bits != 1 && bits != 2 && bits != 4 && bits != 8 && bits != 16) ||
+        (outComponents != outColorComponents && bits < 8))
+    {
+        TRACE_LOG1("charta::PixelsImageHandler::CreateImageXObjectFromPixels, unsupported bits per component - %d",
+                   bits);
+        return false;
+    }
+
+    size_t rowBytes = ((size_t)inPixels.Width * outComponents * bits + 7) / 8;
+    if (inPixels.Stride != 0 && inPixels.Stride < rowBytes)
+    {
+        TRACE_LOG2("charta::PixelsImageHandler::CreateImageXObjectFromPixels, stride %ld is shorter than a row of %ld "
+                   "bytes",
+                   (long)inPixels.Stride, (long)rowBytes);
+        return false;
+    }
+    return true;
+}
+
+PDFImageXObject *charta::PixelsImageHandler::CreateImageXObjectFromPixels(const PixelsImageDescription &inPixels)
+{
+    if (mObjectsContext == nullptr)
+    {
+        TRACE_LOG("charta::PixelsImageHandler::CreateImageXObjectFromPixels. Unexpected Error, mObjectsContext not "
+                  "initialized with an objects context");
+        return nullptr;
+    }
+
+    // check before allocating an ID, so a bad description does not leave behind an object that is never written
+    size_t components, colorComponents;
+    if (!ReadPixelsComponents(inPixels, components, colorComponents))
+        return nullptr;
+
+    return CreateImageXObjectFromPixels(inPixels, mObjectsContext->GetInDirectObjectsRegistry().AllocateNewObjectID());
+}
+
+PDFImageXObject *charta::PixelsImageHandler::CreateImageXObjectFromPixels(const PixelsImageDescription &inPixels,
+                                                                          ObjectIDType inImageXObjectID)
+{
+    PDFImageXObject *imageXObject = nullptr;
+
+    do
+    {
+        if (mObjectsContext == nullptr)
+        {
+            TRACE_LOG("charta::PixelsImageHandler::CreateImageXObjectFromPixels. Unexpected Error, mObjectsContext "
+                      "not initialized with an objects context");
+            break;
+        }
+
+        size_t components, colorComponents;
+        if (!ReadPixelsComponents(inPixels, components, colorComponents))
+            break;
+        bool hasAlpha = components != colorComponents;
+
+        ObjectIDType sMaskObjectID =
+            hasAlpha ? mObjectsContext->GetInDirectObjectsRegistry().AllocateNewObjectID() : 0;
+
+        if (WritePixelsImage(mObjectsContext, inImageXObjectID, inPixels, components, colorComponents, false,
+                             sMaskObjectID) != charta::eSuccess)
+        {
+            TRACE_LOG("charta::PixelsImageHandler::CreateImageXObjectFromPixels, failed to write image samples");
+            break;
+        }
+
+        // if there's a soft mask, write it now
+        if (hasAlpha && WritePixelsImage(mObjectsContext, sMaskObjectID, inPixels, components, colorComponents, true,
+                                         0) != charta::eSuccess)
+        {
+            TRACE_LOG("charta::PixelsImageHandler::CreateImageXObjectFromPixels, failed to write soft mask samples");
+            break;
+        }
+
+        imageXObject = new PDFImageXObject(inImageXObjectID, 1 == colorComponents ? KProcsetImageB : KProcsetImageC);
+    } while (false);
+
+    return imageXObject;
+}
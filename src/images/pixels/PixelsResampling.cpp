@@ -0,0 +1,175 @@
+/*
+   Source File : PixelsResampling.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "images/pixels/PixelsResampling.h"
+
+#include <algorithm>
+
+size_t charta::PixelsBuffer::GetComponentsCount() const
+{
+    switch (Layout)
+    {
+    case ePixelsLayoutGray:
+        return 1;
+    case ePixelsLayoutGrayAlpha:
+        return 2;
+    case ePixelsLayoutRGB:
+        return 3;
+    case ePixelsLayoutRGBA:
+    case ePixelsLayoutCMYK:
+        return 4;
+    }
+    return 0;
+}
+
+charta::PixelsImageDescription charta::PixelsBuffer::Describe() const
+{
+    PixelsImageDescription description;
+
+    description.Pixels = Pixels.data();
+    description.Width = Width;
+    description.Height = Height;
+    description.Layout = Layout;
+    description.BitsPerComponent = 8;
+    return description;
+}
+
+// weights are 16 bits fixed point, summing to exactly 1 for each target sample
+static const uint32_t scWeightOne = 1 << 16;
+
+// the source samples each target sample averages, with their weights. flattened - the contributions of target
+// sample i are at [mStarts[i], mStarts[i + 1])
+struct AreaContributions
+{
+    std::vector<uint32_t> mStarts;
+    std::vector<uint32_t> mIndexes;
+    std::vector<uint32_t> mWeights;
+};
+
+static AreaContributions ComputeAreaContributions(uint32_t inSourceSize, uint32_t inTargetSize)
+{
+    AreaContributions contributions;
+
+    // measured in 1/(source * target) units, source sample k spans [k * target, (k + 1) * target) and target sample
+    // i spans [i * source, (i + 1) * source), so overlaps are exact integers
+    uint64_t source = inSourceSize;
+    uint64_t target = inTargetSize;
+
+    contributions.mStarts.reserve(inTargetSize + 1);
+    for (uint64_t i = 0; i < target; ++i)
+    {
+        uint64_t areaStart = i * source;
+        uint64_t areaEnd = areaStart + source;
+        uint32_t weightsSum = 0;
+
+        contributions.mStarts.push_back((uint32_t)contributions.mIndexes.size());
+        for (uint64_t k = areaStart / target; k < source && k * target < areaEnd; ++k)
+        {
+            uint64_t overlapStart = std::max(areaStart, k * target);
+            uint64_t overlapEnd = std::min(areaEnd, (k + 1) * target);
+            uint32_t weight = (uint32_t)((overlapEnd - overlapStart) * scWeightOne / source);
+
+            contributions.mIndexes.push_back((uint32_t)k);
+            contributions.mWeights.push_back(weight);
+            weightsSum += weight;
+        }
+
+        // rounding leftovers go to the last contribution
+        contributions.mWeights.back() += scWeightOne - weightsSum;
+    }
+    contributions.mStarts.push_back((uint32_t)contributions.mIndexes.size());
+    return contributions;
+}
+
+/*
+    Averages one source row to the target width. results keep 8 fractional bits, for the vertical pass to use.
+    source samples are at most 255, so sums of them by weights summing to 1 << 16 fit in 32 bits
+*/
+static void DownsampleRow(const uint8_t *inSourceRow, size_t inComponents, const AreaContributions &inColumns,
+                          uint32_t inTargetWidth, uint16_t *outRow)
+{
+    uint32_t sums[4];
+
+    for (uint32_t x = 0; x < inTargetWidth; ++x)
+    {
+        for (size_t c = 0; c < inComponents; ++c)
+            sums[c] = 0;
+        for (uint32_t j = inColumns.mStarts[x]; j < inColumns.mStarts[x + 1]; ++j)
+        {
+            const uint8_t *sample = inSourceRow + inColumns.mIndexes[j] * inComponents;
+            uint32_t weight = inColumns.mWeights[j];
+            for (size_t c = 0; c < inComponents; ++c)
+                sums[c] += weight * sample[c];
+        }
+        for (size_t c = 0; c < inComponents; ++c)
+            *(outRow++) = (uint16_t)((sums[c] + (1 << 7)) >> 8);
+    }
+}
+
+charta::PixelsBuffer charta::DownsamplePixels(const PixelsBuffer &inSource, uint32_t inWidth, uint32_t inHeight)
+{
+    PixelsBuffer target;
+    size_t components = inSource.GetComponentsCount();
+
+    target.Layout = inSource.Layout;
+    if (inWidth == 0 || inHeight == 0 || inWidth > inSource.Width || inHeight > inSource.Height)
+        return target;
+
+    target.Width = inWidth;
+    target.Height = inHeight;
+    target.Pixels.resize((size_t)inWidth * inHeight * components);
+
+    AreaContributions columns = ComputeAreaContributions(inSource.Width, inWidth);
+    AreaContributions rows = ComputeAreaContributions(inSource.Height, inHeight);
+    size_t sourceRowBytes = (size_t)inSource.Width * components;
+    size_t targetRowSamples = (size_t)inWidth * components;
+
+    // consecutive target rows share at most one source row, so a single downsampled row is kept for reuse
+    std::vector<uint16_t> downsampledRow(targetRowSamples);
+    std::vector<uint32_t> sums(targetRowSamples);
+    uint32_t downsampledRowIndex = UINT32_MAX;
+
+    for (uint32_t y = 0; y < inHeight; ++y)
+    {
+        std::fill(sums.begin(), sums.end(), 0);
+        for (uint32_t j = rows.mStarts[y]; j < rows.mStarts[y + 1]; ++j)
+        {
+            if (rows.mIndexes[j] != downsampledRowIndex)
+            {
+                downsampledRowIndex = rows.mIndexes[j];
+                DownsampleRow(inSource.Pixels.data() + downsampledRowIndex * sourceRowBytes, components, columns,
+                              inWidth, downsampledRow.data());
+            }
+
+            // 8.8 samples by 16 bits weights summing to 1 << 16 stay within 32 bits
+            uint32_t weight = rows.mWeights[j];
+            const uint16_t *samples = downsampledRow.data();
+            uint32_t *rowSums = sums.data();
+            for (size_t i = 0; i < targetRowSamples; ++i)
+                rowSums[i] += weight * samples[i];
+        }
+
+        uint8_t *targetRow = target.Pixels.data() + y * targetRowSamples;
+        for (size_t i = 0; i < targetRowSamples; ++i)
+            targetRow[i] = (uint8_t)((sums[i] + (1 << 23)) >> 24);
+    }
+
+    return target;
+}
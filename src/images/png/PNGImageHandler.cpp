@@ -32,6 +32,7 @@
 #include "SafeBufferMacrosDefs.h"
 #include "Trace.h"
 #include "XObjectContentContext.h"
+#include "images/pixels/PixelsResampling.h"
 #include "io/InputStringBufferStream.h"
 #include "io/OutputStreamTraits.h"
 #include "io/OutputStringBufferStream.h"
@@ -39,6 +40,7 @@
 
 #include <list>
 #include <stdlib.h>
+#include <vector>
 
 using PDFImageXObjectList = std::list<PDFImageXObject *>;
 
@@ -548,4 +550,91 @@ charta::PNGImageHandler::PNGImageInfo charta::PNGImageHandler::ReadImageInfo(
     return data;
 }
 
+charta::EStatusCode charta::PNGImageHandler::ReadImagePixels(charta::IByteReaderWithPosition *inPNGStream,
+                                                             PixelsBuffer &outPixels)
+{
+    EStatusCode status = eSuccess;
+    png_structp png_ptr = nullptr;
+    png_infop info_ptr = nullptr;
+    std::vector<png_bytep> rows;
+
+    do
+    {
+        // init structs and prep
+        png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, HandlePngError, HandlePngWarning);
+        if (png_ptr == nullptr)
+        {
+            status = eFailure;
+            break;
+        }
+
+        if (setjmp(png_jmpbuf(png_ptr)))
+        {
+            status = eFailure;
+            break;
+        }
+
+        // pair png with custom IO (dont bother with writing)
+        png_set_read_fn(png_ptr, (png_voidp)inPNGStream, ReadDataFromStream);
+
+        // create info struct
+        info_ptr = png_create_info_struct(png_ptr);
+        if (info_ptr == nullptr)
+        {
+            png_error(png_ptr, "OOM allocating info structure");
+        }
+
+        // read info from png
+        png_read_info(png_ptr, info_ptr);
+
+        png_byte color_type = png_get_color_type(png_ptr, info_ptr);
+        png_byte bit_depth = png_get_bit_depth(png_ptr, info_ptr);
+
+        // same transformations as when embedding, to end up with 8 bits per component
+        if (color_type == PNG_COLOR_TYPE_PALETTE)
+            png_set_palette_to_rgb(png_ptr);
+        if (color_type == PNG_COLOR_TYPE_GRAY && bit_depth < 8)
+            png_set_expand_gray_1_2_4_to_8(png_ptr);
+        if (png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS) != 0u)
+            png_set_tRNS_to_alpha(png_ptr);
+        if (bit_depth == 16)
+            png_set_strip_16(png_ptr);
+        if (bit_depth < 8)
+            png_set_packing(png_ptr);
+        png_set_interlace_handling(png_ptr);
+        png_read_update_info(png_ptr, info_ptr);
+
+        png_byte channels_count = png_get_channels(png_ptr, info_ptr);
+        outPixels.Width = png_get_image_width(png_ptr, info_ptr);
+        outPixels.Height = png_get_image_height(png_ptr, info_ptr);
+        switch (channels_count)
+        {
+        case 1:
+            outPixels.Layout = ePixelsLayoutGray;
+            break;
+        case 2:
+            outPixels.Layout = ePixelsLayoutGrayAlpha;
+            break;
+        case 3:
+            outPixels.Layout = ePixelsLayoutRGB;
+            break;
+        default:
+            outPixels.Layout = ePixelsLayoutRGBA;
+            break;
+        }
+
+        // read the whole image at once, which also takes care of interlacing
+        size_t rowBytes = (size_t)outPixels.Width * channels_count;
+        outPixels.Pixels.resize(rowBytes * outPixels.Height);
+        rows.resize(outPixels.Height);
+        for (png_uint_32 y = 0; y < outPixels.Height; ++y)
+            rows[y] = outPixels.Pixels.data() + y * rowBytes;
+        png_read_image(png_ptr, rows.data());
+        png_read_end(png_ptr, nullptr);
+    } while (false);
+
+    png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
+    return status;
+}
+
 #endif
\ No newline at end of file
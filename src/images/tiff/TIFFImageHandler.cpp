@@ -139,6 +139,7 @@ using t2p_err_t = enum {
 struct T2P_PAGE
 {
     tdir_t page_directory;
+    toff_t page_diroffset;
     uint32 page_number;
     ttile_t page_tilecount;
     uint32 page_extra;
@@ -146,6 +147,7 @@ struct T2P_PAGE
     T2P_PAGE()
     {
         page_directory = 0;
+        page_diroffset = 0;
         page_number = 0;
         page_tilecount = 0;
         page_extra = 0;
@@ -428,6 +430,22 @@ PDFFormXObject *charta::TIFFImageHandler::CreateFormXObjectFromTIFFFile(
     return CreateFormXObjectFromTIFFStream(tiffFile.GetInputStream(), inFormXObjectID, inTIFFUsageParameters);
 }
 
+charta::PDFFormXObjectVector charta::TIFFImageHandler::CreateFormXObjectsFromTIFFFile(
+    const std::string &inTIFFFilePath, const std::vector<unsigned long> &inPageIndexes,
+    const TIFFUsageParameters &inTIFFUsageParameters)
+{
+    InputFile tiffFile;
+
+    if (tiffFile.OpenFile(inTIFFFilePath) != charta::eSuccess)
+    {
+        TRACE_LOG1("charta::TIFFImageHandler::CreateFormXObjectsFromTIFFFile. cannot open file for reading - %s",
+                   inTIFFFilePath.c_str());
+        return PDFFormXObjectVector();
+    }
+
+    return CreateFormXObjectsFromTIFFStream(tiffFile.GetInputStream(), inPageIndexes, inTIFFUsageParameters);
+}
+
 void charta::TIFFImageHandler::InitializeConversionState()
 {
 
@@ -478,9 +496,13 @@ PDFFormXObject *charta::TIFFImageHandler::ConvertTiff2PDF(ObjectIDType inFormXOb
 
     do
     {
-        status = ReadTopLevelTiffInformation();
-        if (status != charta::eSuccess)
-            break;
+        // multi page conversions index the directories once, and reuse the index for each page
+        if (mT2p->tiff_pages == nullptr)
+        {
+            status = ReadTopLevelTiffInformation();
+            if (status != charta::eSuccess)
+                break;
+        }
 
         if (mT2p->pdf_page >= mT2p->tiff_pagecount)
         {
@@ -601,10 +623,11 @@ charta::EStatusCode charta::TIFFImageHandler::ReadTopLevelTiffInformation()
             bool isPage = false, isPage2 = false;
             uint32 subfiletype = 0;
 
-            if (TIFFSetDirectory(mT2p->input, i) == 0)
+            // read the directories in sequence, recording their offsets so pages can later be reached directly
+            // rather than by walking the directories chain from the start once more
+            if ((i == 0 ? TIFFSetDirectory(mT2p->input, 0) : TIFFReadDirectory(mT2p->input)) == 0)
             {
-                TRACE_LOG2("Can't set directory %u of input file %s", directorycount * sizeof(T2P_PAGE),
-                           mT2p->inputFilePath.c_str());
+                TRACE_LOG2("Can't set directory %u of input file %s", i, mT2p->inputFilePath.c_str());
                 status = charta::eFailure;
                 break;
             }
@@ -628,6 +651,7 @@ charta::EStatusCode charta::TIFFImageHandler::ReadTopLevelTiffInformation()
                 isPage2 = true;
             }
 
+            mT2p->tiff_pages[mT2p->tiff_pagecount].page_diroffset = TIFFCurrentDirOffset(mT2p->input);
             if (isPage)
                 mT2p->tiff_pages[mT2p->tiff_pagecount].page_number = mT2p->tiff_pagecount;
             if (isPage || isPage2)
@@ -647,7 +671,7 @@ charta::EStatusCode charta::TIFFImageHandler::ReadTopLevelTiffInformation()
 
         for (i = 0; i < mT2p->tiff_pagecount; i++)
         {
-            TIFFSetDirectory(mT2p->input, mT2p->tiff_pages[i].page_directory);
+            TIFFSetSubDirectory(mT2p->input, mT2p->tiff_pages[i].page_diroffset);
             if (((TIFFGetField(mT2p->input, TIFFTAG_PHOTOMETRIC, &xuint16) != 0) && (xuint16 == PHOTOMETRIC_PALETTE)) ||
                 (TIFFGetField(mT2p->input, TIFFTAG_INDEXED, &xuint16) != 0))
             {
@@ -711,7 +735,7 @@ charta::EStatusCode charta::TIFFImageHandler::ReadTIFFPageInformation() // t2p_r
     float *xfloatp;
 
     mT2p->pdf_transcode = T2P_TRANSCODE_ENCODE;
-    TIFFSetDirectory(mT2p->input, mT2p->tiff_pages[mT2p->pdf_page].page_directory);
+    TIFFSetSubDirectory(mT2p->input, mT2p->tiff_pages[mT2p->pdf_page].page_diroffset);
     TIFFGetField(mT2p->input, TIFFTAG_IMAGEWIDTH, &(mT2p->tiff_width));
 
     do
@@ -3266,6 +3290,98 @@ PDFFormXObject *charta::TIFFImageHandler::CreateFormXObjectFromTIFFStream(
     return imageFormXObject;
 }
 
+charta::PDFFormXObjectVector charta::TIFFImageHandler::CreateFormXObjectsFromTIFFStream(
+    charta::IByteReaderWithPosition *inTIFFStream, const std::vector<unsigned long> &inPageIndexes,
+    const TIFFUsageParameters &inTIFFUsageParameters)
+{
+    PDFFormXObjectVector imageFormXObjects;
+    TIFF *input = nullptr;
+
+    do
+    {
+        TIFFSetErrorHandler(ReportError);
+        TIFFSetWarningHandler(ReportWarning);
+
+        if ((mObjectsContext == nullptr) || (mContainerDocumentContext == nullptr))
+        {
+            TRACE_LOG("charta::TIFFImageHandler::CreateFormXObjectsFromTIFFStream. Unexpected Error, mObjectsContext "
+                      "or mContainerDocumentContext not initialized");
+            break;
+        }
+
+        StreamWithPos streamInfo;
+        streamInfo.mStream = inTIFFStream;
+        streamInfo.mOriginalPosition = inTIFFStream->GetCurrentPosition();
+
+        input =
+            TIFFClientOpen("Stream", "r", (thandle_t)&streamInfo, STATIC_streamRead, STATIC_streamWrite,
+                           STATIC_streamSeek, STATIC_streamClose, STATIC_tiffSize, STATIC_tiffMap, STATIC_tiffUnmap);
+        if (input == nullptr)
+        {
+            TRACE_LOG("charta::TIFFImageHandler::CreateFormXObjectsFromTIFFStream. cannot open stream for reading");
+            break;
+        }
+
+        // open and index once, then convert the pages one after the other
+        InitializeConversionState();
+        mT2p->input = input;
+        mT2p->inputFilePath = "";
+        mUserParameters = inTIFFUsageParameters;
+
+        if (ReadTopLevelTiffInformation() != charta::eSuccess)
+            break;
+
+        std::vector<unsigned long> pageIndexes = inPageIndexes;
+        if (pageIndexes.empty())
+        {
+            for (unsigned long i = 0; i < (unsigned long)mT2p->tiff_pagecount; ++i)
+                pageIndexes.push_back(i);
+        }
+
+        auto it = pageIndexes.begin();
+        for (; it != pageIndexes.end(); ++it)
+        {
+            // check before narrowing to tdir_t, so a large index can't wrap around into a valid page
+            if (*it >= (unsigned long)mT2p->tiff_pagecount)
+            {
+                TRACE_LOG2("charta::TIFFImageHandler::CreateFormXObjectsFromTIFFStream, Requested tiff page %lu where "
+                           "the tiff only has %u pages",
+                           *it, mT2p->tiff_pagecount);
+                imageFormXObjects.push_back(nullptr);
+                continue;
+            }
+
+            ResetPageConversionState();
+            mT2p->pdf_page = (tdir_t)*it;
+            imageFormXObjects.push_back(
+                ConvertTiff2PDF(mObjectsContext->GetInDirectObjectsRegistry().AllocateNewObjectID()));
+        }
+    } while (false);
+
+    DestroyConversionState();
+    if (input != nullptr)
+        TIFFClose(input);
+
+    return imageFormXObjects;
+}
+
+void charta::TIFFImageHandler::ResetPageConversionState()
+{
+    // fresh per page state, keeping the input and the pages index
+    T2P *previous = mT2p;
+
+    InitializeConversionState();
+    mT2p->input = previous->input;
+    mT2p->inputFilePath = previous->inputFilePath;
+    mT2p->tiff_pages = previous->tiff_pages;
+    mT2p->tiff_tiles = previous->tiff_tiles;
+    mT2p->tiff_pagecount = previous->tiff_pagecount;
+
+    if (previous->pdf_palette != nullptr)
+        _TIFFfree((tdata_t)previous->pdf_palette);
+    delete previous;
+}
+
 std::pair<double, double> charta::TIFFImageHandler::ReadImageDimensions(charta::IByteReaderWithPosition *inTIFFStream,
                                                                         unsigned long inImageIndex)
 {
@@ -24,6 +24,7 @@
 #include "objects/PDFObjectCast.h"
 #include "objects/PDFStreamInput.h"
 #include "parsing/PDFParser.h"
+#include "parsing/PDFParserReader.h"
 #include <utility>
 
 ArrayOfInputStreamsStream::ArrayOfInputStreamsStream(std::shared_ptr<charta::PDFArray> inArrayOfStreams,
@@ -31,6 +32,17 @@ ArrayOfInputStreamsStream::ArrayOfInputStreamsStream(std::shared_ptr<charta::PDF
 {
     mArray = std::move(inArrayOfStreams);
     mParser = inParser;
+    mReader = nullptr;
+    mCurrentStream = nullptr;
+    mCurrentIndex = 0;
+}
+
+ArrayOfInputStreamsStream::ArrayOfInputStreamsStream(std::shared_ptr<charta::PDFArray> inArrayOfStreams,
+                                                     PDFParserReader *inReader)
+{
+    mArray = std::move(inArrayOfStreams);
+    mParser = nullptr;
+    mReader = inReader;
     mCurrentStream = nullptr;
     mCurrentIndex = 0;
 }
@@ -59,10 +71,13 @@ charta::IByteReader *ArrayOfInputStreamsStream::GetActiveStream()
 
     while ((mCurrentStream == nullptr) && mCurrentIndex < mArray->GetLength())
     {
-        PDFObjectCastPtr<charta::PDFStreamInput> aStream = mParser->QueryArrayObject(mArray, mCurrentIndex);
+        PDFObjectCastPtr<charta::PDFStreamInput> aStream = mReader != nullptr
+                                                               ? mReader->QueryArrayObject(mArray, mCurrentIndex)
+                                                               : mParser->QueryArrayObject(mArray, mCurrentIndex);
         if (!!aStream)
         {
-            mCurrentStream = mParser->StartReadingFromStream(aStream);
+            mCurrentStream = mReader != nullptr ? mReader->StartReadingFromStream(aStream)
+                                                : mParser->StartReadingFromStream(aStream);
             // couldn't start, try with next array object
             if (mCurrentStream == nullptr)
                 ++mCurrentIndex;
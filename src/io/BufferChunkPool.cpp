@@ -0,0 +1,86 @@
+/*
+   Source File : BufferChunkPool.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "io/BufferChunkPool.h"
+
+charta::BufferChunkPool::BufferChunkPool(size_t inChunkSize, size_t inMaxPooledChunks)
+    : mChunkSize(inChunkSize), mMaxPooledChunks(inMaxPooledChunks)
+{
+}
+
+charta::BufferChunkPool::~BufferChunkPool()
+{
+    Trim();
+}
+
+charta::BufferChunkPool &charta::BufferChunkPool::Default()
+{
+    static BufferChunkPool sDefaultPool;
+    return sDefaultPool;
+}
+
+uint8_t *charta::BufferChunkPool::Acquire()
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        if (!mPooledChunks.empty())
+        {
+            uint8_t *chunk = mPooledChunks.back();
+            mPooledChunks.pop_back();
+            return chunk;
+        }
+    }
+    return new uint8_t[mChunkSize];
+}
+
+void charta::BufferChunkPool::Release(uint8_t *inChunk)
+{
+    if (inChunk == nullptr)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        if (mPooledChunks.size() < mMaxPooledChunks)
+        {
+            mPooledChunks.push_back(inChunk);
+            return;
+        }
+    }
+    delete[] inChunk;
+}
+
+size_t charta::BufferChunkPool::GetChunkSize() const
+{
+    return mChunkSize;
+}
+
+size_t charta::BufferChunkPool::GetPooledChunksCount()
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    return mPooledChunks.size();
+}
+
+void charta::BufferChunkPool::Trim()
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    for (uint8_t *chunk : mPooledChunks)
+        delete[] chunk;
+    mPooledChunks.clear();
+}
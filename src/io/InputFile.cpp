@@ -75,6 +75,13 @@ charta::IByteReaderWithPosition *charta::InputFile::GetInputStream()
     return mInputStream.get();
 }
 
+charta::IPositionalByteReader *charta::InputFile::GetPositionalReader()
+{
+    if (nullptr == mInputStream)
+        return nullptr;
+    return static_cast<InputFileStream *>(mInputStream->GetSourceStream());
+}
+
 const std::string &charta::InputFile::GetFilePath()
 {
     return mFilePath;
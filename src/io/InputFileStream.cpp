@@ -21,6 +21,10 @@
 #include "io/InputFileStream.h"
 #include "SafeBufferMacrosDefs.h"
 
+#if !defined(_WIN32) && !defined(__WIN32__) && !defined(WIN32)
+#include <unistd.h>
+#endif
+
 using namespace charta;
 
 charta::InputFileStream::~InputFileStream()
@@ -105,3 +109,30 @@ void charta::InputFileStream::SetPositionFromEnd(long long inOffsetFromEnd)
             SAFE_FSEEK64(mStream, 0, SEEK_SET);
     }
 }
+
+size_t charta::InputFileStream::ReadAt(long long inPosition, uint8_t *inBuffer, size_t inBufferSize)
+{
+    if (mStream == nullptr || inPosition < 0)
+        return 0;
+
+#if defined(_WIN32) || defined(__WIN32__) || defined(WIN32)
+    std::lock_guard<std::mutex> lock(mPositionalReadLock);
+    long long currentPosition = SAFE_FTELL64(mStream);
+    SAFE_FSEEK64(mStream, inPosition, SEEK_SET);
+    size_t readItems = fread(static_cast<void *>(inBuffer), 1, inBufferSize, mStream);
+    SAFE_FSEEK64(mStream, currentPosition, SEEK_SET);
+    return readItems;
+#else
+    int descriptor = fileno(mStream);
+    size_t readItems = 0;
+    while (readItems < inBufferSize)
+    {
+        ssize_t result =
+            pread(descriptor, inBuffer + readItems, inBufferSize - readItems, (off_t)(inPosition + readItems));
+        if (result <= 0)
+            break;
+        readItems += (size_t)result;
+    }
+    return readItems;
+#endif
+}
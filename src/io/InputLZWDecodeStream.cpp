@@ -21,14 +21,31 @@
 #include "io/InputLZWDecodeStream.h"
 
 #include "Trace.h"
-#include <zlib.h>
+#include <algorithm>
+#include <string.h>
+
+static const int scClearTableCode = 256;
+static const int scEndOfDataCode = 257;
+static const int scFirstTableCode = 258;
+
+static const uint32_t scCodeMasks[13] = {0x0,  0x1,  0x3,  0x7,   0xf,   0x1f,  0x3f,
+                                         0x7f, 0xff, 0x1ff, 0x3ff, 0x7ff, 0xfff};
 
 charta::InputLZWDecodeStream::InputLZWDecodeStream(int early)
 {
     mSourceStream = nullptr;
     mCurrentlyEncoding = false;
     mEarly = early;
-    inputBuf = 0;
+    ClearTable();
+}
+
+charta::InputLZWDecodeStream::InputLZWDecodeStream(charta::IByteReader *inSourceReader, int early)
+{
+    mSourceStream = nullptr;
+    mCurrentlyEncoding = false;
+    mEarly = early;
+
+    Assign(inSourceReader);
 }
 
 charta::InputLZWDecodeStream::~InputLZWDecodeStream()
@@ -44,14 +61,6 @@ void charta::InputLZWDecodeStream::FinalizeEncoding()
     mCurrentlyEncoding = false;
 }
 
-charta::InputLZWDecodeStream::InputLZWDecodeStream(charta::IByteReader *inSourceReader)
-{
-    mSourceStream = nullptr;
-    mCurrentlyEncoding = false;
-
-    Assign(inSourceReader);
-}
-
 void charta::InputLZWDecodeStream::Assign(charta::IByteReader *inSourceReader)
 {
     mSourceStream = inSourceReader;
@@ -63,150 +72,162 @@ void charta::InputLZWDecodeStream::StartEncoding()
 {
     mCurrentlyEncoding = true;
 
-    inputBits = 0;
+    mInputPosition = mInputEnd = 0;
+    mBitBuffer = 0;
+    mBitCount = 0;
+    for (int i = 0; i < scClearTableCode; ++i)
+    {
+        mTable[i].length = 1;
+        mTable[i].head = 0;
+        mTable[i].tail = (uint8_t)i;
+        mTable[i].first = (uint8_t)i;
+    }
     ClearTable();
 }
 
-size_t charta::InputLZWDecodeStream::Read(uint8_t *inBuffer, size_t /*inBufferSize*/)
+size_t charta::InputLZWDecodeStream::Read(uint8_t *inBuffer, size_t inBufferSize)
 {
-    if (mCurrentlyEncoding)
+    size_t readBytes = 0;
+
+    // first, whatever is left of a sequence from the previous call
+    if (mSequenceIndex < mSequenceLength)
     {
-        if (seqIndex >= seqLength)
+        readBytes = std::min(mSequenceLength - mSequenceIndex, inBufferSize);
+        memcpy(inBuffer, mSequence + mSequenceIndex, readBytes);
+        mSequenceIndex += readBytes;
+    }
+
+    while (readBytes < inBufferSize && mCurrentlyEncoding)
+    {
+        int code = ProcessNextCode();
+        if (code < 0)
+            break;
+
+        size_t length = mTable[code].length;
+        if (length <= inBufferSize - readBytes)
+        {
+            // expand directly into the caller buffer
+            ExpandSequence(code, inBuffer + readBytes);
+            readBytes += length;
+        }
+        else
         {
-            if (!ProcessNextCode())
-                return 0;
+            // doesn't fit. keep the rest for the next read
+            ExpandSequence(code, mSequence);
+            mSequenceLength = length;
+            mSequenceIndex = inBufferSize - readBytes;
+            memcpy(inBuffer + readBytes, mSequence, mSequenceIndex);
+            readBytes = inBufferSize;
         }
-        memcpy(inBuffer, &seqBuf[seqIndex], 1);
-        seqIndex++;
-        return 1;
     }
-    return 0;
+    return readBytes;
 }
 
-bool charta::InputLZWDecodeStream::ProcessNextCode()
+int charta::InputLZWDecodeStream::ProcessNextCode()
 {
     int code;
-    int nextLength;
-    int i, j;
 
-    // check for EOF
-    bool ret = false;
+    // check for eod and clear-table codes
     do
     {
-        if (!mCurrentlyEncoding)
-            break;
-        // check for eod and clear-table codes
-        do
+        code = GetCode();
+        if (code == -1 || code == scEndOfDataCode)
         {
-            code = GetCode();
-            if (code == -1 || code == 257)
-            {
-                mCurrentlyEncoding = false;
-                break;
-            }
-            if (code == 256)
-            {
-                ClearTable();
-            }
-        } while (code == 256);
-
-        if (!mCurrentlyEncoding)
-            break;
-
-        if (nextCode >= 4097)
-        {
-            // error(getPos(), "Bad LZW stream - expected clear-table code");
-            ClearTable();
+            mCurrentlyEncoding = false;
+            return -1;
         }
+        if (code == scClearTableCode)
+            ClearTable();
+    } while (code == scClearTableCode);
 
-        // process the next code
-        nextLength = seqLength + 1;
-        if (code < 256)
-        {
-            seqBuf[0] = code;
-            seqLength = 1;
-        }
-        else if (code < nextCode)
-        {
-            seqLength = table[code].length;
-            for (i = seqLength - 1, j = code; i > 0; --i)
-            {
-                seqBuf[i] = table[j].tail;
-                j = table[j].head;
-            }
-            seqBuf[0] = j;
-        }
-        else if (code == nextCode)
-        {
-            seqBuf[seqLength] = newChar;
-            ++seqLength;
-        }
-        else
+    if (mNextCode >= scTableSize)
+    {
+        TRACE_LOG("charta::InputLZWDecodeStream::ProcessNextCode, Bad LZW stream - expected clear-table code");
+        ClearTable();
+    }
+
+    if (mFirst)
+    {
+        if (code >= scClearTableCode)
         {
-            // error(getPos(), "Bad LZW stream - unexpected code");
+            TRACE_LOG1("charta::InputLZWDecodeStream::ProcessNextCode, Bad LZW stream - unexpected code %d", code);
             mCurrentlyEncoding = false;
-            break;
-        }
-        newChar = seqBuf[0];
-        if (first)
-        {
-            first = false;
+            return -1;
         }
-        else
+        mFirst = false;
+    }
+    else
+    {
+        if (code > mNextCode)
         {
-            table[nextCode].length = nextLength;
-            table[nextCode].head = prevCode;
-            table[nextCode].tail = newChar;
-            ++nextCode;
-            if (nextCode + mEarly == 512)
-                nextBits = 10;
-            else if (nextCode + mEarly == 1024)
-                nextBits = 11;
-            else if (nextCode + mEarly == 2048)
-                nextBits = 12;
+            TRACE_LOG1("charta::InputLZWDecodeStream::ProcessNextCode, Bad LZW stream - unexpected code %d", code);
+            mCurrentlyEncoding = false;
+            return -1;
         }
-        prevCode = code;
 
-        // reset buffer
-        seqIndex = 0;
-
-        ret = true;
+        // add the previous sequence plus the first byte of this one. when the code is the one being added now,
+        // its first byte is the first byte of the previous sequence. either way the code can then be expanded
+        // from the table
+        uint8_t newChar = code == mNextCode ? mTable[mPrevCode].first : mTable[code].first;
+        mTable[mNextCode].length = mTable[mPrevCode].length + 1;
+        mTable[mNextCode].head = (uint16_t)mPrevCode;
+        mTable[mNextCode].tail = newChar;
+        mTable[mNextCode].first = mTable[mPrevCode].first;
+        ++mNextCode;
+        if (mNextCode + mEarly == 512)
+            mCodeLength = 10;
+        else if (mNextCode + mEarly == 1024)
+            mCodeLength = 11;
+        else if (mNextCode + mEarly == 2048)
+            mCodeLength = 12;
+    }
+    mPrevCode = code;
+    return code;
+}
 
-    } while (false);
-    return ret;
+void charta::InputLZWDecodeStream::ExpandSequence(int inCode, uint8_t *outBuffer) const
+{
+    // walk the chain back from the last byte
+    uint8_t *position = outBuffer + mTable[inCode].length;
+    while (inCode >= scFirstTableCode)
+    {
+        *--position = mTable[inCode].tail;
+        inCode = mTable[inCode].head;
+    }
+    *--position = (uint8_t)inCode;
 }
 
 void charta::InputLZWDecodeStream::ClearTable()
 {
-    nextCode = 258;
-    nextBits = 9;
-    seqIndex = seqLength = 0;
-    first = true;
+    mNextCode = scFirstTableCode;
+    mCodeLength = 9;
+    mSequenceIndex = mSequenceLength = 0;
+    mFirst = true;
 }
 
 int charta::InputLZWDecodeStream::GetCode()
 {
-    int c;
-    int code;
-
-    uint8_t buffer;
-    while (inputBits < nextBits)
+    while (mBitCount < mCodeLength)
     {
-        mSourceStream->Read(&buffer, 1);
-        c = buffer;
-
-        if (c == -1)
+        if (mInputPosition == mInputEnd && !FillInputBuffer())
             return -1;
-        inputBuf = (inputBuf << 8) | (c & 0xff);
-        inputBits += 8;
+        mBitBuffer = (mBitBuffer << 8) | mInputBuffer[mInputPosition++];
+        mBitCount += 8;
     }
-    code = (inputBuf >> (inputBits - nextBits)) & ((1 << nextBits) - 1);
-    inputBits -= nextBits;
-    inputBuf = inputBuf & ((1 << inputBits) - 1); // avoid overflow by limiting to the bits its supposed to use
-    return code;
+    mBitCount -= mCodeLength;
+    return (int)((mBitBuffer >> mBitCount) & scCodeMasks[mCodeLength]);
+}
+
+bool charta::InputLZWDecodeStream::FillInputBuffer()
+{
+    mInputPosition = 0;
+    mInputEnd = 0;
+    while (mInputEnd == 0 && mSourceStream->NotEnded())
+        mInputEnd = mSourceStream->Read(mInputBuffer, scInputBufferSize);
+    return mInputEnd != 0;
 }
 
 bool charta::InputLZWDecodeStream::NotEnded()
 {
-    return mCurrentlyEncoding;
-}
\ No newline at end of file
+    return mCurrentlyEncoding || mSequenceIndex < mSequenceLength;
+}
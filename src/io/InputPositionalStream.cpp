@@ -0,0 +1,101 @@
+/*
+   Source File : InputPositionalStream.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "io/InputPositionalStream.h"
+
+#include <string.h>
+
+charta::InputPositionalStream::InputPositionalStream(IPositionalByteReader *inSource, size_t inBufferSize)
+    : mSource(inSource), mBuffer(inBufferSize > 0 ? inBufferSize : 1), mBufferStart(0), mBufferFill(0), mPosition(0),
+      mEnded(false)
+{
+}
+
+bool charta::InputPositionalStream::FillBuffer()
+{
+    mBufferStart = mPosition;
+    mBufferFill = mSource->ReadAt(mPosition, mBuffer.data(), mBuffer.size());
+    if (mBufferFill == 0)
+        mEnded = true;
+    return mBufferFill > 0;
+}
+
+size_t charta::InputPositionalStream::Read(uint8_t *inBuffer, size_t inBufferSize)
+{
+    size_t readAmount = 0;
+
+    while (readAmount < inBufferSize)
+    {
+        if (mPosition < mBufferStart || mPosition >= mBufferStart + (long long)mBufferFill)
+        {
+            // large reads skip the buffer
+            if (inBufferSize - readAmount >= mBuffer.size())
+            {
+                size_t directRead = mSource->ReadAt(mPosition, inBuffer + readAmount, inBufferSize - readAmount);
+                mPosition += directRead;
+                readAmount += directRead;
+                if (directRead == 0)
+                    mEnded = true;
+                break;
+            }
+            if (!FillBuffer())
+                break;
+        }
+
+        size_t offset = (size_t)(mPosition - mBufferStart);
+        size_t available = mBufferFill - offset;
+        size_t toCopy = available < inBufferSize - readAmount ? available : inBufferSize - readAmount;
+        memcpy(inBuffer + readAmount, mBuffer.data() + offset, toCopy);
+        readAmount += toCopy;
+        mPosition += toCopy;
+    }
+
+    return readAmount;
+}
+
+bool charta::InputPositionalStream::NotEnded()
+{
+    if (mPosition >= mBufferStart && mPosition < mBufferStart + (long long)mBufferFill)
+        return true;
+    if (mEnded)
+        return false;
+    return FillBuffer();
+}
+
+void charta::InputPositionalStream::Skip(size_t inSkipSize)
+{
+    mPosition += inSkipSize;
+    mEnded = false;
+}
+
+void charta::InputPositionalStream::SetPosition(long long inOffsetFromStart)
+{
+    mPosition = inOffsetFromStart;
+    mEnded = false;
+}
+
+void charta::InputPositionalStream::SetPositionFromEnd(long long /*inOffsetFromEnd*/)
+{
+}
+
+long long charta::InputPositionalStream::GetCurrentPosition()
+{
+    return mPosition;
+}
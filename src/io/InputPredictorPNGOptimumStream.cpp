@@ -21,7 +21,10 @@
 #include "io/InputPredictorPNGOptimumStream.h"
 
 #include "Trace.h"
-#include <stdlib.h>
+#include "io/PredictorKernels.h"
+
+#include <algorithm>
+#include <string.h>
 
 /*
     Note from Gal: Note that optimum also implements the others. this is because PNG compression requires that the first
@@ -33,7 +36,7 @@ charta::InputPredictorPNGOptimumStream::InputPredictorPNGOptimumStream()
     mSourceStream = nullptr;
     mBuffer = nullptr;
     mIndex = nullptr;
-    mBufferSize = 0;
+    mRowSize = 0;
     mUpValues = nullptr;
 }
 
@@ -51,7 +54,7 @@ charta::InputPredictorPNGOptimumStream::InputPredictorPNGOptimumStream(charta::I
     mSourceStream = nullptr;
     mBuffer = nullptr;
     mIndex = nullptr;
-    mBufferSize = 0;
+    mRowSize = 0;
     mUpValues = nullptr;
 
     Assign(inSourceStream, inColors, inBitsPerComponent, inColumns);
@@ -61,74 +64,61 @@ size_t charta::InputPredictorPNGOptimumStream::Read(uint8_t *inBuffer, size_t in
 {
     size_t readBytes = 0;
 
-    // exhaust what's in the buffer currently
-    while (mBufferSize > (size_t)(mIndex - mBuffer) && readBytes < inBufferSize)
-    {
-        DecodeNextByte(inBuffer[readBytes]);
-        ++readBytes;
-    }
-
-    // now repeatedly read bytes from the input stream, and decode
-    while (readBytes < inBufferSize && mSourceStream->NotEnded())
+    while (readBytes < inBufferSize)
     {
-        memcpy(mUpValues, mBuffer, mBufferSize);
-        size_t readFromSource = mSourceStream->Read(mBuffer, mBufferSize);
-        if (readFromSource == 0)
-        {
-            break; // a belated end. must be flate
-        }
-        if (readFromSource != mBufferSize)
-        {
-            TRACE_LOG(
-                "charta::InputPredictorPNGOptimumStream::Read, problem, expected columns number read. didn't make it");
+        // exhaust what's in the buffer currently, then decode the next row
+        if (mIndex == mBuffer + 1 + mRowSize && !ReadNextRow())
             break;
-        }
-        mFunctionType = *mBuffer;
-        *mBuffer = 0;         // so i can use this as "left" value...we don't care about this one...it's just a tag
-        mIndex = mBuffer + 1; // skip the first tag
-
-        while (mBufferSize > (size_t)(mIndex - mBuffer) && readBytes < inBufferSize)
-        {
-            DecodeNextByte(inBuffer[readBytes]);
-            ++readBytes;
-        }
+
+        size_t amount = std::min((size_t)(mBuffer + 1 + mRowSize - mIndex), inBufferSize - readBytes);
+        memcpy(inBuffer + readBytes, mIndex, amount);
+        mIndex += amount;
+        readBytes += amount;
     }
     return readBytes;
 }
 
-bool charta::InputPredictorPNGOptimumStream::NotEnded()
+bool charta::InputPredictorPNGOptimumStream::ReadNextRow()
 {
-    return mSourceStream->NotEnded() || (size_t)(mIndex - mBuffer) < mBufferSize;
-}
+    if (!mSourceStream->NotEnded())
+        return false;
 
-void charta::InputPredictorPNGOptimumStream::DecodeNextByte(uint8_t &outDecodedByte)
-{
-    // decoding function is determined by mFunctionType
-    switch (mFunctionType)
+    // the previous row is the up row of the new one
+    std::swap(mBuffer, mUpValues);
+
+    size_t readFromSource = 0;
+    while (readFromSource < mRowSize + 1 && mSourceStream->NotEnded())
+    {
+        size_t amount = mSourceStream->Read(mBuffer + readFromSource, mRowSize + 1 - readFromSource);
+        if (amount == 0)
+            break;
+        readFromSource += amount;
+    }
+
+    if (readFromSource == 0)
+    {
+        // a belated end. must be flate
+        std::swap(mBuffer, mUpValues);
+        return false;
+    }
+    if (readFromSource != mRowSize + 1)
     {
-    case 0:
-        outDecodedByte = *mIndex;
-        break;
-    case 1:
-        outDecodedByte = (uint8_t)((char)*(mIndex - mBytesPerPixel) + (char)*mIndex);
-        break;
-    case 2:
-        outDecodedByte = (uint8_t)((char)mUpValues[mIndex - mBuffer] + (char)*mIndex);
-        break;
-    case 3:
-        outDecodedByte =
-            (uint8_t)((char)mBuffer[mIndex - mBuffer - 1] / 2 + (char)mUpValues[mIndex - mBuffer] / 2 + (char)*mIndex);
-        break;
-    case 4:
-        outDecodedByte = (uint8_t)(PaethPredictor(mBuffer[mIndex - mBuffer - 1], mUpValues[mIndex - mBuffer],
-                                                  mUpValues[mIndex - mBuffer - 1]) +
-                                   (char)*mIndex);
-        break;
+        TRACE_LOG("charta::InputPredictorPNGOptimumStream::ReadNextRow, problem, expected columns number read. didn't "
+                  "make it");
+        std::swap(mBuffer, mUpValues);
+        return false;
     }
 
-    *mIndex = outDecodedByte; // saving the encoded value back to the buffer, for later copying as "Up value", and
-                              // current using as "Left" value
-    ++mIndex;
+    if (!PNGUnfilterRow(mBuffer[0], mBuffer + 1, mUpValues + 1, mRowSize, mBytesPerPixel))
+        TRACE_LOG1("charta::InputPredictorPNGOptimumStream::ReadNextRow, unknown filter type %d. passing row as is",
+                   mBuffer[0]);
+    mIndex = mBuffer + 1; // skip the tag
+    return true;
+}
+
+bool charta::InputPredictorPNGOptimumStream::NotEnded()
+{
+    return mSourceStream->NotEnded() || mIndex < mBuffer + 1 + mRowSize;
 }
 
 void charta::InputPredictorPNGOptimumStream::Assign(charta::IByteReader *inSourceStream, size_t inColors,
@@ -138,27 +128,13 @@ void charta::InputPredictorPNGOptimumStream::Assign(charta::IByteReader *inSourc
 
     delete[] mBuffer;
     delete[] mUpValues;
-    mBytesPerPixel = inColors * inBitsPerComponent / 8;
+    // pixels smaller than a byte are taken as byte sized
+    mBytesPerPixel = std::max(inColors * inBitsPerComponent / 8, (size_t)1);
     // Rows may contain empty bits at end
-    mBufferSize = (inColumns * inColors * inBitsPerComponent + 7) / 8 + 1;
-    mBuffer = new uint8_t[mBufferSize];
-    memset(mBuffer, 0, mBufferSize);
-    mUpValues = new uint8_t[mBufferSize];
-    memset(mUpValues, 0, mBufferSize); // that's less important
-    mIndex = mBuffer + mBufferSize;
-    mFunctionType = 0;
-}
-
-char charta::InputPredictorPNGOptimumStream::PaethPredictor(char inLeft, char inUp, char inUpLeft)
-{
-    int p = inLeft + inUp - inUpLeft;
-    int pLeft = abs(p - inLeft);
-    int pUp = abs(p - inUp);
-    int pUpLeft = abs(p - inUpLeft);
-
-    if (pLeft <= pUp && pLeft <= pUpLeft)
-        return pLeft;
-    if (pUp <= pUpLeft)
-        return inUp;
-    return inUpLeft;
+    mRowSize = (inColumns * inColors * inBitsPerComponent + 7) / 8;
+    mBuffer = new uint8_t[mRowSize + 1];
+    memset(mBuffer, 0, mRowSize + 1);
+    mUpValues = new uint8_t[mRowSize + 1];
+    memset(mUpValues, 0, mRowSize + 1); // the first row has a zero up row
+    mIndex = mBuffer + 1 + mRowSize;
 }
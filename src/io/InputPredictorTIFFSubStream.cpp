@@ -20,13 +20,17 @@
 */
 #include "io/InputPredictorTIFFSubStream.h"
 #include "Trace.h"
+#include "io/PredictorKernels.h"
+
+#include <algorithm>
+#include <string.h>
 
 charta::InputPredictorTIFFSubStream::InputPredictorTIFFSubStream()
 {
     mSourceStream = nullptr;
     mRowBuffer = nullptr;
-    mReadColors = nullptr;
-    mReadColorsCount = 0;
+    mRowSize = 0;
+    mRowIndex = 0;
 }
 
 charta::InputPredictorTIFFSubStream::InputPredictorTIFFSubStream(charta::IByteReader *inSourceStream, size_t inColors,
@@ -34,7 +38,6 @@ charta::InputPredictorTIFFSubStream::InputPredictorTIFFSubStream(charta::IByteRe
 {
     mSourceStream = nullptr;
     mRowBuffer = nullptr;
-    mReadColors = nullptr;
 
     Assign(inSourceStream, inColors, inBitsPerComponent, inColumns);
 }
@@ -43,45 +46,54 @@ charta::InputPredictorTIFFSubStream::~InputPredictorTIFFSubStream()
 {
     delete mSourceStream;
     delete[] mRowBuffer;
-    delete[] mReadColors;
 }
 
 size_t charta::InputPredictorTIFFSubStream::Read(uint8_t *inBuffer, size_t inBufferSize)
 {
     size_t readBytes = 0;
 
-    // exhaust what's in the buffer currently
-    while (mReadColorsCount > (size_t)(mReadColorsIndex - mReadColors) && readBytes < inBufferSize)
+    while (readBytes < inBufferSize)
     {
-        ReadByteFromColorsArray(inBuffer[readBytes]);
-        ++readBytes;
+        // exhaust what's in the buffer currently, then decode the next row
+        if (mRowIndex == mRowSize && !ReadNextRow())
+            break;
+
+        size_t amount = std::min(mRowSize - mRowIndex, inBufferSize - readBytes);
+        memcpy(inBuffer + readBytes, mRowBuffer + mRowIndex, amount);
+        mRowIndex += amount;
+        readBytes += amount;
     }
+    return readBytes;
+}
 
-    // now repeatedly read bytes from the input stream, and decode
-    while (readBytes < inBufferSize && mSourceStream->NotEnded())
+bool charta::InputPredictorTIFFSubStream::ReadNextRow()
+{
+    size_t readFromSource = 0;
+    while (readFromSource < mRowSize && mSourceStream->NotEnded())
     {
-        if (mSourceStream->Read(mRowBuffer, (mColumns * mColors * mBitsPerComponent) / 8) !=
-            (mColumns * mColors * mBitsPerComponent) / 8)
-        {
-            TRACE_LOG("InputPredictorPNGSubStream::Read, problem, expected columns*colors*bitspercomponent/8 number "
-                      "read. didn't make it");
-            readBytes = 0;
+        size_t amount = mSourceStream->Read(mRowBuffer + readFromSource, mRowSize - readFromSource);
+        if (amount == 0)
             break;
-        }
-        DecodeBufferToColors();
-
-        while (mReadColorsCount > (size_t)(mReadColorsIndex - mReadColors) && readBytes < inBufferSize)
-        {
-            ReadByteFromColorsArray(inBuffer[readBytes]);
-            ++readBytes;
-        }
+        readFromSource += amount;
     }
-    return readBytes;
+
+    if (readFromSource == 0)
+        return false;
+    if (readFromSource != mRowSize)
+    {
+        TRACE_LOG("charta::InputPredictorTIFFSubStream::ReadNextRow, problem, expected "
+                  "columns*colors*bitspercomponent/8 number read. didn't make it");
+        return false;
+    }
+
+    TIFFUndifferenceRow(mRowBuffer, mColumns, mColors, mBitsPerComponent);
+    mRowIndex = 0;
+    return true;
 }
 
 bool charta::InputPredictorTIFFSubStream::NotEnded()
 {
-    return mSourceStream->NotEnded() || (size_t)(mReadColorsIndex - mReadColors) < mReadColorsCount;
+    return mSourceStream->NotEnded() || mRowIndex < mRowSize;
 }
 
 void charta::InputPredictorTIFFSubStream::Assign(charta::IByteReader *inSourceStream, size_t inColors,
@@ -92,88 +104,9 @@ void charta::InputPredictorTIFFSubStream::Assign(charta::IByteReader *inSourceSt
     mBitsPerComponent = inBitsPerComponent;
     mColumns = inColumns;
 
-    delete mRowBuffer;
-    mRowBuffer = new uint8_t[(inColumns * inColors * inBitsPerComponent) / 8];
-
-    mReadColorsCount = inColumns * inColors;
-    mReadColors = new uint16_t[mReadColorsCount];
-    mReadColorsIndex =
-        mReadColors + mReadColorsCount; // assign to end of array so will know that should read new buffer
-    mIndexInColor = 0;
-
-    mBitMask = 0;
-    for (uint8_t i = 0; i < inBitsPerComponent; ++i)
-        mBitMask = (mBitMask << 1) + 1;
-}
-
-void charta::InputPredictorTIFFSubStream::ReadByteFromColorsArray(uint8_t &outBuffer)
-{
-    if (8 == mBitsPerComponent)
-    {
-        outBuffer = (uint8_t)(*mReadColorsIndex);
-        ++mReadColorsIndex;
-    }
-    else if (8 > mBitsPerComponent)
-    {
-        outBuffer = 0;
-        for (uint8_t i = 0; i < (8 / mBitsPerComponent); ++i)
-        {
-            outBuffer = (outBuffer << mBitsPerComponent) + (uint8_t)(*mReadColorsIndex);
-            ++mReadColorsIndex;
-        }
-    }
-    else // 8 < mBitsPerComponent [which is just 16 for now]
-    {
-        outBuffer = (uint8_t)(((*mReadColorsIndex) >> (mBitsPerComponent - mIndexInColor * 8)) & 0xff);
-        ++mIndexInColor;
-        if (mBitsPerComponent / 8 == mIndexInColor)
-        {
-            ++mReadColorsIndex;
-            mIndexInColor = 0;
-        }
-    }
+    delete[] mRowBuffer;
+    // Rows may contain empty bits at end
+    mRowSize = (inColumns * inColors * inBitsPerComponent + 7) / 8;
+    mRowBuffer = new uint8_t[mRowSize];
+    mRowIndex = mRowSize; // at the end of the row, so will know that should read a new one
 }
-
-void charta::InputPredictorTIFFSubStream::DecodeBufferToColors()
-{
-    // 1. Split to colors. Use array of colors (should be columns * colors). Each time take BitsPerComponent of the
-    // buffer
-    // 2. Once you got the "colors", loop the array, setting values after diffs (use modulo of bit mask for "sign"
-    // computing)
-    // 3. Now you have the colors array.
-    size_t i = 0;
-
-    // read the colors differences according to bits per component
-    if (8 == mBitsPerComponent)
-    {
-        for (; i < mReadColorsCount; ++i)
-            mReadColors[i] = mRowBuffer[i];
-    }
-    else if (8 > mBitsPerComponent)
-    {
-        for (; i < (mReadColorsCount * mBitsPerComponent / 8); ++i)
-        {
-            for (size_t j = 0; j < (size_t)(8 / mBitsPerComponent); ++j)
-            {
-                mReadColors[(i + 1) * 8 / mBitsPerComponent - j - 1] = mRowBuffer[i] & mBitMask;
-                mRowBuffer[i] = mRowBuffer[i] >> mBitsPerComponent;
-            }
-        }
-    }
-    else // mBitesPerComponent > 8
-    {
-        for (; i < mReadColorsCount; ++i)
-        {
-            mReadColors[i] = 0;
-            for (uint8_t j = 0; j < mBitsPerComponent / 8; ++j)
-                mReadColors[i] = (mReadColors[i] << mBitsPerComponent) + mRowBuffer[i * mBitsPerComponent / 8 + j];
-        }
-    }
-
-    // calculate color values according to diffs
-    for (i = mColors; i < mReadColorsCount; ++i)
-        mReadColors[i] = (mReadColors[i] + mReadColors[i - mColors]) & mBitMask;
-
-    mReadColorsIndex = mReadColors;
-    mIndexInColor = 0;
-}
\ No newline at end of file
@@ -0,0 +1,228 @@
+/*
+   Source File : OutputAsyncFileStream.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "io/OutputAsyncFileStream.h"
+#include "SafeBufferMacrosDefs.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <errno.h>
+#include <string.h>
+
+#if defined(_WIN32) || defined(__WIN32__) || defined(WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+charta::OutputAsyncFileStream::OutputAsyncFileStream(size_t inBufferSize, size_t inBuffersCount)
+    : mBufferSize(inBufferSize > 0 ? inBufferSize : DEFAULT_ASYNC_OUTPUT_BUFFER_SIZE),
+      mBuffersCount(inBuffersCount > 1 ? inBuffersCount : 2), mFile(nullptr), mSyncOnClose(false), mPosition(0),
+      mBuffersInFlight(0), mStopping(false), mError(0), mErrorPosition(0)
+{
+}
+
+charta::OutputAsyncFileStream::~OutputAsyncFileStream()
+{
+    Close();
+}
+
+charta::EStatusCode charta::OutputAsyncFileStream::Open(const std::string &inFilePath, bool inAppend,
+                                                        bool inSyncOnClose)
+{
+    if (Close() != charta::eSuccess)
+        return charta::eFailure;
+
+    SAFE_FOPEN(mFile, inFilePath.c_str(), inAppend ? "ab" : "wb");
+    if (mFile == nullptr)
+        return charta::eFailure;
+
+    // start from the end, so position reading gets the correct file position when appending
+    SAFE_FSEEK64(mFile, 0, SEEK_END);
+    mPosition = SAFE_FTELL64(mFile);
+    mSyncOnClose = inSyncOnClose;
+    mError = 0;
+    mErrorPosition = 0;
+    mStopping = false;
+    mBuffersInFlight = 0;
+    mCurrentBuffer.reserve(mBufferSize);
+
+    mWritingThread = std::thread(&OutputAsyncFileStream::WritePendingBuffers, this, mPosition);
+    return charta::eSuccess;
+}
+
+charta::EStatusCode charta::OutputAsyncFileStream::Close()
+{
+    if (mFile == nullptr)
+        return charta::eSuccess;
+
+    Flush();
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mStopping = true;
+    }
+    mStateChanged.notify_all();
+    mWritingThread.join();
+
+    if (mError == 0 && mSyncOnClose)
+    {
+#if defined(_WIN32) || defined(__WIN32__) || defined(WIN32)
+        if (fflush(mFile) != 0 || _commit(_fileno(mFile)) != 0)
+#else
+        if (fflush(mFile) != 0 || fsync(fileno(mFile)) != 0)
+#endif
+        {
+            mError = errno;
+            mErrorPosition = mPosition;
+        }
+    }
+    if (fclose(mFile) != 0 && mError == 0)
+    {
+        mError = errno;
+        mErrorPosition = mPosition;
+    }
+    mFile = nullptr;
+    mCurrentBuffer.clear();
+    mFreeBuffers.clear();
+
+    if (mError != 0)
+    {
+        TRACE_LOG2("charta::OutputAsyncFileStream::Close, failed writing the file at position %lld - %s",
+                   mErrorPosition, strerror(mError));
+        return charta::eFailure;
+    }
+    return charta::eSuccess;
+}
+
+size_t charta::OutputAsyncFileStream::Write(const uint8_t *inBuffer, size_t inSize)
+{
+    if (mFile == nullptr || GetError() != 0)
+        return 0;
+
+    size_t written = 0;
+    while (written < inSize)
+    {
+        size_t toCopy = std::min(mBufferSize - mCurrentBuffer.size(), inSize - written);
+        mCurrentBuffer.insert(mCurrentBuffer.end(), inBuffer + written, inBuffer + written + toCopy);
+        written += toCopy;
+        if (mCurrentBuffer.size() == mBufferSize)
+            Flush();
+    }
+    mPosition += (long long)written;
+    return written;
+}
+
+long long charta::OutputAsyncFileStream::GetCurrentPosition()
+{
+    return mFile == nullptr ? 0 : mPosition;
+}
+
+void charta::OutputAsyncFileStream::Flush()
+{
+    if (mFile == nullptr || mCurrentBuffer.empty())
+        return;
+
+    std::unique_lock<std::mutex> lock(mLock);
+    // bounded memory - the current buffer is one of the buffers, so wait till one of the others is done
+    mStateChanged.wait(lock, [this]() { return mBuffersInFlight + 1 < mBuffersCount; });
+
+    mPendingBuffers.push_back(std::move(mCurrentBuffer));
+    ++mBuffersInFlight;
+    if (mFreeBuffers.empty())
+    {
+        mCurrentBuffer = std::vector<uint8_t>();
+        mCurrentBuffer.reserve(mBufferSize);
+    }
+    else
+    {
+        mCurrentBuffer = std::move(mFreeBuffers.back());
+        mFreeBuffers.pop_back();
+    }
+    lock.unlock();
+    mStateChanged.notify_all();
+}
+
+int charta::OutputAsyncFileStream::GetError()
+{
+    return mError;
+}
+
+void charta::OutputAsyncFileStream::WritePendingBuffers(long long inStartPosition)
+{
+    // buffers are written in the order they were handed over, so the file position is the sum of the previous ones
+    long long position = inStartPosition;
+
+    std::unique_lock<std::mutex> lock(mLock);
+    while (true)
+    {
+        mStateChanged.wait(lock, [this]() { return mStopping || !mPendingBuffers.empty(); });
+        if (mPendingBuffers.empty())
+            break;
+
+        std::vector<uint8_t> buffer = std::move(mPendingBuffers.front());
+        mPendingBuffers.pop_front();
+        bool failed = mError != 0;
+        lock.unlock();
+
+        // once failed, keep on releasing buffers without writing them
+        long long bufferPosition = position;
+        int error = failed ? 0 : WriteToFile(buffer, bufferPosition);
+        position += (long long)buffer.size();
+        buffer.clear();
+
+        lock.lock();
+        if (error != 0)
+        {
+            mError = error;
+            mErrorPosition = bufferPosition;
+        }
+        mFreeBuffers.push_back(std::move(buffer));
+        --mBuffersInFlight;
+        mStateChanged.notify_all();
+    }
+}
+
+int charta::OutputAsyncFileStream::WriteToFile(const std::vector<uint8_t> &inBuffer, long long inPosition)
+{
+#if defined(_WIN32) || defined(__WIN32__) || defined(WIN32)
+    (void)inPosition;
+    if (fwrite(inBuffer.data(), 1, inBuffer.size(), mFile) != inBuffer.size())
+        return errno != 0 ? errno : EIO;
+    return 0;
+#else
+    int descriptor = fileno(mFile);
+    size_t written = 0;
+    while (written < inBuffer.size())
+    {
+        ssize_t result =
+            pwrite(descriptor, inBuffer.data() + written, inBuffer.size() - written, (off_t)(inPosition + written));
+        if (result < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return errno;
+        }
+        if (result == 0)
+            return EIO;
+        written += (size_t)result;
+    }
+    return 0;
+#endif
+}
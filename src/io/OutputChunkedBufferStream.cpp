@@ -0,0 +1,122 @@
+/*
+   Source File : OutputChunkedBufferStream.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "io/OutputChunkedBufferStream.h"
+
+#include <algorithm>
+#include <memory.h>
+
+charta::OutputChunkedBufferStream::OutputChunkedBufferStream(BufferChunkPool *inPool)
+    : mPool(inPool != nullptr ? inPool : &BufferChunkPool::Default()), mSize(0)
+{
+}
+
+charta::OutputChunkedBufferStream::~OutputChunkedBufferStream()
+{
+    Reset();
+}
+
+size_t charta::OutputChunkedBufferStream::Write(const uint8_t *inBuffer, size_t inSize)
+{
+    size_t chunkSize = mPool->GetChunkSize();
+    size_t written = 0;
+
+    while (written < inSize)
+    {
+        size_t chunkOffset = mSize % chunkSize;
+        if (chunkOffset == 0 && mSize / chunkSize == mChunks.size())
+            mChunks.push_back(mPool->Acquire());
+
+        size_t toCopy = std::min(chunkSize - chunkOffset, inSize - written);
+        memcpy(mChunks.back() + chunkOffset, inBuffer + written, toCopy);
+        written += toCopy;
+        mSize += toCopy;
+    }
+    return written;
+}
+
+long long charta::OutputChunkedBufferStream::GetCurrentPosition()
+{
+    return (long long)mSize;
+}
+
+size_t charta::OutputChunkedBufferStream::CopyToOutputStream(IByteWriter *inTargetStream) const
+{
+    size_t chunkSize = mPool->GetChunkSize();
+    size_t remaining = mSize;
+    size_t written = 0;
+
+    for (size_t i = 0; i < mChunks.size() && remaining > 0; ++i)
+    {
+        size_t toWrite = std::min(chunkSize, remaining);
+        size_t chunkWritten = inTargetStream->Write(mChunks[i], toWrite);
+        written += chunkWritten;
+        if (chunkWritten != toWrite)
+            break;
+        remaining -= toWrite;
+    }
+    return written;
+}
+
+std::string charta::OutputChunkedBufferStream::ToString() const
+{
+    size_t chunkSize = mPool->GetChunkSize();
+    std::string result;
+    result.reserve(mSize);
+
+    size_t remaining = mSize;
+    for (size_t i = 0; i < mChunks.size() && remaining > 0; ++i)
+    {
+        size_t toCopy = std::min(chunkSize, remaining);
+        result.append((const char *)mChunks[i], toCopy);
+        remaining -= toCopy;
+    }
+    return result;
+}
+
+charta::ConstBytesSegmentVector charta::OutputChunkedBufferStream::GetSegments() const
+{
+    size_t chunkSize = mPool->GetChunkSize();
+    ConstBytesSegmentVector result;
+    result.reserve(GetSegmentsCount());
+
+    size_t remaining = mSize;
+    for (size_t i = 0; i < mChunks.size() && remaining > 0; ++i)
+    {
+        size_t segmentSize = std::min(chunkSize, remaining);
+        result.emplace_back(mChunks[i], segmentSize);
+        remaining -= segmentSize;
+    }
+    return result;
+}
+
+size_t charta::OutputChunkedBufferStream::GetSegmentsCount() const
+{
+    size_t chunkSize = mPool->GetChunkSize();
+    return (mSize + chunkSize - 1) / chunkSize;
+}
+
+void charta::OutputChunkedBufferStream::Reset()
+{
+    for (uint8_t *chunk : mChunks)
+        mPool->Release(chunk);
+    mChunks.clear();
+    mSize = 0;
+}
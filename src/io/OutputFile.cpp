@@ -20,12 +20,14 @@
 */
 #include "io/OutputFile.h"
 #include "Trace.h"
+#include "io/OutputAsyncFileStream.h"
 #include "io/OutputBufferedStream.h"
 #include "io/OutputFileStream.h"
 
 charta::OutputFile::OutputFile()
 {
     mOutputStream = nullptr;
+    mAsyncOutputStream = nullptr;
 }
 
 charta::OutputFile::~OutputFile()
@@ -33,7 +35,8 @@ charta::OutputFile::~OutputFile()
     CloseFile();
 }
 
-charta::EStatusCode charta::OutputFile::OpenFile(const std::string &inFilePath, bool inAppend)
+charta::EStatusCode charta::OutputFile::OpenFile(const std::string &inFilePath, bool inAppend, bool inAsynchronous,
+                                                 bool inSyncOnClose)
 {
     EStatusCode status;
     do
@@ -46,6 +49,23 @@ charta::EStatusCode charta::OutputFile::OpenFile(const std::string &inFilePath,
             break;
         }
 
+        if (inAsynchronous)
+        {
+            auto *asyncOutputStream = new OutputAsyncFileStream();
+            status = asyncOutputStream->Open(inFilePath, inAppend, inSyncOnClose);
+            if (status != charta::eSuccess)
+            {
+                TRACE_LOG1("charta::OutputFile::OpenFile, Unexpected Failure. Cannot open file for writing - %s",
+                           inFilePath.c_str());
+                delete asyncOutputStream;
+                break;
+            }
+
+            mAsyncOutputStream = asyncOutputStream;
+            mFilePath = inFilePath;
+            break;
+        }
+
         auto outputFileStream = std::make_unique<OutputFileStream>();
         status = outputFileStream->Open(inFilePath, inAppend); // explicitly open, so status may be retrieved
         if (status != charta::eSuccess)
@@ -63,6 +83,14 @@ charta::EStatusCode charta::OutputFile::OpenFile(const std::string &inFilePath,
 
 charta::EStatusCode charta::OutputFile::CloseFile()
 {
+    if (mAsyncOutputStream != nullptr)
+    {
+        EStatusCode status = mAsyncOutputStream->Close(); // waits for pending writes, and reports their failure
+        delete mAsyncOutputStream;
+        mAsyncOutputStream = nullptr;
+        return status;
+    }
+
     if (nullptr == mOutputStream)
     {
         return charta::eSuccess;
@@ -79,6 +107,8 @@ charta::EStatusCode charta::OutputFile::CloseFile()
 
 charta::IByteWriterWithPosition *charta::OutputFile::GetOutputStream()
 {
+    if (mAsyncOutputStream != nullptr)
+        return mAsyncOutputStream;
     return mOutputStream;
 }
 
@@ -20,6 +20,7 @@
 */
 #include "io/OutputFlateEncodeStream.h"
 #include "Trace.h"
+#include <chrono>
 #include <zlib.h>
 
 constexpr size_t BUFFER_SIZE = 256 * 1024;
@@ -30,6 +31,9 @@ charta::OutputFlateEncodeStream::OutputFlateEncodeStream()
     mZLibState = new z_stream;
     mTargetStream = nullptr;
     mCurrentlyEncoding = false;
+    mMeasureEncodingTime = false;
+    mInputBytes = 0;
+    mEncodingNanoseconds = 0;
 }
 
 charta::OutputFlateEncodeStream::~OutputFlateEncodeStream()
@@ -54,7 +58,7 @@ void charta::OutputFlateEncodeStream::FinalizeEncoding()
     {
         mZLibState->avail_out = BUFFER_SIZE;
         mZLibState->next_out = mBuffer;
-        deflateResult = deflate(mZLibState, Z_FINISH);
+        deflateResult = Deflate(Z_FINISH);
         if (Z_STREAM_ERROR == deflateResult)
         {
             TRACE_LOG1("charta::OutputFlateEncodeStream::FinalizeEncoding, failed to flush zlib information. returned "
@@ -85,6 +89,9 @@ charta::OutputFlateEncodeStream::OutputFlateEncodeStream(charta::IByteWriterWith
     mZLibState = new z_stream;
     mTargetStream = nullptr;
     mCurrentlyEncoding = false;
+    mMeasureEncodingTime = false;
+    mInputBytes = 0;
+    mEncodingNanoseconds = 0;
 
     Assign(inTargetWriter, inInitiallyOn);
 }
@@ -110,6 +117,11 @@ void charta::OutputFlateEncodeStream::Assign(charta::IByteWriterWithPosition *in
     if (mCurrentlyEncoding)
         FinalizeEncoding();
     mTargetStream = inWriter;
+    if (mTargetStream != nullptr)
+    {
+        mInputBytes = 0;
+        mEncodingNanoseconds = 0;
+    }
     if (inInitiallyOn && (mTargetStream != nullptr))
         StartEncoding();
 }
@@ -127,6 +139,7 @@ size_t charta::OutputFlateEncodeStream::EncodeBufferAndWrite(const uint8_t *inBu
 {
     int deflateResult;
 
+    mInputBytes += inSize;
     mZLibState->avail_in = (uInt)inSize; // hmm, caveat here...should take care of this sometime.
     mZLibState->next_in = (Bytef *)inBuffer;
 
@@ -134,7 +147,7 @@ size_t charta::OutputFlateEncodeStream::EncodeBufferAndWrite(const uint8_t *inBu
     {
         mZLibState->avail_out = BUFFER_SIZE;
         mZLibState->next_out = mBuffer;
-        deflateResult = deflate(mZLibState, Z_NO_FLUSH);
+        deflateResult = Deflate(Z_NO_FLUSH);
         if (Z_STREAM_ERROR == deflateResult)
         {
             TRACE_LOG1(
@@ -165,6 +178,18 @@ size_t charta::OutputFlateEncodeStream::EncodeBufferAndWrite(const uint8_t *inBu
     return 0;
 }
 
+int charta::OutputFlateEncodeStream::Deflate(int inFlush)
+{
+    if (!mMeasureEncodingTime)
+        return deflate(mZLibState, inFlush);
+
+    auto start = std::chrono::steady_clock::now();
+    int result = deflate(mZLibState, inFlush);
+    mEncodingNanoseconds +=
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
 long long charta::OutputFlateEncodeStream::GetCurrentPosition()
 {
     if (mTargetStream != nullptr)
@@ -183,3 +208,18 @@ void charta::OutputFlateEncodeStream::TurnOffEncoding()
     if (mCurrentlyEncoding)
         FinalizeEncoding();
 }
+
+void charta::OutputFlateEncodeStream::MeasureEncodingTime(bool inMeasure)
+{
+    mMeasureEncodingTime = inMeasure;
+}
+
+unsigned long long charta::OutputFlateEncodeStream::GetInputBytes() const
+{
+    return mInputBytes;
+}
+
+unsigned long long charta::OutputFlateEncodeStream::GetEncodingNanoseconds() const
+{
+    return mEncodingNanoseconds;
+}
@@ -0,0 +1,271 @@
+/*
+   Source File : PredictorKernels.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "io/PredictorKernels.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PREDICTOR_KERNELS_SSE2
+#include <emmintrin.h>
+#endif
+
+/*
+    Sub, Average and Paeth depend on the byte bpp places back, so a row can't be done in wide vectors - the
+    parallelism is within a pixel. The SSE2 versions below take a whole 3 or 4 byte pixel per step, which is the common
+    RGB/RGBA/CMYK case. SSE2 is part of every x86-64 target, so there's no need for runtime dispatch. Everything else
+    is plain loops, which for Up the compiler vectorises by itself.
+*/
+
+static void UnfilterUp(uint8_t *ioRow, const uint8_t *inPriorRow, size_t inRowSize)
+{
+    for (size_t i = 0; i < inRowSize; ++i)
+        ioRow[i] = (uint8_t)(ioRow[i] + inPriorRow[i]);
+}
+
+static void UnfilterSub(uint8_t *ioRow, size_t inRowSize, size_t inBytesPerPixel)
+{
+    for (size_t i = inBytesPerPixel; i < inRowSize; ++i)
+        ioRow[i] = (uint8_t)(ioRow[i] + ioRow[i - inBytesPerPixel]);
+}
+
+static void UnfilterAverage(uint8_t *ioRow, const uint8_t *inPriorRow, size_t inRowSize, size_t inBytesPerPixel)
+{
+    size_t i = 0;
+    for (; i < inBytesPerPixel && i < inRowSize; ++i)
+        ioRow[i] = (uint8_t)(ioRow[i] + (inPriorRow[i] >> 1));
+    for (; i < inRowSize; ++i)
+        ioRow[i] = (uint8_t)(ioRow[i] + ((ioRow[i - inBytesPerPixel] + inPriorRow[i]) >> 1));
+}
+
+static uint8_t PaethPredictor(int inLeft, int inUp, int inUpLeft)
+{
+    int pLeft = abs(inUp - inUpLeft);
+    int pUp = abs(inLeft - inUpLeft);
+    int pUpLeft = abs(inLeft + inUp - 2 * inUpLeft);
+
+    if (pLeft <= pUp && pLeft <= pUpLeft)
+        return (uint8_t)inLeft;
+    if (pUp <= pUpLeft)
+        return (uint8_t)inUp;
+    return (uint8_t)inUpLeft;
+}
+
+static void UnfilterPaeth(uint8_t *ioRow, const uint8_t *inPriorRow, size_t inRowSize, size_t inBytesPerPixel)
+{
+    size_t i = 0;
+    // no left pixel - the predictor is the up one
+    for (; i < inBytesPerPixel && i < inRowSize; ++i)
+        ioRow[i] = (uint8_t)(ioRow[i] + inPriorRow[i]);
+    for (; i < inRowSize; ++i)
+        ioRow[i] = (uint8_t)(ioRow[i] + PaethPredictor(ioRow[i - inBytesPerPixel], inPriorRow[i],
+                                                       inPriorRow[i - inBytesPerPixel]));
+}
+
+#ifdef PREDICTOR_KERNELS_SSE2
+
+template <size_t BytesPerPixel> static __m128i LoadPixel(const uint8_t *inSource)
+{
+    int32_t value = 0;
+    memcpy(&value, inSource, BytesPerPixel);
+    return _mm_cvtsi32_si128(value);
+}
+
+template <size_t BytesPerPixel> static void StorePixel(uint8_t *outTarget, __m128i inValue)
+{
+    int32_t value = _mm_cvtsi128_si32(inValue);
+    memcpy(outTarget, &value, BytesPerPixel);
+}
+
+static __m128i Select(__m128i inCondition, __m128i inThen, __m128i inElse)
+{
+    return _mm_or_si128(_mm_and_si128(inCondition, inThen), _mm_andnot_si128(inCondition, inElse));
+}
+
+static __m128i Abs16(__m128i inValue)
+{
+    return _mm_max_epi16(inValue, _mm_sub_epi16(_mm_setzero_si128(), inValue));
+}
+
+// the vector loops go while a whole pixel is left, the scalar versions finish the row (for rows that don't divide)
+
+template <size_t BytesPerPixel> static void UnfilterSubSSE2(uint8_t *ioRow, size_t inRowSize)
+{
+    __m128i left = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + BytesPerPixel <= inRowSize; i += BytesPerPixel)
+    {
+        left = _mm_add_epi8(LoadPixel<BytesPerPixel>(ioRow + i), left);
+        StorePixel<BytesPerPixel>(ioRow + i, left);
+    }
+    for (; i < inRowSize; ++i)
+        ioRow[i] = (uint8_t)(ioRow[i] + ioRow[i - BytesPerPixel]);
+}
+
+template <size_t BytesPerPixel>
+static void UnfilterAverageSSE2(uint8_t *ioRow, const uint8_t *inPriorRow, size_t inRowSize)
+{
+    __m128i left = _mm_setzero_si128();
+    __m128i one = _mm_set1_epi8(1);
+    size_t i = 0;
+    for (; i + BytesPerPixel <= inRowSize; i += BytesPerPixel)
+    {
+        __m128i up = LoadPixel<BytesPerPixel>(inPriorRow + i);
+        // avg_epu8 rounds up, the filter wants the floor
+        __m128i average = _mm_sub_epi8(_mm_avg_epu8(left, up), _mm_and_si128(_mm_xor_si128(left, up), one));
+        left = _mm_add_epi8(LoadPixel<BytesPerPixel>(ioRow + i), average);
+        StorePixel<BytesPerPixel>(ioRow + i, left);
+    }
+    for (; i < inRowSize; ++i)
+        ioRow[i] = (uint8_t)(ioRow[i] + ((ioRow[i - BytesPerPixel] + inPriorRow[i]) >> 1));
+}
+
+template <size_t BytesPerPixel>
+static void UnfilterPaethSSE2(uint8_t *ioRow, const uint8_t *inPriorRow, size_t inRowSize)
+{
+    __m128i zero = _mm_setzero_si128();
+    __m128i left = zero;   // a, as 16 bit lanes
+    __m128i upLeft = zero; // c
+    size_t i = 0;
+    for (; i + BytesPerPixel <= inRowSize; i += BytesPerPixel)
+    {
+        __m128i up = _mm_unpacklo_epi8(LoadPixel<BytesPerPixel>(inPriorRow + i), zero); // b
+
+        // distances of left + up - upLeft from each of the three
+        __m128i upDelta = _mm_sub_epi16(up, upLeft);
+        __m128i leftDelta = _mm_sub_epi16(left, upLeft);
+        __m128i pLeft = Abs16(upDelta);
+        __m128i pUp = Abs16(leftDelta);
+        __m128i pUpLeft = Abs16(_mm_add_epi16(upDelta, leftDelta));
+        __m128i smallest = _mm_min_epi16(pUpLeft, _mm_min_epi16(pLeft, pUp));
+
+        // ties go to left, then up, then up left
+        __m128i predictor =
+            Select(_mm_cmpeq_epi16(smallest, pLeft), left, Select(_mm_cmpeq_epi16(smallest, pUp), up, upLeft));
+
+        __m128i value = _mm_add_epi8(LoadPixel<BytesPerPixel>(ioRow + i), _mm_packus_epi16(predictor, predictor));
+        StorePixel<BytesPerPixel>(ioRow + i, value);
+
+        left = _mm_unpacklo_epi8(value, zero);
+        upLeft = up;
+    }
+    for (; i < inRowSize; ++i)
+        ioRow[i] = (uint8_t)(ioRow[i] + PaethPredictor(ioRow[i - BytesPerPixel], inPriorRow[i],
+                                                       inPriorRow[i - BytesPerPixel]));
+}
+
+#endif
+
+bool charta::PNGUnfilterRow(uint8_t inFilterType, uint8_t *ioRow, const uint8_t *inPriorRow, size_t inRowSize,
+                            size_t inBytesPerPixel)
+{
+    switch (inFilterType)
+    {
+    case ePNGFilterNone:
+        return true;
+    case ePNGFilterUp:
+        UnfilterUp(ioRow, inPriorRow, inRowSize);
+        return true;
+#ifdef PREDICTOR_KERNELS_SSE2
+    case ePNGFilterSub:
+        if (inBytesPerPixel == 3)
+            UnfilterSubSSE2<3>(ioRow, inRowSize);
+        else if (inBytesPerPixel == 4)
+            UnfilterSubSSE2<4>(ioRow, inRowSize);
+        else
+            UnfilterSub(ioRow, inRowSize, inBytesPerPixel);
+        return true;
+    case ePNGFilterAverage:
+        if (inBytesPerPixel == 3)
+            UnfilterAverageSSE2<3>(ioRow, inPriorRow, inRowSize);
+        else if (inBytesPerPixel == 4)
+            UnfilterAverageSSE2<4>(ioRow, inPriorRow, inRowSize);
+        else
+            UnfilterAverage(ioRow, inPriorRow, inRowSize, inBytesPerPixel);
+        return true;
+    case ePNGFilterPaeth:
+        if (inBytesPerPixel == 3)
+            UnfilterPaethSSE2<3>(ioRow, inPriorRow, inRowSize);
+        else if (inBytesPerPixel == 4)
+            UnfilterPaethSSE2<4>(ioRow, inPriorRow, inRowSize);
+        else
+            UnfilterPaeth(ioRow, inPriorRow, inRowSize, inBytesPerPixel);
+        return true;
+#else
+    case ePNGFilterSub:
+        UnfilterSub(ioRow, inRowSize, inBytesPerPixel);
+        return true;
+    case ePNGFilterAverage:
+        UnfilterAverage(ioRow, inPriorRow, inRowSize, inBytesPerPixel);
+        return true;
+    case ePNGFilterPaeth:
+        UnfilterPaeth(ioRow, inPriorRow, inRowSize, inBytesPerPixel);
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+// PDF colour spaces have at most 32 components
+static const size_t scMaxPackedColors = 32;
+
+void charta::TIFFUndifferenceRow(uint8_t *ioRow, size_t inColumns, size_t inColors, uint8_t inBitsPerComponent)
+{
+    size_t componentsCount = inColumns * inColors;
+
+    if (8 == inBitsPerComponent)
+    {
+        for (size_t i = inColors; i < componentsCount; ++i)
+            ioRow[i] = (uint8_t)(ioRow[i] + ioRow[i - inColors]);
+    }
+    else if (16 == inBitsPerComponent)
+    {
+        // big endian pairs. the carry from the low byte makes this a 16 bit add
+        for (size_t i = inColors; i < componentsCount; ++i)
+        {
+            uint8_t *component = ioRow + i * 2;
+            const uint8_t *previous = ioRow + (i - inColors) * 2;
+            unsigned int value = ((component[0] << 8) | component[1]) + ((previous[0] << 8) | previous[1]);
+            component[0] = (uint8_t)(value >> 8);
+            component[1] = (uint8_t)value;
+        }
+    }
+    else if (inBitsPerComponent > 0 && inBitsPerComponent < 8)
+    {
+        // components packed from the high bits of each byte. keep the last value of each color on the side
+        if (inColors > scMaxPackedColors)
+            return;
+        unsigned int mask = (1u << inBitsPerComponent) - 1;
+        unsigned int previous[scMaxPackedColors] = {0};
+        for (size_t i = 0; i < componentsCount; ++i)
+        {
+            size_t bitPosition = i * inBitsPerComponent;
+            uint8_t *target = ioRow + bitPosition / 8;
+            int shift = 8 - inBitsPerComponent - (int)(bitPosition % 8);
+            unsigned int value = (*target >> shift) & mask;
+            if (i >= inColors)
+                value = (value + previous[i % inColors]) & mask;
+            previous[i % inColors] = value;
+            *target = (uint8_t)((*target & ~(mask << shift)) | (value << shift));
+        }
+    }
+}
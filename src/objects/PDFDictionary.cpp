@@ -20,37 +20,107 @@
 */
 #include "objects/PDFDictionary.h"
 
+// up to this size lookups scan the entries, past it a hash index is kept
+static const size_t scFlatLookupLimit = 16;
+
 charta::PDFDictionary::PDFDictionary() : PDFObject(eType)
 {
 }
 
-std::shared_ptr<charta::PDFObject> charta::PDFDictionary::QueryDirectObject(const std::string &inName)
+charta::PDFDictionary::PDFDictionary(std::pmr::memory_resource *inResource) : PDFObject(eType), mValues(inResource)
 {
-    auto key = std::make_shared<PDFName>(inName);
-    auto it = mValues.find(key);
+}
 
-    if (it == mValues.end())
+long charta::PDFDictionary::FindEntry(std::string_view inName)
+{
+    if (mValues.size() <= scFlatLookupLimit)
     {
-        return nullptr;
+        for (size_t i = 0; i < mValues.size(); ++i)
+        {
+            if (mValues[i].first->GetValue() == inName)
+                return (long)i;
+        }
+        return -1;
     }
 
-    return it->second;
+    auto it = mIndex->find(inName);
+    return it == mIndex->end() ? -1 : (long)it->second;
+}
+
+long charta::PDFDictionary::FindEntry(const std::shared_ptr<PDFName> &inName)
+{
+    if (mValues.size() > scFlatLookupLimit)
+        return FindEntry(std::string_view(inName->GetValue()));
+
+    // well known names have a single object, so when both sides are well known, pointers tell it all
+    bool isWellKnown = inName->IsWellKnown();
+    for (size_t i = 0; i < mValues.size(); ++i)
+    {
+        const std::shared_ptr<PDFName> &key = mValues[i].first;
+        if (key == inName)
+            return (long)i;
+        if ((!isWellKnown || !key->IsWellKnown()) && key->GetValue() == inName->GetValue())
+            return (long)i;
+    }
+    return -1;
+}
+
+std::shared_ptr<charta::PDFObject> charta::PDFDictionary::QueryDirectObject(const std::string &inName)
+{
+    long index = FindEntry(std::string_view(inName));
+    return index < 0 ? nullptr : mValues[index].second;
+}
+
+std::shared_ptr<charta::PDFObject> charta::PDFDictionary::QueryDirectObject(const std::shared_ptr<PDFName> &inName)
+{
+    long index = FindEntry(inName);
+    return index < 0 ? nullptr : mValues[index].second;
+}
+
+std::shared_ptr<charta::PDFObject> charta::PDFDictionary::QueryDirectObject(EPDFWellKnownName inName)
+{
+    return QueryDirectObject(PDFNameTable::WellKnown(inName));
 }
 
 void charta::PDFDictionary::Insert(const std::shared_ptr<charta::PDFName> &inKeyObject,
                                    const std::shared_ptr<charta::PDFObject> &inValueObject)
 {
-    mValues.insert({inKeyObject, inValueObject});
+    if (FindEntry(inKeyObject) >= 0)
+        return;
+
+    mValues.emplace_back(inKeyObject, inValueObject);
+
+    // the index is built while filling the dictionary, so that lookups don't change it. parsed dictionaries may be
+    // shared between threads reading the same document
+    if (mIndex)
+    {
+        mIndex->insert({std::string_view(inKeyObject->GetValue()), mValues.size() - 1});
+    }
+    else if (mValues.size() > scFlatLookupLimit)
+    {
+        mIndex = std::make_unique<std::unordered_map<std::string_view, size_t>>();
+        mIndex->reserve(mValues.size() * 2);
+        for (size_t i = 0; i < mValues.size(); ++i)
+            mIndex->insert({std::string_view(mValues[i].first->GetValue()), i});
+    }
 }
 
 bool charta::PDFDictionary::Exists(const std::string &inName)
 {
-    auto key = std::make_shared<PDFName>(inName);
-    return mValues.find(key) != mValues.end();
+    return FindEntry(std::string_view(inName)) >= 0;
+}
+
+bool charta::PDFDictionary::Exists(EPDFWellKnownName inName)
+{
+    return FindEntry(PDFNameTable::WellKnown(inName)) >= 0;
 }
 
-MapIterator<std::map<std::shared_ptr<charta::PDFName>, std::shared_ptr<charta::PDFObject>, charta::PDFNameLess>>
-charta::PDFDictionary::GetIterator()
+size_t charta::PDFDictionary::GetLength() const
+{
+    return mValues.size();
+}
+
+MapIterator<charta::PDFDictionaryEntries> charta::PDFDictionary::GetIterator()
 {
     return {mValues};
-}
\ No newline at end of file
+}
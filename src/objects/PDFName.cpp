@@ -20,7 +20,12 @@
 */
 #include "objects/PDFName.h"
 
-charta::PDFName::PDFName(const std::string &inValue) : PDFObject(eType), mValue(inValue)
+charta::PDFName::PDFName(const std::string &inValue) : PDFObject(eType), mValue(inValue), mIsWellKnown(false)
+{
+}
+
+charta::PDFName::PDFName(const std::string &inValue, bool inIsWellKnown)
+    : PDFObject(eType), mValue(inValue), mIsWellKnown(inIsWellKnown)
 {
 }
 
@@ -33,3 +38,8 @@ charta::PDFName::operator std::string() const
 {
     return mValue;
 }
+
+bool charta::PDFName::IsWellKnown() const
+{
+    return mIsWellKnown;
+}
@@ -0,0 +1,92 @@
+/*
+   Source File : PDFNameTable.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "objects/PDFNameTable.h"
+
+#include <vector>
+
+namespace
+{
+// must follow the order of EPDFWellKnownName
+const char *scWellKnownNames[charta::ePDFWellKnownNamesCount] = {
+    "Type", "Subtype", "Length", "Filter", "DecodeParms", "DL", "Resources", "Contents", "Kids", "Count", "Parent",
+    "Page", "Pages", "Root", "Info", "Encrypt", "ID", "Size", "Prev", "XRefStm", "W", "Index", "N", "First",
+    "MediaBox", "CropBox", "Rotate", "Annots", "Font", "XObject", "ExtGState", "ColorSpace", "Pattern", "Shading",
+    "ProcSet", "Properties", "BaseFont", "Encoding", "ToUnicode", "Width", "Height", "BitsPerComponent", "Predictor",
+    "Columns", "Colors", "EarlyChange", "Name"};
+} // namespace
+
+struct charta::PDFNameTable::WellKnownNames
+{
+    WellKnownNames()
+    {
+        for (int i = 0; i < ePDFWellKnownNamesCount; ++i)
+        {
+            std::shared_ptr<PDFName> name(new PDFName(scWellKnownNames[i], true));
+            mByValue.insert({std::string_view(name->GetValue()), i});
+            mAtoms.push_back(name);
+        }
+    }
+
+    std::vector<std::shared_ptr<PDFName>> mAtoms;
+    std::unordered_map<std::string_view, int> mByValue;
+};
+
+const charta::PDFNameTable::WellKnownNames &charta::PDFNameTable::GetWellKnownNames()
+{
+    static WellKnownNames names;
+    return names;
+}
+
+charta::PDFNameTable::PDFNameTable() = default;
+
+std::shared_ptr<charta::PDFName> charta::PDFNameTable::Intern(std::string_view inValue)
+{
+    auto it = mNames.find(inValue);
+    if (it != mNames.end())
+        return it->second;
+
+    const std::shared_ptr<PDFName> *wellKnown = FindWellKnown(inValue);
+    std::shared_ptr<PDFName> name = wellKnown != nullptr ? *wellKnown : std::make_shared<PDFName>(std::string(inValue));
+    mNames.insert({std::string_view(name->GetValue()), name});
+    return name;
+}
+
+size_t charta::PDFNameTable::GetSize() const
+{
+    return mNames.size();
+}
+
+void charta::PDFNameTable::Clear()
+{
+    mNames.clear();
+}
+
+const std::shared_ptr<charta::PDFName> &charta::PDFNameTable::WellKnown(EPDFWellKnownName inName)
+{
+    return GetWellKnownNames().mAtoms[inName];
+}
+
+const std::shared_ptr<charta::PDFName> *charta::PDFNameTable::FindWellKnown(std::string_view inValue)
+{
+    const WellKnownNames &names = GetWellKnownNames();
+    auto it = names.mByValue.find(inValue);
+    return it == names.mByValue.end() ? nullptr : &names.mAtoms[it->second];
+}
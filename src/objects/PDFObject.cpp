@@ -41,12 +41,15 @@ charta::PDFObject::PDFObject(int inType)
 
 charta::PDFObject::~PDFObject()
 {
-    auto it = mMetadata.begin();
-    for (; it != mMetadata.end(); ++it)
+    if (!mMetadata)
+        return;
+
+    auto it = mMetadata->begin();
+    for (; it != mMetadata->end(); ++it)
     {
         it->second->DeleteMe();
     }
-    mMetadata.clear();
+    mMetadata->clear();
 }
 
 charta::PDFObject::EPDFObjectType charta::PDFObject::GetType()
@@ -59,27 +62,35 @@ void charta::PDFObject::SetMetadata(const std::string &inKey, charta::IDeletable
     // delete old metadata
     DeleteMetadata(inKey);
 
-    mMetadata.insert(StringToIDeletable::value_type(inKey, inValue));
+    if (!mMetadata)
+        mMetadata = std::make_unique<StringToIDeletable>();
+    mMetadata->insert(StringToIDeletable::value_type(inKey, inValue));
 }
 
 charta::IDeletable *charta::PDFObject::GetMetadata(const std::string &inKey)
 {
-    auto it = mMetadata.find(inKey);
+    if (!mMetadata)
+        return nullptr;
+
+    auto it = mMetadata->find(inKey);
 
-    if (it == mMetadata.end())
+    if (it == mMetadata->end())
         return nullptr;
     return it->second;
 }
 
 charta::IDeletable *charta::PDFObject::DetachMetadata(const std::string &inKey)
 {
-    auto it = mMetadata.find(inKey);
+    if (!mMetadata)
+        return nullptr;
+
+    auto it = mMetadata->find(inKey);
 
-    if (it == mMetadata.end())
+    if (it == mMetadata->end())
         return nullptr;
 
     charta::IDeletable *result = it->second;
-    mMetadata.erase(it);
+    mMetadata->erase(it);
     return result;
 }
 
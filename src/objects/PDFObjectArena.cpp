@@ -0,0 +1,48 @@
+/*
+   Source File : PDFObjectArena.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "objects/PDFObjectArena.h"
+
+charta::PDFObjectArena::PDFObjectArena(size_t inInitialBlockSize) : mBuffer(inInitialBlockSize), mAllocatedSize(0)
+{
+}
+
+charta::PDFObjectArena::~PDFObjectArena() = default;
+
+size_t charta::PDFObjectArena::GetAllocatedSize() const
+{
+    return mAllocatedSize;
+}
+
+void *charta::PDFObjectArena::do_allocate(size_t inBytes, size_t inAlignment)
+{
+    mAllocatedSize += inBytes;
+    return mBuffer.allocate(inBytes, inAlignment);
+}
+
+void charta::PDFObjectArena::do_deallocate(void * /*inPointer*/, size_t /*inBytes*/, size_t /*inAlignment*/)
+{
+    // memory is released with the arena
+}
+
+bool charta::PDFObjectArena::do_is_equal(const std::pmr::memory_resource &inOther) const noexcept
+{
+    return this == &inOther;
+}
@@ -27,12 +27,22 @@
 #include "objects/PDFName.h"
 #include "objects/helpers/ParsedPrimitiveHelper.h"
 #include "parsing/PDFParser.h"
+#include "parsing/PDFParserReader.h"
 #include <utility>
 
 charta::PDFPageInput::PDFPageInput(PDFParser *inParser, std::shared_ptr<charta::PDFObject> inPageObject)
     : mPageObject(std::move(inPageObject))
 {
     mParser = inParser;
+    mParserReader = nullptr;
+    AssertPageObjectValid();
+}
+
+charta::PDFPageInput::PDFPageInput(PDFParserReader *inParserReader, std::shared_ptr<charta::PDFObject> inPageObject)
+    : mPageObject(std::move(inPageObject))
+{
+    mParser = inParserReader->GetParser();
+    mParserReader = inParserReader;
     AssertPageObjectValid();
 }
 
@@ -41,7 +51,7 @@ void charta::PDFPageInput::AssertPageObjectValid()
     if (!mPageObject)
         TRACE_LOG("charta::PDFPageInput::AssertPageObjectValid, null page object or not a dictionary");
 
-    PDFObjectCastPtr<charta::PDFName> typeObject = mPageObject->QueryDirectObject("Type");
+    PDFObjectCastPtr<charta::PDFName> typeObject = mPageObject->QueryDirectObject(ePDFNameType);
     if (!typeObject || typeObject->GetValue() != "Page")
     {
         TRACE_LOG("charta::PDFPageInput::AssertPageObjectValid, dictionar object provided is NOT a page object");
@@ -52,6 +62,7 @@ void charta::PDFPageInput::AssertPageObjectValid()
 charta::PDFPageInput::PDFPageInput(PDFParser *inParser, const PDFObjectCastPtr<charta::PDFDictionary> &inPageObject)
 {
     mParser = inParser;
+    mParserReader = nullptr;
     mPageObject = inPageObject;
     AssertPageObjectValid();
 }
@@ -59,6 +70,7 @@ charta::PDFPageInput::PDFPageInput(PDFParser *inParser, const PDFObjectCastPtr<c
 charta::PDFPageInput::PDFPageInput(const PDFPageInput &inOtherPage)
 {
     mParser = inOtherPage.mParser;
+    mParserReader = inOtherPage.mParserReader;
     mPageObject = inOtherPage.mPageObject;
     AssertPageObjectValid();
 }
@@ -160,11 +172,14 @@ std::shared_ptr<charta::PDFObject> charta::PDFPageInput::QueryInheritedValue(
 {
     if (inDictionary->Exists(inName))
     {
-        return mParser->QueryDictionaryObject(inDictionary, inName);
+        return mParserReader != nullptr ? mParserReader->QueryDictionaryObject(inDictionary, inName)
+                                        : mParser->QueryDictionaryObject(inDictionary, inName);
     }
     if (inDictionary->Exists(scParent))
     {
-        PDFObjectCastPtr<charta::PDFDictionary> parent(mParser->QueryDictionaryObject(inDictionary, scParent));
+        PDFObjectCastPtr<charta::PDFDictionary> parent(
+            mParserReader != nullptr ? mParserReader->QueryDictionaryObject(inDictionary, scParent)
+                                     : mParser->QueryDictionaryObject(inDictionary, scParent));
         if (!parent)
             return nullptr;
         return QueryInheritedValue(parent, inName);
@@ -0,0 +1,615 @@
+/*
+   Source File : ContentStreamReader.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "parsing/ContentStreamReader.h"
+#include "Trace.h"
+#include "objects/PDFArray.h"
+#include "objects/PDFDictionary.h"
+#include "objects/PDFObjectCast.h"
+#include "objects/PDFStreamInput.h"
+#include "parsing/PDFParser.h"
+
+#include <string.h>
+
+using namespace charta;
+
+enum ECharacterClass
+{
+    eCharacterRegular = 0,
+    eCharacterWhiteSpace = 1,
+    eCharacterDelimiter = 2
+};
+
+struct CharacterClasses
+{
+    uint8_t mClasses[256];
+
+    CharacterClasses() : mClasses()
+    {
+        for (uint8_t whiteSpace : {0, 9, 10, 12, 13, 32})
+            mClasses[whiteSpace] = eCharacterWhiteSpace;
+        for (uint8_t delimiter : {'(', ')', '<', '>', '[', ']', '{', '}', '/', '%'})
+            mClasses[delimiter] = eCharacterDelimiter;
+    }
+};
+static const CharacterClasses scCharacterClasses;
+
+static bool IsWhiteSpace(uint8_t inCharacter)
+{
+    return scCharacterClasses.mClasses[inCharacter] == eCharacterWhiteSpace;
+}
+
+static bool IsRegular(uint8_t inCharacter)
+{
+    return scCharacterClasses.mClasses[inCharacter] == eCharacterRegular;
+}
+
+static const double scPowersOf10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,
+                                      1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18};
+
+static bool ParseNumber(std::string_view inToken, double &outValue, bool &outIsInteger)
+{
+    const char *it = inToken.data();
+    const char *end = it + inToken.size();
+    bool negative = false;
+    if (it < end && (*it == '+' || *it == '-'))
+    {
+        negative = *it == '-';
+        ++it;
+    }
+
+    double value = 0;
+    bool hasDigits = false;
+    while (it < end && *it >= '0' && *it <= '9')
+    {
+        value = value * 10 + (*it - '0');
+        hasDigits = true;
+        ++it;
+    }
+
+    outIsInteger = true;
+    if (it < end && *it == '.')
+    {
+        outIsInteger = false;
+        ++it;
+        // fraction digits are collected as an integer and scaled once, to avoid accumulating rounding errors
+        unsigned long long fraction = 0;
+        size_t fractionDigits = 0;
+        while (it < end && *it >= '0' && *it <= '9')
+        {
+            if (fractionDigits < 18)
+            {
+                fraction = fraction * 10 + (*it - '0');
+                ++fractionDigits;
+            }
+            hasDigits = true;
+            ++it;
+        }
+        value += (double)fraction / scPowersOf10[fractionDigits];
+    }
+
+    if (!hasDigits || it != end)
+        return false;
+    outValue = negative ? -value : value;
+    return true;
+}
+
+ContentStreamReader::ContentStreamReader()
+{
+    mContent = nullptr;
+    mSize = 0;
+    mPosition = 0;
+}
+
+void ContentStreamReader::Start(const uint8_t *inContent, size_t inSize)
+{
+    mContent = inContent;
+    mSize = inSize;
+    mPosition = 0;
+}
+
+size_t ContentStreamReader::SkipWhiteSpacesAndComments(size_t inPosition) const
+{
+    while (inPosition < mSize)
+    {
+        uint8_t character = mContent[inPosition];
+        if (IsWhiteSpace(character))
+        {
+            ++inPosition;
+        }
+        else if (character == '%')
+        {
+            while (inPosition < mSize && mContent[inPosition] != '\n' && mContent[inPosition] != '\r')
+                ++inPosition;
+        }
+        else
+        {
+            break;
+        }
+    }
+    return inPosition;
+}
+
+size_t ContentStreamReader::FindTokenEnd(size_t inPosition) const
+{
+    while (inPosition < mSize && IsRegular(mContent[inPosition]))
+        ++inPosition;
+    return inPosition;
+}
+
+static ContentStreamOperand MakeOperand(EContentStreamOperandType inType, const uint8_t *inToken, size_t inTokenSize,
+                                        size_t inPosition)
+{
+    ContentStreamOperand operand;
+    operand.mType = inType;
+    operand.mToken = std::string_view((const char *)inToken, inTokenSize);
+    operand.mNumber = 0;
+    operand.mIsInteger = false;
+    operand.mBoolean = false;
+    operand.mElementsCount = 0;
+    operand.mPosition = inPosition;
+    return operand;
+}
+
+void ContentStreamReader::CloseContainer(EContentStreamOperandType inType)
+{
+    // stray closing delimiters are ignored
+    if (mOpenContainers.empty() || mOperands[mOpenContainers.back()].mType != inType)
+        return;
+
+    mOperands[mOpenContainers.back()].mElementsCount = mOperands.size() - mOpenContainers.back() - 1;
+    mOpenContainers.pop_back();
+}
+
+void ContentStreamReader::CloseOpenContainers()
+{
+    while (!mOpenContainers.empty())
+        CloseContainer(mOperands[mOpenContainers.back()].mType);
+}
+
+bool ContentStreamReader::ReadToken(std::string_view &outKeyword, size_t &outKeywordPosition)
+{
+    outKeyword = std::string_view();
+
+    mPosition = SkipWhiteSpacesAndComments(mPosition);
+    if (mPosition >= mSize)
+        return false;
+
+    size_t tokenStart = mPosition;
+    switch (mContent[mPosition])
+    {
+    case '[':
+        mOpenContainers.push_back(mOperands.size());
+        mOperands.push_back(MakeOperand(eContentStreamOperandArray, mContent + tokenStart, 1, tokenStart));
+        ++mPosition;
+        break;
+    case ']':
+        CloseContainer(eContentStreamOperandArray);
+        ++mPosition;
+        break;
+    case '<':
+        if (mPosition + 1 < mSize && mContent[mPosition + 1] == '<')
+        {
+            mOpenContainers.push_back(mOperands.size());
+            mOperands.push_back(MakeOperand(eContentStreamOperandDictionary, mContent + tokenStart, 2, tokenStart));
+            mPosition += 2;
+        }
+        else
+        {
+            auto hexEnd = (const uint8_t *)memchr(mContent + tokenStart + 1, '>', mSize - tokenStart - 1);
+            size_t end = hexEnd == nullptr ? mSize : hexEnd - mContent;
+            mOperands.push_back(MakeOperand(eContentStreamOperandHexString, mContent + tokenStart + 1,
+                                            end - tokenStart - 1, tokenStart));
+            mPosition = end < mSize ? end + 1 : mSize;
+        }
+        break;
+    case '>':
+        if (mPosition + 1 < mSize && mContent[mPosition + 1] == '>')
+        {
+            CloseContainer(eContentStreamOperandDictionary);
+            mPosition += 2;
+        }
+        else
+        {
+            ++mPosition;
+        }
+        break;
+    case '(': {
+        size_t depth = 1;
+        size_t position = tokenStart + 1;
+        for (; position < mSize; ++position)
+        {
+            uint8_t character = mContent[position];
+            if (character == '\\')
+                ++position;
+            else if (character == '(')
+                ++depth;
+            else if (character == ')' && --depth == 0)
+                break;
+        }
+        size_t end = position < mSize ? position : mSize;
+        mOperands.push_back(MakeOperand(eContentStreamOperandLiteralString, mContent + tokenStart + 1,
+                                        end - tokenStart - 1, tokenStart));
+        mPosition = end < mSize ? end + 1 : mSize;
+        break;
+    }
+    case '/': {
+        size_t end = FindTokenEnd(tokenStart + 1);
+        mOperands.push_back(
+            MakeOperand(eContentStreamOperandName, mContent + tokenStart + 1, end - tokenStart - 1, tokenStart));
+        mPosition = end;
+        break;
+    }
+    case ')':
+    case '{':
+    case '}':
+        // not expected in content streams. skip
+        ++mPosition;
+        break;
+    default: {
+        size_t end = FindTokenEnd(tokenStart);
+        std::string_view token((const char *)mContent + tokenStart, end - tokenStart);
+        mPosition = end;
+
+        ContentStreamOperand operand =
+            MakeOperand(eContentStreamOperandNumber, mContent + tokenStart, end - tokenStart, tokenStart);
+        if (ParseNumber(token, operand.mNumber, operand.mIsInteger))
+        {
+            mOperands.push_back(operand);
+        }
+        else if (token == "true" || token == "false")
+        {
+            operand.mType = eContentStreamOperandBoolean;
+            operand.mBoolean = token == "true";
+            mOperands.push_back(operand);
+        }
+        else if (token == "null")
+        {
+            operand.mType = eContentStreamOperandNull;
+            mOperands.push_back(operand);
+        }
+        else
+        {
+            outKeyword = token;
+            outKeywordPosition = tokenStart;
+        }
+        break;
+    }
+    }
+    return true;
+}
+
+bool ContentStreamReader::Next(ContentStreamOperator &outOperator)
+{
+    mOperands.clear();
+    mOpenContainers.clear();
+
+    std::string_view keyword;
+    size_t keywordPosition = 0;
+    while (ReadToken(keyword, keywordPosition))
+    {
+        if (keyword.empty())
+            continue;
+
+        CloseOpenContainers();
+        outOperator.mOperator = keyword;
+        outOperator.mPosition = keywordPosition;
+        outOperator.mInlineImageData = nullptr;
+        outOperator.mInlineImageSize = 0;
+        if (keyword == "BI" && !ReadInlineImage(outOperator))
+            return false;
+        outOperator.mOperands = mOperands.data();
+        outOperator.mOperandsCount = mOperands.size();
+        return true;
+    }
+    return false;
+}
+
+// a few bytes of what follows a candidate EI, to tell the end of the image from image data that happens to have
+// "EI" in it. content is text, image data rarely is
+static bool LooksLikeContent(const uint8_t *inBytes, size_t inSize)
+{
+    for (size_t i = 0; i < inSize && i < 8; ++i)
+        if ((inBytes[i] < 0x20 && !IsWhiteSpace(inBytes[i])) || inBytes[i] > 0x7e)
+            return false;
+    return true;
+}
+
+static long long FindInlineImageLength(const std::vector<ContentStreamOperand> &inOperands)
+{
+    // top level entries only, skipping over array and dictionary values
+    for (size_t i = 0; i + 1 < inOperands.size(); i += 2 + inOperands[i + 1].mElementsCount)
+    {
+        const ContentStreamOperand &value = inOperands[i + 1];
+        if (inOperands[i].mType == eContentStreamOperandName &&
+            (inOperands[i].mToken == "L" || inOperands[i].mToken == "Length") &&
+            value.mType == eContentStreamOperandNumber && value.mIsInteger && value.mNumber >= 0)
+            return (long long)value.mNumber;
+    }
+    return -1;
+}
+
+bool ContentStreamReader::ReadInlineImage(ContentStreamOperator &outOperator)
+{
+    // BI has no operands, what's read from here on is the image dictionary
+    mOperands.clear();
+
+    std::string_view keyword;
+    size_t keywordPosition = 0;
+    bool foundData = false;
+    while (!foundData && ReadToken(keyword, keywordPosition))
+        foundData = keyword == "ID";
+    if (!foundData)
+        return false;
+    CloseOpenContainers();
+
+    // a single white space separates ID from the data
+    size_t dataStart = mPosition < mSize ? mPosition + 1 : mSize;
+
+    // PDF 2.0 images may state their length. trust it if EI is where it says
+    long long length = FindInlineImageLength(mOperands);
+    if (length >= 0 && (unsigned long long)length <= mSize - dataStart)
+    {
+        size_t afterData = SkipWhiteSpacesAndComments(dataStart + (size_t)length);
+        if (afterData + 1 < mSize && mContent[afterData] == 'E' && mContent[afterData + 1] == 'I' &&
+            (afterData + 2 == mSize || !IsRegular(mContent[afterData + 2])))
+        {
+            outOperator.mInlineImageData = mContent + dataStart;
+            outOperator.mInlineImageSize = (size_t)length;
+            mPosition = afterData + 2;
+            return true;
+        }
+    }
+
+    // otherwise look for EI, between white spaces, and followed by what looks like content
+    size_t searchFrom = dataStart;
+    while (searchFrom < mSize)
+    {
+        auto candidate = (const uint8_t *)memchr(mContent + searchFrom, 'E', mSize - searchFrom);
+        if (candidate == nullptr)
+            break;
+        size_t position = candidate - mContent;
+        if (position + 1 < mSize && mContent[position + 1] == 'I' &&
+            (position == dataStart || IsWhiteSpace(mContent[position - 1])) &&
+            (position + 2 == mSize ||
+             (!IsRegular(mContent[position + 2]) && LooksLikeContent(candidate + 2, mSize - position - 2))))
+        {
+            size_t dataEnd = position > dataStart ? position - 1 : position;
+            outOperator.mInlineImageData = mContent + dataStart;
+            outOperator.mInlineImageSize = dataEnd - dataStart;
+            mPosition = position + 2;
+            return true;
+        }
+        searchFrom = position + 1;
+    }
+
+    // no end. take the rest as data
+    outOperator.mInlineImageData = mContent + dataStart;
+    outOperator.mInlineImageSize = mSize - dataStart;
+    mPosition = mSize;
+    return true;
+}
+
+EStatusCode ContentStreamReader::Read(const uint8_t *inContent, size_t inSize, IContentStreamVisitor *inVisitor)
+{
+    Start(inContent, inSize);
+
+    ContentStreamOperator anOperator;
+    while (Next(anOperator))
+        if (!inVisitor->OnOperator(anOperator))
+            break;
+    return eSuccess;
+}
+
+EStatusCode ContentStreamReader::ReadStream(PDFParser *inParser,
+                                            const std::shared_ptr<charta::PDFStreamInput> &inStream,
+                                            IContentStreamVisitor *inVisitor)
+{
+    EStatusCode status = inParser->DecodeStreamToBuffer(inStream, mContentBuffer);
+    if (status != eSuccess)
+    {
+        TRACE_LOG("ContentStreamReader::ReadStream, failed to decode content stream");
+        return status;
+    }
+    return Read(mContentBuffer.data(), mContentBuffer.size(), inVisitor);
+}
+
+EStatusCode ContentStreamReader::ReadPageContents(PDFParser *inParser, unsigned long inPageIndex,
+                                                  IContentStreamVisitor *inVisitor)
+{
+    std::shared_ptr<PDFDictionary> page = inParser->ParsePage(inPageIndex);
+    if (!page)
+    {
+        TRACE_LOG1("ContentStreamReader::ReadPageContents, failed to parse page %ld", inPageIndex);
+        return eFailure;
+    }
+
+    std::shared_ptr<PDFObject> contents = inParser->QueryDictionaryObject(page, ePDFNameContents);
+    if (!contents) // no content, nothing to read
+        return eSuccess;
+
+    if (contents->GetType() == PDFObject::ePDFObjectStream)
+        return ReadStream(inParser, std::static_pointer_cast<charta::PDFStreamInput>(contents), inVisitor);
+
+    if (contents->GetType() != PDFObject::ePDFObjectArray)
+    {
+        TRACE_LOG1("ContentStreamReader::ReadPageContents, unexpected contents type for page %ld", inPageIndex);
+        return eFailure;
+    }
+
+    // the streams of an array are one content, split at token boundaries. read them as one
+    PDFObjectCastPtr<PDFArray> contentsArray(contents);
+    mContentBuffer.clear();
+    for (unsigned long i = 0; i < contentsArray->GetLength(); ++i)
+    {
+        PDFObjectCastPtr<charta::PDFStreamInput> stream(inParser->QueryArrayObject(contentsArray, i));
+        if (!stream)
+        {
+            TRACE_LOG1("ContentStreamReader::ReadPageContents, unexpected contents array member for page %ld",
+                       inPageIndex);
+            return eFailure;
+        }
+        EStatusCode status = inParser->DecodeStreamToBuffer(stream, mStreamBuffer);
+        if (status != eSuccess)
+        {
+            TRACE_LOG("ContentStreamReader::ReadPageContents, failed to decode content stream");
+            return status;
+        }
+        mContentBuffer.insert(mContentBuffer.end(), mStreamBuffer.begin(), mStreamBuffer.end());
+        mContentBuffer.push_back('\n');
+    }
+    return Read(mContentBuffer.data(), mContentBuffer.size(), inVisitor);
+}
+
+static int HexValue(uint8_t inCharacter)
+{
+    if (inCharacter >= '0' && inCharacter <= '9')
+        return inCharacter - '0';
+    if (inCharacter >= 'A' && inCharacter <= 'F')
+        return inCharacter - 'A' + 10;
+    if (inCharacter >= 'a' && inCharacter <= 'f')
+        return inCharacter - 'a' + 10;
+    return -1;
+}
+
+std::string ContentStreamReader::DecodeName(const ContentStreamOperand &inOperand)
+{
+    std::string result;
+    std::string_view token = inOperand.mToken;
+    result.reserve(token.size());
+    for (size_t i = 0; i < token.size(); ++i)
+    {
+        int high, low;
+        if (token[i] == '#' && i + 2 < token.size() && (high = HexValue(token[i + 1])) >= 0 &&
+            (low = HexValue(token[i + 2])) >= 0)
+        {
+            result.push_back((char)(high * 16 + low));
+            i += 2;
+        }
+        else
+        {
+            result.push_back(token[i]);
+        }
+    }
+    return result;
+}
+
+static void DecodeHexString(std::string_view inToken, std::string &result)
+{
+    result.reserve(inToken.size() / 2 + 1);
+    int high = -1;
+    for (char character : inToken)
+    {
+        int value = HexValue((uint8_t)character);
+        if (value < 0)
+            continue;
+        if (high < 0)
+        {
+            high = value;
+        }
+        else
+        {
+            result.push_back((char)(high * 16 + value));
+            high = -1;
+        }
+    }
+    if (high >= 0) // odd count, last digit is followed by an implicit 0
+        result.push_back((char)(high * 16));
+}
+
+static void DecodeLiteralString(std::string_view inToken, std::string &result)
+{
+    result.reserve(inToken.size());
+    for (size_t i = 0; i < inToken.size(); ++i)
+    {
+        char character = inToken[i];
+        if (character == '\r')
+        {
+            // end of lines read as \n
+            if (i + 1 < inToken.size() && inToken[i + 1] == '\n')
+                ++i;
+            result.push_back('\n');
+            continue;
+        }
+        if (character != '\\' || i + 1 == inToken.size())
+        {
+            result.push_back(character);
+            continue;
+        }
+
+        character = inToken[++i];
+        switch (character)
+        {
+        case 'n':
+            result.push_back('\n');
+            break;
+        case 'r':
+            result.push_back('\r');
+            break;
+        case 't':
+            result.push_back('\t');
+            break;
+        case 'b':
+            result.push_back('\b');
+            break;
+        case 'f':
+            result.push_back('\f');
+            break;
+        case '\r':
+            // line continuation
+            if (i + 1 < inToken.size() && inToken[i + 1] == '\n')
+                ++i;
+            break;
+        case '\n':
+            break;
+        default:
+            if (character >= '0' && character <= '7')
+            {
+                int value = character - '0';
+                for (int digits = 1; digits < 3 && i + 1 < inToken.size() && inToken[i + 1] >= '0' &&
+                                     inToken[i + 1] <= '7';
+                     ++digits)
+                    value = value * 8 + (inToken[++i] - '0');
+                result.push_back((char)value);
+            }
+            else
+            {
+                // \( \) \\ and unknown escapes, which stand for the character itself
+                result.push_back(character);
+            }
+        }
+    }
+}
+
+std::string ContentStreamReader::DecodeString(const ContentStreamOperand &inOperand)
+{
+    std::string result;
+    DecodeString(inOperand, result);
+    return result;
+}
+
+void ContentStreamReader::DecodeString(const ContentStreamOperand &inOperand, std::string &outString)
+{
+    outString.clear();
+    if (inOperand.mType == eContentStreamOperandHexString)
+        DecodeHexString(inOperand.mToken, outString);
+    else
+        DecodeLiteralString(inOperand.mToken, outString);
+}
@@ -71,6 +71,16 @@ charta::EStatusCode PDFDocumentCopyingContext::Start(PDFParser *inPDFParser, Doc
     return mDocumentHandler.StartParserCopyingContext(inPDFParser);
 }
 
+charta::EStatusCode PDFDocumentCopyingContext::Start(PDFParserReader *inParserReader,
+                                                     DocumentContext *inDocumentContext,
+                                                     ObjectsContext *inObjectsContext)
+{
+    mDocumentContext = inDocumentContext;
+    inDocumentContext->RegisterCopyingContext(this);
+    mDocumentHandler.SetOperationsContexts(inDocumentContext, inObjectsContext);
+    return mDocumentHandler.StartParserReaderCopyingContext(inParserReader);
+}
+
 EStatusCodeAndObjectIDType PDFDocumentCopyingContext::CreateFormXObjectFromPDFPage(unsigned long inPageIndex,
                                                                                    EPDFPageBox inPageBoxToUseAsFormBox,
                                                                                    const double *inTransformationMatrix,
@@ -50,7 +50,8 @@
 #include "objects/PDFReal.h"
 #include "objects/PDFStreamInput.h"
 #include "objects/PDFSymbol.h"
-#include "parsing/SimpleStringTokenizer.h"
+#include "parsing/ContentStreamReader.h"
+#include "parsing/PDFParserReader.h"
 
 using namespace charta;
 
@@ -61,6 +62,7 @@ PDFDocumentHandler::PDFDocumentHandler()
     mWrittenPage = nullptr;
     mParser = nullptr;
     mParserOwned = false;
+    mParserReader = nullptr;
 }
 
 PDFDocumentHandler::~PDFDocumentHandler()
@@ -140,6 +142,8 @@ EStatusCodeAndObjectIDTypeList PDFDocumentHandler::CreateFormXObjectsFromPDFInCo
     const PDFPageRange &inPageRange, IPageEmbedInFormCommand *inPageEmbedCommand, const double *inTransformationMatrix,
     const ObjectIDTypeList &inCopyAdditionalObjects, const ObjectIDTypeList &inPredefinedFormIDs)
 {
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryCopied,
+                                          eWriterStatisticsPhasePDFCopying);
     EStatusCodeAndObjectIDTypeList result;
 
     do
@@ -266,7 +270,7 @@ PDFFormXObject *PDFDocumentHandler::CreatePDFFormXObjectForPage(unsigned long in
                                                                 const double *inTransformationMatrix,
                                                                 ObjectIDType inPredefinedFormId)
 {
-    std::shared_ptr<charta::PDFDictionary> pageObject = mParser->ParsePage(inPageIndex);
+    std::shared_ptr<charta::PDFDictionary> pageObject = ParseSourcePage(inPageIndex);
 
     if (!pageObject)
     {
@@ -358,7 +362,7 @@ PDFRectangle PDFDocumentHandler::DeterminePageBox(const std::shared_ptr<charta::
                                                   EPDFPageBox inPageBoxType)
 {
     PDFRectangle result;
-    PDFPageInput pageInput(mParser, inDictionary);
+    PDFPageInput pageInput(CreateSourcePageInput(inDictionary));
 
     switch (inPageBoxType)
     {
@@ -390,7 +394,7 @@ PDFFormXObject *PDFDocumentHandler::CreatePDFFormXObjectForPage(unsigned long in
                                                                 const double *inTransformationMatrix,
                                                                 ObjectIDType inPredefinedFormId)
 {
-    std::shared_ptr<charta::PDFDictionary> pageObject = mParser->ParsePage(inPageIndex);
+    std::shared_ptr<charta::PDFDictionary> pageObject = ParseSourcePage(inPageIndex);
 
     if (!pageObject)
     {
@@ -407,7 +411,7 @@ EStatusCode PDFDocumentHandler::WritePageContentToSingleStream(charta::IByteWrit
 {
     EStatusCode status = charta::eSuccess;
 
-    std::shared_ptr<charta::PDFObject> pageContent(mParser->QueryDictionaryObject(std::move(inPageObject), "Contents"));
+    std::shared_ptr<charta::PDFObject> pageContent(QuerySourceDictionaryObject(std::move(inPageObject), "Contents"));
 
     // for empty page, simply return
     if (!pageContent)
@@ -431,7 +435,7 @@ EStatusCode PDFDocumentHandler::WritePageContentToSingleStream(charta::IByteWrit
                 TRACE_LOG("PDFDocumentHandler::WritePageContentToSingleStream, content stream array contains non-refs");
                 break;
             }
-            PDFObjectCastPtr<charta::PDFStreamInput> contentStream(mParser->ParseNewObject(refItem->mObjectID));
+            PDFObjectCastPtr<charta::PDFStreamInput> contentStream(ParseSourceObject(refItem->mObjectID));
             if (!contentStream)
             {
                 status = charta::eFailure;
@@ -463,13 +467,11 @@ EStatusCode PDFDocumentHandler::WritePageContentToSingleStream(charta::IByteWrit
 EStatusCode PDFDocumentHandler::WritePDFStreamInputToStream(
     charta::IByteWriter *inTargetStream, const std::shared_ptr<charta::PDFStreamInput> &inSourceStream)
 {
-    charta::IByteReader *streamReader = mParser->CreateInputStreamReader(inSourceStream);
+    charta::IByteReader *streamReader = StartReadingFromSourceStream(inSourceStream);
 
     if (streamReader == nullptr)
         return charta::eFailure;
 
-    mPDFStream->SetPosition(inSourceStream->GetStreamContentStart());
-
     OutputStreamTraits traits(inTargetStream);
     EStatusCode status = traits.CopyToOutputStream(streamReader);
     delete streamReader;
@@ -484,7 +486,7 @@ EStatusCode PDFDocumentHandler::CopyResourcesIndirectObjects(std::shared_ptr<cha
     // if indirect, run CopyInDirectObject on it (passing its ID and a new ID at the target PDF (just allocate as you
     // go)) if direct, let go.
 
-    PDFObjectCastPtr<charta::PDFDictionary> resources(FindPageResources(mParser, std::move(inPage)));
+    PDFObjectCastPtr<charta::PDFDictionary> resources(FindPageResources(std::move(inPage)));
 
     // k. no resources...as wierd as that might be...or just wrong...i'll let it be
     if (!resources)
@@ -602,11 +604,11 @@ EStatusCode PDFDocumentHandler::CopyInDirectObject(ObjectIDType inSourceObjectID
     ObjectIDTypeList newObjectsToWrite;
     OutWritingPolicy writingPolicy(this, newObjectsToWrite);
 
-    std::shared_ptr<charta::PDFObject> sourceObject = mParser->ParseNewObject(inSourceObjectID);
+    std::shared_ptr<charta::PDFObject> sourceObject = ParseSourceObject(inSourceObjectID);
     if (!sourceObject)
     {
-        XrefEntryInput *xrefEntry = mParser->GetXrefEntry(inSourceObjectID);
-        if (xrefEntry->mType == eXrefEntryDelete)
+        XrefEntryInput xrefEntry = mParser->GetXrefEntry(inSourceObjectID);
+        if (xrefEntry.mType == eXrefEntryDelete)
         {
             // if the object is deleted, replace with a deleted object
             mObjectsContext->GetInDirectObjectsRegistry().DeleteObject(inTargetObjectID);
@@ -638,7 +640,7 @@ EStatusCode PDFDocumentHandler::OnResourcesWrite(ResourcesDictionary * /*inResou
     // Writing resources dictionary. simply loop internal elements and copy. nicely enough, i can use read methods,
     // trusting that no new objects need be written
 
-    PDFObjectCastPtr<charta::PDFDictionary> resources(FindPageResources(mParser, mWrittenPage));
+    PDFObjectCastPtr<charta::PDFDictionary> resources(FindPageResources(mWrittenPage));
     ObjectIDTypeList dummyObjectList; // this one should remain empty...
 
     // k. no resources...as wierd as that might be...or just wrong...i'll let it be
@@ -671,6 +673,8 @@ EStatusCodeAndObjectIDTypeList PDFDocumentHandler::AppendPDFPagesFromPDF(
 EStatusCodeAndObjectIDTypeList PDFDocumentHandler::AppendPDFPagesFromPDFInContext(
     const PDFPageRange &inPageRange, const ObjectIDTypeList &inCopyAdditionalObjects)
 {
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryCopied,
+                                          eWriterStatisticsPhasePDFCopying);
     EStatusCodeAndObjectIDTypeList result;
 
     do
@@ -764,7 +768,7 @@ EStatusCodeAndObjectIDTypeList PDFDocumentHandler::AppendPDFPagesFromPDFInContex
 
 EStatusCodeAndObjectIDType PDFDocumentHandler::CreatePDFPageForPage(unsigned long inPageIndex)
 {
-    std::shared_ptr<charta::PDFDictionary> pageObject = mParser->ParsePage(inPageIndex);
+    std::shared_ptr<charta::PDFDictionary> pageObject = ParseSourcePage(inPageIndex);
     EStatusCodeAndObjectIDType result;
     result.first = charta::eFailure;
     result.second = 0;
@@ -798,7 +802,7 @@ EStatusCodeAndObjectIDType PDFDocumentHandler::CreatePDFPageForPage(unsigned lon
         if (CopyResourcesIndirectObjects(pageObject) != charta::eSuccess)
             break;
 
-        PDFPageInput pageInput(mParser, pageObject);
+        PDFPageInput pageInput(CreateSourcePageInput(pageObject));
         newPage.SetMediaBox(pageInput.GetMediaBox());
         PDFRectangle cropBox = pageInput.GetCropBox();
         if (cropBox != pageInput.GetMediaBox())
@@ -851,7 +855,7 @@ EStatusCode PDFDocumentHandler::CopyPageContentToTargetPagePassthrough(
 {
     EStatusCode status = charta::eSuccess;
 
-    std::shared_ptr<charta::PDFObject> pageContent(mParser->QueryDictionaryObject(inPageObject, "Contents"));
+    std::shared_ptr<charta::PDFObject> pageContent(QuerySourceDictionaryObject(inPageObject, ePDFNameContents));
 
     // for empty page, do nothing
     if (!pageContent)
@@ -860,7 +864,7 @@ EStatusCode PDFDocumentHandler::CopyPageContentToTargetPagePassthrough(
     if (pageContent->GetType() == PDFObject::ePDFObjectStream)
     {
         PDFObjectCastPtr<charta::PDFIndirectObjectReference> streamReference =
-            inPageObject->QueryDirectObject("Contents");
+            inPageObject->QueryDirectObject(ePDFNameContents);
         EStatusCodeAndObjectIDType copyObjectStatus = CopyObject(streamReference->mObjectID);
         status = copyObjectStatus.first;
         if (charta::eSuccess == status)
@@ -906,7 +910,7 @@ EStatusCode PDFDocumentHandler::CopyPageContentToTargetPageRecoded(PDFPage &inPa
 {
     EStatusCode status = charta::eSuccess;
 
-    std::shared_ptr<charta::PDFObject> pageContent(mParser->QueryDictionaryObject(std::move(inPageObject), "Contents"));
+    std::shared_ptr<charta::PDFObject> pageContent(QuerySourceDictionaryObject(std::move(inPageObject), "Contents"));
 
     // for empty page, do nothing
     if (!pageContent)
@@ -932,7 +936,7 @@ EStatusCode PDFDocumentHandler::CopyPageContentToTargetPageRecoded(PDFPage &inPa
                     "PDFDocumentHandler::CopyPageContentToTargetPageRecoded, content stream array contains non-refs");
                 break;
             }
-            PDFObjectCastPtr<charta::PDFStreamInput> contentStream(mParser->ParseNewObject(refItem->mObjectID));
+            PDFObjectCastPtr<charta::PDFStreamInput> contentStream(ParseSourceObject(refItem->mObjectID));
             if (!contentStream)
             {
                 status = charta::eFailure;
@@ -990,6 +994,8 @@ EStatusCode PDFDocumentHandler::WritePDFStreamInputToContentContext(
 EStatusCode PDFDocumentHandler::StartFileCopyingContext(const std::string &inPDFFilePath,
                                                         const PDFParsingOptions &inOptions)
 {
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryCopied,
+                                          eWriterStatisticsPhasePDFCopying);
     if (mPDFFile.OpenFile(inPDFFilePath) != charta::eSuccess)
     {
         TRACE_LOG1("PDFDocumentHandler::StartFileCopyingContext, unable to open file for reading in %s",
@@ -1010,6 +1016,7 @@ EStatusCode PDFDocumentHandler::StartCopyingContext(PDFParser *inPDFParser)
             delete mParser;
         mParserOwned = false;
         mParser = inPDFParser;
+        mParserReader = nullptr;
         mPDFStream = inPDFParser->GetParserStream();
 
         if (mParser->IsEncrypted() && !mParser->IsEncryptionSupported())
@@ -1036,6 +1043,7 @@ EStatusCode PDFDocumentHandler::StartCopyingContext(charta::IByteReaderWithPosit
             mParser = new PDFParser();
         mPDFStream = inPDFStream;
         mParserOwned = true;
+        mParserReader = nullptr;
 
         status = mParser->StartPDFParsing(inPDFStream, inOptions);
         if (status != charta::eSuccess)
@@ -1062,6 +1070,8 @@ EStatusCodeAndObjectIDType PDFDocumentHandler::CreateFormXObjectFromPDFPage(unsi
                                                                             const double *inTransformationMatrix,
                                                                             ObjectIDType inPredefinedFormId)
 {
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryCopied,
+                                          eWriterStatisticsPhasePDFCopying);
     EStatusCodeAndObjectIDType result;
     PDFFormXObject *newObject;
 
@@ -1096,6 +1106,8 @@ EStatusCodeAndObjectIDType PDFDocumentHandler::CreateFormXObjectFromPDFPage(unsi
                                                                             const double *inTransformationMatrix,
                                                                             ObjectIDType inPredefinedFormId)
 {
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryCopied,
+                                          eWriterStatisticsPhasePDFCopying);
     EStatusCodeAndObjectIDType result;
     PDFFormXObject *newObject;
 
@@ -1126,6 +1138,8 @@ EStatusCodeAndObjectIDType PDFDocumentHandler::CreateFormXObjectFromPDFPage(unsi
 
 EStatusCodeAndObjectIDType PDFDocumentHandler::AppendPDFPageFromPDF(unsigned long inPageIndex)
 {
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryCopied,
+                                          eWriterStatisticsPhasePDFCopying);
     EStatusCodeAndObjectIDType result;
 
     if (inPageIndex < mParser->GetPagesCount())
@@ -1146,6 +1160,8 @@ EStatusCodeAndObjectIDType PDFDocumentHandler::AppendPDFPageFromPDF(unsigned lon
 
 EStatusCodeAndObjectIDType PDFDocumentHandler::CopyObject(ObjectIDType inSourceObjectID)
 {
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryCopied,
+                                          eWriterStatisticsPhasePDFCopying);
     EStatusCodeAndObjectIDType result;
 
     auto it = mSourceToTarget.find(inSourceObjectID);
@@ -1195,6 +1211,7 @@ void PDFDocumentHandler::StopCopyingContext()
 {
     mPDFFile.CloseFile();
     mPDFStream = nullptr;
+    mParserReader = nullptr;
     // clearing the source to target mapping here. note that copying enjoyed sharing of objects between them
     mSourceToTarget.clear();
     if (mParserOwned)
@@ -1233,6 +1250,8 @@ EStatusCode PDFDocumentHandler::MergePDFPagesToPage(PDFPage &inPage, const std::
 EStatusCode PDFDocumentHandler::MergePDFPagesToPageInContext(PDFPage &inPage, const PDFPageRange &inPageRange,
                                                              const ObjectIDTypeList &inCopyAdditionalObjects)
 {
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryCopied,
+                                          eWriterStatisticsPhasePDFCopying);
     EStatusCode status = charta::eSuccess;
 
     do
@@ -1309,7 +1328,7 @@ EStatusCode PDFDocumentHandler::MergePDFPagesToPageInContext(PDFPage &inPage, co
 
 EStatusCode PDFDocumentHandler::MergePDFPageForPage(PDFPage &inTargetPage, unsigned long inSourcePageIndex)
 {
-    std::shared_ptr<charta::PDFDictionary> pageObject = mParser->ParsePage(inSourcePageIndex);
+    std::shared_ptr<charta::PDFDictionary> pageObject = ParseSourcePage(inSourcePageIndex);
     EStatusCode status = charta::eSuccess;
 
     if (!pageObject)
@@ -1374,7 +1393,7 @@ EStatusCode PDFDocumentHandler::MergeResourcesToPage(PDFPage &inTargetPage,
     // parse each individual resources dictionary separately and copy the resources. the output parameter should be used
     // for old vs. new names
 
-    PDFObjectCastPtr<charta::PDFDictionary> resources(FindPageResources(mParser, std::move(inPage)));
+    PDFObjectCastPtr<charta::PDFDictionary> resources(FindPageResources(std::move(inPage)));
 
     // k. no resources...as wierd as that might be...or just wrong...i'll let it be
     if (!resources)
@@ -1383,7 +1402,7 @@ EStatusCode PDFDocumentHandler::MergeResourcesToPage(PDFPage &inTargetPage,
     EStatusCode status = charta::eSuccess;
 
     // ProcSet
-    PDFObjectCastPtr<charta::PDFArray> procsets(mParser->QueryDictionaryObject(resources, "ProcSet"));
+    PDFObjectCastPtr<charta::PDFArray> procsets(QuerySourceDictionaryObject(resources, ePDFNameProcSet));
     if (procsets != nullptr)
     {
         auto it(procsets->GetIterator());
@@ -1396,7 +1415,7 @@ EStatusCode PDFDocumentHandler::MergeResourcesToPage(PDFPage &inTargetPage,
     {
 
         // ExtGState
-        PDFObjectCastPtr<charta::PDFDictionary> extgstate(mParser->QueryDictionaryObject(resources, "ExtGState"));
+        PDFObjectCastPtr<charta::PDFDictionary> extgstate(QuerySourceDictionaryObject(resources, ePDFNameExtGState));
         if (extgstate != nullptr)
         {
             auto it(extgstate->GetIterator());
@@ -1416,7 +1435,7 @@ EStatusCode PDFDocumentHandler::MergeResourcesToPage(PDFPage &inTargetPage,
         }
 
         // ColorSpace
-        PDFObjectCastPtr<charta::PDFDictionary> colorspace(mParser->QueryDictionaryObject(resources, "ColorSpace"));
+        PDFObjectCastPtr<charta::PDFDictionary> colorspace(QuerySourceDictionaryObject(resources, ePDFNameColorSpace));
         if (colorspace != nullptr)
         {
             auto it(colorspace->GetIterator());
@@ -1434,7 +1453,7 @@ EStatusCode PDFDocumentHandler::MergeResourcesToPage(PDFPage &inTargetPage,
         }
 
         // Pattern
-        PDFObjectCastPtr<charta::PDFDictionary> pattern(mParser->QueryDictionaryObject(resources, "Pattern"));
+        PDFObjectCastPtr<charta::PDFDictionary> pattern(QuerySourceDictionaryObject(resources, ePDFNamePattern));
         if (pattern != nullptr)
         {
             auto it(pattern->GetIterator());
@@ -1452,7 +1471,7 @@ EStatusCode PDFDocumentHandler::MergeResourcesToPage(PDFPage &inTargetPage,
         }
 
         // Shading
-        PDFObjectCastPtr<charta::PDFDictionary> shading(mParser->QueryDictionaryObject(resources, "Shading"));
+        PDFObjectCastPtr<charta::PDFDictionary> shading(QuerySourceDictionaryObject(resources, ePDFNameShading));
         if (shading != nullptr)
         {
             auto it(shading->GetIterator());
@@ -1470,7 +1489,7 @@ EStatusCode PDFDocumentHandler::MergeResourcesToPage(PDFPage &inTargetPage,
         }
 
         // XObject
-        PDFObjectCastPtr<charta::PDFDictionary> xobject(mParser->QueryDictionaryObject(resources, "XObject"));
+        PDFObjectCastPtr<charta::PDFDictionary> xobject(QuerySourceDictionaryObject(resources, ePDFNameXObject));
         if (xobject != nullptr)
         {
             auto it(xobject->GetIterator());
@@ -1488,7 +1507,7 @@ EStatusCode PDFDocumentHandler::MergeResourcesToPage(PDFPage &inTargetPage,
         }
 
         // Font
-        PDFObjectCastPtr<charta::PDFDictionary> font(mParser->QueryDictionaryObject(resources, "Font"));
+        PDFObjectCastPtr<charta::PDFDictionary> font(QuerySourceDictionaryObject(resources, ePDFNameFont));
         if (font != nullptr)
         {
             auto it(font->GetIterator());
@@ -1506,7 +1525,7 @@ EStatusCode PDFDocumentHandler::MergeResourcesToPage(PDFPage &inTargetPage,
         }
 
         // Properties
-        PDFObjectCastPtr<charta::PDFDictionary> properties(mParser->QueryDictionaryObject(resources, "Properties"));
+        PDFObjectCastPtr<charta::PDFDictionary> properties(QuerySourceDictionaryObject(resources, ePDFNameProperties));
         if (properties != nullptr)
         {
             auto it(properties->GetIterator());
@@ -1596,7 +1615,7 @@ EStatusCode PDFDocumentHandler::MergePageContentToTargetPage(PDFPage &inTargetPa
 {
     EStatusCode status = charta::eSuccess;
 
-    std::shared_ptr<charta::PDFObject> pageContent(mParser->QueryDictionaryObject(std::move(inSourcePage), "Contents"));
+    std::shared_ptr<charta::PDFObject> pageContent(QuerySourceDictionaryObject(std::move(inSourcePage), "Contents"));
 
     // for empty page, return now
     if (!pageContent)
@@ -1623,7 +1642,7 @@ EStatusCode PDFDocumentHandler::MergePageContentToTargetPage(PDFPage &inTargetPa
                 TRACE_LOG("PDFDocumentHandler::MergePageContentToTargetPage, content stream array contains non-refs");
                 break;
             }
-            PDFObjectCastPtr<charta::PDFStreamInput> contentStream(mParser->ParseNewObject(refItem->mObjectID));
+            PDFObjectCastPtr<charta::PDFStreamInput> contentStream(ParseSourceObject(refItem->mObjectID));
             if (!contentStream)
             {
                 status = charta::eFailure;
@@ -1688,102 +1707,84 @@ EStatusCode PDFDocumentHandler::WritePDFStreamInputToStream(
     // in order to have minimal interferences with the stream content i'm going for two passes here.
     // the first pass will scan the stream for tokens to replace providing the tokens and their positions.
     // a second pass is then repeatedly copies the content between tokens that are to be replaced. this might be
-    // wasteful, but is the safest method to get the content right.
+    // wasteful, but is the safest method to get the content right. the stream is decoded once, for both passes.
 
     ResourceTokenMarkerList resourcesPositions;
+    std::vector<uint8_t> content = mParser->AcquireStreamBuffer();
 
-    EStatusCode status = ScanStreamForResourcesTokens(inSourceStream, inMappedResourcesNames, resourcesPositions);
-    if (status != charta::eSuccess)
-        return status;
+    EStatusCode status = DecodeSourceStreamToBuffer(inSourceStream, content);
+    if (status == charta::eSuccess)
+        status = ScanStreamForResourcesTokens(content, inMappedResourcesNames, resourcesPositions);
+    if (status == charta::eSuccess)
+        status = MergeAndReplaceResourcesTokens(inTargetStream, content, inMappedResourcesNames, resourcesPositions);
 
-    return MergeAndReplaceResourcesTokens(inTargetStream, inSourceStream, inMappedResourcesNames, resourcesPositions);
+    mParser->ReleaseStreamBuffer(std::move(content));
+    return status;
 }
 
-static const char scSlash = '/';
-EStatusCode PDFDocumentHandler::ScanStreamForResourcesTokens(
-    const std::shared_ptr<charta::PDFStreamInput> &inSourceStream, const StringToStringMap &inMappedResourcesNames,
-    ResourceTokenMarkerList &outResourceMarkers)
+EStatusCode PDFDocumentHandler::ScanStreamForResourcesTokens(std::vector<uint8_t> &inContent,
+                                                             const StringToStringMap &inMappedResourcesNames,
+                                                             ResourceTokenMarkerList &outResourceMarkers)
 {
-    charta::IByteReader *streamReader = mParser->CreateInputStreamReader(inSourceStream);
-
-    if (streamReader == nullptr)
-        return charta::eFailure;
-
-    mPDFStream->SetPosition(inSourceStream->GetStreamContentStart());
+    // any name operand that has a resource name is taken to be a resource reference. strings and inline image data
+    // are skipped by the reader, so their content is never mistaken for a name.
+    // note that here i don't have to take care of name space chars encoding, as the names are alrady encoded in the
+    // map [the new names are never containing space chars]
+    ContentStreamReader reader;
+    reader.Start(inContent.data(), inContent.size());
 
-    // using simplestringtokenizer instead of regular pdfparsertokenizer, as content stream may contain
-    // streams, which may have tokens that will be interpreted as pdf tokens (like string start), and so will cause
-    // a wrong inclusion of content and so will skip content that should be replaced.
-    // There's still risk here, in that there will be a string that like a resource name with forward slash which will
-    // be mistaken for a resource usage. this is something to tackle still.
-    SimpleStringTokenizer tokenizer;
-    tokenizer.SetReadStream(streamReader);
-
-    BoolAndString tokenizerResult;
-
-    while (streamReader->NotEnded())
+    ContentStreamOperator anOperator;
+    while (reader.Next(anOperator))
     {
-        BoolAndString tokenizerResult = tokenizer.GetNextToken();
-
-        if (!tokenizerResult.first)
-            break;
-
-        // check if this is a token that will need replacement - 1. verify that it's a name 2. verify that it's a name
-        // in the input map note that here i don't have to take care of name space chars encoding, as the names are
-        // alrady encoded in the map [the new names are never containing space chars]
-        if (tokenizerResult.second.at(0) == scSlash &&
-            (inMappedResourcesNames.find(tokenizerResult.second.substr(1)) != inMappedResourcesNames.end()))
-            outResourceMarkers.push_back(
-                ResourceTokenMarker(tokenizerResult.second.substr(1), tokenizer.GetRecentTokenPosition()));
+        for (size_t i = 0; i < anOperator.mOperandsCount; ++i)
+        {
+            const ContentStreamOperand &operand = anOperator.mOperands[i];
+            if (operand.mType != eContentStreamOperandName)
+                continue;
+            auto it = inMappedResourcesNames.find(std::string(operand.mToken));
+            if (it != inMappedResourcesNames.end())
+                outResourceMarkers.push_back(ResourceTokenMarker(it->first, (long long)operand.mPosition));
+        }
     }
 
-    delete streamReader;
     return charta::eSuccess;
 }
 
-EStatusCode PDFDocumentHandler::MergeAndReplaceResourcesTokens(
-    charta::IByteWriter *inTargetStream, const std::shared_ptr<charta::PDFStreamInput> &inSourceStream,
-    const StringToStringMap &inMappedResourcesNames, const ResourceTokenMarkerList &inResourceMarkers)
+EStatusCode PDFDocumentHandler::MergeAndReplaceResourcesTokens(charta::IByteWriter *inTargetStream,
+                                                               const std::vector<uint8_t> &inContent,
+                                                               const StringToStringMap &inMappedResourcesNames,
+                                                               const ResourceTokenMarkerList &inResourceMarkers)
 {
-    charta::IByteReader *streamReader = mParser->CreateInputStreamReader(inSourceStream);
-
-    if (streamReader == nullptr)
-        return charta::eFailure;
-
-    mPDFStream->SetPosition(inSourceStream->GetStreamContentStart());
-
-    OutputStreamTraits traits(inTargetStream);
     PrimitiveObjectsWriter primitivesWriter;
     primitivesWriter.SetStreamForWriting(inTargetStream);
-    EStatusCode status = charta::eSuccess;
-    InputStreamSkipperStream skipper(streamReader);
-    auto it = inResourceMarkers.begin();
-    long long previousContentPosition = 0;
+    size_t previousContentPosition = 0;
 
-    for (; it != inResourceMarkers.end() && charta::eSuccess == status; ++it)
+    // copy the content between markers as is, and write the mapped names instead of the marked ones
+    for (const auto &marker : inResourceMarkers)
     {
-        status = traits.CopyToOutputStream(streamReader, (size_t)(it->ResourceTokenPosition - previousContentPosition));
-        if (status != charta::eSuccess)
-            break;
-        primitivesWriter.WriteName(inMappedResourcesNames.find(it->ResourceToken)->second, eTokenSepratorNone);
-        // note that i'm using SkipBy here. if i want to use SkipTo, i have to user the skipper stream as input stream
-        // for the rest of the reader objects here, as SkipTo relies on information on how many bytes were read
-        skipper.SkipBy(it->ResourceToken.size() +
-                       1); // skip the resource name in the read stream [include +1 for slash]
-        previousContentPosition = it->ResourceTokenPosition + it->ResourceToken.size() + 1;
+        auto markerPosition = (size_t)marker.ResourceTokenPosition;
+        if (markerPosition < previousContentPosition || markerPosition > inContent.size())
+            return charta::eFailure;
+        if (inTargetStream->Write(inContent.data() + previousContentPosition,
+                                  markerPosition - previousContentPosition) != markerPosition - previousContentPosition)
+            return charta::eFailure;
+        primitivesWriter.WriteName(inMappedResourcesNames.find(marker.ResourceToken)->second, eTokenSepratorNone);
+        // skip the resource name in the content [include +1 for slash]
+        previousContentPosition = markerPosition + marker.ResourceToken.size() + 1;
     }
 
     // copy from last marker (or in case there are none - from the beginning), till end
-    if (charta::eSuccess == status)
-        status = traits.CopyToOutputStream(streamReader);
-
-    skipper.Assign(nullptr);
-    delete streamReader;
-    return status;
+    if (previousContentPosition < inContent.size() &&
+        inTargetStream->Write(inContent.data() + previousContentPosition, inContent.size() - previousContentPosition) !=
+            inContent.size() - previousContentPosition)
+        return charta::eFailure;
+    return charta::eSuccess;
 }
 
 EStatusCode PDFDocumentHandler::MergePDFPageToPage(PDFPage &inTargetPage, unsigned long inSourcePageIndex)
 {
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryCopied,
+                                          eWriterStatisticsPhasePDFCopying);
     EStatusCode status;
 
     if (inSourcePageIndex < mParser->GetPagesCount())
@@ -1858,17 +1859,32 @@ EStatusCode PDFDocumentHandler::MergePDFPagesToPage(PDFPage &inPage, charta::IBy
 EStatusCode PDFDocumentHandler::StartStreamCopyingContext(charta::IByteReaderWithPosition *inPDFStream,
                                                           const PDFParsingOptions &inOptions)
 {
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryCopied,
+                                          eWriterStatisticsPhasePDFCopying);
     return StartCopyingContext(inPDFStream, inOptions);
 }
 
 charta::EStatusCode PDFDocumentHandler::StartParserCopyingContext(PDFParser *inPDFParser)
 {
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryCopied,
+                                          eWriterStatisticsPhasePDFCopying);
     return StartCopyingContext(inPDFParser);
 }
 
+EStatusCode PDFDocumentHandler::StartParserReaderCopyingContext(PDFParserReader *inParserReader)
+{
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryCopied,
+                                          eWriterStatisticsPhasePDFCopying);
+    EStatusCode status = StartCopyingContext(inParserReader->GetParser());
+    mParserReader = inParserReader;
+    return status;
+}
+
 EStatusCodeAndObjectIDTypeList PDFDocumentHandler::CopyDirectObjectWithDeepCopy(
     std::shared_ptr<charta::PDFObject> inObject)
 {
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryCopied,
+                                          eWriterStatisticsPhasePDFCopying);
     ObjectIDTypeList notCopiedReferencedObjects;
     OutWritingPolicy writingPolicy(this, notCopiedReferencedObjects);
 
@@ -1879,6 +1895,8 @@ EStatusCodeAndObjectIDTypeList PDFDocumentHandler::CopyDirectObjectWithDeepCopy(
 
 EStatusCode PDFDocumentHandler::CopyNewObjectsForDirectObject(const ObjectIDTypeList &inReferencedObjects)
 {
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryCopied,
+                                          eWriterStatisticsPhasePDFCopying);
     return WriteNewObjects(inReferencedObjects);
 }
 
@@ -1906,6 +1924,8 @@ charta::IByteReaderWithPosition *PDFDocumentHandler::GetSourceDocumentStream()
 // for modification scenarios, no need for deep copying. the following implement this path
 EStatusCode PDFDocumentHandler::CopyDirectObjectAsIs(std::shared_ptr<charta::PDFObject> inObject)
 {
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryCopied,
+                                          eWriterStatisticsPhasePDFCopying);
     InWritingPolicy writingPolicy(this);
     return WriteObjectByType(std::move(inObject), eTokenSeparatorEndLine, &writingPolicy);
 }
@@ -2057,12 +2077,12 @@ EStatusCode PDFDocumentHandler::WriteStreamObject(const std::shared_ptr<charta::
      */
     if (!mObjectsContext->IsCompressingStreams())
     {
-        streamReader = mParser->StartReadingFromStream(inStream);
+        streamReader = StartReadingFromSourceStream(inStream);
         readingDecrypted = streamReader != nullptr;
     }
     if (!readingDecrypted)
     {
-        streamReader = mParser->StartReadingFromStreamForPlainCopying(inStream);
+        streamReader = StartReadingFromSourceStreamForPlainCopying(inStream);
     }
 
     while (it.MoveNext() && charta::eSuccess == status)
@@ -2102,6 +2122,8 @@ EStatusCode PDFDocumentHandler::WriteStreamObject(const std::shared_ptr<charta::
 EStatusCode PDFDocumentHandler::MergePDFPageToFormXObject(PDFFormXObject *inTargetFormXObject,
                                                           unsigned long inSourcePageIndex)
 {
+    WriterStatisticsScope statisticsScope(mObjectsContext, eWriterStatisticsCategoryCopied,
+                                          eWriterStatisticsPhasePDFCopying);
     EStatusCode result;
 
     if (inSourcePageIndex < mParser->GetPagesCount())
@@ -2123,7 +2145,7 @@ EStatusCode PDFDocumentHandler::MergePDFPageToFormXObject(PDFFormXObject *inTarg
 EStatusCode PDFDocumentHandler::MergePDFPageForXObject(PDFFormXObject *inTargetFormXObject,
                                                        unsigned long inSourcePageIndex)
 {
-    std::shared_ptr<charta::PDFDictionary> pageObject = mParser->ParsePage(inSourcePageIndex);
+    std::shared_ptr<charta::PDFDictionary> pageObject = ParseSourcePage(inSourcePageIndex);
     EStatusCode result = eSuccess;
 
     do
@@ -2317,14 +2339,14 @@ EStatusCode PDFDocumentHandler::RegisterResourcesForForm(PDFFormXObject *inTarge
 
     do
     {
-        PDFObjectCastPtr<charta::PDFDictionary> resources(FindPageResources(mParser, inPageObject));
+        PDFObjectCastPtr<charta::PDFDictionary> resources(FindPageResources(inPageObject));
 
         // k. no resources...as wierd as that might be...or just wrong...i'll let it be
         if (!resources)
             break;
 
         // ProcSet
-        PDFObjectCastPtr<charta::PDFArray> procsets(mParser->QueryDictionaryObject(resources, "ProcSet"));
+        PDFObjectCastPtr<charta::PDFArray> procsets(QuerySourceDictionaryObject(resources, ePDFNameProcSet));
         if (procsets != nullptr)
         {
             auto it(procsets->GetIterator());
@@ -2421,7 +2443,7 @@ void PDFDocumentHandler::RegisterResourcesForResourcesCategory(
     StringToStringMap &ioMappedResourcesNames)
 {
     PDFObjectCastPtr<charta::PDFDictionary> resourcesCategoryDictionary(
-        mParser->QueryDictionaryObject(std::move(inResourcesDictionary), inCommand->GetResourcesCategoryName()));
+        QuerySourceDictionaryObject(std::move(inResourcesDictionary), inCommand->GetResourcesCategoryName()));
     if (resourcesCategoryDictionary != nullptr)
     {
         auto it(resourcesCategoryDictionary->GetIterator());
@@ -2468,7 +2490,7 @@ EStatusCode PDFDocumentHandler::MergePageContentToTargetXObject(PDFFormXObject *
                                                                 const StringToStringMap &inMappedResourcesNames)
 {
     EStatusCode status = charta::eSuccess;
-    std::shared_ptr<charta::PDFObject> pageContent(mParser->QueryDictionaryObject(std::move(inSourcePage), "Contents"));
+    std::shared_ptr<charta::PDFObject> pageContent(QuerySourceDictionaryObject(std::move(inSourcePage), "Contents"));
 
     // for empty page, do nothing
     if (!pageContent)
@@ -2498,7 +2520,7 @@ EStatusCode PDFDocumentHandler::MergePageContentToTargetXObject(PDFFormXObject *
                     "PDFDocumentHandler::MergePageContentToTargetXObject, content stream array contains non-refs");
                 break;
             }
-            PDFObjectCastPtr<charta::PDFStreamInput> contentStream(mParser->ParseNewObject(refItem->mObjectID));
+            PDFObjectCastPtr<charta::PDFStreamInput> contentStream(ParseSourceObject(refItem->mObjectID));
             if (!contentStream)
             {
                 status = charta::eFailure;
@@ -2551,19 +2573,68 @@ void PDFDocumentHandler::RegisterFormRelatedObjects(PDFFormXObject *inFormXObjec
 }
 
 std::shared_ptr<charta::PDFObject> PDFDocumentHandler::FindPageResources(
-    PDFParser *inParser, const std::shared_ptr<charta::PDFDictionary> &inDictionary)
+    const std::shared_ptr<charta::PDFDictionary> &inDictionary)
 {
-    if (inDictionary->Exists("Resources"))
+    if (inDictionary->Exists(ePDFNameResources))
     {
-        return inParser->QueryDictionaryObject(inDictionary, "Resources");
+        return QuerySourceDictionaryObject(inDictionary, ePDFNameResources);
     }
 
     PDFObjectCastPtr<charta::PDFDictionary> parentDict(
-        inDictionary->Exists("Parent") ? inParser->QueryDictionaryObject(inDictionary, "Parent") : nullptr);
+        inDictionary->Exists(ePDFNameParent) ? QuerySourceDictionaryObject(inDictionary, ePDFNameParent) : nullptr);
     if (!parentDict)
     {
         return nullptr;
     }
 
-    return FindPageResources(inParser, parentDict);
-}
\ No newline at end of file
+    return FindPageResources(parentDict);
+}
+std::shared_ptr<charta::PDFObject> PDFDocumentHandler::ParseSourceObject(ObjectIDType inObjectID)
+{
+    return mParserReader != nullptr ? mParserReader->ParseNewObject(inObjectID) : mParser->ParseNewObject(inObjectID);
+}
+
+std::shared_ptr<charta::PDFDictionary> PDFDocumentHandler::ParseSourcePage(unsigned long inPageIndex)
+{
+    return mParserReader != nullptr ? mParserReader->ParsePage(inPageIndex) : mParser->ParsePage(inPageIndex);
+}
+
+std::shared_ptr<charta::PDFObject> PDFDocumentHandler::QuerySourceDictionaryObject(
+    const std::shared_ptr<charta::PDFDictionary> &inDictionary, const std::string &inName)
+{
+    return mParserReader != nullptr ? mParserReader->QueryDictionaryObject(inDictionary, inName)
+                                    : mParser->QueryDictionaryObject(inDictionary, inName);
+}
+
+std::shared_ptr<charta::PDFObject> PDFDocumentHandler::QuerySourceDictionaryObject(
+    const std::shared_ptr<charta::PDFDictionary> &inDictionary, charta::EPDFWellKnownName inName)
+{
+    return mParserReader != nullptr ? mParserReader->QueryDictionaryObject(inDictionary, inName)
+                                    : mParser->QueryDictionaryObject(inDictionary, inName);
+}
+
+charta::IByteReader *PDFDocumentHandler::StartReadingFromSourceStream(
+    const std::shared_ptr<charta::PDFStreamInput> &inStream)
+{
+    return mParserReader != nullptr ? mParserReader->StartReadingFromStream(inStream)
+                                    : mParser->StartReadingFromStream(inStream);
+}
+
+charta::IByteReader *PDFDocumentHandler::StartReadingFromSourceStreamForPlainCopying(
+    const std::shared_ptr<charta::PDFStreamInput> &inStream)
+{
+    return mParserReader != nullptr ? mParserReader->StartReadingFromStreamForPlainCopying(inStream)
+                                    : mParser->StartReadingFromStreamForPlainCopying(inStream);
+}
+
+EStatusCode PDFDocumentHandler::DecodeSourceStreamToBuffer(const std::shared_ptr<charta::PDFStreamInput> &inStream,
+                                                           std::vector<uint8_t> &ioBuffer)
+{
+    return mParserReader != nullptr ? mParserReader->DecodeStreamToBuffer(inStream, ioBuffer)
+                                    : mParser->DecodeStreamToBuffer(inStream, ioBuffer);
+}
+
+PDFPageInput PDFDocumentHandler::CreateSourcePageInput(const std::shared_ptr<charta::PDFDictionary> &inPageObject)
+{
+    return mParserReader != nullptr ? PDFPageInput(mParserReader, inPageObject) : PDFPageInput(mParser, inPageObject);
+}
@@ -59,6 +59,38 @@ PDFObjectParser::~PDFObjectParser()
         delete mStream;
 }
 
+template <class T, class... Args> std::shared_ptr<T> PDFObjectParser::MakeObject(Args &&...inArgs)
+{
+    if (mArena)
+        return mArena->Make<T>(std::forward<Args>(inArgs)...);
+    return std::make_shared<T>(std::forward<Args>(inArgs)...);
+}
+
+std::pmr::memory_resource *PDFObjectParser::GetContainersResource()
+{
+    if (mArena)
+        return mArena.get();
+    return std::pmr::get_default_resource();
+}
+
+void PDFObjectParser::SetArena(std::shared_ptr<charta::PDFObjectArena> inArena)
+{
+    // objects don't keep their arena alive, and some parsed from the previous one may still be in use
+    if (mArena && mArena != inArena)
+        mRetainedArenas.push_back(std::move(mArena));
+    mArena = std::move(inArena);
+}
+
+void PDFObjectParser::ReleaseRetainedArenas()
+{
+    mRetainedArenas.clear();
+}
+
+std::shared_ptr<charta::PDFObjectArena> PDFObjectParser::GetArena() const
+{
+    return mArena;
+}
+
 void PDFObjectParser::SetReadStream(charta::IByteReader *inSourceStream,
                                     IReadPositionProvider *inCurrentPositionProvider, bool inOwnsStream)
 {
@@ -109,7 +141,7 @@ std::shared_ptr<charta::PDFObject> PDFObjectParser::ParseNewObject()
         return ParseHexadecimalString(token);
     // NULL
     else if (IsNull(token))
-        return std::make_shared<PDFNull>();
+        return MakeObject<PDFNull>();
     // Name
     else if (IsName(token))
         return ParseName(token);
@@ -157,7 +189,7 @@ std::shared_ptr<charta::PDFObject> PDFObjectParser::ParseNewObject()
             }
 
             // if passed all these, then this is a reference
-            return std::make_shared<PDFIndirectObjectReference>(
+            return MakeObject<PDFIndirectObjectReference>(
                 std::static_pointer_cast<charta::PDFInteger>(numberObject)->GetValue(),
                 std::static_pointer_cast<charta::PDFInteger>(versionObject)->GetValue());
         }
@@ -183,7 +215,7 @@ std::shared_ptr<charta::PDFObject> PDFObjectParser::ParseNewObject()
                 // yes, found a stream. record current position as the position where the stream starts.
                 // remove from the current stream position the size of the tokenizer buffer, which is "read", but
                 // not used
-                return std::make_shared<charta::PDFStreamInput>(
+                return MakeObject<charta::PDFStreamInput>(
                     dictObject, mCurrentPositionProvider->GetCurrentPosition() - mTokenizer.GetReadBufferSize());
             }
             else
@@ -195,7 +227,7 @@ std::shared_ptr<charta::PDFObject> PDFObjectParser::ParseNewObject()
     }
     // Symbol (legitimate keyword or error. determine if error based on semantics)
     else
-        return std::make_shared<PDFSymbol>(token);
+        return MakeObject<PDFSymbol>(token);
 }
 
 bool PDFObjectParser::GetNextToken(std::string &outToken)
@@ -232,7 +264,7 @@ bool PDFObjectParser::IsBoolean(const std::string &inToken)
 
 std::shared_ptr<charta::PDFObject> PDFObjectParser::ParseBoolean(const std::string &inToken)
 {
-    return std::make_shared<PDFBoolean>(scTrue == inToken);
+    return MakeObject<PDFBoolean>(scTrue == inToken);
 }
 
 static const char scLeftParanthesis = '(';
@@ -325,7 +357,7 @@ std::shared_ptr<charta::PDFObject> PDFObjectParser::ParseLiteralString(const std
         stringBuffer.sputn((const char *)&buffer, 1);
     }
 
-    return std::make_shared<PDFLiteralString>(MaybeDecryptString(stringBuffer.str()));
+    return MakeObject<PDFLiteralString>(MaybeDecryptString(stringBuffer.str()));
 }
 
 std::string PDFObjectParser::MaybeDecryptString(const std::string &inString)
@@ -362,7 +394,7 @@ std::shared_ptr<charta::PDFObject> PDFObjectParser::ParseHexadecimalString(const
         return nullptr;
     }
 
-    return std::make_shared<PDFHexString>(MaybeDecryptString(DecodeHexString(inToken.substr(1, inToken.size() - 2))));
+    return MakeObject<PDFHexString>(MaybeDecryptString(DecodeHexString(inToken.substr(1, inToken.size() - 2))));
 }
 
 std::string PDFObjectParser::DecodeHexString(const std::string &inStringToDecode)
@@ -420,6 +452,10 @@ bool PDFObjectParser::IsName(const std::string &inToken)
 static const char scSharp = '#';
 std::shared_ptr<charta::PDFObject> PDFObjectParser::ParseName(const std::string &inToken)
 {
+    // common case, nothing to interpret
+    if (inToken.find(scSharp) == std::string::npos)
+        return mNameTable.Intern(std::string_view(inToken).substr(1));
+
     EStatusCode status = charta::eSuccess;
     std::stringbuf stringBuffer;
     BoolAndByte hexResult;
@@ -473,7 +509,7 @@ std::shared_ptr<charta::PDFObject> PDFObjectParser::ParseName(const std::string
     }
 
     if (charta::eSuccess == status)
-        return std::make_shared<charta::PDFName>(stringBuffer.str());
+        return mNameTable.Intern(stringBuffer.str());
     return nullptr;
 }
 
@@ -523,8 +559,8 @@ std::shared_ptr<charta::PDFObject> PDFObjectParser::ParseNumber(const std::strin
     // once we know this is a number, then parsing is easy. just determine if it's a real or integer, so as to separate
     // classes for better accuracy
     if (inToken.find(scDot) != inToken.npos)
-        return std::make_shared<PDFReal>(Double(inToken));
-    return std::make_shared<PDFInteger>(LongLong(inToken));
+        return MakeObject<PDFReal>(Double(inToken));
+    return MakeObject<PDFInteger>(LongLong(inToken));
 }
 
 static const std::string scLeftSquare = "[";
@@ -536,7 +572,7 @@ bool PDFObjectParser::IsArray(const std::string &inToken)
 static const std::string scRightSquare = "]";
 std::shared_ptr<charta::PDFObject> PDFObjectParser::ParseArray()
 {
-    auto anArray = std::make_shared<PDFArray>();
+    auto anArray = MakeObject<PDFArray>();
     bool arrayEndEncountered = false;
     std::string token;
     EStatusCode status = charta::eSuccess;
@@ -593,7 +629,7 @@ bool PDFObjectParser::IsDictionary(const std::string &inToken)
 static const std::string scDoubleRightAngle = ">>";
 std::shared_ptr<charta::PDFObject> PDFObjectParser::ParseDictionary()
 {
-    auto aDictionary = std::make_shared<PDFDictionary>();
+    auto aDictionary = MakeObject<PDFDictionary>(GetContainersResource());
     bool dictionaryEndEncountered = false;
     std::string token;
     EStatusCode status = charta::eSuccess;
@@ -608,7 +644,7 @@ std::shared_ptr<charta::PDFObject> PDFObjectParser::ParseDictionary()
 
         // Parse Key
         auto aKey = ParseNewObject();
-        if (!aKey)
+        if (!aKey || aKey->GetType() != PDFObject::ePDFObjectName)
         {
             status = charta::eFailure;
             TRACE_LOG1("PDFObjectParser::ParseDictionary, failure to parse key for a dictionary. token = %s",
@@ -627,9 +663,9 @@ std::shared_ptr<charta::PDFObject> PDFObjectParser::ParseDictionary()
         }
         auto name = std::static_pointer_cast<charta::PDFName>(aKey);
 
-        // all good. i'm gonna be forgiving here and allow skipping duplicate keys. cause it happens
-        if (!aDictionary->Exists(name->GetValue()))
-            aDictionary->Insert(name, aValue);
+        // all good. i'm gonna be forgiving here and allow skipping duplicate keys. cause it happens. Insert
+        // ignores them
+        aDictionary->Insert(name, aValue);
     }
 
     if (dictionaryEndEncountered && charta::eSuccess == status)
@@ -683,4 +719,8 @@ charta::IByteReader *PDFObjectParser::StartExternalRead()
 void PDFObjectParser::EndExternalRead()
 {
     ResetReadState();
-}
\ No newline at end of file
+}
+charta::PDFNameTable &PDFObjectParser::GetNameTable()
+{
+    return mNameTable;
+}
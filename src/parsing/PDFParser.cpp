@@ -25,6 +25,7 @@
 #include "io/IByteReaderWithPosition.h"
 #include "io/InputAscii85DecodeStream.h"
 #include "io/InputAsciiHexDecodeStream.h"
+#include "io/InputByteArrayStream.h"
 #include "io/InputDCTDecodeStream.h"
 #include "io/InputFlateDecodeStream.h"
 #include "io/InputLZWDecodeStream.h"
@@ -32,6 +33,7 @@
 #include "io/InputPredictorPNGOptimumStream.h"
 #include "io/InputPredictorTIFFSubStream.h"
 #include "io/InputStreamSkipperStream.h"
+#include "io/PredictorKernels.h"
 #include "objects/PDFArray.h"
 #include "objects/PDFDictionary.h"
 #include "objects/PDFIndirectObjectReference.h"
@@ -46,22 +48,27 @@
 #include "objects/PDFSymbol.h"
 
 #include <algorithm>
+#include <string.h>
 #include <utility>
+#include <zlib.h>
 using namespace charta;
 
 PDFParser::PDFParser()
 {
     mStream = nullptr;
     mTrailer = nullptr;
-    mXrefTable = nullptr;
     mPagesObjectIDs = nullptr;
     mParserExtender = nullptr;
+    mXrefRebuilt = false;
     mAllowExtendingSegments =
         true; // Gal 19.9.2013: here's some policy changer. basically i'm supposed to ignore all segments that declare
               // objects past the trailer declared size. but i would like to allow files that do extend. as this is
               // incompatible with the specs, i'll make this boolean dendent. i will sometimes make it public so ppl can
               // actually modify this policy. for now, it's internal
     mObjectParser.SetDecryptionHelper(&mDecryptionHelper);
+    mReadContext.mStream = nullptr;
+    mReadContext.mPositionProvider = &mCurrentPositionProvider;
+    mReadContext.mObjectParser = &mObjectParser;
 }
 
 PDFParser::~PDFParser()
@@ -72,11 +79,11 @@ PDFParser::~PDFParser()
 void PDFParser::ResetParser()
 {
     mTrailer = nullptr;
-    delete[] mXrefTable;
-    mXrefTable = nullptr;
+    mXrefTable.Clear();
     delete[] mPagesObjectIDs;
     mPagesObjectIDs = nullptr;
     mStream = nullptr;
+    mReadContext.mStream = nullptr;
     mCurrentPositionProvider.Assign(nullptr);
 
     auto it = mObjectStreamsCache.begin();
@@ -84,6 +91,11 @@ void PDFParser::ResetParser()
         delete[] it->second;
     mObjectStreamsCache.clear();
     mDecryptionHelper.Reset();
+    mXrefRebuilt = false;
+    mRecoveredObjectStreams.clear();
+    // names of the previous document are of no use for the next one
+    mObjectParser.GetNameTable().Clear();
+    mObjectParser.ReleaseRetainedArenas();
 }
 
 EStatusCode PDFParser::StartPDFParsing(charta::IByteReaderWithPosition *inSourceStream,
@@ -94,6 +106,7 @@ EStatusCode PDFParser::StartPDFParsing(charta::IByteReaderWithPosition *inSource
     ResetParser();
 
     mStream = inSourceStream;
+    mReadContext.mStream = mStream;
     mCurrentPositionProvider.Assign(mStream);
     mObjectParser.SetReadStream(inSourceStream, &mCurrentPositionProvider);
 
@@ -103,6 +116,36 @@ EStatusCode PDFParser::StartPDFParsing(charta::IByteReaderWithPosition *inSource
         if (status != charta::eSuccess)
             break;
 
+        status = ParseDocumentDirectory();
+        if (status != charta::eSuccess && inOptions.RecoverBrokenXref)
+        {
+            TRACE_LOG("PDFParser::StartPDFParsing, failed to read the file directory. rebuilding the xref");
+            status = RebuildXref();
+        }
+        if (status != charta::eSuccess)
+            break;
+
+        status = SetupDocument(inOptions.Password);
+        if (status != charta::eSuccess && inOptions.RecoverBrokenXref && !mXrefRebuilt)
+        {
+            // the xref reads fine, but probably points to the wrong places
+            TRACE_LOG("PDFParser::StartPDFParsing, failed to read document with the file xref. rebuilding the xref");
+            status = RebuildXref();
+            if (status != charta::eSuccess)
+                break;
+            status = SetupDocument(inOptions.Password);
+        }
+    } while (false);
+
+    return status;
+}
+
+EStatusCode PDFParser::ParseDocumentDirectory()
+{
+    EStatusCode status;
+
+    do
+    {
         // initialize reading from end
         mLastReadPositionFromEnd = 0;
         mEncounteredFileStart = false;
@@ -117,10 +160,19 @@ EStatusCode PDFParser::StartPDFParsing(charta::IByteReaderWithPosition *inSource
             break;
 
         status = ParseFileDirectory(); // that would be the xref and trailer
-        if (status != charta::eSuccess)
-            break;
+    } while (false);
+
+    return status;
+}
 
-        status = SetupDecryptionHelper(inOptions.Password);
+EStatusCode PDFParser::SetupDocument(const std::string &inPassword)
+{
+    EStatusCode status;
+
+    do
+    {
+        mDecryptionHelper.Reset();
+        status = SetupDecryptionHelper(inPassword);
         if (status != charta::eSuccess)
             break;
 
@@ -131,25 +183,215 @@ EStatusCode PDFParser::StartPDFParsing(charta::IByteReaderWithPosition *inSource
             // lower level objects will be in object streams (for those PDFs that have them)
             // and the may not be accessed
             mPagesCount = 0;
+            delete[] mPagesObjectIDs;
             mPagesObjectIDs = nullptr;
+            break;
         }
-        else
+
+        // object streams may be encrypted, so their content can only be indexed now
+        if (mXrefRebuilt)
         {
-            status = ParsePagesObjectIDs();
+            status = IndexRecoveredObjectStreams();
             if (status != charta::eSuccess)
                 break;
         }
 
+        delete[] mPagesObjectIDs;
+        mPagesObjectIDs = nullptr;
+        status = ParsePagesObjectIDs();
     } while (false);
 
     return status;
 }
 
+EStatusCode PDFParser::RebuildXref()
+{
+    XrefScanner scanner;
+
+    if (scanner.Scan(mStream) != charta::eSuccess)
+    {
+        TRACE_LOG("PDFParser::RebuildXref, no objects found in file");
+        return charta::eFailure;
+    }
+
+    // cleanup whatever the failed attempt left
+    auto it = mObjectStreamsCache.begin();
+    for (; it != mObjectStreamsCache.end(); ++it)
+        delete[] it->second;
+    mObjectStreamsCache.clear();
+    mRecoveredObjectStreams.clear();
+
+    // later definitions override earlier ones, just like incremental updates do
+    const std::vector<XrefScannedObject> &objects = scanner.GetObjects();
+    ObjectIDType xrefSize = 0;
+    for (const XrefScannedObject &object : objects)
+        xrefSize = std::max(xrefSize, object.mObjectID + 1);
+    mXrefTable.Reset(xrefSize);
+    for (const XrefScannedObject &object : objects)
+        mXrefTable.SetEntry(object.mObjectID, object.mPosition, object.mGenerationNumber, eXrefEntryExisting);
+
+    // object streams that hold the current definition of their object. their content is indexed later
+    for (long long namePosition : scanner.GetKeywordPositions(XrefScanner::eKeywordObjStm))
+    {
+        long long objectIndex = scanner.FindObjectBefore(namePosition);
+        if (objectIndex < 0)
+            continue;
+        const XrefScannedObject &object = objects[objectIndex];
+        if (mXrefTable.GetObjectPosition(object.mObjectID) == object.mPosition &&
+            (mRecoveredObjectStreams.empty() || mRecoveredObjectStreams.back() != object.mObjectID))
+            mRecoveredObjectStreams.push_back(object.mObjectID);
+    }
+
+    mTrailer = RecoverTrailer(scanner);
+    if (!mTrailer)
+    {
+        TRACE_LOG("PDFParser::RebuildXref, could not find a trailer or a catalog");
+        return charta::eFailure;
+    }
+
+    mXrefRebuilt = true;
+    TRACE_LOG2("PDFParser::RebuildXref, rebuilt xref with %ld objects and %ld object streams", xrefSize,
+               (ObjectIDType)mRecoveredObjectStreams.size());
+    return charta::eSuccess;
+}
+
+std::shared_ptr<charta::PDFDictionary> PDFParser::RecoverTrailer(const XrefScanner &inScanner)
+{
+    auto hasUsableRoot = [this](const std::shared_ptr<charta::PDFDictionary> &inDictionary) {
+        PDFObjectCastPtr<charta::PDFIndirectObjectReference> root(inDictionary->QueryDirectObject(ePDFNameRoot));
+        return !!root && mXrefTable.GetType(root->mObjectID) == eXrefEntryExisting;
+    };
+
+    // last trailer with a catalog wins
+    const std::vector<long long> &trailers = inScanner.GetKeywordPositions(XrefScanner::eKeywordTrailer);
+    for (auto it = trailers.rbegin(); it != trailers.rend(); ++it)
+    {
+        MovePositionInStream(*it);
+        PDFObjectCastPtr<charta::PDFDictionary> trailer(mObjectParser.ParseNewObject());
+        if (!!trailer && hasUsableRoot(trailer))
+            return trailer;
+    }
+
+    // then xref streams, whose dictionary is the trailer
+    const std::vector<XrefScannedObject> &objects = inScanner.GetObjects();
+    const std::vector<long long> &xrefStreams = inScanner.GetKeywordPositions(XrefScanner::eKeywordXRef);
+    for (auto it = xrefStreams.rbegin(); it != xrefStreams.rend(); ++it)
+    {
+        long long objectIndex = inScanner.FindObjectBefore(*it);
+        if (objectIndex < 0)
+            continue;
+        PDFObjectCastPtr<charta::PDFStreamInput> xrefStream(ParseNewObject(objects[objectIndex].mObjectID));
+        if (!xrefStream)
+            continue;
+        std::shared_ptr<charta::PDFDictionary> trailer = xrefStream->QueryStreamDictionary();
+        if (hasUsableRoot(trailer))
+            return trailer;
+    }
+
+    // last resort, make up a trailer for the last catalog
+    const std::vector<long long> &catalogs = inScanner.GetKeywordPositions(XrefScanner::eKeywordCatalog);
+    for (auto it = catalogs.rbegin(); it != catalogs.rend(); ++it)
+    {
+        long long objectIndex = inScanner.FindObjectBefore(*it);
+        if (objectIndex < 0)
+            continue;
+        const XrefScannedObject &object = objects[objectIndex];
+        PDFObjectCastPtr<charta::PDFDictionary> catalog(ParseNewObject(object.mObjectID));
+        if (!catalog)
+            continue;
+        PDFObjectCastPtr<charta::PDFName> type(catalog->QueryDirectObject(ePDFNameType));
+        if (!type || type->GetValue() != "Catalog")
+            continue;
+
+        auto trailer = std::make_shared<charta::PDFDictionary>();
+        trailer->Insert(std::make_shared<charta::PDFName>("Size"),
+                        std::make_shared<charta::PDFInteger>(mXrefTable.GetSize()));
+        trailer->Insert(std::make_shared<charta::PDFName>("Root"),
+                        std::make_shared<charta::PDFIndirectObjectReference>(object.mObjectID,
+                                                                             object.mGenerationNumber));
+        return trailer;
+    }
+
+    return nullptr;
+}
+
+EStatusCode PDFParser::IndexRecoveredObjectStreams()
+{
+    for (ObjectIDType objectStreamID : mRecoveredObjectStreams)
+    {
+        PDFObjectCastPtr<charta::PDFStreamInput> objectStream(ParseNewObject(objectStreamID));
+        if (!objectStream)
+            continue;
+
+        std::shared_ptr<charta::PDFDictionary> streamDictionary(objectStream->QueryStreamDictionary());
+        PDFObjectCastPtr<PDFInteger> streamObjectsCount(QueryDictionaryObject(streamDictionary, ePDFNameN));
+        if (!streamObjectsCount || streamObjectsCount->GetValue() <= 0)
+            continue;
+        auto objectsCount = (ObjectIDType)streamObjectsCount->GetValue();
+        long long objectStreamPosition = mXrefTable.GetObjectPosition(objectStreamID);
+
+        charta::IByteReader *objectSource = CreateInputStreamReader(objectStream);
+        if (objectSource == nullptr)
+            continue;
+        InputStreamSkipperStream skipperStream(objectSource);
+        MovePositionInStream(objectStream->GetStreamContentStart());
+        mObjectParser.SetReadStream(&skipperStream, &skipperStream);
+
+        auto *header = new ObjectStreamHeaderEntry[objectsCount];
+        EStatusCode status = ParseObjectStreamHeader(header, objectsCount, mReadContext);
+        mObjectParser.SetReadStream(mStream, &mCurrentPositionProvider);
+        if (status != charta::eSuccess)
+        {
+            TRACE_LOG1("PDFParser::IndexRecoveredObjectStreams, failed to read object stream %ld header, skipping",
+                       objectStreamID);
+            delete[] header;
+            continue;
+        }
+
+        // an object defined directly after the object stream is a later version, and stays
+        for (ObjectIDType i = 0; i < objectsCount; ++i)
+        {
+            ObjectIDType objectID = header[i].mObjectNumber;
+            if (objectID == 0 || objectID == objectStreamID)
+                continue;
+            mXrefTable.ExtendToSize(objectID + 1);
+            if (mXrefTable.GetType(objectID) == eXrefEntryExisting &&
+                mXrefTable.GetObjectPosition(objectID) > objectStreamPosition)
+                continue;
+            mXrefTable.SetEntry(objectID, objectStreamID, i, eXrefEntryStreamObject);
+        }
+
+        auto inserted = mObjectStreamsCache.insert(
+            ObjectIDTypeToObjectStreamHeaderEntryMap::value_type(objectStreamID, header));
+        if (!inserted.second)
+            delete[] header;
+    }
+
+    // the xref is final now
+    mRecoveredObjectStreams.clear();
+    return charta::eSuccess;
+}
+
+bool PDFParser::IsXrefRebuilt() const
+{
+    return mXrefRebuilt;
+}
+
 PDFObjectParser &PDFParser::GetObjectParser()
 {
     return mObjectParser;
 }
 
+void PDFParser::SetObjectArena(std::shared_ptr<charta::PDFObjectArena> inArena)
+{
+    mObjectParser.SetArena(std::move(inArena));
+}
+
+std::shared_ptr<charta::PDFObjectArena> PDFParser::GetObjectArena() const
+{
+    return mObjectParser.GetArena();
+}
+
 DecryptionHelper &PDFParser::GetDecryptionHelper()
 {
     return mDecryptionHelper;
@@ -461,15 +703,11 @@ EStatusCode PDFParser::BuildXrefTableFromTable()
 
     do
     {
-        status = DetermineXrefSize();
-        if (status != charta::eSuccess)
-            break;
-
         status = InitializeXref();
         if (status != charta::eSuccess)
             break;
 
-        bool hasPrev = mTrailer->Exists("Prev");
+        bool hasPrev = mTrailer->Exists(ePDFNamePrev);
         if (hasPrev)
         {
             status = ParsePreviousXrefs(mTrailer);
@@ -477,60 +715,36 @@ EStatusCode PDFParser::BuildXrefTableFromTable()
                 break;
         }
 
-        XrefEntryInput *extendedTable = nullptr;
-        ObjectIDType extendedTableSize;
-        status = ParseXrefFromXrefTable(mXrefTable, mXrefSize, mLastXrefPosition, !hasPrev, &extendedTable,
-                                        &extendedTableSize);
+        status = ParseXrefFromXrefTable(mLastXrefPosition, !hasPrev);
         if (status != charta::eSuccess)
             break;
 
-        // Table may have been extended, in which case replace the pointer and current size
-        if (extendedTable != nullptr)
-        {
-            mXrefSize = extendedTableSize;
-            delete[] mXrefTable;
-            mXrefTable = extendedTable;
-        }
-
         // For hybrids, check also XRefStm entry
-        PDFObjectCastPtr<PDFInteger> xrefStmReference(mTrailer->QueryDirectObject("XRefStm"));
+        PDFObjectCastPtr<PDFInteger> xrefStmReference(mTrailer->QueryDirectObject(ePDFNameXRefStm));
         if (!xrefStmReference)
             break;
         // if exists, merge update xref
-        status = ParseXrefFromXrefStream(mXrefTable, mXrefSize, xrefStmReference->GetValue(), &extendedTable,
-                                         &extendedTableSize);
+        status = ParseXrefFromXrefStream(xrefStmReference->GetValue());
         if (status != charta::eSuccess)
         {
             TRACE_LOG("PDFParser::ParseDirectory, failure to parse xref in hybrid mode");
             break;
         }
-        if (extendedTable != nullptr)
-        {
-            mXrefSize = extendedTableSize;
-            delete[] mXrefTable;
-            mXrefTable = extendedTable;
-        }
     } while (false);
 
     return status;
 }
 
-EStatusCode PDFParser::DetermineXrefSize()
+EStatusCode PDFParser::InitializeXref()
 {
-    PDFObjectCastPtr<PDFInteger> aSize(mTrailer->QueryDirectObject("Size"));
+    PDFObjectCastPtr<PDFInteger> aSize(mTrailer->QueryDirectObject(ePDFNameSize));
 
     if (!aSize)
     {
         return charta::eFailure;
     }
 
-    mXrefSize = (ObjectIDType)aSize->GetValue();
-    return charta::eSuccess;
-}
-
-EStatusCode PDFParser::InitializeXref()
-{
-    mXrefTable = new XrefEntryInput[mXrefSize];
+    mXrefTable.Reset((ObjectIDType)aSize->GetValue());
     return charta::eSuccess;
 }
 
@@ -539,9 +753,7 @@ using ULong = BoxingBaseWithRW<unsigned long>;
 using LongFilePositionTypeBox = BoxingBaseWithRW<long long>;
 
 static const std::string scXref = "xref";
-EStatusCode PDFParser::ParseXrefFromXrefTable(XrefEntryInput *inXrefTable, ObjectIDType inXrefSize,
-                                              long long inXrefPosition, bool inIsFirstXref,
-                                              XrefEntryInput **outExtendedTable, ObjectIDType *outExtendedTableSize)
+EStatusCode PDFParser::ParseXrefFromXrefTable(long long inXrefPosition, bool inIsFirstXref)
 {
     // K. cross ref starts at  xref position
     // and ends with trailer (or when exahausted the number of objects...whichever first)
@@ -552,8 +764,6 @@ EStatusCode PDFParser::ParseXrefFromXrefTable(XrefEntryInput *inXrefTable, Objec
     ObjectIDType firstNonSectionObject;
     uint8_t entry[20];
 
-    *outExtendedTable = nullptr;
-
     tokenizer.SetReadStream(mStream);
     MovePositionInStream(inXrefPosition);
 
@@ -611,15 +821,8 @@ EStatusCode PDFParser::ParseXrefFromXrefTable(XrefEntryInput *inXrefTable, Objec
             firstNonSectionObject = currentObject + ObjectIDTypeBox(token.second);
 
             // if the segment declared objects above the xref size, consult policy on what to do
-            if (firstNonSectionObject > inXrefSize && mAllowExtendingSegments)
-            {
-                inXrefTable = ExtendXrefTableToSize(inXrefTable, inXrefSize, firstNonSectionObject);
-                inXrefSize = firstNonSectionObject;
-                if (*outExtendedTable != nullptr)
-                    delete[] * outExtendedTable;
-                *outExtendedTable = inXrefTable;
-                *outExtendedTableSize = firstNonSectionObject;
-            }
+            if (firstNonSectionObject > mXrefTable.GetSize() && mAllowExtendingSegments)
+                mXrefTable.ExtendToSize(firstNonSectionObject);
 
             // now parse the section.
             while (currentObject < firstNonSectionObject)
@@ -627,12 +830,11 @@ EStatusCode PDFParser::ParseXrefFromXrefTable(XrefEntryInput *inXrefTable, Objec
                 status = ReadNextXrefEntry(entry);
                 if (status != eSuccess)
                     break;
-                if (currentObject < inXrefSize)
+                if (currentObject < mXrefTable.GetSize())
                 {
-                    inXrefTable[currentObject].mObjectPosition =
-                        LongFilePositionTypeBox(std::string((const char *)entry, 10));
-                    inXrefTable[currentObject].mRivision = ULong(std::string((const char *)(entry + 11), 5));
-                    inXrefTable[currentObject].mType = entry[17] == 'n' ? eXrefEntryExisting : eXrefEntryDelete;
+                    mXrefTable.SetEntry(currentObject, LongFilePositionTypeBox(std::string((const char *)entry, 10)),
+                                        ULong(std::string((const char *)(entry + 11), 5)),
+                                        entry[17] == 'n' ? eXrefEntryExisting : eXrefEntryDelete);
                 }
                 ++currentObject;
             }
@@ -676,16 +878,6 @@ EStatusCode PDFParser::ReadNextXrefEntry(uint8_t inBuffer[20])
     return status;
 }
 
-XrefEntryInput *PDFParser::ExtendXrefTableToSize(XrefEntryInput *inXrefTable, ObjectIDType inOldSize,
-                                                 ObjectIDType inNewSize)
-{
-    auto *newTable = new XrefEntryInput[inNewSize];
-
-    for (ObjectIDType i = 0; i < inOldSize; ++i)
-        newTable[i] = inXrefTable[i];
-    return newTable;
-}
-
 std::shared_ptr<charta::PDFDictionary> PDFParser::GetTrailer()
 {
     return mTrailer;
@@ -698,36 +890,39 @@ double PDFParser::GetPDFLevel() const
 
 std::shared_ptr<charta::PDFObject> PDFParser::ParseNewObject(ObjectIDType inObjectId)
 {
-    if (inObjectId >= mXrefSize)
-    {
-        return nullptr;
-    }
-    if (eXrefEntryExisting == mXrefTable[inObjectId].mType)
+    return ParseNewObject(inObjectId, mReadContext);
+}
+
+std::shared_ptr<charta::PDFObject> PDFParser::ParseNewObject(ObjectIDType inObjectId, PDFParserReadContext &ioContext)
+{
+    EXrefEntryType entryType = mXrefTable.GetType(inObjectId);
+    if (eXrefEntryExisting == entryType)
     {
-        return ParseExistingInDirectObject(inObjectId);
+        return ParseExistingInDirectObject(inObjectId, ioContext);
     }
-    if (eXrefEntryStreamObject == mXrefTable[inObjectId].mType)
+    if (eXrefEntryStreamObject == entryType)
     {
-        return ParseExistingInDirectStreamObject(inObjectId);
+        return ParseExistingInDirectStreamObject(inObjectId, ioContext);
     }
     return nullptr;
 }
 
 ObjectIDType PDFParser::GetObjectsCount() const
 {
-    return mXrefSize;
+    return mXrefTable.GetSize();
 }
 
 static const std::string scObj = "obj";
-std::shared_ptr<charta::PDFObject> PDFParser::ParseExistingInDirectObject(ObjectIDType inObjectID)
+std::shared_ptr<charta::PDFObject> PDFParser::ParseExistingInDirectObject(ObjectIDType inObjectID,
+                                                                          PDFParserReadContext &ioContext)
 {
-    MovePositionInStream(mXrefTable[inObjectID].mObjectPosition);
+    MovePositionInStream(mXrefTable.GetObjectPosition(inObjectID), ioContext);
 
     // should get us to the ObjectNumber ObjectVersion obj section
     // verify that it's good and if so continue to parse the object itself
 
     // verify object ID
-    PDFObjectCastPtr<PDFInteger> idObject(mObjectParser.ParseNewObject());
+    PDFObjectCastPtr<PDFInteger> idObject(ioContext.mObjectParser->ParseNewObject());
 
     if (!idObject)
     {
@@ -744,7 +939,7 @@ std::shared_ptr<charta::PDFObject> PDFParser::ParseExistingInDirectObject(Object
     }
 
     // verify object Version
-    PDFObjectCastPtr<PDFInteger> versionObject(mObjectParser.ParseNewObject());
+    PDFObjectCastPtr<PDFInteger> versionObject(ioContext.mObjectParser->ParseNewObject());
 
     if (!versionObject)
     {
@@ -752,16 +947,16 @@ std::shared_ptr<charta::PDFObject> PDFParser::ParseExistingInDirectObject(Object
         return nullptr;
     }
 
-    if ((unsigned long)versionObject->GetValue() != mXrefTable[inObjectID].mRivision)
+    if ((unsigned long)versionObject->GetValue() != mXrefTable.GetRivision(inObjectID))
     {
         TRACE_LOG2("PDFParser::ParseExistingInDirectObject, failed to read object declaration, exepected version = "
                    "%ld, found %ld",
-                   mXrefTable[inObjectID].mRivision, versionObject->GetValue());
+                   mXrefTable.GetRivision(inObjectID), versionObject->GetValue());
         return nullptr;
     }
 
     // now the obj keyword
-    PDFObjectCastPtr<PDFSymbol> objKeyword(mObjectParser.ParseNewObject());
+    PDFObjectCastPtr<PDFSymbol> objKeyword(ioContext.mObjectParser->ParseNewObject());
 
     if (!objKeyword)
     {
@@ -778,7 +973,7 @@ std::shared_ptr<charta::PDFObject> PDFParser::ParseExistingInDirectObject(Object
     }
 
     NotifyIndirectObjectStart(inObjectID, versionObject->GetValue());
-    auto readObject = mObjectParser.ParseNewObject();
+    auto readObject = ioContext.mObjectParser->ParseNewObject();
     NotifyIndirectObjectEnd(readObject);
 
     return readObject;
@@ -799,7 +994,8 @@ EStatusCode PDFParser::ParsePagesObjectIDs()
     do
     {
         // get catalogue, verify indirect reference
-        PDFObjectCastPtr<charta::PDFIndirectObjectReference> catalogReference(mTrailer->QueryDirectObject("Root"));
+        PDFObjectCastPtr<charta::PDFIndirectObjectReference> catalogReference(
+            mTrailer->QueryDirectObject(ePDFNameRoot));
         if (!catalogReference)
         {
             TRACE_LOG("PDFParser::ParsePagesObjectIDs, failed to read catalog reference in trailer");
@@ -816,7 +1012,7 @@ EStatusCode PDFParser::ParsePagesObjectIDs()
         }
 
         // get pages, verify indirect reference
-        PDFObjectCastPtr<charta::PDFIndirectObjectReference> pagesReference(catalog->QueryDirectObject("Pages"));
+        PDFObjectCastPtr<charta::PDFIndirectObjectReference> pagesReference(catalog->QueryDirectObject(ePDFNamePages));
         if (!pagesReference)
         {
             TRACE_LOG("PDFParser::ParsePagesObjectIDs, failed to read pages reference in catalog");
@@ -832,7 +1028,7 @@ EStatusCode PDFParser::ParsePagesObjectIDs()
             break;
         }
 
-        PDFObjectCastPtr<PDFInteger> totalPagesCount(QueryDictionaryObject(pages, "Count"));
+        PDFObjectCastPtr<PDFInteger> totalPagesCount(QueryDictionaryObject(pages, ePDFNameCount));
         if (!totalPagesCount)
         {
             TRACE_LOG("PDFParser::ParsePagesObjectIDs, failed to read pages count");
@@ -872,7 +1068,7 @@ EStatusCode PDFParser::ParsePagesIDs(const std::shared_ptr<charta::PDFDictionary
 
     do
     {
-        PDFObjectCastPtr<charta::PDFName> objectType(inPageNode->QueryDirectObject("Type"));
+        PDFObjectCastPtr<charta::PDFName> objectType(inPageNode->QueryDirectObject(ePDFNameType));
         if (!objectType)
         {
             TRACE_LOG("PDFParser::ParsePagesIDs, can't read object type");
@@ -896,7 +1092,7 @@ EStatusCode PDFParser::ParsePagesIDs(const std::shared_ptr<charta::PDFDictionary
         else if (scPages == objectType->GetValue())
         {
             // a Page tree node
-            auto pKids = inPageNode->QueryDirectObject("Kids");
+            auto pKids = inPageNode->QueryDirectObject(ePDFNameKids);
             if ((pKids != nullptr) && pKids->GetType() == PDFObject::ePDFObjectIndirectObjectReference)
                 pKids = ParseNewObject(std::static_pointer_cast<charta::PDFIndirectObjectReference>(pKids)->mObjectID);
             PDFObjectCastPtr<charta::PDFArray> kidsObject(pKids);
@@ -968,6 +1164,11 @@ ObjectIDType PDFParser::GetPageObjectID(unsigned long inPageIndex)
 }
 
 std::shared_ptr<charta::PDFDictionary> PDFParser::ParsePage(unsigned long inPageIndex)
+{
+    return ParsePage(inPageIndex, mReadContext);
+}
+
+std::shared_ptr<charta::PDFDictionary> PDFParser::ParsePage(unsigned long inPageIndex, PDFParserReadContext &ioContext)
 {
     if (mPagesCount <= inPageIndex)
         return nullptr;
@@ -978,7 +1179,7 @@ std::shared_ptr<charta::PDFDictionary> PDFParser::ParsePage(unsigned long inPage
         return nullptr;
     }
 
-    PDFObjectCastPtr<charta::PDFDictionary> pageObject(ParseNewObject(mPagesObjectIDs[inPageIndex]));
+    PDFObjectCastPtr<charta::PDFDictionary> pageObject(ParseNewObject(mPagesObjectIDs[inPageIndex], ioContext));
 
     if (!pageObject)
     {
@@ -986,7 +1187,7 @@ std::shared_ptr<charta::PDFDictionary> PDFParser::ParsePage(unsigned long inPage
         return nullptr;
     }
 
-    PDFObjectCastPtr<charta::PDFName> objectType(pageObject->QueryDirectObject("Type"));
+    PDFObjectCastPtr<charta::PDFName> objectType(pageObject->QueryDirectObject(ePDFNameType));
 
     if (scPage == objectType->GetValue())
     {
@@ -999,6 +1200,13 @@ std::shared_ptr<charta::PDFDictionary> PDFParser::ParsePage(unsigned long inPage
 
 std::shared_ptr<charta::PDFObject> PDFParser::QueryDictionaryObject(
     const std::shared_ptr<charta::PDFDictionary> &inDictionary, const std::string &inName)
+{
+    return QueryDictionaryObject(inDictionary, inName, mReadContext);
+}
+
+std::shared_ptr<charta::PDFObject> PDFParser::QueryDictionaryObject(
+    const std::shared_ptr<charta::PDFDictionary> &inDictionary, const std::string &inName,
+    PDFParserReadContext &ioContext)
 {
     auto anObject = inDictionary->QueryDirectObject(inName);
 
@@ -1007,16 +1215,41 @@ std::shared_ptr<charta::PDFObject> PDFParser::QueryDictionaryObject(
 
     if (anObject->GetType() == PDFObject::ePDFObjectIndirectObjectReference)
     {
-        auto theActualObject =
-            ParseNewObject(std::static_pointer_cast<charta::PDFIndirectObjectReference>(anObject)->mObjectID);
+        auto theActualObject = ParseNewObject(
+            std::static_pointer_cast<charta::PDFIndirectObjectReference>(anObject)->mObjectID, ioContext);
         return theActualObject;
     }
 
     return anObject;
 }
 
+std::shared_ptr<charta::PDFObject> PDFParser::QueryDictionaryObject(
+    const std::shared_ptr<charta::PDFDictionary> &inDictionary, charta::EPDFWellKnownName inName)
+{
+    return QueryDictionaryObject(inDictionary, inName, mReadContext);
+}
+
+std::shared_ptr<charta::PDFObject> PDFParser::QueryDictionaryObject(
+    const std::shared_ptr<charta::PDFDictionary> &inDictionary, charta::EPDFWellKnownName inName,
+    PDFParserReadContext &ioContext)
+{
+    auto anObject = inDictionary->QueryDirectObject(inName);
+
+    if (anObject != nullptr && anObject->GetType() == PDFObject::ePDFObjectIndirectObjectReference)
+        return ParseNewObject(std::static_pointer_cast<charta::PDFIndirectObjectReference>(anObject)->mObjectID,
+                              ioContext);
+
+    return anObject;
+}
+
 std::shared_ptr<charta::PDFObject> PDFParser::QueryArrayObject(const std::shared_ptr<charta::PDFArray> &inArray,
                                                                unsigned long inIndex)
+{
+    return QueryArrayObject(inArray, inIndex, mReadContext);
+}
+
+std::shared_ptr<charta::PDFObject> PDFParser::QueryArrayObject(const std::shared_ptr<charta::PDFArray> &inArray,
+                                                               unsigned long inIndex, PDFParserReadContext &ioContext)
 {
     auto anObject(inArray->QueryObject(inIndex));
 
@@ -1025,8 +1258,8 @@ std::shared_ptr<charta::PDFObject> PDFParser::QueryArrayObject(const std::shared
 
     if (anObject->GetType() == PDFObject::ePDFObjectIndirectObjectReference)
     {
-        auto theActualObject =
-            ParseNewObject(std::static_pointer_cast<charta::PDFIndirectObjectReference>(anObject)->mObjectID);
+        auto theActualObject = ParseNewObject(
+            std::static_pointer_cast<charta::PDFIndirectObjectReference>(anObject)->mObjectID, ioContext);
         return theActualObject;
     }
 
@@ -1035,7 +1268,7 @@ std::shared_ptr<charta::PDFObject> PDFParser::QueryArrayObject(const std::shared
 
 EStatusCode PDFParser::ParsePreviousXrefs(const std::shared_ptr<charta::PDFDictionary> &inTrailer)
 {
-    PDFObjectCastPtr<PDFInteger> previousPosition(inTrailer->QueryDirectObject("Prev"));
+    PDFObjectCastPtr<PDFInteger> previousPosition(inTrailer->QueryDirectObject(ePDFNamePrev));
     if (!previousPosition)
     {
         TRACE_LOG("PDFParser::ParsePreviousXrefs, unexpected, prev is not integer");
@@ -1044,47 +1277,56 @@ EStatusCode PDFParser::ParsePreviousXrefs(const std::shared_ptr<charta::PDFDicti
 
     EStatusCode status;
 
-    auto *aTable = new XrefEntryInput[mXrefSize];
     do
     {
-        std::shared_ptr<charta::PDFDictionary> trailerP = nullptr;
-
-        XrefEntryInput *extendedTable = nullptr;
-        ObjectIDType extendedTableSize;
-        status = ParsePreviousFileDirectory(previousPosition->GetValue(), aTable, mXrefSize, &trailerP, &extendedTable,
-                                            &extendedTableSize);
+        std::shared_ptr<charta::PDFDictionary> trailer;
+        std::shared_ptr<charta::PDFStreamInput> xrefStream;
+        status = ParsePreviousFileDirectory(previousPosition->GetValue(), &trailer, &xrefStream);
         if (status != charta::eSuccess)
             break;
-        std::shared_ptr<charta::PDFDictionary> trailer(trailerP);
 
-        if (trailer->Exists("Prev"))
+        bool hasPrev = trailer->Exists(ePDFNamePrev);
+        if (hasPrev)
         {
             status = ParsePreviousXrefs(trailer);
             if (status != charta::eSuccess)
                 break;
         }
 
-        // Table may have been extended, in which case replace the pointer and current size
-        ObjectIDType newTableSize;
-        if (extendedTable != nullptr)
+        // older sections are now in the table, so write this one over them, in place
+        if (xrefStream != nullptr)
         {
-            newTableSize = extendedTableSize;
-            delete[] aTable;
-            aTable = extendedTable;
+            status = ParseXrefFromXrefStream(xrefStream);
+            break;
+        }
+
+        status = ParseXrefFromXrefTable(previousPosition->GetValue(), !hasPrev);
+        if (status != charta::eSuccess)
+        {
+            TRACE_LOG1("PDFParser::ParseDirectory, failed to parse xref table in %ld", previousPosition->GetValue());
+            break;
+        }
+
+        // For hybrids, check also XRefStm entry
+        PDFObjectCastPtr<PDFInteger> xrefStmReference(trailer->QueryDirectObject(ePDFNameXRefStm));
+        if (xrefStmReference != nullptr)
+        {
+            // if exists, merge update xref
+            status = ParseXrefFromXrefStream(xrefStmReference->GetValue());
+            if (status != charta::eSuccess)
+            {
+                TRACE_LOG("PDFParser::ParseDirectory, failure to parse xref in hybrid mode");
+                break;
+            }
         }
-        else
-            newTableSize = mXrefSize;
-        MergeXrefWithMainXref(aTable, newTableSize);
     } while (false);
 
-    delete[] aTable;
     return status;
 }
 
-EStatusCode PDFParser::ParsePreviousFileDirectory(long long inXrefPosition, XrefEntryInput *inXrefTable,
-                                                  ObjectIDType inXrefSize,
+EStatusCode PDFParser::ParsePreviousFileDirectory(long long inXrefPosition,
                                                   std::shared_ptr<charta::PDFDictionary> *outTrailer,
-                                                  XrefEntryInput **outExtendedTable, ObjectIDType *outExtendedTableSize)
+                                                  std::shared_ptr<charta::PDFStreamInput> *outXrefStream)
 {
     EStatusCode status = charta::eSuccess;
 
@@ -1103,46 +1345,15 @@ EStatusCode PDFParser::ParsePreviousFileDirectory(long long inXrefPosition, Xref
         if (anObject->GetType() == PDFObject::ePDFObjectSymbol &&
             std::static_pointer_cast<PDFSymbol>(anObject)->GetValue() == scXref)
         {
-            // xref table case
-
-            // Parsing trailer. this is not really necessary at this point, but for faulty PDFs which first xref may
-            // incorrectly skip 0 entry. A simple correction is possible, but it is required to know whether the
+            // xref table case. only the trailer is read here, the entries are read once the previous
+            // directories are in the table. Note that the trailer is also required for faulty PDFs which first xref
+            // may incorrectly skip 0 entry. A simple correction is possible, but it is required to know whether the
             // to-be-parsed xref is the first one, or not.
             std::shared_ptr<charta::PDFDictionary> trailerDictionary = nullptr;
             status = ParseTrailerDictionary(&trailerDictionary);
             if (status != charta::eSuccess)
                 break;
 
-            bool hasPrev = trailerDictionary->Exists("Prev");
-
-            status = ParseXrefFromXrefTable(inXrefTable, inXrefSize, inXrefPosition, !hasPrev, outExtendedTable,
-                                            outExtendedTableSize);
-            if (status != charta::eSuccess)
-            {
-                TRACE_LOG1("PDFParser::ParseDirectory, failed to parse xref table in %ld", inXrefPosition);
-                break;
-            }
-
-            if (*outExtendedTable != nullptr)
-            {
-                inXrefTable = *outExtendedTable;
-                inXrefSize = *outExtendedTableSize;
-            }
-
-            // For hybrids, check also XRefStm entry
-            PDFObjectCastPtr<PDFInteger> xrefStmReference(trailerDictionary->QueryDirectObject("XRefStm"));
-            if (xrefStmReference != nullptr)
-            {
-                // if exists, merge update xref
-                status = ParseXrefFromXrefStream(inXrefTable, inXrefSize, xrefStmReference->GetValue(),
-                                                 outExtendedTable, outExtendedTableSize);
-                if (status != charta::eSuccess)
-                {
-                    TRACE_LOG("PDFParser::ParseDirectory, failure to parse xref in hybrid mode");
-                    break;
-                }
-            }
-
             *outTrailer = trailerDictionary;
         }
         else if (anObject->GetType() == PDFObject::ePDFObjectInteger &&
@@ -1191,11 +1402,7 @@ EStatusCode PDFParser::ParsePreviousFileDirectory(long long inXrefPosition, Xref
             NotifyIndirectObjectEnd(xrefStream);
 
             *outTrailer = xrefStream->QueryStreamDictionary();
-
-            status =
-                ParseXrefFromXrefStream(inXrefTable, inXrefSize, xrefStream, outExtendedTable, outExtendedTableSize);
-            if (status != charta::eSuccess)
-                break;
+            *outXrefStream = xrefStream;
         }
         else
         {
@@ -1206,23 +1413,6 @@ EStatusCode PDFParser::ParsePreviousFileDirectory(long long inXrefPosition, Xref
     return status;
 }
 
-void PDFParser::MergeXrefWithMainXref(XrefEntryInput *inTableToMerge, ObjectIDType inMergedTableSize)
-{
-    if (inMergedTableSize > mXrefSize)
-    {
-        XrefEntryInput *newTable = ExtendXrefTableToSize(mXrefTable, mXrefSize, inMergedTableSize);
-        mXrefSize = inMergedTableSize;
-        delete[] mXrefTable;
-        mXrefTable = newTable;
-    }
-
-    for (ObjectIDType i = 0; i < mXrefSize; ++i)
-    {
-        if (inTableToMerge[i].mType != eXrefEntryUndefined)
-            mXrefTable[i] = inTableToMerge[i];
-    }
-}
-
 EStatusCode PDFParser::ParseFileDirectory()
 {
     EStatusCode status = charta::eSuccess;
@@ -1326,43 +1516,24 @@ EStatusCode PDFParser::BuildXrefTableAndTrailerFromXrefStream(long long inXrefSt
         auto xrefDictionary(xrefStream->QueryStreamDictionary());
         mTrailer = xrefDictionary;
 
-        status = DetermineXrefSize();
-        if (status != charta::eSuccess)
-            break;
-
         status = InitializeXref();
         if (status != charta::eSuccess)
             break;
 
-        if (mTrailer->Exists("Prev"))
+        if (mTrailer->Exists(ePDFNamePrev))
         {
             status = ParsePreviousXrefs(mTrailer);
             if (status != charta::eSuccess)
                 break;
         }
 
-        XrefEntryInput *extendedTable = nullptr;
-        ObjectIDType extendedTableSize;
-        status = ParseXrefFromXrefStream(mXrefTable, mXrefSize, xrefStream, &extendedTable, &extendedTableSize);
-        if (status != charta::eSuccess)
-            break;
-
-        // Table may have been extended, in which case replace the pointer and current size
-        if (extendedTable != nullptr)
-        {
-            mXrefSize = extendedTableSize;
-            delete[] mXrefTable;
-            mXrefTable = extendedTable;
-        }
-
+        status = ParseXrefFromXrefStream(xrefStream);
     } while (false);
 
     return status;
 }
 
-EStatusCode PDFParser::ParseXrefFromXrefStream(XrefEntryInput *inXrefTable, ObjectIDType inXrefSize,
-                                               long long inXrefPosition, XrefEntryInput **outExtendedTable,
-                                               ObjectIDType *outExtendedTableSize)
+EStatusCode PDFParser::ParseXrefFromXrefStream(long long inXrefPosition)
 {
     EStatusCode status = charta::eSuccess;
 
@@ -1419,14 +1590,12 @@ EStatusCode PDFParser::ParseXrefFromXrefStream(XrefEntryInput *inXrefTable, Obje
 
         NotifyIndirectObjectEnd(xrefStream);
 
-        status = ParseXrefFromXrefStream(inXrefTable, inXrefSize, xrefStream, outExtendedTable, outExtendedTableSize);
+        status = ParseXrefFromXrefStream(xrefStream);
     } while (false);
     return status;
 }
 
-EStatusCode PDFParser::ParseXrefFromXrefStream(XrefEntryInput *inXrefTable, ObjectIDType inXrefSize,
-                                               const std::shared_ptr<charta::PDFStreamInput> &inXrefStream,
-                                               XrefEntryInput **outExtendedTable, ObjectIDType *outExtendedTableSize)
+EStatusCode PDFParser::ParseXrefFromXrefStream(const std::shared_ptr<charta::PDFStreamInput> &inXrefStream)
 {
     // 1. Setup the stream to read from the stream start location
     // 2. Set it up with an input stream to decode if required
@@ -1437,23 +1606,22 @@ EStatusCode PDFParser::ParseXrefFromXrefStream(XrefEntryInput *inXrefTable, Obje
 
     EStatusCode status = charta::eSuccess;
 
-    outExtendedTable = nullptr;
-
-    charta::IByteReader *xrefStreamSource = CreateInputStreamReader(inXrefStream);
+    std::vector<uint8_t> xrefStreamContent = AcquireStreamBuffer();
+    InputByteArrayStream xrefStreamReader;
+    charta::IByteReader *xrefStreamSource = &xrefStreamReader;
     int *widthsArray = nullptr;
 
     do
     {
-        if (xrefStreamSource == nullptr)
-        {
-            status = charta::eFailure;
+        status = DecodeStreamToBuffer(inXrefStream, xrefStreamContent);
+        if (status != charta::eSuccess)
             break;
-        }
+        xrefStreamReader.Assign(xrefStreamContent.data(), (long long)xrefStreamContent.size());
 
         std::shared_ptr<charta::PDFDictionary> streamDictionary(inXrefStream->QueryStreamDictionary());
 
         // setup w array
-        PDFObjectCastPtr<charta::PDFArray> wArray(QueryDictionaryObject(streamDictionary, "W"));
+        PDFObjectCastPtr<charta::PDFArray> wArray(QueryDictionaryObject(streamDictionary, ePDFNameW));
         if (!wArray)
         {
             TRACE_LOG("PDFParser::ParseXrefFromXrefStream, W array not available. failing");
@@ -1478,12 +1646,11 @@ EStatusCode PDFParser::ParseXrefFromXrefStream(XrefEntryInput *inXrefTable, Obje
             break;
 
         // read the segments from the stream
-        PDFObjectCastPtr<charta::PDFArray> subsectionsIndex(QueryDictionaryObject(streamDictionary, "Index"));
-        MovePositionInStream(inXrefStream->GetStreamContentStart());
+        PDFObjectCastPtr<charta::PDFArray> subsectionsIndex(QueryDictionaryObject(streamDictionary, ePDFNameIndex));
 
         if (!subsectionsIndex)
         {
-            PDFObjectCastPtr<PDFInteger> xrefSize(QueryDictionaryObject(streamDictionary, "Size"));
+            PDFObjectCastPtr<PDFInteger> xrefSize(QueryDictionaryObject(streamDictionary, ePDFNameSize));
             if (!xrefSize)
             {
                 TRACE_LOG("PDFParser::ParseXrefFromXrefStream, xref size does not exist for this stream");
@@ -1493,22 +1660,14 @@ EStatusCode PDFParser::ParseXrefFromXrefStream(XrefEntryInput *inXrefTable, Obje
 
             // if reading objects past expected range interesting consult policy
             auto readXrefSize = (ObjectIDType)xrefSize->GetValue();
-            if (readXrefSize > inXrefSize)
+            if (readXrefSize > mXrefTable.GetSize())
             {
                 if (mAllowExtendingSegments)
-                {
-                    inXrefTable = ExtendXrefTableToSize(inXrefTable, inXrefSize, readXrefSize);
-                    inXrefSize = readXrefSize;
-                    if (*outExtendedTable != nullptr)
-                        delete[] * outExtendedTable;
-                    *outExtendedTable = inXrefTable;
-                    *outExtendedTableSize = readXrefSize;
-                }
+                    mXrefTable.ExtendToSize(readXrefSize);
                 else
                     break;
             }
-            status =
-                ReadXrefStreamSegment(inXrefTable, 0, readXrefSize, xrefStreamSource, widthsArray, wArray->GetLength());
+            status = ReadXrefStreamSegment(0, readXrefSize, xrefStreamSource, widthsArray, wArray->GetLength());
         }
         else
         {
@@ -1543,41 +1702,39 @@ EStatusCode PDFParser::ParseXrefFromXrefStream(XrefEntryInput *inXrefTable, Obje
                 }
                 auto objectsCount = (ObjectIDType)segmentValue->GetValue();
                 // if reading objects past expected range interesting consult policy
-                if (startObject + objectsCount > inXrefSize)
+                if (startObject + objectsCount > mXrefTable.GetSize())
                 {
                     if (mAllowExtendingSegments)
-                    {
-                        inXrefTable = ExtendXrefTableToSize(inXrefTable, inXrefSize, startObject + objectsCount);
-                        inXrefSize = startObject + objectsCount;
-                        if (*outExtendedTable != nullptr)
-                            delete[] * outExtendedTable;
-                        *outExtendedTable = inXrefTable;
-                        *outExtendedTableSize = startObject + objectsCount;
-                    }
+                        mXrefTable.ExtendToSize(startObject + objectsCount);
                     else
                         break;
                 }
-                status = ReadXrefStreamSegment(inXrefTable, startObject,
-                                               std::min<ObjectIDType>(objectsCount, inXrefSize - startObject),
+                status = ReadXrefStreamSegment(startObject,
+                                               std::min<ObjectIDType>(objectsCount, mXrefTable.GetSize() - startObject),
                                                xrefStreamSource, widthsArray, wArray->GetLength());
             }
         }
     } while (false);
 
-    delete xrefStreamSource;
+    ReleaseStreamBuffer(std::move(xrefStreamContent));
     delete[] widthsArray;
     return status;
 }
 
 void PDFParser::MovePositionInStream(long long inPosition)
 {
-    mStream->SetPosition(inPosition);
-    mObjectParser.ResetReadState();
+    MovePositionInStream(inPosition, mReadContext);
 }
 
-EStatusCode PDFParser::ReadXrefStreamSegment(XrefEntryInput *inXrefTable, ObjectIDType inSegmentStartObject,
-                                             ObjectIDType inSegmentCount, charta::IByteReader *inReadFrom,
-                                             int *inEntryWidths, unsigned long inEntryWidthsSize)
+void PDFParser::MovePositionInStream(long long inPosition, PDFParserReadContext &ioContext)
+{
+    ioContext.mStream->SetPosition(inPosition);
+    ioContext.mObjectParser->ResetReadState();
+}
+
+EStatusCode PDFParser::ReadXrefStreamSegment(ObjectIDType inSegmentStartObject, ObjectIDType inSegmentCount,
+                                             charta::IByteReader *inReadFrom, int *inEntryWidths,
+                                             unsigned long inEntryWidthsSize)
 {
     ObjectIDType objectToRead = inSegmentStartObject;
     EStatusCode status = charta::eSuccess;
@@ -1594,27 +1751,29 @@ EStatusCode PDFParser::ReadXrefStreamSegment(XrefEntryInput *inXrefTable, Object
          ++objectToRead)
     {
         long long entryType;
+        long long objectPosition;
+        ObjectIDType rivision;
         status = ReadXrefSegmentValue(inReadFrom, inEntryWidths[0], entryType);
         if (status != charta::eSuccess)
             break;
-        status = ReadXrefSegmentValue(inReadFrom, inEntryWidths[1], inXrefTable[objectToRead].mObjectPosition);
+        status = ReadXrefSegmentValue(inReadFrom, inEntryWidths[1], objectPosition);
         if (status != charta::eSuccess)
             break;
-        status = ReadXrefSegmentValue(inReadFrom, inEntryWidths[2], inXrefTable[objectToRead].mRivision);
+        status = ReadXrefSegmentValue(inReadFrom, inEntryWidths[2], rivision);
         if (status != charta::eSuccess)
             break;
 
         if (0 == entryType)
         {
-            inXrefTable[objectToRead].mType = eXrefEntryDelete;
+            mXrefTable.SetEntry(objectToRead, objectPosition, rivision, eXrefEntryDelete);
         }
         else if (1 == entryType)
         {
-            inXrefTable[objectToRead].mType = eXrefEntryExisting;
+            mXrefTable.SetEntry(objectToRead, objectPosition, rivision, eXrefEntryExisting);
         }
         else if (2 == entryType)
         {
-            inXrefTable[objectToRead].mType = eXrefEntryStreamObject;
+            mXrefTable.SetEntry(objectToRead, objectPosition, rivision, eXrefEntryStreamObject);
         }
         else
         {
@@ -1655,7 +1814,8 @@ EStatusCode PDFParser::ReadXrefSegmentValue(charta::IByteReader *inSource, int i
     return status;
 }
 
-std::shared_ptr<charta::PDFObject> PDFParser::ParseExistingInDirectStreamObject(ObjectIDType inObjectId)
+std::shared_ptr<charta::PDFObject> PDFParser::ParseExistingInDirectStreamObject(ObjectIDType inObjectId,
+                                                                                PDFParserReadContext &ioContext)
 {
     // parsing an object in an object stream requires the following:
     // 1. Setting the position to this object stream
@@ -1675,20 +1835,20 @@ std::shared_ptr<charta::PDFObject> PDFParser::ParseExistingInDirectStreamObject(
 
     do
     {
-        objectStreamID = (ObjectIDType)mXrefTable[inObjectId].mObjectPosition;
-        PDFObjectCastPtr<charta::PDFStreamInput> objectStream(ParseNewObject(objectStreamID));
+        objectStreamID = (ObjectIDType)mXrefTable.GetObjectPosition(inObjectId);
+        PDFObjectCastPtr<charta::PDFStreamInput> objectStream(ParseNewObject(objectStreamID, ioContext));
         if (!objectStream)
         {
             TRACE_LOG2("PDFParser::ParseExistingInDirectStreamObject, failed to parse object %ld. failed to find "
                        "object stream for it, which should be %ld",
-                       inObjectId, mXrefTable[inObjectId].mObjectPosition);
+                       inObjectId, mXrefTable.GetObjectPosition(inObjectId));
             status = charta::eFailure;
             break;
         }
 
         std::shared_ptr<charta::PDFDictionary> streamDictionary(objectStream->QueryStreamDictionary());
 
-        PDFObjectCastPtr<PDFInteger> streamObjectsCount(QueryDictionaryObject(streamDictionary, "N"));
+        PDFObjectCastPtr<PDFInteger> streamObjectsCount(QueryDictionaryObject(streamDictionary, ePDFNameN, ioContext));
         if (!streamObjectsCount)
         {
             TRACE_LOG1("PDFParser::ParseExistingInDirectStreamObject, no N key in stream dictionary %ld",
@@ -1698,7 +1858,8 @@ std::shared_ptr<charta::PDFObject> PDFParser::ParseExistingInDirectStreamObject(
         }
         auto objectsCount = (ObjectIDType)streamObjectsCount->GetValue();
 
-        PDFObjectCastPtr<PDFInteger> firstStreamObjectPosition(QueryDictionaryObject(streamDictionary, "First"));
+        PDFObjectCastPtr<PDFInteger> firstStreamObjectPosition(
+            QueryDictionaryObject(streamDictionary, ePDFNameFirst, ioContext));
         if (!streamObjectsCount)
         {
             TRACE_LOG1("PDFParser::ParseExistingInDirectStreamObject, no First key in stream dictionary %ld",
@@ -1707,63 +1868,76 @@ std::shared_ptr<charta::PDFObject> PDFParser::ParseExistingInDirectStreamObject(
             break;
         }
 
-        objectSource = CreateInputStreamReader(objectStream);
+        objectSource = CreateInputStreamReader(objectStream, ioContext);
         skipperStream.Assign(objectSource);
-        MovePositionInStream(objectStream->GetStreamContentStart());
+        MovePositionInStream(objectStream->GetStreamContentStart(), ioContext);
 
-        mObjectParser.SetReadStream(&skipperStream, &skipperStream);
+        ioContext.mObjectParser->SetReadStream(&skipperStream, &skipperStream);
 
-        auto it = mObjectStreamsCache.find(objectStreamID);
+        {
+            std::lock_guard<std::mutex> lock(mObjectStreamsCacheLock);
+            auto it = mObjectStreamsCache.find(objectStreamID);
+            objectStreamHeader = it == mObjectStreamsCache.end() ? nullptr : it->second;
+        }
 
-        if (it == mObjectStreamsCache.end())
+        if (objectStreamHeader == nullptr)
         {
-            objectStreamHeader = new ObjectStreamHeaderEntry[objectsCount];
-            status = ParseObjectStreamHeader(objectStreamHeader, objectsCount);
+            auto *parsedHeader = new ObjectStreamHeaderEntry[objectsCount];
+            status = ParseObjectStreamHeader(parsedHeader, objectsCount, ioContext);
             if (status != charta::eSuccess)
             {
-                delete[] objectStreamHeader;
+                delete[] parsedHeader;
                 break;
             }
-            it = mObjectStreamsCache
-                     .insert(ObjectIDTypeToObjectStreamHeaderEntryMap::value_type(objectStreamID, objectStreamHeader))
-                     .first;
+
+            // readers may parse the same header at the same time. the first one in is kept
+            std::lock_guard<std::mutex> lock(mObjectStreamsCacheLock);
+            auto inserted = mObjectStreamsCache.insert(
+                ObjectIDTypeToObjectStreamHeaderEntryMap::value_type(objectStreamID, parsedHeader));
+            if (!inserted.second)
+                delete[] parsedHeader;
+            objectStreamHeader = inserted.first->second;
         }
-        objectStreamHeader = it->second;
 
-        // verify that i got the right object ID
-        if (objectsCount <= mXrefTable[inObjectId].mRivision ||
-            objectStreamHeader[mXrefTable[inObjectId].mRivision].mObjectNumber != inObjectId)
+        // verify that i got the right object ID. for stream objects the xref second number is the index in the stream
+        unsigned long indexInStream = mXrefTable.GetRivision(inObjectId);
+        if (objectsCount <= indexInStream ||
+            objectStreamHeader[indexInStream].mObjectNumber != inObjectId)
         {
             TRACE_LOG2(
                 "PDFParser::ParseXrefFromXrefStream, wrong object. expecting to find object ID %ld, and found %ld",
                 inObjectId,
-                objectsCount <= mXrefTable[inObjectId].mRivision
+                objectsCount <= indexInStream
                     ? -1
-                    : objectStreamHeader[mXrefTable[inObjectId].mRivision].mObjectNumber);
+                    : objectStreamHeader[indexInStream].mObjectNumber);
             status = charta::eFailure;
             break;
         }
 
         // when parsing the header, should be at position already..so don't skip if already there [using
         // GetCurrentPosition to see if parsed some]
-        if (mXrefTable[inObjectId].mRivision != 0 || skipperStream.GetCurrentPosition() == 0)
+        if (indexInStream != 0 || skipperStream.GetCurrentPosition() == 0)
         {
-            long long objectPositionInStream = objectStreamHeader[mXrefTable[inObjectId].mRivision].mObjectOffset +
+            long long objectPositionInStream = objectStreamHeader[indexInStream].mObjectOffset +
                                                firstStreamObjectPosition->GetValue();
             skipperStream.SkipTo(objectPositionInStream);
-            mObjectParser.ResetReadState();
+            ioContext.mObjectParser->ResetReadState();
         }
 
-        mDecryptionHelper.PauseDecryption(); // objects within objects stream already enjoy the object stream
-                                             // protection, and so are no longer encrypted
+        // objects within objects stream already enjoy the object stream protection, and so are no longer encrypted.
+        // [pausing only matters for encrypted files, and those are never read concurrently]
+        bool isEncrypted = IsEncrypted();
+        if (isEncrypted)
+            mDecryptionHelper.PauseDecryption();
         NotifyIndirectObjectStart(inObjectId, 0);
-        anObject = mObjectParser.ParseNewObject();
+        anObject = ioContext.mObjectParser->ParseNewObject();
         NotifyIndirectObjectEnd(anObject);
-        mDecryptionHelper.ReleaseDecryption();
+        if (isEncrypted)
+            mDecryptionHelper.ReleaseDecryption();
 
     } while (false);
 
-    mObjectParser.SetReadStream(mStream, &mCurrentPositionProvider);
+    ioContext.mObjectParser->SetReadStream(ioContext.mStream, ioContext.mPositionProvider);
 
     return anObject;
 }
@@ -1784,14 +1958,15 @@ void PDFParser::NotifyIndirectObjectEnd(const std::shared_ptr<charta::PDFObject>
     mDecryptionHelper.OnObjectEnd(inObject);
 }
 
-EStatusCode PDFParser::ParseObjectStreamHeader(ObjectStreamHeaderEntry *inHeaderInfo, ObjectIDType inObjectsCount)
+EStatusCode PDFParser::ParseObjectStreamHeader(ObjectStreamHeaderEntry *inHeaderInfo, ObjectIDType inObjectsCount,
+                                               PDFParserReadContext &ioContext)
 {
     ObjectIDType currentObject = 0;
     EStatusCode status = charta::eSuccess;
 
     while (currentObject < inObjectsCount && (charta::eSuccess == status))
     {
-        PDFObjectCastPtr<PDFInteger> objectNumber(mObjectParser.ParseNewObject());
+        PDFObjectCastPtr<PDFInteger> objectNumber(ioContext.mObjectParser->ParseNewObject());
         if (!objectNumber)
         {
             TRACE_LOG("PDFParser::ParseObjectStreamHeader, parsing failed when reading object number. either not "
@@ -1800,7 +1975,7 @@ EStatusCode PDFParser::ParseObjectStreamHeader(ObjectStreamHeaderEntry *inHeader
             break;
         }
 
-        PDFObjectCastPtr<PDFInteger> objectPosition(mObjectParser.ParseNewObject());
+        PDFObjectCastPtr<PDFInteger> objectPosition(ioContext.mObjectParser->ParseNewObject());
         if (!objectPosition)
         {
             TRACE_LOG("PDFParser::ParseObjectStreamHeader, parsing failed when reading object position. either not "
@@ -1839,6 +2014,12 @@ charta::IByteReader *PDFParser::WrapWithDecryptionFilter(const std::shared_ptr<c
 }
 
 charta::IByteReader *PDFParser::CreateInputStreamReader(const std::shared_ptr<charta::PDFStreamInput> &inStream)
+{
+    return CreateInputStreamReader(inStream, mReadContext);
+}
+
+charta::IByteReader *PDFParser::CreateInputStreamReader(const std::shared_ptr<charta::PDFStreamInput> &inStream,
+                                                        PDFParserReadContext &ioContext)
 {
     std::shared_ptr<charta::PDFDictionary> streamDictionary(inStream->QueryStreamDictionary());
     charta::IByteReader *result = nullptr;
@@ -1848,7 +2029,7 @@ charta::IByteReader *PDFParser::CreateInputStreamReader(const std::shared_ptr<ch
     {
 
         // setup stream according to length and possible filter
-        PDFObjectCastPtr<PDFInteger> lengthObject(QueryDictionaryObject(streamDictionary, "Length"));
+        PDFObjectCastPtr<PDFInteger> lengthObject(QueryDictionaryObject(streamDictionary, ePDFNameLength, ioContext));
         if (!lengthObject)
         {
             TRACE_LOG("PDFParser::CreateInputStreamReader, stream does not have length, failing");
@@ -1856,11 +2037,12 @@ charta::IByteReader *PDFParser::CreateInputStreamReader(const std::shared_ptr<ch
             break;
         }
 
-        result = new InputLimitedStream(mStream, lengthObject->GetValue(), false);
+        result = new InputLimitedStream(ioContext.mStream, lengthObject->GetValue(), false);
 
         result = WrapWithDecryptionFilter(inStream, result);
 
-        std::shared_ptr<charta::PDFObject> filterObject(QueryDictionaryObject(streamDictionary, "Filter"));
+        std::shared_ptr<charta::PDFObject> filterObject(
+            QueryDictionaryObject(streamDictionary, ePDFNameFilter, ioContext));
         if (!filterObject)
         {
             // no filter, so stop here
@@ -1870,7 +2052,8 @@ charta::IByteReader *PDFParser::CreateInputStreamReader(const std::shared_ptr<ch
         if (filterObject->GetType() == PDFObject::ePDFObjectArray)
         {
             auto filterObjectArray = std::static_pointer_cast<charta::PDFArray>(filterObject);
-            PDFObjectCastPtr<charta::PDFArray> decodeParams(QueryDictionaryObject(streamDictionary, "DecodeParms"));
+            PDFObjectCastPtr<charta::PDFArray> decodeParams(
+                QueryDictionaryObject(streamDictionary, ePDFNameDecodeParms, ioContext));
             for (unsigned long i = 0; i < filterObjectArray->GetLength() && eSuccess == status; ++i)
             {
                 PDFObjectCastPtr<charta::PDFName> filterObjectItem(filterObjectArray->QueryObject(i));
@@ -1885,16 +2068,17 @@ charta::IByteReader *PDFParser::CreateInputStreamReader(const std::shared_ptr<ch
                 EStatusCodeAndIByteReader createStatus;
                 if (!decodeParams)
                 {
-                    createStatus = CreateFilterForStream(result, filterObjectItem, nullptr, inStream);
+                    createStatus = CreateFilterForStream(result, filterObjectItem, nullptr, inStream, ioContext);
                 }
                 else
                 {
-                    PDFObjectCastPtr<charta::PDFDictionary> decodeParamsItem(QueryArrayObject(decodeParams, i));
+                    PDFObjectCastPtr<charta::PDFDictionary> decodeParamsItem(
+                        QueryArrayObject(decodeParams, i, ioContext));
 
                     createStatus = CreateFilterForStream(
-                        result, std::static_pointer_cast<charta::PDFName>(filterObject),
+                        result, filterObjectItem,
                         !decodeParamsItem ? nullptr : std::shared_ptr<charta::PDFDictionary>(decodeParamsItem),
-                        inStream);
+                        inStream, ioContext);
                 }
 
                 if (createStatus.first != eSuccess)
@@ -1907,11 +2091,11 @@ charta::IByteReader *PDFParser::CreateInputStreamReader(const std::shared_ptr<ch
         }
         else if (filterObject->GetType() == PDFObject::ePDFObjectName)
         {
-            auto decodeParams =
-                std::static_pointer_cast<PDFDictionary>(QueryDictionaryObject(streamDictionary, "DecodeParms"));
+            auto decodeParams = std::static_pointer_cast<PDFDictionary>(
+                QueryDictionaryObject(streamDictionary, ePDFNameDecodeParms, ioContext));
 
             auto createStatus = CreateFilterForStream(result, std::static_pointer_cast<charta::PDFName>(filterObject),
-                                                      !decodeParams ? nullptr : decodeParams, inStream);
+                                                      !decodeParams ? nullptr : decodeParams, inStream, ioContext);
             if (createStatus.first != eSuccess)
             {
                 status = charta::eFailure;
@@ -1940,7 +2124,8 @@ charta::IByteReader *PDFParser::CreateInputStreamReader(const std::shared_ptr<ch
 EStatusCodeAndIByteReader PDFParser::CreateFilterForStream(charta::IByteReader *inStream,
                                                            const std::shared_ptr<charta::PDFName> &inFilterName,
                                                            const std::shared_ptr<charta::PDFDictionary> &inDecodeParams,
-                                                           const std::shared_ptr<charta::PDFStreamInput> &inPDFStream)
+                                                           const std::shared_ptr<charta::PDFStreamInput> &inPDFStream,
+                                                           PDFParserReadContext &ioContext)
 {
     EStatusCode status = eSuccess;
     charta::IByteReader *result = nullptr;
@@ -1964,8 +2149,10 @@ EStatusCodeAndIByteReader PDFParser::CreateFilterForStream(charta::IByteReader *
                 int early = 1;
                 if (inDecodeParams != nullptr)
                 {
-                    PDFObjectCastPtr<PDFInteger> earlyObj(QueryDictionaryObject(inDecodeParams, "EarlyChange"));
-                    early = earlyObj->GetValue();
+                    PDFObjectCastPtr<PDFInteger> earlyObj(
+                        QueryDictionaryObject(inDecodeParams, ePDFNameEarlyChange, ioContext));
+                    if (!!earlyObj)
+                        early = (int)earlyObj->GetValue();
                 }
                 lzwStream = new InputLZWDecodeStream(early);
                 lzwStream->Assign(inStream);
@@ -1978,16 +2165,17 @@ EStatusCodeAndIByteReader PDFParser::CreateFilterForStream(charta::IByteReader *
                 break;
 
             // read predictor, and apply the relevant predictor function
-            PDFObjectCastPtr<PDFInteger> predictor(QueryDictionaryObject(inDecodeParams, "Predictor"));
+            PDFObjectCastPtr<PDFInteger> predictor(QueryDictionaryObject(inDecodeParams, ePDFNamePredictor, ioContext));
 
             if (!predictor || predictor->GetValue() == 1)
             {
                 break;
             }
 
-            PDFObjectCastPtr<PDFInteger> columns(QueryDictionaryObject(inDecodeParams, "Columns"));
-            PDFObjectCastPtr<PDFInteger> colors(QueryDictionaryObject(inDecodeParams, "Colors"));
-            PDFObjectCastPtr<PDFInteger> bitsPerComponent(QueryDictionaryObject(inDecodeParams, "BitsPerComponent"));
+            PDFObjectCastPtr<PDFInteger> columns(QueryDictionaryObject(inDecodeParams, ePDFNameColumns, ioContext));
+            PDFObjectCastPtr<PDFInteger> colors(QueryDictionaryObject(inDecodeParams, ePDFNameColors, ioContext));
+            PDFObjectCastPtr<PDFInteger> bitsPerComponent(
+                QueryDictionaryObject(inDecodeParams, ePDFNameBitsPerComponent, ioContext));
             size_t columnsValue = columns != nullptr ? (size_t)columns->GetValue() : 1;
             size_t colorsValue = colors != nullptr ? (size_t)colors->GetValue() : 1;
             size_t bitsPerComponentValue = bitsPerComponent != nullptr ? (size_t)bitsPerComponent->GetValue() : 8;
@@ -2033,7 +2221,8 @@ EStatusCodeAndIByteReader PDFParser::CreateFilterForStream(charta::IByteReader *
 #endif
         else if (inFilterName->GetValue() == "Crypt")
         {
-            PDFObjectCastPtr<charta::PDFName> cryptFilterName(QueryDictionaryObject(inDecodeParams, "Name"));
+            PDFObjectCastPtr<charta::PDFName> cryptFilterName(
+                QueryDictionaryObject(inDecodeParams, ePDFNameName, ioContext));
 
             result =
                 mDecryptionHelper.CreateDecryptionFilterForStream(inPDFStream, inStream, cryptFilterName->GetValue());
@@ -2068,15 +2257,27 @@ EStatusCodeAndIByteReader PDFParser::CreateFilterForStream(charta::IByteReader *
 
 charta::IByteReader *PDFParser::StartReadingFromStream(const std::shared_ptr<charta::PDFStreamInput> &inStream)
 {
-    charta::IByteReader *result = CreateInputStreamReader(inStream);
+    return StartReadingFromStream(inStream, mReadContext);
+}
+
+charta::IByteReader *PDFParser::StartReadingFromStream(const std::shared_ptr<charta::PDFStreamInput> &inStream,
+                                                       PDFParserReadContext &ioContext)
+{
+    charta::IByteReader *result = CreateInputStreamReader(inStream, ioContext);
     if (result != nullptr)
-        MovePositionInStream(inStream->GetStreamContentStart());
+        MovePositionInStream(inStream->GetStreamContentStart(), ioContext);
     return result;
 }
 
 PDFObjectParser *PDFParser::StartReadingObjectsFromStream(std::shared_ptr<charta::PDFStreamInput> inStream)
 {
-    charta::IByteReader *readStream = StartReadingFromStream(std::move(inStream));
+    return StartReadingObjectsFromStream(std::move(inStream), mReadContext);
+}
+
+PDFObjectParser *PDFParser::StartReadingObjectsFromStream(std::shared_ptr<charta::PDFStreamInput> inStream,
+                                                          PDFParserReadContext &ioContext)
+{
+    charta::IByteReader *readStream = StartReadingFromStream(inStream, ioContext);
     if (readStream == nullptr)
         return nullptr;
 
@@ -2085,6 +2286,7 @@ PDFObjectParser *PDFParser::StartReadingObjectsFromStream(std::shared_ptr<charta
     objectsParser->SetReadStream(source, source, true);
     // Not setting decryption filter cause shuoldnt decrypt at lower level. if at all - the stream is encrypted already
     objectsParser->SetParserExtender(mParserExtender);
+    objectsParser->SetArena(ioContext.mObjectParser->GetArena());
 
     return objectsParser;
 }
@@ -2098,12 +2300,19 @@ PDFObjectParser *PDFParser::StartReadingObjectsFromStreams(std::shared_ptr<chart
     objectsParser->SetReadStream(source, source, true);
     // Not setting decryption filter cause shuoldnt decrypt at lower level. if at all - the stream is encrypted already
     objectsParser->SetParserExtender(mParserExtender);
+    objectsParser->SetArena(mObjectParser.GetArena());
 
     return objectsParser;
 }
 
 charta::IByteReader *PDFParser::CreateInputStreamReaderForPlainCopying(
     const std::shared_ptr<charta::PDFStreamInput> &inStream)
+{
+    return CreateInputStreamReaderForPlainCopying(inStream, mReadContext);
+}
+
+charta::IByteReader *PDFParser::CreateInputStreamReaderForPlainCopying(
+    const std::shared_ptr<charta::PDFStreamInput> &inStream, PDFParserReadContext &ioContext)
 {
     std::shared_ptr<charta::PDFDictionary> streamDictionary(inStream->QueryStreamDictionary());
     charta::IByteReader *result = nullptr;
@@ -2112,7 +2321,7 @@ charta::IByteReader *PDFParser::CreateInputStreamReaderForPlainCopying(
     do
     {
         // setup stream according to length and possible filter
-        PDFObjectCastPtr<PDFInteger> lengthObject(QueryDictionaryObject(streamDictionary, "Length"));
+        PDFObjectCastPtr<PDFInteger> lengthObject(QueryDictionaryObject(streamDictionary, ePDFNameLength, ioContext));
         if (!lengthObject)
         {
             TRACE_LOG("PDFParser::CreateInputStreamReaderForPlainCopying, stream does not have length, failing");
@@ -2120,7 +2329,7 @@ charta::IByteReader *PDFParser::CreateInputStreamReaderForPlainCopying(
             break;
         }
 
-        result = new InputLimitedStream(mStream, lengthObject->GetValue(), false);
+        result = new InputLimitedStream(ioContext.mStream, lengthObject->GetValue(), false);
 
         result = WrapWithDecryptionFilter(inStream, result);
 
@@ -2137,12 +2346,242 @@ charta::IByteReader *PDFParser::CreateInputStreamReaderForPlainCopying(
 charta::IByteReader *PDFParser::StartReadingFromStreamForPlainCopying(
     const std::shared_ptr<charta::PDFStreamInput> &inStream)
 {
-    charta::IByteReader *result = CreateInputStreamReaderForPlainCopying(inStream);
+    return StartReadingFromStreamForPlainCopying(inStream, mReadContext);
+}
+
+charta::IByteReader *PDFParser::StartReadingFromStreamForPlainCopying(
+    const std::shared_ptr<charta::PDFStreamInput> &inStream, PDFParserReadContext &ioContext)
+{
+    charta::IByteReader *result = CreateInputStreamReaderForPlainCopying(inStream, ioContext);
     if (result != nullptr)
-        MovePositionInStream(inStream->GetStreamContentStart());
+        MovePositionInStream(inStream->GetStreamContentStart(), ioContext);
     return result;
 }
 
+// blocks in which encoded data is read, and decoded data grows
+static const size_t scDecodeBlockSize = 64 * 1024;
+// without /DL, flate is assumed to compress content this much, to size the buffer up front
+static const long long scEstimatedCompressionRatio = 4;
+// don't trust declared sizes beyond this for preallocation. larger streams still decode, growing as they go
+static const long long scMaxPreallocatedSize = 256 * 1024 * 1024;
+// pooled buffers kept by the parser
+static const size_t scMaxPooledBuffers = 8;
+static const size_t scMaxPooledBufferCapacity = 64 * 1024 * 1024;
+
+EStatusCode PDFParser::DecodeStreamToBuffer(const std::shared_ptr<charta::PDFStreamInput> &inStream,
+                                            std::vector<uint8_t> &ioBuffer)
+{
+    return DecodeStreamToBuffer(inStream, ioBuffer, mReadContext);
+}
+
+EStatusCode PDFParser::DecodeStreamToBuffer(const std::shared_ptr<charta::PDFStreamInput> &inStream,
+                                            std::vector<uint8_t> &ioBuffer, PDFParserReadContext &ioContext)
+{
+    std::shared_ptr<charta::PDFDictionary> streamDictionary(inStream->QueryStreamDictionary());
+
+    PDFObjectCastPtr<PDFInteger> lengthObject(QueryDictionaryObject(streamDictionary, ePDFNameLength, ioContext));
+    if (!lengthObject)
+    {
+        TRACE_LOG("PDFParser::DecodeStreamToBuffer, stream does not have length, failing");
+        return charta::eFailure;
+    }
+
+    // find a lone flate filter, and its parameters
+    std::shared_ptr<charta::PDFObject> filterObject(QueryDictionaryObject(streamDictionary, ePDFNameFilter, ioContext));
+    std::shared_ptr<charta::PDFObject> decodeParamsObject(
+        QueryDictionaryObject(streamDictionary, ePDFNameDecodeParms, ioContext));
+    PDFObjectCastPtr<charta::PDFName> filterName(filterObject);
+    PDFObjectCastPtr<charta::PDFDictionary> decodeParams(decodeParamsObject);
+    PDFObjectCastPtr<charta::PDFArray> filterArray(filterObject);
+    if (!!filterArray && filterArray->GetLength() == 1)
+    {
+        filterName = filterArray->QueryObject(0);
+        PDFObjectCastPtr<charta::PDFArray> decodeParamsArray(decodeParamsObject);
+        decodeParams = !decodeParamsArray ? nullptr : QueryArrayObject(decodeParamsArray, 0, ioContext);
+    }
+    bool isFlate = !!filterName && filterName->GetValue() == "FlateDecode";
+
+    // size up front. /DL is only a hint, so the buffer still grows (or shrinks) to the actual size
+    long long expectedSize = lengthObject->GetValue();
+    PDFObjectCastPtr<PDFInteger> decodedLength(QueryDictionaryObject(streamDictionary, ePDFNameDL, ioContext));
+    if (!!decodedLength)
+        expectedSize = decodedLength->GetValue();
+    else if (!!filterObject)
+        expectedSize *= scEstimatedCompressionRatio;
+    ioBuffer.clear();
+    ioBuffer.resize((size_t)std::max(std::min(expectedSize, scMaxPreallocatedSize), (long long)scDecodeBlockSize));
+
+    if (isFlate && !IsEncrypted())
+    {
+        EStatusCode status = InflateStreamToBuffer(inStream, lengthObject->GetValue(), ioBuffer, ioContext);
+        if (status != charta::eSuccess || !decodeParams)
+            return status;
+        return ApplyPredictorToBuffer(decodeParams, ioBuffer, ioContext);
+    }
+
+    charta::IByteReader *streamReader = StartReadingFromStream(inStream, ioContext);
+    if (streamReader == nullptr)
+    {
+        ioBuffer.clear();
+        return charta::eFailure;
+    }
+
+    size_t decodedSize = 0;
+    while (streamReader->NotEnded())
+    {
+        if (ioBuffer.size() - decodedSize < scDecodeBlockSize)
+            ioBuffer.resize(std::max(ioBuffer.size() * 2, decodedSize + scDecodeBlockSize));
+        size_t readBytes = streamReader->Read(ioBuffer.data() + decodedSize, ioBuffer.size() - decodedSize);
+        if (readBytes == 0)
+            break;
+        decodedSize += readBytes;
+    }
+    delete streamReader;
+    ioBuffer.resize(decodedSize);
+    return charta::eSuccess;
+}
+
+EStatusCode PDFParser::InflateStreamToBuffer(const std::shared_ptr<charta::PDFStreamInput> &inStream,
+                                             long long inLength, std::vector<uint8_t> &ioBuffer,
+                                             PDFParserReadContext &ioContext)
+{
+    z_stream zStream;
+    memset(&zStream, 0, sizeof(zStream));
+    int inflateResult = inflateInit(&zStream);
+    if (inflateResult != Z_OK)
+    {
+        TRACE_LOG1("PDFParser::InflateStreamToBuffer, Unexpected failure in initializating flate library. status "
+                   "code = %d",
+                   inflateResult);
+        ioBuffer.clear();
+        return charta::eFailure;
+    }
+
+    std::vector<uint8_t> input = AcquireStreamBuffer();
+    input.resize(scDecodeBlockSize);
+    MovePositionInStream(inStream->GetStreamContentStart(), ioContext);
+
+    long long remaining = inLength;
+    size_t decodedSize = 0;
+    while (inflateResult != Z_STREAM_END)
+    {
+        if (zStream.avail_in == 0)
+        {
+            size_t readBytes = 0;
+            if (remaining > 0)
+                readBytes = ioContext.mStream->Read(input.data(), (size_t)std::min<long long>(remaining, input.size()));
+            if (readBytes == 0)
+                break; // a belated end, take what's there
+            remaining -= readBytes;
+            zStream.next_in = input.data();
+            zStream.avail_in = (uInt)readBytes;
+        }
+        if (decodedSize == ioBuffer.size())
+            ioBuffer.resize(ioBuffer.size() * 2);
+        zStream.next_out = ioBuffer.data() + decodedSize;
+        zStream.avail_out = (uInt)std::min(ioBuffer.size() - decodedSize, (size_t)UINT32_MAX);
+
+        inflateResult = inflate(&zStream, Z_NO_FLUSH);
+        decodedSize = (size_t)(zStream.next_out - ioBuffer.data());
+        if (inflateResult != Z_OK && inflateResult != Z_STREAM_END && inflateResult != Z_BUF_ERROR)
+        {
+            // like InputFlateDecodeStream, keep what was decoded till the error
+            TRACE_LOG1("PDFParser::InflateStreamToBuffer, failed to read zlib information. returned error code = %d",
+                       inflateResult);
+            break;
+        }
+    }
+
+    inflateEnd(&zStream);
+    ReleaseStreamBuffer(std::move(input));
+    ioBuffer.resize(decodedSize);
+    return charta::eSuccess;
+}
+
+EStatusCode PDFParser::ApplyPredictorToBuffer(const std::shared_ptr<charta::PDFDictionary> &inDecodeParams,
+                                              std::vector<uint8_t> &ioBuffer, PDFParserReadContext &ioContext)
+{
+    // same parameters as CreateFilterForStream, undone in place on the whole buffer
+    PDFObjectCastPtr<PDFInteger> predictor(QueryDictionaryObject(inDecodeParams, ePDFNamePredictor, ioContext));
+    if (!predictor || predictor->GetValue() == 1)
+        return charta::eSuccess;
+
+    PDFObjectCastPtr<PDFInteger> columns(QueryDictionaryObject(inDecodeParams, ePDFNameColumns, ioContext));
+    PDFObjectCastPtr<PDFInteger> colors(QueryDictionaryObject(inDecodeParams, ePDFNameColors, ioContext));
+    PDFObjectCastPtr<PDFInteger> bitsPerComponent(
+        QueryDictionaryObject(inDecodeParams, ePDFNameBitsPerComponent, ioContext));
+    size_t columnsValue = columns != nullptr ? (size_t)columns->GetValue() : 1;
+    size_t colorsValue = colors != nullptr ? (size_t)colors->GetValue() : 1;
+    size_t bitsPerComponentValue = bitsPerComponent != nullptr ? (size_t)bitsPerComponent->GetValue() : 8;
+    size_t rowSize = (columnsValue * colorsValue * bitsPerComponentValue + 7) / 8;
+    if (rowSize == 0)
+    {
+        TRACE_LOG("PDFParser::ApplyPredictorToBuffer, empty predictor rows, failing");
+        return charta::eFailure;
+    }
+
+    switch (predictor->GetValue())
+    {
+    case 2: {
+        size_t rowsCount = ioBuffer.size() / rowSize;
+        for (size_t i = 0; i < rowsCount; ++i)
+            TIFFUndifferenceRow(ioBuffer.data() + i * rowSize, columnsValue, colorsValue,
+                                (uint8_t)bitsPerComponentValue);
+        ioBuffer.resize(rowsCount * rowSize);
+        return charta::eSuccess;
+    }
+    case 10:
+    case 11:
+    case 12:
+    case 13:
+    case 14:
+    case 15: {
+        // rows come with a tag byte. decoded rows are moved back over the tags as they go, and each is the prior row
+        // of the next
+        size_t bytesPerPixel = std::max(colorsValue * bitsPerComponentValue / 8, (size_t)1);
+        size_t rowsCount = ioBuffer.size() / (rowSize + 1);
+        std::vector<uint8_t> zeroRow(rowSize, 0);
+        uint8_t *data = ioBuffer.data();
+        for (size_t i = 0; i < rowsCount; ++i)
+        {
+            uint8_t filterType = data[i * (rowSize + 1)];
+            uint8_t *row = data + i * rowSize;
+            memmove(row, data + i * (rowSize + 1) + 1, rowSize);
+            if (!PNGUnfilterRow(filterType, row, i == 0 ? zeroRow.data() : row - rowSize, rowSize, bytesPerPixel))
+                TRACE_LOG1("PDFParser::ApplyPredictorToBuffer, unknown filter type %d. passing row as is",
+                           filterType);
+        }
+        ioBuffer.resize(rowsCount * rowSize);
+        return charta::eSuccess;
+    }
+    default:
+        TRACE_LOG("PDFParser::ApplyPredictorToBuffer, supporting only predictor of types 1,2,10,11,12,13,14,15, "
+                  "failing");
+        return charta::eFailure;
+    }
+}
+
+std::vector<uint8_t> PDFParser::AcquireStreamBuffer()
+{
+    std::lock_guard<std::mutex> lock(mStreamBufferPoolLock);
+    if (mStreamBufferPool.empty())
+        return std::vector<uint8_t>();
+    std::vector<uint8_t> result = std::move(mStreamBufferPool.back());
+    mStreamBufferPool.pop_back();
+    return result;
+}
+
+void PDFParser::ReleaseStreamBuffer(std::vector<uint8_t> inBuffer)
+{
+    // very large buffers are let go, so a single huge stream doesn't pin its memory
+    if (inBuffer.capacity() == 0 || inBuffer.capacity() > scMaxPooledBufferCapacity)
+        return;
+    inBuffer.clear();
+    std::lock_guard<std::mutex> lock(mStreamBufferPoolLock);
+    if (mStreamBufferPool.size() < scMaxPooledBuffers)
+        mStreamBufferPool.push_back(std::move(inBuffer));
+}
+
 EStatusCode PDFParser::StartStateFileParsing(charta::IByteReaderWithPosition *inSourceStream)
 {
     EStatusCode status;
@@ -2150,6 +2589,7 @@ EStatusCode PDFParser::StartStateFileParsing(charta::IByteReaderWithPosition *in
     ResetParser();
 
     mStream = inSourceStream;
+    mReadContext.mStream = mStream;
     mCurrentPositionProvider.Assign(mStream);
     mObjectParser.SetReadStream(inSourceStream, &mCurrentPositionProvider);
 
@@ -2196,12 +2636,12 @@ bool PDFParser::IsEncryptionSupported()
 
 ObjectIDType PDFParser::GetXrefSize() const
 {
-    return mXrefSize;
+    return mXrefTable.GetSize();
 }
 
-XrefEntryInput *PDFParser::GetXrefEntry(ObjectIDType inObjectID)
+XrefEntryInput PDFParser::GetXrefEntry(ObjectIDType inObjectID) const
 {
-    return (inObjectID < mXrefSize) ? mXrefTable + inObjectID : nullptr;
+    return mXrefTable.GetEntry(inObjectID);
 }
 
 long long PDFParser::GetXrefPosition() const
@@ -0,0 +1,167 @@
+/*
+   Source File : PDFParserReader.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "parsing/PDFParserReader.h"
+#include "io/ArrayOfInputStreamsStream.h"
+#include "io/InputStreamSkipperStream.h"
+
+#include <utility>
+
+using namespace charta;
+
+// positional reads over the parser own stream, for when there's no better source. moves the shared position under a
+// lock, so it's only as concurrent as the stream is
+class PDFParserReader::ParserStreamSource : public charta::IPositionalByteReader
+{
+  public:
+    ParserStreamSource(PDFParser *inParser) : mParser(inParser)
+    {
+    }
+
+    size_t ReadAt(long long inPosition, uint8_t *inBuffer, size_t inBufferSize) override
+    {
+        std::lock_guard<std::mutex> lock(mParser->mStreamReadLock);
+        charta::IByteReaderWithPosition *stream = mParser->GetParserStream();
+        if (stream == nullptr)
+            return 0;
+
+        stream->SetPosition(inPosition);
+        size_t readAmount = 0;
+        while (readAmount < inBufferSize && stream->NotEnded())
+        {
+            size_t currentRead = stream->Read(inBuffer + readAmount, inBufferSize - readAmount);
+            if (currentRead == 0)
+                break;
+            readAmount += currentRead;
+        }
+        return readAmount;
+    }
+
+  private:
+    PDFParser *mParser;
+};
+
+PDFParserReader::PDFParserReader(PDFParser *inParser, charta::IPositionalByteReader *inSource)
+    : mParser(inParser),
+      mParserStreamSource(inSource == nullptr ? std::make_unique<ParserStreamSource>(inParser) : nullptr),
+      mStream(inSource != nullptr ? inSource : mParserStreamSource.get())
+{
+    mPositionProvider.Assign(&mStream);
+    mObjectParser.SetReadStream(&mStream, &mPositionProvider);
+    // decrypting strings and notifying the extender happen only in serialized reading
+    mObjectParser.SetDecryptionHelper(&mParser->mDecryptionHelper);
+    mObjectParser.SetParserExtender(mParser->mParserExtender);
+
+    mReadContext.mStream = &mStream;
+    mReadContext.mPositionProvider = &mPositionProvider;
+    mReadContext.mObjectParser = &mObjectParser;
+}
+
+PDFParserReader::~PDFParserReader() = default;
+
+std::unique_lock<std::recursive_mutex> PDFParserReader::LockIfSerialized()
+{
+    // the decryption helper and extender follow the object being parsed, so only one reader may parse at a time
+    if (mParser->IsEncrypted() || mParser->mParserExtender != nullptr)
+        return std::unique_lock<std::recursive_mutex>(mParser->mSerializedReadLock);
+    return std::unique_lock<std::recursive_mutex>();
+}
+
+std::shared_ptr<charta::PDFObject> PDFParserReader::ParseNewObject(ObjectIDType inObjectId)
+{
+    std::unique_lock<std::recursive_mutex> lock = LockIfSerialized();
+    return mParser->ParseNewObject(inObjectId, mReadContext);
+}
+
+std::shared_ptr<charta::PDFObject> PDFParserReader::QueryDictionaryObject(
+    const std::shared_ptr<charta::PDFDictionary> &inDictionary, const std::string &inName)
+{
+    std::unique_lock<std::recursive_mutex> lock = LockIfSerialized();
+    return mParser->QueryDictionaryObject(inDictionary, inName, mReadContext);
+}
+
+std::shared_ptr<charta::PDFObject> PDFParserReader::QueryDictionaryObject(
+    const std::shared_ptr<charta::PDFDictionary> &inDictionary, charta::EPDFWellKnownName inName)
+{
+    std::unique_lock<std::recursive_mutex> lock = LockIfSerialized();
+    return mParser->QueryDictionaryObject(inDictionary, inName, mReadContext);
+}
+
+std::shared_ptr<charta::PDFObject> PDFParserReader::QueryArrayObject(const std::shared_ptr<charta::PDFArray> &inArray,
+                                                                     unsigned long inIndex)
+{
+    std::unique_lock<std::recursive_mutex> lock = LockIfSerialized();
+    return mParser->QueryArrayObject(inArray, inIndex, mReadContext);
+}
+
+std::shared_ptr<charta::PDFDictionary> PDFParserReader::ParsePage(unsigned long inPageIndex)
+{
+    std::unique_lock<std::recursive_mutex> lock = LockIfSerialized();
+    return mParser->ParsePage(inPageIndex, mReadContext);
+}
+
+charta::IByteReader *PDFParserReader::StartReadingFromStream(const std::shared_ptr<charta::PDFStreamInput> &inStream)
+{
+    std::unique_lock<std::recursive_mutex> lock = LockIfSerialized();
+    return mParser->StartReadingFromStream(inStream, mReadContext);
+}
+
+charta::IByteReader *PDFParserReader::StartReadingFromStreamForPlainCopying(
+    const std::shared_ptr<charta::PDFStreamInput> &inStream)
+{
+    std::unique_lock<std::recursive_mutex> lock = LockIfSerialized();
+    return mParser->StartReadingFromStreamForPlainCopying(inStream, mReadContext);
+}
+
+PDFObjectParser *PDFParserReader::StartReadingObjectsFromStream(std::shared_ptr<charta::PDFStreamInput> inStream)
+{
+    std::unique_lock<std::recursive_mutex> lock = LockIfSerialized();
+    return mParser->StartReadingObjectsFromStream(std::move(inStream), mReadContext);
+}
+
+charta::EStatusCode PDFParserReader::DecodeStreamToBuffer(const std::shared_ptr<charta::PDFStreamInput> &inStream,
+                                                         std::vector<uint8_t> &ioBuffer)
+{
+    std::unique_lock<std::recursive_mutex> lock = LockIfSerialized();
+    return mParser->DecodeStreamToBuffer(inStream, ioBuffer, mReadContext);
+}
+
+PDFObjectParser *PDFParserReader::StartReadingObjectsFromStreams(std::shared_ptr<charta::PDFArray> inArrayOfStreams)
+{
+    charta::IByteReader *readStream = new ArrayOfInputStreamsStream(std::move(inArrayOfStreams), this);
+
+    auto *objectsParser = new PDFObjectParser();
+    auto *source = new InputStreamSkipperStream(readStream);
+    objectsParser->SetReadStream(source, source, true);
+    objectsParser->SetParserExtender(mParser->mParserExtender);
+    objectsParser->SetArena(mObjectParser.GetArena());
+
+    return objectsParser;
+}
+
+void PDFParserReader::SetObjectArena(std::shared_ptr<charta::PDFObjectArena> inArena)
+{
+    mObjectParser.SetArena(std::move(inArena));
+}
+
+PDFParser *PDFParserReader::GetParser()
+{
+    return mParser;
+}
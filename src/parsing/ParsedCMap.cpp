@@ -0,0 +1,343 @@
+/*
+   Source File : ParsedCMap.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "parsing/ParsedCMap.h"
+#include "parsing/ContentStreamReader.h"
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+
+using namespace charta;
+
+ParsedCMap::ParsedCMap()
+{
+    mCodeLengths = 0;
+}
+
+static bool IsString(const ContentStreamOperand &inOperand)
+{
+    return inOperand.mType == eContentStreamOperandHexString || inOperand.mType == eContentStreamOperandLiteralString;
+}
+
+// index of the operand after the one at inIndex, skipping the elements of arrays and dictionaries
+static size_t NextOperand(const ContentStreamOperator &inOperator, size_t inIndex)
+{
+    const ContentStreamOperand &operand = inOperator.mOperands[inIndex];
+    if (operand.mType == eContentStreamOperandArray || operand.mType == eContentStreamOperandDictionary)
+        return inIndex + 1 + operand.mElementsCount;
+    return inIndex + 1;
+}
+
+// codes are big endian numbers of 1 to 4 bytes. false for anything else
+static bool ReadCodeString(const ContentStreamOperand &inOperand, std::string &ioBuffer, uint32_t &outCode,
+                           size_t &outLength)
+{
+    if (!IsString(inOperand))
+        return false;
+    ContentStreamReader::DecodeString(inOperand, ioBuffer);
+    if (ioBuffer.empty() || ioBuffer.size() > 4)
+        return false;
+    outCode = 0;
+    for (char byte : ioBuffer)
+        outCode = (outCode << 8) | (uint8_t)byte;
+    outLength = ioBuffer.size();
+    return true;
+}
+
+// lay the ranges, in the order they were defined, one over the other. what remains is sorted by first code, and has
+// a single range for each code - the last one defined for it
+template <class T> static void ResolveOverlaps(std::vector<T> &ioRanges)
+{
+    std::map<uint32_t, T> resolved;
+    for (const T &range : ioRanges)
+    {
+        // a range that starts earlier keeps its start, and its end if it goes past the new one
+        auto it = resolved.upper_bound(range.mFirstCode);
+        if (it != resolved.begin())
+        {
+            T &previous = std::prev(it)->second;
+            if (previous.mFirstCode < range.mFirstCode && previous.mLastCode >= range.mFirstCode)
+            {
+                if (previous.mLastCode > range.mLastCode)
+                {
+                    T end = previous;
+                    end.mFirstCode = range.mLastCode + 1;
+                    resolved.insert({end.mFirstCode, end});
+                }
+                previous.mLastCode = range.mFirstCode - 1;
+            }
+        }
+
+        // ranges that start within the new one go, save for the part of the last one that goes past it
+        it = resolved.lower_bound(range.mFirstCode);
+        while (it != resolved.end() && it->first <= range.mLastCode)
+        {
+            T covered = it->second;
+            it = resolved.erase(it);
+            if (covered.mLastCode > range.mLastCode)
+            {
+                covered.mFirstCode = range.mLastCode + 1;
+                resolved.insert({covered.mFirstCode, covered});
+                break;
+            }
+        }
+
+        resolved[range.mFirstCode] = range;
+    }
+
+    ioRanges.clear();
+    for (auto &entry : resolved)
+        ioRanges.push_back(entry.second);
+}
+
+EStatusCode ParsedCMap::Parse(const uint8_t *inData, size_t inSize)
+{
+    ContentStreamReader reader;
+    ContentStreamOperator anOperator;
+    std::string low, high, destination;
+    uint32_t lowCode, highCode;
+    size_t lowLength, highLength;
+
+    // the maps are PostScript programs, though their syntax is close enough to content to be read as such. the
+    // entries are the operands of the end* operators
+    reader.Start(inData, inSize);
+    while (reader.Next(anOperator))
+    {
+        const ContentStreamOperand *operands = anOperator.mOperands;
+        size_t count = anOperator.mOperandsCount;
+
+        if (anOperator.mOperator == "endcodespacerange")
+        {
+            for (size_t i = 0; i + 1 < count; i = NextOperand(anOperator, NextOperand(anOperator, i)))
+            {
+                if (ReadCodeString(operands[i], low, lowCode, lowLength) &&
+                    ReadCodeString(operands[i + 1], high, highCode, highLength) && lowLength == highLength)
+                {
+                    mCodespaceRanges.push_back({lowCode, highCode, lowLength});
+                    mCodeLengths |= 1u << lowLength;
+                }
+            }
+        }
+        else if (anOperator.mOperator == "endbfchar")
+        {
+            for (size_t i = 0; i + 1 < count; i = NextOperand(anOperator, NextOperand(anOperator, i)))
+            {
+                if (ReadCodeString(operands[i], low, lowCode, lowLength) && IsString(operands[i + 1]))
+                {
+                    ContentStreamReader::DecodeString(operands[i + 1], destination);
+                    AddUnicodeRange(lowCode, lowCode, destination);
+                }
+            }
+        }
+        else if (anOperator.mOperator == "endbfrange")
+        {
+            size_t i = 0;
+            while (i + 2 < count)
+            {
+                size_t destinationIndex = NextOperand(anOperator, NextOperand(anOperator, i));
+                if (destinationIndex >= count)
+                    break;
+                if (ReadCodeString(operands[i], low, lowCode, lowLength) &&
+                    ReadCodeString(operands[i + 1], high, highCode, highLength) && lowCode <= highCode)
+                {
+                    const ContentStreamOperand &target = operands[destinationIndex];
+                    if (IsString(target))
+                    {
+                        ContentStreamReader::DecodeString(target, destination);
+                        AddUnicodeRange(lowCode, highCode, destination);
+                    }
+                    else if (target.mType == eContentStreamOperandArray)
+                    {
+                        // a value per code
+                        uint32_t code = lowCode;
+                        size_t end = destinationIndex + 1 + target.mElementsCount;
+                        for (size_t j = destinationIndex + 1; j < end && code <= highCode;
+                             j = NextOperand(anOperator, j), ++code)
+                        {
+                            if (!IsString(operands[j]))
+                                continue;
+                            ContentStreamReader::DecodeString(operands[j], destination);
+                            AddUnicodeRange(code, code, destination);
+                        }
+                    }
+                }
+                i = NextOperand(anOperator, destinationIndex);
+            }
+        }
+        else if (anOperator.mOperator == "endcidchar" || anOperator.mOperator == "endcidrange")
+        {
+            bool isRange = anOperator.mOperator == "endcidrange";
+            size_t entrySize = isRange ? 3 : 2;
+            for (size_t i = 0; i + entrySize <= count; i += entrySize)
+            {
+                if (!ReadCodeString(operands[i], low, lowCode, lowLength))
+                    continue;
+                highCode = lowCode;
+                if (isRange && !ReadCodeString(operands[i + 1], high, highCode, highLength))
+                    continue;
+                const ContentStreamOperand &cid = operands[i + entrySize - 1];
+                if (cid.mType == eContentStreamOperandNumber && cid.mNumber >= 0 && lowCode <= highCode)
+                    mCIDRanges.push_back({lowCode, highCode, lowCode, (uint32_t)cid.mNumber});
+            }
+        }
+    }
+
+    // for lookups, with later definitions of a code replacing earlier ones
+    ResolveOverlaps(mUnicodeRanges);
+    ResolveOverlaps(mCIDRanges);
+
+    return mCodespaceRanges.empty() && mUnicodeRanges.empty() && mCIDRanges.empty() ? eFailure : eSuccess;
+}
+
+void ParsedCMap::AddUnicodeRange(uint32_t inFirstCode, uint32_t inLastCode, const std::string &inUTF16BE)
+{
+    auto offset = (uint32_t)mUnicodes.size();
+    for (size_t i = 0; i + 1 < inUTF16BE.size(); i += 2)
+    {
+        uint32_t unit = ((uint8_t)inUTF16BE[i] << 8) | (uint8_t)inUTF16BE[i + 1];
+        if (unit >= 0xD800 && unit <= 0xDBFF && i + 3 < inUTF16BE.size())
+        {
+            uint32_t low = ((uint8_t)inUTF16BE[i + 2] << 8) | (uint8_t)inUTF16BE[i + 3];
+            if (low >= 0xDC00 && low <= 0xDFFF)
+            {
+                unit = 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00);
+                i += 2;
+            }
+        }
+        mUnicodes.push_back(unit);
+    }
+
+    if (mUnicodes.size() == offset) // nothing mapped
+        return;
+    mUnicodeRanges.push_back({inFirstCode, inLastCode, inFirstCode, offset, (uint32_t)(mUnicodes.size() - offset)});
+}
+
+size_t ParsedCMap::ReadCode(const uint8_t *inData, size_t inSize, size_t inDefaultLength, uint32_t &outCode) const
+{
+    size_t length = inDefaultLength;
+    if (mCodeLengths != 0)
+    {
+        // the shortest length, which is also the length of codes that match no range
+        length = 1;
+        while ((mCodeLengths & (1u << length)) == 0)
+            ++length;
+
+        if ((mCodeLengths & ~(1u << length)) != 0)
+        {
+            for (size_t candidate = length; candidate <= 4 && candidate <= inSize; ++candidate)
+            {
+                if ((mCodeLengths & (1u << candidate)) == 0)
+                    continue;
+                uint32_t code = 0;
+                for (size_t i = 0; i < candidate; ++i)
+                    code = (code << 8) | inData[i];
+                for (const CodespaceRange &range : mCodespaceRanges)
+                {
+                    if (range.mLength == candidate && code >= range.mLow && code <= range.mHigh)
+                    {
+                        outCode = code;
+                        return candidate;
+                    }
+                }
+            }
+        }
+    }
+
+    if (length > inSize)
+        length = inSize;
+    outCode = 0;
+    for (size_t i = 0; i < length; ++i)
+        outCode = (outCode << 8) | inData[i];
+    return length;
+}
+
+bool ParsedCMap::AppendUnicode(uint32_t inCode, std::string &ioText) const
+{
+    auto it = std::upper_bound(
+        mUnicodeRanges.begin(), mUnicodeRanges.end(), inCode,
+        [](uint32_t inValue, const UnicodeRange &inRange) { return inValue < inRange.mFirstCode; });
+    if (it == mUnicodeRanges.begin())
+        return false;
+    --it;
+    if (inCode > it->mLastCode)
+        return false;
+
+    for (uint32_t i = 0; i < it->mLength; ++i)
+    {
+        uint32_t codePoint = mUnicodes[it->mOffset + i];
+        if (i + 1 == it->mLength)
+            codePoint += inCode - it->mBaseCode;
+        AppendUTF8(codePoint, ioText);
+    }
+    return true;
+}
+
+bool ParsedCMap::MapToCID(uint32_t inCode, uint32_t &outCID) const
+{
+    auto it = std::upper_bound(mCIDRanges.begin(), mCIDRanges.end(), inCode,
+                               [](uint32_t inValue, const CIDRange &inRange) { return inValue < inRange.mFirstCode; });
+    if (it == mCIDRanges.begin())
+        return false;
+    --it;
+    if (inCode > it->mLastCode)
+        return false;
+    outCID = it->mBaseCID + (inCode - it->mBaseCode);
+    return true;
+}
+
+bool ParsedCMap::HasCodespaceRanges() const
+{
+    return !mCodespaceRanges.empty();
+}
+
+bool ParsedCMap::HasUnicodeMappings() const
+{
+    return !mUnicodeRanges.empty();
+}
+
+void ParsedCMap::AppendUTF8(uint32_t inCodePoint, std::string &ioText)
+{
+    if ((inCodePoint >= 0xD800 && inCodePoint <= 0xDFFF) || inCodePoint > 0x10FFFF)
+        inCodePoint = 0xFFFD;
+
+    if (inCodePoint < 0x80)
+    {
+        ioText.push_back((char)inCodePoint);
+    }
+    else if (inCodePoint < 0x800)
+    {
+        ioText.push_back((char)(0xC0 | (inCodePoint >> 6)));
+        ioText.push_back((char)(0x80 | (inCodePoint & 0x3F)));
+    }
+    else if (inCodePoint < 0x10000)
+    {
+        ioText.push_back((char)(0xE0 | (inCodePoint >> 12)));
+        ioText.push_back((char)(0x80 | ((inCodePoint >> 6) & 0x3F)));
+        ioText.push_back((char)(0x80 | (inCodePoint & 0x3F)));
+    }
+    else
+    {
+        ioText.push_back((char)(0xF0 | (inCodePoint >> 18)));
+        ioText.push_back((char)(0x80 | ((inCodePoint >> 12) & 0x3F)));
+        ioText.push_back((char)(0x80 | ((inCodePoint >> 6) & 0x3F)));
+        ioText.push_back((char)(0x80 | (inCodePoint & 0x3F)));
+    }
+}
@@ -0,0 +1,520 @@
+/*
+   Source File : TextExtractionFont.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "parsing/TextExtractionFont.h"
+#include "Trace.h"
+#include "encoding/PDFDocEncoding.h"
+#include "encoding/StandardEncoding.h"
+#include "encoding/WinAnsiEncoding.h"
+#include "objects/PDFArray.h"
+#include "objects/PDFDictionary.h"
+#include "objects/PDFIndirectObjectReference.h"
+#include "objects/PDFName.h"
+#include "objects/PDFObjectCast.h"
+#include "objects/PDFStreamInput.h"
+#include "objects/helpers/ParsedPrimitiveHelper.h"
+#include "parsing/PDFParserReader.h"
+
+#include <algorithm>
+#include <string.h>
+
+using namespace charta;
+
+// MacRomanEncoding upper half. the lower half is ASCII
+static const uint16_t scMacRomanUpperHalf[128] = {
+    0x00C4, 0x00C5, 0x00C7, 0x00C9, 0x00D1, 0x00D6, 0x00DC, 0x00E1, 0x00E0, 0x00E2, 0x00E4, 0x00E3, 0x00E5,
+    0x00E7, 0x00E9, 0x00E8, 0x00EA, 0x00EB, 0x00ED, 0x00EC, 0x00EE, 0x00EF, 0x00F1, 0x00F3, 0x00F2, 0x00F4,
+    0x00F6, 0x00F5, 0x00FA, 0x00F9, 0x00FB, 0x00FC, 0x2020, 0x00B0, 0x00A2, 0x00A3, 0x00A7, 0x2022, 0x00B6,
+    0x00DF, 0x00AE, 0x00A9, 0x2122, 0x00B4, 0x00A8, 0x2260, 0x00C6, 0x00D8, 0x221E, 0x00B1, 0x2264, 0x2265,
+    0x00A5, 0x00B5, 0x2202, 0x2211, 0x220F, 0x03C0, 0x222B, 0x00AA, 0x00BA, 0x03A9, 0x00E6, 0x00F8, 0x00BF,
+    0x00A1, 0x00AC, 0x221A, 0x0192, 0x2248, 0x2206, 0x00AB, 0x00BB, 0x2026, 0x00A0, 0x00C0, 0x00C3, 0x00D5,
+    0x0152, 0x0153, 0x2013, 0x2014, 0x201C, 0x201D, 0x2018, 0x2019, 0x00F7, 0x25CA, 0x00FF, 0x0178, 0x2044,
+    0x00A4, 0x2039, 0x203A, 0xFB01, 0xFB02, 0x2021, 0x00B7, 0x201A, 0x201E, 0x2030, 0x00C2, 0x00CA, 0x00C1,
+    0x00CB, 0x00C8, 0x00CD, 0x00CE, 0x00CF, 0x00CC, 0x00D3, 0x00D4, 0xF8FF, 0x00D2, 0x00DA, 0x00DB, 0x00D9,
+    0x0131, 0x02C6, 0x02DC, 0x00AF, 0x02D8, 0x02D9, 0x02DA, 0x00B8, 0x02DD, 0x02DB, 0x02C7};
+
+// glyph names found in encodings and fonts that PDFDocEncoding doesn't name
+static const std::pair<const char *, uint32_t> scExtraGlyphNames[] = {
+    {"tilde", 0x02DC},  {"ff", 0xFB00},        {"ffi", 0xFB03},   {"ffl", 0xFB04},
+    {"nbspace", 0x00A0}, {"sfthyphen", 0x00AD}, {"Omega", 0x03A9}, {"pi", 0x03C0},
+    {"mu", 0x00B5},      {"Delta", 0x2206}};
+
+enum EBaseEncoding
+{
+    eBaseEncodingStandard,
+    eBaseEncodingWinAnsi,
+    eBaseEncodingMacRoman,
+    eBaseEncodingPDFDoc,
+    eBaseEncodingCount
+};
+
+struct GlyphTables
+{
+    std::unordered_map<std::string, uint32_t> mGlyphNames;
+    uint32_t mEncodings[eBaseEncodingCount][256];
+
+    GlyphTables()
+    {
+        PDFDocEncoding pdfDocEncoding;
+        for (int i = 0; i < 256; ++i)
+        {
+            const char *glyphName = pdfDocEncoding.GetEncodedGlyphName((uint8_t)i);
+            if (strcmp(glyphName, ".notdef") != 0)
+                mGlyphNames.emplace(glyphName, pdfDocEncoding.Decode((uint8_t)i));
+        }
+        for (const auto &extra : scExtraGlyphNames)
+            mGlyphNames.emplace(extra.first, extra.second);
+
+        StandardEncoding standardEncoding;
+        WinAnsiEncoding winAnsiEncoding;
+        for (int i = 0; i < 256; ++i)
+        {
+            mEncodings[eBaseEncodingStandard][i] = Lookup(standardEncoding.GetEncodedGlyphName((uint8_t)i));
+            mEncodings[eBaseEncodingWinAnsi][i] = Lookup(winAnsiEncoding.GetEncodedGlyphName((uint8_t)i));
+            mEncodings[eBaseEncodingMacRoman][i] = i < 128 ? (i < 32 ? 0 : i) : scMacRomanUpperHalf[i - 128];
+            mEncodings[eBaseEncodingPDFDoc][i] = Lookup(pdfDocEncoding.GetEncodedGlyphName((uint8_t)i));
+        }
+    }
+
+    uint32_t Lookup(const std::string &inGlyphName) const
+    {
+        auto it = mGlyphNames.find(inGlyphName);
+        return it == mGlyphNames.end() ? 0 : it->second;
+    }
+};
+
+static const GlyphTables &GetGlyphTables()
+{
+    static const GlyphTables scGlyphTables;
+    return scGlyphTables;
+}
+
+static bool ParseHex(const std::string &inText, size_t inStart, size_t inLength, uint32_t &outValue)
+{
+    if (inStart + inLength > inText.size())
+        return false;
+    outValue = 0;
+    for (size_t i = inStart; i < inStart + inLength; ++i)
+    {
+        char character = inText[i];
+        int digit;
+        if (character >= '0' && character <= '9')
+            digit = character - '0';
+        else if (character >= 'A' && character <= 'F')
+            digit = character - 'A' + 10;
+        else
+            return false; // glyph names use uppercase hex
+        outValue = outValue * 16 + digit;
+    }
+    return true;
+}
+
+uint32_t TextExtractionFont::GlyphNameToUnicode(const std::string &inGlyphName)
+{
+    // suffixes, as in a.sc, name variants of the same character
+    size_t dot = inGlyphName.find('.');
+    if (dot != std::string::npos && dot > 0)
+        return GlyphNameToUnicode(inGlyphName.substr(0, dot));
+
+    uint32_t result = GetGlyphTables().Lookup(inGlyphName);
+    if (result != 0)
+        return result;
+
+    // uniXXXX[XXXX...] - taking the first character - and uXXXX to uXXXXXX
+    if (inGlyphName.size() >= 7 && inGlyphName.compare(0, 3, "uni") == 0 && ParseHex(inGlyphName, 3, 4, result))
+        return result;
+    if (inGlyphName.size() >= 5 && inGlyphName.size() <= 7 && inGlyphName[0] == 'u' &&
+        ParseHex(inGlyphName, 1, inGlyphName.size() - 1, result))
+        return result;
+    return 0;
+}
+
+static std::shared_ptr<const ParsedCMap> ReadCMap(PDFParserReader *inReader,
+                                                  const std::shared_ptr<PDFObject> &inCMapObject)
+{
+    if (!inCMapObject || inCMapObject->GetType() != PDFObject::ePDFObjectStream)
+        return nullptr;
+
+    std::vector<uint8_t> buffer = inReader->GetParser()->AcquireStreamBuffer();
+    std::shared_ptr<ParsedCMap> cMap;
+    if (inReader->DecodeStreamToBuffer(std::static_pointer_cast<charta::PDFStreamInput>(inCMapObject), buffer) ==
+        eSuccess)
+    {
+        cMap = std::make_shared<ParsedCMap>();
+        if (cMap->Parse(buffer.data(), buffer.size()) != eSuccess)
+        {
+            TRACE_LOG("TextExtractionFont, failed to read a CMap");
+            cMap.reset();
+        }
+    }
+    else
+    {
+        TRACE_LOG("TextExtractionFont, failed to decode a CMap stream");
+    }
+    inReader->GetParser()->ReleaseStreamBuffer(std::move(buffer));
+    return cMap;
+}
+
+static std::string NameValue(const std::shared_ptr<PDFObject> &inObject)
+{
+    PDFObjectCastPtr<charta::PDFName> name(inObject);
+    return !name ? std::string() : name->GetValue();
+}
+
+static double NumberValue(const std::shared_ptr<PDFObject> &inObject, double inDefault)
+{
+    if (!inObject)
+        return inDefault;
+    ParsedPrimitiveHelper helper(inObject);
+    return helper.IsNumber() ? helper.GetAsDouble() : inDefault;
+}
+
+TextExtractionFont::TextExtractionFont()
+{
+    mIsComposite = false;
+    mIsVertical = false;
+    mCodesAreUnicode = false;
+    mDefaultWidth = 1;
+    for (int i = 0; i < 256; ++i)
+    {
+        mUnicodes[i] = 0;
+        mWidths[i] = 0.5;
+    }
+}
+
+EStatusCode TextExtractionFont::Read(PDFParserReader *inReader, const std::shared_ptr<PDFDictionary> &inFont,
+                                     TextExtractionCache *inCache)
+{
+    mBaseFont = NameValue(inReader->QueryDictionaryObject(inFont, ePDFNameBaseFont));
+    std::string subtype = NameValue(inReader->QueryDictionaryObject(inFont, ePDFNameSubtype));
+
+    std::shared_ptr<PDFObject> toUnicode = inFont->QueryDirectObject(ePDFNameToUnicode);
+    if (toUnicode)
+        mToUnicode = inCache != nullptr
+                         ? inCache->GetCMap(inReader, toUnicode)
+                         : ReadCMap(inReader, inReader->QueryDictionaryObject(inFont, ePDFNameToUnicode));
+
+    if (subtype == "Type0")
+        return ReadCompositeFont(inReader, inFont, inCache);
+
+    ReadSimpleEncoding(inReader, inFont, subtype);
+
+    // type 3 glyph space is defined by the font matrix, the others are 1/1000 of text space
+    double scale = 0.001;
+    if (subtype == "Type3")
+    {
+        PDFObjectCastPtr<PDFArray> fontMatrix(inReader->QueryDictionaryObject(inFont, "FontMatrix"));
+        if (!!fontMatrix && fontMatrix->GetLength() == 6)
+            scale = NumberValue(inReader->QueryArrayObject(fontMatrix, 0), scale);
+    }
+    ReadSimpleWidths(inReader, inFont, scale);
+    return eSuccess;
+}
+
+void TextExtractionFont::ReadSimpleEncoding(PDFParserReader *inReader, const std::shared_ptr<PDFDictionary> &inFont,
+                                            const std::string &inSubtype)
+{
+    std::shared_ptr<PDFObject> encoding = inReader->QueryDictionaryObject(inFont, ePDFNameEncoding);
+    std::shared_ptr<PDFDictionary> encodingDictionary;
+    std::string baseEncodingName;
+    if (encoding && encoding->GetType() == PDFObject::ePDFObjectDictionary)
+    {
+        encodingDictionary = std::static_pointer_cast<PDFDictionary>(encoding);
+        baseEncodingName = NameValue(inReader->QueryDictionaryObject(encodingDictionary, "BaseEncoding"));
+    }
+    else
+    {
+        baseEncodingName = NameValue(encoding);
+    }
+
+    // type 3 fonts have no built in encoding. the others are taken as standard, which is right for the common latin
+    // text fonts, and at least gets ASCII right for the rest
+    EBaseEncoding baseEncoding = eBaseEncodingStandard;
+    if (baseEncodingName == "WinAnsiEncoding")
+        baseEncoding = eBaseEncodingWinAnsi;
+    else if (baseEncodingName == "MacRomanEncoding")
+        baseEncoding = eBaseEncodingMacRoman;
+    else if (baseEncodingName == "PDFDocEncoding")
+        baseEncoding = eBaseEncodingPDFDoc;
+    if (inSubtype != "Type3" || !baseEncodingName.empty())
+        memcpy(mUnicodes, GetGlyphTables().mEncodings[baseEncoding], sizeof(mUnicodes));
+
+    if (!encodingDictionary)
+        return;
+    PDFObjectCastPtr<PDFArray> differences(inReader->QueryDictionaryObject(encodingDictionary, "Differences"));
+    if (!differences)
+        return;
+
+    // codes followed by the names of the glyphs from that code on
+    unsigned long code = 0;
+    for (unsigned long i = 0; i < differences->GetLength(); ++i)
+    {
+        std::shared_ptr<PDFObject> item = inReader->QueryArrayObject(differences, i);
+        if (!item)
+            continue;
+        if (item->GetType() == PDFObject::ePDFObjectName)
+        {
+            if (code < 256)
+                mUnicodes[code] = GlyphNameToUnicode(std::static_pointer_cast<charta::PDFName>(item)->GetValue());
+            ++code;
+        }
+        else
+        {
+            code = (unsigned long)NumberValue(item, (double)code);
+        }
+    }
+}
+
+void TextExtractionFont::ReadSimpleWidths(PDFParserReader *inReader, const std::shared_ptr<PDFDictionary> &inFont,
+                                          double inScale)
+{
+    PDFObjectCastPtr<PDFArray> widths(inReader->QueryDictionaryObject(inFont, "Widths"));
+    if (!widths)
+        return; // keep the default
+
+    double missingWidth = 0;
+    PDFObjectCastPtr<PDFDictionary> fontDescriptor(inReader->QueryDictionaryObject(inFont, "FontDescriptor"));
+    if (!!fontDescriptor)
+        missingWidth = NumberValue(inReader->QueryDictionaryObject(fontDescriptor, "MissingWidth"), 0);
+    for (double &width : mWidths)
+        width = missingWidth * inScale;
+
+    auto firstChar = (long long)NumberValue(inReader->QueryDictionaryObject(inFont, "FirstChar"), 0);
+    for (unsigned long i = 0; i < widths->GetLength(); ++i)
+    {
+        long long code = firstChar + i;
+        if (code < 0 || code > 255)
+            continue;
+        mWidths[code] = NumberValue(inReader->QueryArrayObject(widths, i), missingWidth) * inScale;
+    }
+}
+
+EStatusCode TextExtractionFont::ReadCompositeFont(PDFParserReader *inReader,
+                                                  const std::shared_ptr<PDFDictionary> &inFont,
+                                                  TextExtractionCache *inCache)
+{
+    mIsComposite = true;
+
+    std::shared_ptr<PDFObject> encoding = inFont->QueryDirectObject(ePDFNameEncoding);
+    std::shared_ptr<PDFObject> resolvedEncoding = inReader->QueryDictionaryObject(inFont, ePDFNameEncoding);
+    if (resolvedEncoding && resolvedEncoding->GetType() == PDFObject::ePDFObjectStream)
+    {
+        mEncodingCMap =
+            inCache != nullptr ? inCache->GetCMap(inReader, encoding) : ReadCMap(inReader, resolvedEncoding);
+        std::shared_ptr<PDFDictionary> cMapDictionary =
+            std::static_pointer_cast<charta::PDFStreamInput>(resolvedEncoding)->QueryStreamDictionary();
+        mIsVertical = NumberValue(inReader->QueryDictionaryObject(cMapDictionary, "WMode"), 0) == 1;
+    }
+    else
+    {
+        // predefined CMaps. the identity ones and the unicode ones are 2 bytes, the others are assumed to be
+        std::string cMapName = NameValue(resolvedEncoding);
+        mIsVertical = cMapName.size() > 2 && cMapName.compare(cMapName.size() - 2, 2, "-V") == 0;
+        mCodesAreUnicode =
+            cMapName.find("UCS2") != std::string::npos || cMapName.find("UTF16") != std::string::npos;
+    }
+
+    PDFObjectCastPtr<PDFArray> descendantFonts(inReader->QueryDictionaryObject(inFont, "DescendantFonts"));
+    if (!descendantFonts || descendantFonts->GetLength() == 0)
+    {
+        TRACE_LOG("TextExtractionFont::ReadCompositeFont, composite font with no descendant font");
+        return eFailure;
+    }
+    PDFObjectCastPtr<PDFDictionary> descendantFont(inReader->QueryArrayObject(descendantFonts, 0));
+    if (!descendantFont)
+    {
+        TRACE_LOG("TextExtractionFont::ReadCompositeFont, descendant font is not a dictionary");
+        return eFailure;
+    }
+
+    mDefaultWidth = NumberValue(inReader->QueryDictionaryObject(descendantFont, "DW"), 1000) * 0.001;
+
+    // W lists "c [w1 w2 ...]" and "cfirst clast w" entries
+    PDFObjectCastPtr<PDFArray> widths(inReader->QueryDictionaryObject(descendantFont, ePDFNameW));
+    if (!widths)
+        return eSuccess;
+    unsigned long length = widths->GetLength();
+    for (unsigned long i = 0; i + 1 < length;)
+    {
+        auto firstCID = (uint32_t)NumberValue(inReader->QueryArrayObject(widths, i), 0);
+        std::shared_ptr<PDFObject> next = inReader->QueryArrayObject(widths, i + 1);
+        if (next && next->GetType() == PDFObject::ePDFObjectArray)
+        {
+            PDFObjectCastPtr<PDFArray> cidWidths(next);
+            for (unsigned long j = 0; j < cidWidths->GetLength(); ++j)
+            {
+                double width = NumberValue(inReader->QueryArrayObject(cidWidths, j), 1000) * 0.001;
+                mWidthRanges.push_back({firstCID + (uint32_t)j, firstCID + (uint32_t)j, width});
+            }
+            i += 2;
+        }
+        else
+        {
+            if (i + 2 >= length)
+                break;
+            auto lastCID = (uint32_t)NumberValue(next, 0);
+            double width = NumberValue(inReader->QueryArrayObject(widths, i + 2), 1000) * 0.001;
+            if (firstCID <= lastCID)
+                mWidthRanges.push_back({firstCID, lastCID, width});
+            i += 3;
+        }
+    }
+    std::stable_sort(mWidthRanges.begin(), mWidthRanges.end(), [](const WidthRange &inLeft, const WidthRange &inRight) {
+        return inLeft.mFirstCID < inRight.mFirstCID;
+    });
+    return eSuccess;
+}
+
+size_t TextExtractionFont::ReadCompositeCode(const uint8_t *inData, size_t inSize, uint32_t &outCode) const
+{
+    if (mEncodingCMap)
+        return mEncodingCMap->ReadCode(inData, inSize, 2, outCode);
+    if (inSize < 2)
+    {
+        outCode = inData[0];
+        return 1;
+    }
+    outCode = ((uint32_t)inData[0] << 8) | inData[1];
+    return 2;
+}
+
+void TextExtractionFont::AppendUnicode(uint32_t inCode, std::string &ioText) const
+{
+    if (mToUnicode && mToUnicode->AppendUnicode(inCode, ioText))
+        return;
+
+    if (!mIsComposite)
+    {
+        if (mUnicodes[inCode & 0xFF] != 0)
+            ParsedCMap::AppendUTF8(mUnicodes[inCode & 0xFF], ioText);
+    }
+    else
+    {
+        ParsedCMap::AppendUTF8(mCodesAreUnicode ? inCode : 0xFFFD, ioText);
+    }
+}
+
+double TextExtractionFont::GetWidth(uint32_t inCode) const
+{
+    if (!mIsComposite)
+        return mWidths[inCode & 0xFF];
+
+    uint32_t cid = inCode;
+    if (mEncodingCMap)
+        mEncodingCMap->MapToCID(inCode, cid);
+    auto it = std::upper_bound(mWidthRanges.begin(), mWidthRanges.end(), cid,
+                               [](uint32_t inValue, const WidthRange &inRange) { return inValue < inRange.mFirstCID; });
+    if (it == mWidthRanges.begin())
+        return mDefaultWidth;
+    --it;
+    return cid <= it->mLastCID ? it->mWidth : mDefaultWidth;
+}
+
+bool TextExtractionFont::IsComposite() const
+{
+    return mIsComposite;
+}
+
+bool TextExtractionFont::IsVertical() const
+{
+    return mIsVertical;
+}
+
+const std::string &TextExtractionFont::GetBaseFont() const
+{
+    return mBaseFont;
+}
+
+std::shared_ptr<const TextExtractionFont> TextExtractionCache::GetFont(PDFParserReader *inReader,
+                                                                       const std::shared_ptr<PDFObject> &inFontEntry)
+{
+    if (!inFontEntry)
+        return nullptr;
+
+    ObjectIDType objectID = 0;
+    std::shared_ptr<PDFObject> fontObject = inFontEntry;
+    if (inFontEntry->GetType() == PDFObject::ePDFObjectIndirectObjectReference)
+    {
+        objectID = std::static_pointer_cast<PDFIndirectObjectReference>(inFontEntry)->mObjectID;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            auto it = mFonts.find(objectID);
+            if (it != mFonts.end())
+                return it->second;
+        }
+        fontObject = inReader->ParseNewObject(objectID);
+    }
+
+    // read outside of the lock. threads that miss together read the font more than once, and keep the first
+    std::shared_ptr<TextExtractionFont> font;
+    if (fontObject && fontObject->GetType() == PDFObject::ePDFObjectDictionary)
+    {
+        font = std::make_shared<TextExtractionFont>();
+        if (font->Read(inReader, std::static_pointer_cast<PDFDictionary>(fontObject), this) != eSuccess)
+            font.reset();
+    }
+    if (!font)
+        TRACE_LOG1("TextExtractionCache::GetFont, failed to read font %ld", objectID);
+
+    if (objectID == 0)
+        return font;
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mFonts.emplace(objectID, font).first->second;
+}
+
+std::shared_ptr<const ParsedCMap> TextExtractionCache::GetCMap(PDFParserReader *inReader,
+                                                               const std::shared_ptr<PDFObject> &inCMapEntry)
+{
+    if (!inCMapEntry)
+        return nullptr;
+    if (inCMapEntry->GetType() != PDFObject::ePDFObjectIndirectObjectReference)
+        return ReadCMap(inReader, inCMapEntry);
+
+    ObjectIDType objectID = std::static_pointer_cast<PDFIndirectObjectReference>(inCMapEntry)->mObjectID;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = mCMaps.find(objectID);
+        if (it != mCMaps.end())
+            return it->second;
+    }
+
+    std::shared_ptr<const ParsedCMap> cMap = ReadCMap(inReader, inReader->ParseNewObject(objectID));
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mCMaps.emplace(objectID, cMap).first->second;
+}
+
+size_t TextExtractionCache::GetFontsCount()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mFonts.size();
+}
+
+size_t TextExtractionCache::GetCMapsCount()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mCMaps.size();
+}
+
+void TextExtractionCache::Reset()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mFonts.clear();
+    mCMaps.clear();
+}
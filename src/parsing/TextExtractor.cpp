@@ -0,0 +1,623 @@
+/*
+   Source File : TextExtractor.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "parsing/TextExtractor.h"
+#include "Trace.h"
+#include "objects/PDFArray.h"
+#include "objects/PDFDictionary.h"
+#include "objects/PDFIndirectObjectReference.h"
+#include "objects/PDFName.h"
+#include "objects/PDFObjectCast.h"
+#include "objects/PDFStreamInput.h"
+#include "objects/helpers/ParsedPrimitiveHelper.h"
+#include "parsing/PDFParser.h"
+#include "parsing/PDFParserReader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <math.h>
+#include <thread>
+
+using namespace charta;
+
+static const size_t scMaxFormsDepth = 16;
+
+static void SetIdentity(double *outMatrix)
+{
+    outMatrix[0] = outMatrix[3] = 1;
+    outMatrix[1] = outMatrix[2] = outMatrix[4] = outMatrix[5] = 0;
+}
+
+// ioMatrix = inMatrix x ioMatrix
+static void PreMultiply(const double *inMatrix, double *ioMatrix)
+{
+    double result[6];
+    result[0] = inMatrix[0] * ioMatrix[0] + inMatrix[1] * ioMatrix[2];
+    result[1] = inMatrix[0] * ioMatrix[1] + inMatrix[1] * ioMatrix[3];
+    result[2] = inMatrix[2] * ioMatrix[0] + inMatrix[3] * ioMatrix[2];
+    result[3] = inMatrix[2] * ioMatrix[1] + inMatrix[3] * ioMatrix[3];
+    result[4] = inMatrix[4] * ioMatrix[0] + inMatrix[5] * ioMatrix[2] + ioMatrix[4];
+    result[5] = inMatrix[4] * ioMatrix[1] + inMatrix[5] * ioMatrix[3] + ioMatrix[5];
+    std::copy(result, result + 6, ioMatrix);
+}
+
+// ioMatrix = translation(inX, inY) x ioMatrix
+static void Translate(double inX, double inY, double *ioMatrix)
+{
+    ioMatrix[4] += inX * ioMatrix[0] + inY * ioMatrix[2];
+    ioMatrix[5] += inX * ioMatrix[1] + inY * ioMatrix[3];
+}
+
+// the last inCount operands are numbers. operators take their operands from the end of the list
+static bool HasNumbers(const ContentStreamOperator &inOperator, size_t inCount)
+{
+    if (inOperator.mOperandsCount < inCount)
+        return false;
+    for (size_t i = inOperator.mOperandsCount - inCount; i < inOperator.mOperandsCount; ++i)
+        if (inOperator.mOperands[i].mType != eContentStreamOperandNumber)
+            return false;
+    return true;
+}
+
+static double NumberFromEnd(const ContentStreamOperator &inOperator, size_t inIndexFromEnd)
+{
+    return inOperator.mOperands[inOperator.mOperandsCount - inIndexFromEnd].mNumber;
+}
+
+static const ContentStreamOperand *LastOperand(const ContentStreamOperator &inOperator)
+{
+    return inOperator.mOperandsCount == 0 ? nullptr : inOperator.mOperands + inOperator.mOperandsCount - 1;
+}
+
+static bool IsString(const ContentStreamOperand *inOperand)
+{
+    return inOperand != nullptr && (inOperand->mType == eContentStreamOperandLiteralString ||
+                                    inOperand->mType == eContentStreamOperandHexString);
+}
+
+TextExtractor::TextExtractor(PDFParserReader *inReader, TextExtractionCache *inCache)
+{
+    mReader = inReader;
+    if (inCache == nullptr)
+    {
+        mOwnCache = std::make_unique<TextExtractionCache>();
+        inCache = mOwnCache.get();
+    }
+    mCache = inCache;
+    mWordGapThreshold = 0.2;
+    mVisitor = nullptr;
+    mStopped = false;
+    mRunOpen = false;
+    SetIdentity(mTextMatrix);
+    SetIdentity(mTextLineMatrix);
+}
+
+TextExtractor::~TextExtractor() = default;
+
+void TextExtractor::SetWordGapThreshold(double inEms)
+{
+    mWordGapThreshold = inEms;
+}
+
+class TextRunsCollector : public ITextExtractionVisitor
+{
+  public:
+    TextRunsCollector(std::vector<TextRun> &outRuns) : mRuns(outRuns)
+    {
+    }
+
+    bool OnTextRun(const TextRun &inRun) override
+    {
+        mRuns.push_back(inRun);
+        return true;
+    }
+
+  private:
+    std::vector<TextRun> &mRuns;
+};
+
+EStatusCode TextExtractor::ExtractPage(unsigned long inPageIndex, std::vector<TextRun> &outRuns)
+{
+    TextRunsCollector collector(outRuns);
+    return ExtractPage(inPageIndex, &collector);
+}
+
+EStatusCode TextExtractor::ExtractPage(unsigned long inPageIndex, ITextExtractionVisitor *inVisitor)
+{
+    std::shared_ptr<PDFDictionary> page = mReader->ParsePage(inPageIndex);
+    if (!page)
+    {
+        TRACE_LOG1("TextExtractor::ExtractPage, failed to parse page %ld", inPageIndex);
+        return eFailure;
+    }
+
+    // resources may be inherited from the pages tree
+    std::shared_ptr<PDFDictionary> resources;
+    std::shared_ptr<PDFDictionary> node = page;
+    for (int level = 0; node && !resources && level < 32; ++level)
+    {
+        resources = PDFObjectCastPtr<PDFDictionary>(mReader->QueryDictionaryObject(node, ePDFNameResources));
+        node = PDFObjectCastPtr<PDFDictionary>(mReader->QueryDictionaryObject(node, ePDFNameParent));
+    }
+
+    if (mContentBuffers.empty())
+        mContentBuffers.resize(1);
+    EStatusCode status = DecodePageContents(page, mContentBuffers[0]);
+    if (status != eSuccess)
+        return status;
+
+    mVisitor = inVisitor;
+    mStopped = false;
+    mRunOpen = false;
+    mStates.clear();
+    mStates.push_back(GraphicState());
+    GraphicState &state = mStates.back();
+    SetIdentity(state.mCTM);
+    state.mCharacterSpacing = 0;
+    state.mWordSpacing = 0;
+    state.mHorizontalScaling = 1;
+    state.mLeading = 0;
+    state.mRise = 0;
+    state.mFontSize = 0;
+    state.mFont = nullptr;
+    SetIdentity(mTextMatrix);
+    SetIdentity(mTextLineMatrix);
+    mFormsStack.clear();
+    mPageFonts.clear();
+    mFontsResources.reset();
+    mFontsDictionary.reset();
+    mResourceFonts.clear();
+
+    status = ReadContent(mContentBuffers[0].data(), mContentBuffers[0].size(), resources, 0);
+    FlushRun();
+    mVisitor = nullptr;
+    return status;
+}
+
+EStatusCode TextExtractor::DecodePageContents(const std::shared_ptr<PDFDictionary> &inPage,
+                                              std::vector<uint8_t> &outContent)
+{
+    outContent.clear();
+    std::shared_ptr<PDFObject> contents = mReader->QueryDictionaryObject(inPage, ePDFNameContents);
+    if (!contents) // no content, no text
+        return eSuccess;
+
+    if (contents->GetType() == PDFObject::ePDFObjectStream)
+    {
+        EStatusCode status =
+            mReader->DecodeStreamToBuffer(std::static_pointer_cast<charta::PDFStreamInput>(contents), outContent);
+        if (status != eSuccess)
+            TRACE_LOG("TextExtractor::DecodePageContents, failed to decode content stream");
+        return status;
+    }
+
+    PDFObjectCastPtr<PDFArray> contentsArray(contents);
+    if (!contentsArray)
+    {
+        TRACE_LOG("TextExtractor::DecodePageContents, unexpected contents type");
+        return eFailure;
+    }
+
+    // the streams of an array are one content
+    for (unsigned long i = 0; i < contentsArray->GetLength(); ++i)
+    {
+        PDFObjectCastPtr<charta::PDFStreamInput> stream(mReader->QueryArrayObject(contentsArray, i));
+        if (!stream || mReader->DecodeStreamToBuffer(stream, mStreamBuffer) != eSuccess)
+        {
+            TRACE_LOG("TextExtractor::DecodePageContents, failed to decode content stream");
+            return eFailure;
+        }
+        outContent.insert(outContent.end(), mStreamBuffer.begin(), mStreamBuffer.end());
+        outContent.push_back('\n');
+    }
+    return eSuccess;
+}
+
+EStatusCode TextExtractor::ReadContent(const uint8_t *inContent, size_t inSize,
+                                       const std::shared_ptr<PDFDictionary> &inResources, size_t inDepth)
+{
+    while (mContentReaders.size() <= inDepth)
+        mContentReaders.push_back(std::make_unique<ContentStreamReader>());
+    ContentStreamReader &reader = *mContentReaders[inDepth];
+
+    ContentStreamOperator anOperator;
+    reader.Start(inContent, inSize);
+    while (!mStopped && reader.Next(anOperator))
+    {
+        std::string_view name = anOperator.mOperator;
+        GraphicState &state = mStates.back();
+
+        switch (name[0])
+        {
+        case 'T':
+            if (name == "Tj")
+            {
+                if (IsString(LastOperand(anOperator)))
+                    ShowText(*LastOperand(anOperator));
+                FlushRun();
+            }
+            else if (name == "TJ")
+            {
+                // the array and its elements are the operands
+                size_t i = 0;
+                while (i < anOperator.mOperandsCount && anOperator.mOperands[i].mType != eContentStreamOperandArray)
+                    ++i;
+                if (i == anOperator.mOperandsCount)
+                    break;
+                size_t end = i + 1 + anOperator.mOperands[i].mElementsCount;
+                for (++i; i < end && i < anOperator.mOperandsCount; ++i)
+                {
+                    const ContentStreamOperand &element = anOperator.mOperands[i];
+                    if (IsString(&element))
+                        ShowText(element);
+                    else if (element.mType == eContentStreamOperandNumber)
+                        AdjustText(element.mNumber);
+                }
+                FlushRun();
+            }
+            else if (name == "Td" && HasNumbers(anOperator, 2))
+            {
+                MoveTextLine(NumberFromEnd(anOperator, 2), NumberFromEnd(anOperator, 1));
+            }
+            else if (name == "TD" && HasNumbers(anOperator, 2))
+            {
+                state.mLeading = -NumberFromEnd(anOperator, 1);
+                MoveTextLine(NumberFromEnd(anOperator, 2), NumberFromEnd(anOperator, 1));
+            }
+            else if (name == "Tm" && HasNumbers(anOperator, 6))
+            {
+                for (size_t i = 0; i < 6; ++i)
+                    mTextMatrix[i] = mTextLineMatrix[i] = NumberFromEnd(anOperator, 6 - i);
+            }
+            else if (name == "T*")
+            {
+                MoveTextLine(0, -state.mLeading);
+            }
+            else if (name == "Tf" && anOperator.mOperandsCount >= 2 && HasNumbers(anOperator, 1))
+            {
+                state.mFontSize = NumberFromEnd(anOperator, 1);
+                SetFont(inResources, anOperator.mOperands[anOperator.mOperandsCount - 2]);
+            }
+            else if (name == "Tc" && HasNumbers(anOperator, 1))
+            {
+                state.mCharacterSpacing = NumberFromEnd(anOperator, 1);
+            }
+            else if (name == "Tw" && HasNumbers(anOperator, 1))
+            {
+                state.mWordSpacing = NumberFromEnd(anOperator, 1);
+            }
+            else if (name == "Tz" && HasNumbers(anOperator, 1))
+            {
+                state.mHorizontalScaling = NumberFromEnd(anOperator, 1) / 100;
+            }
+            else if (name == "TL" && HasNumbers(anOperator, 1))
+            {
+                state.mLeading = NumberFromEnd(anOperator, 1);
+            }
+            else if (name == "Ts" && HasNumbers(anOperator, 1))
+            {
+                state.mRise = NumberFromEnd(anOperator, 1);
+            }
+            break;
+        case '\'':
+            if (name.size() == 1)
+            {
+                MoveTextLine(0, -state.mLeading);
+                if (IsString(LastOperand(anOperator)))
+                    ShowText(*LastOperand(anOperator));
+                FlushRun();
+            }
+            break;
+        case '"':
+            if (name.size() == 1 && anOperator.mOperandsCount >= 3 && IsString(LastOperand(anOperator)))
+            {
+                state.mWordSpacing = anOperator.mOperands[anOperator.mOperandsCount - 3].mNumber;
+                state.mCharacterSpacing = anOperator.mOperands[anOperator.mOperandsCount - 2].mNumber;
+                MoveTextLine(0, -state.mLeading);
+                ShowText(*LastOperand(anOperator));
+                FlushRun();
+            }
+            break;
+        case 'B':
+            if (name == "BT")
+            {
+                SetIdentity(mTextMatrix);
+                SetIdentity(mTextLineMatrix);
+            }
+            break;
+        case 'q':
+            if (name.size() == 1)
+                mStates.push_back(state);
+            break;
+        case 'Q':
+            if (name.size() == 1 && mStates.size() > 1)
+                mStates.pop_back();
+            break;
+        case 'c':
+            if (name == "cm" && HasNumbers(anOperator, 6))
+            {
+                double matrix[6];
+                for (size_t i = 0; i < 6; ++i)
+                    matrix[i] = NumberFromEnd(anOperator, 6 - i);
+                PreMultiply(matrix, state.mCTM);
+            }
+            break;
+        case 'D':
+            if (name == "Do" && anOperator.mOperandsCount > 0 &&
+                LastOperand(anOperator)->mType == eContentStreamOperandName)
+                DrawForm(inResources, *LastOperand(anOperator), inDepth);
+            break;
+        default:
+            break;
+        }
+    }
+    return eSuccess;
+}
+
+void TextExtractor::MoveTextLine(double inX, double inY)
+{
+    Translate(inX, inY, mTextLineMatrix);
+    std::copy(mTextLineMatrix, mTextLineMatrix + 6, mTextMatrix);
+}
+
+void TextExtractor::SetFont(const std::shared_ptr<PDFDictionary> &inResources, const ContentStreamOperand &inName)
+{
+    GraphicState &state = mStates.back();
+    state.mFont = nullptr;
+    if (!inResources || inName.mType != eContentStreamOperandName)
+        return;
+
+    if (mFontsResources != inResources)
+    {
+        mFontsResources = inResources;
+        mFontsDictionary = PDFObjectCastPtr<PDFDictionary>(mReader->QueryDictionaryObject(inResources, ePDFNameFont));
+        mResourceFonts.clear();
+    }
+    for (const auto &resourceFont : mResourceFonts)
+    {
+        if (resourceFont.first == inName.mToken)
+        {
+            state.mFont = resourceFont.second;
+            return;
+        }
+    }
+    if (!mFontsDictionary)
+        return;
+
+    std::shared_ptr<const TextExtractionFont> font =
+        mCache->GetFont(mReader, mFontsDictionary->QueryDirectObject(ContentStreamReader::DecodeName(inName)));
+    if (font && std::find(mPageFonts.begin(), mPageFonts.end(), font) == mPageFonts.end())
+        mPageFonts.push_back(font);
+    mResourceFonts.emplace_back(std::string(inName.mToken), font.get());
+    state.mFont = font.get();
+}
+
+void TextExtractor::ShowText(const ContentStreamOperand &inString)
+{
+    const GraphicState &state = mStates.back();
+    if (state.mFont == nullptr)
+        return;
+
+    const TextExtractionFont *font = state.mFont;
+
+    // text space origin, raised, to user space
+    auto origin = [&](double &outX, double &outY) {
+        double x = mTextMatrix[4] + state.mRise * mTextMatrix[2];
+        double y = mTextMatrix[5] + state.mRise * mTextMatrix[3];
+        outX = x * state.mCTM[0] + y * state.mCTM[2] + state.mCTM[4];
+        outY = x * state.mCTM[1] + y * state.mCTM[3] + state.mCTM[5];
+    };
+
+    if (!mRunOpen)
+    {
+        mRunOpen = true;
+        mRun.mText.clear();
+        origin(mRun.mX, mRun.mY);
+        // the size of an em in user space, along the text vertical axis
+        double c = mTextMatrix[2] * state.mCTM[0] + mTextMatrix[3] * state.mCTM[2];
+        double d = mTextMatrix[2] * state.mCTM[1] + mTextMatrix[3] * state.mCTM[3];
+        mRun.mFontSize = fabs(state.mFontSize) * sqrt(c * c + d * d);
+        mRun.mFontName = font->GetBaseFont();
+    }
+
+    ContentStreamReader::DecodeString(inString, mString);
+    const auto *data = (const uint8_t *)mString.data();
+    size_t size = mString.size();
+    bool vertical = font->IsVertical();
+    for (size_t position = 0; position < size;)
+    {
+        uint32_t code;
+        size_t length = font->ReadCode(data + position, size - position, code);
+        position += length;
+        font->AppendUnicode(code, mRun.mText);
+
+        double spacing = state.mCharacterSpacing + (length == 1 && code == 32 ? state.mWordSpacing : 0);
+        if (vertical)
+            Translate(0, -state.mFontSize + spacing, mTextMatrix);
+        else
+            Translate((font->GetWidth(code) * state.mFontSize + spacing) * state.mHorizontalScaling, 0, mTextMatrix);
+    }
+    origin(mRun.mEndX, mRun.mEndY);
+}
+
+void TextExtractor::AdjustText(double inAdjustment)
+{
+    const GraphicState &state = mStates.back();
+    double ems = -inAdjustment / 1000;
+    // a large enough move forward is a word gap
+    if (ems > mWordGapThreshold)
+        FlushRun();
+    if (state.mFont != nullptr && state.mFont->IsVertical())
+        Translate(0, ems * state.mFontSize, mTextMatrix);
+    else
+        Translate(ems * state.mFontSize * state.mHorizontalScaling, 0, mTextMatrix);
+}
+
+void TextExtractor::FlushRun()
+{
+    if (!mRunOpen)
+        return;
+    mRunOpen = false;
+    if (mRun.mText.empty() || mVisitor == nullptr)
+        return;
+    if (!mVisitor->OnTextRun(mRun))
+        mStopped = true;
+}
+
+void TextExtractor::DrawForm(const std::shared_ptr<PDFDictionary> &inResources, const ContentStreamOperand &inName,
+                             size_t inDepth)
+{
+    if (!inResources || inDepth + 1 >= scMaxFormsDepth)
+        return;
+    PDFObjectCastPtr<PDFDictionary> xObjects(mReader->QueryDictionaryObject(inResources, ePDFNameXObject));
+    if (!xObjects)
+        return;
+
+    // forms that draw themselves are drawn once
+    std::shared_ptr<PDFObject> entry = xObjects->QueryDirectObject(ContentStreamReader::DecodeName(inName));
+    if (!entry)
+        return;
+    ObjectIDType formID = 0;
+    if (entry->GetType() == PDFObject::ePDFObjectIndirectObjectReference)
+    {
+        formID = std::static_pointer_cast<PDFIndirectObjectReference>(entry)->mObjectID;
+        if (std::find(mFormsStack.begin(), mFormsStack.end(), formID) != mFormsStack.end())
+            return;
+        entry = mReader->ParseNewObject(formID);
+    }
+
+    PDFObjectCastPtr<charta::PDFStreamInput> form(entry);
+    if (!form)
+        return;
+    std::shared_ptr<PDFDictionary> formDictionary = form->QueryStreamDictionary();
+    PDFObjectCastPtr<charta::PDFName> subtype(mReader->QueryDictionaryObject(formDictionary, ePDFNameSubtype));
+    if (!subtype || subtype->GetValue() != "Form")
+        return; // images
+
+    if (mContentBuffers.size() <= inDepth + 1)
+        mContentBuffers.resize(inDepth + 2);
+    std::vector<uint8_t> &content = mContentBuffers[inDepth + 1];
+    if (mReader->DecodeStreamToBuffer(form, content) != eSuccess)
+    {
+        TRACE_LOG1("TextExtractor::DrawForm, failed to decode form %ld", formID);
+        return;
+    }
+
+    // the form draws in a state of its own, with its matrix
+    mStates.push_back(mStates.back());
+    PDFObjectCastPtr<PDFArray> matrix(mReader->QueryDictionaryObject(formDictionary, "Matrix"));
+    if (!!matrix && matrix->GetLength() == 6)
+    {
+        double values[6];
+        for (unsigned long i = 0; i < 6; ++i)
+        {
+            std::shared_ptr<PDFObject> value = mReader->QueryArrayObject(matrix, i);
+            ParsedPrimitiveHelper helper(value);
+            values[i] = value && helper.IsNumber() ? helper.GetAsDouble() : (i == 0 || i == 3 ? 1 : 0);
+        }
+        PreMultiply(values, mStates.back().mCTM);
+    }
+    PDFObjectCastPtr<PDFDictionary> formResources(mReader->QueryDictionaryObject(formDictionary, ePDFNameResources));
+    double textMatrix[6], textLineMatrix[6];
+    std::copy(mTextMatrix, mTextMatrix + 6, textMatrix);
+    std::copy(mTextLineMatrix, mTextLineMatrix + 6, textLineMatrix);
+    size_t statesCount = mStates.size();
+
+    mFormsStack.push_back(formID);
+    ReadContent(content.data(), content.size(), !formResources ? inResources : formResources, inDepth + 1);
+    mFormsStack.pop_back();
+
+    // unbalanced q/Q in the form don't leak out of it
+    mStates.resize(statesCount - 1);
+    std::copy(textMatrix, textMatrix + 6, mTextMatrix);
+    std::copy(textLineMatrix, textLineMatrix + 6, mTextLineMatrix);
+}
+
+EStatusCode TextExtractor::ExtractPages(PDFParser *inParser, IPositionalByteReader *inSource,
+                                        unsigned long inFirstPage, unsigned long inPagesCount,
+                                        unsigned int inThreadsCount, std::vector<std::vector<TextRun>> &outPages,
+                                        TextExtractionCache *inCache)
+{
+    if (inFirstPage + inPagesCount > inParser->GetPagesCount())
+    {
+        TRACE_LOG2("TextExtractor::ExtractPages, %ld pages from page %ld are out of range", inPagesCount, inFirstPage);
+        return eFailure;
+    }
+
+    outPages.clear();
+    outPages.resize(inPagesCount);
+    std::unique_ptr<TextExtractionCache> ownCache;
+    if (inCache == nullptr)
+    {
+        ownCache = std::make_unique<TextExtractionCache>();
+        inCache = ownCache.get();
+    }
+
+    if (inThreadsCount == 0)
+        inThreadsCount = std::max(1u, std::thread::hardware_concurrency());
+    if (inThreadsCount > inPagesCount)
+        inThreadsCount = (unsigned int)std::max(1ul, inPagesCount);
+
+    // threads take the next page when done with one, so slow pages don't hold the rest
+    std::atomic<unsigned long> nextPage(0);
+    std::atomic<bool> failed(false);
+    auto work = [&]() {
+        PDFParserReader reader(inParser, inSource);
+        TextExtractor extractor(&reader, inCache);
+        for (unsigned long i = nextPage++; i < inPagesCount; i = nextPage++)
+        {
+            if (extractor.ExtractPage(inFirstPage + i, outPages[i]) != eSuccess)
+            {
+                outPages[i].clear();
+                failed = true;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned int t = 1; t < inThreadsCount; ++t)
+        threads.emplace_back(work);
+    work();
+    for (auto &thread : threads)
+        thread.join();
+
+    return failed ? eFailure : eSuccess;
+}
+
+std::string TextExtractor::RunsToText(const std::vector<TextRun> &inRuns)
+{
+    std::string result;
+    const TextRun *previous = nullptr;
+    for (const TextRun &run : inRuns)
+    {
+        if (previous != nullptr)
+        {
+            double size = std::max(std::max(run.mFontSize, previous->mFontSize), 1.0);
+            if (fabs(run.mY - previous->mEndY) > size / 2)
+                result.push_back('\n');
+            else if (fabs(run.mX - previous->mEndX) > size * 0.15 && !result.empty() && result.back() != ' ' &&
+                     !run.mText.empty() && run.mText[0] != ' ')
+                result.push_back(' ');
+        }
+        result.append(run.mText);
+        previous = &run;
+    }
+    return result;
+}
@@ -0,0 +1,224 @@
+/*
+   Source File : XrefScanner.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "parsing/XrefScanner.h"
+#include "io/IByteReaderWithPosition.h"
+
+#include <algorithm>
+#include <string.h>
+
+using namespace charta;
+
+// bytes kept from the end of a block for the next one. enough for the longest object header and keyword
+static const size_t scCarrySize = 64;
+
+struct KeywordDefinition
+{
+    const char *mText;
+    size_t mLength;
+    bool mIsName;
+};
+
+static const KeywordDefinition scKeywords[XrefScanner::eKeywordsCount] = {
+    {"trailer", 7, false}, {"/ObjStm", 7, true}, {"/XRef", 5, true}, {"/Catalog", 8, true}};
+
+static bool IsWhiteSpace(uint8_t inCharacter)
+{
+    return inCharacter == 0x20 || inCharacter == 0xA || inCharacter == 0xD || inCharacter == 0x9 ||
+           inCharacter == 0xC || inCharacter == 0;
+}
+
+static bool IsDelimiter(uint8_t inCharacter)
+{
+    return inCharacter == '(' || inCharacter == ')' || inCharacter == '<' || inCharacter == '>' ||
+           inCharacter == '[' || inCharacter == ']' || inCharacter == '{' || inCharacter == '}' ||
+           inCharacter == '/' || inCharacter == '%';
+}
+
+static bool IsRegular(uint8_t inCharacter)
+{
+    return !IsWhiteSpace(inCharacter) && !IsDelimiter(inCharacter);
+}
+
+static bool IsDigit(uint8_t inCharacter)
+{
+    return inCharacter >= '0' && inCharacter <= '9';
+}
+
+XrefScanner::XrefScanner(size_t inBlockSize)
+{
+    mBlockSize = std::max(inBlockSize, scCarrySize * 4);
+}
+
+EStatusCode XrefScanner::Scan(IByteReaderWithPosition *inStream)
+{
+    mObjects.clear();
+    for (auto &positions : mKeywordPositions)
+        positions.clear();
+
+    std::vector<uint8_t> buffer(scCarrySize + mBlockSize);
+    size_t carry = 0;
+    long long bufferPosition = 0;
+
+    inStream->SetPosition(0);
+    while (true)
+    {
+        size_t readAmount = inStream->Read(buffer.data() + carry, mBlockSize);
+        size_t length = carry + readAmount;
+        bool isLastBlock = readAmount == 0 || !inStream->NotEnded();
+
+        // a marker is checked once the byte following it is available. markers decided in the previous block are
+        // not reported again, so search from where undecided ones could start
+        ScanObjectHeaders(buffer.data(), length, carry, bufferPosition, isLastBlock);
+        for (int i = 0; i < eKeywordsCount; ++i)
+            ScanKeyword((EKeyword)i, buffer.data(), length, carry, bufferPosition, isLastBlock);
+
+        if (isLastBlock)
+            break;
+
+        size_t nextCarry = std::min(length, scCarrySize);
+        memmove(buffer.data(), buffer.data() + length - nextCarry, nextCarry);
+        bufferPosition += (long long)(length - nextCarry);
+        carry = nextCarry;
+    }
+
+    return mObjects.empty() ? eFailure : eSuccess;
+}
+
+void XrefScanner::ScanObjectHeaders(const uint8_t *inBuffer, size_t inLength, size_t inFrom,
+                                    long long inBufferPosition, bool inIsLastBlock)
+{
+    // candidates are "obj" keywords, decided by the byte after them (inFrom is the first undecided position)
+    size_t searchStart = inFrom >= 3 ? inFrom - 3 : 0;
+    const uint8_t *end = inBuffer + inLength;
+    const uint8_t *current = inBuffer + searchStart;
+
+    while (current < end)
+    {
+        current = (const uint8_t *)memchr(current, 'o', end - current);
+        if (current == nullptr)
+            break;
+
+        size_t index = current - inBuffer;
+        ++current;
+
+        size_t decisionIndex = index + 3;
+        if (decisionIndex > inLength || (decisionIndex == inLength && !inIsLastBlock))
+            break;
+        if (inBuffer[index + 1] != 'b' || inBuffer[index + 2] != 'j')
+            continue;
+        if (decisionIndex < inLength && IsRegular(inBuffer[decisionIndex]))
+            continue;
+
+        // now go back over "N G "
+        long long i = (long long)index - 1;
+        if (i < 0 || !IsWhiteSpace(inBuffer[i]))
+            continue;
+        while (i >= 0 && IsWhiteSpace(inBuffer[i]))
+            --i;
+
+        unsigned long generationNumber = 0;
+        unsigned long multiplier = 1;
+        long long digitsEnd = i;
+        while (i >= 0 && IsDigit(inBuffer[i]) && digitsEnd - i < 5)
+        {
+            generationNumber += (inBuffer[i] - '0') * multiplier;
+            multiplier *= 10;
+            --i;
+        }
+        if (i == digitsEnd || i < 0 || !IsWhiteSpace(inBuffer[i]))
+            continue;
+        while (i >= 0 && IsWhiteSpace(inBuffer[i]))
+            --i;
+
+        ObjectIDType objectID = 0;
+        ObjectIDType idMultiplier = 1;
+        digitsEnd = i;
+        while (i >= 0 && IsDigit(inBuffer[i]) && digitsEnd - i < 10)
+        {
+            objectID += (inBuffer[i] - '0') * idMultiplier;
+            idMultiplier *= 10;
+            --i;
+        }
+        if (i == digitsEnd || objectID == 0)
+            continue;
+        // the ID must start a token. running out of buffer is fine only at the file start
+        if ((i >= 0 && IsRegular(inBuffer[i])) || (i < 0 && inBufferPosition != 0))
+            continue;
+
+        mObjects.push_back({objectID, generationNumber, inBufferPosition + i + 1});
+    }
+}
+
+void XrefScanner::ScanKeyword(EKeyword inKeyword, const uint8_t *inBuffer, size_t inLength, size_t inFrom,
+                              long long inBufferPosition, bool inIsLastBlock)
+{
+    const KeywordDefinition &keyword = scKeywords[inKeyword];
+    size_t searchStart = inFrom >= keyword.mLength ? inFrom - keyword.mLength : 0;
+
+    // look for the second character, which is rarer than the first (a slash, for names), then match the rest
+    const uint8_t *end = inBuffer + inLength;
+    const uint8_t *current = inBuffer + searchStart + 1;
+
+    while (current < end)
+    {
+        current = (const uint8_t *)memchr(current, keyword.mText[1], end - current);
+        if (current == nullptr)
+            break;
+
+        const uint8_t *found = current - 1;
+        ++current;
+        if (found + keyword.mLength > end)
+            break;
+        if (memcmp(found, keyword.mText, keyword.mLength) != 0)
+            continue;
+
+        size_t index = found - inBuffer;
+        size_t decisionIndex = index + keyword.mLength;
+
+        if (decisionIndex == inLength && !inIsLastBlock)
+            break;
+        if (decisionIndex < inLength && IsRegular(inBuffer[decisionIndex]))
+            continue;
+        // keywords must start a token, names are self delimiting
+        if (!keyword.mIsName && index > 0 && IsRegular(inBuffer[index - 1]))
+            continue;
+
+        mKeywordPositions[inKeyword].push_back(inBufferPosition + (long long)(keyword.mIsName ? index : decisionIndex));
+    }
+}
+
+const std::vector<XrefScannedObject> &XrefScanner::GetObjects() const
+{
+    return mObjects;
+}
+
+const std::vector<long long> &XrefScanner::GetKeywordPositions(EKeyword inKeyword) const
+{
+    return mKeywordPositions[inKeyword];
+}
+
+long long XrefScanner::FindObjectBefore(long long inPosition) const
+{
+    auto it = std::lower_bound(
+        mObjects.begin(), mObjects.end(), inPosition,
+        [](const XrefScannedObject &inObject, long long inValue) { return inObject.mPosition < inValue; });
+    return (long long)(it - mObjects.begin()) - 1;
+}
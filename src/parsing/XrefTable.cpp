@@ -0,0 +1,153 @@
+/*
+   Source File : XrefTable.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "parsing/XrefTable.h"
+
+#include <algorithm>
+
+static const uint64_t scPositionBits = 40;
+static const uint64_t scPositionMask = (uint64_t(1) << scPositionBits) - 1;
+static const uint64_t scTypeShift = 40;
+static const uint64_t scTypeMask = 3;
+static const uint64_t scWideFlag = uint64_t(1) << 42;
+static const uint64_t scRivisionShift = 43;
+static const uint64_t scRivisionMax = (uint64_t(1) << 21) - 1;
+
+// stored type codes. 0 is kept for undefined, so that zeroed entries are undefined
+static uint64_t EncodeType(EXrefEntryType inType)
+{
+    switch (inType)
+    {
+    case eXrefEntryExisting:
+        return 1;
+    case eXrefEntryDelete:
+        return 2;
+    case eXrefEntryStreamObject:
+        return 3;
+    default:
+        return 0;
+    }
+}
+
+static EXrefEntryType DecodeType(uint64_t inEntry)
+{
+    switch ((inEntry >> scTypeShift) & scTypeMask)
+    {
+    case 1:
+        return eXrefEntryExisting;
+    case 2:
+        return eXrefEntryDelete;
+    case 3:
+        return eXrefEntryStreamObject;
+    default:
+        return eXrefEntryUndefined;
+    }
+}
+
+XrefTable::XrefTable() = default;
+
+void XrefTable::Reset(ObjectIDType inSize)
+{
+    mEntries.assign(inSize, 0);
+    mWideEntries.clear();
+}
+
+void XrefTable::Clear()
+{
+    std::vector<uint64_t>().swap(mEntries);
+    mWideEntries.clear();
+}
+
+ObjectIDType XrefTable::GetSize() const
+{
+    return (ObjectIDType)mEntries.size();
+}
+
+void XrefTable::ExtendToSize(ObjectIDType inNewSize)
+{
+    if (inNewSize <= mEntries.size())
+        return;
+
+    // grow capacity geometrically, so that a series of extending segments does not copy the table over and over
+    if (inNewSize > mEntries.capacity())
+        mEntries.reserve(std::max<size_t>(inNewSize, mEntries.capacity() + mEntries.capacity() / 2));
+    mEntries.resize(inNewSize, 0);
+}
+
+EXrefEntryType XrefTable::GetType(ObjectIDType inObjectID) const
+{
+    if (inObjectID >= mEntries.size())
+        return eXrefEntryUndefined;
+    return DecodeType(mEntries[inObjectID]);
+}
+
+long long XrefTable::GetObjectPosition(ObjectIDType inObjectID) const
+{
+    if (inObjectID >= mEntries.size())
+        return 0;
+
+    uint64_t entry = mEntries[inObjectID];
+    if ((entry & scWideFlag) != 0)
+        return mWideEntries.find(inObjectID)->second.first;
+    return (long long)(entry & scPositionMask);
+}
+
+unsigned long XrefTable::GetRivision(ObjectIDType inObjectID) const
+{
+    if (inObjectID >= mEntries.size())
+        return 0;
+
+    uint64_t entry = mEntries[inObjectID];
+    if ((entry & scWideFlag) != 0)
+        return mWideEntries.find(inObjectID)->second.second;
+    return (unsigned long)(entry >> scRivisionShift);
+}
+
+XrefEntryInput XrefTable::GetEntry(ObjectIDType inObjectID) const
+{
+    if (inObjectID >= mEntries.size())
+        return XrefEntryInput();
+    return XrefEntryInput(GetObjectPosition(inObjectID), GetRivision(inObjectID), GetType(inObjectID));
+}
+
+void XrefTable::SetEntry(ObjectIDType inObjectID, long long inObjectPosition, unsigned long inRivision,
+                         EXrefEntryType inType)
+{
+    uint64_t entry = EncodeType(inType) << scTypeShift;
+
+    if (inObjectPosition >= 0 && (uint64_t)inObjectPosition <= scPositionMask && inRivision <= scRivisionMax)
+    {
+        entry |= (uint64_t)inObjectPosition | ((uint64_t)inRivision << scRivisionShift);
+        if ((mEntries[inObjectID] & scWideFlag) != 0)
+            mWideEntries.erase(inObjectID);
+    }
+    else
+    {
+        entry |= scWideFlag;
+        mWideEntries[inObjectID] = std::make_pair(inObjectPosition, inRivision);
+    }
+    mEntries[inObjectID] = entry;
+}
+
+size_t XrefTable::GetMemoryFootprint() const
+{
+    return mEntries.capacity() * sizeof(uint64_t) +
+           mWideEntries.size() * (sizeof(ObjectIDType) + sizeof(std::pair<long long, unsigned long>));
+}
@@ -0,0 +1,187 @@
+/*
+   Source File : ContentStreamReaderTest.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "parsing/ContentStreamReader.h"
+#include "PDFPage.h"
+#include "PDFWriter.h"
+#include "PageContentContext.h"
+#include "TestHelper.h"
+#include "io/InputFile.h"
+#include "parsing/PDFParser.h"
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using namespace charta;
+
+namespace
+{
+class OperatorsRecorder : public IContentStreamVisitor
+{
+  public:
+    std::vector<std::string> mOperators;
+    size_t mStopAfter = SIZE_MAX;
+
+    bool OnOperator(const ContentStreamOperator &inOperator) override
+    {
+        mOperators.emplace_back(inOperator.mOperator);
+        return mOperators.size() < mStopAfter;
+    }
+};
+} // namespace
+
+static bool NextOperator(ContentStreamReader &inReader, ContentStreamOperator &outOperator,
+                         const std::string &inExpected)
+{
+    return inReader.Next(outOperator) && outOperator.mOperator == inExpected;
+}
+
+TEST(Parsing, ContentStreamReader)
+{
+    // the image data has a 0 in it
+    static const char scContent[] = "q 1 0 0 -1.5 +.25 600. cm % a comment ) [ <<\n"
+                                    "/F1#20x 12 Tf\r\n"
+                                    "[(Hel\\)lo (nested) \\101) -120.75 <48 65 6C6>] TJ\n"
+                                    "/Span <</MCID 3 /Alt [1 [2 3]]>> BDC EMC\n"
+                                    "BI /W 4 /H 1 /CS /G /D [1 0] ID \x01" "EI\xff\x00 EI Q";
+    const std::string content(scContent, sizeof(scContent) - 1);
+    const uint8_t *data = (const uint8_t *)content.data();
+
+    ContentStreamReader reader;
+    reader.Start(data, content.size());
+    ContentStreamOperator anOperator;
+
+    ASSERT_TRUE(NextOperator(reader, anOperator, "q"));
+    EXPECT_EQ(anOperator.mOperandsCount, 0);
+
+    ASSERT_TRUE(NextOperator(reader, anOperator, "cm"));
+    ASSERT_EQ(anOperator.mOperandsCount, 6);
+    const double matrix[] = {1, 0, 0, -1.5, 0.25, 600};
+    for (size_t i = 0; i < 6; ++i)
+    {
+        EXPECT_EQ(anOperator.mOperands[i].mType, eContentStreamOperandNumber);
+        EXPECT_EQ(anOperator.mOperands[i].mNumber, matrix[i]);
+    }
+    EXPECT_TRUE(anOperator.mOperands[0].mIsInteger);
+    EXPECT_FALSE(anOperator.mOperands[5].mIsInteger);
+    EXPECT_EQ(content.substr(anOperator.mPosition, 2), "cm");
+
+    // the comment is skipped, and so are the unterminated array and dictionary that follow it
+    ASSERT_TRUE(NextOperator(reader, anOperator, "Tf"));
+    ASSERT_EQ(anOperator.mOperandsCount, 2);
+    EXPECT_EQ(anOperator.mOperands[0].mType, eContentStreamOperandName);
+    EXPECT_EQ(anOperator.mOperands[0].mToken, "F1#20x");
+    EXPECT_EQ(ContentStreamReader::DecodeName(anOperator.mOperands[0]), "F1 x");
+    EXPECT_EQ(content[anOperator.mOperands[0].mPosition], '/');
+
+    ASSERT_TRUE(NextOperator(reader, anOperator, "TJ"));
+    ASSERT_EQ(anOperator.mOperandsCount, 4);
+    EXPECT_EQ(anOperator.mOperands[0].mType, eContentStreamOperandArray);
+    EXPECT_EQ(anOperator.mOperands[0].mElementsCount, 3);
+    EXPECT_EQ(anOperator.mOperands[1].mType, eContentStreamOperandLiteralString);
+    EXPECT_EQ(ContentStreamReader::DecodeString(anOperator.mOperands[1]), "Hel)lo (nested) A");
+    EXPECT_EQ(anOperator.mOperands[2].mNumber, -120.75);
+    EXPECT_EQ(anOperator.mOperands[3].mType, eContentStreamOperandHexString);
+    EXPECT_EQ(ContentStreamReader::DecodeString(anOperator.mOperands[3]), "Hel`");
+
+    ASSERT_TRUE(NextOperator(reader, anOperator, "BDC"));
+    ASSERT_EQ(anOperator.mOperandsCount, 10);
+    EXPECT_EQ(anOperator.mOperands[1].mType, eContentStreamOperandDictionary);
+    EXPECT_EQ(anOperator.mOperands[1].mElementsCount, 8);
+    EXPECT_EQ(anOperator.mOperands[4].mType, eContentStreamOperandName);
+    EXPECT_EQ(anOperator.mOperands[4].mToken, "Alt");
+    EXPECT_EQ(anOperator.mOperands[5].mElementsCount, 4);
+    EXPECT_EQ(anOperator.mOperands[7].mElementsCount, 2);
+
+    ASSERT_TRUE(NextOperator(reader, anOperator, "EMC"));
+
+    // inline image data is skipped up to the EI that ends it, and not the one in the data
+    ASSERT_TRUE(NextOperator(reader, anOperator, "BI"));
+    ASSERT_EQ(anOperator.mOperandsCount, 10);
+    EXPECT_EQ(anOperator.mOperands[6].mToken, "D");
+    EXPECT_EQ(anOperator.mOperands[7].mElementsCount, 2);
+    ASSERT_EQ(anOperator.mInlineImageSize, 5);
+    EXPECT_EQ(std::string((const char *)anOperator.mInlineImageData, 5), std::string("\x01" "EI\xff\x00", 5));
+
+    ASSERT_TRUE(NextOperator(reader, anOperator, "Q"));
+    EXPECT_FALSE(reader.Next(anOperator));
+
+    // push interface, stopping early
+    OperatorsRecorder recorder;
+    recorder.mStopAfter = 3;
+    EXPECT_EQ(reader.Read(data, content.size(), &recorder), eSuccess);
+    EXPECT_EQ(recorder.mOperators, std::vector<std::string>({"q", "cm", "Tf"}));
+}
+
+TEST(Parsing, ContentStreamReaderInlineImageLength)
+{
+    // a stated length wins over an EI in the data
+    const std::string content = "BI /W 2 /H 2 /L 6 ID 12 EI\n EI\nQ";
+    ContentStreamReader reader;
+    reader.Start((const uint8_t *)content.data(), content.size());
+    ContentStreamOperator anOperator;
+
+    ASSERT_TRUE(NextOperator(reader, anOperator, "BI"));
+    EXPECT_EQ(std::string((const char *)anOperator.mInlineImageData, anOperator.mInlineImageSize), "12 EI\n");
+    ASSERT_TRUE(NextOperator(reader, anOperator, "Q"));
+}
+
+TEST(Parsing, ContentStreamReaderPageContents)
+{
+    std::string outputPath = RelativeURLToLocalPath(PDFWRITE_BINARY_PATH, "ContentStreamReader.pdf");
+    {
+        PDFWriter pdfWriter;
+        ASSERT_EQ(pdfWriter.StartPDF(outputPath, ePDFVersion13), eSuccess);
+        PDFPage page;
+        page.SetMediaBox(PDFRectangle(0, 0, 595, 842));
+        PageContentContext *contentContext = pdfWriter.StartPageContentContext(page);
+        contentContext->q();
+        contentContext->cm(1, 0, 0, 1, 10.5, 20);
+        contentContext->re(0, 0, 100, 50);
+        contentContext->f();
+        // pausing makes the contents an array of two streams
+        ASSERT_EQ(pdfWriter.PausePageContentContext(contentContext), eSuccess);
+        contentContext->Q();
+        ASSERT_EQ(pdfWriter.EndPageContentContext(contentContext), eSuccess);
+        ASSERT_EQ(pdfWriter.WritePage(page), eSuccess);
+        ASSERT_EQ(pdfWriter.EndPDF(), eSuccess);
+    }
+
+    InputFile pdfFile;
+    PDFParser parser;
+    ASSERT_EQ(pdfFile.OpenFile(outputPath), eSuccess);
+    ASSERT_EQ(parser.StartPDFParsing(pdfFile.GetInputStream()), eSuccess);
+
+    ContentStreamReader reader;
+    OperatorsRecorder recorder;
+    ASSERT_EQ(reader.ReadPageContents(&parser, 0, &recorder), eSuccess);
+    EXPECT_EQ(recorder.mOperators, std::vector<std::string>({"q", "cm", "re", "f", "Q"}));
+
+    // and a page from an existing file
+    InputFile sourceFile;
+    PDFParser sourceParser;
+    ASSERT_EQ(sourceFile.OpenFile(RelativeURLToLocalPath(PDFWRITE_SOURCE_PATH, "data/XObjectContent.pdf")), eSuccess);
+    ASSERT_EQ(sourceParser.StartPDFParsing(sourceFile.GetInputStream()), eSuccess);
+    OperatorsRecorder sourceRecorder;
+    ASSERT_EQ(reader.ReadPageContents(&sourceParser, 0, &sourceRecorder), eSuccess);
+    EXPECT_FALSE(sourceRecorder.mOperators.empty());
+}
@@ -0,0 +1,123 @@
+/*
+   Source File : DecodeStreamToBufferTest.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "TestHelper.h"
+#include "io/InputFile.h"
+#include "objects/PDFObjectCast.h"
+#include "objects/PDFStreamInput.h"
+#include "parsing/PDFParser.h"
+#include "parsing/PDFParserReader.h"
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+using namespace charta;
+
+namespace
+{
+std::vector<uint8_t> ReadThroughFilters(PDFParser &inParser, const std::shared_ptr<charta::PDFStreamInput> &inStream)
+{
+    std::vector<uint8_t> result;
+    std::unique_ptr<IByteReader> reader(inParser.StartReadingFromStream(inStream));
+    if (!reader)
+        return result;
+    uint8_t buffer[1000];
+    while (reader->NotEnded())
+    {
+        size_t readBytes = reader->Read(buffer, sizeof(buffer));
+        if (readBytes == 0)
+            break;
+        result.insert(result.end(), buffer, buffer + readBytes);
+    }
+    return result;
+}
+
+// every stream in the file decodes to the same content as through the filter chain
+void CompareStreams(const std::string &inFileName,
+                    const PDFParsingOptions &inOptions = PDFParsingOptions::DefaultPDFParsingOptions())
+{
+    InputFile pdfFile;
+    PDFParser parser;
+
+    ASSERT_EQ(pdfFile.OpenFile(RelativeURLToLocalPath(PDFWRITE_SOURCE_PATH, inFileName)), eSuccess);
+    ASSERT_EQ(parser.StartPDFParsing(pdfFile.GetInputStream(), inOptions), eSuccess) << inFileName;
+
+    int streamsCount = 0;
+    std::vector<uint8_t> buffer = parser.AcquireStreamBuffer();
+    for (ObjectIDType i = 1; i < parser.GetXrefSize(); ++i)
+    {
+        auto object = parser.ParseNewObject(i);
+        if (!object || object->GetType() != PDFObject::ePDFObjectStream)
+            continue;
+        auto stream = std::static_pointer_cast<charta::PDFStreamInput>(object);
+
+        std::vector<uint8_t> expected = ReadThroughFilters(parser, stream);
+        ASSERT_EQ(parser.DecodeStreamToBuffer(stream, buffer), eSuccess) << inFileName << " object " << i;
+        EXPECT_EQ(buffer, expected) << inFileName << " object " << i;
+        ++streamsCount;
+    }
+    parser.ReleaseStreamBuffer(std::move(buffer));
+    EXPECT_GT(streamsCount, 0);
+}
+} // namespace
+
+TEST(Parsing, DecodeStreamToBuffer)
+{
+    // flate with and without predictors, xref and object streams, images and plain streams
+    CompareStreams("data/ObjectStreams.pdf");
+    CompareStreams("data/XObjectContent.pdf");
+    CompareStreams("data/Linearized.pdf");
+    CompareStreams("data/test3.pdf");
+    // encrypted, read through the decryption filter
+    CompareStreams("data/PDFWithPassword.pdf", PDFParsingOptions("user"));
+}
+
+TEST(Parsing, DecodeStreamToBufferPool)
+{
+    InputFile pdfFile;
+    PDFParser parser;
+
+    ASSERT_EQ(pdfFile.OpenFile(RelativeURLToLocalPath(PDFWRITE_SOURCE_PATH, "data/AddedPage.pdf")), eSuccess);
+    ASSERT_EQ(parser.StartPDFParsing(pdfFile.GetInputStream()), eSuccess);
+
+    auto page = parser.ParsePage(0);
+    ASSERT_TRUE(!!page);
+    PDFObjectCastPtr<charta::PDFStreamInput> contents(parser.QueryDictionaryObject(page, ePDFNameContents));
+    ASSERT_TRUE(!!contents);
+
+    // a released buffer comes back empty, with its memory
+    std::vector<uint8_t> buffer = parser.AcquireStreamBuffer();
+    ASSERT_EQ(parser.DecodeStreamToBuffer(contents, buffer), eSuccess);
+    std::vector<uint8_t> expected = buffer;
+    EXPECT_FALSE(expected.empty());
+    const uint8_t *memory = buffer.data();
+    parser.ReleaseStreamBuffer(std::move(buffer));
+
+    std::vector<uint8_t> reused = parser.AcquireStreamBuffer();
+    EXPECT_TRUE(reused.empty());
+    EXPECT_EQ(reused.data(), memory);
+
+    // and the readers decode the same
+    PDFParserReader reader(&parser);
+    ASSERT_EQ(reader.DecodeStreamToBuffer(contents, reused), eSuccess);
+    EXPECT_EQ(reused, expected);
+    parser.ReleaseStreamBuffer(std::move(reused));
+}
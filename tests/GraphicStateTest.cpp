@@ -0,0 +1,139 @@
+/*
+   Source File : GraphicStateTest.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "PDFPage.h"
+#include "PDFWriter.h"
+#include "PageContentContext.h"
+#include "PagePresets.h"
+#include "io/OutputStringBufferStream.h"
+
+#include <gtest/gtest.h>
+
+using namespace charta;
+
+static size_t CountOperator(const std::string &inContent, const std::string &inOperator)
+{
+    std::string token = " " + inOperator + "\r\n";
+    size_t count = 0;
+    for (size_t position = inContent.find(token); position != std::string::npos;
+         position = inContent.find(token, position + 1))
+        ++count;
+    return count;
+}
+
+static std::string WriteTablePage(bool inElideRedundantOperators)
+{
+    OutputStringBufferStream pdfStream;
+    PDFWriter pdfWriter;
+    PDFCreationSettings settings(false, true);
+    settings.ElideRedundantOperators = inElideRedundantOperators;
+
+    EXPECT_EQ(pdfWriter.StartPDFForStream(&pdfStream, ePDFVersion13, LogConfiguration::DefaultLogConfiguration(),
+                                          settings),
+              eSuccess);
+
+    PDFPage page;
+    page.SetMediaBox(charta::PagePresets::A4_Portrait);
+    PageContentContext *contentContext = pdfWriter.StartPageContentContext(page);
+
+    AbstractContentContext::GraphicOptions cellBorder(AbstractContentContext::eStroke, AbstractContentContext::eRGB,
+                                                      0x808080, 0.5);
+    AbstractContentContext::GraphicOptions cellFill(AbstractContentContext::eFill, AbstractContentContext::eRGB,
+                                                    0xFF0000);
+    for (int row = 0; row < 10; ++row)
+    {
+        contentContext->DrawRectangle(50, 50 + row * 20, 100, 20, cellFill);
+        contentContext->DrawRectangle(50, 50 + row * 20, 100, 20, cellBorder);
+    }
+
+    // Q brings back the color that was set before q
+    contentContext->q();
+    contentContext->rg(0, 0, 1);
+    contentContext->cm(1, 0, 0, 1, 0, 0);
+    contentContext->Q();
+    contentContext->rg(1, 0, 0);
+
+    EXPECT_EQ(pdfWriter.EndPageContentContext(contentContext), eSuccess);
+    EXPECT_EQ(pdfWriter.WritePage(page), eSuccess);
+    EXPECT_EQ(pdfWriter.EndPDFForStream(), eSuccess);
+    return pdfStream.ToString();
+}
+
+TEST(PDF, RedundantOperatorsElision)
+{
+    std::string plain = WriteTablePage(false);
+    EXPECT_EQ(CountOperator(plain, "rg"), 12);
+    EXPECT_EQ(CountOperator(plain, "RG"), 10);
+    EXPECT_EQ(CountOperator(plain, "w"), 10);
+    EXPECT_EQ(CountOperator(plain, "cm"), 1);
+
+    std::string elided = WriteTablePage(true);
+    EXPECT_EQ(CountOperator(elided, "rg"), 2);
+    EXPECT_EQ(CountOperator(elided, "RG"), 1);
+    EXPECT_EQ(CountOperator(elided, "w"), 1);
+    EXPECT_EQ(CountOperator(elided, "cm"), 0);
+    EXPECT_EQ(CountOperator(elided, "re"), 20);
+    EXPECT_LT(elided.size(), plain.size());
+}
+
+TEST(PDF, GraphicStateTracking)
+{
+    OutputStringBufferStream pdfStream;
+    PDFWriter pdfWriter;
+    ASSERT_EQ(pdfWriter.StartPDFForStream(&pdfStream, ePDFVersion13), eSuccess);
+
+    PDFPage page;
+    page.SetMediaBox(charta::PagePresets::A4_Portrait);
+    PageContentContext *contentContext = pdfWriter.StartPageContentContext(page);
+    ASSERT_NE(contentContext, nullptr);
+    EXPECT_FALSE(contentContext->GetElideRedundantOperators());
+
+    // nothing is assumed before it is set
+    EXPECT_FALSE(contentContext->GetCurrentGraphicState().mLineWidth.has_value());
+    EXPECT_EQ(contentContext->GetCurrentGraphicState().mFillColor.mComponentsCount, 0);
+
+    contentContext->cm(2, 0, 0, 2, 10, 10);
+    contentContext->cm(1, 0, 0, 1, 5, 5);
+    const double *ctm = contentContext->GetCurrentGraphicState().mCTM;
+    EXPECT_DOUBLE_EQ(ctm[0], 2);
+    EXPECT_DOUBLE_EQ(ctm[3], 2);
+    EXPECT_DOUBLE_EQ(ctm[4], 20);
+    EXPECT_DOUBLE_EQ(ctm[5], 20);
+
+    contentContext->k(0, 0, 0, 1);
+    contentContext->Tc(0.5);
+    contentContext->q();
+    contentContext->w(3);
+    contentContext->DoubleQuoteLow(2, 1, "text");
+    EXPECT_EQ(contentContext->GetCurrentGraphicState().mCharacterSpacing, 1);
+    EXPECT_EQ(contentContext->Q(), eSuccess);
+    EXPECT_EQ(contentContext->GetCurrentGraphicState().mCharacterSpacing, 0.5);
+    EXPECT_FALSE(contentContext->GetCurrentGraphicState().mLineWidth.has_value());
+    EXPECT_EQ(contentContext->GetCurrentGraphicState().mFillColor.mColorSpace, "DeviceCMYK");
+
+    // free code may change anything
+    contentContext->WriteFreeCode("0 g\r\n");
+    EXPECT_EQ(contentContext->GetCurrentGraphicState().mFillColor.mComponentsCount, 0);
+    EXPECT_FALSE(contentContext->GetCurrentGraphicState().mCTMKnown);
+
+    ASSERT_EQ(pdfWriter.EndPageContentContext(contentContext), eSuccess);
+    ASSERT_EQ(pdfWriter.WritePage(page), eSuccess);
+    ASSERT_EQ(pdfWriter.EndPDFForStream(), eSuccess);
+}
@@ -0,0 +1,184 @@
+/*
+   Source File : ImageDownsamplingTest.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "PDFPage.h"
+#include "PDFWriter.h"
+#include "PageContentContext.h"
+#include "TestHelper.h"
+#include "images/pixels/PixelsResampling.h"
+#include "io/InputFile.h"
+#include "objects/PDFDictionary.h"
+#include "objects/PDFInteger.h"
+#include "objects/PDFName.h"
+#include "objects/PDFObjectCast.h"
+#include "objects/PDFStreamInput.h"
+#include "parsing/PDFParser.h"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <utility>
+#include <vector>
+
+using namespace charta;
+
+namespace
+{
+typedef std::vector<std::pair<long long, long long>> SizesVector;
+
+EStatusCode WriteImagesDocument(const std::string &inOutputPath, double inTargetResolution)
+{
+    PDFWriter pdfWriter;
+    PDFCreationSettings settings(true, true);
+    settings.ImageTargetResolution = inTargetResolution;
+
+    EStatusCode status = pdfWriter.StartPDF(inOutputPath, ePDFVersion14, LogConfiguration::DefaultLogConfiguration(),
+                                            settings);
+    if (status != eSuccess)
+        return status;
+
+    PDFPage page;
+    page.SetMediaBox(charta::PagePresets::A4_Portrait);
+    PageContentContext *cxt = pdfWriter.StartPageContentContext(page);
+
+    AbstractContentContext::ImageOptions options;
+    options.transformationMethod = AbstractContentContext::eFit;
+    options.fitProportional = true;
+
+    // 1600x1200 jpg, in 200x150 points
+    options.boundingBoxWidth = 200;
+    options.boundingBoxHeight = 150;
+    cxt->DrawImage(10, 10, RelativeURLToLocalPath(PDFWRITE_SOURCE_PATH, "data/images/otherStage.JPG"), options);
+    // same size again, shares the image
+    cxt->DrawImage(10, 200, RelativeURLToLocalPath(PDFWRITE_SOURCE_PATH, "data/images/otherStage.JPG"), options);
+
+    // 862x862 RGBA png, in 100x100 points
+    options.boundingBoxWidth = 100;
+    options.boundingBoxHeight = 100;
+    cxt->DrawImage(250, 10, RelativeURLToLocalPath(PDFWRITE_SOURCE_PATH, "data/images/png/original.png"), options);
+
+    // 1024x768 interlaced RGB png, in 128x96 points
+    options.boundingBoxWidth = 128;
+    options.boundingBoxHeight = 96;
+    cxt->DrawImage(250, 200, RelativeURLToLocalPath(PDFWRITE_SOURCE_PATH, "data/images/png/pnglogo-grr.png"),
+                   options);
+
+    // 550x350 jpg at its natural size, already below the target resolution
+    cxt->DrawImage(10, 400, RelativeURLToLocalPath(PDFWRITE_SOURCE_PATH, "data/images/soundcloud_logo.jpg"));
+
+    status = pdfWriter.EndPageContentContext(cxt);
+    if (status != eSuccess)
+        return status;
+    status = pdfWriter.WritePage(page);
+    if (status != eSuccess)
+        return status;
+    return pdfWriter.EndPDF();
+}
+
+// sizes of the color images, masks excluded
+SizesVector ReadImageSizes(const std::string &inPDFPath)
+{
+    SizesVector sizes;
+    InputFile pdfFile;
+    PDFParser parser;
+
+    if (pdfFile.OpenFile(inPDFPath) != eSuccess || parser.StartPDFParsing(pdfFile.GetInputStream()) != eSuccess)
+        return sizes;
+
+    for (ObjectIDType i = 1; i < parser.GetObjectsCount(); ++i)
+    {
+        PDFObjectCastPtr<charta::PDFStreamInput> stream(parser.ParseNewObject(i));
+        if (!stream)
+            continue;
+        std::shared_ptr<PDFDictionary> dictionary = stream->QueryStreamDictionary();
+        PDFObjectCastPtr<charta::PDFName> subtype(dictionary->QueryDirectObject("Subtype"));
+        PDFObjectCastPtr<charta::PDFName> colorSpace(dictionary->QueryDirectObject("ColorSpace"));
+        if (!subtype || subtype->GetValue() != "Image" || (!!colorSpace && colorSpace->GetValue() == "DeviceGray"))
+            continue;
+
+        PDFObjectCastPtr<PDFInteger> width(dictionary->QueryDirectObject("Width"));
+        PDFObjectCastPtr<PDFInteger> height(dictionary->QueryDirectObject("Height"));
+        sizes.emplace_back(width->GetValue(), height->GetValue());
+    }
+    return sizes;
+}
+
+long long GetFileSize(const std::string &inPath)
+{
+    FILE *file = fopen(inPath.c_str(), "rb");
+    if (file == nullptr)
+        return -1;
+    fseek(file, 0, SEEK_END);
+    long long size = ftell(file);
+    fclose(file);
+    return size;
+}
+} // namespace
+
+TEST(PDFImages, ImageDownsampling)
+{
+    std::string originalPath = RelativeURLToLocalPath(PDFWRITE_BINARY_PATH, "ImageDownsamplingOriginal.pdf");
+    std::string downsampledPath = RelativeURLToLocalPath(PDFWRITE_BINARY_PATH, "ImageDownsampling.pdf");
+
+    ASSERT_EQ(WriteImagesDocument(originalPath, 0), eSuccess);
+    ASSERT_EQ(WriteImagesDocument(downsampledPath, 144), eSuccess);
+
+    SizesVector originalSizes = ReadImageSizes(originalPath);
+    SizesVector downsampledSizes = ReadImageSizes(downsampledPath);
+    ASSERT_EQ(originalSizes.size(), 4);
+    ASSERT_EQ(downsampledSizes.size(), 4);
+
+    // 144 pixels per inch at the drawn size, twice the points
+    SizesVector expected = {{400, 300}, {200, 200}, {256, 192}, {550, 350}};
+    for (auto &size : expected)
+        EXPECT_NE(std::find(downsampledSizes.begin(), downsampledSizes.end(), size), downsampledSizes.end())
+            << size.first << "x" << size.second;
+
+    EXPECT_LT(GetFileSize(downsampledPath) * 4, GetFileSize(originalPath));
+}
+
+TEST(PDFImages, DownsamplePixels)
+{
+    // 4x2 RGB, averaged to 2x1
+    PixelsBuffer source;
+    source.Width = 4;
+    source.Height = 2;
+    source.Layout = ePixelsLayoutRGB;
+    source.Pixels = {0,  0,  0,  10, 20, 30, 100, 100, 100, 200, 200, 200,
+                     10, 20, 30, 20, 40, 60, 100, 100, 100, 200, 200, 200};
+
+    PixelsBuffer target = DownsamplePixels(source, 2, 1);
+    EXPECT_EQ(target.Width, 2);
+    EXPECT_EQ(target.Height, 1);
+    EXPECT_EQ(target.Layout, ePixelsLayoutRGB);
+    EXPECT_EQ(target.Pixels, std::vector<uint8_t>({10, 20, 30, 150, 150, 150}));
+
+    // 3 to 2 spreads the middle pixel between both
+    source.Width = 3;
+    source.Height = 1;
+    source.Layout = ePixelsLayoutGray;
+    source.Pixels = {0, 90, 180};
+    target = DownsamplePixels(source, 2, 1);
+    EXPECT_EQ(target.Pixels, std::vector<uint8_t>({30, 150}));
+
+    // same size is a copy
+    target = DownsamplePixels(source, 3, 1);
+    EXPECT_EQ(target.Pixels, source.Pixels);
+}
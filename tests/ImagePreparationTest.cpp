@@ -0,0 +1,205 @@
+/*
+   Source File : ImagePreparationTest.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "PDFPage.h"
+#include "PDFWriter.h"
+#include "PageContentContext.h"
+#include "TestHelper.h"
+#include "io/InputFile.h"
+#include "objects/PDFDictionary.h"
+#include "objects/PDFIndirectObjectReference.h"
+#include "objects/PDFInteger.h"
+#include "objects/PDFName.h"
+#include "objects/PDFObjectCast.h"
+#include "objects/PDFStreamInput.h"
+#include "parsing/PDFParser.h"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <tuple>
+#include <vector>
+
+using namespace charta;
+
+namespace
+{
+typedef std::tuple<long long, long long, std::vector<uint8_t>> ImageSamples;
+
+EStatusCode WriteImagesDocument(const std::string &inOutputPath, unsigned int inPreparationThreads)
+{
+    PDFWriter pdfWriter;
+    PDFCreationSettings settings(true, true);
+    settings.ImageTargetResolution = 144;
+    settings.ImagePreparationThreads = inPreparationThreads;
+
+    EStatusCode status = pdfWriter.StartPDF(inOutputPath, ePDFVersion14, LogConfiguration::DefaultLogConfiguration(),
+                                            settings);
+    if (status != eSuccess)
+        return status;
+
+    // no interlaced png here. drawn in place those come out of a single row buffer, and so won't match the prepared
+    // ones, that are read whole
+    const char *images[] = {"data/images/otherStage.JPG", "data/images/soundcloud_logo.jpg",
+                            "data/images/png/original.png", "data/images/png/gray-alpha-8-linear.png",
+                            "data/images/png/gray-16-linear.png", "data/XObjectContent.pdf"};
+
+    for (int pageIndex = 0; pageIndex < 2 && status == eSuccess; ++pageIndex)
+    {
+        PDFPage page;
+        page.SetMediaBox(charta::PagePresets::A4_Portrait);
+        PageContentContext *cxt = pdfWriter.StartPageContentContext(page);
+
+        // natural size on the first page, smaller on the second, so both kept and downsampled images are prepared
+        AbstractContentContext::ImageOptions options;
+        if (pageIndex == 1)
+        {
+            options.transformationMethod = AbstractContentContext::eFit;
+            options.fitProportional = true;
+        }
+        for (size_t i = 0; i < sizeof(images) / sizeof(images[0]); ++i)
+        {
+            cxt->DrawImage(10, 10 + 100 * i, RelativeURLToLocalPath(PDFWRITE_SOURCE_PATH, images[i]), options);
+            // again, sharing the image
+            cxt->DrawImage(300, 10 + 100 * i, RelativeURLToLocalPath(PDFWRITE_SOURCE_PATH, images[i]), options);
+        }
+
+        status = pdfWriter.EndPageContentContext(cxt);
+        if (status == eSuccess)
+            status = pdfWriter.WritePage(page);
+    }
+
+    if (status != eSuccess)
+        return status;
+    return pdfWriter.EndPDF();
+}
+
+// decoded samples of all images, masks included, in a stable order
+std::vector<ImageSamples> ReadImages(const std::string &inPDFPath)
+{
+    std::vector<ImageSamples> images;
+    InputFile pdfFile;
+    PDFParser parser;
+
+    if (pdfFile.OpenFile(inPDFPath) != eSuccess || parser.StartPDFParsing(pdfFile.GetInputStream()) != eSuccess)
+        return images;
+
+    for (ObjectIDType i = 1; i < parser.GetObjectsCount(); ++i)
+    {
+        PDFObjectCastPtr<charta::PDFStreamInput> stream(parser.ParseNewObject(i));
+        if (!stream)
+            continue;
+        std::shared_ptr<PDFDictionary> dictionary = stream->QueryStreamDictionary();
+        PDFObjectCastPtr<charta::PDFName> subtype(dictionary->QueryDirectObject("Subtype"));
+        if (!subtype || subtype->GetValue() != "Image")
+            continue;
+
+        PDFObjectCastPtr<PDFInteger> width(dictionary->QueryDirectObject("Width"));
+        PDFObjectCastPtr<PDFInteger> height(dictionary->QueryDirectObject("Height"));
+        std::vector<uint8_t> samples;
+        EXPECT_EQ(parser.DecodeStreamToBuffer(stream, samples), eSuccess) << "object " << i;
+        images.emplace_back(width->GetValue(), height->GetValue(), samples);
+    }
+    std::sort(images.begin(), images.end());
+    return images;
+}
+} // namespace
+
+TEST(PDFImages, ImagePreparation)
+{
+    std::string inPlacePath = RelativeURLToLocalPath(PDFWRITE_BINARY_PATH, "ImagePreparationInPlace.pdf");
+    std::string preparedPath = RelativeURLToLocalPath(PDFWRITE_BINARY_PATH, "ImagePreparation.pdf");
+
+    ASSERT_EQ(WriteImagesDocument(inPlacePath, 0), eSuccess);
+    ASSERT_EQ(WriteImagesDocument(preparedPath, 4), eSuccess);
+
+    // same images, whichever thread decoded them
+    std::vector<ImageSamples> inPlaceImages = ReadImages(inPlacePath);
+    std::vector<ImageSamples> preparedImages = ReadImages(preparedPath);
+    ASSERT_FALSE(inPlaceImages.empty());
+    ASSERT_EQ(inPlaceImages.size(), preparedImages.size());
+    for (size_t i = 0; i < inPlaceImages.size(); ++i)
+    {
+        EXPECT_EQ(std::get<0>(inPlaceImages[i]), std::get<0>(preparedImages[i])) << "image " << i;
+        EXPECT_EQ(std::get<1>(inPlaceImages[i]), std::get<1>(preparedImages[i])) << "image " << i;
+        EXPECT_TRUE(std::get<2>(inPlaceImages[i]) == std::get<2>(preparedImages[i])) << "image " << i;
+    }
+}
+
+TEST(PDFImages, ImagePreparationFallback)
+{
+    std::string outputPath = RelativeURLToLocalPath(PDFWRITE_BINARY_PATH, "ImagePreparationFallback.pdf");
+    std::string imagePath = RelativeURLToLocalPath(PDFWRITE_SOURCE_PATH, "data/images/cmyk.jpg");
+
+    PDFWriter pdfWriter;
+    PDFCreationSettings settings(true, true);
+    settings.ImageTargetResolution = 144;
+    settings.ImagePreparationThreads = 4;
+    ASSERT_EQ(pdfWriter.StartPDF(outputPath, ePDFVersion14, LogConfiguration::DefaultLogConfiguration(), settings),
+              eSuccess);
+
+    // drawn small enough to call for downsampling, which cmyk jpgs don't get. preparing it fails, and the image is
+    // embedded as is instead
+    PDFPage page;
+    page.SetMediaBox(charta::PagePresets::A4_Portrait);
+    PageContentContext *cxt = pdfWriter.StartPageContentContext(page);
+    AbstractContentContext::ImageOptions options;
+    options.transformationMethod = AbstractContentContext::eFit;
+    options.boundingBoxWidth = 50;
+    options.boundingBoxHeight = 50;
+    options.fitProportional = true;
+    cxt->DrawImage(10, 10, imagePath, options);
+    ASSERT_EQ(pdfWriter.EndPageContentContext(cxt), eSuccess);
+    ASSERT_EQ(pdfWriter.WritePage(page), eSuccess);
+    ASSERT_EQ(pdfWriter.EndPDF(), eSuccess);
+
+    InputFile pdfFile;
+    PDFParser parser;
+    ASSERT_EQ(pdfFile.OpenFile(outputPath), eSuccess);
+    ASSERT_EQ(parser.StartPDFParsing(pdfFile.GetInputStream()), eSuccess);
+
+    // the form that the page draws is there, and draws the original image
+    PDFObjectCastPtr<PDFDictionary> resources(parser.QueryDictionaryObject(parser.ParsePage(0), "Resources"));
+    ASSERT_TRUE(!!resources);
+    PDFObjectCastPtr<PDFDictionary> xobjects(parser.QueryDictionaryObject(resources, "XObject"));
+    ASSERT_TRUE(!!xobjects);
+    auto it = xobjects->GetIterator();
+    ASSERT_TRUE(it.MoveNext());
+    PDFObjectCastPtr<PDFIndirectObjectReference> formRef(it.GetValue());
+    ASSERT_TRUE(!!formRef);
+    PDFObjectCastPtr<charta::PDFStreamInput> form(parser.ParseNewObject(formRef->mObjectID));
+    ASSERT_TRUE(!!form);
+    std::shared_ptr<PDFDictionary> formDictionary = form->QueryStreamDictionary();
+    PDFObjectCastPtr<charta::PDFName> subtype(formDictionary->QueryDirectObject("Subtype"));
+    ASSERT_TRUE(!!subtype);
+    EXPECT_EQ(subtype->GetValue(), "Form");
+
+    PDFObjectCastPtr<PDFDictionary> formResources(parser.QueryDictionaryObject(formDictionary, "Resources"));
+    ASSERT_TRUE(!!formResources);
+    PDFObjectCastPtr<PDFDictionary> formXObjects(parser.QueryDictionaryObject(formResources, "XObject"));
+    ASSERT_TRUE(!!formXObjects);
+    auto imageIt = formXObjects->GetIterator();
+    ASSERT_TRUE(imageIt.MoveNext());
+    PDFObjectCastPtr<charta::PDFStreamInput> image(
+        parser.QueryDictionaryObject(formXObjects, imageIt.GetKey()->GetValue()));
+    ASSERT_TRUE(!!image);
+    PDFObjectCastPtr<PDFInteger> width(image->QueryStreamDictionary()->QueryDirectObject("Width"));
+    ASSERT_TRUE(!!width);
+    EXPECT_EQ(width->GetValue(), 256);
+}
@@ -0,0 +1,187 @@
+/*
+   Source File : InputLZWDecodeTest.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "io/InputLZWDecodeStream.h"
+#include "io/InputStringStream.h"
+
+#include <gtest/gtest.h>
+#include <map>
+#include <string>
+
+using namespace charta;
+
+namespace
+{
+// minimal LZW encoder, for round trips. tracks the decoder's table size to know the code length to write with
+class LZWEncoder
+{
+  public:
+    LZWEncoder(int inEarly) : mEarly(inEarly)
+    {
+    }
+
+    std::string Encode(const std::string &inSource)
+    {
+        ClearTable();
+        WriteCode(256);
+        std::string current;
+        for (char c : inSource)
+        {
+            std::string next = current + c;
+            if (current.empty() || mCodes.find(next) != mCodes.end())
+            {
+                current = next;
+                continue;
+            }
+            WriteCode(CodeOf(current));
+            mCodes[next] = mNextCode++;
+            current = std::string(1, c);
+            if (mNextCode == 4094)
+            {
+                WriteCode(256);
+                ClearTable();
+            }
+        }
+        if (!current.empty())
+            WriteCode(CodeOf(current));
+        WriteCode(257);
+        if (mBitCount > 0)
+            mResult.push_back((char)(mBitBuffer << (8 - mBitCount)));
+        return mResult;
+    }
+
+  private:
+    int mEarly;
+    std::map<std::string, int> mCodes;
+    int mNextCode = 258;
+    int mDecoderNextCode = 258;
+    bool mDecoderFirst = true;
+    std::string mResult;
+    uint32_t mBitBuffer = 0;
+    int mBitCount = 0;
+
+    void ClearTable()
+    {
+        mCodes.clear();
+        mNextCode = 258;
+        mDecoderNextCode = 258;
+        mDecoderFirst = true;
+    }
+
+    int CodeOf(const std::string &inSequence)
+    {
+        return inSequence.size() == 1 ? (uint8_t)inSequence[0] : mCodes[inSequence];
+    }
+
+    void WriteCode(int inCode)
+    {
+        int decoderNext = mDecoderNextCode + mEarly;
+        int length = decoderNext >= 2048 ? 12 : (decoderNext >= 1024 ? 11 : (decoderNext >= 512 ? 10 : 9));
+        mBitBuffer = (mBitBuffer << length) | inCode;
+        mBitCount += length;
+        while (mBitCount >= 8)
+        {
+            mBitCount -= 8;
+            mResult.push_back((char)(mBitBuffer >> mBitCount));
+        }
+        mBitBuffer &= (1 << mBitCount) - 1;
+        if (inCode == 256)
+            return;
+        if (!mDecoderFirst)
+            ++mDecoderNextCode;
+        mDecoderFirst = false;
+    }
+};
+
+std::string MakeSource()
+{
+    // runs, repeats and noise, long enough to go through a few table clears
+    std::string source;
+    uint32_t seed = 12345;
+    for (int i = 0; i < 20000; ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        switch ((seed >> 16) % 3)
+        {
+        case 0:
+            source.append((seed >> 8) % 40, (char)(seed >> 24));
+            break;
+        case 1:
+            source.append("the quick brown fox ");
+            break;
+        default:
+            source.push_back((char)(seed >> 20));
+        }
+    }
+    return source;
+}
+
+std::string Decode(const std::string &inEncoded, int inEarly, size_t inReadSize)
+{
+    InputLZWDecodeStream decoder(inEarly);
+    decoder.Assign(new InputStringStream(inEncoded));
+
+    std::string result;
+    std::string buffer(inReadSize, 0);
+    while (decoder.NotEnded())
+    {
+        size_t readBytes = decoder.Read((uint8_t *)&buffer[0], inReadSize);
+        // short reads only at the end of the stream
+        if (readBytes < inReadSize)
+        {
+            EXPECT_FALSE(decoder.NotEnded());
+        }
+        result.append(buffer, 0, readBytes);
+    }
+    return result;
+}
+} // namespace
+
+TEST(PDFEmbedding, InputLZWDecode)
+{
+    std::string source = MakeSource();
+
+    for (int early = 0; early <= 1; ++early)
+    {
+        std::string encoded = LZWEncoder(early).Encode(source);
+        ASSERT_LT(encoded.size(), source.size());
+        for (size_t readSize : {1, 7, 4096, 1 << 20})
+            EXPECT_EQ(Decode(encoded, early, readSize), source) << "early " << early << " read size " << readSize;
+    }
+
+    // the sample from the PDF reference: 45 45 45 45 45 65 45 45 45 66
+    std::string sample("\x80\x0B\x60\x50\x22\x0C\x0C\x85\x01", 9);
+    EXPECT_EQ(Decode(sample, 1, 64), "\x2D\x2D\x2D\x2D\x2D\x41\x2D\x2D\x2D\x42");
+}
+
+TEST(PDFEmbedding, InputLZWDecodeTruncated)
+{
+    std::string source = MakeSource();
+    std::string encoded = LZWEncoder(1).Encode(source);
+
+    // no end of data code - decodes what is there and stops
+    std::string decoded = Decode(encoded.substr(0, encoded.size() / 2), 1, 4096);
+    EXPECT_GT(decoded.size(), 0);
+    EXPECT_EQ(decoded, source.substr(0, decoded.size()));
+
+    // garbage - stops without reading out of the table
+    std::string garbage(1000, '\xff');
+    EXPECT_EQ(Decode(garbage, 1, 4096), "");
+}
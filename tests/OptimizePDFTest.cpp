@@ -0,0 +1,137 @@
+/*
+   Source File : OptimizePDFTest.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "DictionaryContext.h"
+#include "ObjectsContext.h"
+#include "PDFStream.h"
+#include "PDFWriter.h"
+#include "TestHelper.h"
+#include "io/IByteWriter.h"
+#include "io/InputFile.h"
+#include "objects/PDFDictionary.h"
+#include "objects/PDFIndirectObjectReference.h"
+#include "objects/PDFObjectCast.h"
+#include "objects/PDFStreamInput.h"
+#include "parsing/PDFDocumentCopyingContext.h"
+#include "parsing/PDFParser.h"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace charta;
+
+namespace
+{
+// replace the contents of the first page with a new stream, leaving the previous contents unreferenced
+EStatusCode ReplaceFirstPageContents(const std::string &inSourcePath, const std::string &inTargetPath, int inRound)
+{
+    PDFWriter pdfWriter;
+    EStatusCode status = pdfWriter.ModifyPDF(inSourcePath, ePDFVersion13, inTargetPath);
+    if (status != eSuccess)
+        return status;
+
+    ObjectsContext &objectsContext = pdfWriter.GetObjectsContext();
+    PDFParser &modifiedFileParser = pdfWriter.GetModifiedFileParser();
+    auto copyingContext = pdfWriter.CreatePDFCopyingContextForModifiedFile();
+
+    ObjectIDType contentsID = objectsContext.StartNewIndirectObject();
+    std::shared_ptr<PDFStream> contents = objectsContext.StartPDFStream();
+    std::string content = "% round " + std::to_string(inRound) + "\nq 0 0 1 RG 10 10 m " +
+                          std::to_string(100 + inRound) + " 100 l S Q\n";
+    contents->GetWriteStream()->Write((const uint8_t *)content.c_str(), content.size());
+    objectsContext.EndPDFStream(contents);
+
+    ObjectIDType pageID = modifiedFileParser.GetPageObjectID(0);
+    auto page = modifiedFileParser.ParsePage(0);
+    auto it = page->GetIterator();
+
+    objectsContext.StartModifiedIndirectObject(pageID);
+    DictionaryContext *pageDictionary = objectsContext.StartDictionary();
+    while (it.MoveNext())
+    {
+        if (it.GetKey()->GetValue() == "Contents")
+            continue;
+        pageDictionary->WriteKey(it.GetKey()->GetValue());
+        copyingContext->CopyDirectObjectAsIs(it.GetValue());
+    }
+    pageDictionary->WriteKey("Contents");
+    pageDictionary->WriteNewObjectReferenceValue(contentsID);
+    objectsContext.EndDictionary(pageDictionary);
+    objectsContext.EndIndirectObject();
+
+    copyingContext = nullptr;
+    return pdfWriter.EndPDF();
+}
+
+long long FileSize(const std::string &inPath)
+{
+    InputFile file;
+    if (file.OpenFile(inPath) != eSuccess)
+        return -1;
+    return file.GetFileSize();
+}
+} // namespace
+
+TEST(Modification, OptimizePDF)
+{
+    const int rounds = 8;
+    std::string currentPath = RelativeURLToLocalPath(PDFWRITE_SOURCE_PATH, "data/XObjectContent.pdf");
+    for (int i = 0; i < rounds; ++i)
+    {
+        std::string nextPath =
+            RelativeURLToLocalPath(PDFWRITE_BINARY_PATH, "OptimizeRound" + std::to_string(i) + ".pdf");
+        ASSERT_EQ(ReplaceFirstPageContents(currentPath, nextPath, i), eSuccess);
+        currentPath = nextPath;
+    }
+
+    std::string optimizedPath = RelativeURLToLocalPath(PDFWRITE_BINARY_PATH, "OptimizedPDF.pdf");
+    ASSERT_EQ(PDFWriter::OptimizePDF(currentPath, optimizedPath, LogConfiguration::DefaultLogConfiguration(),
+                                     PDFCreationSettings(true, true)),
+              eSuccess);
+
+    EXPECT_LT(FileSize(optimizedPath), FileSize(currentPath));
+
+    InputFile modifiedFile;
+    PDFParser modifiedParser;
+    ASSERT_EQ(modifiedFile.OpenFile(currentPath), eSuccess);
+    ASSERT_EQ(modifiedParser.StartPDFParsing(modifiedFile.GetInputStream()), eSuccess);
+
+    InputFile optimizedFile;
+    PDFParser optimizedParser;
+    ASSERT_EQ(optimizedFile.OpenFile(optimizedPath), eSuccess);
+    ASSERT_EQ(optimizedParser.StartPDFParsing(optimizedFile.GetInputStream()), eSuccess);
+
+    // single revision, with the dropped contents gone and every object in use
+    EXPECT_EQ(optimizedParser.GetPagesCount(), modifiedParser.GetPagesCount());
+    EXPECT_LE(optimizedParser.GetXrefSize() + rounds, modifiedParser.GetXrefSize());
+    EXPECT_FALSE(optimizedParser.GetTrailer()->Exists("Prev"));
+    for (ObjectIDType i = 1; i < optimizedParser.GetXrefSize(); ++i)
+        EXPECT_NE(optimizedParser.ParseNewObject(i), nullptr) << "object " << i;
+
+    // and the first page shows the last revision
+    PDFObjectCastPtr<charta::PDFStreamInput> contents(
+        optimizedParser.QueryDictionaryObject(optimizedParser.ParsePage(0), "Contents"));
+    ASSERT_TRUE(!!contents);
+    std::vector<uint8_t> decoded;
+    ASSERT_EQ(optimizedParser.DecodeStreamToBuffer(contents, decoded), eSuccess);
+    std::string decodedText(decoded.begin(), decoded.end());
+    EXPECT_EQ(decodedText.find("% round " + std::to_string(rounds - 1)), 0);
+}
@@ -0,0 +1,117 @@
+/*
+   Source File : OutputAsyncFileStreamTest.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "PDFPage.h"
+#include "PDFWriter.h"
+#include "PageContentContext.h"
+#include "PagePresets.h"
+#include "TestHelper.h"
+#include "io/InputFile.h"
+#include "io/OutputAsyncFileStream.h"
+#include "io/OutputStreamTraits.h"
+#include "io/OutputStringBufferStream.h"
+#include "parsing/PDFParser.h"
+
+#include <errno.h>
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace charta;
+
+static std::string ReadFile(const std::string &inFilePath)
+{
+    InputFile file;
+    EXPECT_EQ(file.OpenFile(inFilePath), eSuccess);
+    OutputStringBufferStream content;
+    OutputStreamTraits traits(&content);
+    traits.CopyToOutputStream(file.GetInputStream());
+    return content.ToString();
+}
+
+TEST(IO, OutputAsyncFileStream)
+{
+    std::string path = RelativeURLToLocalPath(PDFWRITE_BINARY_PATH, "OutputAsyncFileStreamTest.txt");
+    std::string expected;
+
+    {
+        // small buffers, so writing goes through many of them
+        OutputAsyncFileStream stream(100, 3);
+        ASSERT_EQ(stream.Open(path), eSuccess);
+        for (int i = 0; i < 1000; ++i)
+        {
+            std::string line = "line " + std::to_string(i) + "\n";
+            EXPECT_EQ(stream.Write((const uint8_t *)line.c_str(), line.size()), line.size());
+            expected += line;
+        }
+        EXPECT_EQ(stream.GetCurrentPosition(), (long long)expected.size());
+        EXPECT_EQ(stream.Close(), eSuccess);
+    }
+    EXPECT_EQ(ReadFile(path), expected);
+
+    {
+        OutputAsyncFileStream stream;
+        ASSERT_EQ(stream.Open(path, true, true), eSuccess);
+        EXPECT_EQ(stream.GetCurrentPosition(), (long long)expected.size());
+        stream.Write((const uint8_t *)"appended", 8);
+        EXPECT_EQ(stream.Close(), eSuccess);
+    }
+    EXPECT_EQ(ReadFile(path), expected + "appended");
+
+#ifdef __linux__
+    {
+        // failed writes show at close
+        OutputAsyncFileStream stream(16);
+        ASSERT_EQ(stream.Open("/dev/full"), eSuccess);
+        for (int i = 0; i < 10; ++i)
+            stream.Write((const uint8_t *)expected.c_str(), 10);
+        EXPECT_EQ(stream.Close(), eFailure);
+        EXPECT_EQ(stream.GetError(), ENOSPC);
+    }
+#endif
+}
+
+TEST(PDF, AsynchronousFileOutput)
+{
+    std::string path = RelativeURLToLocalPath(PDFWRITE_BINARY_PATH, "AsynchronousFileOutput.pdf");
+
+    PDFWriter pdfWriter;
+    PDFCreationSettings settings(true, true);
+    settings.AsynchronousFileOutput = true;
+    settings.SyncFileOnClose = true;
+    ASSERT_EQ(pdfWriter.StartPDF(path, ePDFVersion13, LogConfiguration::DefaultLogConfiguration(), settings),
+              eSuccess);
+    for (int i = 0; i < 20; ++i)
+    {
+        PDFPage page;
+        page.SetMediaBox(charta::PagePresets::A4_Portrait);
+        auto contentContext = pdfWriter.StartPageContentContext(page);
+        for (int j = 0; j < 200; ++j)
+            contentContext->DrawRectangle(j, j, 100, 100);
+        ASSERT_EQ(pdfWriter.EndPageContentContext(contentContext), eSuccess);
+        ASSERT_EQ(pdfWriter.WritePage(page), eSuccess);
+    }
+    ASSERT_EQ(pdfWriter.EndPDF(), eSuccess);
+
+    InputFile pdfFile;
+    PDFParser parser;
+    ASSERT_EQ(pdfFile.OpenFile(path), eSuccess);
+    ASSERT_EQ(parser.StartPDFParsing(pdfFile.GetInputStream()), eSuccess);
+    EXPECT_EQ(parser.GetPagesCount(), 20);
+}
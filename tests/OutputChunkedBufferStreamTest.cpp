@@ -0,0 +1,133 @@
+/*
+   Source File : OutputChunkedBufferStreamTest.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "PDFPage.h"
+#include "PDFWriter.h"
+#include "PageContentContext.h"
+#include "PagePresets.h"
+#include "TestHelper.h"
+#include "io/BufferChunkPool.h"
+#include "io/InputFile.h"
+#include "io/InputStringStream.h"
+#include "io/OutputChunkedBufferStream.h"
+#include "io/OutputStringBufferStream.h"
+#include "parsing/PDFParser.h"
+
+#include <gtest/gtest.h>
+#include <string>
+
+#if !defined(_WIN32) && !defined(__WIN32__) && !defined(WIN32)
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+using namespace charta;
+
+TEST(IO, OutputChunkedBufferStream)
+{
+    BufferChunkPool pool(16, 4);
+    std::string expected;
+
+    {
+        OutputChunkedBufferStream stream(&pool);
+        for (int i = 0; i < 20; ++i)
+        {
+            // writes of varying sizes, crossing chunk boundaries
+            std::string piece(i % 7 + 1, (char)('a' + i));
+            stream.Write((const uint8_t *)piece.c_str(), piece.size());
+            expected += piece;
+        }
+        EXPECT_EQ(stream.GetCurrentPosition(), (long long)expected.size());
+        EXPECT_EQ(stream.ToString(), expected);
+
+        OutputStringBufferStream target;
+        EXPECT_EQ(stream.CopyToOutputStream(&target), expected.size());
+        EXPECT_EQ(target.ToString(), expected);
+
+        // chunks go back to the pool, up to its limit
+        stream.Reset();
+        EXPECT_EQ(stream.GetCurrentPosition(), 0);
+        EXPECT_EQ(stream.ToString(), "");
+        EXPECT_EQ(pool.GetPooledChunksCount(), 4);
+
+        // and are reused by the next write
+        stream.Write((const uint8_t *)expected.c_str(), 40);
+        EXPECT_EQ(pool.GetPooledChunksCount(), 1);
+        EXPECT_EQ(stream.ToString(), expected.substr(0, 40));
+    }
+    EXPECT_EQ(pool.GetPooledChunksCount(), 4);
+
+    pool.Trim();
+    EXPECT_EQ(pool.GetPooledChunksCount(), 0);
+}
+
+TEST(PDF, ChunkedBufferOutput)
+{
+    // a document written straight into pooled chunks, as for a response body
+    BufferChunkPool pool(1024);
+    OutputChunkedBufferStream pdfStream(&pool);
+    PDFWriter pdfWriter;
+
+    ASSERT_EQ(pdfWriter.StartPDFForStream(&pdfStream, ePDFVersion13), eSuccess);
+    for (int i = 0; i < 5; ++i)
+    {
+        PDFPage page;
+        page.SetMediaBox(charta::PagePresets::A4_Portrait);
+        auto contentContext = pdfWriter.StartPageContentContext(page);
+        for (int j = 0; j < 100; ++j)
+            contentContext->DrawRectangle(j, j, 100, 100);
+        ASSERT_EQ(pdfWriter.EndPageContentContext(contentContext), eSuccess);
+        ASSERT_EQ(pdfWriter.WritePage(page), eSuccess);
+    }
+    ASSERT_EQ(pdfWriter.EndPDFForStream(), eSuccess);
+
+    ConstBytesSegmentVector segments = pdfStream.GetSegments();
+    EXPECT_EQ(segments.size(), pdfStream.GetSegmentsCount());
+    EXPECT_GT(segments.size(), 1);
+    std::string joined;
+    for (const auto &segment : segments)
+    {
+        EXPECT_LE(segment.second, pool.GetChunkSize());
+        joined.append((const char *)segment.first, segment.second);
+    }
+    EXPECT_EQ(joined, pdfStream.ToString());
+
+#if !defined(_WIN32) && !defined(__WIN32__) && !defined(WIN32)
+    // segments map directly to an iovec array
+    std::string path = RelativeURLToLocalPath(PDFWRITE_BINARY_PATH, "ChunkedBufferOutput.pdf");
+    std::vector<struct iovec> vectors;
+    for (const auto &segment : segments)
+        vectors.push_back({(void *)segment.first, segment.second});
+    int descriptor = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    ASSERT_GE(descriptor, 0);
+    EXPECT_EQ(writev(descriptor, vectors.data(), (int)vectors.size()), (ssize_t)joined.size());
+    close(descriptor);
+
+    InputFile pdfFile;
+    ASSERT_EQ(pdfFile.OpenFile(path), eSuccess);
+    EXPECT_EQ(pdfFile.GetFileSize(), (long long)joined.size());
+#endif
+
+    InputStringStream pdfContent(joined);
+    PDFParser parser;
+    ASSERT_EQ(parser.StartPDFParsing(&pdfContent), eSuccess);
+    EXPECT_EQ(parser.GetPagesCount(), 5);
+}
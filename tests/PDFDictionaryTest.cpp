@@ -0,0 +1,133 @@
+/*
+   Source File : PDFDictionaryTest.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "objects/PDFDictionary.h"
+#include "TestHelper.h"
+#include "io/AdapterIByteReaderWithPositionToIReadPositionProvider.h"
+#include "io/InputFile.h"
+#include "io/InputStringStream.h"
+#include "objects/PDFArray.h"
+#include "objects/PDFInteger.h"
+#include "objects/PDFName.h"
+#include "objects/PDFNameTable.h"
+#include "objects/PDFObjectCast.h"
+#include "parsing/PDFObjectParser.h"
+#include "parsing/PDFParser.h"
+
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace charta;
+
+static std::shared_ptr<PDFObject> ParseString(PDFObjectParser &inParser, InputStringStream &inStream,
+                                              AdapterIByteReaderWithPositionToIReadPositionProvider &inPosition,
+                                              const std::string &inSource)
+{
+    inStream.Assign(inSource);
+    inPosition.Assign(&inStream);
+    inParser.SetReadStream(&inStream, &inPosition);
+    return inParser.ParseNewObject();
+}
+
+TEST(Parsing, PDFNameInterning)
+{
+    PDFObjectParser parser;
+    InputStringStream stream;
+    AdapterIByteReaderWithPositionToIReadPositionProvider position;
+
+    std::string source = "[/Type /Custom#20Name /Type /Custom#20Name /Other]";
+    PDFObjectCastPtr<PDFArray> anArray(ParseString(parser, stream, position, source));
+    ASSERT_TRUE(!!anArray);
+    ASSERT_EQ(anArray->GetLength(), 5);
+
+    // equal names are the same object, and well known ones are the process wide atoms
+    EXPECT_EQ(anArray->QueryObject(0), anArray->QueryObject(2));
+    EXPECT_EQ(anArray->QueryObject(0), PDFNameTable::WellKnown(ePDFNameType));
+    EXPECT_EQ(anArray->QueryObject(1), anArray->QueryObject(3));
+    EXPECT_EQ(std::static_pointer_cast<charta::PDFName>(anArray->QueryObject(1))->GetValue(), "Custom Name");
+    EXPECT_FALSE(std::static_pointer_cast<charta::PDFName>(anArray->QueryObject(4))->IsWellKnown());
+}
+
+TEST(Parsing, PDFDictionaryLookup)
+{
+    PDFObjectParser parser;
+    InputStringStream stream;
+    AdapterIByteReaderWithPositionToIReadPositionProvider position;
+
+    PDFObjectCastPtr<PDFDictionary> small(
+        ParseString(parser, stream, position, "<</Type /Page /Length 12 /Custom 3 /Length 13>>"));
+    ASSERT_TRUE(!!small);
+
+    // duplicate keys keep the first value
+    EXPECT_EQ(small->GetLength(), 3);
+    PDFObjectCastPtr<PDFInteger> length(small->QueryDirectObject(ePDFNameLength));
+    ASSERT_TRUE(!!length);
+    EXPECT_EQ(length->GetValue(), 12);
+    EXPECT_TRUE(small->Exists("Custom"));
+    EXPECT_TRUE(small->Exists(ePDFNameType));
+    EXPECT_FALSE(small->Exists(ePDFNameFilter));
+    EXPECT_EQ(small->QueryDirectObject("Missing"), nullptr);
+
+    // a key that is not interned still matches the atom
+    PDFDictionary manual;
+    manual.Insert(std::make_shared<charta::PDFName>("Kids"), std::make_shared<PDFInteger>(1));
+    EXPECT_NE(manual.QueryDirectObject(ePDFNameKids), nullptr);
+    EXPECT_EQ(manual.QueryDirectObject(ePDFNameType), nullptr);
+
+    // large dictionaries go through the hash index
+    std::stringstream source;
+    source << "<<";
+    for (int i = 0; i < 100; ++i)
+        source << "/Key" << i << " " << i << " ";
+    source << "/Filter 100 /Key5 1000>>";
+    PDFObjectCastPtr<PDFDictionary> large(ParseString(parser, stream, position, source.str()));
+    ASSERT_TRUE(!!large);
+    EXPECT_EQ(large->GetLength(), 101);
+    for (int i = 0; i < 100; ++i)
+    {
+        PDFObjectCastPtr<PDFInteger> value(large->QueryDirectObject("Key" + std::to_string(i)));
+        ASSERT_TRUE(!!value);
+        EXPECT_EQ(value->GetValue(), i);
+    }
+    PDFObjectCastPtr<PDFInteger> filter(large->QueryDirectObject(ePDFNameFilter));
+    ASSERT_TRUE(!!filter);
+    EXPECT_EQ(filter->GetValue(), 100);
+
+    // iteration follows the source order
+    auto it = large->GetIterator();
+    ASSERT_TRUE(it.MoveNext());
+    EXPECT_EQ(it.GetKey()->GetValue(), "Key0");
+}
+
+TEST(Parsing, PDFNameTableReset)
+{
+    InputFile pdfFile;
+    PDFParser parser;
+
+    ASSERT_EQ(pdfFile.OpenFile(RelativeURLToLocalPath(PDFWRITE_SOURCE_PATH, "data/AddedPage.pdf")), eSuccess);
+    ASSERT_EQ(parser.StartPDFParsing(pdfFile.GetInputStream()), eSuccess);
+    for (ObjectIDType i = 1; i < parser.GetXrefSize(); ++i)
+        parser.ParseNewObject(i);
+    EXPECT_GT(parser.GetObjectParser().GetNameTable().GetSize(), 0);
+
+    // a parser reused for another document starts with no names
+    parser.ResetParser();
+    EXPECT_EQ(parser.GetObjectParser().GetNameTable().GetSize(), 0);
+}
@@ -0,0 +1,105 @@
+/*
+   Source File : PDFObjectArenaTest.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "objects/PDFObjectArena.h"
+#include "TestHelper.h"
+#include "io/InputFile.h"
+#include "objects/PDFArray.h"
+#include "objects/PDFDictionary.h"
+#include "objects/PDFInteger.h"
+#include "objects/PDFObjectCast.h"
+#include "parsing/PDFParser.h"
+
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace charta;
+
+TEST(Parsing, PDFObjectArena)
+{
+    InputFile pdfFile;
+    PDFParser parser;
+
+    ASSERT_EQ(pdfFile.OpenFile(RelativeURLToLocalPath(PDFWRITE_SOURCE_PATH, "data/AddedPage.pdf")), eSuccess);
+    ASSERT_EQ(parser.StartPDFParsing(pdfFile.GetInputStream()), eSuccess);
+
+    std::vector<std::shared_ptr<PDFObject>> heapObjects;
+    for (ObjectIDType i = 1; i < parser.GetXrefSize(); ++i)
+        heapObjects.push_back(parser.ParseNewObject(i));
+
+    auto arena = std::make_shared<PDFObjectArena>();
+    parser.SetObjectArena(arena);
+    EXPECT_EQ(parser.GetObjectArena(), arena);
+
+    std::vector<std::shared_ptr<PDFObject>> arenaObjects;
+    for (ObjectIDType i = 1; i < parser.GetXrefSize(); ++i)
+        arenaObjects.push_back(parser.ParseNewObject(i));
+    EXPECT_GT(arena->GetAllocatedSize(), 0);
+
+    // same graph, whichever the allocation
+    ASSERT_EQ(heapObjects.size(), arenaObjects.size());
+    for (size_t i = 0; i < heapObjects.size(); ++i)
+    {
+        ASSERT_EQ(heapObjects[i] == nullptr, arenaObjects[i] == nullptr) << "object " << i + 1;
+        if (heapObjects[i] == nullptr)
+            continue;
+        EXPECT_EQ(heapObjects[i]->GetType(), arenaObjects[i]->GetType());
+        if (heapObjects[i]->GetType() == PDFObject::ePDFObjectDictionary)
+        {
+            EXPECT_EQ(std::static_pointer_cast<PDFDictionary>(heapObjects[i])->GetLength(),
+                      std::static_pointer_cast<PDFDictionary>(arenaObjects[i])->GetLength());
+        }
+    }
+    EXPECT_EQ(parser.GetPagesCount(), 4);
+
+    // objects don't own the arena, the parser keeps it after moving on to another one, until it is reset
+    std::weak_ptr<PDFObjectArena> weakArena(arena);
+    parser.SetObjectArena(nullptr);
+    arena.reset();
+    EXPECT_FALSE(weakArena.expired());
+    for (auto &object : arenaObjects)
+    {
+        if (object != nullptr && object->GetType() == PDFObject::ePDFObjectDictionary)
+        {
+            EXPECT_TRUE(std::static_pointer_cast<PDFDictionary>(object)->GetIterator().MoveNext());
+        }
+    }
+    arenaObjects.clear();
+    parser.ResetParser();
+    EXPECT_TRUE(weakArena.expired());
+}
+
+TEST(Parsing, PDFObjectArenaContainers)
+{
+    auto arena = std::make_shared<PDFObjectArena>(1024);
+
+    auto anArray = arena->Make<PDFArray>();
+    for (int i = 0; i < 100; ++i)
+        anArray->AppendObject(arena->Make<PDFInteger>(i));
+    ASSERT_EQ(anArray->GetLength(), 100);
+    PDFObjectCastPtr<PDFInteger> last(anArray->QueryObject(99));
+    ASSERT_TRUE(!!last);
+    EXPECT_EQ(last->GetValue(), 99);
+    EXPECT_GE(arena->GetAllocatedSize(), 100 * sizeof(PDFInteger));
+
+    // no metadata, no map
+    EXPECT_EQ(anArray->GetMetadata("missing"), nullptr);
+    EXPECT_EQ(anArray->DetachMetadata("missing"), nullptr);
+}
@@ -0,0 +1,128 @@
+/*
+   Source File : PDFParserReaderTest.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "parsing/PDFParserReader.h"
+#include "TestHelper.h"
+#include "io/InputFile.h"
+#include "objects/PDFArray.h"
+#include "objects/PDFDictionary.h"
+#include "objects/PDFObjectCast.h"
+#include "objects/PDFStreamInput.h"
+#include "parsing/PDFParser.h"
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace charta;
+
+namespace
+{
+// number of objects in the page contents, as a digest of parsing the page and decoding its streams
+template <class Reader> long CountContentObjects(Reader &inReader, unsigned long inPageIndex)
+{
+    auto page = inReader.ParsePage(inPageIndex);
+    if (!page)
+        return -1;
+
+    auto contents = inReader.QueryDictionaryObject(page, ePDFNameContents);
+    if (!contents)
+        return 0;
+
+    std::unique_ptr<PDFObjectParser> objectsParser;
+    if (contents->GetType() == PDFObject::ePDFObjectStream)
+        objectsParser.reset(
+            inReader.StartReadingObjectsFromStream(std::static_pointer_cast<charta::PDFStreamInput>(contents)));
+    else if (contents->GetType() == PDFObject::ePDFObjectArray)
+        objectsParser.reset(
+            inReader.StartReadingObjectsFromStreams(std::static_pointer_cast<charta::PDFArray>(contents)));
+    if (!objectsParser)
+        return -1;
+
+    long count = 0;
+    while (objectsParser->ParseNewObject() != nullptr)
+        ++count;
+    return count;
+}
+
+void ReadConcurrently(const std::string &inFileName)
+{
+    InputFile pdfFile;
+    PDFParser parser;
+
+    ASSERT_EQ(pdfFile.OpenFile(RelativeURLToLocalPath(PDFWRITE_SOURCE_PATH, inFileName)), eSuccess);
+    ASSERT_EQ(parser.StartPDFParsing(pdfFile.GetInputStream()), eSuccess);
+    ASSERT_GT(parser.GetPagesCount(), 0);
+
+    std::vector<long> expected;
+    for (unsigned long i = 0; i < parser.GetPagesCount(); ++i)
+        expected.push_back(CountContentObjects(parser, i));
+    ASSERT_GT(expected[0], 0);
+    std::vector<PDFObject::EPDFObjectType> expectedTypes;
+    for (ObjectIDType i = 0; i < parser.GetXrefSize(); ++i)
+    {
+        auto anObject = parser.ParseNewObject(i);
+        expectedTypes.push_back(anObject == nullptr ? PDFObject::ePDFObjectNull : anObject->GetType());
+    }
+
+    // odd threads read through the parser stream, even ones with positional reads
+    const int threadsCount = 4;
+    std::vector<int> failures(threadsCount, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadsCount; ++t)
+    {
+        threads.emplace_back([&, t]() {
+            PDFParserReader reader(&parser, t % 2 == 0 ? pdfFile.GetPositionalReader() : nullptr);
+            for (int round = 0; round < 5; ++round)
+            {
+                for (unsigned long i = 0; i < parser.GetPagesCount(); ++i)
+                {
+                    // start at different pages so threads don't go in lockstep
+                    unsigned long pageIndex = (i + t) % parser.GetPagesCount();
+                    if (CountContentObjects(reader, pageIndex) != expected[pageIndex])
+                        ++failures[t];
+                }
+                for (ObjectIDType i = 0; i < parser.GetXrefSize(); ++i)
+                {
+                    auto anObject = reader.ParseNewObject(i);
+                    if ((anObject == nullptr ? PDFObject::ePDFObjectNull : anObject->GetType()) != expectedTypes[i])
+                        ++failures[t];
+                }
+            }
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    for (int t = 0; t < threadsCount; ++t)
+        EXPECT_EQ(failures[t], 0) << "thread " << t;
+}
+} // namespace
+
+TEST(Parsing, PDFParserReaderConcurrentReads)
+{
+    ReadConcurrently("data/XObjectContent.pdf");
+}
+
+TEST(Parsing, PDFParserReaderObjectStreams)
+{
+    ReadConcurrently("data/ObjectStreams.pdf");
+}
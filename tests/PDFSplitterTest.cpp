@@ -0,0 +1,216 @@
+/*
+   Source File : PDFSplitterTest.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "PDFSplitter.h"
+#include "DictionaryContext.h"
+#include "DocumentContextExtenderAdapter.h"
+#include "ObjectsContext.h"
+#include "PDFPage.h"
+#include "PDFWriter.h"
+#include "TestHelper.h"
+#include "io/InputFile.h"
+#include "objects/PDFPageInput.h"
+#include "parsing/PDFParser.h"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace charta;
+
+namespace
+{
+// adds the outline, and a Dests dictionary for its named destination, to the catalog
+class OutlineCatalogWriter : public DocumentContextExtenderAdapter
+{
+  public:
+    OutlineCatalogWriter(ObjectIDType inOutlinesID, ObjectIDType inNamedPageID)
+        : mOutlinesID(inOutlinesID), mNamedPageID(inNamedPageID)
+    {
+    }
+
+    EStatusCode OnCatalogWrite(CatalogInformation * /*inCatalogInformation*/,
+                               DictionaryContext *inCatalogDictionaryContext, ObjectsContext *inPDFWriterObjectContext,
+                               DocumentContext * /*inPDFWriterDocumentContext*/) override
+    {
+        inCatalogDictionaryContext->WriteKey("Outlines");
+        inCatalogDictionaryContext->WriteNewObjectReferenceValue(mOutlinesID);
+
+        inCatalogDictionaryContext->WriteKey("Dests");
+        DictionaryContext *dests = inPDFWriterObjectContext->StartDictionary();
+        dests->WriteKey("chapterB");
+        inPDFWriterObjectContext->StartArray();
+        inPDFWriterObjectContext->WriteNewIndirectObjectReference(mNamedPageID);
+        inPDFWriterObjectContext->WriteName("Fit");
+        inPDFWriterObjectContext->EndArray(eTokenSeparatorEndLine);
+        return inPDFWriterObjectContext->EndDictionary(dests);
+    }
+
+  private:
+    ObjectIDType mOutlinesID;
+    ObjectIDType mNamedPageID;
+};
+
+// ten pages, told apart by their width, and an outline marking pages 0, 3 and 7. the items are out of page order, and
+// point at their pages with a GoTo action, a named destination and an explicit destination
+void WriteSourceDocument(const std::string &inPath)
+{
+    PDFWriter pdfWriter;
+    ASSERT_EQ(pdfWriter.StartPDF(inPath, ePDFVersion14), eSuccess);
+
+    std::vector<ObjectIDType> pageIDs;
+    for (int i = 0; i < 10; ++i)
+    {
+        PDFPage page;
+        page.SetMediaBox(PDFRectangle(0, 0, 100 + i, 100));
+        EStatusCodeAndObjectIDType result = pdfWriter.WritePageAndReturnPageID(page);
+        ASSERT_EQ(result.first, eSuccess);
+        pageIDs.push_back(result.second);
+    }
+
+    ObjectsContext &objectsContext = pdfWriter.GetObjectsContext();
+    IndirectObjectsReferenceRegistry &registry = objectsContext.GetInDirectObjectsRegistry();
+    ObjectIDType outlinesID = registry.AllocateNewObjectID();
+    ObjectIDType itemIDs[3] = {registry.AllocateNewObjectID(), registry.AllocateNewObjectID(),
+                               registry.AllocateNewObjectID()};
+
+    objectsContext.StartNewIndirectObject(outlinesID);
+    DictionaryContext *outlines = objectsContext.StartDictionary();
+    outlines->WriteKey("First");
+    outlines->WriteNewObjectReferenceValue(itemIDs[0]);
+    outlines->WriteKey("Last");
+    outlines->WriteNewObjectReferenceValue(itemIDs[2]);
+    outlines->WriteKey("Count");
+    outlines->WriteIntegerValue(3);
+    objectsContext.EndDictionary(outlines);
+    objectsContext.EndIndirectObject();
+
+    const char *titles[3] = {"Chapter C", "Chapter A", "Chapter B"};
+    for (int i = 0; i < 3; ++i)
+    {
+        objectsContext.StartNewIndirectObject(itemIDs[i]);
+        DictionaryContext *item = objectsContext.StartDictionary();
+        item->WriteKey("Title");
+        item->WriteLiteralStringValue(titles[i]);
+        item->WriteKey("Parent");
+        item->WriteNewObjectReferenceValue(outlinesID);
+        if (i > 0)
+        {
+            item->WriteKey("Prev");
+            item->WriteNewObjectReferenceValue(itemIDs[i - 1]);
+        }
+        if (i < 2)
+        {
+            item->WriteKey("Next");
+            item->WriteNewObjectReferenceValue(itemIDs[i + 1]);
+        }
+        if (i == 0)
+        {
+            item->WriteKey("Dest");
+            objectsContext.StartArray();
+            objectsContext.WriteNewIndirectObjectReference(pageIDs[7]);
+            objectsContext.WriteName("Fit");
+            objectsContext.EndArray(eTokenSeparatorEndLine);
+        }
+        else if (i == 1)
+        {
+            item->WriteKey("A");
+            DictionaryContext *action = objectsContext.StartDictionary();
+            action->WriteKey("S");
+            action->WriteNameValue("GoTo");
+            action->WriteKey("D");
+            objectsContext.StartArray();
+            objectsContext.WriteNewIndirectObjectReference(pageIDs[0]);
+            objectsContext.WriteName("Fit");
+            objectsContext.EndArray(eTokenSeparatorEndLine);
+            objectsContext.EndDictionary(action);
+        }
+        else
+        {
+            item->WriteKey("Dest");
+            item->WriteNameValue("chapterB");
+        }
+        objectsContext.EndDictionary(item);
+        objectsContext.EndIndirectObject();
+    }
+
+    OutlineCatalogWriter catalogWriter(outlinesID, pageIDs[3]);
+    pdfWriter.GetDocumentContext().AddDocumentContextExtender(&catalogWriter);
+    ASSERT_EQ(pdfWriter.EndPDF(), eSuccess);
+    pdfWriter.GetDocumentContext().RemoveDocumentContextExtender(&catalogWriter);
+}
+
+// page widths of a written part, which tell which source pages it holds
+std::vector<int> ReadPageWidths(const std::string &inPath)
+{
+    std::vector<int> widths;
+    InputFile file;
+    PDFParser parser;
+    if (file.OpenFile(inPath) != eSuccess || parser.StartPDFParsing(file.GetInputStream()) != eSuccess)
+        return widths;
+    for (unsigned long i = 0; i < parser.GetPagesCount(); ++i)
+    {
+        PDFPageInput page(&parser, parser.ParsePage(i));
+        widths.push_back((int)page.GetMediaBox().UpperRightX - 100);
+    }
+    return widths;
+}
+} // namespace
+
+TEST(PDFEmbedding, PDFSplitter)
+{
+    std::string sourcePath = RelativeURLToLocalPath(PDFWRITE_BINARY_PATH, "SplitterSource.pdf");
+    WriteSourceDocument(sourcePath);
+
+    PDFSplitter splitter;
+    ASSERT_EQ(splitter.Open(sourcePath), eSuccess);
+    EXPECT_EQ(splitter.GetPagesCount(), 10);
+
+    // every 4 pages
+    PDFSplitPartVector parts = splitter.CreatePartsForEveryNPages(4);
+    ASSERT_EQ(parts.size(), 3);
+    for (size_t i = 0; i < parts.size(); ++i)
+        parts[i].OutputPath = RelativeURLToLocalPath(PDFWRITE_BINARY_PATH, "SplitEvery4_" + std::to_string(i) + ".pdf");
+    ASSERT_EQ(splitter.Split(parts, 3), eSuccess);
+    EXPECT_EQ(ReadPageWidths(parts[0].OutputPath), std::vector<int>({0, 1, 2, 3}));
+    EXPECT_EQ(ReadPageWidths(parts[1].OutputPath), std::vector<int>({4, 5, 6, 7}));
+    EXPECT_EQ(ReadPageWidths(parts[2].OutputPath), std::vector<int>({8, 9}));
+
+    // by bookmarks, in page order
+    ASSERT_EQ(splitter.CreatePartsForBookmarks(parts), eSuccess);
+    ASSERT_EQ(parts.size(), 3);
+    EXPECT_EQ(parts[0].Title, "Chapter A");
+    EXPECT_EQ(parts[1].Title, "Chapter B");
+    EXPECT_EQ(parts[2].Title, "Chapter C");
+    for (size_t i = 0; i < parts.size(); ++i)
+        parts[i].OutputPath =
+            RelativeURLToLocalPath(PDFWRITE_BINARY_PATH, "SplitBookmark_" + std::to_string(i) + ".pdf");
+    ASSERT_EQ(splitter.Split(parts, 2), eSuccess);
+    EXPECT_EQ(ReadPageWidths(parts[0].OutputPath), std::vector<int>({0, 1, 2}));
+    EXPECT_EQ(ReadPageWidths(parts[1].OutputPath), std::vector<int>({3, 4, 5, 6}));
+    EXPECT_EQ(ReadPageWidths(parts[2].OutputPath), std::vector<int>({7, 8, 9}));
+
+    // explicit ranges, a bad one failing only its own part
+    parts.resize(2);
+    parts[0].PageRange.mSpecificRanges = {{9, 9}, {0, 1}};
+    parts[1].PageRange.mSpecificRanges = {{5, 12}};
+    EXPECT_EQ(splitter.Split(parts), eFailure);
+    EXPECT_EQ(ReadPageWidths(parts[0].OutputPath), std::vector<int>({9, 0, 1}));
+}
@@ -0,0 +1,135 @@
+/*
+   Source File : PageContentBufferTest.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "PageContentBuffer.h"
+#include "PDFPage.h"
+#include "PDFRectangle.h"
+#include "PDFWriter.h"
+#include "PageContentContext.h"
+#include "TestHelper.h"
+#include "io/InputFile.h"
+#include "objects/PDFDictionary.h"
+#include "objects/PDFObjectCast.h"
+#include "objects/PDFStreamInput.h"
+#include "parsing/PDFParser.h"
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace charta;
+
+static const int scPagesCount = 12;
+static const int scThreadsCount = 4;
+
+static void FillPage(PageContentBuffer *inBuffer, PDFUsedFont *inFont, int inPageIndex)
+{
+    PageContentContext *contentContext = inBuffer->GetContentContext();
+
+    for (int i = 0; i < 50; ++i)
+    {
+        contentContext->q();
+        contentContext->k(0, 0, (i % 10) / 10.0, 1);
+        contentContext->re(50 + i * 2, 100 + i * 3, 200, 20);
+        contentContext->f();
+        contentContext->Q();
+    }
+
+    contentContext->BT();
+    contentContext->k(0, 0, 0, 1);
+    contentContext->Tf(inFont, 14);
+    contentContext->Tm(1, 0, 0, 1, 50, 700);
+    contentContext->Tj("Page " + std::to_string(inPageIndex + 1) + " of the report");
+    contentContext->ET();
+
+    inBuffer->Finalize();
+}
+
+TEST(PDF, PageContentBuffer)
+{
+    std::string outputPath = RelativeURLToLocalPath(PDFWRITE_BINARY_PATH, "PageContentBuffer.pdf");
+
+    {
+        PDFWriter pdfWriter;
+        ASSERT_EQ(pdfWriter.StartPDF(outputPath, ePDFVersion13), eSuccess);
+
+        PDFUsedFont *font =
+            pdfWriter.GetFontForFile(RelativeURLToLocalPath(PDFWRITE_SOURCE_PATH, "data/fonts/arial.ttf"));
+        ASSERT_NE(font, nullptr);
+
+        std::vector<PDFPage> pages(scPagesCount);
+        std::vector<PageContentBuffer *> buffers;
+        for (auto &page : pages)
+        {
+            page.SetMediaBox(charta::PagePresets::A4_Portrait);
+            buffers.push_back(pdfWriter.StartPageContentBuffer(page));
+            ASSERT_NE(buffers.back(), nullptr);
+        }
+
+        // pages are filled out of order and on several threads, and committed in page order
+        std::vector<std::thread> workers;
+        for (int t = 0; t < scThreadsCount; ++t)
+            workers.emplace_back([&, t]() {
+                for (int i = scPagesCount - 1 - t; i >= 0; i -= scThreadsCount)
+                    FillPage(buffers[i], font, i);
+            });
+        for (auto &worker : workers)
+            worker.join();
+
+        for (auto buffer : buffers)
+            ASSERT_EQ(pdfWriter.CommitPageContentBuffer(buffer), eSuccess);
+
+        // a regular page after buffered ones
+        PDFPage lastPage;
+        lastPage.SetMediaBox(charta::PagePresets::A4_Portrait);
+        PageContentContext *contentContext = pdfWriter.StartPageContentContext(lastPage);
+        contentContext->re(50, 50, 100, 100);
+        contentContext->f();
+        ASSERT_EQ(pdfWriter.EndPageContentContext(contentContext), eSuccess);
+        ASSERT_EQ(pdfWriter.WritePage(lastPage), eSuccess);
+
+        // unused reserved IDs are released
+        PDFPage emptyPage;
+        emptyPage.SetMediaBox(charta::PagePresets::A4_Portrait);
+        ASSERT_EQ(pdfWriter.CommitPageContentBuffer(pdfWriter.StartPageContentBuffer(emptyPage, 4)), eSuccess);
+
+        ASSERT_EQ(pdfWriter.EndPDF(), eSuccess);
+    }
+
+    InputFile pdfFile;
+    PDFParser parser;
+    ASSERT_EQ(pdfFile.OpenFile(outputPath), eSuccess);
+    ASSERT_EQ(parser.StartPDFParsing(pdfFile.GetInputStream()), eSuccess);
+    ASSERT_EQ(parser.GetPagesCount(), scPagesCount + 2);
+
+    for (unsigned long i = 0; i < scPagesCount + 1; ++i)
+    {
+        auto page = parser.ParsePage(i);
+        ASSERT_NE(page, nullptr) << "page " << i;
+        PDFObjectCastPtr<charta::PDFStreamInput> contents(parser.QueryDictionaryObject(page, "Contents"));
+        ASSERT_TRUE(!!contents) << "page " << i;
+
+        // content stream decodes fully
+        std::vector<uint8_t> decoded;
+        ASSERT_EQ(parser.DecodeStreamToBuffer(contents, decoded), eSuccess) << "page " << i;
+        EXPECT_FALSE(decoded.empty()) << "page " << i;
+    }
+    EXPECT_EQ(parser.QueryDictionaryObject(parser.ParsePage(scPagesCount + 1), "Contents"), nullptr);
+}
@@ -0,0 +1,148 @@
+/*
+   Source File : PathConstructionTest.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "PDFPage.h"
+#include "PDFWriter.h"
+#include "PageContentContext.h"
+#include "PagePresets.h"
+#include "PrimitiveObjectsWriter.h"
+#include "io/OutputStringBufferStream.h"
+
+#include <functional>
+#include <gtest/gtest.h>
+#include <random>
+#include <stdio.h>
+#include <vector>
+
+using namespace charta;
+
+static std::string FormatReference(double inValue)
+{
+    char buffer[512];
+    snprintf(buffer, sizeof(buffer), "%.6f", inValue);
+    std::string result = buffer;
+    if (result.find('.') != std::string::npos)
+    {
+        result.erase(result.find_last_not_of('0') + 1);
+        if (result.back() == '.')
+            result.pop_back();
+    }
+    return result;
+}
+
+static std::string Format(double inValue)
+{
+    char buffer[PrimitiveObjectsWriter::scMaxDoubleLength];
+    return std::string(buffer, PrimitiveObjectsWriter::FormatDouble(inValue, buffer));
+}
+
+// content stream of a single page, written uncompressed
+static std::string WritePageContent(const std::function<void(PageContentContext *)> &inDraw)
+{
+    OutputStringBufferStream pdfStream;
+    PDFWriter pdfWriter;
+
+    EXPECT_EQ(pdfWriter.StartPDFForStream(&pdfStream, ePDFVersion13, LogConfiguration::DefaultLogConfiguration(),
+                                          PDFCreationSettings(false, true)),
+              eSuccess);
+
+    PDFPage page;
+    page.SetMediaBox(charta::PagePresets::A4_Portrait);
+    PageContentContext *contentContext = pdfWriter.StartPageContentContext(page);
+    inDraw(contentContext);
+    EXPECT_EQ(pdfWriter.EndPageContentContext(contentContext), eSuccess);
+    EXPECT_EQ(pdfWriter.WritePage(page), eSuccess);
+    EXPECT_EQ(pdfWriter.EndPDFForStream(), eSuccess);
+
+    std::string pdf = pdfStream.ToString();
+    size_t start = pdf.find("stream\r\n");
+    size_t end = pdf.find("endstream", start);
+    EXPECT_NE(start, std::string::npos);
+    EXPECT_NE(end, std::string::npos);
+    return pdf.substr(start, end - start);
+}
+
+TEST(PDF, FormatDouble)
+{
+    std::vector<double> values = {0,         -0.0,       1,        -1,          0.5,        1.0 / 3,   -2.0 / 3,
+                                  0.0000004, -0.0000004, 0.000001, 0.0000005,   123.456789, 1e6,       -1e6 - 0.25,
+                                  595.2756,  841.8898,   1e7,      9999999.999, 1e20,       -1.5e300,  2.5e-7};
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> coordinates(-2000, 2000);
+    std::uniform_real_distribution<double> fractions(-1, 1);
+    for (int i = 0; i < 10000; ++i)
+    {
+        values.push_back(coordinates(generator));
+        values.push_back(fractions(generator));
+        values.push_back((float)coordinates(generator));
+    }
+
+    for (double value : values)
+        EXPECT_EQ(Format(value), FormatReference(value)) << value;
+}
+
+TEST(PDF, PathConstructionBulk)
+{
+    std::vector<double> points;
+    for (int i = 0; i < 2000; ++i)
+    {
+        points.push_back(50 + i * 0.25);
+        points.push_back(400 + 100 * (i % 7) / 3.0);
+    }
+    size_t pointsCount = points.size() / 2;
+
+    // bulk operators write exactly what the single operators do
+    std::string single = WritePageContent([&](PageContentContext *inContext) {
+        inContext->m(points[0], points[1]);
+        for (size_t i = 1; i < pointsCount; ++i)
+            inContext->l(points[2 * i], points[2 * i + 1]);
+        inContext->S();
+        inContext->m(points[0], points[1]);
+        for (size_t i = 1; i + 2 < pointsCount; i += 3)
+            inContext->c(points[2 * i], points[2 * i + 1], points[2 * i + 2], points[2 * i + 3], points[2 * i + 4],
+                         points[2 * i + 5]);
+        inContext->S();
+    });
+    std::string bulk = WritePageContent([&](PageContentContext *inContext) {
+        inContext->Polyline(points.data(), pointsCount);
+        inContext->S();
+        inContext->Curves(points.data(), pointsCount);
+        inContext->S();
+    });
+    EXPECT_EQ(single, bulk);
+
+    // floats, and a transform applied to the points
+    std::vector<float> floatPoints = {10, 20, 30, 40, 50, 60, 70, 80};
+    size_t counts[] = {3, 1};
+    double matrix[] = {2, 0, 0, 2, 100, 200};
+    std::string polygons = WritePageContent([&](PageContentContext *inContext) {
+        inContext->Polygons(floatPoints.data(), counts, 2, matrix);
+        inContext->f();
+    });
+    EXPECT_NE(polygons.find("120 240 m\r\n160 280 l\r\n200 320 l\r\nh\r\n240 360 m\r\nh\r\nf\r\n"),
+              std::string::npos);
+
+    // high level path drawing goes through the bulk writer
+    DoubleAndDoublePairList pathPoints = {{10, 10}, {20.5, 10}, {20.5, 30.25}};
+    std::string path = WritePageContent([&](PageContentContext *inContext) {
+        inContext->DrawPath(pathPoints, AbstractContentContext::GraphicOptions(AbstractContentContext::eStroke));
+    });
+    EXPECT_NE(path.find("10 10 m\r\n20.5 10 l\r\n20.5 30.25 l\r\nS\r\n"), std::string::npos);
+}
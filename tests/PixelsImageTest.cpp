@@ -0,0 +1,165 @@
+/*
+   Source File : PixelsImageTest.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "PDFImageXObject.h"
+#include "PDFPage.h"
+#include "PDFWriter.h"
+#include "PageContentContext.h"
+#include "TestHelper.h"
+#include "io/InputFile.h"
+#include "objects/PDFDictionary.h"
+#include "objects/PDFInteger.h"
+#include "objects/PDFObjectCast.h"
+#include "objects/PDFStreamInput.h"
+#include "parsing/PDFParser.h"
+
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace charta;
+
+namespace
+{
+struct PixelsImageSample
+{
+    PixelsImageDescription description;
+    std::vector<uint8_t> pixels;
+    ObjectIDType imageObjectID = 0;
+
+    // expected samples, once color and alpha are apart
+    std::vector<uint8_t> color;
+    std::vector<uint8_t> alpha;
+};
+
+// gradients with a bit of noise, in rows padded to inStride
+void MakeSample(PixelsImageSample &outSample, EPixelsLayout inLayout, uint32_t inWidth, uint32_t inHeight,
+                int inBitsPerComponent, size_t inComponents, size_t inStride, bool inUsePredictors)
+{
+    size_t sampleBytes = inBitsPerComponent == 16 ? 2 : 1;
+    size_t rowBytes = (inWidth * inComponents * inBitsPerComponent + 7) / 8;
+    size_t colorComponents =
+        (inLayout == ePixelsLayoutGrayAlpha || inLayout == ePixelsLayoutRGBA) ? inComponents - 1 : inComponents;
+
+    outSample.pixels.assign(inStride * inHeight, 0xEE);
+    for (uint32_t y = 0; y < inHeight; ++y)
+    {
+        uint8_t *row = outSample.pixels.data() + y * inStride;
+        for (size_t i = 0; i < rowBytes; ++i)
+            row[i] = (uint8_t)(i * 3 + y * 5 + ((i * 7919 + y * 104729) % 13));
+
+        if (inBitsPerComponent < 8)
+        {
+            outSample.color.insert(outSample.color.end(), row, row + rowBytes);
+            continue;
+        }
+        for (uint32_t x = 0; x < inWidth; ++x)
+        {
+            const uint8_t *pixel = row + x * inComponents * sampleBytes;
+            outSample.color.insert(outSample.color.end(), pixel, pixel + colorComponents * sampleBytes);
+            if (colorComponents != inComponents)
+                outSample.alpha.insert(outSample.alpha.end(), pixel + colorComponents * sampleBytes,
+                                       pixel + inComponents * sampleBytes);
+        }
+    }
+
+    outSample.description.Pixels = outSample.pixels.data();
+    outSample.description.Width = inWidth;
+    outSample.description.Height = inHeight;
+    outSample.description.Stride = inStride;
+    outSample.description.Layout = inLayout;
+    outSample.description.BitsPerComponent = inBitsPerComponent;
+    outSample.description.UsePredictors = inUsePredictors;
+}
+} // namespace
+
+TEST(PDFImages, PixelsImage)
+{
+    std::vector<PixelsImageSample> samples(6);
+    MakeSample(samples[0], ePixelsLayoutRGBA, 37, 23, 8, 4, 37 * 4 + 5, true);
+    MakeSample(samples[1], ePixelsLayoutRGB, 40, 30, 8, 3, 40 * 3, false);
+    MakeSample(samples[2], ePixelsLayoutGray, 13, 7, 1, 1, 2, true);
+    MakeSample(samples[3], ePixelsLayoutCMYK, 11, 9, 16, 4, 11 * 8, true);
+    MakeSample(samples[4], ePixelsLayoutGrayAlpha, 17, 5, 16, 2, 17 * 4 + 3, false);
+    MakeSample(samples[5], ePixelsLayoutGray, 21, 4, 4, 1, 16, false);
+
+    std::string outputPath = RelativeURLToLocalPath(PDFWRITE_BINARY_PATH, "PixelsImageTest.pdf");
+    PDFWriter pdfWriter;
+    ASSERT_EQ(pdfWriter.StartPDF(outputPath, ePDFVersion14), eSuccess);
+
+    PDFPage page;
+    page.SetMediaBox(charta::PagePresets::A4_Portrait);
+    PageContentContext *pageContentContext = pdfWriter.StartPageContentContext(page);
+    ASSERT_NE(pageContentContext, nullptr);
+    ASSERT_EQ(pdfWriter.PausePageContentContext(pageContentContext), eSuccess);
+
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        PDFImageXObject *imageXObject = pdfWriter.CreateImageXObjectFromPixels(samples[i].description);
+        ASSERT_NE(imageXObject, nullptr) << "sample " << i;
+        samples[i].imageObjectID = imageXObject->GetImageObjectID();
+
+        pageContentContext->q();
+        pageContentContext->cm(samples[i].description.Width * 4, 0, 0, samples[i].description.Height * 4, 10,
+                               10 + i * 130);
+        pageContentContext->Do(page.GetResourcesDictionary().AddImageXObjectMapping(imageXObject));
+        pageContentContext->Q();
+        delete imageXObject;
+    }
+
+    // bad descriptions fail
+    PixelsImageDescription badDescription = samples[0].description;
+    badDescription.Stride = 10;
+    EXPECT_EQ(pdfWriter.CreateImageXObjectFromPixels(badDescription), nullptr);
+    badDescription = samples[0].description;
+    badDescription.BitsPerComponent = 4;
+    EXPECT_EQ(pdfWriter.CreateImageXObjectFromPixels(badDescription), nullptr);
+
+    ASSERT_EQ(pdfWriter.EndPageContentContext(pageContentContext), eSuccess);
+    ASSERT_EQ(pdfWriter.WritePage(page), eSuccess);
+    ASSERT_EQ(pdfWriter.EndPDF(), eSuccess);
+
+    // read back, and decode to the original samples
+    InputFile pdfFile;
+    PDFParser parser;
+    ASSERT_EQ(pdfFile.OpenFile(outputPath), eSuccess);
+    ASSERT_EQ(parser.StartPDFParsing(pdfFile.GetInputStream()), eSuccess);
+
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        PDFObjectCastPtr<charta::PDFStreamInput> image(parser.ParseNewObject(samples[i].imageObjectID));
+        ASSERT_TRUE(!!image) << "sample " << i;
+        std::shared_ptr<PDFDictionary> imageDictionary = image->QueryStreamDictionary();
+        PDFObjectCastPtr<PDFInteger> width(imageDictionary->QueryDirectObject("Width"));
+        ASSERT_TRUE(!!width);
+        EXPECT_EQ(width->GetValue(), samples[i].description.Width);
+        EXPECT_EQ(imageDictionary->Exists("DecodeParms"), samples[i].description.UsePredictors);
+
+        std::vector<uint8_t> decoded;
+        ASSERT_EQ(parser.DecodeStreamToBuffer(image, decoded), eSuccess);
+        EXPECT_EQ(decoded, samples[i].color) << "sample " << i;
+
+        PDFObjectCastPtr<charta::PDFStreamInput> mask(parser.QueryDictionaryObject(imageDictionary, "SMask"));
+        ASSERT_EQ(!!mask, !samples[i].alpha.empty()) << "sample " << i;
+        if (!mask)
+            continue;
+        ASSERT_EQ(parser.DecodeStreamToBuffer(mask, decoded), eSuccess);
+        EXPECT_EQ(decoded, samples[i].alpha) << "sample " << i;
+    }
+}
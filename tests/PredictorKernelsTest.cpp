@@ -0,0 +1,213 @@
+/*
+   Source File : PredictorKernelsTest.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "io/PredictorKernels.h"
+#include "io/InputPredictorPNGOptimumStream.h"
+#include "io/InputPredictorTIFFSubStream.h"
+#include "io/InputStringStream.h"
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+using namespace charta;
+
+namespace
+{
+std::vector<uint8_t> RandomBytes(size_t inSize, uint32_t inSeed)
+{
+    std::vector<uint8_t> result(inSize);
+    for (auto &value : result)
+    {
+        inSeed = inSeed * 1103515245 + 12345;
+        // some runs, so the predictors see small differences as well as noise
+        value = (inSeed >> 28) < 4 ? (uint8_t)(inSeed >> 16) : (uint8_t)(inSeed >> 29);
+    }
+    return result;
+}
+
+uint8_t Paeth(int inLeft, int inUp, int inUpLeft)
+{
+    int p = inLeft + inUp - inUpLeft;
+    int pa = abs(p - inLeft), pb = abs(p - inUp), pc = abs(p - inUpLeft);
+    if (pa <= pb && pa <= pc)
+        return (uint8_t)inLeft;
+    if (pb <= pc)
+        return (uint8_t)inUp;
+    return (uint8_t)inUpLeft;
+}
+
+// the PNG filter, straight from the spec
+uint8_t Predict(uint8_t inFilterType, const std::vector<uint8_t> &inRow, const std::vector<uint8_t> &inPrior,
+                size_t inIndex, size_t inBytesPerPixel)
+{
+    int left = inIndex >= inBytesPerPixel ? inRow[inIndex - inBytesPerPixel] : 0;
+    int up = inPrior[inIndex];
+    int upLeft = inIndex >= inBytesPerPixel ? inPrior[inIndex - inBytesPerPixel] : 0;
+    switch (inFilterType)
+    {
+    case ePNGFilterSub:
+        return (uint8_t)left;
+    case ePNGFilterUp:
+        return (uint8_t)up;
+    case ePNGFilterAverage:
+        return (uint8_t)((left + up) / 2);
+    case ePNGFilterPaeth:
+        return Paeth(left, up, upLeft);
+    default:
+        return 0;
+    }
+}
+
+std::vector<uint8_t> FilterRow(uint8_t inFilterType, const std::vector<uint8_t> &inRow,
+                               const std::vector<uint8_t> &inPrior, size_t inBytesPerPixel)
+{
+    std::vector<uint8_t> result(inRow.size());
+    for (size_t i = 0; i < inRow.size(); ++i)
+        result[i] = (uint8_t)(inRow[i] - Predict(inFilterType, inRow, inPrior, i, inBytesPerPixel));
+    return result;
+}
+
+std::string ReadAll(IByteReader &inStream, size_t inReadSize)
+{
+    std::string result;
+    std::string buffer(inReadSize, 0);
+    while (inStream.NotEnded())
+    {
+        size_t readBytes = inStream.Read((uint8_t *)&buffer[0], inReadSize);
+        if (readBytes == 0)
+            break;
+        result.append(buffer, 0, readBytes);
+    }
+    return result;
+}
+} // namespace
+
+TEST(PDFEmbedding, PNGUnfilterRow)
+{
+    for (size_t bytesPerPixel = 1; bytesPerPixel <= 8; ++bytesPerPixel)
+    {
+        for (size_t rowSize : {bytesPerPixel, (size_t)31, (size_t)1000})
+        {
+            std::vector<uint8_t> prior = RandomBytes(rowSize, (uint32_t)(bytesPerPixel * 7 + rowSize));
+            std::vector<uint8_t> row = RandomBytes(rowSize, (uint32_t)(bytesPerPixel * 13 + rowSize));
+            for (uint8_t filterType = ePNGFilterNone; filterType <= ePNGFilterPaeth; ++filterType)
+            {
+                std::vector<uint8_t> decoded = FilterRow(filterType, row, prior, bytesPerPixel);
+                ASSERT_TRUE(PNGUnfilterRow(filterType, decoded.data(), prior.data(), rowSize, bytesPerPixel));
+                EXPECT_EQ(decoded, row) << "filter " << (int)filterType << " bpp " << bytesPerPixel << " size "
+                                        << rowSize;
+            }
+        }
+    }
+
+    std::vector<uint8_t> row(4, 1);
+    EXPECT_FALSE(PNGUnfilterRow(5, row.data(), row.data(), row.size(), 1));
+}
+
+TEST(PDFEmbedding, InputPredictorPNGOptimum)
+{
+    // RGB, 8 bits, 50 columns, a different filter for every row
+    const size_t colors = 3, columns = 50, rows = 20, rowSize = colors * columns;
+    std::vector<uint8_t> image = RandomBytes(rowSize * rows, 99);
+
+    std::string encoded;
+    std::vector<uint8_t> prior(rowSize, 0);
+    for (size_t i = 0; i < rows; ++i)
+    {
+        std::vector<uint8_t> row(image.begin() + i * rowSize, image.begin() + (i + 1) * rowSize);
+        uint8_t filterType = (uint8_t)(i % 5);
+        std::vector<uint8_t> filtered = FilterRow(filterType, row, prior, colors);
+        encoded.push_back((char)filterType);
+        encoded.append(filtered.begin(), filtered.end());
+        prior = row;
+    }
+
+    for (size_t readSize : {(size_t)1, (size_t)7, rowSize, (size_t)100000})
+    {
+        InputPredictorPNGOptimumStream predictor(new InputStringStream(encoded), colors, 8, columns);
+        std::string decoded = ReadAll(predictor, readSize);
+        EXPECT_EQ(decoded, std::string(image.begin(), image.end())) << "read size " << readSize;
+    }
+}
+
+TEST(PDFEmbedding, InputPredictorTIFFSub)
+{
+    const size_t columns = 37;
+    for (uint8_t bitsPerComponent : {1, 2, 4, 8, 16})
+    {
+        for (size_t colors : {1, 3})
+        {
+            // decode a row of known differences, and compare with the running sums
+            size_t components = columns * colors;
+            size_t rowSize = (components * bitsPerComponent + 7) / 8;
+            std::vector<uint8_t> row = RandomBytes(rowSize * 2, bitsPerComponent + (uint32_t)colors);
+            std::string encoded(row.begin(), row.end());
+
+            unsigned int mask = bitsPerComponent == 16 ? 0xffff : (1u << bitsPerComponent) - 1;
+            std::string expected;
+            for (size_t r = 0; r < 2; ++r)
+            {
+                const uint8_t *source = row.data() + r * rowSize;
+                std::vector<uint8_t> target(rowSize, 0);
+                std::vector<unsigned int> values(components);
+                for (size_t i = 0; i < components; ++i)
+                {
+                    size_t byteIndex = i * bitsPerComponent / 8;
+                    int shift = (int)(8 - bitsPerComponent - i * bitsPerComponent % 8);
+                    unsigned int value;
+                    if (bitsPerComponent == 16)
+                        value = (source[i * 2] << 8) | source[i * 2 + 1];
+                    else if (bitsPerComponent == 8)
+                        value = source[i];
+                    else
+                        value = (source[byteIndex] >> shift) & mask;
+                    values[i] = i >= colors ? (value + values[i - colors]) & mask : value;
+
+                    if (bitsPerComponent == 16)
+                    {
+                        target[i * 2] = (uint8_t)(values[i] >> 8);
+                        target[i * 2 + 1] = (uint8_t)values[i];
+                    }
+                    else if (bitsPerComponent == 8)
+                        target[i] = (uint8_t)values[i];
+                    else
+                        target[byteIndex] |= (uint8_t)(values[i] << shift);
+                }
+                // padding bits at the end of the row go through untouched
+                if (bitsPerComponent < 8 && (components * bitsPerComponent) % 8 != 0)
+                {
+                    uint8_t padding = (uint8_t)((1u << (8 - (components * bitsPerComponent) % 8)) - 1);
+                    target[rowSize - 1] |= source[rowSize - 1] & padding;
+                }
+                expected.append(target.begin(), target.end());
+            }
+
+            for (size_t readSize : {(size_t)1, (size_t)5, (size_t)4096})
+            {
+                InputPredictorTIFFSubStream predictor(new InputStringStream(encoded), colors, bitsPerComponent,
+                                                      columns);
+                EXPECT_EQ(ReadAll(predictor, readSize), expected)
+                    << "bits " << (int)bitsPerComponent << " colors " << colors << " read size " << readSize;
+            }
+        }
+    }
+}
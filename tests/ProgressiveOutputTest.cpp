@@ -0,0 +1,85 @@
+/*
+   Source File : ProgressiveOutputTest.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "PDFPage.h"
+#include "PDFWriter.h"
+#include "PageContentContext.h"
+#include "PagePresets.h"
+#include "io/InputStringStream.h"
+#include "io/OutputStringBufferStream.h"
+#include "parsing/PDFParser.h"
+
+#include <gtest/gtest.h>
+#include <regex>
+#include <string>
+#include <vector>
+
+using namespace charta;
+
+TEST(PDF, ProgressiveOutput)
+{
+    OutputStringBufferStream pdfStream;
+    PDFWriter pdfWriter;
+    PDFCreationSettings settings(true, true);
+    settings.ProgressiveOutput = true;
+
+    ASSERT_EQ(pdfWriter.StartPDFForStream(&pdfStream, ePDFVersion13, LogConfiguration::DefaultLogConfiguration(),
+                                          settings),
+              eSuccess);
+
+    // what was safe to send at each point, and the output at that time
+    std::vector<std::string> sent;
+    sent.push_back(pdfStream.ToString().substr(0, (size_t)pdfWriter.GetSafeToSendPosition()));
+    EXPECT_FALSE(sent.back().empty()); // header
+
+    for (int i = 0; i < 3; ++i)
+    {
+        PDFPage page;
+        page.SetMediaBox(charta::PagePresets::A4_Portrait);
+        PageContentContext *contentContext = pdfWriter.StartPageContentContext(page);
+        for (int j = 0; j < 50; ++j)
+            contentContext->DrawRectangle(j, j, 100, 100);
+
+        // the content stream is still open, and none of it is out
+        EXPECT_EQ(pdfWriter.GetSafeToSendPosition(), (long long)sent.back().size());
+
+        ASSERT_EQ(pdfWriter.EndPageContentContext(contentContext), eSuccess);
+        ASSERT_EQ(pdfWriter.WritePage(page), eSuccess);
+
+        // everything written so far is complete
+        EXPECT_EQ(pdfWriter.GetSafeToSendPosition(), pdfStream.GetCurrentPosition());
+        EXPECT_GT(pdfWriter.GetSafeToSendPosition(), (long long)sent.back().size());
+        sent.push_back(pdfStream.ToString().substr(0, (size_t)pdfWriter.GetSafeToSendPosition()));
+    }
+    ASSERT_EQ(pdfWriter.EndPDFForStream(), eSuccess);
+
+    // sent bytes are never changed later
+    std::string pdf = pdfStream.ToString();
+    for (const auto &prefix : sent)
+        EXPECT_EQ(pdf.compare(0, prefix.size(), prefix), 0);
+
+    // no forward referenced lengths
+    EXPECT_FALSE(std::regex_search(pdf, std::regex("/Length \\d+ 0 R")));
+
+    InputStringStream pdfContent(pdf);
+    PDFParser parser;
+    ASSERT_EQ(parser.StartPDFParsing(&pdfContent), eSuccess);
+    EXPECT_EQ(parser.GetPagesCount(), 3);
+}
@@ -0,0 +1,129 @@
+/*
+   Source File : StateSnapshotTest.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "StateSnapshot.h"
+#include "PDFPage.h"
+#include "PDFWriter.h"
+#include "PageContentContext.h"
+#include "TestHelper.h"
+#include "io/InputFile.h"
+#include "objects/PDFDictionary.h"
+#include "objects/PDFObjectCast.h"
+#include "parsing/PDFParser.h"
+
+#include <fstream>
+#include <gtest/gtest.h>
+
+using namespace charta;
+
+static EStatusCode WriteTextPage(PDFWriter &inWriter, PDFUsedFont *inFont, const std::string &inText)
+{
+    PDFPage page;
+    page.SetMediaBox(charta::PagePresets::A4_Portrait);
+
+    PageContentContext *contentContext = inWriter.StartPageContentContext(page);
+    if (contentContext == nullptr)
+        return eFailure;
+
+    contentContext->BT();
+    contentContext->k(0, 0, 0, 1);
+    contentContext->Tf(inFont, 1);
+    contentContext->Tm(30, 0, 0, 30, 78.4252, 662.8997);
+    EStatusCode status = contentContext->Tj(inText);
+    contentContext->ET();
+    if (status != eSuccess)
+        return status;
+
+    status = inWriter.EndPageContentContext(contentContext);
+    if (status != eSuccess)
+        return status;
+    return inWriter.WritePage(page);
+}
+
+TEST(PDF, ShutDownRestartBinaryState)
+{
+    std::string pdfPath = RelativeURLToLocalPath(PDFWRITE_BINARY_PATH, "ShutDownRestartBinaryState.pdf");
+    std::string statePath = RelativeURLToLocalPath(PDFWRITE_BINARY_PATH, "ShutDownRestartBinaryState.bin");
+    std::string fontPath = RelativeURLToLocalPath(PDFWRITE_SOURCE_PATH, "data/fonts/arial.ttf");
+
+    {
+        PDFWriter pdfWriterA;
+        ASSERT_EQ(pdfWriterA.StartPDF(pdfPath, ePDFVersion13), eSuccess);
+        PDFUsedFont *font = pdfWriterA.GetFontForFile(fontPath);
+        ASSERT_NE(font, nullptr);
+        ASSERT_EQ(WriteTextPage(pdfWriterA, font, "hello world"), eSuccess);
+        ASSERT_EQ(pdfWriterA.Shutdown(statePath, eStateFileFormatBinary), eSuccess);
+    }
+
+    ASSERT_TRUE(StateSnapshot::IsSnapshotFile(statePath));
+    {
+        StateSnapshot snapshot;
+        ASSERT_EQ(snapshot.Open(statePath), eSuccess);
+        PDFObjectCastPtr<charta::PDFDictionary> root(snapshot.ParseNewObject(snapshot.GetRootObjectID()));
+        ASSERT_TRUE(!!root);
+        EXPECT_TRUE(root->Exists("mObjectsContext"));
+        EXPECT_EQ(snapshot.ParseNewObject(snapshot.GetObjectsCount()), nullptr);
+    }
+
+    {
+        // same font again, so that glyphs used before the shutdown are carried over
+        PDFWriter pdfWriterB;
+        ASSERT_EQ(pdfWriterB.ContinuePDF(pdfPath, statePath), eSuccess);
+        PDFUsedFont *font = pdfWriterB.GetFontForFile(fontPath);
+        ASSERT_NE(font, nullptr);
+        ASSERT_EQ(WriteTextPage(pdfWriterB, font, "hello again"), eSuccess);
+        ASSERT_EQ(pdfWriterB.EndPDF(), eSuccess);
+    }
+
+    InputFile pdfFile;
+    PDFParser parser;
+    ASSERT_EQ(pdfFile.OpenFile(pdfPath), eSuccess);
+    ASSERT_EQ(parser.StartPDFParsing(pdfFile.GetInputStream()), eSuccess);
+    EXPECT_EQ(parser.GetPagesCount(), 2);
+}
+
+TEST(PDF, StateSnapshotChecksum)
+{
+    std::string pdfPath = RelativeURLToLocalPath(PDFWRITE_BINARY_PATH, "StateSnapshotChecksum.pdf");
+    std::string statePath = RelativeURLToLocalPath(PDFWRITE_BINARY_PATH, "StateSnapshotChecksum.bin");
+
+    {
+        PDFWriter pdfWriter;
+        ASSERT_EQ(pdfWriter.StartPDF(pdfPath, ePDFVersion13), eSuccess);
+        ASSERT_EQ(pdfWriter.Shutdown(statePath, eStateFileFormatBinary), eSuccess);
+    }
+
+    // flip a byte past the header
+    {
+        std::fstream stateFile(statePath, std::ios::in | std::ios::out | std::ios::binary);
+        stateFile.seekg(48);
+        char aByte = 0;
+        stateFile.read(&aByte, 1);
+        aByte ^= 0x5a;
+        stateFile.seekp(48);
+        stateFile.write(&aByte, 1);
+    }
+
+    StateSnapshot snapshot;
+    EXPECT_NE(snapshot.Open(statePath), eSuccess);
+
+    PDFWriter pdfWriter;
+    EXPECT_NE(pdfWriter.ContinuePDF(pdfPath, statePath), eSuccess);
+}
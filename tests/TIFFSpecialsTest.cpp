@@ -234,4 +234,40 @@ TEST(PDFImages, TIFFSpecials)
     ASSERT_EQ(status, charta::eSuccess);
 }
 
+TEST(PDFImages, TIFFMultiPage)
+{
+    PDFWriter pdfWriter;
+    EStatusCode status;
+    std::string multipage = RelativeURLToLocalPath(PDFWRITE_SOURCE_PATH, "data/images/tiff/multipage.tif");
+
+    status = pdfWriter.StartPDF(
+        RelativeURLToLocalPath(PDFWRITE_BINARY_PATH, "TiffMultiPageTest.pdf"), ePDFVersion13,
+        LogConfiguration(true, true, RelativeURLToLocalPath(PDFWRITE_BINARY_PATH, "TiffMultiPageTestLog.txt")));
+    ASSERT_EQ(status, charta::eSuccess);
+
+    // all pages, opening the tiff once
+    PDFFormXObjectVector allPages = pdfWriter.CreateFormXObjectsFromTIFFFile(multipage);
+    ASSERT_EQ(allPages.size(), 4U);
+    for (auto imageFormXObject : allPages)
+    {
+        ASSERT_NE(imageFormXObject, nullptr);
+        status = CreatePageForImageAndRelease(pdfWriter, imageFormXObject);
+        ASSERT_EQ(status, charta::eSuccess);
+    }
+
+    // selected pages, in the requested order. an out of range page fails alone
+    PDFFormXObjectVector selectedPages = pdfWriter.CreateFormXObjectsFromTIFFFile(multipage, {3, 1, 7});
+    ASSERT_EQ(selectedPages.size(), 3U);
+    EXPECT_EQ(selectedPages[2], nullptr);
+    for (size_t i = 0; i < 2; ++i)
+    {
+        ASSERT_NE(selectedPages[i], nullptr);
+        status = CreatePageForImageAndRelease(pdfWriter, selectedPages[i]);
+        ASSERT_EQ(status, charta::eSuccess);
+    }
+
+    status = pdfWriter.EndPDF();
+    ASSERT_EQ(status, charta::eSuccess);
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,318 @@
+/*
+   Source File : TextExtractorTest.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "parsing/TextExtractor.h"
+#include "DictionaryContext.h"
+#include "ObjectsContext.h"
+#include "PDFFormXObject.h"
+#include "PDFPage.h"
+#include "PDFWriter.h"
+#include "PageContentContext.h"
+#include "TestHelper.h"
+#include "XObjectContentContext.h"
+#include "io/InputFile.h"
+#include "parsing/ParsedCMap.h"
+#include "parsing/PDFParser.h"
+#include "parsing/PDFParserReader.h"
+
+#include <gtest/gtest.h>
+#include <list>
+#include <string>
+#include <vector>
+
+using namespace charta;
+
+TEST(Parsing, ParsedCMap)
+{
+    static const char scCMap[] = "/CIDInit /ProcSet findresource begin 12 dict begin begincmap\n"
+                                 "/CMapName /Test def\n"
+                                 "2 begincodespacerange <00> <80> <8140> <FFFF> endcodespacerange\n"
+                                 "2 beginbfchar <41> <0058> <8141> <D835DC00> endbfchar\n"
+                                 "2 beginbfrange <61> <63> <00660069> <9000> <9002> [<0031> <0032> <0033>] endbfrange\n"
+                                 "1 begincidrange <8140> <81FF> 500 endcidrange\n"
+                                 "endcmap CMapName currentdict /CMap defineresource pop end end";
+    ParsedCMap cMap;
+    ASSERT_EQ(cMap.Parse((const uint8_t *)scCMap, sizeof(scCMap) - 1), eSuccess);
+    EXPECT_TRUE(cMap.HasCodespaceRanges());
+    EXPECT_TRUE(cMap.HasUnicodeMappings());
+
+    // mixed one and two bytes codes
+    const uint8_t codes[] = {0x41, 0x81, 0x41, 0x62, 0x90};
+    uint32_t code;
+    EXPECT_EQ(cMap.ReadCode(codes, 5, 2, code), 1);
+    EXPECT_EQ(code, 0x41);
+    EXPECT_EQ(cMap.ReadCode(codes + 1, 4, 2, code), 2);
+    EXPECT_EQ(code, 0x8141);
+    EXPECT_EQ(cMap.ReadCode(codes + 3, 2, 2, code), 1);
+    EXPECT_EQ(code, 0x62);
+    EXPECT_EQ(cMap.ReadCode(codes + 4, 1, 2, code), 1); // truncated
+
+    std::string text;
+    EXPECT_TRUE(cMap.AppendUnicode(0x41, text));
+    EXPECT_EQ(text, "X");
+    text.clear();
+    EXPECT_TRUE(cMap.AppendUnicode(0x8141, text)); // surrogate pair
+    EXPECT_EQ(text, "\xF0\x9D\x90\x80");
+    text.clear();
+    EXPECT_TRUE(cMap.AppendUnicode(0x63, text)); // last value incremented along the range
+    EXPECT_EQ(text, "fk");
+    text.clear();
+    EXPECT_TRUE(cMap.AppendUnicode(0x9001, text));
+    EXPECT_EQ(text, "2");
+    EXPECT_FALSE(cMap.AppendUnicode(0x64, text));
+    EXPECT_FALSE(cMap.AppendUnicode(0x9003, text));
+
+    uint32_t cid;
+    EXPECT_TRUE(cMap.MapToCID(0x8142, cid));
+    EXPECT_EQ(cid, 502);
+    EXPECT_FALSE(cMap.MapToCID(0x41, cid));
+}
+
+TEST(Parsing, ParsedCMapOverlaps)
+{
+    static const char scCMap[] = "begincmap\n"
+                                 "1 begincodespacerange <00> <FF> endcodespacerange\n"
+                                 "2 beginbfrange <20> <7E> <0020> <A0> <AF> <00E0> endbfrange\n"
+                                 "2 beginbfchar <41> <00C5> <A0> <0058> endbfchar\n"
+                                 "1 beginbfrange <A8> <B2> <0030> endbfrange\n"
+                                 "1 begincidrange <00> <FF> 100 endcidrange\n"
+                                 "1 begincidchar <10> 7 endcidchar\n"
+                                 "endcmap";
+    ParsedCMap cMap;
+    ASSERT_EQ(cMap.Parse((const uint8_t *)scCMap, sizeof(scCMap) - 1), eSuccess);
+
+    // later definitions win, and the earlier range still maps the codes around them
+    std::string text;
+    EXPECT_TRUE(cMap.AppendUnicode(0x41, text));
+    EXPECT_EQ(text, "\xC3\x85");
+    text.clear();
+    EXPECT_TRUE(cMap.AppendUnicode(0x40, text));
+    EXPECT_TRUE(cMap.AppendUnicode(0x42, text));
+    EXPECT_TRUE(cMap.AppendUnicode(0x61, text));
+    EXPECT_TRUE(cMap.AppendUnicode(0x7E, text));
+    EXPECT_EQ(text, "@Ba~");
+    text.clear();
+    EXPECT_TRUE(cMap.AppendUnicode(0xA0, text));
+    EXPECT_TRUE(cMap.AppendUnicode(0xA1, text)); // still incremented from the start of its own range
+    EXPECT_TRUE(cMap.AppendUnicode(0xA8, text));
+    EXPECT_TRUE(cMap.AppendUnicode(0xB2, text));
+    EXPECT_EQ(text, "X\xC3\xA1"
+                    "0:");
+    EXPECT_FALSE(cMap.AppendUnicode(0xB3, text));
+
+    uint32_t cid;
+    EXPECT_TRUE(cMap.MapToCID(0x10, cid));
+    EXPECT_EQ(cid, 7);
+    EXPECT_TRUE(cMap.MapToCID(0x11, cid));
+    EXPECT_EQ(cid, 117);
+    EXPECT_TRUE(cMap.MapToCID(0x0F, cid));
+    EXPECT_EQ(cid, 115);
+}
+
+namespace
+{
+void WriteExtractionSample(const std::string &inPath)
+{
+    PDFWriter pdfWriter;
+    ASSERT_EQ(pdfWriter.StartPDF(inPath, ePDFVersion13), eSuccess);
+    PDFUsedFont *arial = pdfWriter.GetFontForFile(RelativeURLToLocalPath(PDFWRITE_SOURCE_PATH, "data/fonts/arial.ttf"));
+    ASSERT_NE(arial, nullptr);
+
+    // first page, with the library font, which has a ToUnicode map, and a form
+    {
+        PDFFormXObject *form = pdfWriter.StartFormXObject(PDFRectangle(0, 0, 200, 100));
+        XObjectContentContext *formContext = form->GetContentContext();
+        formContext->BT();
+        formContext->Tf(arial, 10);
+        formContext->Td(5, 5);
+        formContext->Tj("In a form");
+        formContext->ET();
+        ObjectIDType formID = form->GetObjectID();
+        ASSERT_EQ(pdfWriter.EndFormXObjectAndRelease(form), eSuccess);
+
+        PDFPage page;
+        page.SetMediaBox(charta::PagePresets::A4_Portrait);
+        PageContentContext *contentContext = pdfWriter.StartPageContentContext(page);
+        contentContext->BT();
+        contentContext->Tf(arial, 12);
+        contentContext->Tm(1, 0, 0, 1, 50, 800);
+        contentContext->Tj("Hello World");
+        contentContext->TL(20);
+        contentContext->TStar();
+        contentContext->Tj("Καλημέρα");
+        contentContext->ET();
+        contentContext->q();
+        contentContext->cm(2, 0, 0, 2, 100, 400);
+        contentContext->Do(page.GetResourcesDictionary().AddFormXObjectMapping(formID));
+        contentContext->Q();
+        ASSERT_EQ(pdfWriter.EndPageContentContext(contentContext), eSuccess);
+        ASSERT_EQ(pdfWriter.WritePage(page), eSuccess);
+    }
+
+    // second page, with a simple font that has no ToUnicode or widths
+    {
+        ObjectsContext &objectsContext = pdfWriter.GetObjectsContext();
+        ObjectIDType fontID = objectsContext.StartNewIndirectObject();
+        DictionaryContext *font = objectsContext.StartDictionary();
+        font->WriteKey("Type");
+        font->WriteNameValue("Font");
+        font->WriteKey("Subtype");
+        font->WriteNameValue("Type1");
+        font->WriteKey("BaseFont");
+        font->WriteNameValue("Helvetica");
+        font->WriteKey("Encoding");
+        DictionaryContext *encoding = objectsContext.StartDictionary();
+        encoding->WriteKey("BaseEncoding");
+        encoding->WriteNameValue("WinAnsiEncoding");
+        encoding->WriteKey("Differences");
+        objectsContext.StartArray();
+        objectsContext.WriteInteger(65);
+        objectsContext.WriteName("uni05D0");
+        objectsContext.WriteName("B.sc");
+        objectsContext.EndArray(eTokenSeparatorEndLine);
+        objectsContext.EndDictionary(encoding);
+        objectsContext.EndDictionary(font);
+        objectsContext.EndIndirectObject();
+
+        PDFPage page;
+        page.SetMediaBox(charta::PagePresets::A4_Portrait);
+        PageContentContext *contentContext = pdfWriter.StartPageContentContext(page);
+        std::string fontName = page.GetResourcesDictionary().AddFontMapping(fontID);
+        contentContext->BT();
+        contentContext->TfLow(fontName, 10);
+        contentContext->Tm(1, 0, 0, 1, 100, 700);
+        contentContext->TjLow("ABC\x80");
+        contentContext->TJLow({std::string("Hel"), -50.0, std::string("lo"), -1000.0, std::string("world")});
+        contentContext->ET();
+        contentContext->q();
+        contentContext->cm(2, 0, 0, 2, 0, 0);
+        contentContext->BT();
+        contentContext->TfLow(fontName, 10);
+        contentContext->Td(50, 100);
+        contentContext->Ts(5);
+        contentContext->TjLow("Big");
+        contentContext->ET();
+        contentContext->Q();
+        ASSERT_EQ(pdfWriter.EndPageContentContext(contentContext), eSuccess);
+        ASSERT_EQ(pdfWriter.WritePage(page), eSuccess);
+    }
+
+    ASSERT_EQ(pdfWriter.EndPDF(), eSuccess);
+}
+} // namespace
+
+TEST(Parsing, TextExtractor)
+{
+    std::string path = RelativeURLToLocalPath(PDFWRITE_BINARY_PATH, "TextExtraction.pdf");
+    WriteExtractionSample(path);
+
+    InputFile pdfFile;
+    PDFParser parser;
+    ASSERT_EQ(pdfFile.OpenFile(path), eSuccess);
+    ASSERT_EQ(parser.StartPDFParsing(pdfFile.GetInputStream()), eSuccess);
+    PDFParserReader reader(&parser, pdfFile.GetPositionalReader());
+    TextExtractor extractor(&reader);
+
+    std::vector<TextRun> runs;
+    ASSERT_EQ(extractor.ExtractPage(0, runs), eSuccess);
+    ASSERT_EQ(runs.size(), 3);
+    EXPECT_EQ(runs[0].mText, "Hello World");
+    EXPECT_DOUBLE_EQ(runs[0].mX, 50);
+    EXPECT_DOUBLE_EQ(runs[0].mY, 800);
+    EXPECT_DOUBLE_EQ(runs[0].mFontSize, 12);
+    EXPECT_GT(runs[0].mEndX, 100);
+    EXPECT_DOUBLE_EQ(runs[0].mEndY, 800);
+    EXPECT_EQ(runs[1].mText, "Καλημέρα");
+    EXPECT_DOUBLE_EQ(runs[1].mX, 50);
+    EXPECT_DOUBLE_EQ(runs[1].mY, 780);
+    // the form is scaled and moved by the page
+    EXPECT_EQ(runs[2].mText, "In a form");
+    EXPECT_DOUBLE_EQ(runs[2].mX, 110);
+    EXPECT_DOUBLE_EQ(runs[2].mY, 410);
+    EXPECT_DOUBLE_EQ(runs[2].mFontSize, 20);
+    EXPECT_EQ(TextExtractor::RunsToText(runs), "Hello World\nΚαλημέρα\nIn a form");
+
+    runs.clear();
+    ASSERT_EQ(extractor.ExtractPage(1, runs), eSuccess);
+    ASSERT_EQ(runs.size(), 4);
+    // differences, glyph name suffixes and the base encoding
+    EXPECT_EQ(runs[0].mText, "\xD7\x90"
+                             "BC\xE2\x82\xAC");
+    EXPECT_EQ(runs[0].mFontName, "Helvetica");
+    // no widths, so half an em per glyph
+    EXPECT_DOUBLE_EQ(runs[0].mEndX, 120);
+    EXPECT_DOUBLE_EQ(runs[1].mX, 120);
+    EXPECT_EQ(runs[1].mText, "Hello"); // small TJ spacing does not split
+    EXPECT_DOUBLE_EQ(runs[1].mEndX, 145.5);
+    EXPECT_EQ(runs[2].mText, "world");
+    EXPECT_DOUBLE_EQ(runs[2].mX, 155.5);
+    EXPECT_EQ(runs[3].mText, "Big");
+    EXPECT_DOUBLE_EQ(runs[3].mX, 100);
+    EXPECT_DOUBLE_EQ(runs[3].mY, 210); // rise is in text space
+    EXPECT_DOUBLE_EQ(runs[3].mFontSize, 20);
+}
+
+TEST(Parsing, TextExtractorParallel)
+{
+    std::string path = RelativeURLToLocalPath(PDFWRITE_BINARY_PATH, "TextExtractionParallel.pdf");
+    const unsigned long pagesCount = 24;
+    {
+        PDFWriter pdfWriter;
+        ASSERT_EQ(pdfWriter.StartPDF(path, ePDFVersion13), eSuccess);
+        PDFUsedFont *arial =
+            pdfWriter.GetFontForFile(RelativeURLToLocalPath(PDFWRITE_SOURCE_PATH, "data/fonts/arial.ttf"));
+        ASSERT_NE(arial, nullptr);
+        for (unsigned long i = 0; i < pagesCount; ++i)
+        {
+            PDFPage page;
+            page.SetMediaBox(charta::PagePresets::A4_Portrait);
+            PageContentContext *contentContext = pdfWriter.StartPageContentContext(page);
+            contentContext->BT();
+            contentContext->Tf(arial, 12);
+            contentContext->Td(50, 700);
+            contentContext->Tj("Page " + std::to_string(i + 1));
+            contentContext->ET();
+            ASSERT_EQ(pdfWriter.EndPageContentContext(contentContext), eSuccess);
+            ASSERT_EQ(pdfWriter.WritePage(page), eSuccess);
+        }
+        ASSERT_EQ(pdfWriter.EndPDF(), eSuccess);
+    }
+
+    InputFile pdfFile;
+    PDFParser parser;
+    ASSERT_EQ(pdfFile.OpenFile(path), eSuccess);
+    ASSERT_EQ(parser.StartPDFParsing(pdfFile.GetInputStream()), eSuccess);
+
+    TextExtractionCache cache;
+    std::vector<std::vector<TextRun>> pages;
+    ASSERT_EQ(TextExtractor::ExtractPages(&parser, pdfFile.GetPositionalReader(), 0, pagesCount, 4, pages, &cache),
+              eSuccess);
+    ASSERT_EQ(pages.size(), pagesCount);
+    for (unsigned long i = 0; i < pagesCount; ++i)
+    {
+        ASSERT_EQ(pages[i].size(), 1) << "page " << i;
+        EXPECT_EQ(pages[i][0].mText, "Page " + std::to_string(i + 1));
+    }
+    // one font, and its ToUnicode map, for all pages
+    EXPECT_EQ(cache.GetFontsCount(), 1);
+    EXPECT_EQ(cache.GetCMapsCount(), 1);
+
+    EXPECT_EQ(TextExtractor::ExtractPages(&parser, nullptr, 20, 5, 2, pages), eFailure);
+}
@@ -0,0 +1,166 @@
+/*
+   Source File : WriterStatisticsTest.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "WriterStatistics.h"
+#include "PDFPage.h"
+#include "PDFWriter.h"
+#include "PageContentBuffer.h"
+#include "PageContentContext.h"
+#include "TestHelper.h"
+#include "io/InputFile.h"
+
+#include <gtest/gtest.h>
+
+using namespace charta;
+
+static PDFCreationSettings StatisticsSettings(bool inCollect)
+{
+    PDFCreationSettings settings(true, true);
+    settings.CollectStatistics = inCollect;
+    return settings;
+}
+
+static EStatusCode WriteSampleDocument(PDFWriter &inWriter, const std::string &inOutputPath, bool inCollect)
+{
+    EStatusCode status =
+        inWriter.StartPDF(inOutputPath, ePDFVersion13, LogConfiguration::DefaultLogConfiguration(),
+                          StatisticsSettings(inCollect));
+    if (status != eSuccess)
+        return status;
+
+    inWriter.GetDocumentContext().GetTrailerInformation().GetInfo().Title = PDFTextString("Statistics");
+    PDFUsedFont *font = inWriter.GetFontForFile(RelativeURLToLocalPath(PDFWRITE_SOURCE_PATH, "data/fonts/arial.ttf"));
+    if (font == nullptr)
+        return eFailure;
+
+    PDFPage page;
+    page.SetMediaBox(PDFRectangle(0, 0, 595, 842));
+    PageContentContext *contentContext = inWriter.StartPageContentContext(page);
+    for (int i = 0; i < 100; ++i)
+        contentContext->re(10 + i, 10 + i, 100, 100);
+    contentContext->f();
+    contentContext->BT();
+    contentContext->Tf(font, 12);
+    contentContext->Tm(1, 0, 0, 1, 50, 700);
+    contentContext->Tj("Where did the bytes go");
+    contentContext->ET();
+    contentContext->DrawImage(10, 10, RelativeURLToLocalPath(PDFWRITE_SOURCE_PATH, "data/images/soundcloud_logo.jpg"));
+    status = inWriter.EndPageContentContext(contentContext);
+    if (status != eSuccess)
+        return status;
+    status = inWriter.WritePage(page);
+    if (status != eSuccess)
+        return status;
+
+    EStatusCodeAndObjectIDTypeList appended = inWriter.AppendPDFPagesFromPDF(
+        RelativeURLToLocalPath(PDFWRITE_SOURCE_PATH, "data/XObjectContent.pdf"), PDFPageRange());
+    if (appended.first != eSuccess)
+        return appended.first;
+
+    return inWriter.EndPDF();
+}
+
+TEST(PDF, WriterStatistics)
+{
+    std::string outputPath = RelativeURLToLocalPath(PDFWRITE_BINARY_PATH, "WriterStatistics.pdf");
+    PDFWriter pdfWriter;
+    ASSERT_EQ(WriteSampleDocument(pdfWriter, outputPath, true), eSuccess);
+
+    const WriterStatistics &statistics = pdfWriter.GetStatistics();
+
+    InputFile outputFile;
+    ASSERT_EQ(outputFile.OpenFile(outputPath), eSuccess);
+    EXPECT_EQ(statistics.GetOutputBytes(), (unsigned long long)outputFile.GetFileSize());
+
+    unsigned long long categoriesBytes = 0;
+    for (int i = 0; i < eWriterStatisticsCategoryCount; ++i)
+        categoriesBytes += statistics.GetBytes((EWriterStatisticsCategory)i);
+    // all but the header
+    EXPECT_LE(categoriesBytes, statistics.GetOutputBytes());
+    EXPECT_GT(categoriesBytes, statistics.GetOutputBytes() - 64);
+
+    EXPECT_GT(statistics.GetObjectsCount(eWriterStatisticsCategoryContent), 0);
+    EXPECT_GT(statistics.GetObjectsCount(eWriterStatisticsCategoryImages), 0);
+    EXPECT_GT(statistics.GetObjectsCount(eWriterStatisticsCategoryFonts), 0);
+    EXPECT_EQ(statistics.GetObjectsCount(eWriterStatisticsCategoryMetadata), 1);
+    EXPECT_GT(statistics.GetObjectsCount(eWriterStatisticsCategoryCopied), 0);
+    EXPECT_EQ(statistics.GetObjectsCount(eWriterStatisticsCategoryXref), 0); // a table, not a stream
+    EXPECT_GT(statistics.GetBytes(eWriterStatisticsCategoryXref), 0);
+    EXPECT_GT(statistics.GetObjectsCount(eWriterStatisticsCategoryOther), 0); // page tree and catalog
+
+    EXPECT_GT(statistics.GetStreamsCount(), 0);
+    EXPECT_GT(statistics.GetRawStreamBytes(), statistics.GetEncodedStreamBytes());
+
+    EXPECT_GT(statistics.GetPhaseNanoseconds(eWriterStatisticsPhaseCompression), 0);
+    EXPECT_GT(statistics.GetPhaseNanoseconds(eWriterStatisticsPhaseFontSubsetting), 0);
+    EXPECT_GT(statistics.GetPhaseNanoseconds(eWriterStatisticsPhaseImageDecoding), 0);
+    EXPECT_GT(statistics.GetPhaseNanoseconds(eWriterStatisticsPhasePDFCopying), 0);
+    EXPECT_EQ(statistics.GetBufferedMemory(), 0);
+
+    std::string json = statistics.ToJSON();
+    EXPECT_EQ(json.front(), '{');
+    EXPECT_EQ(json.back(), '}');
+    EXPECT_NE(json.find("\"outputBytes\":" + std::to_string(statistics.GetOutputBytes())), std::string::npos);
+    EXPECT_NE(json.find("\"fonts\":{\"objects\":"), std::string::npos);
+    EXPECT_NE(json.find("\"fontSubsetting\":"), std::string::npos);
+    EXPECT_NE(json.find("\"peakBufferedMemory\":"), std::string::npos);
+
+    // off by default, and the next production starts over
+    ASSERT_EQ(WriteSampleDocument(pdfWriter, outputPath, false), eSuccess);
+    EXPECT_EQ(pdfWriter.GetStatistics().GetObjectsCount(), 0);
+    EXPECT_EQ(pdfWriter.GetStatistics().GetOutputBytes(), 0);
+}
+
+TEST(PDF, WriterStatisticsBufferedMemory)
+{
+    std::string outputPath = RelativeURLToLocalPath(PDFWRITE_BINARY_PATH, "WriterStatisticsBuffered.pdf");
+    PDFWriter pdfWriter;
+    ASSERT_EQ(pdfWriter.StartPDF(outputPath, ePDFVersion13, LogConfiguration::DefaultLogConfiguration(),
+                                 StatisticsSettings(true)),
+              eSuccess);
+
+    PDFPage pages[2];
+    PageContentBuffer *buffers[2];
+    for (int i = 0; i < 2; ++i)
+    {
+        pages[i].SetMediaBox(PDFRectangle(0, 0, 595, 842));
+        buffers[i] = pdfWriter.StartPageContentBuffer(pages[i]);
+        ASSERT_NE(buffers[i], nullptr);
+        PageContentContext *contentContext = buffers[i]->GetContentContext();
+        for (int j = 0; j < 200; ++j)
+            contentContext->re(j, j, 10 + i, 10);
+        contentContext->f();
+        ASSERT_EQ(buffers[i]->Finalize(), eSuccess);
+    }
+
+    // both buffers are held at once
+    const WriterStatistics &statistics = pdfWriter.GetStatistics();
+    size_t bothBuffers = statistics.GetBufferedMemory();
+    EXPECT_GT(bothBuffers, 0);
+
+    for (auto &buffer : buffers)
+        ASSERT_EQ(pdfWriter.CommitPageContentBuffer(buffer), eSuccess);
+    EXPECT_EQ(statistics.GetBufferedMemory(), 0);
+    ASSERT_EQ(pdfWriter.EndPDF(), eSuccess);
+
+    EXPECT_EQ(statistics.GetPeakBufferedMemory(), bothBuffers);
+    // buffered objects are accounted when written into the buffer
+    EXPECT_GE(statistics.GetObjectsCount(eWriterStatisticsCategoryContent), 4);
+}
@@ -0,0 +1,167 @@
+/*
+   Source File : XrefRecoveryTest.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "EStatusCode.h"
+#include "TestHelper.h"
+#include "io/InputFile.h"
+#include "io/InputStringStream.h"
+#include "objects/PDFDictionary.h"
+#include "parsing/PDFParser.h"
+#include "parsing/XrefScanner.h"
+
+#include <fstream>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+using namespace charta;
+
+static std::string ReadFile(const std::string &inPath)
+{
+    std::ifstream file(inPath, std::ios::binary);
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+// shift everything after the header line, so that all xref offsets are off
+static std::string ShiftOffsets(const std::string &inContent)
+{
+    size_t headerEnd = inContent.find('\n') + 1;
+    return inContent.substr(0, headerEnd) + "%" + std::string(137, 'x') + "\n" + inContent.substr(headerEnd);
+}
+
+static void CompareToOriginal(const std::string &inOriginalPath, PDFParser &inRecovered)
+{
+    InputFile originalFile;
+    PDFParser original;
+    ASSERT_EQ(originalFile.OpenFile(inOriginalPath), eSuccess);
+    ASSERT_EQ(original.StartPDFParsing(originalFile.GetInputStream()), eSuccess);
+
+    EXPECT_EQ(original.GetPagesCount(), inRecovered.GetPagesCount());
+    for (ObjectIDType i = 1; i < original.GetXrefSize(); ++i)
+    {
+        if (original.GetXrefEntry(i).mType == eXrefEntryDelete)
+            continue;
+        auto originalObject = original.ParseNewObject(i);
+        if (originalObject == nullptr)
+            continue;
+        auto recoveredObject = inRecovered.ParseNewObject(i);
+        ASSERT_NE(recoveredObject, nullptr) << "object " << i;
+        EXPECT_EQ(originalObject->GetType(), recoveredObject->GetType()) << "object " << i;
+        if (originalObject->GetType() == PDFObject::ePDFObjectDictionary)
+        {
+            EXPECT_EQ(std::static_pointer_cast<PDFDictionary>(originalObject)->GetLength(),
+                      std::static_pointer_cast<PDFDictionary>(recoveredObject)->GetLength())
+                << "object " << i;
+        }
+    }
+}
+
+static void TestShiftedFile(const std::string &inRelativePath)
+{
+    std::string path = RelativeURLToLocalPath(PDFWRITE_SOURCE_PATH, inRelativePath);
+    std::string shifted = ShiftOffsets(ReadFile(path));
+
+    {
+        InputStringStream stream(shifted);
+        PDFParser parser;
+        EXPECT_NE(parser.StartPDFParsing(&stream), eSuccess);
+    }
+
+    InputStringStream stream(shifted);
+    PDFParser parser;
+    PDFParsingOptions options;
+    options.RecoverBrokenXref = true;
+    ASSERT_EQ(parser.StartPDFParsing(&stream, options), eSuccess);
+    EXPECT_TRUE(parser.IsXrefRebuilt());
+    CompareToOriginal(path, parser);
+}
+
+TEST(Parsing, XrefRecoveryBadXref)
+{
+    InputFile pdfFile;
+    ASSERT_EQ(pdfFile.OpenFile(RelativeURLToLocalPath(PDFWRITE_SOURCE_PATH, "data/test_bad_xref.pdf")), eSuccess);
+
+    PDFParser parser;
+    ASSERT_EQ(parser.StartPDFParsing(pdfFile.GetInputStream(), PDFParsingOptions("", true)), eSuccess);
+    EXPECT_TRUE(parser.IsXrefRebuilt());
+    EXPECT_GT(parser.GetPagesCount(), 0);
+    EXPECT_NE(parser.ParsePage(0), nullptr);
+}
+
+TEST(Parsing, XrefRecoveryShiftedTable)
+{
+    TestShiftedFile("data/AddedPage.pdf");
+}
+
+TEST(Parsing, XrefRecoveryShiftedObjectStreams)
+{
+    TestShiftedFile("data/ObjectStreams.pdf");
+}
+
+TEST(Parsing, XrefRecoveryIntactFile)
+{
+    InputFile pdfFile;
+    ASSERT_EQ(pdfFile.OpenFile(RelativeURLToLocalPath(PDFWRITE_SOURCE_PATH, "data/XObjectContent.pdf")), eSuccess);
+
+    PDFParser parser;
+    ASSERT_EQ(parser.StartPDFParsing(pdfFile.GetInputStream(), PDFParsingOptions("", true)), eSuccess);
+    EXPECT_FALSE(parser.IsXrefRebuilt());
+}
+
+TEST(Parsing, XrefScannerBlockBoundaries)
+{
+    std::stringstream source;
+    source << "%PDF-1.4\n";
+    for (int i = 1; i <= 200; ++i)
+        source << i << " 0 obj<</Type /Page /Count " << i * 7 << ">>endobj\n"
+               << (i % 3 == 0 ? "% 12 0 objects in a comment\n" : "") << i + 1000 << " 2 obj /ObjStm endobj\n";
+    source << "trailer<</Root 1 0 R>>\n%%EOF";
+    std::string content = source.str();
+
+    InputStringStream wholeStream(content);
+    XrefScanner whole;
+    ASSERT_EQ(whole.Scan(&wholeStream), eSuccess);
+    ASSERT_EQ(whole.GetObjects().size(), 400);
+    EXPECT_EQ(whole.GetKeywordPositions(XrefScanner::eKeywordObjStm).size(), 200);
+    ASSERT_EQ(whole.GetKeywordPositions(XrefScanner::eKeywordTrailer).size(), 1);
+    EXPECT_EQ(content.substr(whole.GetKeywordPositions(XrefScanner::eKeywordTrailer)[0], 2), "<<");
+    EXPECT_EQ(whole.GetObjects()[1].mObjectID, 1001);
+    EXPECT_EQ(whole.GetObjects()[1].mGenerationNumber, 2);
+    EXPECT_EQ(content.substr(whole.GetObjects()[1].mPosition, 10), "1001 2 obj");
+
+    // small blocks, so markers straddle block ends
+    for (size_t blockSize : {256, 257, 300, 1001})
+    {
+        InputStringStream stream(content);
+        XrefScanner blocks(blockSize);
+        ASSERT_EQ(blocks.Scan(&stream), eSuccess);
+        ASSERT_EQ(blocks.GetObjects().size(), whole.GetObjects().size()) << blockSize;
+        for (size_t i = 0; i < whole.GetObjects().size(); ++i)
+            EXPECT_EQ(blocks.GetObjects()[i].mPosition, whole.GetObjects()[i].mPosition) << blockSize;
+        EXPECT_EQ(blocks.GetKeywordPositions(XrefScanner::eKeywordObjStm),
+                  whole.GetKeywordPositions(XrefScanner::eKeywordObjStm))
+            << blockSize;
+    }
+
+    EXPECT_EQ(whole.FindObjectBefore(0), -1);
+    EXPECT_EQ(whole.FindObjectBefore(whole.GetObjects()[2].mPosition + 1), 2);
+}
@@ -0,0 +1,92 @@
+/*
+   Source File : XrefTableTest.cpp
+
+
+   Copyright 2011 Gal Kahana PDFWriter
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+
+*/
+#include "parsing/XrefTable.h"
+#include "TestHelper.h"
+#include "io/InputFile.h"
+#include "parsing/PDFParser.h"
+
+#include <gtest/gtest.h>
+
+using namespace charta;
+
+TEST(Parsing, XrefTablePacking)
+{
+    XrefTable table;
+    table.Reset(4);
+
+    EXPECT_EQ(table.GetSize(), 4);
+    EXPECT_EQ(table.GetType(0), eXrefEntryUndefined);
+
+    table.SetEntry(1, 1234567, 0, eXrefEntryExisting);
+    table.SetEntry(2, 12, 3, eXrefEntryStreamObject);
+    table.SetEntry(3, 0, 65535, eXrefEntryDelete);
+
+    EXPECT_EQ(table.GetType(1), eXrefEntryExisting);
+    EXPECT_EQ(table.GetObjectPosition(1), 1234567);
+    EXPECT_EQ(table.GetRivision(1), 0);
+    EXPECT_EQ(table.GetType(2), eXrefEntryStreamObject);
+    EXPECT_EQ(table.GetObjectPosition(2), 12);
+    EXPECT_EQ(table.GetRivision(2), 3);
+    EXPECT_EQ(table.GetType(3), eXrefEntryDelete);
+    EXPECT_EQ(table.GetRivision(3), 65535);
+
+    // values that don't fit the packed entry
+    table.SetEntry(0, 1LL << 41, 1UL << 22, eXrefEntryExisting);
+    XrefEntryInput wide = table.GetEntry(0);
+    EXPECT_EQ(wide.mType, eXrefEntryExisting);
+    EXPECT_EQ(wide.mObjectPosition, 1LL << 41);
+    EXPECT_EQ(wide.mRivision, 1UL << 22);
+
+    // overwriting with a small value drops the wide value
+    table.SetEntry(0, 10, 1, eXrefEntryExisting);
+    EXPECT_EQ(table.GetObjectPosition(0), 10);
+    EXPECT_EQ(table.GetRivision(0), 1);
+
+    // extending keeps existing entries and adds undefined ones
+    table.ExtendToSize(1000);
+    EXPECT_EQ(table.GetSize(), 1000);
+    EXPECT_EQ(table.GetObjectPosition(1), 1234567);
+    EXPECT_EQ(table.GetType(999), eXrefEntryUndefined);
+    EXPECT_EQ(table.GetType(1000), eXrefEntryUndefined);
+    EXPECT_EQ(table.GetEntry(5000).mType, eXrefEntryUndefined);
+}
+
+TEST(Parsing, XrefTableIncrementalSections)
+{
+    // a file with an incremental update, where xref sections are merged into a single table
+    InputFile pdfFile;
+    PDFParser parser;
+
+    ASSERT_EQ(pdfFile.OpenFile(RelativeURLToLocalPath(PDFWRITE_SOURCE_PATH, "data/AddedPage.pdf")), eSuccess);
+    ASSERT_EQ(parser.StartPDFParsing(pdfFile.GetInputStream()), eSuccess);
+
+    ASSERT_GT(parser.GetXrefSize(), 0);
+    for (ObjectIDType i = 1; i < parser.GetXrefSize(); ++i)
+    {
+        XrefEntryInput entry = parser.GetXrefEntry(i);
+        if (entry.mType == eXrefEntryExisting || entry.mType == eXrefEntryStreamObject)
+        {
+            EXPECT_NE(parser.ParseNewObject(i), nullptr) << "object " << i;
+        }
+    }
+    // the page tree of the update, and not the original one
+    EXPECT_EQ(parser.GetPagesCount(), 4);
+}